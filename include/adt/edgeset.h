@@ -19,14 +19,13 @@ struct state_set;
 struct edge_iter {
 	size_t i;
 	const struct edge_set *set;
+	int defaults;
 };
 
 struct edge_ordered_iter {
 	const struct edge_set *set;
 	size_t pos;
-	size_t steps;
 	unsigned char symbol;
-	uint64_t symbols_used[4];
 };
 
 /* Opaque struct type for edge iterator,
@@ -47,6 +46,13 @@ int
 edge_set_add(struct edge_set **set, const struct fsm_alloc *alloc,
 	unsigned char symbol, fsm_state_t state);
 
+/* Add an edge to the given state for each symbol in the bitmap.
+ * Where possible these are stored as a single default edge,
+ * rather than an edge per symbol. */
+int
+edge_set_add_bulk(struct edge_set **setp, const struct fsm_alloc *alloc,
+	const struct bm *symbols, fsm_state_t state);
+
 int
 edge_set_add_state_set(struct edge_set **setp, const struct fsm_alloc *alloc,
 	unsigned char symbol, const struct state_set *state_set);
@@ -55,6 +61,14 @@ int
 edge_set_find(const struct edge_set *set, unsigned char symbol,
 	struct fsm_edge *e);
 
+/* Find the default edge, if any, returning 0 if there is none.
+ * Its symbols are written to the bitmap, which may be NULL.
+ * These edges are also yielded by edge_set_find(), edge_set_next()
+ * and so on, as if they were stored individually. */
+int
+edge_set_default(const struct edge_set *set,
+	struct bm *symbols, fsm_state_t *state);
+
 int
 edge_set_contains(const struct edge_set *set, unsigned char symbol);
 
@@ -85,6 +99,11 @@ edge_set_compact(struct edge_set **set,
 void
 edge_set_reset(const struct edge_set *set, struct edge_iter *it);
 
+/* Reset an iterator to yield only the edges which are not part of
+ * the default edge, for callers who handle edge_set_default() themselves. */
+void
+edge_set_reset_explicit(const struct edge_set *set, struct edge_iter *it);
+
 int
 edge_set_next(struct edge_iter *it, struct fsm_edge *e);
 
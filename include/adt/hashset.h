@@ -7,6 +7,8 @@
 #ifndef ADT_HASHSET_H
 #define ADT_HASHSET_H
 
+#include <stdint.h>
+
 struct hashset_iter {
 	size_t i;
 	const struct hashset *hashset;
@@ -19,5 +21,8 @@ struct hashset_iter {
 unsigned long
 hashrec(const void *p, size_t n);
 
+uint64_t
+hashmix64(uint64_t z);
+
 #endif
 
@@ -64,12 +64,12 @@ int
 state_set_cmp(const struct state_set *a, const struct state_set *b);
 
 const fsm_state_t *
-state_set_array(const struct state_set *set);
+state_set_array(struct state_set *set);
 
-void
+int
 state_set_rebase(struct state_set **set, fsm_state_t base);
 
-void
+int
 state_set_replace(struct state_set **set, fsm_state_t old, fsm_state_t new);
 
 unsigned long
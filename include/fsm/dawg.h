@@ -0,0 +1,120 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#ifndef FSM_DAWG_H
+#define FSM_DAWG_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+struct fsm;
+struct fsm_dawg;
+
+/*
+ * A serialised, read-only representation of a minimal acyclic DFA
+ * (a directed acyclic word graph) for a finite set of strings.
+ *
+ * The intended source is re_strings_build() with both anchors set,
+ * followed by fsm_minimise(). The serialised form is position-independent
+ * and is queried in-place; it is intended to be mmap(2)ed and shared
+ * between processes, with no need to construct a struct fsm for lookup.
+ *
+ * Nodes are variable-length: a flags byte (end state and edge count),
+ * a varint count of the words reachable from the node (for ordinal
+ * lookup), the node's edge symbols in ascending order, and the target
+ * offsets of those edges bit-packed at the minimum width required to
+ * address the whole node area.
+ */
+
+/*
+ * Serialise an FSM to the given stream.
+ *
+ * The FSM must be a DFA accepting a finite language (i.e. no cycles
+ * other than those through states which cannot reach an end state).
+ * The FSM need not be minimal, but the output is smallest when it is.
+ *
+ * Returns 1 on success, or 0 on error; see errno. EINVAL indicates an
+ * FSM which is not a DFA, has no start state, or has an infinite language.
+ */
+int
+fsm_dawg_write(FILE *f, const struct fsm *fsm);
+
+/*
+ * Open a serialised DAWG from memory. The memory is not copied and must
+ * remain extant until fsm_dawg_close(). The header is validated here;
+ * node contents are bounds-checked during lookup.
+ *
+ * Returns NULL on error; see errno.
+ */
+struct fsm_dawg *
+fsm_dawg_open(const void *p, size_t n);
+
+/*
+ * Map a serialised DAWG from a file, read-only.
+ *
+ * Returns NULL on error; see errno.
+ */
+struct fsm_dawg *
+fsm_dawg_map(const char *path);
+
+void
+fsm_dawg_close(struct fsm_dawg *dawg);
+
+/*
+ * The number of words in the set.
+ */
+size_t
+fsm_dawg_count(const struct fsm_dawg *dawg);
+
+/*
+ * Returns 1 if the string s of length n is a member of the set, else 0.
+ */
+int
+fsm_dawg_contains(const struct fsm_dawg *dawg, const char *s, size_t n);
+
+/*
+ * Returns 1 if any member of the set begins with the string s of length n,
+ * else 0. The empty string is a prefix of every member of a non-empty set.
+ */
+int
+fsm_dawg_hasprefix(const struct fsm_dawg *dawg, const char *s, size_t n);
+
+/*
+ * Find the longest member of the set which is a prefix of s.
+ *
+ * Returns 1 and writes the length of that member to *len on success,
+ * or 0 if no member of the set is a prefix of s.
+ */
+int
+fsm_dawg_longest_prefix(const struct fsm_dawg *dawg, const char *s, size_t n,
+	size_t *len);
+
+/*
+ * Find the ordinal of s within the set. Ordinals are dense (0 to count-1)
+ * and follow the lexicographic order of members, comparing octets as
+ * unsigned values.
+ *
+ * Returns 1 and writes the ordinal to *id on success, or 0 if s is not a
+ * member of the set.
+ */
+int
+fsm_dawg_index(const struct fsm_dawg *dawg, const char *s, size_t n,
+	size_t *id);
+
+/*
+ * The inverse of fsm_dawg_index(): write the member with the given ordinal
+ * to buf, truncated to bufsz - 1 octets and always '\0'-terminated when
+ * bufsz is non-zero. Members may themselves contain '\0'.
+ *
+ * Returns the length of the member (which may exceed bufsz - 1),
+ * or -1 if id is out of range.
+ */
+long
+fsm_dawg_word(const struct fsm_dawg *dawg, size_t id,
+	char *buf, size_t bufsz);
+
+#endif
+
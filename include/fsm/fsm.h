@@ -99,8 +99,9 @@ fsm_addstate_bulk(struct fsm *fsm, size_t n);
 
  /*
  * Remove a state. Any edges transitioning to this state are also removed.
+ * Returns 0 on error.
  */
-void
+int
 fsm_removestate(struct fsm *fsm, fsm_state_t state);
 
 /* Use the state passed in via opaque to determine whether the state[id]
@@ -326,6 +327,20 @@ fsm_complete(struct fsm *fsm,
 int
 fsm_minimise(struct fsm *fsm);
 
+/*
+ * Minimise a DFA as for fsm_minimise(), but distinguishing end states
+ * by their opaque values, such that end states are only merged with
+ * others of the same opaque. For a DFA of several patterns each marking
+ * its end states with an opaque (or an interned set of opaques, where
+ * patterns overlap), this gives the minimal DFA which still tells them
+ * apart. The opaque for a merged state is kept as-is; carryopaque is
+ * not called.
+ *
+ * Returns false on error; see errno.
+ */
+int
+fsm_minimise_opaque(struct fsm *fsm);
+
 /*
  * Concatenate b after a. This is not commutative.
  */
@@ -378,6 +393,10 @@ fsm_shortest(const struct fsm *fsm,
  * its state opaque value previously set by fsm_setopaque() (not to be
  * confused with the opaque pointer passed for the fsm_getc callback function).
  *
+ * Execution stops without reading the remaining input once an absorbing
+ * state is reached (see fsm_isabsorbing()), where the outcome is decided.
+ * This is detected on the first byte read after entering such a state.
+ *
  * The given FSM is expected to be a DFA.
  */
 int
@@ -0,0 +1,123 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#ifndef FSM_LEXER_H
+#define FSM_LEXER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+/*
+ * A lexer serialised as tables, to be loaded and run at runtime rather
+ * than generated as code and compiled in. lx -l vm writes these.
+ *
+ * A lexer is a DFA per zone, each accepting state giving the token it
+ * produces (or none, to skip the text matched) and the zone to switch to
+ * for the next token (or none, to stay). The DFAs' transitions are held
+ * together as one table indexed by state and class of byte, and a token
+ * is lexed by the longest run of transitions, as for lx's generated code.
+ *
+ * Tokens are numbered from 0 in the order their names are given.
+ */
+
+#define FSM_LEXER_SKIP ((unsigned) -1)
+#define FSM_LEXER_STAY ((unsigned) -1)
+
+#define FSM_LEXER_EOF     (-1)
+#define FSM_LEXER_UNKNOWN (-2)
+#define FSM_LEXER_ERROR   (-3)
+
+struct fsm;
+struct fsm_lexer;
+
+struct fsm_lexer_pos {
+	unsigned byte;
+	unsigned line;
+	unsigned col;
+};
+
+/*
+ * Input to lex. The text of the token most recently returned by
+ * fsm_lexer_next() runs from tok to p.
+ *
+ * Line and column are counted in start and end only if pos is set;
+ * bytes are always counted. At the end of input, start and end are left
+ * as for the token before.
+ */
+struct fsm_lexer_input {
+	const char *p;
+	const char *e;
+	const char *tok;
+
+	unsigned zone;
+
+	int pos;
+	struct fsm_lexer_pos start;
+	struct fsm_lexer_pos end;
+};
+
+/*
+ * Serialise a lexer to the given stream. zone[] are DFAs with start
+ * states, and the end callback is called for each accepting state
+ * to set the token it produces and the zone it switches to, which may be
+ * FSM_LEXER_SKIP and FSM_LEXER_STAY respectively.
+ *
+ * Returns 1 on success, or 0 on error; see errno. EINVAL indicates a zone
+ * which is not a DFA or has no start state, or a token or zone out of range.
+ */
+int
+fsm_lexer_write(FILE *f,
+	const struct fsm *const zone[], size_t nzones, unsigned start,
+	const char *const name[], size_t ntokens,
+	void (*end)(const struct fsm *fsm, fsm_state_t state,
+		unsigned *token, unsigned *zone, void *opaque),
+	void *opaque);
+
+/*
+ * Load a lexer written by fsm_lexer_write(). The tables are validated
+ * here, so that fsm_lexer_next() needs no checks for a bad file.
+ *
+ * Returns NULL on error; see errno. EINVAL indicates a bad file.
+ */
+struct fsm_lexer *
+fsm_lexer_read(FILE *f);
+
+void
+fsm_lexer_free(struct fsm_lexer *lexer);
+
+size_t
+fsm_lexer_ntokens(const struct fsm_lexer *lexer);
+
+/*
+ * Returns the name given for a token, or NULL if out of range.
+ */
+const char *
+fsm_lexer_name(const struct fsm_lexer *lexer, int token);
+
+/*
+ * Set up to lex the n bytes at buf, from the lexer's starting zone.
+ */
+void
+fsm_lexer_init(const struct fsm_lexer *lexer, struct fsm_lexer_input *in,
+	const char *buf, size_t n);
+
+/*
+ * Lex the next token, skipping any text matched which produces no token.
+ *
+ * Returns the token, or FSM_LEXER_EOF at the end of input, or
+ * FSM_LEXER_UNKNOWN for text which is not a token. The text for
+ * FSM_LEXER_UNKNOWN runs up to and including the byte at which lexing
+ * failed, and lexing may continue from the byte after it.
+ *
+ * A token cut short by the end of input returns FSM_LEXER_ERROR, with
+ * errno set to EINVAL, as for lx's generated code. The text runs to the
+ * end of input, and the next call returns FSM_LEXER_EOF.
+ */
+int
+fsm_lexer_next(const struct fsm_lexer *lexer, struct fsm_lexer_input *in);
+
+#endif
+
@@ -11,6 +11,7 @@
 
 struct fsm;
 struct fsm_state;
+struct fsm_vm_profile;
 
 enum fsm_io {
 	FSM_IO_GETC,
@@ -18,6 +19,12 @@ enum fsm_io {
 	FSM_IO_PAIR
 };
 
+enum fsm_ctable {
+	FSM_CTABLE_AUTO,
+	FSM_CTABLE_NEVER,
+	FSM_CTABLE_ALWAYS
+};
+
 struct fsm_options {
 	/* boolean: true indicates to omit names for states in output */
 	unsigned int anonymous_states:1;
@@ -50,6 +57,18 @@ struct fsm_options {
 	/* for generated code, what kind of I/O API to generate */
 	enum fsm_io io;
 
+	/* for C code output, whether to represent transitions by a switch
+	 * statement per state, or by compressed tables and a small driver.
+	 * Tables suit very large DFAs, where the switch statements would be
+	 * too large to compile. FSM_CTABLE_AUTO decides by size. */
+	enum fsm_ctable ctable;
+
+	/* for C code output, the number of functions across which to split
+	 * the switch statements for states. Each is guarded by FSM_PART, so
+	 * that one file may be compiled as several translation units in
+	 * parallel. 0 or 1 for a single function. */
+	unsigned int parts;
+
 	/* a prefix for namespacing generated identifiers. NULL if not required. */
 	const char *prefix;
 
@@ -68,6 +87,10 @@ struct fsm_options {
 	void (*carryopaque)(struct fsm *src_fsm, const fsm_state_t *src_set, size_t n,
 		struct fsm *dst_fsm, fsm_state_t dst_state);
 
+	/* execution profile to guide code layout for the VM and its
+	 * derived output languages. NULL if not required. */
+	const struct fsm_vm_profile *vm_profile;
+
 	/* custom allocation functions */
 	const struct fsm_alloc *alloc;
 };
@@ -0,0 +1,136 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#ifndef FSM_PARALLEL_H
+#define FSM_PARALLEL_H
+
+#include <stddef.h>
+
+/*
+ * Matching a single large buffer across several threads.
+ * These use POSIX threads, and so programs calling them
+ * need -lpthread (or -pthread).
+ *
+ * A DFA's transitions are compiled to a table indexed by state and class
+ * of byte. To match, the buffer is split into a chunk per thread. The
+ * first chunk runs from the start state. Every other chunk runs from all
+ * states at once, merging runs which converge on the same state, and so
+ * gives a map from the state the chunk is entered in to the state it ends
+ * in. These maps are composed in order for the exact final state.
+ *
+ * Most DFAs converge to a few states within some tens of bytes, after
+ * which a chunk costs about the same as sequential matching.
+ *
+ * The same table serves to match many short buffers in a batch. Several
+ * buffers are advanced a byte at a time in turn, so that their lookups
+ * are independent of each other and the memory accesses for them overlap,
+ * rather than each waiting on the one before.
+ *
+ * A table may instead be compiled for matching each line of a buffer
+ * in one pass. The DFA is taken to match a single line, without its
+ * newline. In the table, a newline leads back to the start state, and
+ * from an accepting state it leads to a copy of the start state which
+ * marks that line as accepted, so there's no reset or call per line.
+ *
+ * Several tables may also be combined to run over the same input in one
+ * pass, for a rule set split across DFAs. Their transitions are looked up
+ * together, a lane per DFA. Built by GCC or clang for x86 with a CPU which
+ * has AVX2, 9 to 16 DFAs (16 lanes) are stepped as two vectors of eight
+ * gathers. Up to 8 DFAs always run one lane at a time, since a single
+ * vector of gathers, each waiting on the one before, is slower than that.
+ * There is no SSE path, because SSE has no gather instruction.
+ */
+
+#define FSM_PARALLEL_MULTI_MAX 16
+
+struct fsm;
+struct fsm_parallel;
+struct fsm_parallel_multi;
+
+struct fsm_parallel_buf {
+	const char *buf;
+	size_t n;
+};
+
+/*
+ * The given FSM is expected to be a DFA with a start state, and is not
+ * referenced after compiling. Returns NULL on error; see errno.
+ */
+struct fsm_parallel *
+fsm_parallel_compile(const struct fsm *fsm);
+
+/*
+ * As fsm_parallel_compile(), for fsm_parallel_match_lines() only.
+ */
+struct fsm_parallel *
+fsm_parallel_compile_lines(const struct fsm *fsm);
+
+void
+fsm_parallel_free(struct fsm_parallel *p);
+
+/*
+ * Match the buffer using up to nthreads threads, or if nthreads is 0,
+ * as many as there are processors online. Buffers too small to be worth
+ * splitting are matched by the calling thread alone.
+ *
+ * Returns as for fsm_exec(): 1 on success, with the accepting state
+ * output to *end, or 0 if the input is not matched, or -1 on error.
+ */
+int
+fsm_parallel_match(const struct fsm_parallel *p, const char *buf, size_t n,
+	unsigned nthreads, fsm_state_t *end);
+
+/*
+ * Match each of the n buffers given, setting matched[i] to 1 if buffer i
+ * is matched, and 0 if not. If end is non-NULL, end[i] is set to the
+ * accepting state for each buffer matched, and is left alone otherwise.
+ *
+ * Returns the number of buffers matched.
+ */
+size_t
+fsm_parallel_match_batch(const struct fsm_parallel *p,
+	const struct fsm_parallel_buf *a, size_t n,
+	unsigned char *matched, fsm_state_t *end);
+
+/*
+ * Match each line of the buffer, calling the callback for each line
+ * accepted, in order. The line given excludes its newline, lineno counts
+ * from 0, and end is the accepting state. A final line without a newline
+ * counts as a line.
+ *
+ * If the callback returns 0, matching stops and 0 is returned.
+ * Otherwise returns 1.
+ */
+int
+fsm_parallel_match_lines(const struct fsm_parallel *p, const char *buf, size_t n,
+	void *opaque,
+	int (*callback)(const char *line, size_t len, size_t lineno, fsm_state_t end, void *opaque));
+
+/*
+ * Combine up to FSM_PARALLEL_MULTI_MAX DFAs compiled by
+ * fsm_parallel_compile(). The tables given are not referenced after
+ * combining. Returns NULL on error; see errno.
+ */
+struct fsm_parallel_multi *
+fsm_parallel_multi_compile(const struct fsm_parallel *const p[], size_t n);
+
+void
+fsm_parallel_multi_free(struct fsm_parallel_multi *m);
+
+/*
+ * Match the buffer against each DFA combined, in the order given,
+ * setting matched[] and end[] for each as for fsm_parallel_match_batch().
+ * The AVX2 path applies only when there are 9 to 16 DFAs, per above.
+ *
+ * Returns the number of DFAs which matched.
+ */
+size_t
+fsm_parallel_multi_match(const struct fsm_parallel_multi *m,
+	const char *buf, size_t n,
+	unsigned char *matched, fsm_state_t *end);
+
+#endif
+
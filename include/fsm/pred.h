@@ -31,6 +31,15 @@ fsm_isdfa(const struct fsm *fsm, fsm_state_t state);
 int
 fsm_iscomplete(const struct fsm *fsm, fsm_state_t state);
 
+/*
+ * An absorbing state is one whose every edge leads back to itself,
+ * so that once entered, no further input can change the outcome.
+ * For an end state, this also requires the state to be complete.
+ * A state which is not an end state is absorbing with no edges at all.
+ */
+int
+fsm_isabsorbing(const struct fsm *fsm, fsm_state_t state);
+
 int
 fsm_hasincoming(const struct fsm *fsm, fsm_state_t state);
 
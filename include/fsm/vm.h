@@ -6,6 +6,7 @@
 
 struct fsm;
 struct fsm_dfavm;
+struct fsm_vm_profile;
 
 enum fsm_vm_compile_flags {
 	FSM_VM_COMPILE_PRINT_IR        = 0x0001,
@@ -13,14 +14,23 @@ enum fsm_vm_compile_flags {
 
 	FSM_VM_COMPILE_PRINT_ENC       = 0x0004,
 
-	FSM_VM_COMPILE_OPTIM           = 0X0008
+	FSM_VM_COMPILE_OPTIM           = 0X0008,
+
+	/* match runs of states with a single transition by one instruction */
+	FSM_VM_COMPILE_MATCHS          = 0x0010
 };
 
-#define FSM_VM_COMPILE_DEFAULT_FLAGS FSM_VM_COMPILE_OPTIM
+#define FSM_VM_COMPILE_DEFAULT_FLAGS (FSM_VM_COMPILE_OPTIM | FSM_VM_COMPILE_MATCHS)
 
+/*
+ * FSM_VM_COMPILE_AMD64 produces native code for the host, in memory,
+ * rather than bytecode. It can't be saved, and compiling fails with
+ * ENOTSUP on platforms other than amd64.
+ */
 enum fsm_vm_compile_output {
 	FSM_VM_COMPILE_VM_V1 = 0,
-	FSM_VM_COMPILE_VM_V2 = 1
+	FSM_VM_COMPILE_VM_V2 = 1,
+	FSM_VM_COMPILE_AMD64 = 2
 };
 
 struct fsm_vm_compile_opts {
@@ -28,6 +38,9 @@ struct fsm_vm_compile_opts {
 	enum fsm_vm_compile_output output;
 
 	FILE *log;
+
+	/* execution profile to guide code layout. NULL if not required. */
+	const struct fsm_vm_profile *profile;
 };
 
 struct fsm_dfavm *
@@ -53,5 +66,25 @@ fsm_vm_match_buffer(const struct fsm_dfavm *mv, const char *buf, size_t n);
 
 void fsm_vm_free(struct fsm_dfavm *);
 
+/*
+ * Record how often each state is entered, and each transition taken,
+ * when matching sample input against a DFA. The profile refers to states
+ * by number, and so applies only to that DFA, unchanged; it's intended to
+ * be given to fsm_vm_compile_with_options(), or as fsm_options.vm_profile,
+ * when compiling the same DFA.
+ *
+ * fsm_vm_profile_buffer() returns 1 if the buffer matched, 0 if not,
+ * or -1 on error.
+ */
+struct fsm_vm_profile *
+fsm_vm_profile_new(const struct fsm *fsm);
+
+int
+fsm_vm_profile_buffer(struct fsm_vm_profile *profile, const struct fsm *fsm,
+	const char *buf, size_t n);
+
+void
+fsm_vm_profile_free(struct fsm_vm_profile *profile);
+
 #endif /* FSM_VM_H */
 
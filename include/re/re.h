@@ -150,6 +150,49 @@ re_comp(enum re_dialect dialect,
 	const struct fsm_options *opt,
 	enum re_flags flags, struct re_err *err);
 
+/*
+ * Compile a regexp of the given dialect from the n bytes at s, which need
+ * not be '\0'-terminated. As for re_comp(), but the dialect's lexer reads
+ * from the buffer directly; re_comp() reads the regexp into a buffer
+ * first. For example:
+ *
+ *     re_comp_buf(RE_NATIVE, s, strlen(s), NULL, 0, NULL);
+ *
+ * Returns NULL on error, per re_comp().
+ */
+struct fsm *
+re_comp_buf(enum re_dialect dialect,
+	const char *s, size_t n,
+	const struct fsm_options *opt,
+	enum re_flags flags, struct re_err *err);
+
+/*
+ * An arena holds the parse tree for each regexp compiled by re_comp_arena().
+ * The tree is freed all at once after compiling, and the arena keeps its
+ * memory for the next regexp, rather than allocating and freeing each node
+ * in turn. This suits compiling many regexps in a batch.
+ *
+ * An arena may be used for one compilation at a time only.
+ *
+ * re_arena_new() returns NULL on error; see errno.
+ */
+struct re_arena;
+
+struct re_arena *
+re_arena_new(void);
+
+void
+re_arena_free(struct re_arena *arena);
+
+/*
+ * As for re_comp_buf(), with the parse tree allocated from the given arena.
+ */
+struct fsm *
+re_comp_arena(struct re_arena *arena,
+	enum re_dialect dialect, const char *s, size_t n,
+	const struct fsm_options *opt,
+	enum re_flags flags, struct re_err *err);
+
 /*
  * Return a human-readable string describing a given error code. The string
  * returned has static storage, and must not be freed.
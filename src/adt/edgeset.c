@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <limits.h>
 #include <string.h>
 #include <stdio.h>
 
@@ -19,12 +20,29 @@
 #include <adt/stateset.h>
 #include <adt/edgeset.h>
 
-/* This is a simple linear-probing hash table, keyed by the edge symbol.
- * Since many edge sets only contain a single item, there is a special
+/* Since many edge sets only contain a single item, there is a special
  * case to box the symbol and state ID boxed in the edge_set pointer.
- * Otherwise, the hash table starts with SET_INITIAL buckets and grows
- * as necessary. */
+ *
+ * Otherwise edges are held in one of two representations, chosen by
+ * density. A sparse set is an array of edges sorted by symbol, searched
+ * by bisection. An array may hold several edges for the same symbol
+ * (an NFA), and starts with SET_INITIAL entries, growing as necessary.
+ *
+ * Once an array with at most one edge per symbol holds more than
+ * ARRAY_MAX edges, it becomes dense: a bitmap of the symbols present,
+ * and an array of destinations indexed by the rank of each symbol in
+ * that bitmap. Finding an edge is then a bit test and a popcount.
+ * A dense set reverts to an array if a second edge is added for any
+ * symbol.
+ *
+ * Alongside either representation, a set may have one default
+ * destination, shared by every symbol in a bitmap. This is the "else"
+ * edge for a complete DFA or a "." in a regexp, which would otherwise
+ * cost an edge per symbol. Iterators yield these edges as if they were
+ * stored individually, so callers need not know they exist; callers
+ * which do care can find them by edge_set_default(). */
 #define SET_INITIAL 8
+#define ARRAY_MAX 16
 #define SINGLETON_MAX_STATE             ((~ (uintptr_t) 0U) >> (CHAR_BIT + 1))
 #define SINGLETON_ENCODE(symbol, state) ((void *) ( \
                                         	(((uintptr_t) (state)) << (CHAR_BIT + 1)) | \
@@ -34,25 +52,301 @@
 #define SINGLETON_DECODE_STATE(ptr)     ((fsm_state_t)   (((uintptr_t) (ptr)) >> (CHAR_BIT + 1)))
 #define IS_SINGLETON(ptr)               (((uintptr_t) (ptr)) & 0x1)
 
-/* Used to represent buckets that are not currently used;
- * tombstone is for states that were removed (and can be replaced),
- * but may be followed by other elements due to previous collisions. */
-#define BUCKET_UNUSED ((fsm_state_t)-1)
-#define BUCKET_TOMBSTONE ((fsm_state_t)-2)
-
-/* 32-bit approximation of the inverse golden ratio / UINT32_MAX:
- * (sqrt(5) - 1)/2 -> 0.618, so 0.618 * 0xffffffff. See Knuth 6.4. */
-#define PHI32 0x9e3779b9
+/* Used by rewrite_explicit() for an edge which is to be dropped */
+#define STATE_NONE ((fsm_state_t)-1)
 
 #define EOI_DONE ((size_t)-1)
 #define EOI_SINGLETON_SET ((size_t)-2)
+#define EOI_DEFAULT ((size_t)-3)
 
 struct edge_set {
-	struct fsm_edge *b;	/* buckets */
+	/* Explicit edges. For an array, b[0..count) sorted by symbol;
+	 * for a dense set, dest[0..count) in the order of present. */
+	struct fsm_edge *b;
+	fsm_state_t *dest;
+	uint64_t present[FSM_SIGMA_COUNT / 64];
 	size_t count;
 	size_t ceil;
+	unsigned dense:1;
+	unsigned nondet:1; /* array may have more than one edge per symbol */
+
+	/* The default edge, for each symbol in dmask. No explicit edge
+	 * is <symbol, dstate> for a symbol in dmask. */
+	struct bm dmask;
+	fsm_state_t dstate;
 };
 
+static unsigned
+popcount64(uint64_t x)
+{
+#if defined(__GNUC__)
+	return __builtin_popcountll(x);
+#else
+	unsigned n;
+
+	/* peter wegner's method, as for bm_count() */
+	for (n = 0; x != 0; x &= x - 1) {
+		n++;
+	}
+
+	return n;
+#endif
+}
+
+static int
+dense_has(const struct edge_set *set, unsigned char symbol)
+{
+	return (set->present[symbol / 64] >> (symbol % 64)) & 1;
+}
+
+/* The index into dest[] for a symbol */
+static size_t
+dense_rank(const struct edge_set *set, unsigned char symbol)
+{
+	const uint64_t below = ((uint64_t) 1 << (symbol % 64)) - 1;
+	size_t r;
+	unsigned i;
+
+	r = 0;
+	for (i = 0; i < symbol / 64; i++) {
+		r += popcount64(set->present[i]);
+	}
+
+	return r + popcount64(set->present[symbol / 64] & below);
+}
+
+/* The first present symbol >= i, or FSM_SIGMA_COUNT if there is none */
+static unsigned
+dense_next(const struct edge_set *set, unsigned i)
+{
+	while (i < FSM_SIGMA_COUNT) {
+		const uint64_t w = set->present[i / 64] >> (i % 64);
+		if (w != 0) {
+			/* count trailing zeroes */
+			return i + popcount64((w & (~w + 1)) - 1);
+		}
+
+		i = (i / 64 + 1) * 64;
+	}
+
+	return FSM_SIGMA_COUNT;
+}
+
+/* The index of the first edge with a symbol >= the given symbol */
+static size_t
+array_lower(const struct edge_set *set, unsigned symbol)
+{
+	size_t lo, hi;
+
+	assert(!set->dense);
+
+	lo = 0;
+	hi = set->count;
+
+	while (lo < hi) {
+		const size_t mid = lo + (hi - lo) / 2;
+		if (set->b[mid].symbol < symbol) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	return lo;
+}
+
+static int
+has_default(const struct edge_set *set)
+{
+	size_t i;
+
+	assert(set != NULL && !IS_SINGLETON(set));
+
+	for (i = 0; i < sizeof set->dmask.map; i++) {
+		if (set->dmask.map[i] != 0) {
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+static int
+is_default(const struct edge_set *set, unsigned char symbol, fsm_state_t state)
+{
+	assert(set != NULL && !IS_SINGLETON(set));
+
+	return bm_get(&set->dmask, symbol) && set->dstate == state;
+}
+
+/*
+ * Map each explicit edge's state by f, dropping edges for which f
+ * returns STATE_NONE. If dedup is set, an edge which becomes the same
+ * as another edge for that symbol is also dropped; this can only
+ * happen for an array.
+ */
+static void
+rewrite_explicit(struct edge_set *set,
+	fsm_state_t (*f)(const struct edge_set *, unsigned char, fsm_state_t, const void *),
+	const void *opaque, int dedup)
+{
+	size_t i, j;
+
+	assert(set != NULL && !IS_SINGLETON(set));
+
+	if (set->dense) {
+		unsigned s;
+
+		j = 0;
+		for (s = dense_next(set, 0), i = 0; s < FSM_SIGMA_COUNT; s = dense_next(set, s + 1), i++) {
+			const fsm_state_t to = f(set, s, set->dest[i], opaque);
+
+			if (to == STATE_NONE) {
+				set->present[s / 64] &= ~((uint64_t) 1 << (s % 64));
+				continue;
+			}
+
+			set->dest[j++] = to;
+		}
+
+		assert(i == set->count);
+		set->count = j;
+		return;
+	}
+
+	{
+		size_t run;
+		int nondet;
+
+		run = 0;
+		nondet = 0;
+
+		for (i = 0, j = 0; i < set->count; i++) {
+			const unsigned char symbol = set->b[i].symbol;
+			const fsm_state_t to = f(set, symbol, set->b[i].state, opaque);
+			size_t k;
+
+			if (j == 0 || set->b[j - 1].symbol != symbol) {
+				run = j;
+			}
+
+			if (to == STATE_NONE) {
+				continue;
+			}
+
+			if (dedup) {
+				for (k = run; k < j; k++) {
+					if (set->b[k].state == to) {
+						break;
+					}
+				}
+
+				if (k < j) {
+					continue;
+				}
+			}
+
+			if (run < j) {
+				nondet = 1;
+			}
+
+			set->b[j].symbol = symbol;
+			set->b[j].state  = to;
+			j++;
+		}
+
+		set->count  = j;
+		set->nondet = nondet;
+	}
+}
+
+static fsm_state_t
+drop_default(const struct edge_set *set, unsigned char symbol, fsm_state_t state,
+	const void *opaque)
+{
+	(void) opaque;
+
+	return is_default(set, symbol, state) ? STATE_NONE : state;
+}
+
+/* Drop explicit edges which duplicate the default edge. */
+static void
+dedup_default(struct edge_set *set)
+{
+	rewrite_explicit(set, drop_default, NULL, 0);
+}
+
+/* Convert a deterministic array to a dense set. On failure to
+ * allocate, the set is left as it was, which is harmless. */
+static void
+densify(const struct fsm_alloc *alloc, struct edge_set *set)
+{
+	fsm_state_t *dest;
+	size_t ceil, i;
+
+	assert(!set->dense && !set->nondet);
+
+	for (ceil = SET_INITIAL; ceil < set->count * 2 && ceil < FSM_SIGMA_COUNT; ceil *= 2)
+		;
+
+	dest = f_malloc(alloc, ceil * sizeof *dest);
+	if (dest == NULL) {
+		return;
+	}
+
+	memset(set->present, 0x00, sizeof set->present);
+
+	for (i = 0; i < set->count; i++) {
+		const unsigned char symbol = set->b[i].symbol;
+
+		assert(!dense_has(set, symbol));
+
+		set->present[symbol / 64] |= (uint64_t) 1 << (symbol % 64);
+		dest[i] = set->b[i].state;
+	}
+
+	f_free(alloc, set->b);
+
+	set->b     = NULL;
+	set->dest  = dest;
+	set->ceil  = ceil;
+	set->dense = 1;
+}
+
+static int
+undensify(const struct fsm_alloc *alloc, struct edge_set *set)
+{
+	struct fsm_edge *b;
+	size_t ceil, i;
+	unsigned s;
+
+	assert(set->dense);
+
+	for (ceil = SET_INITIAL; ceil <= set->count; ceil *= 2)
+		;
+
+	b = f_malloc(alloc, ceil * sizeof *b);
+	if (b == NULL) {
+		return 0;
+	}
+
+	for (s = dense_next(set, 0), i = 0; s < FSM_SIGMA_COUNT; s = dense_next(set, s + 1), i++) {
+		b[i].symbol = s;
+		b[i].state  = set->dest[i];
+	}
+
+	assert(i == set->count);
+
+	f_free(alloc, set->dest);
+
+	set->dest  = NULL;
+	set->b     = b;
+	set->ceil  = ceil;
+	set->dense = 0;
+
+	return 1;
+}
+
 struct edge_set *
 edge_set_new(void)
 {
@@ -69,16 +363,18 @@ edge_set_create(const struct fsm_alloc *a)
 		return NULL;
 	}
 
-	set->b = f_malloc(a, SET_INITIAL * sizeof *set->b);
-	if (set->b == NULL) {
-		f_free(a, set);
-		return NULL;
-	}
-	memset(set->b, 0xff, SET_INITIAL * sizeof *set->b);
-	assert(set->b[0].state == BUCKET_UNUSED);
-
+	/* arrays are allocated on demand; a set may have only a default */
+	set->b     = NULL;
+	set->dest  = NULL;
 	set->count = 0;
-	set->ceil = SET_INITIAL;
+	set->ceil  = 0;
+	set->dense = 0;
+	set->nondet = 0;
+
+	memset(set->present, 0x00, sizeof set->present);
+
+	bm_clear(&set->dmask);
+	set->dstate = 0;
 
 	return set;
 }
@@ -94,59 +390,100 @@ edge_set_free(const struct fsm_alloc *alloc, struct edge_set *set)
 		return;
 	}
 
-	assert(set->b != NULL);
-
 	f_free(alloc, set->b);
+	f_free(alloc, set->dest);
 	f_free(alloc, set);
 }
 
 static int
-grow_buckets(const struct fsm_alloc *alloc, struct edge_set *set)
+array_insert(const struct fsm_alloc *alloc, struct edge_set *set,
+	unsigned char symbol, fsm_state_t state)
 {
-	struct fsm_edge *nb, *ob = set->b; /* new and old buckets */
-	const size_t oceil = set->ceil;
-	const size_t nceil = 2 * oceil;
-	const size_t nmask = nceil - 1;
-	size_t o_i, n_i, added;
+	size_t lo, hi;
 
-	/* assumed to be a power of 2 */
-	assert((nceil & nmask) == 0);
+	assert(!set->dense);
 
-	nb = f_malloc(alloc, nceil * sizeof *nb);
-	if (nb == NULL) {
-		return 0;
+	lo = array_lower(set, symbol);
+
+	for (hi = lo; hi < set->count && set->b[hi].symbol == symbol; hi++) {
+		if (set->b[hi].state == state) {
+			return 1; /* already present */
+		}
 	}
-	memset(nb, 0xff, nceil * sizeof *nb);
-	assert(nb[0].state == BUCKET_UNUSED);
 
-	added = 0;
-	for (o_i = 0; o_i < oceil; o_i++) {
-		unsigned h;
-		const fsm_state_t bs = ob[o_i].state;
-		if (bs == BUCKET_UNUSED || bs == BUCKET_TOMBSTONE) {
-			continue;
+	if (set->count == set->ceil) {
+		const size_t nceil = set->ceil == 0 ? SET_INITIAL : set->ceil * 2;
+		struct fsm_edge *nb;
+
+		nb = f_realloc(alloc, set->b, nceil * sizeof *nb);
+		if (nb == NULL) {
+			return 0;
 		}
 
-		h = PHI32 * ob[o_i].symbol;
-		for (n_i = 0; n_i < nceil; n_i++) {
-			const size_t b_i = (h + n_i) & nmask;
-			if (nb[b_i].state != BUCKET_UNUSED) {
-				assert(nb[b_i].state != BUCKET_TOMBSTONE);
-				continue;
-			}
+		set->b    = nb;
+		set->ceil = nceil;
+	}
+
+	/* new edges for a symbol go after any existing ones */
+	memmove(&set->b[hi + 1], &set->b[hi], (set->count - hi) * sizeof *set->b);
+	set->b[hi].symbol = symbol;
+	set->b[hi].state  = state;
+	set->count++;
+
+	if (hi > lo) {
+		set->nondet = 1;
+	}
+
+	if (!set->nondet && set->count > ARRAY_MAX) {
+		densify(alloc, set);
+	}
+
+	return 1;
+}
+
+static int
+dense_insert(const struct fsm_alloc *alloc, struct edge_set *set,
+	unsigned char symbol, fsm_state_t state)
+{
+	size_t r;
+
+	assert(set->dense);
+
+	r = dense_rank(set, symbol);
 
-			nb[b_i].symbol = ob[o_i].symbol;
-			nb[b_i].state = ob[o_i].state;
-			added++;
-			break;
+	if (dense_has(set, symbol)) {
+		if (set->dest[r] == state) {
+			return 1; /* already present */
 		}
+
+		/* a second edge for this symbol; only an array can hold that */
+		if (!undensify(alloc, set)) {
+			return 0;
+		}
+
+		return array_insert(alloc, set, symbol, state);
 	}
-	assert(added == set->count);
 
-	f_free(alloc, ob);
+	if (set->count == set->ceil) {
+		const size_t nceil = set->ceil * 2;
+		fsm_state_t *nd;
+
+		assert(nceil <= FSM_SIGMA_COUNT);
+
+		nd = f_realloc(alloc, set->dest, nceil * sizeof *nd);
+		if (nd == NULL) {
+			return 0;
+		}
+
+		set->dest = nd;
+		set->ceil = nceil;
+	}
+
+	memmove(&set->dest[r + 1], &set->dest[r], (set->count - r) * sizeof *set->dest);
+	set->dest[r] = state;
+	set->present[symbol / 64] |= (uint64_t) 1 << (symbol % 64);
+	set->count++;
 
-	set->b = nb;
-	set->ceil = nceil;
 	return 1;
 }
 
@@ -168,6 +505,10 @@ edge_set_add(struct edge_set **setp, const struct fsm_alloc *alloc,
 		prev_symbol = SINGLETON_DECODE_SYMBOL(*setp);
 		prev_state  = SINGLETON_DECODE_STATE(*setp);
 
+		if (prev_symbol == symbol && prev_state == state) {
+			return 1; /* already present */
+		}
+
 		*setp = edge_set_create(alloc);
 		if (*setp == NULL) {
 			return 0;
@@ -175,7 +516,6 @@ edge_set_add(struct edge_set **setp, const struct fsm_alloc *alloc,
 
 		assert(!IS_SINGLETON(*setp));
 
-		/* TODO: bulk add */
 		if (!edge_set_add(setp, alloc, prev_symbol, prev_state)) {
 			return 0;
 		}
@@ -197,63 +537,90 @@ edge_set_add(struct edge_set **setp, const struct fsm_alloc *alloc,
 
 	set = *setp;
 
-	/* Grow buckets at 50% capacity */
-	if (set->count == set->ceil/2) {
-		if (!grow_buckets(alloc, set)) {
+	if (is_default(set, symbol, state)) {
+		return 1; /* already present */
+	}
+
+	if (set->dense) {
+		return dense_insert(alloc, set, symbol, state);
+	}
+
+	return array_insert(alloc, set, symbol, state);
+}
+
+int
+edge_set_add_bulk(struct edge_set **setp, const struct fsm_alloc *alloc,
+	const struct bm *symbols, fsm_state_t state)
+{
+	struct edge_set *set;
+	int i;
+
+	assert(setp != NULL);
+	assert(symbols != NULL);
+
+	if (bm_count(symbols) == 0) {
+		return 1;
+	}
+
+	if (*setp == NULL || IS_SINGLETON(*setp)) {
+		struct edge_set *prev = *setp;
+
+		*setp = edge_set_create(alloc);
+		if (*setp == NULL) {
 			return 0;
 		}
+
+		if (prev != NULL) {
+			if (!edge_set_add(setp, alloc, SINGLETON_DECODE_SYMBOL(prev), SINGLETON_DECODE_STATE(prev))) {
+				return 0;
+			}
+		}
 	}
 
-	{
-		const size_t mask = set->ceil - 1;
-		const unsigned h = PHI32 * symbol;
-
-		int has_tombstone_candidate = 0;
-		size_t tc_pos;
-
-		size_t i;
-		for (i = 0; i < set->ceil; i++) {
-			const size_t b_i = (h + i) & mask;
-			const fsm_state_t bs = set->b[b_i].state;
-
-			/* Continue past a tombstone, but note where
-			 * it was -- as long as the value being added
-			 * isn't already present later, we can add it there.
-			 * This fills the first tombstone, if there are more
-			 * than one, because search will find it sooner. */
-			if (bs == BUCKET_TOMBSTONE) {
-				if (!has_tombstone_candidate) {
-					has_tombstone_candidate = 1;
-					tc_pos = b_i;
+	set = *setp;
+
+	/*
+	 * There's only one default per set, so where two groups of symbols
+	 * go to different states, the larger group becomes the default and
+	 * the other is stored as explicit edges.
+	 */
+	if (has_default(set) && set->dstate != state) {
+		struct bm prev;
+		fsm_state_t prev_state;
+
+		if (bm_count(symbols) <= bm_count(&set->dmask)) {
+			i = -1;
+			while (i = bm_next(symbols, i, 1), i <= UCHAR_MAX) {
+				if (!edge_set_add(setp, alloc, i, state)) {
+					return 0;
 				}
-				continue;
-			} else if (bs == BUCKET_UNUSED) {
-				const size_t pos = (has_tombstone_candidate
-				    ? tc_pos : b_i);
-				set->b[pos].state = state;
-				set->b[pos].symbol = symbol;
-				set->count++;
-
-				assert(edge_set_contains(set, symbol));
-				return 1;
-			} else if (bs == state && set->b[b_i].symbol == symbol) {
-				return 1; /* already present */
-			} else {
-				/* ignore other edges */
-				continue;
 			}
-		}
 
-		if (has_tombstone_candidate) {
-			set->b[tc_pos].state = state;
-			set->b[tc_pos].symbol = symbol;
-			set->count++;
 			return 1;
 		}
 
-		assert(!"unreachable");
-		return 0;
+		prev = set->dmask;
+		prev_state = set->dstate;
+
+		bm_clear(&set->dmask);
+
+		i = -1;
+		while (i = bm_next(&prev, i, 1), i <= UCHAR_MAX) {
+			if (!edge_set_add(setp, alloc, i, prev_state)) {
+				return 0;
+			}
+		}
 	}
+
+	for (i = 0; i < (int) sizeof set->dmask.map; i++) {
+		set->dmask.map[i] |= symbols->map[i];
+	}
+
+	set->dstate = state;
+
+	dedup_default(set);
+
+	return 1;
 }
 
 int
@@ -281,12 +648,10 @@ edge_set_find(const struct edge_set *set, unsigned char symbol,
 {
 	assert(e != NULL);
 
-	if (edge_set_empty(set)) {
+	if (set == NULL) {
 		return 0;
 	}
 
-	assert(set != NULL);
-
 	if (IS_SINGLETON(set)) {
 		if (SINGLETON_DECODE_SYMBOL(set) == symbol) {
 			e->symbol = symbol;
@@ -294,28 +659,51 @@ edge_set_find(const struct edge_set *set, unsigned char symbol,
 			return 1;
 		}
 		return 0;
+	}
+
+	if (set->dense) {
+		if (dense_has(set, symbol)) {
+			e->symbol = symbol;
+			e->state  = set->dest[dense_rank(set, symbol)];
+			return 1;
+		}
 	} else {
-		const size_t mask = set->ceil - 1;
-		const unsigned h = PHI32 * symbol;
-		size_t i;
-		for (i = 0; i < set->ceil; i++) {
-			const size_t b_i = (h + i) & mask;
-			const fsm_state_t bs = set->b[b_i].state;
-			if (bs == BUCKET_UNUSED) {
-				break;
-			} else if (bs == BUCKET_TOMBSTONE) {
-				continue; /* search past deleted */
-			} else if (set->b[b_i].symbol == symbol) {
-				memcpy(e, &set->b[b_i], sizeof *e);
-				return 1; /* found */
-			}
+		const size_t i = array_lower(set, symbol);
+		if (i < set->count && set->b[i].symbol == symbol) {
+			*e = set->b[i];
+			return 1;
 		}
 	}
 
+	if (bm_get(&set->dmask, symbol)) {
+		e->symbol = symbol;
+		e->state  = set->dstate;
+		return 1;
+	}
+
 	/* not found */
 	return 0;
 }
 
+int
+edge_set_default(const struct edge_set *set,
+	struct bm *symbols, fsm_state_t *state)
+{
+	if (edge_set_empty(set) || IS_SINGLETON(set) || !has_default(set)) {
+		return 0;
+	}
+
+	if (symbols != NULL) {
+		*symbols = set->dmask;
+	}
+
+	if (state != NULL) {
+		*state = set->dstate;
+	}
+
+	return 1;
+}
+
 int
 edge_set_contains(const struct edge_set *set, unsigned char symbol)
 {
@@ -350,17 +738,32 @@ edge_set_hasnondeterminism(const struct edge_set *set, struct bm *bm)
 		return 0;
 	}
 
-	for (i = 0; i < set->ceil; i++) {
-		const fsm_state_t bs = set->b[i].state;
-		if (bs == BUCKET_UNUSED || bs == BUCKET_TOMBSTONE) {
-			continue; /* no element */
+	if (set->dense) {
+		unsigned s;
+
+		for (s = dense_next(set, 0); s < FSM_SIGMA_COUNT; s = dense_next(set, s + 1)) {
+			if (bm_get(bm, s)) {
+				return 1;
+			}
+
+			bm_set(bm, s);
 		}
+	} else {
+		for (i = 0; i < set->count; i++) {
+			if (bm_get(bm, set->b[i].symbol)) {
+				return 1;
+			}
+
+			bm_set(bm, set->b[i].symbol);
+		}
+	}
 
-		if (bm_get(bm, set->b[i].symbol)) {
+	for (i = 0; i < sizeof bm->map; i++) {
+		if (bm->map[i] & set->dmask.map[i]) {
 			return 1;
 		}
 
-		bm_set(bm, set->b[i].symbol);
+		bm->map[i] |= set->dmask.map[i];
 	}
 
 	return 0;
@@ -394,9 +797,49 @@ edge_set_count(const struct edge_set *set)
 		return 1;
 	}
 
-	assert(set->b != NULL);
+	return set->count + bm_count(&set->dmask);
+}
+
+/* Copy a set wholesale, for adding to an empty set */
+static struct edge_set *
+edge_set_clone(const struct fsm_alloc *alloc, const struct edge_set *src)
+{
+	struct edge_set *set;
+
+	assert(src != NULL && !IS_SINGLETON(src));
+
+	set = f_malloc(alloc, sizeof *set);
+	if (set == NULL) {
+		return NULL;
+	}
+
+	*set = *src;
+	set->b    = NULL;
+	set->dest = NULL;
+
+	if (src->dense) {
+		set->dest = f_malloc(alloc, src->ceil * sizeof *set->dest);
+		if (set->dest == NULL) {
+			goto error;
+		}
 
-	return set->count;
+		memcpy(set->dest, src->dest, src->count * sizeof *set->dest);
+	} else if (src->ceil > 0) {
+		set->b = f_malloc(alloc, src->ceil * sizeof *set->b);
+		if (set->b == NULL) {
+			goto error;
+		}
+
+		memcpy(set->b, src->b, src->count * sizeof *set->b);
+	}
+
+	return set;
+
+error:
+
+	f_free(alloc, set);
+
+	return NULL;
 }
 
 int
@@ -420,7 +863,20 @@ edge_set_copy(struct edge_set **dst, const struct fsm_alloc *alloc,
 		return 1;
 	}
 
-	for (edge_set_reset(src, &jt); edge_set_next(&jt, &e); ) {
+	if (*dst == NULL) {
+		*dst = edge_set_clone(alloc, src);
+		if (*dst == NULL) {
+			return 0;
+		}
+
+		return 1;
+	}
+
+	if (!edge_set_add_bulk(dst, alloc, &src->dmask, src->dstate)) {
+		return 0;
+	}
+
+	for (edge_set_reset_explicit(src, &jt); edge_set_next(&jt, &e); ) {
 		/* TODO: bulk add */
 		if (!edge_set_add(dst, alloc, e.symbol, e.state)) {
 			return 0;
@@ -448,38 +904,51 @@ edge_set_remove(struct edge_set **setp, unsigned char symbol)
 
 	if (edge_set_empty(set)) {
 		return;
-	} else {
-		const size_t mask = set->ceil - 1;
-		const unsigned h = PHI32 * symbol;
-		size_t i;
-		for (i = 0; i < set->ceil; i++) {
-			const size_t b_i = (h + i) & mask;
-			const fsm_state_t bs = set->b[b_i].state;
-			if (bs == BUCKET_UNUSED) {
-				break; /* not found */
-			} else if (set->b[b_i].symbol == symbol
-			    && set->b[b_i].state != BUCKET_TOMBSTONE) {
-				/* Set to a distinct marker for a deleted
-				 * entry; there may be entries past this
-				 * due to collisions that still need to
-				 * be checked. */
-				set->b[b_i].state = BUCKET_TOMBSTONE;
-				set->count--;
-			}
+	}
+
+	if (set->dense) {
+		if (dense_has(set, symbol)) {
+			const size_t r = dense_rank(set, symbol);
+
+			memmove(&set->dest[r], &set->dest[r + 1], (set->count - r - 1) * sizeof *set->dest);
+			set->present[symbol / 64] &= ~((uint64_t) 1 << (symbol % 64));
+			set->count--;
 		}
+	} else {
+		size_t lo, hi;
+
+		lo = array_lower(set, symbol);
+		for (hi = lo; hi < set->count && set->b[hi].symbol == symbol; hi++)
+			;
+
+		memmove(&set->b[lo], &set->b[hi], (set->count - hi) * sizeof *set->b);
+		set->count -= hi - lo;
 	}
 
+	set->dmask.map[symbol / CHAR_BIT] &= ~(1U << symbol % CHAR_BIT);
+
 	assert(!edge_set_contains(set, symbol));
 }
 
+static fsm_state_t
+drop_state(const struct edge_set *set, unsigned char symbol, fsm_state_t state,
+	const void *opaque)
+{
+	const fsm_state_t *s = opaque;
+
+	(void) set;
+	(void) symbol;
+
+	return state == *s ? STATE_NONE : state;
+}
+
 void
 edge_set_remove_state(struct edge_set **setp, fsm_state_t state)
 {
 	struct edge_set *set;
-	size_t i;
 
 	assert(setp != NULL);
-	assert(state != BUCKET_UNUSED && state != BUCKET_TOMBSTONE);
+	assert(state != STATE_NONE);
 
 	if (IS_SINGLETON(*setp)) {
 		if (SINGLETON_DECODE_STATE(*setp) == state) {
@@ -495,20 +964,39 @@ edge_set_remove_state(struct edge_set **setp, fsm_state_t state)
 	}
 
 	/* Remove all edges with that state */
-	for (i = 0; i < set->ceil; i++) {
-		if (set->b[i].state == state) {
-			set->b[i].state = BUCKET_TOMBSTONE;
-			set->count--;
-		}
+	rewrite_explicit(set, drop_state, &state, 0);
+
+	if (set->dstate == state) {
+		bm_clear(&set->dmask);
 	}
 }
 
+struct remap_env {
+	fsm_state_remap_fun *remap;
+	const void *opaque;
+};
+
+static fsm_state_t
+remap_state(const struct edge_set *set, unsigned char symbol, fsm_state_t state,
+	const void *opaque)
+{
+	const struct remap_env *env = opaque;
+	fsm_state_t to;
+
+	(void) set;
+	(void) symbol;
+
+	to = env->remap(state, env->opaque);
+
+	return to == FSM_STATE_REMAP_NO_STATE ? STATE_NONE : to;
+}
+
 void
 edge_set_compact(struct edge_set **setp,
     fsm_state_remap_fun *remap, const void *opaque)
 {
 	struct edge_set *set;
-	size_t i;
+	struct remap_env env;
 
 	assert(setp != NULL);
 
@@ -531,24 +1019,23 @@ edge_set_compact(struct edge_set **setp,
 		return;
 	}
 
-	i = 0;
-	for (i = 0; i < set->ceil; i++) {
-		const fsm_state_t to = set->b[i].state;
-		fsm_state_t new_to;
-		if (to == BUCKET_UNUSED || to == BUCKET_TOMBSTONE) {
-			continue;
-		}
-		new_to = remap(to, opaque);
+	env.remap  = remap;
+	env.opaque = opaque;
 
-		if (new_to == FSM_STATE_REMAP_NO_STATE) { /* drop */
-			set->b[i].state = BUCKET_TOMBSTONE;
-			set->count--;
-		} else {	/* keep */
-			set->b[i].state = new_to;
+	rewrite_explicit(set, remap_state, &env, 0);
+
+	if (has_default(set)) {
+		const fsm_state_t new_to = remap(set->dstate, opaque);
+
+		if (new_to == FSM_STATE_REMAP_NO_STATE) {
+			bm_clear(&set->dmask);
+		} else {
+			set->dstate = new_to;
+			dedup_default(set);
 		}
 	}
 
-	/* todo: if set->count < set->ceil/2, shrink buckets */
+	/* todo: if set->count < set->ceil/2, shrink */
 }
 
 void
@@ -556,50 +1043,104 @@ edge_set_reset(const struct edge_set *set, struct edge_iter *it)
 {
 	it->i = 0;
 	it->set = set;
+	it->defaults = 1;
+}
+
+void
+edge_set_reset_explicit(const struct edge_set *set, struct edge_iter *it)
+{
+	it->i = 0;
+	it->set = set;
+	it->defaults = 0;
 }
 
 int
 edge_set_next(struct edge_iter *it, struct fsm_edge *e)
 {
+	const struct edge_set *set;
+	size_t n;
+
 	assert(it != NULL);
 	assert(e != NULL);
 
-	if (it->set == NULL) {
+	set = it->set;
+
+	if (set == NULL) {
 		return 0;
 	}
 
-	if (IS_SINGLETON(it->set)) {
+	if (IS_SINGLETON(set)) {
 		if (it->i >= 1) {
 			return 0;
 		}
 
-		e->symbol = SINGLETON_DECODE_SYMBOL(it->set);
-		e->state  = SINGLETON_DECODE_STATE(it->set);
+		e->symbol = SINGLETON_DECODE_SYMBOL(set);
+		e->state  = SINGLETON_DECODE_STATE(set);
 
 		it->i++;
 
 		return 1;
 	}
 
-	while (it->i < it->set->ceil) {
-		const fsm_state_t bs = it->set->b[it->i].state;
-		if (bs == BUCKET_UNUSED || bs == BUCKET_TOMBSTONE) {
+	/*
+	 * it->i counts through the explicit edges (by index for an array,
+	 * by symbol for a dense set), and then past n by symbol through
+	 * the default edge.
+	 */
+	if (set->dense) {
+		n = FSM_SIGMA_COUNT;
+
+		if (it->i < n) {
+			const unsigned s = dense_next(set, it->i);
+			if (s < FSM_SIGMA_COUNT) {
+				e->symbol = s;
+				e->state  = set->dest[dense_rank(set, s)];
+				it->i = s + 1;
+				return 1;
+			}
+
+			it->i = n;
+		}
+	} else {
+		n = set->count;
+
+		if (it->i < n) {
+			*e = set->b[it->i];
 			it->i++;
-			continue;
+			return 1;
+		}
+	}
+
+	if (it->defaults) {
+		const size_t symbol = bm_next(&set->dmask,
+			(int) (it->i - n) - 1, 1);
+		if (symbol <= UCHAR_MAX) {
+			e->symbol = symbol;
+			e->state  = set->dstate;
+			it->i = n + symbol + 1;
+			return 1;
 		}
-		*e = it->set->b[it->i];
-		it->i++;
-		return 1;
 	}
 
 	return 0;
 }
 
+static fsm_state_t
+rebase_state(const struct edge_set *set, unsigned char symbol, fsm_state_t state,
+	const void *opaque)
+{
+	const fsm_state_t *base = opaque;
+
+	(void) set;
+	(void) symbol;
+
+	return state + *base;
+}
+
 void
 edge_set_rebase(struct edge_set **setp, fsm_state_t base)
 {
 	struct edge_set *set;
-	size_t i;
 
 	assert(setp != NULL);
 
@@ -623,24 +1164,38 @@ edge_set_rebase(struct edge_set **setp, fsm_state_t base)
 		return;
 	}
 
-	for (i = 0; i < set->ceil; i++) {
-		const fsm_state_t bs = set->b[i].state;
-		if (bs == BUCKET_UNUSED || bs == BUCKET_TOMBSTONE) {
-			continue;
-		}
-		set->b[i].state += base;
+	rewrite_explicit(set, rebase_state, &base, 0);
+
+	if (has_default(set)) {
+		set->dstate += base;
 	}
 }
 
+struct replace_env {
+	fsm_state_t old;
+	fsm_state_t new;
+};
+
+static fsm_state_t
+replace_state(const struct edge_set *set, unsigned char symbol, fsm_state_t state,
+	const void *opaque)
+{
+	const struct replace_env *env = opaque;
+
+	(void) set;
+	(void) symbol;
+
+	return state == env->old ? env->new : state;
+}
+
 void
 edge_set_replace_state(struct edge_set **setp, fsm_state_t old, fsm_state_t new)
 {
 	struct edge_set *set;
-	size_t i;
+	struct replace_env env;
 
 	assert(setp != NULL);
-	assert(old != BUCKET_UNUSED);
-	assert(old != BUCKET_TOMBSTONE);
+	assert(old != STATE_NONE);
 
 	if (IS_SINGLETON(*setp)) {
 		if (SINGLETON_DECODE_STATE(*setp) == old) {
@@ -661,35 +1216,19 @@ edge_set_replace_state(struct edge_set **setp, fsm_state_t old, fsm_state_t new)
 		return;
 	}
 
-	for (i = 0; i < set->ceil; i++) {
-		if (set->b[i].state == old) {
-			set->b[i].state = new;
-		}
-	}
+	env.old = old;
+	env.new = new;
 
 	/* If there is now more than one edge <label, new> for
-	 * any label, then the later ones need to be removed and
-	 * the count adjusted. */
-	{
-		uint64_t seen[4];
-		memset(seen, 0x00, sizeof(seen));
-		for (i = 0; i < set->ceil; i++) {
-			const fsm_state_t bs = set->b[i].state;
-			unsigned char symbol;
-			uint64_t bit;
-			if (bs != new) {
-				continue;
-			}
-			symbol = set->b[i].symbol;
-			bit = (uint64_t)1 << (symbol & 63);
-			if (seen[symbol/64] & bit) {
-				/* remove duplicate, update count */
-				set->b[i].state = BUCKET_TOMBSTONE;
-				set->count--;
-			} else {
-				seen[symbol/64] |= bit;
-			}
+	 * any label, then the later ones are removed. */
+	rewrite_explicit(set, replace_state, &env, 1);
+
+	if (has_default(set)) {
+		if (set->dstate == old) {
+			set->dstate = new;
 		}
+
+		dedup_default(set);
 	}
 }
 
@@ -704,88 +1243,68 @@ edge_set_empty(const struct edge_set *set)
 		return 0;
 	}
 
-	return set->count == 0;
+	return set->count == 0 && !has_default(set);
+}
+
+/* The first symbol >= i with any edge, or FSM_SIGMA_COUNT if none */
+static unsigned
+next_symbol(const struct edge_set *set, unsigned i)
+{
+	unsigned s, d;
+
+	if (i >= FSM_SIGMA_COUNT) {
+		return FSM_SIGMA_COUNT;
+	}
+
+	if (set->dense) {
+		s = dense_next(set, i);
+	} else {
+		const size_t j = array_lower(set, i);
+		s = j < set->count ? set->b[j].symbol : FSM_SIGMA_COUNT;
+	}
+
+	d = bm_next(&set->dmask, (int) i - 1, 1);
+
+	return d < s ? d : s;
+}
+
+/* Point the iterator at the explicit edges for a symbol */
+static void
+eoi_seek(struct edge_ordered_iter *eoi, unsigned symbol)
+{
+	if (symbol >= FSM_SIGMA_COUNT) {
+		eoi->pos = EOI_DONE;
+		return;
+	}
+
+	eoi->symbol = symbol;
+	eoi->pos = eoi->set->dense ? 0 : array_lower(eoi->set, symbol);
 }
 
 void
 edge_set_ordered_iter_reset_to(const struct edge_set *set,
     struct edge_ordered_iter *eoi, unsigned char symbol)
 {
-	/* Create an ordered iterator for the hash table by figuring
-	 * out which symbols are present (0x00 <= x <= 0xff, tracked
-	 * in a bit set) and either yielding the next bucket for the
-	 * current symbol or advancing to the next symbol present. */
+	/* Edges are held in symbol order already, so the ordered iterator
+	 * just needs to interleave the default edge. The default edge for
+	 * a symbol, if any, follows its explicit edges. */
 
-	size_t i, found, mask;
 	memset(eoi, 0x00, sizeof(*eoi));
 
+	eoi->set = set;
 	eoi->symbol = symbol;
 
 	/* Check for special case unboxed sets first. */
 	if (IS_SINGLETON(set)) {
-		eoi->set = set;
-		eoi->pos = EOI_SINGLETON_SET;
+		eoi->pos = SINGLETON_DECODE_SYMBOL(set) >= symbol
+			? EOI_SINGLETON_SET : EOI_DONE;
 		return;
 	} else if (edge_set_empty(set)) {
 		eoi->pos = EOI_DONE;
 		return;
 	}
 
-	found = 0;
-	for (i = 0; i < set->ceil; i++) {
-		const fsm_state_t bs = set->b[i].state;
-		unsigned char symbol;
-		if (bs == BUCKET_UNUSED || bs == BUCKET_TOMBSTONE) {
-			continue;
-		}
-
-		symbol = set->b[i].symbol;
-		eoi->symbols_used[symbol/64] |= ((uint64_t)1 << (symbol & 63));
-		found++;
-	}
-	assert(found == set->count);
-	mask = set->ceil - 1;
-
-	/* Start out pointing to the first bucket with a matching symbol,
-	 * or the first unused bucket if not present. */
-	{
-		const unsigned h = PHI32 * eoi->symbol;
-		for (i = 0; i < set->ceil; i++) {
-			const size_t b_i = (h + i) & mask;
-			const fsm_state_t bs = set->b[b_i].state;
-			if (bs == BUCKET_TOMBSTONE) {
-				continue; /* search past deleted */
-			} else if (bs == BUCKET_UNUSED) {
-				eoi->pos = b_i; /* will advance to next symbol */
-				break;
-			} else if (set->b[b_i].symbol == eoi->symbol) {
-				eoi->pos = b_i; /* pointing at first bucket */
-				break;
-			} else {
-				continue; /* find first entry with symbol */
-			}
-		}
-	}
-
-	eoi->set = set;
-}
-
-static int
-advance_symbol(struct edge_ordered_iter *eoi)
-{
-	unsigned i = eoi->symbol + 1;
-	while (i < 0x100) {
-		if (eoi->symbols_used[i/64] & ((uint64_t)1 << (i & 63))) {
-			eoi->symbol = i;
-			return 1;
-		}
-		i++;
-	}
-
-	eoi->pos = EOI_DONE;
-	eoi->steps = 0;
-
-	return 0;
+	eoi_seek(eoi, next_symbol(set, symbol));
 }
 
 void
@@ -798,10 +1317,7 @@ edge_set_ordered_iter_reset(const struct edge_set *set,
 int
 edge_set_ordered_iter_next(struct edge_ordered_iter *eoi, struct fsm_edge *e)
 {
-	fsm_state_t bs;
-	unsigned char symbol;
 	const struct edge_set *set = eoi->set;
-	size_t mask;
 
 	if (eoi->pos == EOI_DONE) {
 		return 0;	/* done */
@@ -812,62 +1328,40 @@ edge_set_ordered_iter_next(struct edge_ordered_iter *eoi, struct fsm_edge *e)
 		return 1;
 	}
 
-	mask = set->ceil - 1;
-
 	for (;;) {
-		eoi->pos &= mask;
-		bs = set->b[eoi->pos].state;
-		symbol = set->b[eoi->pos].symbol;
-		eoi->steps++;
-
-		if (bs == BUCKET_UNUSED || eoi->steps == set->ceil) {
-			size_t i;
-			unsigned h;
-			/* after current symbol's entries -- check next */
-			if (!advance_symbol(eoi)) {
-				return 0; /* done */
-			}
-
-			h = PHI32 * eoi->symbol;
-			for (i = 0; i < set->ceil; i++) {
-				const size_t b_i = (h + i) & mask;
-				bs = set->b[b_i].state;
-
-				if (bs == BUCKET_TOMBSTONE) {
-					continue; /* search past deleted */
-				} else if (bs == BUCKET_UNUSED) {
-					/* should never get here -- searching for
-					 * a symbol that isn't present, but we
-					 * already know what's present */
-					assert(!"internal error");
-				} else if (set->b[b_i].symbol != eoi->symbol) {
-					continue; /* skip collision */
-				} else {
-					assert(set->b[b_i].symbol == eoi->symbol);
-
-					/* yield next match and then advance */
-					eoi->pos = b_i;
-					eoi->steps = 0;
-					memcpy(e, &set->b[eoi->pos], sizeof(*e));
-					eoi->pos++;
+		unsigned char prev;
+
+		if (eoi->pos != EOI_DEFAULT) {
+			if (set->dense) {
+				if (eoi->pos == 0 && dense_has(set, eoi->symbol)) {
+					e->symbol = eoi->symbol;
+					e->state  = set->dest[dense_rank(set, eoi->symbol)];
+					eoi->pos = EOI_DEFAULT;
 					return 1;
 				}
+			} else if (eoi->pos < set->count && set->b[eoi->pos].symbol == eoi->symbol) {
+				*e = set->b[eoi->pos];
+				eoi->pos++;
+				return 1;
 			}
-			/* should always find a match or an unused bucket */
-			assert(!"internal error");
-			return 0;
-		} else if (bs == BUCKET_TOMBSTONE) {
-			eoi->pos++; /* skip over */
-			continue;
-		} else if (symbol != eoi->symbol) {
-			eoi->pos++;
-			continue; /* skip collision */
-		} else {
-			/* if pointing at next bucket, yield it */
-			assert(symbol == eoi->symbol);
-			memcpy(e, &set->b[eoi->pos], sizeof(*e));
-			eoi->pos++;
+
+			eoi->pos = EOI_DEFAULT;
+		}
+
+		/* after current symbol's explicit entries -- yield
+		 * its default, if any, then check next symbol */
+		prev = eoi->symbol;
+
+		eoi_seek(eoi, next_symbol(set, prev + 1U));
+
+		if (bm_get(&set->dmask, prev)) {
+			e->symbol = prev;
+			e->state  = set->dstate;
 			return 1;
 		}
+
+		if (eoi->pos == EOI_DONE) {
+			return 0; /* done */
+		}
 	}
 }
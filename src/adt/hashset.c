@@ -6,9 +6,28 @@
 
 #include <assert.h>
 #include <string.h>
+#include <stdint.h>
 #include <stdio.h>
 
 #include <adt/alloc.h>
+#include <adt/hashset.h>
+
+/* splitmix64's finaliser */
+uint64_t
+hashmix64(uint64_t z)
+{
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+	return z ^ (z >> 31);
+}
+
+/*
+ * Keys hashed here are our own state numbers and the like, not input
+ * from an adversary, so by default hashrec() is a fast non-cryptographic
+ * hash. Define HASH_SIPHASH for siphash instead.
+ */
+
+#ifdef HASH_SIPHASH
 
 /* XXX: cheesing around uint8_t here */
 extern int
@@ -31,3 +50,31 @@ hashrec(const void *p, size_t n)
 	return h;
 }
 
+#else
+
+unsigned long
+hashrec(const void *p, size_t n)
+{
+	const unsigned char *s = p;
+	uint64_t h, v;
+
+	h = 0x9e3779b97f4a7c15 ^ n;
+
+	/* a word at a time, then whatever's left over */
+	while (n >= sizeof v) {
+		memcpy(&v, s, sizeof v);
+		h = hashmix64(h ^ v) + 0x9e3779b97f4a7c15;
+		s += sizeof v;
+		n -= sizeof v;
+	}
+
+	if (n > 0) {
+		v = 0;
+		memcpy(&v, s, n);
+		h = hashmix64(h ^ v) + 0x9e3779b97f4a7c15;
+	}
+
+	return (unsigned long) hashmix64(h);
+}
+
+#endif
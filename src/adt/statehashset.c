@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <stddef.h>
+#include <string.h>
 
 #include <fsm/fsm.h>
 
@@ -13,49 +14,30 @@
 #include <adt/hashset.h>
 #include <adt/statehashset.h>
 
+#include "hashgroup.inc"
+
 /*
  * TODO: now fsm_state_t is a numeric index, this could be a dynamically
  * allocated bitmap, instead of a hash table.
  *
  * XXX: meanwhile I'm breaking abstraction here, because item_t is not a
  * pointer type, and I've included the hashset implementation here directly
- * rather than using the generic hashset.inc
- *
- * TODO: or could re-centralise by having struct bucket provided by the
- * concrete implementations, and hashset.inc just returns the bucket.
+ * rather than using the generic hashset.inc. The control bytes and group
+ * probing are shared, by way of hashgroup.inc.
  */
 
-#define DEFAULT_LOAD 0.66
-#define DEFAULT_NBUCKETS 4
-
-/* XXX: explore whether we should split the bucket or not */
-
-struct bucket {
-	unsigned long hash;
-	fsm_state_t item;
-	unsigned int has_item:1; /* XXX: terrible for alignment */
-};
+#define DEFAULT_NBUCKETS GROUP_WIDTH
 
 struct state_hashset {
 	const struct fsm_alloc *alloc;
 	size_t nbuckets;
 	size_t nitems;
-	struct bucket *buckets;
-	size_t maxload;
-	int (*cmp)(const void *, const void *);
-	unsigned long (*hash)(fsm_state_t);
-	float load;
+	size_t growth; /* empty buckets which may be filled before a rehash */
+	unsigned char *ctrl;
+	fsm_state_t *items;
 };
 
-#define UNSET_HASH (0UL)
-
-static int
-state_cmpval(fsm_state_t a, fsm_state_t b)
-{
-	return (a > b) - (a < b);
-}
-
-static unsigned
+static unsigned long
 hash_single_state(fsm_state_t state)
 {
 	/*
@@ -67,43 +49,74 @@ hash_single_state(fsm_state_t state)
 	return hashrec(&state, sizeof state);
 }
 
-static int
-is_pow2(size_t n)
-{
-	return (n & (n-1)) == 0;
-}
-
 static int
 finditem(const struct state_hashset *hashset, unsigned long hash, fsm_state_t item, size_t *bp)
 {
-	size_t b, c, nb;
+	const unsigned char h2 = HASH_H2(hash);
+	size_t ng, g, step, avail;
 
 	if (hashset->nbuckets == 0) {
 		return 0;
 	}
 
-	b = is_pow2(hashset->nbuckets) ? (hash & (hashset->nbuckets-1)) : (hash % hashset->nbuckets);
-	nb = hashset->nbuckets;
-	for (c=0; c < nb; c++) {
-		if (hashset->buckets[b].hash == hash) {
-			if (item == hashset->buckets[b].item || state_cmpval(item, hashset->buckets[b].item) == 0) {
+	ng = hashset->nbuckets / GROUP_WIDTH;
+	g = HASH_H1(hash) & (ng - 1);
+	avail = hashset->nbuckets;
+
+	for (step = 0; step < ng; step++) {
+		const unsigned char *ctrl = &hashset->ctrl[g * GROUP_WIDTH];
+		group_mask m;
+
+		for (m = group_match(ctrl, h2); m != 0; m &= m - 1) {
+			const size_t b = g * GROUP_WIDTH + group_first(m);
+
+			if (hashset->items[b] == item) {
 				*bp = b;
 				return 1;
 			}
-		} else if (!hashset->buckets[b].has_item && hashset->buckets[b].hash == UNSET_HASH) {
-			*bp = b;
-			return 0;
 		}
 
-		if (++b == nb) {
-			b = 0;
+		if (avail == hashset->nbuckets) {
+			m = group_match_free(ctrl);
+			if (m != 0) {
+				avail = g * GROUP_WIDTH + group_first(m);
+			}
+		}
+
+		/* an empty bucket ends the probe */
+		if (group_match_empty(ctrl) != 0) {
+			break;
 		}
+
+		g = (g + step + 1) & (ng - 1);
 	}
 
-	*bp = nb;
+	*bp = avail;
 	return 0;
 }
 
+static int
+alloc_buckets(const struct fsm_alloc *alloc, size_t nbuckets,
+	unsigned char **ctrl, fsm_state_t **items)
+{
+	assert(nbuckets % GROUP_WIDTH == 0);
+
+	*ctrl = f_malloc(alloc, nbuckets * sizeof **ctrl);
+	if (*ctrl == NULL) {
+		return 0;
+	}
+
+	*items = f_malloc(alloc, nbuckets * sizeof **items);
+	if (*items == NULL) {
+		f_free(alloc, *ctrl);
+		return 0;
+	}
+
+	memset(*ctrl, CTRL_EMPTY, nbuckets * sizeof **ctrl);
+
+	return 1;
+}
+
 struct state_hashset *
 state_hashset_create(const struct fsm_alloc *a)
 {
@@ -115,33 +128,18 @@ state_hashset_create(const struct fsm_alloc *a)
 	}
 
 	new->alloc = a;
-	new->load = DEFAULT_LOAD;
 	new->nbuckets = DEFAULT_NBUCKETS;
-	new->maxload = new->load * new->nbuckets;
 	new->nitems = 0;
+	new->growth = MAX_LOAD(new->nbuckets);
 
-	if (new->nbuckets == 0) {
-		new->buckets = NULL;
-	} else {
-		new->buckets = f_calloc(new->alloc, new->nbuckets, sizeof new->buckets[0]);
-		if (new->buckets == NULL) {
-			f_free(a, new);
-			return NULL;
-		}
+	if (!alloc_buckets(a, new->nbuckets, &new->ctrl, &new->items)) {
+		f_free(a, new);
+		return NULL;
 	}
 
 	return new;
 }
 
-static void
-hashset_finalize(struct state_hashset *hashset)
-{
-	static const struct state_hashset zero;
-
-	f_free(hashset->alloc, hashset->buckets);
-	*hashset = zero;
-}
-
 void
 state_hashset_free(struct state_hashset *set)
 {
@@ -149,50 +147,45 @@ state_hashset_free(struct state_hashset *set)
 		return;
 	}
 
-	hashset_finalize(set);
+	f_free(set->alloc, set->ctrl);
+	f_free(set->alloc, set->items);
 	f_free(set->alloc, set);
 }
 
 static int
 rehash(struct state_hashset *hashset)
 {
-	static const struct state_hashset hs_init;
-
-	size_t i, nb, newsz;
-	struct state_hashset ns;
-	struct bucket *b;
+	unsigned char *ctrl;
+	fsm_state_t *items;
+	size_t i, newsz;
 
-	ns = hs_init;
-
-	/* check resizing logic */
+	/* there is no removal, so no tombstones to clear */
 	newsz = (hashset->nbuckets > 0) ? 2 * hashset->nbuckets : DEFAULT_NBUCKETS;
-	ns.buckets = f_calloc(hashset->alloc, newsz, sizeof ns.buckets[0]);
-	if (ns.buckets == NULL) {
+
+	if (!alloc_buckets(hashset->alloc, newsz, &ctrl, &items)) {
 		return 0;
 	}
 
-	ns.nbuckets = newsz;
-	ns.maxload = hashset->load * newsz;
+	for (i = 0; i < hashset->nbuckets; i++) {
+		size_t b;
 
-	nb = hashset->nbuckets;
-	b = hashset->buckets;
-	for (i = 0; i < nb; i++) {
-		size_t bi = 0;
-
-		if (!b[i].has_item) {
+		if (!CTRL_FULL(hashset->ctrl[i])) {
 			continue;
 		}
 
-		/* XXX: replace finditem with something that doesn't
-		 * call cmp() since all items should be unique */
-		finditem(&ns, b[i].hash, b[i].item, &bi);
-		ns.buckets[bi] = b[i];
+		b = group_findfree(ctrl, newsz, hash_single_state(hashset->items[i]));
+		ctrl[b] = hashset->ctrl[i];
+		items[b] = hashset->items[i];
 	}
 
-	f_free(hashset->alloc, hashset->buckets);
-	hashset->nbuckets = ns.nbuckets;
-	hashset->buckets  = ns.buckets;
-	hashset->maxload  = ns.maxload;
+	f_free(hashset->alloc, hashset->ctrl);
+	f_free(hashset->alloc, hashset->items);
+
+	hashset->nbuckets = newsz;
+	hashset->growth   = MAX_LOAD(newsz) - hashset->nitems;
+	hashset->ctrl     = ctrl;
+	hashset->items    = items;
+
 	return 1;
 }
 
@@ -204,32 +197,29 @@ state_hashset_add(struct state_hashset *set, fsm_state_t item)
 
 	assert(set != NULL);
 
-	if (set->buckets == NULL) {
-		if (!rehash(set)) {
-			return 0;
-		}
-	}
-
 	if (finditem(set, hash, item, &b)) {
-		/* found, return item */
-		return set->buckets[b].item;
+		/* found */
+		return 1;
 	}
 
 	/* not found, so add it */
 
 	/* check if we need a rehash */
-	if (set->nitems >= set->maxload) {
+	if (b == set->nbuckets || (set->ctrl[b] == CTRL_EMPTY && set->growth == 0)) {
 		if (!rehash(set)) {
 			return 0;
 		}
 
 		/* re-find the first available bucket */
-		finditem(set, hash, item, &b);
+		b = group_findfree(set->ctrl, set->nbuckets, hash);
 	}
 
-	set->buckets[b].hash = hash;
-	set->buckets[b].item = item;
-	set->buckets[b].has_item = 1;
+	if (set->ctrl[b] == CTRL_EMPTY) {
+		set->growth--;
+	}
+
+	set->ctrl[b] = HASH_H2(hash);
+	set->items[b] = item;
 
 	set->nitems++;
 
@@ -246,4 +236,3 @@ state_hashset_contains(const struct state_hashset *set, fsm_state_t item)
 
 	return finditem(set, h, item, &b);
 }
-
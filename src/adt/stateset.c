@@ -15,11 +15,6 @@
 #include <adt/stateset.h>
 #include <adt/hashset.h>
 
-/*
- * TODO: now fsm_state_t is a numeric index, this could be a dynamically
- * allocated bitmap, instead of a set.inc's array of items.
- */
-
 #define SET_INITIAL 8
 
 /*
@@ -41,13 +36,83 @@
 #define SINGLETON_DECODE(ptr)   ((fsm_state_t) (((uintptr_t) (ptr)) >> 1))
 #define IS_SINGLETON(ptr)       (((uintptr_t) (ptr)) & 0x1)
 
+/*
+ * Otherwise a set is a sorted array of states, until it becomes dense.
+ * Determinising a wide NFA gives closures of thousands of states, and
+ * so a dense set is held as a bitmap instead, in the manner of a roaring
+ * bitmap: the state space is divided into chunks of CHUNK_STATES states,
+ * and only chunks with at least one member are stored. Each chunk is
+ * CHUNK_WORDS words, and chunks are kept in order of their key (the
+ * state number divided by CHUNK_STATES), with their words laid out
+ * contiguously so that the whole set can be scanned as one bitmap.
+ *
+ * An array becomes a bitmap when it has at least DENSE_MIN members and
+ * an average of at least DENSE_PER_CHUNK members per chunk. Bitmaps
+ * become arrays again only for state_set_array().
+ *
+ * Hashing and comparison are defined over members, independently of the
+ * representation, so that the same set of states has the same hash
+ * whichever way it was constructed.
+ */
+#define CHUNK_WORDS     8
+#define CHUNK_STATES    (CHUNK_WORDS * 64)
+#define DENSE_MIN       64
+#define DENSE_PER_CHUNK 16
+
+#define IS_BITMAP(set)  ((set)->a == NULL)
+
 struct state_set {
 	const struct fsm_alloc *alloc;
-	fsm_state_t *a;
-	size_t i;
-	size_t n;
+	fsm_state_t *a;   /* sorted members, or NULL for a bitmap */
+	size_t i;         /* member count */
+	size_t n;         /* allocated members, or allocated chunks */
+
+	/* bitmap only */
+	fsm_state_t *keys;
+	uint64_t *w;      /* CHUNK_WORDS per chunk */
+	size_t nchunks;
 };
 
+static unsigned
+ctz64(uint64_t v)
+{
+	unsigned n;
+
+	assert(v != 0);
+
+#if defined(__GNUC__)
+	n = __builtin_ctzll(v);
+#else
+	for (n = 0; (v & 1) == 0; v >>= 1) {
+		n++;
+	}
+#endif
+
+	return n;
+}
+
+static unsigned
+popcount64(uint64_t v)
+{
+	unsigned n;
+
+#if defined(__GNUC__)
+	n = __builtin_popcountll(v);
+#else
+	for (n = 0; v != 0; v &= v - 1) {
+		n++;
+	}
+#endif
+
+	return n;
+}
+
+static uint64_t
+hash_word(uint64_t h, uint64_t wordpos, uint64_t word)
+{
+	return hashmix64(h ^ hashmix64(word + wordpos * 0x9e3779b97f4a7c15));
+}
+
 int
 state_set_has(const struct fsm *fsm, const struct state_set *set,
 	int (*predicate)(const struct fsm *, fsm_state_t))
@@ -82,59 +147,150 @@ state_set_cmpptr(const void *a, const void *b)
 	return state_set_cmpval(* (fsm_state_t *) a, * (fsm_state_t *) b);
 }
 
-int
-state_set_cmp(const struct state_set *a, const struct state_set *b)
+/*
+ * The index of the first chunk with a key >= the given key
+ */
+static size_t
+chunk_search(const struct state_set *set, fsm_state_t key)
 {
-	size_t count_a, count_b;
+	size_t start, end;
 
-	assert(a != NULL);
-	assert(b != NULL);
+	assert(IS_BITMAP(set));
 
-	count_a = state_set_count(a);
-	count_b = state_set_count(b);
+	start = 0;
+	end = set->nchunks;
 
-	if (count_a != count_b) {
-		return count_a - count_b;
+	while (start < end) {
+		const size_t mid = start + (end - start) / 2;
+		if (set->keys[mid] < key) {
+			start = mid + 1;
+		} else {
+			end = mid;
+		}
+	}
+
+	return start;
+}
+
+/*
+ * Find the next member of a bitmap at or after *pos, a bit position
+ * through the words of all chunks, as for an iterator.
+ */
+static int
+bitmap_next(const struct state_set *set, size_t *pos, fsm_state_t *state)
+{
+	const size_t nw = set->nchunks * CHUNK_WORDS;
+	size_t k;
+	uint64_t v;
+
+	k = *pos / 64;
+	if (k >= nw) {
+		return 0;
 	}
 
-	if (IS_SINGLETON(a) && IS_SINGLETON(b)) {
-		fsm_state_t sa, sb;
+	v = set->w[k] & (~(uint64_t) 0 << (*pos % 64));
 
-		sa = SINGLETON_DECODE(a);
-		sb = SINGLETON_DECODE(b);
+	while (v == 0) {
+		if (++k >= nw) {
+			*pos = nw * 64;
+			return 0;
+		}
 
-		return (sa > sb) - (sa < sb);
+		v = set->w[k];
 	}
 
-	if (IS_SINGLETON(a)) {
-		fsm_state_t sa, sb;
+	*state = set->keys[k / CHUNK_WORDS] * CHUNK_STATES
+		+ (k % CHUNK_WORDS) * 64 + ctz64(v);
+	*pos = k * 64 + ctz64(v) + 1;
+
+	return 1;
+}
+
+/*
+ * A cursor over members in ascending order, whatever the representation.
+ */
+struct cursor {
+	const struct state_set *set;
+	size_t pos;
+};
+
+static int
+cursor_next(struct cursor *c, fsm_state_t *state)
+{
+	const struct state_set *set = c->set;
+
+	if (IS_SINGLETON(set)) {
+		if (c->pos > 0) {
+			return 0;
+		}
 
-		assert(b->a != NULL);
-		assert(count_b == 1);
+		*state = SINGLETON_DECODE(set);
+		c->pos++;
+		return 1;
+	}
 
-		sa = SINGLETON_DECODE(a);
-		sb = state_set_only(b);
+	if (IS_BITMAP(set)) {
+		return bitmap_next(set, &c->pos, state);
+	}
 
-		return (sa > sb) - (sa < sb);
+	if (c->pos >= set->i) {
+		return 0;
 	}
 
-	if (IS_SINGLETON(b)) {
-		fsm_state_t sa, sb;
+	*state = set->a[c->pos++];
+	return 1;
+}
 
-		assert(a->a != NULL);
-		assert(count_a == 1);
+int
+state_set_cmp(const struct state_set *a, const struct state_set *b)
+{
+	struct cursor ca, cb;
+	size_t count_a, count_b;
+	fsm_state_t sa, sb;
 
-		sa = state_set_only(a);
-		sb = SINGLETON_DECODE(b);
+	assert(a != NULL);
+	assert(b != NULL);
 
-		return (sa > sb) - (sa < sb);
+	count_a = state_set_count(a);
+	count_b = state_set_count(b);
+
+	if (count_a != count_b) {
+		return count_a - count_b;
+	}
+
+	/*
+	 * Sets of the same size are ordered by their first differing member.
+	 * Where both have the same representation, equality is found
+	 * a word at a time first.
+	 */
+	if (!IS_SINGLETON(a) && !IS_SINGLETON(b)) {
+		if (!IS_BITMAP(a) && !IS_BITMAP(b)) {
+			if (0 == memcmp(a->a, b->a, a->i * sizeof *a->a)) {
+				return 0;
+			}
+		} else if (IS_BITMAP(a) && IS_BITMAP(b) && a->nchunks == b->nchunks) {
+			if (0 == memcmp(a->keys, b->keys, a->nchunks * sizeof *a->keys)
+			 && 0 == memcmp(a->w, b->w, a->nchunks * CHUNK_WORDS * sizeof *a->w)) {
+				return 0;
+			}
+		}
 	}
 
-	assert(a->a != NULL);
-	assert(b->a != NULL);
-	assert(a->i == b->i);
+	ca.set = a; ca.pos = 0;
+	cb.set = b; cb.pos = 0;
 
-	return memcmp(a->a, b->a, a->i * sizeof *a->a);
+	while (cursor_next(&ca, &sa)) {
+		if (!cursor_next(&cb, &sb)) {
+			assert(!"unreachable");
+			return +1;
+		}
+
+		if (sa != sb) {
+			return (sa > sb) - (sa < sb);
+		}
+	}
+
+	return 0;
 }
 
 /*
@@ -181,6 +337,7 @@ state_set_create(const struct fsm_alloc *a)
 
 	set->a = f_malloc(a, SET_INITIAL * sizeof *set->a);
 	if (set->a == NULL) {
+		f_free(a, set);
 		return NULL;
 	}
 
@@ -188,6 +345,10 @@ state_set_create(const struct fsm_alloc *a)
 	set->i = 0;
 	set->n = SET_INITIAL;
 
+	set->keys = NULL;
+	set->w = NULL;
+	set->nchunks = 0;
+
 	return set;
 }
 
@@ -202,12 +363,368 @@ state_set_free(struct state_set *set)
 		return;
 	}
 
-	assert(set->a != NULL);
-
 	f_free(set->alloc, set->a);
+	f_free(set->alloc, set->keys);
+	f_free(set->alloc, set->w);
 	f_free(set->alloc, set);
 }
 
+/*
+ * Convert an array to a bitmap, if it's dense enough to be worth it.
+ * Failing to allocate is not an error; the set just stays as it is.
+ */
+static void
+maybe_densify(struct state_set *set)
+{
+	fsm_state_t *keys;
+	uint64_t *w;
+	size_t nchunks, i, c;
+
+	assert(!IS_SINGLETON(set) && !IS_BITMAP(set));
+
+	if (set->i < DENSE_MIN) {
+		return;
+	}
+
+	nchunks = 1;
+	for (i = 1; i < set->i; i++) {
+		if (set->a[i] / CHUNK_STATES != set->a[i - 1] / CHUNK_STATES) {
+			nchunks++;
+		}
+	}
+
+	if (set->i < nchunks * DENSE_PER_CHUNK) {
+		return;
+	}
+
+	keys = f_malloc(set->alloc, nchunks * sizeof *keys);
+	if (keys == NULL) {
+		return;
+	}
+
+	w = f_calloc(set->alloc, nchunks * CHUNK_WORDS, sizeof *w);
+	if (w == NULL) {
+		f_free(set->alloc, keys);
+		return;
+	}
+
+	for (i = 0, c = 0; i < set->i; i++) {
+		const fsm_state_t s = set->a[i];
+		const size_t bit = s % CHUNK_STATES;
+
+		if (i > 0 && s / CHUNK_STATES != set->a[i - 1] / CHUNK_STATES) {
+			c++;
+		}
+
+		keys[c] = s / CHUNK_STATES;
+		w[c * CHUNK_WORDS + bit / 64] |= (uint64_t) 1 << (bit % 64);
+	}
+
+	assert(c + 1 == nchunks);
+
+	f_free(set->alloc, set->a);
+
+	set->a = NULL;
+	set->keys = keys;
+	set->w = w;
+	set->nchunks = nchunks;
+	set->n = nchunks;
+}
+
+/* Convert a bitmap back to an array */
+static int
+undensify(struct state_set *set)
+{
+	fsm_state_t *a;
+	size_t pos, j;
+	fsm_state_t s;
+
+	assert(!IS_SINGLETON(set) && IS_BITMAP(set));
+
+	a = f_malloc(set->alloc, (set->i < SET_INITIAL ? SET_INITIAL : set->i) * sizeof *a);
+	if (a == NULL) {
+		return 0;
+	}
+
+	for (pos = 0, j = 0; bitmap_next(set, &pos, &s); j++) {
+		a[j] = s;
+	}
+
+	assert(j == set->i);
+
+	f_free(set->alloc, set->keys);
+	f_free(set->alloc, set->w);
+
+	set->a = a;
+	set->n = set->i < SET_INITIAL ? SET_INITIAL : set->i;
+	set->keys = NULL;
+	set->w = NULL;
+	set->nchunks = 0;
+
+	return 1;
+}
+
+/* Make room for a chunk at index c, zeroed */
+static int
+chunk_insert(struct state_set *set, size_t c, fsm_state_t key)
+{
+	assert(IS_BITMAP(set));
+	assert(c <= set->nchunks);
+
+	if (set->nchunks == set->n) {
+		const size_t n = set->n * 2;
+		fsm_state_t *keys;
+		uint64_t *w;
+
+		keys = f_realloc(set->alloc, set->keys, n * sizeof *keys);
+		if (keys == NULL) {
+			return 0;
+		}
+
+		set->keys = keys;
+
+		w = f_realloc(set->alloc, set->w, n * CHUNK_WORDS * sizeof *w);
+		if (w == NULL) {
+			return 0;
+		}
+
+		set->w = w;
+		set->n = n;
+	}
+
+	memmove(&set->keys[c + 1], &set->keys[c],
+		(set->nchunks - c) * sizeof *set->keys);
+	memmove(&set->w[(c + 1) * CHUNK_WORDS], &set->w[c * CHUNK_WORDS],
+		(set->nchunks - c) * CHUNK_WORDS * sizeof *set->w);
+
+	set->keys[c] = key;
+	memset(&set->w[c * CHUNK_WORDS], 0, CHUNK_WORDS * sizeof *set->w);
+	set->nchunks++;
+
+	return 1;
+}
+
+static void
+chunk_remove(struct state_set *set, size_t c)
+{
+	assert(IS_BITMAP(set));
+	assert(c < set->nchunks);
+
+	memmove(&set->keys[c], &set->keys[c + 1],
+		(set->nchunks - c - 1) * sizeof *set->keys);
+	memmove(&set->w[c * CHUNK_WORDS], &set->w[(c + 1) * CHUNK_WORDS],
+		(set->nchunks - c - 1) * CHUNK_WORDS * sizeof *set->w);
+
+	set->nchunks--;
+}
+
+static int
+bitmap_add(struct state_set *set, fsm_state_t state)
+{
+	const fsm_state_t key = state / CHUNK_STATES;
+	const size_t bit = state % CHUNK_STATES;
+	uint64_t *word;
+	size_t c;
+
+	c = chunk_search(set, key);
+	if (c == set->nchunks || set->keys[c] != key) {
+		if (!chunk_insert(set, c, key)) {
+			return 0;
+		}
+	}
+
+	word = &set->w[c * CHUNK_WORDS + bit / 64];
+	if (!(*word & ((uint64_t) 1 << (bit % 64)))) {
+		*word |= (uint64_t) 1 << (bit % 64);
+		set->i++;
+	}
+
+	return 1;
+}
+
+static int
+bitmap_contains(const struct state_set *set, fsm_state_t state)
+{
+	const fsm_state_t key = state / CHUNK_STATES;
+	const size_t bit = state % CHUNK_STATES;
+	size_t c;
+
+	c = chunk_search(set, key);
+	if (c == set->nchunks || set->keys[c] != key) {
+		return 0;
+	}
+
+	return (set->w[c * CHUNK_WORDS + bit / 64] >> (bit % 64)) & 1;
+}
+
+static void
+bitmap_remove(struct state_set *set, fsm_state_t state)
+{
+	const fsm_state_t key = state / CHUNK_STATES;
+	const size_t bit = state % CHUNK_STATES;
+	uint64_t *word;
+	size_t c, k;
+
+	c = chunk_search(set, key);
+	if (c == set->nchunks || set->keys[c] != key) {
+		return;
+	}
+
+	word = &set->w[c * CHUNK_WORDS + bit / 64];
+	if (!(*word & ((uint64_t) 1 << (bit % 64)))) {
+		return;
+	}
+
+	*word &= ~((uint64_t) 1 << (bit % 64));
+	set->i--;
+
+	for (k = 0; k < CHUNK_WORDS; k++) {
+		if (set->w[c * CHUNK_WORDS + k] != 0) {
+			return;
+		}
+	}
+
+	chunk_remove(set, c);
+}
+
+/*
+ * Union a bitmap into a bitmap. Where src's chunks are all present in
+ * dst already (as for closures which overlap), this is a word-by-word OR.
+ */
+static int
+bitmap_union(struct state_set *dst, const struct state_set *src)
+{
+	fsm_state_t *keys;
+	uint64_t *w;
+	size_t c, d, m, k, missing;
+
+	assert(IS_BITMAP(dst) && IS_BITMAP(src));
+
+	missing = 0;
+	for (c = 0, d = 0; c < src->nchunks; c++) {
+		while (d < dst->nchunks && dst->keys[d] < src->keys[c]) {
+			d++;
+		}
+
+		if (d == dst->nchunks || dst->keys[d] != src->keys[c]) {
+			missing++;
+		}
+	}
+
+	if (missing == 0) {
+		for (c = 0, d = 0; c < src->nchunks; c++) {
+			const uint64_t *sw;
+			uint64_t *dw;
+			size_t added;
+
+			while (dst->keys[d] != src->keys[c]) {
+				d++;
+			}
+
+			sw = &src->w[c * CHUNK_WORDS];
+			dw = &dst->w[d * CHUNK_WORDS];
+
+			added = 0;
+			for (k = 0; k < CHUNK_WORDS; k++) {
+				added += popcount64(sw[k] & ~dw[k]);
+				dw[k] |= sw[k];
+			}
+
+			dst->i += added;
+		}
+
+		return 1;
+	}
+
+	/* Otherwise merge both into new storage */
+	m = dst->nchunks + missing;
+
+	keys = f_malloc(dst->alloc, m * sizeof *keys);
+	if (keys == NULL) {
+		return 0;
+	}
+
+	w = f_malloc(dst->alloc, m * CHUNK_WORDS * sizeof *w);
+	if (w == NULL) {
+		f_free(dst->alloc, keys);
+		return 0;
+	}
+
+	dst->i = 0;
+
+	for (c = 0, d = 0, m = 0; c < src->nchunks || d < dst->nchunks; m++) {
+		uint64_t *ow = &w[m * CHUNK_WORDS];
+
+		if (d == dst->nchunks || (c < src->nchunks && src->keys[c] < dst->keys[d])) {
+			keys[m] = src->keys[c];
+			memcpy(ow, &src->w[c * CHUNK_WORDS], CHUNK_WORDS * sizeof *ow);
+			c++;
+		} else if (c == src->nchunks || dst->keys[d] < src->keys[c]) {
+			keys[m] = dst->keys[d];
+			memcpy(ow, &dst->w[d * CHUNK_WORDS], CHUNK_WORDS * sizeof *ow);
+			d++;
+		} else {
+			keys[m] = dst->keys[d];
+			for (k = 0; k < CHUNK_WORDS; k++) {
+				ow[k] = dst->w[d * CHUNK_WORDS + k] | src->w[c * CHUNK_WORDS + k];
+			}
+			c++;
+			d++;
+		}
+
+		for (k = 0; k < CHUNK_WORDS; k++) {
+			dst->i += popcount64(ow[k]);
+		}
+	}
+
+	f_free(dst->alloc, dst->keys);
+	f_free(dst->alloc, dst->w);
+
+	dst->keys = keys;
+	dst->w = w;
+	dst->nchunks = m;
+	dst->n = m;
+
+	return 1;
+}
+
+static struct state_set *
+bitmap_clone(const struct fsm_alloc *alloc, const struct state_set *src)
+{
+	struct state_set *set;
+
+	assert(IS_BITMAP(src));
+
+	set = f_malloc(alloc, sizeof *set);
+	if (set == NULL) {
+		return NULL;
+	}
+
+	set->alloc = alloc;
+	set->a = NULL;
+	set->i = src->i;
+	set->n = src->nchunks;
+	set->nchunks = src->nchunks;
+
+	set->keys = f_malloc(alloc, src->nchunks * sizeof *set->keys);
+	if (set->keys == NULL) {
+		f_free(alloc, set);
+		return NULL;
+	}
+
+	set->w = f_malloc(alloc, src->nchunks * CHUNK_WORDS * sizeof *set->w);
+	if (set->w == NULL) {
+		f_free(alloc, set->keys);
+		f_free(alloc, set);
+		return NULL;
+	}
+
+	memcpy(set->keys, src->keys, src->nchunks * sizeof *set->keys);
+	memcpy(set->w, src->w, src->nchunks * CHUNK_WORDS * sizeof *set->w);
+
+	return set;
+}
+
 int
 state_set_add(struct state_set **setp, const struct fsm_alloc *alloc,
 	fsm_state_t state)
@@ -236,6 +753,10 @@ state_set_add(struct state_set **setp, const struct fsm_alloc *alloc,
 
 	set = *setp;
 
+	if (IS_BITMAP(set)) {
+		return bitmap_add(set, state);
+	}
+
 	i = 0;
 
 	/*
@@ -272,6 +793,11 @@ state_set_add(struct state_set **setp, const struct fsm_alloc *alloc,
 
 		set->a[i] = state;
 		set->i++;
+
+		/* only worth considering when the array has just doubled */
+		if (set->i == set->n / 2 + 1) {
+			maybe_densify(set);
+		}
 	} else {
 		set->a[0] = state;
 		set->i = 1;
@@ -282,12 +808,49 @@ state_set_add(struct state_set **setp, const struct fsm_alloc *alloc,
 	return 1;
 }
 
+/*
+ * Merge a sorted run b[0..n) into the array, from the back so that it
+ * may be done in place.
+ */
+static void
+array_merge(struct state_set *set, const fsm_state_t *b, size_t n)
+{
+	size_t ia, ib, o;
+
+	assert(!IS_BITMAP(set));
+	assert(set->i + n <= set->n);
+
+	ia = set->i;
+	ib = n;
+	o = set->i + n;
+
+	while (ib > 0) {
+		if (ia > 0 && set->a[ia - 1] > b[ib - 1]) {
+			set->a[--o] = set->a[--ia];
+		} else if (ia > 0 && set->a[ia - 1] == b[ib - 1]) {
+			set->a[--o] = set->a[--ia];
+			ib--;
+		} else {
+			set->a[--o] = b[--ib];
+		}
+	}
+
+	/* the untouched prefix a[0..ia) is already in place */
+	if (o > ia) {
+		memmove(&set->a[ia], &set->a[o], (set->i + n - o) * sizeof *set->a);
+	}
+
+	set->i = ia + (set->i + n - o);
+}
+
 int
 state_set_add_bulk(struct state_set **setp, const struct fsm_alloc *alloc,
 	const fsm_state_t *a, size_t n)
 {
 	struct state_set *set;
 	size_t newlen;
+	size_t i;
+	int sorted;
 
 	assert(setp != NULL);
 	assert(a != NULL);
@@ -328,6 +891,16 @@ state_set_add_bulk(struct state_set **setp, const struct fsm_alloc *alloc,
 
 	set = *setp;
 
+	if (IS_BITMAP(set)) {
+		for (i = 0; i < n; i++) {
+			if (!bitmap_add(set, a[i])) {
+				return 0;
+			}
+		}
+
+		return 1;
+	}
+
 	newlen = set->i + n;
 	if (newlen > set->n) {
 		/* need to expand */
@@ -344,27 +917,42 @@ state_set_add_bulk(struct state_set **setp, const struct fsm_alloc *alloc,
 		set->n = newcap;
 	}
 
-	memcpy(&set->a[set->i], &a[0], n * sizeof a[0]);
+	sorted = 1;
+	for (i = 1; i < n; i++) {
+		if (a[i - 1] >= a[i]) {
+			sorted = 0;
+			break;
+		}
+	}
+
+	/* The usual case is copying from another set, which is sorted */
+	if (sorted) {
+		array_merge(set, a, n);
+	} else {
+		memcpy(&set->a[set->i], &a[0], n * sizeof a[0]);
 
-	qsort(&set->a[0], set->i+n, sizeof set->a[0], state_set_cmpptr);
+		qsort(&set->a[0], set->i+n, sizeof set->a[0], state_set_cmpptr);
 
-	/* remove any duplicates */
-	{
-		size_t i, curr = 1, max = set->i + n;
-		for (i = 1; i < max; i++) {
-			int cmp = state_set_cmpval(set->a[i-1], set->a[i]);
+		/* remove any duplicates */
+		{
+			size_t curr = 1, max = set->i + n;
+			for (i = 1; i < max; i++) {
+				int cmp = state_set_cmpval(set->a[i-1], set->a[i]);
 
-			assert(cmp <= 0);
-			assert(curr <= i);
+				assert(cmp <= 0);
+				assert(curr <= i);
 
-			if (cmp != 0) {
-				set->a[curr++] = set->a[i];
+				if (cmp != 0) {
+					set->a[curr++] = set->a[i];
+				}
 			}
-		}
 
-		set->i = curr;
+			set->i = curr;
+		}
 	}
 
+	maybe_densify(set);
+
 	return 1;
 }
 
@@ -386,11 +974,50 @@ state_set_copy(struct state_set **dst, const struct fsm_alloc *alloc,
 		return 1;
 	}
 
-	if (!state_set_add_bulk(dst, alloc, src->a, src->i)) {
-		return 0;
+	if (!IS_BITMAP(src)) {
+		if (!state_set_add_bulk(dst, alloc, src->a, src->i)) {
+			return 0;
+		}
+
+		return 1;
 	}
 
-	return 1;
+	if (*dst == NULL || IS_SINGLETON(*dst)) {
+		struct state_set *prev = *dst;
+
+		*dst = bitmap_clone(alloc, src);
+		if (*dst == NULL) {
+			return 0;
+		}
+
+		if (prev != NULL && !bitmap_add(*dst, SINGLETON_DECODE(prev))) {
+			return 0;
+		}
+
+		return 1;
+	}
+
+	/* the union is at least as dense as src */
+	if (!IS_BITMAP(*dst)) {
+		struct state_set *tmp;
+
+		tmp = bitmap_clone((*dst)->alloc, src);
+		if (tmp == NULL) {
+			return 0;
+		}
+
+		if (!state_set_add_bulk(&tmp, alloc, (*dst)->a, (*dst)->i)) {
+			state_set_free(tmp);
+			return 0;
+		}
+
+		state_set_free(*dst);
+		*dst = tmp;
+
+		return 1;
+	}
+
+	return bitmap_union(*dst, src);
 }
 
 void
@@ -398,7 +1025,8 @@ state_set_compact(struct state_set **setp,
     fsm_state_remap_fun *remap, void *opaque)
 {
 	struct state_set *set;
-	size_t i, removed, dst;
+	size_t i, dst;
+	int sorted;
 
 	if (IS_SINGLETON(*setp)) {
 		const fsm_state_t s = SINGLETON_DECODE(*setp);
@@ -406,7 +1034,6 @@ state_set_compact(struct state_set **setp,
 		if (new_id == FSM_STATE_REMAP_NO_STATE) {
 			*setp = NULL;
 		} else {
-			assert(new_id <= s);
 			*setp = SINGLETON_ENCODE(new_id);
 		}
 		return;
@@ -418,27 +1045,41 @@ state_set_compact(struct state_set **setp,
 		return;
 	}
 
-	i = 0;
-	removed = 0;
+	/* XXX: compaction renumbers, so a bitmap is rebuilt as an array */
+	if (IS_BITMAP(set) && !undensify(set)) {
+		return;
+	}
+
+	sorted = 1;
 	dst = 0;
 
 	for (i = 0; i < set->i; i++) {
-		const fsm_state_t s = set->a[i];
-		const fsm_state_t new_id = remap(s + removed, opaque);
+		const fsm_state_t new_id = remap(set->a[i], opaque);
 
 		if (new_id == FSM_STATE_REMAP_NO_STATE) { /* drop */
-			removed++;
-		} else {	/* keep */
-			if (dst < i) {
-				memcpy(&set->a[dst],
-				    &set->a[i],
-				    sizeof(set->a[0]));
+			continue;
+		}
+
+		if (dst > 0 && set->a[dst - 1] >= new_id) {
+			sorted = 0;
+		}
+
+		set->a[dst++] = new_id;
+	}
+
+	set->i = dst;
+
+	if (!sorted) {
+		qsort(set->a, set->i, sizeof *set->a, state_set_cmpptr);
+
+		for (i = 1, dst = set->i > 0; i < set->i; i++) {
+			if (set->a[i] != set->a[dst - 1]) {
+				set->a[dst++] = set->a[i];
 			}
-			dst++;
 		}
+
+		set->i = dst;
 	}
-	set->i -= removed;
-	assert(set->i == dst);
 }
 
 void
@@ -460,6 +1101,11 @@ state_set_remove(struct state_set **setp, fsm_state_t state)
 		return;
 	}
 
+	if (IS_BITMAP(set)) {
+		bitmap_remove(set, state);
+		return;
+	}
+
 	i = state_set_search(set, state);
 	if (set->a[i] == state) {
 		if (i < set->i) {
@@ -495,9 +1141,21 @@ state_set_only(const struct state_set *set)
 		return SINGLETON_DECODE(set);
 	}
 
-	assert(set->n >= 1);
 	assert(set->i == 1);
 
+	if (IS_BITMAP(set)) {
+		fsm_state_t s;
+		size_t pos = 0;
+
+		if (!bitmap_next(set, &pos, &s)) {
+			assert(!"unreachable");
+		}
+
+		return s;
+	}
+
+	assert(set->n >= 1);
+
 	return set->a[0];
 }
 
@@ -514,6 +1172,10 @@ state_set_contains(const struct state_set *set, fsm_state_t state)
 		return SINGLETON_DECODE(set) == state;
 	}
 
+	if (IS_BITMAP(set)) {
+		return bitmap_contains(set, state);
+	}
+
 	i = state_set_search(set, state);
 	if (set->a[i] == state) {
 		return 1;
@@ -533,8 +1195,6 @@ state_set_count(const struct state_set *set)
 		return 1;
 	}
 
-	assert(set->a != NULL);
-
 	return set->i;
 }
 
@@ -567,6 +1227,11 @@ state_set_next(struct state_iter *it, fsm_state_t *state)
 		return 1;
 	}
 
+	/* for a bitmap, it->i is a bit position */
+	if (IS_BITMAP(it->set)) {
+		return bitmap_next(it->set, &it->i, state);
+	}
+
 	if (it->i >= it->set->i) {
 		return 0;
 	}
@@ -579,7 +1244,7 @@ state_set_next(struct state_iter *it, fsm_state_t *state)
 }
 
 const fsm_state_t *
-state_set_array(const struct state_set *set)
+state_set_array(struct state_set *set)
 {
 	assert(set != NULL);
 	assert(!IS_SINGLETON(set));
@@ -588,10 +1253,18 @@ state_set_array(const struct state_set *set)
 		return NULL;
 	}
 
+	/*
+	 * A bitmap has no array of members to present, so it's converted
+	 * back to one. That doesn't change its members, but may fail.
+	 */
+	if (IS_BITMAP(set) && !undensify(set)) {
+		return NULL;
+	}
+
 	return set->a;
 }
 
-void
+int
 state_set_rebase(struct state_set **setp, fsm_state_t base)
 {
 	struct state_set *set;
@@ -600,7 +1273,7 @@ state_set_rebase(struct state_set **setp, fsm_state_t base)
 	assert(setp != NULL);
 
 	if (*setp == NULL) {
-		return;
+		return 1;
 	}
 
 	if (IS_SINGLETON(*setp)) {
@@ -611,17 +1284,33 @@ state_set_rebase(struct state_set **setp, fsm_state_t base)
 
 		assert(state <= SINGLETON_MAX);
 		*setp = SINGLETON_ENCODE(state);
-		return;
+		return 1;
 	}
 
 	set = *setp;
 
+	if (IS_BITMAP(set)) {
+		if (base % CHUNK_STATES == 0) {
+			for (i = 0; i < set->nchunks; i++) {
+				set->keys[i] += base / CHUNK_STATES;
+			}
+
+			return 1;
+		}
+
+		if (!undensify(set)) {
+			return 0;
+		}
+	}
+
 	for (i = 0; i < set->i; i++) {
 		set->a[i] += base;
 	}
+
+	return 1;
 }
 
-void
+int
 state_set_replace(struct state_set **setp, fsm_state_t old, fsm_state_t new)
 {
 	struct state_set *set;
@@ -632,36 +1321,114 @@ state_set_replace(struct state_set **setp, fsm_state_t old, fsm_state_t new)
 
 	if (IS_SINGLETON(*setp)) {
 		if (SINGLETON_DECODE(*setp) != old) {
-			return;
+			return 1;
 		}
 
 		*setp = SINGLETON_ENCODE(new);
-		return;
+		return 1;
 	}
 
 	set = *setp;
 
 	if (set == NULL) {
-		return;
+		return 1;
 	}
 
-	for (i = 0; i < set->i; i++) {
-		if (set->a[i] == old) {
-			set->a[i] = new;
+	if (!state_set_contains(set, old)) {
+		return 1;
+	}
+
+	/*
+	 * Adding new to a bitmap may need a chunk allocated, so that's done
+	 * first, leaving the set unchanged if it fails.
+	 */
+	if (IS_BITMAP(set)) {
+		if (!bitmap_add(set, new)) {
+			return 0;
+		}
+
+		if (old != new) {
+			state_set_remove(setp, old);
+		}
+
+		return 1;
+	}
+
+	state_set_remove(setp, old);
+
+	/*
+	 * Removing old left room for new; re-insert it in order,
+	 * which cannot need to allocate.
+	 */
+	if (state_set_empty(set) || !state_set_contains(set, new)) {
+		i = state_set_empty(set) ? 0 : state_set_search(set, new);
+		if (i < set->i && set->a[i] < new) {
+			i++;
 		}
+
+		memmove(&set->a[i + 1], &set->a[i], (set->i - i) * (sizeof *set->a));
+		set->a[i] = new;
+		set->i++;
 	}
+
+	return 1;
 }
 
 unsigned long
 state_set_hash(const struct state_set *set)
 {
+	struct cursor c;
+	uint64_t h, word;
+	fsm_state_t s, wordpos;
+	int have;
+
 	assert(set != NULL);
 
-	if (IS_SINGLETON(set)) {
-		fsm_state_t state;
-		state = SINGLETON_DECODE(set);
-		return hashrec(&state, sizeof state);
+	/*
+	 * The hash is over each non-zero 64-bit word of the set as
+	 * a bitmap, with its position, so that an array and a bitmap
+	 * (or a singleton) with the same members hash alike. For a bitmap
+	 * this is a pass over its words; otherwise the words are assembled
+	 * as we go.
+	 */
+	h = 0x9e3779b97f4a7c15 ^ state_set_count(set);
+
+	if (!IS_SINGLETON(set) && IS_BITMAP(set)) {
+		size_t k;
+
+		for (k = 0; k < set->nchunks * CHUNK_WORDS; k++) {
+			if (set->w[k] == 0) {
+				continue;
+			}
+
+			wordpos = set->keys[k / CHUNK_WORDS] * CHUNK_WORDS + k % CHUNK_WORDS;
+			h = hash_word(h, wordpos, set->w[k]);
+		}
+
+		return (unsigned long) h;
+	}
+
+	c.set = set;
+	c.pos = 0;
+
+	have = 0;
+	word = 0;
+	wordpos = 0;
+
+	while (cursor_next(&c, &s)) {
+		if (have && s / 64 != wordpos) {
+			h = hash_word(h, wordpos, word);
+			word = 0;
+		}
+
+		wordpos = s / 64;
+		word |= (uint64_t) 1 << (s % 64);
+		have = 1;
+	}
+
+	if (have) {
+		h = hash_word(h, wordpos, word);
 	}
 
-	return hashrec(set->a, set->i * sizeof *set->a);
+	return (unsigned long) h;
 }
@@ -38,6 +38,7 @@ lx_getc(struct lx *lx)
 
 	if (c == '\n') {
 		lx->end.line++;
+		lx->end.saved_col = lx->end.col - 1;
 		lx->end.col = 1;
 	}
 
@@ -61,7 +62,7 @@ lx_ungetc(struct lx *lx, int c)
 
 	if (c == '\n') {
 		lx->end.line--;
-		lx->end.col = 0; /* XXX: lost information */
+		lx->end.col = lx->end.saved_col;
 	}
 }
 
@@ -173,20 +174,20 @@ z0(struct lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "a" */
+			lx_ungetc(lx, c); return TOK_CHAR;
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
 			case '\'': state = S2; break;
-			default: state = S1; break;
+			default: state = S0; break;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_ungetc(lx, c); return TOK_CHAR;
-
 		case S2: /* e.g. "'" */
 			lx_ungetc(lx, c); return lx->z = z3, TOK_LABEL;
 
@@ -205,7 +206,7 @@ z0(struct lx *lx)
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
+	case S0: return TOK_CHAR;
 	case S2: return TOK_LABEL;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
@@ -232,34 +233,48 @@ z1(struct lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S7;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "\\x" */
 			switch ((unsigned char) c) {
-			case '"': state = S2; break;
-			case '\\': state = S3; break;
-			default: state = S1; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': state = S5; break;
+			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_ungetc(lx, c); return TOK_CHAR;
-
-		case S2: /* e.g. "\"" */
-			lx_ungetc(lx, c); return lx->z = z3, TOK_LABEL;
-
-		case S3: /* e.g. "\\" */
+		case S1: /* e.g. "\\" */
 			switch ((unsigned char) c) {
+			case 'x': state = S0; break;
 			case '"':
 			case '\\':
 			case 'f':
 			case 'n':
 			case 'r':
 			case 't':
-			case 'v': state = S4; break;
-			case 'x': state = S6; break;
+			case 'v': state = S3; break;
 			case '0':
 			case '1':
 			case '2':
@@ -267,15 +282,18 @@ z1(struct lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7': state = S5; break;
+			case '7': state = S4; break;
 			default:  lx_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S4: /* e.g. "\\f" */
+		case S2: /* e.g. "\"" */
+			lx_ungetc(lx, c); return lx->z = z3, TOK_LABEL;
+
+		case S3: /* e.g. "\\f" */
 			lx_ungetc(lx, c); return TOK_ESC;
 
-		case S5: /* e.g. "\\0" */
+		case S4: /* e.g. "\\0" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -289,7 +307,7 @@ z1(struct lx *lx)
 			}
 			break;
 
-		case S6: /* e.g. "\\x" */
+		case S5: /* e.g. "\\xa" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -312,36 +330,19 @@ z1(struct lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S7; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'f': break;
+			default:  lx_ungetc(lx, c); return TOK_HEX;
 			}
 			break;
 
-		case S7: /* e.g. "\\xa" */
+		case S6: /* e.g. "a" */
+			lx_ungetc(lx, c); return TOK_CHAR;
+
+		case S7: /* start */
 			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': break;
-			default:  lx_ungetc(lx, c); return TOK_HEX;
+			case '\\': state = S1; break;
+			case '"': state = S2; break;
+			default: state = S6; break;
 			}
 			break;
 
@@ -362,10 +363,10 @@ z1(struct lx *lx)
 	case NONE: return TOK_EOF;
 	case S1: return TOK_CHAR;
 	case S2: return TOK_LABEL;
-	case S3: return TOK_CHAR;
-	case S4: return TOK_ESC;
-	case S5: return TOK_OCT;
-	case S7: return TOK_HEX;
+	case S3: return TOK_ESC;
+	case S4: return TOK_OCT;
+	case S5: return TOK_HEX;
+	case S6: return TOK_CHAR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -391,20 +392,20 @@ z2(struct lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "a" */
+			lx_ungetc(lx, c); return lx->z(lx);
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
 			case '\n': state = S2; break;
-			default: state = S1; break;
+			default: state = S0; break;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_ungetc(lx, c); return lx->z(lx);
-
 		case S2: /* e.g. "\n" */
 			lx_ungetc(lx, c); return lx->z = z3, lx->z(lx);
 
@@ -433,7 +434,7 @@ z2(struct lx *lx)
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_EOF;
+	case S0: return TOK_EOF;
 	case S2: return TOK_EOF;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
@@ -462,21 +463,12 @@ z3(struct lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S17;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "a" */
 			switch ((unsigned char) c) {
-			case '\t':
-			case '\n':
-			case '\r':
-			case ' ': state = S1; break;
-			case '"': state = S2; break;
-			case '#': state = S3; break;
-			case '\'': state = S4; break;
-			case ',': state = S5; break;
-			case '-': state = S6; break;
 			case '0':
 			case '1':
 			case '2':
@@ -518,6 +510,7 @@ z3(struct lx *lx)
 			case 'b':
 			case 'c':
 			case 'd':
+			case 'e':
 			case 'f':
 			case 'g':
 			case 'h':
@@ -531,51 +524,26 @@ z3(struct lx *lx)
 			case 'p':
 			case 'q':
 			case 'r':
+			case 's':
 			case 't':
 			case 'u':
 			case 'v':
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S7; break;
-			case ';': state = S8; break;
-			case '?': state = S9; break;
-			case 'e': state = S10; break;
-			case 's': state = S11; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S1: /* e.g. "\t" */
-			switch ((unsigned char) c) {
-			case '\t':
-			case '\n':
-			case '\r':
-			case ' ': break;
-			default:  lx_ungetc(lx, c); return lx->z(lx);
+			case 'z': break;
+			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S2: /* e.g. "\"" */
-			lx_ungetc(lx, c); return lx->z = z1, lx->z(lx);
-
-		case S3: /* e.g. "#" */
-			lx_ungetc(lx, c); return lx->z = z2, lx->z(lx);
-
-		case S4: /* e.g. "'" */
-			lx_ungetc(lx, c); return lx->z = z0, lx->z(lx);
-
-		case S5: /* e.g. "," */
-			lx_ungetc(lx, c); return TOK_COMMA;
-
-		case S6: /* e.g. "-" */
+		case S1: /* e.g. "-" */
 			switch ((unsigned char) c) {
-			case '>': state = S12; break;
+			case '>': state = S11; break;
 			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S7: /* e.g. "a" */
+		case S2: /* e.g. "end" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -639,18 +607,50 @@ z3(struct lx *lx)
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': break;
+			case 'z': state = S0; break;
+			case ':': state = S10; break;
 			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S8: /* e.g. ";" */
+		case S3: /* e.g. "#" */
+			lx_ungetc(lx, c); return lx->z = z2, lx->z(lx);
+
+		case S4: /* e.g. "'" */
+			lx_ungetc(lx, c); return lx->z = z0, lx->z(lx);
+
+		case S5: /* e.g. "," */
+			lx_ungetc(lx, c); return TOK_COMMA;
+
+		case S6: /* e.g. "\t" */
+			switch ((unsigned char) c) {
+			case '\t':
+			case '\n':
+			case '\r':
+			case ' ': break;
+			default:  lx_ungetc(lx, c); return lx->z(lx);
+			}
+			break;
+
+		case S7: /* e.g. ";" */
 			lx_ungetc(lx, c); return TOK_SEP;
 
-		case S9: /* e.g. "?" */
+		case S8: /* e.g. "?" */
 			lx_ungetc(lx, c); return TOK_ANY;
 
-		case S10: /* e.g. "e" */
+		case S9: /* e.g. "start:" */
+			lx_ungetc(lx, c); return TOK_START;
+
+		case S10: /* e.g. "end:" */
+			lx_ungetc(lx, c); return TOK_END;
+
+		case S11: /* e.g. "->" */
+			lx_ungetc(lx, c); return TOK_TO;
+
+		case S12: /* e.g. "\"" */
+			lx_ungetc(lx, c); return lx->z = z1, lx->z(lx);
+
+		case S13: /* e.g. "start" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -702,6 +702,7 @@ z3(struct lx *lx)
 			case 'k':
 			case 'l':
 			case 'm':
+			case 'n':
 			case 'o':
 			case 'p':
 			case 'q':
@@ -713,15 +714,14 @@ z3(struct lx *lx)
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S7; break;
-			case 'n': state = S13; break;
+			case 'z': state = S0; break;
+			case ':': state = S9; break;
 			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S11: /* e.g. "s" */
+		case S14: /* e.g. "en" */
 			switch ((unsigned char) c) {
-			case 't': state = S14; break;
 			case '0':
 			case '1':
 			case '2':
@@ -762,7 +762,6 @@ z3(struct lx *lx)
 			case 'a':
 			case 'b':
 			case 'c':
-			case 'd':
 			case 'e':
 			case 'f':
 			case 'g':
@@ -778,22 +777,20 @@ z3(struct lx *lx)
 			case 'q':
 			case 'r':
 			case 's':
+			case 't':
 			case 'u':
 			case 'v':
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S7; break;
+			case 'z': state = S0; break;
+			case 'd': state = S2; break;
 			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S12: /* e.g. "->" */
-			lx_ungetc(lx, c); return TOK_TO;
-
-		case S13: /* e.g. "en" */
+		case S15: /* e.g. "e" */
 			switch ((unsigned char) c) {
-			case 'd': state = S19; break;
 			case '0':
 			case '1':
 			case '2':
@@ -834,6 +831,7 @@ z3(struct lx *lx)
 			case 'a':
 			case 'b':
 			case 'c':
+			case 'd':
 			case 'e':
 			case 'f':
 			case 'g':
@@ -843,7 +841,6 @@ z3(struct lx *lx)
 			case 'k':
 			case 'l':
 			case 'm':
-			case 'n':
 			case 'o':
 			case 'p':
 			case 'q':
@@ -855,14 +852,14 @@ z3(struct lx *lx)
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S7; break;
+			case 'z': state = S0; break;
+			case 'n': state = S14; break;
 			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S14: /* e.g. "st" */
+		case S16: /* e.g. "star" */
 			switch ((unsigned char) c) {
-			case 'a': state = S15; break;
 			case '0':
 			case '1':
 			case '2':
@@ -900,6 +897,7 @@ z3(struct lx *lx)
 			case 'Y':
 			case 'Z':
 			case '_':
+			case 'a':
 			case 'b':
 			case 'c':
 			case 'd':
@@ -918,20 +916,19 @@ z3(struct lx *lx)
 			case 'q':
 			case 'r':
 			case 's':
-			case 't':
 			case 'u':
 			case 'v':
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S7; break;
+			case 'z': state = S0; break;
+			case 't': state = S13; break;
 			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S15: /* e.g. "sta" */
+		case S17: /* start */
 			switch ((unsigned char) c) {
-			case 'r': state = S16; break;
 			case '0':
 			case '1':
 			case '2':
@@ -973,7 +970,6 @@ z3(struct lx *lx)
 			case 'b':
 			case 'c':
 			case 'd':
-			case 'e':
 			case 'f':
 			case 'g':
 			case 'h':
@@ -986,21 +982,33 @@ z3(struct lx *lx)
 			case 'o':
 			case 'p':
 			case 'q':
-			case 's':
+			case 'r':
 			case 't':
 			case 'u':
 			case 'v':
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S7; break;
-			default:  lx_ungetc(lx, c); return TOK_IDENT;
+			case 'z': state = S0; break;
+			case '-': state = S1; break;
+			case '#': state = S3; break;
+			case '\'': state = S4; break;
+			case ',': state = S5; break;
+			case '\t':
+			case '\n':
+			case '\r':
+			case ' ': state = S6; break;
+			case ';': state = S7; break;
+			case '?': state = S8; break;
+			case '"': state = S12; break;
+			case 'e': state = S15; break;
+			case 's': state = S20; break;
+			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S16: /* e.g. "star" */
+		case S18: /* e.g. "sta" */
 			switch ((unsigned char) c) {
-			case 't': state = S17; break;
 			case '0':
 			case '1':
 			case '2':
@@ -1055,21 +1063,21 @@ z3(struct lx *lx)
 			case 'o':
 			case 'p':
 			case 'q':
-			case 'r':
 			case 's':
+			case 't':
 			case 'u':
 			case 'v':
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S7; break;
+			case 'z': state = S0; break;
+			case 'r': state = S16; break;
 			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S17: /* e.g. "start" */
+		case S19: /* e.g. "st" */
 			switch ((unsigned char) c) {
-			case ':': state = S18; break;
 			case '0':
 			case '1':
 			case '2':
@@ -1107,7 +1115,6 @@ z3(struct lx *lx)
 			case 'Y':
 			case 'Z':
 			case '_':
-			case 'a':
 			case 'b':
 			case 'c':
 			case 'd':
@@ -1132,15 +1139,13 @@ z3(struct lx *lx)
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S7; break;
+			case 'z': state = S0; break;
+			case 'a': state = S18; break;
 			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S18: /* e.g. "start:" */
-			lx_ungetc(lx, c); return TOK_START;
-
-		case S19: /* e.g. "end" */
+		case S20: /* e.g. "s" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -1198,30 +1203,26 @@ z3(struct lx *lx)
 			case 'q':
 			case 'r':
 			case 's':
-			case 't':
 			case 'u':
 			case 'v':
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S7; break;
-			case ':': state = S20; break;
+			case 'z': state = S0; break;
+			case 't': state = S19; break;
 			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S20: /* e.g. "end:" */
-			lx_ungetc(lx, c); return TOK_END;
-
 		default:
 			; /* unreached */
 		}
 
 		switch (state) {
-		case S1:
-		case S2:
 		case S3:
 		case S4:
+		case S6:
+		case S12:
 			break;
 
 		default:
@@ -1239,25 +1240,25 @@ z3(struct lx *lx)
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_EOF;
-	case S2: return TOK_EOF;
+	case S0: return TOK_IDENT;
+	case S2: return TOK_IDENT;
 	case S3: return TOK_EOF;
 	case S4: return TOK_EOF;
 	case S5: return TOK_COMMA;
-	case S7: return TOK_IDENT;
-	case S8: return TOK_SEP;
-	case S9: return TOK_ANY;
-	case S10: return TOK_IDENT;
-	case S11: return TOK_IDENT;
-	case S12: return TOK_TO;
+	case S6: return TOK_EOF;
+	case S7: return TOK_SEP;
+	case S8: return TOK_ANY;
+	case S9: return TOK_START;
+	case S10: return TOK_END;
+	case S11: return TOK_TO;
+	case S12: return TOK_EOF;
 	case S13: return TOK_IDENT;
 	case S14: return TOK_IDENT;
 	case S15: return TOK_IDENT;
 	case S16: return TOK_IDENT;
-	case S17: return TOK_IDENT;
-	case S18: return TOK_START;
+	case S18: return TOK_IDENT;
 	case S19: return TOK_IDENT;
-	case S20: return TOK_END;
+	case S20: return TOK_IDENT;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -1292,35 +1293,69 @@ lx_example(enum lx_token (*z)(struct lx *), enum lx_token t)
 
 	if (z == z0) {
 		switch (t) {
-		case TOK_CHAR: return "a";
-		case TOK_LABEL: return "'";
+		case TOK_COMMA: return "";
+		case TOK_SEP: return "";
+		case TOK_ANY: return "";
+		case TOK_TO: return "";
+		case TOK_IDENT: return "";
+		case TOK_END: return "";
+		case TOK_START: return "";
+		case TOK_CHAR: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_LABEL: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z1) {
 		switch (t) {
-		case TOK_CHAR: return "a";
-		case TOK_HEX: return "\\xa";
-		case TOK_OCT: return "\\0";
-		case TOK_ESC: return "\\f";
-		case TOK_LABEL: return "\"";
+		case TOK_COMMA: return "";
+		case TOK_SEP: return "";
+		case TOK_ANY: return "";
+		case TOK_TO: return "";
+		case TOK_IDENT: return "";
+		case TOK_END: return "";
+		case TOK_START: return "";
+		case TOK_CHAR: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_LABEL: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z2) {
 		switch (t) {
+		case TOK_COMMA: return "";
+		case TOK_SEP: return "";
+		case TOK_ANY: return "";
+		case TOK_TO: return "";
+		case TOK_IDENT: return "";
+		case TOK_END: return "";
+		case TOK_START: return "";
+		case TOK_CHAR: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_LABEL: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z3) {
 		switch (t) {
-		case TOK_COMMA: return ",";
-		case TOK_SEP: return ";";
-		case TOK_ANY: return "?";
-		case TOK_TO: return "->";
-		case TOK_IDENT: return "a";
-		case TOK_END: return "end:";
-		case TOK_START: return "start:";
+		case TOK_COMMA: return "";
+		case TOK_SEP: return "";
+		case TOK_ANY: return "";
+		case TOK_TO: return "";
+		case TOK_IDENT: return "";
+		case TOK_END: return "";
+		case TOK_START: return "";
+		case TOK_CHAR: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_LABEL: return "";
 		default: goto error;
 		}
 	}
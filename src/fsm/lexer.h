@@ -23,12 +23,13 @@ enum lx_token {
 
 /*
  * .byte is 0-based.
- * .line and .col are 1-based; 0 means unknown.
+ * .line, .col, and .saved_col are 1-based; 0 means unknown.
  */
 struct lx_pos {
 	unsigned byte;
 	unsigned line;
 	unsigned col;
+	unsigned saved_col;
 };
 
 struct lx {
@@ -9,6 +9,8 @@
 #include <unistd.h>
 
 #include <assert.h>
+#include <errno.h>
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -106,7 +108,7 @@ static void
 usage(void)
 {
 	printf("usage: fsm [-x] {<text> ...}\n");
-	printf("       fsm {-p} [-l <language>] [-aCcwX] [-k <io>] [-e <prefix>]\n");
+	printf("       fsm {-p} [-l <language>] [-aCcwX] [-k <io>] [-T <ctable>] [-S <parts>] [-e <prefix>]\n");
 	printf("       fsm {-dmr | -t <transformation>} [-i <iterations>] [<file.fsm> | <file-a> <file-b>]\n");
 	printf("       fsm {-q <query>} [<file>]\n");
 	printf("       fsm {-W <maxlen>} <file.fsm>\n");
@@ -146,6 +148,57 @@ io(const char *name)
 	exit(EXIT_FAILURE);
 }
 
+static enum fsm_ctable
+ctable(const char *name)
+{
+	size_t i;
+
+	struct {
+		const char *name;
+		enum fsm_ctable ctable;
+	} a[] = {
+		{ "auto",   FSM_CTABLE_AUTO   },
+		{ "never",  FSM_CTABLE_NEVER  },
+		{ "always", FSM_CTABLE_ALWAYS }
+	};
+
+	assert(name != NULL);
+
+	for (i = 0; i < sizeof a / sizeof *a; i++) {
+		if (0 == strcmp(a[i].name, name)) {
+			return a[i].ctable;
+		}
+	}
+
+	fprintf(stderr, "unrecognised table mode; valid modes are: ");
+
+	for (i = 0; i < sizeof a / sizeof *a; i++) {
+		fprintf(stderr, "%s%s",
+			a[i].name,
+			i + 1 < sizeof a / sizeof *a ? ", " : "\n");
+	}
+
+	exit(EXIT_FAILURE);
+}
+
+static unsigned
+parts(const char *s)
+{
+	unsigned long n;
+	char *e;
+
+	assert(s != NULL);
+
+	errno = 0;
+	n = strtoul(s, &e, 10);
+	if (*s == '\0' || *e != '\0' || errno != 0 || n > UINT_MAX) {
+		fprintf(stderr, "-S: invalid number of parts\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return n;
+}
+
 static fsm_print *
 print_name(const char *name)
 {
@@ -225,7 +278,9 @@ static int
 		{ "hasambiguity",      fsm_has, fsm_hasnondeterminism },
 		{ "hasnondeterminism", fsm_has, fsm_hasnondeterminism },
 		{ "hasepsilons",       fsm_has, fsm_hasepsilons       },
-		{ "epsilons",          fsm_has, fsm_hasepsilons       }
+		{ "epsilons",          fsm_has, fsm_hasepsilons       },
+		{ "hasabsorbing",      fsm_has, fsm_isabsorbing       },
+		{ "absorbing",         fsm_has, fsm_isabsorbing       }
 	};
 
 	assert(name != NULL);
@@ -381,7 +436,7 @@ main(int argc, char *argv[])
 	{
 		int c;
 
-		while (c = getopt(argc, argv, "h" "aCcwXe:k:i:" "xpq:l:dGmrt:W:"), c != -1) {
+		while (c = getopt(argc, argv, "h" "aCcwXe:k:T:S:i:" "xpq:l:dGmrt:W:"), c != -1) {
 			switch (c) {
 			case 'a': opt.anonymous_states  = 1;          break;
 			case 'c': opt.consolidate_edges = 1;          break;
@@ -390,6 +445,8 @@ main(int argc, char *argv[])
 			case 'X': opt.always_hex        = 1;          break;
 			case 'e': opt.prefix            = optarg;     break;
 			case 'k': opt.io                = io(optarg); break;
+			case 'T': opt.ctable            = ctable(optarg); break;
+			case 'S': opt.parts             = parts(optarg);  break;
 
 			case 'i':
 				iterations = strtoul(optarg, NULL, 10);
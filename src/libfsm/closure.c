@@ -189,7 +189,7 @@ error:
 
 int
 symbol_closure_without_epsilons(const struct fsm *fsm, fsm_state_t s,
-	struct state_set *sclosures[static FSM_SIGMA_COUNT])
+	struct state_set *sclosures[])
 {
 	struct edge_iter jt;
 	struct fsm_edge e;
@@ -207,7 +207,8 @@ symbol_closure_without_epsilons(const struct fsm *fsm, fsm_state_t s,
 	 * to avoid repeating that work by de-duplicating on the destination.
 	 */
 
-	for (edge_set_reset(fsm->states[s].edges, &jt); edge_set_next(&jt, &e); ) {
+	/* default edges are left to the caller; see edge_set_default() */
+	for (edge_set_reset_explicit(fsm->states[s].edges, &jt); edge_set_next(&jt, &e); ) {
 		if (!state_set_add(&sclosures[e.symbol], fsm->opt->alloc, e.state)) {
 			return 0;
 		}
@@ -218,8 +219,8 @@ symbol_closure_without_epsilons(const struct fsm *fsm, fsm_state_t s,
 
 int
 symbol_closure(const struct fsm *fsm, fsm_state_t s,
-	struct state_set * const eclosures[static FSM_SIGMA_COUNT],
-	struct state_set *sclosures[static FSM_SIGMA_COUNT])
+	struct state_set * const eclosures[],
+	struct state_set *sclosures[])
 {
 	struct edge_iter jt;
 	struct fsm_edge e;
@@ -61,7 +61,6 @@ fsm_complete(struct fsm *fsm,
 		struct fsm_edge e;
 		struct edge_iter jt;
 		struct bm bm;
-		int i;
 
 		if (!predicate(fsm, s)) {
 			continue;
@@ -73,13 +72,15 @@ fsm_complete(struct fsm *fsm,
 			bm_set(&bm, e.symbol);
 		}
 
-		/* TODO: bulk add symbols as the inverse of this bitmap */
-		i = -1;
-		while (i = bm_next(&bm, i, 0), i <= UCHAR_MAX) {
-			if (!fsm_addedge_literal(fsm, s, new, i)) {
-				/* TODO: free stuff */
-				return 0;
-			}
+		/*
+		 * The missing symbols go to the error state. These are added
+		 * in bulk, typically stored as the state's default edge.
+		 */
+		bm_invert(&bm);
+
+		if (!edge_set_add_bulk(&fsm->states[s].edges, fsm->opt->alloc, &bm, new)) {
+			/* TODO: free stuff */
+			return 0;
 		}
 	}
 
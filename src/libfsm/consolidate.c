@@ -40,7 +40,7 @@ mapping_cb(fsm_state_t id, const void *opaque)
 
 struct fsm *
 fsm_consolidate(struct fsm *src,
-    const fsm_state_t *mapping, size_t mapping_count)
+    const fsm_state_t *mapping, size_t mapping_count, int by_opaque)
 {
 	struct fsm *dst;
 	fsm_state_t src_i;
@@ -125,6 +125,13 @@ fsm_consolidate(struct fsm *src,
 			}
 			assert(fsm_isend(src, src_i));
 
+			/* The mapping keeps end states of different opaques
+			 * apart, so there is nothing to carry. */
+			if (by_opaque) {
+				assert(dst->states[dst_i].opaque == src->states[src_i].opaque);
+				continue;
+			}
+
 			/* Find the previous state that also maps to this
 			 * state, to carry the opaque from it. This could
 			 * become expensive when there are a very high number
@@ -0,0 +1,857 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/pred.h>
+#include <fsm/walk.h>
+#include <fsm/dawg.h>
+
+#include <adt/set.h>
+#include <adt/edgeset.h>
+
+#include "internal.h"
+
+/*
+ * Serialised layout; all multi-octet integers are little-endian:
+ *
+ *   0  magic "FSMDAWG" and a version octet
+ *   8  u64 number of words
+ *  16  u32 length of the node area, in octets
+ *  20  u32 offset of the start node, relative to the node area
+ *  24  u8  width of bit-packed edge targets, in bits
+ *  25  reserved, zero
+ *  32  node area
+ *
+ * Each node is:
+ *
+ *   flags    bit 7 is set for an end state. Bits 0-6 are the number of
+ *            edges, or 127 meaning the following octet holds count - 127
+ *   count    varint (7 bits per octet, LSB first) number of words
+ *            accepted from this node, including the empty word if end
+ *   symbols  one octet per edge, ascending
+ *   targets  one <width>-bit node offset per edge, LSB first, padded to
+ *            a whole octet
+ */
+
+#define DAWG_MAGIC   "FSMDAWG"
+#define DAWG_VERSION 0x01
+#define DAWG_HEADER  32
+
+#define DAWG_END     0x80
+#define DAWG_NEDGES  0x7f
+
+struct fsm_dawg {
+	const unsigned char *nodes;
+	size_t len;
+
+	uint64_t count;
+	uint32_t start;
+	unsigned width;
+
+	/* non-NULL when mapped by fsm_dawg_map() */
+	void *map;
+	size_t maplen;
+};
+
+struct dawg_node {
+	unsigned int end:1;
+	unsigned n;
+	uint64_t count;
+	const unsigned char *sym; /* n symbols */
+	const unsigned char *tgt; /* n bit-packed targets */
+};
+
+struct dawg_frame {
+	fsm_state_t state;
+	struct edge_ordered_iter eoi;
+};
+
+static size_t
+varint_len(uint64_t v)
+{
+	size_t n;
+
+	for (n = 1; v >= 0x80; n++) {
+		v >>= 7;
+	}
+
+	return n;
+}
+
+static size_t
+node_size(size_t nedges, uint64_t count, unsigned width)
+{
+	return 1 + (nedges >= DAWG_NEDGES)
+		+ varint_len(count)
+		+ nedges
+		+ (nedges * width + 7) / 8;
+}
+
+static unsigned
+width_for(size_t max)
+{
+	unsigned w;
+
+	for (w = 1; w < 64 && (max >> w) != 0; w++)
+		;
+
+	return w;
+}
+
+static void
+put_le(unsigned char *p, uint64_t v, size_t n)
+{
+	size_t i;
+
+	for (i = 0; i < n; i++) {
+		p[i] = (v >> (8 * i)) & 0xff;
+	}
+}
+
+static uint64_t
+get_le(const unsigned char *p, size_t n)
+{
+	uint64_t v;
+	size_t i;
+
+	v = 0;
+
+	for (i = 0; i < n; i++) {
+		v |= (uint64_t) p[i] << (8 * i);
+	}
+
+	return v;
+}
+
+/*
+ * Depth-first post-order over an acyclic DFA, counting the words
+ * accepted from each state. Any back edge means an infinite language.
+ */
+static int
+count_words(const struct fsm *fsm, fsm_state_t start,
+	uint64_t *count, fsm_state_t *order, size_t *norder)
+{
+	struct dawg_frame *stack;
+	unsigned char *colour;
+	size_t top;
+
+	enum { WHITE, GREY, BLACK };
+
+	stack  = f_malloc(fsm->opt->alloc, fsm->statecount * sizeof *stack);
+	colour = f_calloc(fsm->opt->alloc, fsm->statecount, sizeof *colour);
+	if (stack == NULL || colour == NULL) {
+		goto error;
+	}
+
+	*norder = 0;
+
+	top = 0;
+	stack[top].state = start;
+	edge_set_ordered_iter_reset(fsm->states[start].edges, &stack[top].eoi);
+	colour[start] = GREY;
+	count[start] = fsm_isend(fsm, start);
+	top++;
+
+	while (top > 0) {
+		struct dawg_frame *fr = &stack[top - 1];
+		struct fsm_edge e;
+
+		if (!edge_set_ordered_iter_next(&fr->eoi, &e)) {
+			colour[fr->state] = BLACK;
+			order[(*norder)++] = fr->state;
+			top--;
+
+			if (top > 0) {
+				fsm_state_t parent = stack[top - 1].state;
+
+				if (count[parent] > UINT64_MAX - count[fr->state]) {
+					errno = ERANGE;
+					goto error;
+				}
+
+				count[parent] += count[fr->state];
+			}
+
+			continue;
+		}
+
+		switch (colour[e.state]) {
+		case GREY:
+			errno = EINVAL;
+			goto error;
+
+		case BLACK:
+			if (count[fr->state] > UINT64_MAX - count[e.state]) {
+				errno = ERANGE;
+				goto error;
+			}
+
+			count[fr->state] += count[e.state];
+			break;
+
+		case WHITE:
+			assert(top < fsm->statecount);
+
+			stack[top].state = e.state;
+			edge_set_ordered_iter_reset(fsm->states[e.state].edges, &stack[top].eoi);
+			colour[e.state] = GREY;
+			count[e.state] = fsm_isend(fsm, e.state);
+			top++;
+			break;
+		}
+	}
+
+	f_free(fsm->opt->alloc, stack);
+	f_free(fsm->opt->alloc, colour);
+
+	return 1;
+
+error:
+
+	f_free(fsm->opt->alloc, stack);
+	f_free(fsm->opt->alloc, colour);
+
+	return 0;
+}
+
+static int
+write_node(FILE *f, const struct fsm *fsm, fsm_state_t s,
+	const uint64_t *count, const size_t *offset, unsigned width)
+{
+	unsigned char buf[2 + 10 + FSM_SIGMA_COUNT + FSM_SIGMA_COUNT * 4];
+	unsigned char sym[FSM_SIGMA_COUNT];
+	fsm_state_t to[FSM_SIGMA_COUNT];
+	struct edge_ordered_iter eoi;
+	struct fsm_edge e;
+	size_t n, i, p, bit;
+	uint64_t v;
+
+	n = 0;
+
+	for (edge_set_ordered_iter_reset(fsm->states[s].edges, &eoi); edge_set_ordered_iter_next(&eoi, &e); ) {
+		assert(n < FSM_SIGMA_COUNT);
+
+		sym[n] = e.symbol;
+		to[n]  = e.state;
+		n++;
+	}
+
+	p = 0;
+
+	buf[p++] = (fsm_isend(fsm, s) ? DAWG_END : 0)
+		| (n >= DAWG_NEDGES ? DAWG_NEDGES : n);
+	if (n >= DAWG_NEDGES) {
+		buf[p++] = n - DAWG_NEDGES;
+	}
+
+	for (v = count[s]; v >= 0x80; v >>= 7) {
+		buf[p++] = (v & 0x7f) | 0x80;
+	}
+	buf[p++] = v;
+
+	memcpy(buf + p, sym, n);
+	p += n;
+
+	memset(buf + p, 0, (n * width + 7) / 8);
+
+	for (i = 0, bit = 0; i < n; i++, bit += width) {
+		unsigned k;
+
+		v = offset[to[i]];
+
+		for (k = 0; k < width; k++) {
+			if (v & ((uint64_t) 1 << k)) {
+				buf[p + (bit + k) / 8] |= 1U << ((bit + k) % 8);
+			}
+		}
+	}
+
+	p += (n * width + 7) / 8;
+
+	assert(p == node_size(n, count[s], width));
+
+	return fwrite(buf, 1, p, f) == p;
+}
+
+int
+fsm_dawg_write(FILE *f, const struct fsm *fsm)
+{
+	struct fsm *dfa;
+	fsm_state_t start;
+	fsm_state_t *order;
+	uint64_t *count;
+	size_t *offset;
+	size_t norder, total, i;
+	unsigned width;
+
+	assert(f != NULL);
+	assert(fsm != NULL);
+
+	if (!fsm_getstart(fsm, &start)) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	if (!fsm_all(fsm, fsm_isdfa)) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	/*
+	 * Dead states may legitimately form cycles (e.g. the error state
+	 * of a complete DFA), so these are trimmed away before looking for
+	 * cycles which would make the language infinite.
+	 */
+	dfa = fsm_clone(fsm);
+	if (dfa == NULL) {
+		return 0;
+	}
+
+	if (fsm_trim(dfa, FSM_TRIM_START_AND_END_REACHABLE, NULL) < 0) {
+		fsm_free(dfa);
+		return 0;
+	}
+
+	order  = NULL;
+	count  = NULL;
+	offset = NULL;
+
+	if (!fsm_getstart(dfa, &start)) {
+		/* empty language; the start state was trimmed away */
+		if (!fsm_addstate(dfa, &start)) {
+			goto error;
+		}
+
+		fsm_setstart(dfa, start);
+	}
+
+	order  = f_malloc(dfa->opt->alloc, dfa->statecount * sizeof *order);
+	count  = f_malloc(dfa->opt->alloc, dfa->statecount * sizeof *count);
+	offset = f_malloc(dfa->opt->alloc, dfa->statecount * sizeof *offset);
+	if (order == NULL || count == NULL || offset == NULL) {
+		goto error;
+	}
+
+	if (!count_words(dfa, start, count, order, &norder)) {
+		goto error;
+	}
+
+	/*
+	 * Nodes are laid out in reverse post-order, so the start node comes
+	 * first and a node's descendants tend to follow closely behind it.
+	 *
+	 * The target width depends on the total size, which in turn depends
+	 * on the target width. Sizes only grow with width, so this converges.
+	 */
+	width = 1;
+
+	for (;;) {
+		unsigned need;
+
+		total = 0;
+
+		for (i = norder; i > 0; i--) {
+			fsm_state_t s = order[i - 1];
+
+			offset[s] = total;
+			total += node_size(edge_set_count(dfa->states[s].edges), count[s], width);
+		}
+
+		need = width_for(offset[order[0]]);
+		if (need <= width) {
+			break;
+		}
+
+		width = need;
+	}
+
+	if (width > 32 || total > UINT32_MAX) {
+		errno = EFBIG;
+		goto error;
+	}
+
+	{
+		unsigned char hdr[DAWG_HEADER];
+
+		memset(hdr, 0, sizeof hdr);
+		memcpy(hdr, DAWG_MAGIC, 7);
+		hdr[7] = DAWG_VERSION;
+		put_le(hdr +  8, count[start], 8);
+		put_le(hdr + 16, total, 4);
+		put_le(hdr + 20, offset[start], 4);
+		hdr[24] = width;
+
+		if (fwrite(hdr, sizeof hdr, 1, f) != 1) {
+			goto error;
+		}
+	}
+
+	for (i = norder; i > 0; i--) {
+		if (!write_node(f, dfa, order[i - 1], count, offset, width)) {
+			goto error;
+		}
+	}
+
+	f_free(dfa->opt->alloc, order);
+	f_free(dfa->opt->alloc, count);
+	f_free(dfa->opt->alloc, offset);
+
+	fsm_free(dfa);
+
+	return 1;
+
+error:
+
+	f_free(dfa->opt->alloc, order);
+	f_free(dfa->opt->alloc, count);
+	f_free(dfa->opt->alloc, offset);
+
+	fsm_free(dfa);
+
+	return 0;
+}
+
+struct fsm_dawg *
+fsm_dawg_open(const void *p, size_t n)
+{
+	const unsigned char *hdr = p;
+	struct fsm_dawg *dawg;
+	uint64_t len;
+
+	if (p == NULL || n < DAWG_HEADER) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (memcmp(hdr, DAWG_MAGIC, 7) != 0 || hdr[7] != DAWG_VERSION) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	len = get_le(hdr + 16, 4);
+	if (len != n - DAWG_HEADER || hdr[24] < 1 || hdr[24] > 32) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	dawg = malloc(sizeof *dawg);
+	if (dawg == NULL) {
+		return NULL;
+	}
+
+	dawg->nodes  = hdr + DAWG_HEADER;
+	dawg->len    = len;
+	dawg->count  = get_le(hdr +  8, 8);
+	dawg->start  = get_le(hdr + 20, 4);
+	dawg->width  = hdr[24];
+	dawg->map    = NULL;
+	dawg->maplen = 0;
+
+	if (dawg->start >= dawg->len) {
+		free(dawg);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	return dawg;
+}
+
+struct fsm_dawg *
+fsm_dawg_map(const char *path)
+{
+	struct fsm_dawg *dawg;
+	struct stat st;
+	void *map;
+	int fd;
+
+	assert(path != NULL);
+
+	fd = open(path, O_RDONLY);
+	if (fd == -1) {
+		return NULL;
+	}
+
+	if (fstat(fd, &st) == -1) {
+		close(fd);
+		return NULL;
+	}
+
+	if (st.st_size < DAWG_HEADER) {
+		close(fd);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (map == MAP_FAILED) {
+		return NULL;
+	}
+
+	dawg = fsm_dawg_open(map, st.st_size);
+	if (dawg == NULL) {
+		int e = errno;
+		munmap(map, st.st_size);
+		errno = e;
+		return NULL;
+	}
+
+	dawg->map    = map;
+	dawg->maplen = st.st_size;
+
+	return dawg;
+}
+
+void
+fsm_dawg_close(struct fsm_dawg *dawg)
+{
+	if (dawg == NULL) {
+		return;
+	}
+
+	if (dawg->map != NULL) {
+		munmap(dawg->map, dawg->maplen);
+	}
+
+	free(dawg);
+}
+
+size_t
+fsm_dawg_count(const struct fsm_dawg *dawg)
+{
+	assert(dawg != NULL);
+
+	return dawg->count;
+}
+
+static int
+node_decode(const struct fsm_dawg *dawg, size_t off, struct dawg_node *node)
+{
+	const unsigned char *p, *e;
+	unsigned shift;
+
+	p = dawg->nodes + off;
+	e = dawg->nodes + dawg->len;
+
+	if (off >= dawg->len) {
+		return 0;
+	}
+
+	node->end = !!(*p & DAWG_END);
+	node->n   = *p & DAWG_NEDGES;
+	p++;
+
+	if (node->n == DAWG_NEDGES) {
+		if (p >= e) {
+			return 0;
+		}
+
+		node->n += *p++;
+	}
+
+	node->count = 0;
+	shift = 0;
+
+	do {
+		if (p >= e || shift > 63) {
+			return 0;
+		}
+
+		node->count |= (uint64_t) (*p & 0x7f) << shift;
+		shift += 7;
+	} while (*p++ & 0x80);
+
+	if ((size_t) (e - p) < node->n) {
+		return 0;
+	}
+
+	node->sym = p;
+	node->tgt = p + node->n;
+
+	if ((size_t) (e - node->tgt) < (node->n * dawg->width + 7) / 8) {
+		return 0;
+	}
+
+	return 1;
+}
+
+static size_t
+node_target(const struct fsm_dawg *dawg, const struct dawg_node *node, unsigned i)
+{
+	size_t bit;
+	uint64_t v;
+	unsigned nbytes, k;
+
+	bit = (size_t) i * dawg->width;
+	nbytes = (bit % 8 + dawg->width + 7) / 8;
+
+	v = 0;
+	for (k = 0; k < nbytes; k++) {
+		v |= (uint64_t) node->tgt[bit / 8 + k] << (8 * k);
+	}
+
+	v >>= bit % 8;
+
+	return v & (((uint64_t) 1 << dawg->width) - 1);
+}
+
+static int
+node_find(const struct dawg_node *node, unsigned char c, unsigned *i)
+{
+	unsigned lo, hi;
+
+	lo = 0;
+	hi = node->n;
+
+	while (lo < hi) {
+		unsigned mid = lo + (hi - lo) / 2;
+
+		if (node->sym[mid] < c) {
+			lo = mid + 1;
+		} else {
+			hi = mid;
+		}
+	}
+
+	if (lo == node->n || node->sym[lo] != c) {
+		return 0;
+	}
+
+	*i = lo;
+	return 1;
+}
+
+/*
+ * Walk s from the start node, stopping at the first octet without
+ * an edge. Returns the number of octets consumed, and the final node.
+ */
+static size_t
+walk(const struct fsm_dawg *dawg, const char *s, size_t n,
+	struct dawg_node *node, int *ok)
+{
+	size_t k;
+
+	*ok = node_decode(dawg, dawg->start, node);
+	if (!*ok) {
+		return 0;
+	}
+
+	for (k = 0; k < n; k++) {
+		unsigned i;
+
+		if (!node_find(node, (unsigned char) s[k], &i)) {
+			break;
+		}
+
+		*ok = node_decode(dawg, node_target(dawg, node, i), node);
+		if (!*ok) {
+			break;
+		}
+	}
+
+	return k;
+}
+
+int
+fsm_dawg_contains(const struct fsm_dawg *dawg, const char *s, size_t n)
+{
+	struct dawg_node node;
+	int ok;
+
+	assert(dawg != NULL);
+	assert(s != NULL || n == 0);
+
+	return walk(dawg, s, n, &node, &ok) == n && ok && node.end;
+}
+
+int
+fsm_dawg_hasprefix(const struct fsm_dawg *dawg, const char *s, size_t n)
+{
+	struct dawg_node node;
+	int ok;
+
+	assert(dawg != NULL);
+	assert(s != NULL || n == 0);
+
+	return walk(dawg, s, n, &node, &ok) == n && ok && node.count > 0;
+}
+
+int
+fsm_dawg_longest_prefix(const struct fsm_dawg *dawg, const char *s, size_t n,
+	size_t *len)
+{
+	struct dawg_node node;
+	size_t k;
+	int found;
+
+	assert(dawg != NULL);
+	assert(s != NULL || n == 0);
+	assert(len != NULL);
+
+	if (!node_decode(dawg, dawg->start, &node)) {
+		return 0;
+	}
+
+	found = 0;
+
+	for (k = 0; ; k++) {
+		unsigned i;
+
+		if (node.end) {
+			*len = k;
+			found = 1;
+		}
+
+		if (k == n || !node_find(&node, (unsigned char) s[k], &i)) {
+			break;
+		}
+
+		if (!node_decode(dawg, node_target(dawg, &node, i), &node)) {
+			break;
+		}
+	}
+
+	return found;
+}
+
+int
+fsm_dawg_index(const struct fsm_dawg *dawg, const char *s, size_t n,
+	size_t *id)
+{
+	struct dawg_node node, sib;
+	uint64_t rank;
+	size_t k;
+
+	assert(dawg != NULL);
+	assert(s != NULL || n == 0);
+	assert(id != NULL);
+
+	if (!node_decode(dawg, dawg->start, &node)) {
+		return 0;
+	}
+
+	rank = 0;
+
+	for (k = 0; k < n; k++) {
+		unsigned i, j;
+
+		if (!node_find(&node, (unsigned char) s[k], &i)) {
+			return 0;
+		}
+
+		/* a word ending here sorts before any longer word */
+		rank += node.end;
+
+		for (j = 0; j < i; j++) {
+			if (!node_decode(dawg, node_target(dawg, &node, j), &sib)) {
+				return 0;
+			}
+
+			rank += sib.count;
+		}
+
+		if (!node_decode(dawg, node_target(dawg, &node, i), &node)) {
+			return 0;
+		}
+	}
+
+	if (!node.end) {
+		return 0;
+	}
+
+	*id = rank;
+	return 1;
+}
+
+long
+fsm_dawg_word(const struct fsm_dawg *dawg, size_t id,
+	char *buf, size_t bufsz)
+{
+	struct dawg_node node, child;
+	uint64_t rem;
+	size_t k;
+
+	assert(dawg != NULL);
+	assert(buf != NULL || bufsz == 0);
+
+	if (id >= dawg->count) {
+		return -1;
+	}
+
+	if (!node_decode(dawg, dawg->start, &node)) {
+		return -1;
+	}
+
+	rem = id;
+
+	for (k = 0; ; k++) {
+		unsigned i;
+
+		/* no word is longer than there are nodes; malformed input may cycle */
+		if (k > dawg->len) {
+			return -1;
+		}
+
+		if (node.end) {
+			if (rem == 0) {
+				break;
+			}
+
+			rem--;
+		}
+
+		for (i = 0; i < node.n; i++) {
+			if (!node_decode(dawg, node_target(dawg, &node, i), &child)) {
+				return -1;
+			}
+
+			if (rem < child.count) {
+				break;
+			}
+
+			rem -= child.count;
+		}
+
+		if (i == node.n) {
+			/* counts are inconsistent; malformed input */
+			return -1;
+		}
+
+		if (k + 1 < bufsz) {
+			buf[k] = node.sym[i];
+		}
+
+		node = child;
+	}
+
+	if (bufsz > 0) {
+		buf[k < bufsz ? k : bufsz - 1] = '\0';
+	}
+
+	if (k > LONG_MAX) {
+		errno = ERANGE;
+		return -1;
+	}
+
+	return k;
+}
+
@@ -5,15 +5,20 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 #include <stddef.h>
+#include <stdio.h>
 #include <errno.h>
 
 #include <fsm/fsm.h>
 #include <fsm/pred.h>
 #include <fsm/walk.h>
 
+#include <print/esc.h>
+
 #include <adt/alloc.h>
 #include <adt/set.h>
+#include <adt/bitmap.h>
 #include <adt/edgeset.h>
 #include <adt/stateset.h>
 #include <adt/hashset.h>
@@ -154,6 +159,119 @@ stack_pop(struct mappingstack **stack, const struct fsm_alloc *alloc)
 	return m;
 }
 
+/*
+ * Find the DFA state for a set of NFA states, creating a new one (and
+ * pushing it to the todo list) if none exists. Ownership of the set
+ * passes to the mapping, or the set is freed.
+ */
+static struct mapping *
+closure_mapping(struct mapping_hashset *mappings, const struct fsm_alloc *alloc,
+	size_t *dfacount, struct mappingstack **stack, struct state_set *closure)
+{
+	struct mapping *m;
+
+	/*
+	 * We use the mappings as a de-duplication mechanism, keyed by this
+	 * set of NFA states.
+	 */
+
+	/* Use an existing mapping if present, otherwise add a new one */
+	m = mapping_find(mappings, closure);
+	if (m != NULL) {
+		/* we already have this closure, free this instance */
+		state_set_free(closure);
+
+		assert(m->dfastate < *dfacount);
+
+		return m;
+	}
+
+	m = mapping_add(mappings, alloc, (*dfacount)++, closure);
+	if (m == NULL) {
+		return NULL;
+	}
+
+	/* ownership belongs to the mapping now, so don't free closure */
+
+	if (!stack_push(stack, alloc, m)) {
+		return NULL;
+	}
+
+	return m;
+}
+
+/*
+ * Symbols which have no explicit edge from any state in the closure,
+ * and which are covered by the default edge of every state with one,
+ * all lead to the same set of NFA states. These are gathered into one
+ * closure, so that the DFA state gets a default edge too. Default edges
+ * for the remaining symbols are added to the per-symbol closures.
+ */
+static int
+default_closure(const struct fsm *nfa, const struct state_set *closure,
+	struct state_set *sclosures[FSM_SIGMA_COUNT],
+	struct state_set **dclosure, struct bm *dsymbols)
+{
+	struct state_iter it;
+	struct bm symbols;
+	fsm_state_t s, to;
+	int i;
+
+	*dclosure = NULL;
+
+	bm_clear(dsymbols);
+	bm_invert(dsymbols);
+
+	for (state_set_reset((void *) closure, &it); state_set_next(&it, &s); ) {
+		if (!edge_set_default(nfa->states[s].edges, &symbols, &to)) {
+			continue;
+		}
+
+		for (i = 0; i < (int) sizeof symbols.map; i++) {
+			dsymbols->map[i] &= symbols.map[i];
+		}
+
+		if (!state_set_add(dclosure, nfa->opt->alloc, to)) {
+			return 0;
+		}
+	}
+
+	if (*dclosure == NULL) {
+		bm_clear(dsymbols);
+		return 1;
+	}
+
+	for (i = 0; i <= FSM_SIGMA_MAX; i++) {
+		if (sclosures[i] != NULL) {
+			dsymbols->map[i / CHAR_BIT] &= ~(1U << i % CHAR_BIT);
+		}
+	}
+
+	for (state_set_reset((void *) closure, &it); state_set_next(&it, &s); ) {
+		if (!edge_set_default(nfa->states[s].edges, &symbols, &to)) {
+			continue;
+		}
+
+		i = -1;
+		while (i = bm_next(&symbols, i, 1), i <= UCHAR_MAX) {
+			if (bm_get(dsymbols, i)) {
+				continue;
+			}
+
+			if (!state_set_add(&sclosures[i], nfa->opt->alloc, to)) {
+				return 0;
+			}
+		}
+	}
+
+	if (bm_count(dsymbols) == 0) {
+		state_set_free(*dclosure);
+		*dclosure = NULL;
+	}
+
+	return 1;
+}
+
 int
 fsm_determinise(struct fsm *nfa)
 {
@@ -226,6 +344,8 @@ fsm_determinise(struct fsm *nfa)
 
 	do {
 		struct state_set *sclosures[FSM_SIGMA_COUNT] = { NULL };
+		struct state_set *dclosure;
+		struct bm dsymbols;
 		int i;
 
 		assert(curr != NULL);
@@ -248,6 +368,11 @@ fsm_determinise(struct fsm *nfa)
 			}
 		}
 
+		if (!default_closure(nfa, curr->closure, sclosures, &dclosure, &dsymbols)) {
+			/* TODO: free mappings, sclosures, stack */
+			goto error;
+		}
+
 		for (i = 0; i <= FSM_SIGMA_MAX; i++) {
 			struct mapping *m;
 
@@ -257,33 +382,29 @@ fsm_determinise(struct fsm *nfa)
 
 			/*
 			 * The set of NFA states sclosures[i] represents a single DFA state.
-			 * We use the mappings as a de-duplication mechanism, keyed by this
-			 * set of NFA states.
 			 */
+			m = closure_mapping(mappings, nfa->opt->alloc, &dfacount, &stack, sclosures[i]);
+			if (m == NULL) {
+				/* TODO: free mappings, sclosures, stack */
+				goto error;
+			}
 
-			/* Use an existing mapping if present, otherwise add a new one */
-			m = mapping_find(mappings, sclosures[i]);
-			if (m != NULL) {
-				/* we already have this closure, free this instance */
-				state_set_free(sclosures[i]);
-
-				assert(m->dfastate < dfacount);
-			} else {
-				m = mapping_add(mappings, nfa->opt->alloc, dfacount++, sclosures[i]);
-				if (m == NULL) {
-					/* TODO: free mappings, sclosures, stack */
-					goto error;
-				}
+			if (!edge_set_add(&curr->edges, nfa->opt->alloc, i, m->dfastate)) {
+				/* TODO: free mappings, sclosures, stack */
+				goto error;
+			}
+		}
 
-				/* ownership belongs to the mapping now, so don't free sclosures[i] */
+		if (dclosure != NULL) {
+			struct mapping *m;
 
-				if (!stack_push(&stack, nfa->opt->alloc, m)) {
-					/* TODO: free mappings, sclosures, stack */
-					goto error;
-				}
+			m = closure_mapping(mappings, nfa->opt->alloc, &dfacount, &stack, dclosure);
+			if (m == NULL) {
+				/* TODO: free mappings, sclosures, stack */
+				goto error;
 			}
 
-			if (!edge_set_add(&curr->edges, nfa->opt->alloc, i, m->dfastate)) {
+			if (!edge_set_add_bulk(&curr->edges, nfa->opt->alloc, &dsymbols, m->dfastate)) {
 				/* TODO: free mappings, sclosures, stack */
 				goto error;
 			}
@@ -340,7 +461,9 @@ fsm_determinise(struct fsm *nfa)
 			 * The closure may contain non-end states, but at least one state is
 			 * known to have been an end state.
 			 */
-			fsm_carryopaque(nfa, m->closure, dfa, m->dfastate);
+			if (!fsm_carryopaque(nfa, m->closure, dfa, m->dfastate)) {
+				goto error;
+			}
 		}
 
 		fsm_move(nfa, dfa);
@@ -7,10 +7,14 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <limits.h>
+#include <stdio.h>
 
 #include <fsm/fsm.h>
 
+#include <print/esc.h>
+
 #include <adt/set.h>
+#include <adt/bitmap.h>
 #include <adt/stateset.h>
 #include <adt/edgeset.h>
 
@@ -35,17 +39,17 @@ int
 fsm_addedge_any(struct fsm *fsm,
 	fsm_state_t from, fsm_state_t to)
 {
-	int i;
+	struct bm bm;
 
 	assert(fsm != NULL);
 	assert(from < fsm->statecount);
 	assert(to < fsm->statecount);
 
-	/* TODO: bulk add by symbol, presumably as a bitmap */
-	for (i = 0; i <= UCHAR_MAX; i++) {
-		if (!fsm_addedge_literal(fsm, from, to, (unsigned char) i)) {
-			return 0;
-		}
+	bm_clear(&bm);
+	bm_invert(&bm);
+
+	if (!edge_set_add_bulk(&fsm->states[from].edges, fsm->opt->alloc, &bm, to)) {
+		return 0;
 	}
 
 	return 1;
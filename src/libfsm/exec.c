@@ -38,7 +38,7 @@ fsm_exec(const struct fsm *fsm,
 	int (*fsm_getc)(void *opaque), void *opaque,
 	fsm_state_t *end)
 {
-	fsm_state_t state;
+	fsm_state_t state, next, checked;
 	int c;
 
 	assert(fsm != NULL);
@@ -59,12 +59,33 @@ fsm_exec(const struct fsm *fsm,
 		return -1;
 	}
 
+	checked = state;
+	if (fsm_isabsorbing(fsm, state)) {
+		goto done;
+	}
+
 	while (c = fsm_getc(opaque), c != EOF) {
-		if (!transition(fsm, state, c, &state)) {
+		if (!transition(fsm, state, c, &next)) {
 			return 0;
 		}
+
+		/*
+		 * Every edge from an absorbing state leads back to itself,
+		 * so it's enough to check on the first self-loop taken
+		 * after entering a state, rather than for every byte.
+		 */
+		if (next == state && state != checked) {
+			checked = state;
+			if (fsm_isabsorbing(fsm, state)) {
+				break;
+			}
+		}
+
+		state = next;
 	}
 
+done:
+
 	if (!fsm_isend(fsm, state)) {
 		return 0;
 	}
@@ -162,8 +162,8 @@ fsm_carryopaque_array(struct fsm *src_fsm, const fsm_state_t *src_set, size_t n,
 		dst_fsm, dst_state);
 }
 
-void
-fsm_carryopaque(struct fsm *src_fsm, const struct state_set *src_set,
+int
+fsm_carryopaque(struct fsm *src_fsm, struct state_set *src_set,
 	struct fsm *dst_fsm, fsm_state_t dst_state)
 {
 	fsm_state_t src_state;
@@ -178,7 +178,7 @@ fsm_carryopaque(struct fsm *src_fsm, const struct state_set *src_set,
 
 	/* TODO: right? */
 	if (state_set_empty(src_set)) {
-		return;
+		return 1;
 	}
 
 	n = state_set_count(src_set);
@@ -196,9 +196,14 @@ fsm_carryopaque(struct fsm *src_fsm, const struct state_set *src_set,
 		 * because the user-facing API doesn't expose the state set ADT.
 		 */
 		p = state_set_array(src_set);
+		if (p == NULL) {
+			return 0;
+		}
 	}
 
 	fsm_carryopaque_array(src_fsm, p, n, dst_fsm, dst_state);
+
+	return 1;
 }
 
 unsigned int
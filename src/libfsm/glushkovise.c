@@ -100,7 +100,9 @@ fsm_glushkovise(struct fsm *nfa)
 		 * The closure may contain non-end states, but at least one state is
 		 * known to have been an end state.
 		 */
-		fsm_carryopaque(nfa, eclosures[s], nfa, s);
+		if (!fsm_carryopaque(nfa, eclosures[s], nfa, s)) {
+			goto error;
+		}
 
 	}
 
@@ -74,8 +74,8 @@ void
 fsm_carryopaque_array(struct fsm *src_fsm, const fsm_state_t *src_set, size_t n,
     struct fsm *dst_fsm, fsm_state_t dst_state);
 
-void
-fsm_carryopaque(struct fsm *fsm, const struct state_set *set,
+int
+fsm_carryopaque(struct fsm *fsm, struct state_set *set,
 	struct fsm *new, fsm_state_t state);
 
 struct fsm *
@@ -135,9 +135,11 @@ void *
 f_realloc(const struct fsm_alloc *a, void *p, size_t sz);
 
 /* Take a source fsm and a state mapping, produce a new
- * fsm where states may be consolidated. */
+ * fsm where states may be consolidated. If by_opaque is set,
+ * end states are only consolidated with others of the same
+ * opaque, and carryopaque is not called for them. */
 struct fsm *
 fsm_consolidate(struct fsm *src,
-    const fsm_state_t *mapping, size_t mapping_count);
+    const fsm_state_t *mapping, size_t mapping_count, int by_opaque);
 
 #endif
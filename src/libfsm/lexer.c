@@ -0,0 +1,645 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/pred.h>
+#include <fsm/walk.h>
+#include <fsm/lexer.h>
+
+#include <adt/set.h>
+#include <adt/edgeset.h>
+
+#include "internal.h"
+
+/*
+ * Serialised layout; all integers are u32, little-endian:
+ *
+ *   0  magic "FSMLEX" and a version octet each for major and minor
+ *   8  number of states, n
+ *  12  number of byte classes
+ *  16  number of zones
+ *  20  number of tokens
+ *  24  the starting zone
+ *  28  byte classes, one octet per byte value
+ *      the start state for each zone
+ *      per state, the token produced and the zone switched to; a state
+ *      which does not accept has LEXER_NOTEND for its token
+ *      transitions, n rows of one state per class, n meaning none
+ *      per token, the length of its name and then the name itself
+ *
+ * The zones' DFAs are numbered consecutively into the one set of states.
+ */
+
+#define LEXER_MAGIC "FSMLEX"
+#define LEXER_MAJOR 0x00
+#define LEXER_MINOR 0x01
+
+#define LEXER_NOTEND ((uint32_t) -2)
+
+struct lexer_end {
+	int32_t token; /* FSM_LEXER_UNKNOWN if not accepting, FSM_LEXER_EOF to skip */
+	uint32_t zone;
+};
+
+/*
+ * In memory, states are held as the offset of their row in next[],
+ * so a transition is one lookup of next[s + cls[c]]. The row for
+ * state n has no transitions, and is where none leads.
+ */
+struct fsm_lexer {
+	unsigned nclasses;
+	unsigned char cls[FSM_SIGMA_COUNT];
+
+	uint32_t n;
+	uint32_t dead;  /* n * nclasses */
+	uint32_t *next; /* n * nclasses */
+	struct lexer_end *end; /* by state */
+
+	uint32_t nzones;
+	uint32_t *zstart; /* row offsets */
+	uint32_t start;
+
+	uint32_t ntokens;
+	char **name;
+};
+
+/* each state's transitions, with the dead state for none */
+static void
+state_row(const struct fsm *fsm, fsm_state_t s, fsm_state_t base, fsm_state_t dead,
+	fsm_state_t row[FSM_SIGMA_COUNT])
+{
+	struct edge_iter it;
+	struct fsm_edge e;
+	unsigned c;
+
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		row[c] = dead;
+	}
+
+	for (edge_set_reset(fsm->states[s].edges, &it); edge_set_next(&it, &e); ) {
+		row[e.symbol] = base + e.state;
+	}
+}
+
+/*
+ * Refine the byte classes so that no two bytes in the same class
+ * lead to different states from this row.
+ */
+static void
+refine(unsigned char cls[FSM_SIGMA_COUNT], unsigned *nclasses,
+	const fsm_state_t row[FSM_SIGMA_COUNT])
+{
+	/* a chain per existing class of (dest, new class) pairs */
+	int head[FSM_SIGMA_COUNT];
+	int chain[FSM_SIGMA_COUNT];
+	fsm_state_t dest[FSM_SIGMA_COUNT];
+	unsigned char newcls[FSM_SIGMA_COUNT];
+	unsigned c, used;
+	int e;
+
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		head[c] = -1;
+	}
+
+	used = 0;
+
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		const unsigned k = cls[c];
+
+		for (e = head[k]; e != -1; e = chain[e]) {
+			if (dest[e] == row[c]) {
+				break;
+			}
+		}
+
+		if (e == -1) {
+			e = used++;
+			dest[e]  = row[c];
+			chain[e] = head[k];
+
+			/* the first split of a class keeps its number */
+			newcls[e] = (head[k] == -1) ? k : (*nclasses)++;
+			head[k]  = e;
+		}
+
+		cls[c] = newcls[e];
+	}
+}
+
+static int
+put_u32(FILE *f, uint32_t v)
+{
+	unsigned char b[4];
+
+	b[0] = v;
+	b[1] = v >> 8;
+	b[2] = v >> 16;
+	b[3] = v >> 24;
+
+	return fwrite(b, sizeof b, 1, f) == 1;
+}
+
+static int
+get_u32(FILE *f, uint32_t *v)
+{
+	unsigned char b[4];
+
+	if (fread(b, sizeof b, 1, f) != 1) {
+		return 0;
+	}
+
+	*v = (uint32_t) b[0]
+		| (uint32_t) b[1] << 8
+		| (uint32_t) b[2] << 16
+		| (uint32_t) b[3] << 24;
+
+	return 1;
+}
+
+int
+fsm_lexer_write(FILE *f,
+	const struct fsm *const zone[], size_t nzones, unsigned start,
+	const char *const name[], size_t ntokens,
+	void (*end)(const struct fsm *fsm, fsm_state_t state,
+		unsigned *token, unsigned *zone, void *opaque),
+	void *opaque)
+{
+	fsm_state_t row[FSM_SIGMA_COUNT];
+	unsigned char cls[FSM_SIGMA_COUNT];
+	unsigned char header[8];
+	fsm_state_t *base;
+	fsm_state_t n, s;
+	unsigned nclasses;
+	size_t i;
+	unsigned c;
+
+	assert(f != NULL);
+	assert(zone != NULL || nzones == 0);
+	assert(name != NULL || ntokens == 0);
+	assert(end != NULL);
+
+	if (nzones == 0 || start >= nzones
+	 || nzones >= FSM_LEXER_STAY || ntokens >= (uint32_t) FSM_LEXER_ERROR) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	base = malloc(nzones * sizeof *base);
+	if (base == NULL) {
+		return 0;
+	}
+
+	n = 0;
+
+	for (i = 0; i < nzones; i++) {
+		fsm_state_t q;
+
+		if (!fsm_all(zone[i], fsm_isdfa) || !fsm_getstart(zone[i], &q)) {
+			goto einval;
+		}
+
+		if (zone[i]->statecount >= UINT32_MAX - n) {
+			free(base);
+			errno = ERANGE;
+			return 0;
+		}
+
+		base[i] = n;
+		n += zone[i]->statecount;
+	}
+
+	memset(cls, 0, sizeof cls);
+	nclasses = 1;
+
+	for (i = 0; i < nzones; i++) {
+		for (s = 0; s < zone[i]->statecount; s++) {
+			state_row(zone[i], s, base[i], n, row);
+			refine(cls, &nclasses, row);
+		}
+	}
+
+	memcpy(&header[0], LEXER_MAGIC, 6);
+	header[6] = LEXER_MAJOR;
+	header[7] = LEXER_MINOR;
+
+	if (fwrite(header, sizeof header, 1, f) != 1) {
+		goto error;
+	}
+
+	if (!put_u32(f, n) || !put_u32(f, nclasses)
+	 || !put_u32(f, nzones) || !put_u32(f, ntokens) || !put_u32(f, start)) {
+		goto error;
+	}
+
+	if (fwrite(cls, sizeof cls, 1, f) != 1) {
+		goto error;
+	}
+
+	for (i = 0; i < nzones; i++) {
+		fsm_state_t q;
+
+		(void) fsm_getstart(zone[i], &q);
+
+		if (!put_u32(f, base[i] + q)) {
+			goto error;
+		}
+	}
+
+	for (i = 0; i < nzones; i++) {
+		for (s = 0; s < zone[i]->statecount; s++) {
+			unsigned token, to;
+
+			if (!fsm_isend(zone[i], s)) {
+				token = LEXER_NOTEND;
+				to    = FSM_LEXER_STAY;
+			} else {
+				token = FSM_LEXER_SKIP;
+				to    = FSM_LEXER_STAY;
+
+				end(zone[i], s, &token, &to, opaque);
+
+				if (token != FSM_LEXER_SKIP && token >= ntokens) {
+					goto einval;
+				}
+
+				if (to != FSM_LEXER_STAY && to >= nzones) {
+					goto einval;
+				}
+			}
+
+			if (!put_u32(f, token) || !put_u32(f, to)) {
+				goto error;
+			}
+		}
+	}
+
+	for (i = 0; i < nzones; i++) {
+		for (s = 0; s < zone[i]->statecount; s++) {
+			fsm_state_t out[FSM_SIGMA_COUNT];
+
+			state_row(zone[i], s, base[i], n, row);
+
+			for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+				out[cls[c]] = row[c];
+			}
+
+			for (c = 0; c < nclasses; c++) {
+				if (!put_u32(f, out[c])) {
+					goto error;
+				}
+			}
+		}
+	}
+
+	for (i = 0; i < ntokens; i++) {
+		size_t len;
+
+		assert(name[i] != NULL);
+
+		len = strlen(name[i]);
+
+		if (!put_u32(f, len) || fwrite(name[i], 1, len, f) != len) {
+			goto error;
+		}
+	}
+
+	free(base);
+
+	return 1;
+
+einval:
+
+	errno = EINVAL;
+
+error:
+
+	free(base);
+
+	return 0;
+}
+
+void
+fsm_lexer_free(struct fsm_lexer *lexer)
+{
+	uint32_t i;
+
+	if (lexer == NULL) {
+		return;
+	}
+
+	if (lexer->name != NULL) {
+		for (i = 0; i < lexer->ntokens; i++) {
+			free(lexer->name[i]);
+		}
+	}
+
+	free(lexer->name);
+	free(lexer->next);
+	free(lexer->end);
+	free(lexer->zstart);
+	free(lexer);
+}
+
+struct fsm_lexer *
+fsm_lexer_read(FILE *f)
+{
+	unsigned char header[8];
+	struct fsm_lexer *lexer;
+	uint32_t nclasses;
+	uint32_t i;
+	size_t rows;
+	unsigned c;
+
+	assert(f != NULL);
+
+	if (fread(header, sizeof header, 1, f) != 1) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	if (memcmp(&header[0], LEXER_MAGIC, 6) != 0
+	 || header[6] != LEXER_MAJOR || header[7] != LEXER_MINOR) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	lexer = calloc(1, sizeof *lexer);
+	if (lexer == NULL) {
+		return NULL;
+	}
+
+	if (!get_u32(f, &lexer->n) || !get_u32(f, &nclasses)
+	 || !get_u32(f, &lexer->nzones) || !get_u32(f, &lexer->ntokens)
+	 || !get_u32(f, &lexer->start)) {
+		goto einval;
+	}
+
+	if (nclasses == 0 || nclasses > FSM_SIGMA_COUNT
+	 || lexer->nzones == 0 || lexer->start >= lexer->nzones
+	 || lexer->ntokens >= (uint32_t) FSM_LEXER_ERROR) {
+		goto einval;
+	}
+
+	/* row offsets include the dead row, n * nclasses */
+	if (lexer->n >= UINT32_MAX / nclasses) {
+		goto einval;
+	}
+
+	lexer->nclasses = nclasses;
+	lexer->dead     = lexer->n * nclasses;
+	rows = lexer->n;
+
+	if (fread(lexer->cls, sizeof lexer->cls, 1, f) != 1) {
+		goto einval;
+	}
+
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		if (lexer->cls[c] >= nclasses) {
+			goto einval;
+		}
+	}
+
+	lexer->zstart = malloc(lexer->nzones * sizeof *lexer->zstart);
+	lexer->end    = malloc((rows > 0 ? rows : 1) * sizeof *lexer->end);
+	lexer->next   = malloc((rows + 1) * nclasses * sizeof *lexer->next);
+	lexer->name   = calloc(lexer->ntokens > 0 ? lexer->ntokens : 1, sizeof *lexer->name);
+	if (lexer->zstart == NULL || lexer->end == NULL || lexer->next == NULL || lexer->name == NULL) {
+		goto error;
+	}
+
+	for (i = 0; i < lexer->nzones; i++) {
+		uint32_t q;
+
+		if (!get_u32(f, &q) || q >= lexer->n) {
+			goto einval;
+		}
+
+		lexer->zstart[i] = q * nclasses;
+	}
+
+	for (i = 0; i < rows; i++) {
+		uint32_t token, to;
+
+		if (!get_u32(f, &token) || !get_u32(f, &to)) {
+			goto einval;
+		}
+
+		if (to != FSM_LEXER_STAY && to >= lexer->nzones) {
+			goto einval;
+		}
+
+		if (token == LEXER_NOTEND) {
+			lexer->end[i].token = FSM_LEXER_UNKNOWN;
+		} else if (token == FSM_LEXER_SKIP) {
+			lexer->end[i].token = FSM_LEXER_EOF;
+		} else if (token < lexer->ntokens) {
+			lexer->end[i].token = token;
+		} else {
+			goto einval;
+		}
+
+		lexer->end[i].zone = to;
+	}
+
+	for (i = 0; i < rows * nclasses; i++) {
+		uint32_t q;
+
+		if (!get_u32(f, &q) || q > lexer->n) {
+			goto einval;
+		}
+
+		lexer->next[i] = q * nclasses;
+	}
+
+	for (c = 0; c < nclasses; c++) {
+		lexer->next[lexer->dead + c] = lexer->dead;
+	}
+
+	for (i = 0; i < lexer->ntokens; i++) {
+		uint32_t len;
+
+		if (!get_u32(f, &len) || len == UINT32_MAX) {
+			goto einval;
+		}
+
+		lexer->name[i] = malloc((size_t) len + 1);
+		if (lexer->name[i] == NULL) {
+			goto error;
+		}
+
+		if (len > 0 && fread(lexer->name[i], len, 1, f) != 1) {
+			goto einval;
+		}
+
+		lexer->name[i][len] = '\0';
+	}
+
+	return lexer;
+
+einval:
+
+	errno = EINVAL;
+
+error:
+
+	fsm_lexer_free(lexer);
+
+	return NULL;
+}
+
+size_t
+fsm_lexer_ntokens(const struct fsm_lexer *lexer)
+{
+	assert(lexer != NULL);
+
+	return lexer->ntokens;
+}
+
+const char *
+fsm_lexer_name(const struct fsm_lexer *lexer, int token)
+{
+	assert(lexer != NULL);
+
+	if (token < 0 || (uint32_t) token >= lexer->ntokens) {
+		return NULL;
+	}
+
+	return lexer->name[token];
+}
+
+void
+fsm_lexer_init(const struct fsm_lexer *lexer, struct fsm_lexer_input *in,
+	const char *buf, size_t n)
+{
+	assert(lexer != NULL);
+	assert(in != NULL);
+	assert(buf != NULL || n == 0);
+
+	in->p    = buf;
+	in->e    = buf + n;
+	in->tok  = buf;
+	in->zone = lexer->start;
+	in->pos  = 0;
+
+	in->end.byte = 0;
+	in->end.line = 1;
+	in->end.col  = 1;
+	in->start    = in->end;
+}
+
+static void
+advance(struct fsm_lexer_input *in, const char *p, const char *e)
+{
+	if (!in->pos) {
+		in->end.byte += e - p;
+		return;
+	}
+
+	for ( ; p < e; p++) {
+		in->end.byte++;
+		in->end.col++;
+
+		if (*p == '\n') {
+			in->end.line++;
+			in->end.col = 1;
+		}
+	}
+}
+
+int
+fsm_lexer_next(const struct fsm_lexer *lexer, struct fsm_lexer_input *in)
+{
+	const unsigned char *cls;
+	const uint32_t *next;
+	const unsigned char *p, *e;
+	const struct lexer_end *x;
+	uint32_t s, dead;
+
+	assert(lexer != NULL);
+	assert(in != NULL);
+	assert(in->p != NULL || in->p == in->e);
+	assert(in->zone < lexer->nzones);
+
+	cls  = lexer->cls;
+	next = lexer->next;
+	dead = lexer->dead;
+
+	p = (const unsigned char *) in->p;
+	e = (const unsigned char *) in->e;
+
+	/* as for lx, the end of input is where the last token left off */
+	if (p == e) {
+		in->tok = in->p;
+		return FSM_LEXER_EOF;
+	}
+
+restart:
+
+	in->tok   = (const char *) p;
+	in->start = in->end;
+
+	s = lexer->zstart[in->zone];
+
+	for (;;) {
+		uint32_t q;
+
+		if (p == e) {
+			in->p = (const char *) p;
+			advance(in, in->tok, in->p);
+
+			if (in->p == in->tok) {
+				return FSM_LEXER_EOF;
+			}
+
+			x = &lexer->end[s / lexer->nclasses];
+
+			if (x->token == FSM_LEXER_UNKNOWN) {
+				errno = EINVAL;
+				return FSM_LEXER_ERROR;
+			}
+
+			/* no point in changing zone here; there's no more input */
+			return x->token;
+		}
+
+		q = next[s + cls[*p]];
+		if (q == dead) {
+			break;
+		}
+
+		s = q;
+		p++;
+	}
+
+	x = &lexer->end[s / lexer->nclasses];
+
+	if (x->token == FSM_LEXER_UNKNOWN) {
+		in->p = (const char *) p + 1;
+		advance(in, in->tok, in->p);
+		return FSM_LEXER_UNKNOWN;
+	}
+
+	in->p = (const char *) p;
+	advance(in, in->tok, in->p);
+
+	if (x->zone != FSM_LEXER_STAY) {
+		in->zone = x->zone;
+	}
+
+	if (x->token == FSM_LEXER_EOF) {
+		goto restart;
+	}
+
+	return x->token;
+}
+
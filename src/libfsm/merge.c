@@ -55,7 +55,9 @@ merge(struct fsm *dst, struct fsm *src,
 		*base_src = dst->statecount;
 
 		for (i = 0; i < src->statecount; i++) {
-			state_set_rebase(&src->states[i].epsilons, *base_src);
+			if (!state_set_rebase(&src->states[i].epsilons, *base_src)) {
+				return NULL;
+			}
 			edge_set_rebase(&src->states[i].edges, *base_src);
 		}
 	}
@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 #include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
@@ -17,6 +18,9 @@
 #include <fsm/walk.h>
 #include <fsm/alloc.h>
 
+#include <print/esc.h>
+
+#include <adt/bitmap.h>
 #include <adt/edgeset.h>
 #include <adt/set.h>
 
@@ -35,8 +39,8 @@
 
 #include "minimise_internal.h"
 
-int
-fsm_minimise(struct fsm *fsm)
+static int
+minimise(struct fsm *fsm, int by_opaque)
 {
 	int r = 0;
 	struct fsm *dst = NULL;
@@ -94,7 +98,7 @@ fsm_minimise(struct fsm *fsm)
 
 	TIME(tv_pre);
 	r = build_minimised_mapping(fsm, labels, label_count,
-	    shortest_end_distance,
+	    shortest_end_distance, by_opaque,
 	    mapping, &minimised_states);
 	TIME(tv_post);
 	LOG_TIME_DELTA("minimise");
@@ -110,7 +114,7 @@ fsm_minimise(struct fsm *fsm)
 	 * into a new DFA, combining states that could not be
 	 * proven distinguishable. */
 	TIME(tv_pre);
-	dst = fsm_consolidate(fsm, mapping, fsm->statecount);
+	dst = fsm_consolidate(fsm, mapping, fsm->statecount, by_opaque);
 	TIME(tv_post);
 	LOG_TIME_DELTA("consolidate");
 
@@ -132,14 +136,33 @@ cleanup:
 	return r;
 }
 
+int
+fsm_minimise(struct fsm *fsm)
+{
+	return minimise(fsm, 0);
+}
+
+int
+fsm_minimise_opaque(struct fsm *fsm)
+{
+	return minimise(fsm, 1);
+}
+
 /* Build a bit set of labels used, then write the set
- * into a sorted array. */
+ * into a sorted array.
+ *
+ * Symbols which appear only in default edges, and in the default
+ * edges of exactly the same states, go to the same place from every
+ * state, so no one of them can partition an EC differently from the
+ * others. Only the first symbol of each such class is used as a label. */
 static void
 collect_labels(const struct fsm *fsm,
     unsigned char *labels, size_t *label_count)
 {
-	size_t count = 0;
 	uint64_t label_set[FSM_SIGMA_COUNT/64] = { 0, 0, 0, 0 };
+	uint64_t classes[FSM_SIGMA_COUNT][FSM_SIGMA_COUNT/64];
+	size_t class_count = 0;
+	size_t c;
 	int i;
 
 	fsm_state_t id;
@@ -147,16 +170,74 @@ collect_labels(const struct fsm *fsm,
 		struct fsm_edge e;
 		struct edge_iter ei;
 		unsigned char label;
-		for (edge_set_reset(fsm->states[id].edges, &ei);
+		for (edge_set_reset_explicit(fsm->states[id].edges, &ei);
 		     edge_set_next(&ei, &e); ) {
 			assert(e.state < fsm->statecount);
 			label = e.symbol;
 
-			if (label_set[label/64] & (1UL << (label & 63))) {
-				/* already set, ignore */
-			} else {
-				label_set[label/64] |= (1UL << (label & 63));
-				count++;
+			label_set[label/64] |= (1UL << (label & 63));
+		}
+	}
+
+	/* The default-only symbols start out as one class... */
+	memset(classes[0], 0x00, sizeof classes[0]);
+	for (id = 0; id < fsm->statecount; id++) {
+		struct bm bm;
+
+		if (!edge_set_default(fsm->states[id].edges, &bm, NULL)) {
+			continue;
+		}
+
+		for (i = 0; i < 256; i++) {
+			if (bm_get(&bm, i) && !(label_set[i/64] & (1UL << (i & 63)))) {
+				classes[0][i/64] |= (1UL << (i & 63));
+			}
+		}
+
+		class_count = 1;
+	}
+
+	/* ...which is then split by each state's default edge. */
+	for (id = 0; id < fsm->statecount && class_count > 0; id++) {
+		struct bm bm;
+		size_t n;
+
+		if (!edge_set_default(fsm->states[id].edges, &bm, NULL)) {
+			continue;
+		}
+
+		n = class_count;
+		for (c = 0; c < n; c++) {
+			uint64_t in[FSM_SIGMA_COUNT/64] = { 0, 0, 0, 0 };
+			uint64_t out[FSM_SIGMA_COUNT/64] = { 0, 0, 0, 0 };
+			int has_in = 0, has_out = 0;
+
+			for (i = 0; i < 256; i++) {
+				if (!(classes[c][i/64] & (1UL << (i & 63)))) {
+					continue;
+				}
+
+				if (bm_get(&bm, i)) {
+					in[i/64] |= (1UL << (i & 63));
+					has_in = 1;
+				} else {
+					out[i/64] |= (1UL << (i & 63));
+					has_out = 1;
+				}
+			}
+
+			if (has_in && has_out) {
+				memcpy(classes[c], in, sizeof in);
+				memcpy(classes[class_count++], out, sizeof out);
+			}
+		}
+	}
+
+	for (c = 0; c < class_count; c++) {
+		for (i = 0; i < 256; i++) {
+			if (classes[c][i/64] & (1UL << (i & 63))) {
+				label_set[i/64] |= (1UL << (i & 63));
+				break;
 			}
 		}
 	}
@@ -168,7 +249,6 @@ collect_labels(const struct fsm *fsm,
 			(*label_count)++;
 		}
 	}
-	assert(*label_count == count);
 }
 
 /* Build a mapping for a minimised version of the DFA, using Moore's
@@ -197,11 +277,15 @@ collect_labels(const struct fsm *fsm,
  * When PARTITION_BY_END_STATE_DISTANCE is non-zero, instead of
  * starting with two ECs, do a pass grouping the states into ECs
  * according to their distance to the closest end state. See the
- * comments around it for further details. */
+ * comments around it for further details.
+ *
+ * When by_opaque is non-zero, end states with different opaques
+ * are also split into different ECs from the start, so they are
+ * distinguishable in the same way as final and non-final states. */
 static int
 build_minimised_mapping(const struct fsm *fsm,
     const unsigned char *dfa_labels, size_t dfa_label_count,
-    const unsigned *shortest_end_distance,
+    const unsigned *shortest_end_distance, int by_opaque,
     fsm_state_t *mapping, size_t *minimized_state_count)
 {
 	struct min_env env;
@@ -224,6 +308,12 @@ build_minimised_mapping(const struct fsm *fsm,
 	env.dfa_labels = dfa_labels;
 	env.dfa_label_count = dfa_label_count;
 
+	memset(env.dfa_label_set, 0x00, sizeof env.dfa_label_set);
+	for (i = 0; i < dfa_label_count; i++) {
+		const unsigned char label = dfa_labels[i];
+		env.dfa_label_set[label/64] |= (1UL << (label & 63));
+	}
+
 	env.state_ecs = f_malloc(fsm->opt->alloc, alloc_size);
 	if (env.state_ecs == NULL) { goto cleanup; }
 
@@ -242,6 +332,10 @@ build_minimised_mapping(const struct fsm *fsm,
 		goto cleanup;
 	}
 
+	if (by_opaque && !partition_by_opaque(&env, fsm)) {
+		goto cleanup;
+	}
+
 #if LOG_INIT
 	for (i = 0; i < env.ec_count; i++) {
 		fprintf(stderr, "# --ec[%lu]: %d\n", i, env.ecs[i]);
@@ -651,6 +745,203 @@ cleanup:
 #endif
 }
 
+struct opaque_end {
+	uintptr_t opaque;
+	fsm_state_t ec;
+	fsm_state_t id;
+	fsm_state_t first; /* lowest id with the same ec and opaque */
+};
+
+static int
+cmp_opaque_end(const void *pa, const void *pb)
+{
+	const struct opaque_end *a = pa;
+	const struct opaque_end *b = pb;
+
+	if (a->ec != b->ec) {
+		return a->ec < b->ec ? -1 : 1;
+	}
+	if (a->opaque != b->opaque) {
+		return a->opaque < b->opaque ? -1 : 1;
+	}
+	if (a->id != b->id) {
+		return a->id < b->id ? -1 : 1;
+	}
+	return 0;
+}
+
+static int
+cmp_opaque_first(const void *pa, const void *pb)
+{
+	const struct opaque_end *a = pa;
+	const struct opaque_end *b = pb;
+
+	if (a->ec != b->ec) {
+		return a->ec < b->ec ? -1 : 1;
+	}
+	if (a->first != b->first) {
+		return a->first < b->first ? -1 : 1;
+	}
+	if (a->id != b->id) {
+		return a->id < b->id ? -1 : 1;
+	}
+	return 0;
+}
+
+static void
+swap_ecs(struct min_env *env, unsigned *counts,
+    fsm_state_t a, fsm_state_t b)
+{
+	fsm_state_t cur, tmp_head;
+	unsigned tmp_count;
+
+	for (cur = env->ecs[a]; cur != NO_ID; cur = env->jump[cur]) {
+		env->state_ecs[cur] = b;
+	}
+	for (cur = env->ecs[b]; cur != NO_ID; cur = env->jump[cur]) {
+		env->state_ecs[cur] = a;
+	}
+
+	tmp_head = env->ecs[a];
+	env->ecs[a] = env->ecs[b];
+	env->ecs[b] = tmp_head;
+
+	tmp_count = counts[a];
+	counts[a] = counts[b];
+	counts[b] = tmp_count;
+}
+
+/* Split the initial ECs so that end states with different opaques
+ * start apart. The end states are sorted by EC and opaque, and each
+ * run of an opaque after the first within an EC moves to a new EC.
+ * This is linear apart from the sort, and so is cheap compared to
+ * the partitioning which follows.
+ *
+ * The new ECs are appended, so afterwards the ECs are reordered to
+ * keep those with fewer than two states after done_ec_offset, and
+ * the small ones are given SMALL_EC_FLAG. */
+static int
+partition_by_opaque(struct min_env *env, const struct fsm *fsm)
+{
+	struct opaque_end *ends = NULL;
+	unsigned *counts = NULL;
+	size_t end_count, i;
+	fsm_state_t ec, lo, hi;
+	int res = 0;
+
+	end_count = 0;
+	for (i = 0; i < fsm->statecount; i++) {
+		if (fsm_isend(fsm, i)) {
+			end_count++;
+		}
+	}
+
+	if (end_count < 2) {
+		return 1;
+	}
+
+	ends = f_malloc(fsm->opt->alloc, end_count * sizeof ends[0]);
+	if (ends == NULL) {
+		goto cleanup;
+	}
+
+	end_count = 0;
+	for (i = 0; i < fsm->statecount; i++) {
+		if (fsm_isend(fsm, i)) {
+			ends[end_count].opaque = (uintptr_t) fsm->states[i].opaque;
+			ends[end_count].ec = env->state_ecs[i];
+			ends[end_count].id = i;
+			end_count++;
+		}
+	}
+
+	qsort(ends, end_count, sizeof ends[0], cmp_opaque_end);
+
+	/*
+	 * The new ECs are numbered in order of their lowest state, rather than
+	 * by the opaques' addresses, so that the result does not depend on
+	 * where the opaques happen to have been allocated.
+	 */
+	for (i = 0; i < end_count; i++) {
+		if (i > 0 && ends[i].ec == ends[i - 1].ec
+		 && ends[i].opaque == ends[i - 1].opaque) {
+			ends[i].first = ends[i - 1].first;
+		} else {
+			ends[i].first = ends[i].id;
+		}
+	}
+
+	qsort(ends, end_count, sizeof ends[0], cmp_opaque_first);
+
+	for (i = 1; i < end_count; i++) {
+		if (ends[i].ec != ends[i - 1].ec) {
+			continue;
+		}
+
+		if (ends[i].first == ends[i - 1].first) {
+			env->state_ecs[ends[i].id] = env->state_ecs[ends[i - 1].id];
+		} else {
+			env->state_ecs[ends[i].id] = env->ec_count++;
+		}
+	}
+
+	counts = f_calloc(fsm->opt->alloc, env->ec_count, sizeof counts[0]);
+	if (counts == NULL) {
+		goto cleanup;
+	}
+
+	/* relink every EC's list from state_ecs[] */
+	for (ec = 0; ec < env->ec_count; ec++) {
+		env->ecs[ec] = NO_ID;
+	}
+	for (i = 0; i < fsm->statecount; i++) {
+		ec = env->state_ecs[i];
+		env->jump[i] = env->ecs[ec];
+		env->ecs[ec] = i;
+		counts[ec]++;
+	}
+
+	/* An empty not-final EC stays first; see build_minimised_mapping. */
+	lo = (env->ecs[0] == NO_ID) ? 1 : 0;
+	hi = env->ec_count - 1;
+
+	while (lo < hi) {
+		if (counts[lo] >= 2) {
+			lo++;
+		} else if (counts[hi] < 2) {
+			hi--;
+		} else {
+			swap_ecs(env, counts, lo, hi);
+		}
+	}
+
+	env->done_ec_offset = env->ec_count;
+	for (ec = (env->ecs[0] == NO_ID) ? 1 : 0; ec < env->ec_count; ec++) {
+		if (counts[ec] < 2) {
+			env->done_ec_offset = ec;
+			break;
+		}
+	}
+
+	/* populate_initial_ecs sets no SMALL_EC_FLAG, so relinking the
+	 * lists above loses none. Flag the small ECs here, as
+	 * update_ec_links would had they been split by partitioning. */
+	if (env->dfa_label_count >= DFA_LABELS_THRESHOLD) {
+		for (ec = 0; ec < env->done_ec_offset; ec++) {
+			if (env->ecs[ec] != NO_ID && counts[ec] <= SMALL_EC_THRESHOLD) {
+				env->ecs[ec] = SET_SMALL_EC_FLAG(env->ecs[ec]);
+			}
+		}
+	}
+
+	res = 1;
+
+cleanup:
+	f_free(fsm->opt->alloc, ends);
+	f_free(fsm->opt->alloc, counts);
+	return res;
+}
+
 #if EXPENSIVE_INTEGRITY_CHECKS
 static void
 check_done_ec_offset(const struct min_env *env)
@@ -777,12 +1068,24 @@ init_label_iterator(const struct min_env *env,
 		while (cur != NO_ID) {
 			struct fsm_edge e;
 			struct edge_iter ei;
-			for (edge_set_reset(env->fsm->states[cur].edges, &ei);
+			struct bm bm;
+			for (edge_set_reset_explicit(env->fsm->states[cur].edges, &ei);
 			     edge_set_next(&ei, &e); ) {
 				const unsigned char label = e.symbol;
 				label_set[label/32] |=
 				    ((uint32_t)1 << (label & 31));
 			}
+
+			/* only the representative labels for a default edge */
+			if (edge_set_default(env->fsm->states[cur].edges, &bm, NULL)) {
+				for (i = 0; i < 256; i++) {
+					if (bm_get(&bm, i)
+					    && (env->dfa_label_set[i/64] & (1UL << (i & 63)))) {
+						label_set[i/32] |=
+						    ((uint32_t)1 << (i & 31));
+					}
+				}
+			}
 			cur = env->jump[cur];
 		}
 
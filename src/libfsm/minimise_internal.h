@@ -65,6 +65,9 @@ struct min_env {
 	/* The set of labels that appear through the entire DFA. */
 	const unsigned char *dfa_labels;
 	size_t dfa_label_count;
+
+	/* The same labels, as a bit set. */
+	uint64_t dfa_label_set[FSM_SIGMA_COUNT/64];
 };
 
 /* An iterator, used to try partitioning on either:
@@ -110,7 +113,7 @@ collect_labels(const struct fsm *fsm,
 static int
 build_minimised_mapping(const struct fsm *fsm,
     const unsigned char *dfa_labels, size_t dfa_label_count,
-    const unsigned *shortest_end_distance,
+    const unsigned *shortest_end_distance, int by_opaque,
     fsm_state_t *mapping, size_t *minimized_state_count);
 
 static void
@@ -120,6 +123,9 @@ static int
 populate_initial_ecs(struct min_env *env, const struct fsm *fsm,
 	const unsigned *shortest_end_distance);
 
+static int
+partition_by_opaque(struct min_env *env, const struct fsm *fsm);
+
 #if EXPENSIVE_INTEGRITY_CHECKS
 static void
 check_done_ec_offset(const struct min_env *env);
@@ -5,11 +5,16 @@
  */
 
 #include <assert.h>
+#include <limits.h>
 #include <stddef.h>
+#include <stdio.h>
 
 #include <fsm/fsm.h>
 
+#include <print/esc.h>
+
 #include <adt/set.h>
+#include <adt/bitmap.h>
 #include <adt/stateset.h>
 #include <adt/edgeset.h>
 
@@ -20,6 +25,10 @@ fsm_findmode(const struct fsm *fsm, fsm_state_t state, unsigned int *freq)
 {
 	struct edge_iter it;
 	struct fsm_edge e;
+	struct bm dmask;
+	fsm_state_t dstate;
+	unsigned int dfreq;
+	int seen;
 
 	struct {
 		fsm_state_t state;
@@ -31,7 +40,17 @@ fsm_findmode(const struct fsm *fsm, fsm_state_t state, unsigned int *freq)
 	assert(fsm != NULL);
 	assert(state < fsm->statecount);
 
-	for (edge_set_reset(fsm->states[state].edges, &it); edge_set_next(&it, &e); ) {
+	/*
+	 * The default edge counts once for each of its symbols,
+	 * in addition to any explicit edges to the same state.
+	 */
+	dfreq = 0;
+	seen  = 0;
+	if (edge_set_default(fsm->states[state].edges, &dmask, &dstate)) {
+		dfreq = bm_count(&dmask);
+	}
+
+	for (edge_set_reset_explicit(fsm->states[state].edges, &it); edge_set_next(&it, &e); ) {
 		struct edge_iter kt = it;
 		struct fsm_edge c;
 		unsigned int curr;
@@ -47,12 +66,26 @@ fsm_findmode(const struct fsm *fsm, fsm_state_t state, unsigned int *freq)
 			}
 		}
 
+		if (dfreq > 0 && e.state == dstate) {
+			if (seen) {
+				continue;
+			}
+
+			curr += dfreq;
+			seen = 1;
+		}
+
 		if (curr > mode.freq) {
 			mode.freq  = curr;
 			mode.state = e.state;
 		}
 	}
 
+	if (dfreq > 0 && !seen && dfreq > mode.freq) {
+		mode.freq  = dfreq;
+		mode.state = dstate;
+	}
+
 	if (freq != NULL) {
 		*freq = mode.freq;
 	}
@@ -61,4 +94,3 @@ fsm_findmode(const struct fsm *fsm, fsm_state_t state, unsigned int *freq)
 
 	return mode.state;
 }
-
@@ -0,0 +1,1117 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/pred.h>
+#include <fsm/walk.h>
+#include <fsm/parallel.h>
+
+#include <adt/set.h>
+#include <adt/edgeset.h>
+
+#include "internal.h"
+
+/* below this many bytes per thread, splitting costs more than it saves */
+#define PARALLEL_MIN_CHUNK (256 * 1024)
+
+/* bytes between checking for absorbing states, and merging runs */
+#define PARALLEL_BLOCK 64
+
+/* buffers advanced in turn by fsm_parallel_match_batch() */
+#define PARALLEL_LANES 16
+
+/* lanes per vector for fsm_parallel_multi_match() */
+#define PARALLEL_GROUP 8
+
+#if defined(__GNUC__)
+#define PREFETCH(p) __builtin_prefetch((p))
+#else
+#define PREFETCH(p) ((void) (p))
+#endif
+
+/*
+ * AVX2 code is compiled regardless of the flags given for the rest of
+ * this file, and used only when the CPU supports it.
+ * Define FSM_PARALLEL_NO_SIMD to use the portable code regardless.
+ */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && !defined(FSM_PARALLEL_NO_SIMD)
+#define PARALLEL_AVX2 1
+#include <immintrin.h>
+#else
+#define PARALLEL_AVX2 0
+#endif
+
+#define PARALLEL_END       0x01
+#define PARALLEL_ABSORBING 0x02
+
+#define NONE ((fsm_state_t) -1)
+
+struct fsm_parallel {
+	unsigned nclasses;
+	unsigned char cls[FSM_SIGMA_COUNT];
+
+	/* states are numbered as for the DFA, plus a dead state n */
+	fsm_state_t n;
+	fsm_state_t start;
+
+	fsm_state_t *next;    /* rows * nclasses */
+	unsigned char *flags; /* rows */
+
+	/*
+	 * For fsm_parallel_compile_lines(), rows from hot on are absorbing,
+	 * and from lines on are copies of the start state entered by a newline
+	 * from each accepting state, accept[] giving that state. orig[] gives
+	 * the DFA's state for rows before lines. NONE otherwise.
+	 */
+	fsm_state_t hot;
+	fsm_state_t lines;
+	fsm_state_t *accept;
+	fsm_state_t *orig;
+};
+
+/*
+ * DFAs combined to run in lanes. Each lane's state is the offset of its
+ * row in next[], and each entry there is the offset of the row it leads
+ * to, so a transition is one lookup of next[s + cls[c][lane]]. Lanes past
+ * the number of DFAs stay in a dead row at offset 0.
+ */
+struct fsm_parallel_multi {
+	unsigned n;
+	unsigned lanes; /* n rounded up to PARALLEL_GROUP */
+
+	int32_t cls[FSM_SIGMA_COUNT][FSM_PARALLEL_MULTI_MAX];
+	int32_t start[FSM_PARALLEL_MULTI_MAX];
+
+	/* to find the state number for a row */
+	int32_t base[FSM_PARALLEL_MULTI_MAX];
+	unsigned nclasses[FSM_PARALLEL_MULTI_MAX];
+
+	int32_t *next;
+	unsigned char *flags; /* by row offset */
+};
+
+/*
+ * Entering a chunk in state i, it ends in state cur[lane[first[i]]].
+ * There's a lane per state reached by the first byte, and cur[] holds
+ * a run per distinct state, as lanes merge when their states converge.
+ */
+struct chunk {
+	const struct fsm_parallel *p;
+	const unsigned char *b, *e;
+
+	fsm_state_t *first; /* n + 1 */
+	fsm_state_t *lane;  /* per lane */
+	fsm_state_t *cur;   /* per run */
+	fsm_state_t *slot;  /* per state, NONE when unused */
+	fsm_state_t *remap; /* per run */
+
+	size_t nlanes;
+	int threaded;
+	pthread_t tid;
+};
+
+/* each state's transitions, with the dead state for none */
+static void
+state_row(const struct fsm *fsm, fsm_state_t s, fsm_state_t row[FSM_SIGMA_COUNT])
+{
+	struct edge_iter it;
+	struct fsm_edge e;
+	unsigned c;
+
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		row[c] = fsm->statecount;
+	}
+
+	for (edge_set_reset(fsm->states[s].edges, &it); edge_set_next(&it, &e); ) {
+		row[e.symbol] = e.state;
+	}
+}
+
+/*
+ * Refine the byte classes so that no two bytes in the same class
+ * lead to different states from this row.
+ */
+static void
+refine(struct fsm_parallel *p, const fsm_state_t row[FSM_SIGMA_COUNT])
+{
+	/* a chain per existing class of (dest, new class) pairs */
+	int head[FSM_SIGMA_COUNT];
+	int chain[FSM_SIGMA_COUNT];
+	fsm_state_t dest[FSM_SIGMA_COUNT];
+	unsigned char newcls[FSM_SIGMA_COUNT];
+	unsigned c, used;
+	int e;
+
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		head[c] = -1;
+	}
+
+	used = 0;
+
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		const unsigned k = p->cls[c];
+
+		for (e = head[k]; e != -1; e = chain[e]) {
+			if (dest[e] == row[c]) {
+				break;
+			}
+		}
+
+		if (e == -1) {
+			e = used++;
+			dest[e]  = row[c];
+			chain[e] = head[k];
+
+			/* the first split of a class keeps its number */
+			newcls[e] = (head[k] == -1) ? k : p->nclasses++;
+			head[k]  = e;
+		}
+
+		p->cls[c] = newcls[e];
+	}
+}
+
+/* the table's DFA and classes, with no rows yet */
+static struct fsm_parallel *
+alloc_table(const struct fsm *fsm, int lines)
+{
+	fsm_state_t row[FSM_SIGMA_COUNT];
+	struct fsm_parallel *p;
+	fsm_state_t s;
+
+	assert(fsm != NULL);
+
+	p = malloc(sizeof *p);
+	if (p == NULL) {
+		return NULL;
+	}
+
+	if (!fsm_all(fsm, fsm_isdfa) || !fsm_getstart(fsm, &p->start)) {
+		free(p);
+		errno = EINVAL;
+		return NULL;
+	}
+
+	p->n = fsm->statecount;
+
+	/* with room for a copy of the start state per state, for lines */
+	if (p->n >= NONE / 2 - 1) {
+		free(p);
+		errno = ERANGE;
+		return NULL;
+	}
+
+	memset(p->cls, 0, sizeof p->cls);
+	p->nclasses = 1;
+
+	/* the newline is always a class of its own, to go to the start state */
+	if (lines) {
+		p->cls[(unsigned char) '\n'] = p->nclasses++;
+	}
+
+	for (s = 0; s < p->n; s++) {
+		state_row(fsm, s, row);
+		refine(p, row);
+	}
+
+	p->next   = NULL;
+	p->flags  = NULL;
+	p->hot    = NONE;
+	p->lines  = NONE;
+	p->accept = NULL;
+	p->orig   = NULL;
+
+	return p;
+}
+
+static int
+alloc_rows(struct fsm_parallel *p, fsm_state_t rows)
+{
+	if (rows > SIZE_MAX / sizeof *p->next / p->nclasses) {
+		errno = ENOMEM;
+		return 0;
+	}
+
+	p->next  = malloc((size_t) rows * p->nclasses * sizeof *p->next);
+	p->flags = malloc((size_t) rows * sizeof *p->flags);
+	if (p->next == NULL || p->flags == NULL) {
+		return 0;
+	}
+
+	return 1;
+}
+
+struct fsm_parallel *
+fsm_parallel_compile(const struct fsm *fsm)
+{
+	fsm_state_t row[FSM_SIGMA_COUNT];
+	struct fsm_parallel *p;
+	fsm_state_t s;
+	unsigned c;
+
+	p = alloc_table(fsm, 0);
+	if (p == NULL) {
+		return NULL;
+	}
+
+	if (!alloc_rows(p, p->n + 1)) {
+		fsm_parallel_free(p);
+		return NULL;
+	}
+
+	for (s = 0; s < p->n; s++) {
+		state_row(fsm, s, row);
+
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			p->next[(size_t) s * p->nclasses + p->cls[c]] = row[c];
+		}
+
+		p->flags[s] = 0;
+
+		if (fsm_isend(fsm, s)) {
+			p->flags[s] |= PARALLEL_END;
+		}
+
+		if (fsm_isabsorbing(fsm, s)) {
+			p->flags[s] |= PARALLEL_ABSORBING;
+		}
+	}
+
+	for (c = 0; c < p->nclasses; c++) {
+		p->next[(size_t) p->n * p->nclasses + c] = p->n;
+	}
+
+	p->flags[p->n] = PARALLEL_ABSORBING;
+
+	return p;
+}
+
+/*
+ * For lines, a newline leaves every state, and so absorbing means only
+ * until the end of the line. A newline from an accepting state leads to
+ * that state's own copy of the start state, to record that its line was
+ * accepted.
+ *
+ * Rows are renumbered so that the absorbing states and the copies come
+ * last, from p->hot. Matching then needs only one comparison per byte to
+ * find either. The copies are numbered from p->lines.
+ */
+struct fsm_parallel *
+fsm_parallel_compile_lines(const struct fsm *fsm)
+{
+	fsm_state_t row[FSM_SIGMA_COUNT];
+	struct fsm_parallel *p;
+	fsm_state_t *idx;
+	fsm_state_t s, i, j, e, rows;
+	unsigned char *absorbing;
+	unsigned c;
+
+	p = alloc_table(fsm, 1);
+	if (p == NULL) {
+		return NULL;
+	}
+
+	/* the dead state n is absorbing */
+	idx       = malloc((size_t) (p->n + 1) * sizeof *idx);
+	absorbing = malloc((size_t) (p->n + 1) * sizeof *absorbing);
+	if (idx == NULL || absorbing == NULL) {
+		goto error;
+	}
+
+	rows = p->n + 1;
+
+	for (s = 0; s < p->n; s++) {
+		state_row(fsm, s, row);
+
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			if (c != '\n' && row[c] != s) {
+				break;
+			}
+		}
+
+		absorbing[s] = c == FSM_SIGMA_COUNT;
+
+		if (fsm_isend(fsm, s)) {
+			rows++;
+		}
+	}
+
+	absorbing[p->n] = 1;
+
+	i = 0;
+	for (s = 0; s <= p->n; s++) {
+		if (!absorbing[s]) {
+			idx[s] = i++;
+		}
+	}
+
+	p->hot = i;
+
+	for (s = 0; s <= p->n; s++) {
+		if (absorbing[s]) {
+			idx[s] = i++;
+		}
+	}
+
+	p->lines = i;
+
+	if (!alloc_rows(p, rows)) {
+		goto error;
+	}
+
+	p->accept = malloc((size_t) (rows - p->lines + 1) * sizeof *p->accept);
+	p->orig   = malloc((size_t) p->lines * sizeof *p->orig);
+	if (p->accept == NULL || p->orig == NULL) {
+		goto error;
+	}
+
+	e = p->lines;
+
+	for (s = 0; s <= p->n; s++) {
+		if (s < p->n) {
+			state_row(fsm, s, row);
+		} else {
+			for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+				row[c] = p->n;
+			}
+		}
+
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			row[c] = idx[row[c]];
+		}
+
+		i = idx[s];
+
+		p->orig[i]  = s;
+		p->flags[i] = absorbing[s] ? PARALLEL_ABSORBING : 0;
+
+		if (s < p->n && fsm_isend(fsm, s)) {
+			p->flags[i] |= PARALLEL_END;
+			p->accept[e - p->lines] = s;
+			row['\n'] = e++;
+		} else {
+			row['\n'] = idx[p->start];
+		}
+
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			p->next[(size_t) i * p->nclasses + p->cls[c]] = row[c];
+		}
+	}
+
+	assert(e == rows);
+
+	p->start = idx[p->start];
+
+	for (j = p->lines; j < rows; j++) {
+		memcpy(&p->next[(size_t) j * p->nclasses],
+			&p->next[(size_t) p->start * p->nclasses],
+			p->nclasses * sizeof *p->next);
+
+		p->flags[j] = p->flags[p->start] & ~PARALLEL_END;
+	}
+
+	free(idx);
+	free(absorbing);
+
+	return p;
+
+error:
+
+	free(idx);
+	free(absorbing);
+	fsm_parallel_free(p);
+
+	return NULL;
+}
+
+void
+fsm_parallel_free(struct fsm_parallel *p)
+{
+	if (p == NULL) {
+		return;
+	}
+
+	free(p->next);
+	free(p->flags);
+	free(p->accept);
+	free(p->orig);
+	free(p);
+}
+
+/* a single run, which may stop early at an absorbing state */
+static fsm_state_t
+run(const struct fsm_parallel *p, fsm_state_t s,
+	const unsigned char *b, const unsigned char *e)
+{
+	const fsm_state_t *next;
+	const unsigned char *cls;
+	const unsigned char *be;
+	size_t nclasses;
+
+	next     = p->next;
+	cls      = p->cls;
+	nclasses = p->nclasses;
+
+	while (b != e) {
+		be = (size_t) (e - b) > PARALLEL_BLOCK ? b + PARALLEL_BLOCK : e;
+
+		for ( ; b != be; b++) {
+			s = next[s * nclasses + cls[*b]];
+		}
+
+		if (p->flags[s] & PARALLEL_ABSORBING) {
+			break;
+		}
+	}
+
+	return s;
+}
+
+/* merge runs which have converged on the same state */
+static size_t
+merge(struct chunk *k, size_t m)
+{
+	size_t i, j, n;
+
+	n = 0;
+
+	for (j = 0; j < m; j++) {
+		const fsm_state_t s = k->cur[j];
+
+		if (k->slot[s] == NONE) {
+			k->slot[s] = n;
+			k->cur[n]  = s;
+			n++;
+		}
+
+		k->remap[j] = k->slot[s];
+	}
+
+	for (j = 0; j < n; j++) {
+		k->slot[k->cur[j]] = NONE;
+	}
+
+	if (n < m) {
+		for (i = 0; i < k->nlanes; i++) {
+			k->lane[i] = k->remap[k->lane[i]];
+		}
+	}
+
+	return n;
+}
+
+static void *
+run_chunk(void *opaque)
+{
+	struct chunk *k = opaque;
+	const struct fsm_parallel *p;
+	const unsigned char *b, *be;
+	size_t nclasses;
+	fsm_state_t i;
+	size_t j, m;
+
+	assert(k != NULL);
+	assert(k->b < k->e);
+
+	p = k->p;
+	b = k->b;
+	nclasses = p->nclasses;
+
+	/* the first byte takes every state to one of its lanes */
+	m = 0;
+
+	for (i = 0; i <= p->n; i++) {
+		const fsm_state_t s = p->next[i * nclasses + p->cls[*b]];
+
+		if (k->slot[s] == NONE) {
+			k->slot[s] = m;
+			k->cur[m]  = s;
+			m++;
+		}
+
+		k->first[i] = k->slot[s];
+	}
+
+	for (j = 0; j < m; j++) {
+		k->slot[k->cur[j]] = NONE;
+		k->lane[j] = j;
+	}
+
+	k->nlanes = m;
+
+	b++;
+
+	while (b != k->e && m > 1) {
+		be = (size_t) (k->e - b) > PARALLEL_BLOCK ? b + PARALLEL_BLOCK : k->e;
+
+		for (j = 0; j < m; j++) {
+			const unsigned char *q;
+			fsm_state_t s;
+
+			s = k->cur[j];
+
+			for (q = b; q != be; q++) {
+				s = p->next[s * nclasses + p->cls[*q]];
+			}
+
+			k->cur[j] = s;
+		}
+
+		b = be;
+
+		m = merge(k, m);
+	}
+
+	if (m == 1) {
+		k->cur[0] = run(p, k->cur[0], b, k->e);
+	}
+
+	return NULL;
+}
+
+static unsigned
+online(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	long n;
+
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n > 0) {
+		return n;
+	}
+#endif
+
+	return 1;
+}
+
+int
+fsm_parallel_match(const struct fsm_parallel *p, const char *buf, size_t n,
+	unsigned nthreads, fsm_state_t *end)
+{
+	const unsigned char *b;
+	struct chunk *k;
+	fsm_state_t *a;
+	size_t i, nchunks, len, w;
+	fsm_state_t s;
+
+	assert(p != NULL);
+	assert(p->lines == NONE);
+	assert(buf != NULL || n == 0);
+	assert(end != NULL);
+
+	b = (const unsigned char *) buf;
+
+	if (nthreads == 0) {
+		nthreads = online();
+	}
+
+	nchunks = n / PARALLEL_MIN_CHUNK;
+	if (nchunks > nthreads) {
+		nchunks = nthreads;
+	}
+
+	if (nchunks <= 1) {
+		s = run(p, p->start, b, b + n);
+		goto done;
+	}
+
+	/* first, lane, cur, slot and remap each have at most n + 1 entries */
+	w = (size_t) p->n + 1;
+
+	if (nchunks - 1 > SIZE_MAX / sizeof *a / 5 / w) {
+		errno = ENOMEM;
+		return -1;
+	}
+
+	k = malloc(nchunks * sizeof *k);
+	a = malloc((nchunks - 1) * 5 * w * sizeof *a);
+	if (k == NULL || a == NULL) {
+		free(k);
+		free(a);
+		return -1;
+	}
+
+	len = n / nchunks;
+
+	for (i = 0; i < nchunks; i++) {
+		k[i].p = p;
+		k[i].b = b + i * len;
+		k[i].e = (i + 1 == nchunks) ? b + n : k[i].b + len;
+		k[i].threaded = 0;
+
+		if (i == 0) {
+			continue;
+		}
+
+		k[i].first = a + (i - 1) * 5 * w;
+		k[i].lane  = k[i].first + w;
+		k[i].cur   = k[i].lane  + w;
+		k[i].slot  = k[i].cur   + w;
+		k[i].remap = k[i].slot  + w;
+
+		memset(k[i].slot, 0xff, w * sizeof *k[i].slot);
+
+		/* on failure, this chunk is run after the first, below */
+		k[i].threaded = 0 == pthread_create(&k[i].tid, NULL, run_chunk, &k[i]);
+	}
+
+	s = run(p, p->start, k[0].b, k[0].e);
+
+	for (i = 1; i < nchunks; i++) {
+		if (k[i].threaded) {
+			(void) pthread_join(k[i].tid, NULL);
+		} else {
+			(void) run_chunk(&k[i]);
+		}
+
+		s = k[i].cur[k[i].lane[k[i].first[s]]];
+	}
+
+	free(k);
+	free(a);
+
+done:
+
+	if (~p->flags[s] & PARALLEL_END) {
+		return 0;
+	}
+
+	*end = s;
+	return 1;
+}
+
+size_t
+fsm_parallel_match_batch(const struct fsm_parallel *p,
+	const struct fsm_parallel_buf *a, size_t n,
+	unsigned char *matched, fsm_state_t *end)
+{
+	const unsigned char *b[PARALLEL_LANES], *e[PARALLEL_LANES];
+	fsm_state_t s[PARALLEL_LANES];
+	size_t id[PARALLEL_LANES];
+	const fsm_state_t *next;
+	const unsigned char *cls;
+	size_t nclasses;
+	size_t i, count;
+	unsigned j, lanes;
+
+	assert(p != NULL);
+	assert(p->lines == NONE);
+	assert(a != NULL || n == 0);
+	assert(matched != NULL || n == 0);
+
+	next     = p->next;
+	cls      = p->cls;
+	nclasses = p->nclasses;
+
+	count = 0;
+	lanes = 0;
+
+	for (i = 0; i < n && lanes < PARALLEL_LANES; i++, lanes++) {
+		b[lanes]  = (const unsigned char *) a[i].buf;
+		e[lanes]  = b[lanes] + a[i].n;
+		s[lanes]  = p->start;
+		id[lanes] = i;
+	}
+
+	/*
+	 * Each pass advances every lane by a byte. A lane which is done
+	 * takes the next buffer, or when there are none left, the last lane
+	 * takes its place. Its first transition is prefetched either way.
+	 */
+	while (lanes > 0) {
+		for (j = 0; j < lanes; ) {
+			if (b[j] == e[j] || (p->flags[s[j]] & PARALLEL_ABSORBING)) {
+				matched[id[j]] = !!(p->flags[s[j]] & PARALLEL_END);
+				if (matched[id[j]]) {
+					if (end != NULL) {
+						end[id[j]] = s[j];
+					}
+					count++;
+				}
+
+				if (i < n) {
+					b[j]  = (const unsigned char *) a[i].buf;
+					e[j]  = b[j] + a[i].n;
+					s[j]  = p->start;
+					id[j] = i;
+					i++;
+				} else {
+					lanes--;
+					b[j]  = b[lanes];
+					e[j]  = e[lanes];
+					s[j]  = s[lanes];
+					id[j] = id[lanes];
+				}
+
+				if (j < lanes && b[j] != e[j]) {
+					PREFETCH(&next[s[j] * nclasses + cls[*b[j]]]);
+				}
+
+				/* the buffer taken may be done already */
+				continue;
+			}
+
+			s[j] = next[s[j] * nclasses + cls[*b[j]]];
+			b[j]++;
+
+			if (b[j] != e[j]) {
+				PREFETCH(&next[s[j] * nclasses + cls[*b[j]]]);
+			}
+
+			j++;
+		}
+	}
+
+	return count;
+}
+
+struct fsm_parallel_multi *
+fsm_parallel_multi_compile(const struct fsm_parallel *const p[], size_t n)
+{
+	struct fsm_parallel_multi *m;
+	size_t i, len, off;
+	fsm_state_t st;
+	unsigned c;
+
+	assert(p != NULL || n == 0);
+
+	if (n == 0 || n > FSM_PARALLEL_MULTI_MAX) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	/* offsets are gathered as signed 32-bit indices */
+	len = 1;
+	for (i = 0; i < n; i++) {
+		const size_t w = (size_t) (p[i]->n + 1) * p[i]->nclasses;
+
+		assert(p[i]->lines == NONE);
+
+		if (w > INT32_MAX - len) {
+			errno = ERANGE;
+			return NULL;
+		}
+
+		len += w;
+	}
+
+	m = malloc(sizeof *m);
+	if (m == NULL) {
+		return NULL;
+	}
+
+	m->next  = malloc(len * sizeof *m->next);
+	m->flags = calloc(len, sizeof *m->flags);
+	if (m->next == NULL || m->flags == NULL) {
+		free(m->next);
+		free(m->flags);
+		free(m);
+		return NULL;
+	}
+
+	m->n     = n;
+	m->lanes = (n + PARALLEL_GROUP - 1) / PARALLEL_GROUP * PARALLEL_GROUP;
+
+	memset(m->cls,      0, sizeof m->cls);
+	memset(m->start,    0, sizeof m->start);
+	memset(m->base,     0, sizeof m->base);
+	memset(m->nclasses, 0, sizeof m->nclasses);
+
+	m->next[0]  = 0;
+	m->flags[0] = PARALLEL_ABSORBING;
+
+	off = 1;
+
+	for (i = 0; i < n; i++) {
+		const size_t nclasses = p[i]->nclasses;
+
+		m->base[i]     = off;
+		m->nclasses[i] = nclasses;
+		m->start[i]    = off + p[i]->start * nclasses;
+
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			m->cls[c][i] = p[i]->cls[c];
+		}
+
+		for (st = 0; st <= p[i]->n; st++) {
+			const size_t row = (size_t) st * nclasses;
+
+			for (c = 0; c < nclasses; c++) {
+				m->next[off + row + c] = off + p[i]->next[row + c] * nclasses;
+			}
+
+			m->flags[off + row] = p[i]->flags[st];
+		}
+
+		off += (size_t) (p[i]->n + 1) * nclasses;
+	}
+
+	assert(off == len);
+
+	return m;
+}
+
+void
+fsm_parallel_multi_free(struct fsm_parallel_multi *m)
+{
+	if (m == NULL) {
+		return;
+	}
+
+	free(m->next);
+	free(m->flags);
+	free(m);
+}
+
+static int
+multi_absorbed(const struct fsm_parallel_multi *m, const int32_t s[])
+{
+	unsigned l;
+
+	for (l = 0; l < m->lanes; l++) {
+		if (~m->flags[s[l]] & PARALLEL_ABSORBING) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+static void
+multi_run(const struct fsm_parallel_multi *m, int32_t s[],
+	const unsigned char *b, const unsigned char *e)
+{
+	const unsigned char *be;
+	unsigned l;
+
+	while (b != e) {
+		be = (size_t) (e - b) > PARALLEL_BLOCK ? b + PARALLEL_BLOCK : e;
+
+		for ( ; b != be; b++) {
+			const int32_t *cls = m->cls[*b];
+
+			/* lanes past n are dead */
+			for (l = 0; l < m->n; l++) {
+				s[l] = m->next[s[l] + cls[l]];
+			}
+		}
+
+		if (multi_absorbed(m, s)) {
+			break;
+		}
+	}
+}
+
+#if PARALLEL_AVX2
+
+/*
+ * Each gather waits on the one before for the same vector, so two
+ * vectors are run together to overlap them. For a single vector's worth
+ * of lanes, the portable code is faster.
+ */
+__attribute__((target("avx2")))
+static void
+multi_run_avx2(const struct fsm_parallel_multi *m, int32_t s[],
+	const unsigned char *b, const unsigned char *e)
+{
+	const int *next = (const int *) m->next;
+	const unsigned char *be;
+	__m256i v0, v1;
+
+	assert(m->lanes == 2 * PARALLEL_GROUP);
+
+	v0 = _mm256_loadu_si256((const __m256i *) &s[0]);
+	v1 = _mm256_loadu_si256((const __m256i *) &s[PARALLEL_GROUP]);
+
+	while (b != e) {
+		be = (size_t) (e - b) > PARALLEL_BLOCK ? b + PARALLEL_BLOCK : e;
+
+		for ( ; b != be; b++) {
+			const __m256i *cls = (const __m256i *) m->cls[*b];
+
+			v0 = _mm256_i32gather_epi32(next, _mm256_add_epi32(v0, _mm256_loadu_si256(&cls[0])), 4);
+			v1 = _mm256_i32gather_epi32(next, _mm256_add_epi32(v1, _mm256_loadu_si256(&cls[1])), 4);
+		}
+
+		_mm256_storeu_si256((__m256i *) &s[0], v0);
+		_mm256_storeu_si256((__m256i *) &s[PARALLEL_GROUP], v1);
+
+		if (multi_absorbed(m, s)) {
+			break;
+		}
+	}
+}
+
+#endif
+
+size_t
+fsm_parallel_multi_match(const struct fsm_parallel_multi *m,
+	const char *buf, size_t n,
+	unsigned char *matched, fsm_state_t *end)
+{
+	int32_t s[FSM_PARALLEL_MULTI_MAX];
+	const unsigned char *b;
+	size_t count;
+	unsigned l;
+
+	assert(m != NULL);
+	assert(buf != NULL || n == 0);
+	assert(matched != NULL);
+
+	b = (const unsigned char *) buf;
+
+	memcpy(s, m->start, sizeof s);
+
+#if PARALLEL_AVX2
+	if (m->lanes == 2 * PARALLEL_GROUP && __builtin_cpu_supports("avx2")) {
+		multi_run_avx2(m, s, b, b + n);
+	} else
+#endif
+	multi_run(m, s, b, b + n);
+
+	count = 0;
+
+	for (l = 0; l < m->n; l++) {
+		matched[l] = !!(m->flags[s[l]] & PARALLEL_END);
+		if (matched[l]) {
+			if (end != NULL) {
+				end[l] = (s[l] - m->base[l]) / m->nclasses[l];
+			}
+			count++;
+		}
+	}
+
+	return count;
+}
+
+struct report {
+	const unsigned char *b;
+
+	/* line numbers are counted only as far as each line reported */
+	const unsigned char *counted;
+	size_t lineno;
+
+	void *opaque;
+	int (*callback)(const char *line, size_t len, size_t lineno, fsm_state_t end, void *opaque);
+};
+
+/* report the line ending at eol */
+static int
+report(struct report *r, const unsigned char *eol, fsm_state_t end)
+{
+	const unsigned char *sol, *nl;
+
+	for (sol = eol; sol != r->b && sol[-1] != '\n'; sol--)
+		;
+
+	while (nl = memchr(r->counted, '\n', sol - r->counted), nl != NULL) {
+		r->counted = nl + 1;
+		r->lineno++;
+	}
+
+	return r->callback((const char *) sol, eol - sol, r->lineno, end, r->opaque);
+}
+
+/* the next newline, or the end */
+static const unsigned char *
+skip(const unsigned char *q, const unsigned char *e)
+{
+	const unsigned char *nl;
+
+	nl = memchr(q, '\n', e - q);
+
+	return nl != NULL ? nl : e;
+}
+
+int
+fsm_parallel_match_lines(const struct fsm_parallel *p, const char *buf, size_t n,
+	void *opaque,
+	int (*callback)(const char *line, size_t len, size_t lineno, fsm_state_t end, void *opaque))
+{
+	const fsm_state_t *next;
+	const unsigned char *cls;
+	const unsigned char *b, *q, *e;
+	struct report r;
+	size_t nclasses;
+	fsm_state_t s, hot, lines;
+
+	assert(p != NULL);
+	assert(p->lines != NONE);
+	assert(buf != NULL || n == 0);
+	assert(callback != NULL);
+
+	next     = p->next;
+	cls      = p->cls;
+	nclasses = p->nclasses;
+	hot      = p->hot;
+	lines    = p->lines;
+
+	b = (const unsigned char *) buf;
+	e = b + n;
+
+	r.b        = b;
+	r.counted  = b;
+	r.lineno   = 0;
+	r.opaque   = opaque;
+	r.callback = callback;
+
+	s = p->start;
+	q = b;
+
+	/* nothing more in a line can change its outcome once absorbing */
+	if (p->flags[s] & PARALLEL_ABSORBING) {
+		q = skip(q, e);
+	}
+
+	while (q != e) {
+		s = next[s * nclasses + cls[*q]];
+
+		if (s < hot) {
+			q++;
+			continue;
+		}
+
+		/* *q is the newline ending an accepted line */
+		if (s >= lines) {
+			if (!report(&r, q, p->accept[s - lines])) {
+				return 0;
+			}
+		}
+
+		q++;
+
+		if (p->flags[s] & PARALLEL_ABSORBING) {
+			q = skip(q, e);
+		}
+	}
+
+	/* a copy of the start state is the start state, having skipped the line */
+	if (s >= lines) {
+		s = p->start;
+	}
+
+	/* a final line without a newline */
+	if (n > 0 && b[n - 1] != '\n' && (p->flags[s] & PARALLEL_END)) {
+		if (!report(&r, e, p->orig[s])) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
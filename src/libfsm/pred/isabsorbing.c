@@ -0,0 +1,48 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+
+#include <fsm/fsm.h>
+#include <fsm/pred.h>
+
+#include <adt/edgeset.h>
+
+#include "../internal.h"
+
+int
+fsm_isabsorbing(const struct fsm *fsm, fsm_state_t state)
+{
+	struct fsm_edge e;
+	struct edge_iter it;
+	fsm_state_t to;
+
+	assert(fsm != NULL);
+	assert(state < fsm->statecount);
+
+	if (fsm_hasepsilons(fsm, state)) {
+		return 0;
+	}
+
+	if (edge_set_default(fsm->states[state].edges, NULL, &to) && to != state) {
+		return 0;
+	}
+
+	for (edge_set_reset_explicit(fsm->states[state].edges, &it); edge_set_next(&it, &e); ) {
+		if (e.state != state) {
+			return 0;
+		}
+	}
+
+	/* no end state is reachable, whether or not there are edges */
+	if (!fsm->states[state].end) {
+		return 1;
+	}
+
+	/* every edge goes to this state, so there's one edge per symbol at most */
+	return edge_set_count(fsm->states[state].edges) == FSM_SIGMA_COUNT;
+}
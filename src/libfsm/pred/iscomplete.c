@@ -34,9 +34,11 @@ fsm_iscomplete(const struct fsm *fsm, fsm_state_t state)
 	/* epsilon transitions have no effect on completeness */
 	(void) fsm->states[state].epsilons;
 
-	bm_clear(&bm);
+	if (!edge_set_default(fsm->states[state].edges, &bm, NULL)) {
+		bm_clear(&bm);
+	}
 
-	for (edge_set_reset(fsm->states[state].edges, &it); edge_set_next(&it, &e); ) {
+	for (edge_set_reset_explicit(fsm->states[state].edges, &it); edge_set_next(&it, &e); ) {
 		assert(e.state < fsm->statecount);
 
 		bm_set(&bm, e.symbol);
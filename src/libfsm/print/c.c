@@ -14,6 +14,7 @@
 #include <print/esc.h>
 
 #include <adt/set.h>
+#include <adt/alloc.h>
 
 #include <fsm/fsm.h>
 #include <fsm/pred.h>
@@ -35,6 +36,37 @@ ir_indexof(const struct ir *ir, const struct ir_state *cs)
 	return cs - ir->states;
 }
 
+/*
+ * Absorbing states decide the outcome on entry, and so (outside of
+ * fragments) transitions to them end execution early. Those without
+ * edges are left alone; no transition from them already reaches leaf().
+ */
+static int
+ir_isearly(const struct ir_state *cs)
+{
+	assert(cs != NULL);
+
+	return cs->absorbing && cs->strategy != IR_NONE;
+}
+
+static unsigned
+ir_countearly(const struct ir *ir)
+{
+	unsigned n;
+	size_t i;
+
+	assert(ir != NULL);
+	assert(ir->states != NULL);
+
+	n = 0;
+
+	for (i = 0; i < ir->n; i++) {
+		n += ir_isearly(&ir->states[i]);
+	}
+
+	return n;
+}
+
 static int
 ir_hasend(const struct ir *ir)
 {
@@ -107,9 +139,35 @@ print_ranges(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	}
 }
 
+/*
+ * When states are split across several functions, part[] gives the
+ * function for each state, and a transition to a state in another
+ * function leaves this one. Otherwise part is NULL.
+ */
+static void
+print_to(FILE *f, const struct ir *ir, int early,
+	const unsigned *part, unsigned csi, unsigned to)
+{
+	assert(f != NULL);
+	assert(ir != NULL);
+
+	/* TODO: pad S%u out to maximum state width */
+	if (to != csi) {
+		fprintf(f, "state = S%u; ", to);
+	}
+
+	if (early && ir_isearly(&ir->states[to])) {
+		fprintf(f, "goto done;");
+	} else if (part != NULL && part[to] != part[csi]) {
+		fprintf(f, "goto handoff;");
+	} else {
+		fprintf(f, "break;");
+	}
+}
+
 static void
 print_groups(FILE *f, const struct ir *ir, const struct fsm_options *opt,
-	unsigned csi,
+	int early, const unsigned *part, unsigned csi,
 	const struct ir_group *groups, size_t n)
 {
 	size_t j;
@@ -124,11 +182,9 @@ print_groups(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 
 		print_ranges(f, ir, opt, groups[j].ranges, groups[j].n);
 
-		/* TODO: pad S%u out to maximum state width */
-		if (groups[j].to != csi) {
-			fprintf(f, " state = S%u;", groups[j].to);
-		}
-		fprintf(f, " break;\n");
+		fprintf(f, " ");
+		print_to(f, ir, early, part, csi, groups[j].to);
+		fprintf(f, "\n");
 
 		/* TODO: if greedy, and fsm_isend(fsm, state->edges[i].sl->state) then:
 			fprintf(f, "         return %s%s;\n", prefix.tok, state->edges[i].sl->state's token);
@@ -138,7 +194,7 @@ print_groups(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 
 static void
 print_singlecase(FILE *f, const struct ir *ir, const struct fsm_options *opt,
-	const char *cp,
+	const char *cp, int early, const unsigned *part,
 	struct ir_state *cs,
 	int (*leaf)(FILE *, const void *state_opaque, const void *leaf_opaque),
 	const void *leaf_opaque)
@@ -163,16 +219,14 @@ print_singlecase(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 
 	case IR_SAME:
 		fprintf(f, "\t\t\t");
-		if (cs->u.same.to != ir_indexof(ir, cs)) {
-			fprintf(f, "state = S%u; ", cs->u.same.to);
-		}
-		fprintf(f, "break;\n");
+		print_to(f, ir, early, part, ir_indexof(ir, cs), cs->u.same.to);
+		fprintf(f, "\n");
 		return;
 
 	case IR_COMPLETE:
 		fprintf(f, "\t\t\tswitch ((unsigned char) %s) {\n", cp);
 
-		print_groups(f, ir, opt, ir_indexof(ir, cs), cs->u.complete.groups, cs->u.complete.n);
+		print_groups(f, ir, opt, early, part, ir_indexof(ir, cs), cs->u.complete.groups, cs->u.complete.n);
 
 		fprintf(f, "\t\t\t}\n");
 		fprintf(f, "\t\t\tbreak;\n");
@@ -181,7 +235,7 @@ print_singlecase(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	case IR_PARTIAL:
 		fprintf(f, "\t\t\tswitch ((unsigned char) %s) {\n", cp);
 
-		print_groups(f, ir, opt, ir_indexof(ir, cs), cs->u.partial.groups, cs->u.partial.n);
+		print_groups(f, ir, opt, early, part, ir_indexof(ir, cs), cs->u.partial.groups, cs->u.partial.n);
 
 		fprintf(f, "\t\t\tdefault:  ");
 		leaf(f, cs->opaque, leaf_opaque);
@@ -194,13 +248,11 @@ print_singlecase(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	case IR_DOMINANT:
 		fprintf(f, "\t\t\tswitch ((unsigned char) %s) {\n", cp);
 
-		print_groups(f, ir, opt, ir_indexof(ir, cs), cs->u.dominant.groups, cs->u.dominant.n);
+		print_groups(f, ir, opt, early, part, ir_indexof(ir, cs), cs->u.dominant.groups, cs->u.dominant.n);
 
 		fprintf(f, "\t\t\tdefault: ");
-		if (cs->u.dominant.mode != ir_indexof(ir, cs)) {
-			fprintf(f, "state = S%u; ", cs->u.dominant.mode);
-		}
-		fprintf(f, "break;\n");
+		print_to(f, ir, early, part, ir_indexof(ir, cs), cs->u.dominant.mode);
+		fprintf(f, "\n");
 
 		fprintf(f, "\t\t\t}\n");
 		fprintf(f, "\t\t\tbreak;\n");
@@ -209,7 +261,7 @@ print_singlecase(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	case IR_ERROR:
 		fprintf(f, "\t\t\tswitch ((unsigned char) %s) {\n", cp);
 
-		print_groups(f, ir, opt, ir_indexof(ir, cs), cs->u.error.groups, cs->u.error.n);
+		print_groups(f, ir, opt, early, part, ir_indexof(ir, cs), cs->u.error.groups, cs->u.error.n);
 
 		print_ranges(f, ir, opt, cs->u.error.error.ranges, cs->u.error.error.n);
 		fprintf(f, " ");
@@ -217,10 +269,8 @@ print_singlecase(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 		fprintf(f, "\n");
 
 		fprintf(f, "\t\t\tdefault: ");
-		if (cs->u.error.mode != ir_indexof(ir, cs)) {
-			fprintf(f, "state = S%u; ", cs->u.error.mode);
-		}
-		fprintf(f, "break;\n");
+		print_to(f, ir, early, part, ir_indexof(ir, cs), cs->u.error.mode);
+		fprintf(f, "\n");
 
 		fprintf(f, "\t\t\t}\n");
 		fprintf(f, "\t\t\tbreak;\n");
@@ -295,122 +345,1404 @@ endstates(FILE *f, const struct fsm_options *opt, const struct ir *ir)
 	fprintf(f, "\t}\n");
 }
 
-int
-fsm_print_cfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
-	const char *cp,
-	int (*leaf)(FILE *, const void *state_opaque, const void *leaf_opaque),
-	const void *leaf_opaque)
+/*
+ * Tables for output by FSM_CTABLE. Bytes are partitioned into classes
+ * which no state distinguishes, and then transitions are indexed by
+ * state and class: a transition from state s on class k is next[base[s] + k]
+ * if check[base[s] + k] == s, and otherwise dflt[s]. Rows are overlapped
+ * (row displacement), so that next[] and check[] are much smaller than
+ * n * nclasses. The value n stands for no transition, which reaches leaf().
+ * If every state has a transition for every class, n never appears and
+ * there's no leaf() to reach, as for a switch statement of only cases.
+ */
+struct ctable {
+	unsigned nclasses;
+	unsigned char cls[FSM_SIGMA_COUNT];
+	int partial; /* some state has no transition for some class */
+
+	unsigned *dflt;  /* per state */
+	unsigned *base;  /* per state */
+
+	size_t len;
+	unsigned *next;
+	unsigned *check; /* n for unused entries */
+};
+
+/* the number of states below which switch statements are always used */
+#define CTABLE_MIN_STATES 512
+
+/* the number of early states tested by comparison, rather than a table */
+#define CTABLE_EARLY_CMP 4
+
+static void
+ctable_free(const struct fsm_options *opt, struct ctable *t)
 {
-	unsigned i;
+	f_free(opt->alloc, t->dflt);
+	f_free(opt->alloc, t->base);
+	f_free(opt->alloc, t->next);
+	f_free(opt->alloc, t->check);
+}
 
-	assert(f != NULL);
-	assert(ir != NULL);
-	assert(opt != NULL);
-	assert(cp != NULL);
+/* each state's transitions, with ir->n for none */
+static void
+ir_row(const struct ir *ir, const struct ir_state *cs, unsigned row[FSM_SIGMA_COUNT])
+{
+	const struct ir_group *groups;
+	size_t i, j, n;
+	unsigned c;
 
-	fprintf(f, "\t\tswitch (state) {\n");
-	for (i = 0; i < ir->n; i++) {
-		fprintf(f, "\t\tcase S%u:", i);
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		row[c] = ir->n;
+	}
 
-		if (opt->comments) {
-			if (ir->states[i].example != NULL) {
-				fprintf(f, " /* e.g. \"");
-				escputs(f, opt, c_escputc_str, ir->states[i].example);
-				fprintf(f, "\" */");
-			} else if (i == ir->start) {
-				fprintf(f, " /* start */");
-			}
+	switch (cs->strategy) {
+	case IR_NONE:
+		return;
+
+	case IR_SAME:
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			row[c] = cs->u.same.to;
 		}
-		fprintf(f, "\n");
+		return;
 
-		print_singlecase(f, ir, opt, cp, &ir->states[i], leaf, leaf_opaque);
+	case IR_TABLE:
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			row[c] = cs->u.table.to[c];
+		}
+		return;
 
-		fprintf(f, "\n");
+	case IR_COMPLETE:
+		groups = cs->u.complete.groups;
+		n = cs->u.complete.n;
+		break;
+
+	case IR_PARTIAL:
+		groups = cs->u.partial.groups;
+		n = cs->u.partial.n;
+		break;
+
+	case IR_DOMINANT:
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			row[c] = cs->u.dominant.mode;
+		}
+		groups = cs->u.dominant.groups;
+		n = cs->u.dominant.n;
+		break;
+
+	case IR_ERROR:
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			row[c] = cs->u.error.mode;
+		}
+		for (j = 0; j < cs->u.error.error.n; j++) {
+			for (c = cs->u.error.error.ranges[j].start; c <= cs->u.error.error.ranges[j].end; c++) {
+				row[c] = ir->n;
+			}
+		}
+		groups = cs->u.error.groups;
+		n = cs->u.error.n;
+		break;
+
+	default:
+		assert(!"unreached");
+		abort();
 	}
-	fprintf(f, "\t\tdefault:\n");
-	fprintf(f, "\t\t\t; /* unreached */\n");
-	fprintf(f, "\t\t}\n");
 
-	return 0;
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < groups[i].n; j++) {
+			for (c = groups[i].ranges[j].start; c <= groups[i].ranges[j].end; c++) {
+				row[c] = groups[i].to;
+			}
+		}
+	}
 }
 
+/*
+ * Refine the byte classes so that no two bytes in the same class
+ * lead to different states from this row.
+ */
 static void
-fsm_print_c_complete(FILE *f, const struct ir *ir, const struct fsm_options *opt)
+ctable_refine(struct ctable *t, const unsigned row[FSM_SIGMA_COUNT])
 {
-	const char *cp;
+	/* a chain per existing class of (dest, new class) pairs */
+	int head[FSM_SIGMA_COUNT];
+	int chain[FSM_SIGMA_COUNT];
+	unsigned dest[FSM_SIGMA_COUNT];
+	unsigned char newcls[FSM_SIGMA_COUNT];
+	unsigned c, used;
+	int e;
+
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		head[c] = -1;
+	}
 
-	assert(f != NULL);
-	assert(ir != NULL);
-	assert(opt != NULL);
+	used = 0;
 
-	if (opt->cp != NULL) {
-		cp = opt->cp;
-	} else {
-		switch (opt->io) {
-		case FSM_IO_GETC: cp = "c";  break;
-		case FSM_IO_STR:  cp = "*p"; break;
-		case FSM_IO_PAIR: cp = "*p"; break;
+	for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+		const unsigned k = t->cls[c];
+
+		for (e = head[k]; e != -1; e = chain[e]) {
+			if (dest[e] == row[c]) {
+				break;
+			}
+		}
+
+		if (e == -1) {
+			e = used++;
+			dest[e]  = row[c];
+			chain[e] = head[k];
+
+			/* the first split of a class keeps its number */
+			newcls[e] = (head[k] == -1) ? k : t->nclasses++;
+			head[k]  = e;
 		}
+
+		t->cls[c] = newcls[e];
 	}
+}
 
-	/* enum of states */
-	print_stateenum(f, ir->n);
-	fprintf(f, "\n");
+static int
+cmp_unsigned(const void *a, const void *b)
+{
+	const unsigned *ua = a, *ub = b;
 
-	/* start state */
-	fprintf(f, "\tstate = S%u;\n", ir->start);
-	fprintf(f, "\n");
+	return (*ua > *ub) - (*ua < *ub);
+}
 
-	switch (opt->io) {
-	case FSM_IO_GETC:
-		fprintf(f, "\twhile (c = fsm_getc(opaque), c != EOF) {\n");
-		break;
+/* the most common destination, if that saves anything */
+static unsigned
+ctable_default(const struct ir *ir, const unsigned *rowk, unsigned nclasses)
+{
+	unsigned tmp[FSM_SIGMA_COUNT];
+	unsigned i, j, best, bestn;
 
-	case FSM_IO_STR:
-		fprintf(f, "\tfor (p = s; *p != '\\0'; p++) {\n");
-		break;
+	memcpy(tmp, rowk, nclasses * sizeof *tmp);
+	qsort(tmp, nclasses, sizeof *tmp, cmp_unsigned);
 
-	case FSM_IO_PAIR:
-		fprintf(f, "\tfor (p = b; p != e; p++) {\n");
-		break;
+	best  = ir->n;
+	bestn = 1;
+
+	for (i = 0; i < nclasses; i = j) {
+		for (j = i + 1; j < nclasses && tmp[j] == tmp[i]; j++)
+			;
+
+		if (j - i > bestn || (j - i == bestn && tmp[i] == ir->n)) {
+			best  = tmp[i];
+			bestn = j - i;
+		}
 	}
 
-	(void) fsm_print_cfrag(f, ir, opt, cp,
-		opt->leaf != NULL ? opt->leaf : leaf, opt->leaf_opaque);
+	return best;
+}
 
-	fprintf(f, "\t}\n");
-	fprintf(f, "\n");
+static int
+ctable_grow(const struct fsm_options *opt, struct ctable *t, const struct ir *ir, size_t len)
+{
+	unsigned *next, *check;
+	size_t i, newlen;
 
-	/* end states */
-	endstates(f, opt, ir);
+	if (len <= t->len) {
+		return 1;
+	}
+
+	newlen = (t->len == 0) ? FSM_SIGMA_COUNT : t->len;
+	while (newlen < len) {
+		newlen *= 2;
+	}
+
+	next = f_realloc(opt->alloc, t->next, newlen * sizeof *next);
+	if (next == NULL) {
+		return 0;
+	}
+	t->next = next;
+
+	check = f_realloc(opt->alloc, t->check, newlen * sizeof *check);
+	if (check == NULL) {
+		return 0;
+	}
+	t->check = check;
+
+	for (i = t->len; i < newlen; i++) {
+		t->next[i]  = ir->n;
+		t->check[i] = ir->n;
+	}
+
+	t->len = newlen;
+
+	return 1;
 }
 
-void
-fsm_print_c(FILE *f, const struct fsm *fsm)
+struct ctable_row {
+	unsigned state;
+	size_t off; /* into the entries for all rows */
+	size_t n;
+};
+
+static int
+cmp_rowsize(const void *a, const void *b)
 {
-	struct ir *ir;
-	const char *prefix;
+	const struct ctable_row *ra = a, *rb = b;
 
-	assert(f != NULL);
-	assert(fsm != NULL);
-	assert(fsm->opt != NULL);
+	if (ra->n != rb->n) {
+		return (ra->n < rb->n) ? +1 : -1;
+	}
 
-	ir = make_ir(fsm);
-	if (ir == NULL) {
-		return;
+	return (ra->state > rb->state) - (ra->state < rb->state);
+}
+
+static int
+ctable_build(const struct ir *ir, const struct fsm_options *opt, struct ctable *t)
+{
+	static const struct ctable zero;
+	struct ctable_row *rows;
+	unsigned *ek, *ed; /* entries: class and destination */
+	unsigned row[FSM_SIGMA_COUNT];
+	unsigned rowk[FSM_SIGMA_COUNT];
+	unsigned rep[FSM_SIGMA_COUNT];
+	size_t i, j, ne, nemax, lowest, maxbase, prevb;
+	unsigned c, k;
+
+	*t = zero;
+
+	t->nclasses = 1;
+
+	for (i = 0; i < ir->n; i++) {
+		ir_row(ir, &ir->states[i], row);
+		ctable_refine(t, row);
 	}
 
-	/* henceforth, no function should be passed struct fsm *, only the ir and options */
+	/* renumber classes by their first byte, for legibility */
+	{
+		int renum[FSM_SIGMA_COUNT];
+		unsigned seen;
 
-	if (fsm->opt->prefix != NULL) {
-		prefix = fsm->opt->prefix;
-	} else {
-		prefix = "fsm_";
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			renum[c] = -1;
+		}
+
+		seen = 0;
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			if (renum[t->cls[c]] == -1) {
+				rep[seen] = c;
+				renum[t->cls[c]] = seen++;
+			}
+			t->cls[c] = renum[t->cls[c]];
+		}
+
+		assert(seen == t->nclasses);
 	}
 
-	if (fsm->opt->fragment) {
-		fsm_print_c_complete(f, ir, fsm->opt);
-		return;
+	t->dflt = f_malloc(opt->alloc, ir->n * sizeof *t->dflt);
+	t->base = f_malloc(opt->alloc, ir->n * sizeof *t->base);
+	rows    = f_malloc(opt->alloc, ir->n * sizeof *rows);
+	ek      = NULL;
+	ed      = NULL;
+	if (t->dflt == NULL || t->base == NULL || rows == NULL) {
+		goto error;
+	}
+
+	ne   = 0;
+	nemax = 0;
+
+	for (i = 0; i < ir->n; i++) {
+		ir_row(ir, &ir->states[i], row);
+
+		for (k = 0; k < t->nclasses; k++) {
+			rowk[k] = row[rep[k]];
+			if (rowk[k] == ir->n) {
+				t->partial = 1;
+			}
+		}
+
+		t->dflt[i] = ctable_default(ir, rowk, t->nclasses);
+
+		rows[i].state = i;
+		rows[i].off   = ne;
+
+		if (nemax - ne < t->nclasses) {
+			unsigned *tmp;
+
+			nemax = (nemax == 0) ? ir->n + t->nclasses : nemax * 2;
+
+			tmp = f_realloc(opt->alloc, ek, nemax * sizeof *ek);
+			if (tmp == NULL) {
+				goto error;
+			}
+			ek = tmp;
+
+			tmp = f_realloc(opt->alloc, ed, nemax * sizeof *ed);
+			if (tmp == NULL) {
+				goto error;
+			}
+			ed = tmp;
+		}
+
+		for (k = 0; k < t->nclasses; k++) {
+			if (rowk[k] == t->dflt[i]) {
+				continue;
+			}
+
+			ek[ne] = k;
+			ed[ne] = rowk[k];
+			ne++;
+		}
+
+		rows[i].n = ne - rows[i].off;
+	}
+
+	/*
+	 * First fit, largest rows first. A row of the same size as the one
+	 * before starts looking where that one fit, which keeps this linear
+	 * in the table size per distinct row size, at some small cost in
+	 * compression.
+	 */
+	qsort(rows, ir->n, sizeof *rows, cmp_rowsize);
+
+	lowest  = 0;
+	maxbase = 0;
+	prevb   = 0;
+
+	for (i = 0; i < ir->n; i++) {
+		const unsigned *rk = ek + rows[i].off;
+		const unsigned *rd = ed + rows[i].off;
+		size_t b;
+
+		if (rows[i].n == 0) {
+			t->base[rows[i].state] = 0;
+			continue;
+		}
+
+		while (lowest < t->len && t->check[lowest] != ir->n) {
+			lowest++;
+		}
+
+		b = (lowest > rk[0]) ? lowest - rk[0] : 0;
+		if (i > 0 && rows[i].n == rows[i - 1].n && prevb > b) {
+			b = prevb;
+		}
+
+		for ( ; ; b++) {
+			if (b + t->nclasses > t->len && !ctable_grow(opt, t, ir, b + t->nclasses)) {
+				goto error;
+			}
+
+			for (j = 0; j < rows[i].n; j++) {
+				if (t->check[b + rk[j]] != ir->n) {
+					break;
+				}
+			}
+
+			if (j == rows[i].n) {
+				break;
+			}
+		}
+
+		for (j = 0; j < rows[i].n; j++) {
+			t->check[b + rk[j]] = rows[i].state;
+			t->next[b + rk[j]]  = rd[j];
+		}
+
+		t->base[rows[i].state] = b;
+		prevb = b;
+		if (b > maxbase) {
+			maxbase = b;
+		}
+	}
+
+	/* every row may be indexed by every class */
+	if (!ctable_grow(opt, t, ir, maxbase + t->nclasses)) {
+		goto error;
+	}
+	t->len = maxbase + t->nclasses;
+
+	f_free(opt->alloc, rows);
+	f_free(opt->alloc, ek);
+	f_free(opt->alloc, ed);
+
+	return 1;
+
+error:
+
+	f_free(opt->alloc, rows);
+	f_free(opt->alloc, ek);
+	f_free(opt->alloc, ed);
+	ctable_free(opt, t);
+
+	return 0;
+}
+
+/*
+ * A rough guess at the size of the generated code for each state's
+ * switch statement, in bytes.
+ */
+static size_t
+switch_size(const struct ir *ir, const struct fsm_options *opt)
+{
+	unsigned row[FSM_SIGMA_COUNT];
+	size_t i, size;
+	unsigned c;
+
+	size = 0;
+
+	for (i = 0; i < ir->n; i++) {
+		ir_row(ir, &ir->states[i], row);
+
+		size += 64;
+
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			if (c > 0 && row[c] == row[c - 1] && opt->case_ranges) {
+				continue;
+			}
+
+			if (row[c] != i) {
+				size += 24;
+			}
+		}
+	}
+
+	return size;
+}
+
+static size_t
+table_size(const struct ir *ir, const struct ctable *t)
+{
+	return 6 * (FSM_SIGMA_COUNT + 3 * ir->n + 2 * t->len);
+}
+
+/*
+ * Decide whether to output tables, building them if so.
+ */
+static int
+use_ctable(const struct ir *ir, const struct fsm_options *opt, struct ctable *t)
+{
+	switch (opt->ctable) {
+	case FSM_CTABLE_NEVER:
+		return 0;
+
+	case FSM_CTABLE_ALWAYS:
+		break;
+
+	case FSM_CTABLE_AUTO:
+		if (ir->n < CTABLE_MIN_STATES) {
+			return 0;
+		}
+		break;
+	}
+
+	if (!ctable_build(ir, opt, t)) {
+		return -1;
+	}
+
+	if (opt->ctable == FSM_CTABLE_AUTO && table_size(ir, t) >= switch_size(ir, opt)) {
+		ctable_free(opt, t);
+		return 0;
+	}
+
+	return 1;
+}
+
+static const char *
+ctype(unsigned long max)
+{
+	if (max <= 255UL) {
+		return "unsigned char";
+	}
+
+	if (max <= 65535UL) {
+		return "unsigned short";
+	}
+
+	return "unsigned long";
+}
+
+static void
+print_array(FILE *f, const char *tabs, const char *name, const unsigned *a, size_t n)
+{
+	unsigned long max;
+	size_t i;
+
+	max = 0;
+	for (i = 0; i < n; i++) {
+		if (a[i] > max) {
+			max = a[i];
+		}
+	}
+
+	fprintf(f, "%sstatic const %s %s[] = {", tabs, ctype(max), name);
+
+	for (i = 0; i < n; i++) {
+		if (i % 16 == 0) {
+			fprintf(f, "\n%s\t", tabs);
+		} else {
+			fprintf(f, " ");
+		}
+
+		fprintf(f, "%u%s", a[i], i + 1 < n ? "," : "");
+	}
+
+	fprintf(f, "\n%s};\n", tabs);
+}
+
+struct leaftext {
+	unsigned state;
+	long off;
+	size_t len;
+};
+
+/*
+ * leaf() output can differ per state. Rather than a case per state,
+ * states are grouped by their leaf() output, and the group is found
+ * by table.
+ */
+struct leaves {
+	char *buf;
+	struct leaftext *lt; /* sorted by text */
+	unsigned *group;     /* per state */
+	unsigned ngroups;
+};
+
+static const char *leafbuf; /* for cmp_leaftext() */
+
+static int
+cmp_leaftext(const void *a, const void *b)
+{
+	const struct leaftext *la = a, *lb = b;
+	size_t n;
+	int r;
+
+	n = la->len < lb->len ? la->len : lb->len;
+
+	r = memcmp(leafbuf + la->off, leafbuf + lb->off, n);
+	if (r != 0) {
+		return r;
+	}
+
+	if (la->len != lb->len) {
+		return (la->len > lb->len) - (la->len < lb->len);
+	}
+
+	return (la->state > lb->state) - (la->state < lb->state);
+}
+
+static void
+leaves_free(const struct fsm_options *opt, struct leaves *l)
+{
+	f_free(opt->alloc, l->buf);
+	f_free(opt->alloc, l->lt);
+	f_free(opt->alloc, l->group);
+}
+
+static int
+leaves_build(const struct ir *ir, const struct fsm_options *opt,
+	int (*leaf)(FILE *, const void *state_opaque, const void *leaf_opaque),
+	const void *leaf_opaque, struct leaves *l)
+{
+	static const struct leaves zero;
+	FILE *tmp;
+	long size;
+	size_t i;
+
+	*l = zero;
+
+	l->lt    = f_malloc(opt->alloc, ir->n * sizeof *l->lt);
+	l->group = f_malloc(opt->alloc, ir->n * sizeof *l->group);
+	if (l->lt == NULL || l->group == NULL) {
+		leaves_free(opt, l);
+		return 0;
+	}
+
+	tmp = tmpfile();
+	if (tmp == NULL) {
+		leaves_free(opt, l);
+		return 0;
+	}
+
+	for (i = 0; i < ir->n; i++) {
+		l->lt[i].state = i;
+		l->lt[i].off   = ftell(tmp);
+
+		if (-1 == leaf(tmp, ir->states[i].opaque, leaf_opaque)) {
+			goto error;
+		}
+
+		l->lt[i].len = ftell(tmp) - l->lt[i].off;
+	}
+
+	size = ftell(tmp);
+	if (size == -1 || ferror(tmp)) {
+		goto error;
+	}
+
+	l->buf = f_malloc(opt->alloc, size + 1);
+	if (l->buf == NULL) {
+		goto error;
+	}
+
+	rewind(tmp);
+	if (fread(l->buf, 1, size, tmp) != (size_t) size) {
+		goto error;
+	}
+
+	fclose(tmp);
+
+	leafbuf = l->buf;
+	qsort(l->lt, ir->n, sizeof *l->lt, cmp_leaftext);
+	leafbuf = NULL;
+
+	l->ngroups = 0;
+	for (i = 0; i < ir->n; i++) {
+		const struct leaftext *lt = &l->lt[i];
+
+		if (i == 0 || lt->len != lt[-1].len
+			|| 0 != memcmp(l->buf + lt->off, l->buf + lt[-1].off, lt->len))
+		{
+			l->ngroups++;
+		}
+
+		l->group[lt->state] = l->ngroups - 1;
+	}
+
+	return 1;
+
+error:
+
+	fclose(tmp);
+	leaves_free(opt, l);
+
+	return 0;
+}
+
+/*
+ * A transition to n reaches the leaf() output for the state it's from.
+ */
+static void
+print_leaves(FILE *f, const struct ir *ir, const struct leaves *l)
+{
+	size_t i;
+
+	fprintf(f, "\t\t\tto = check[k] == state ? next[k] : dflt[state];\n");
+	fprintf(f, "\t\t\tif (to == %u) {\n", (unsigned) ir->n);
+
+	if (l->ngroups == 1) {
+		fprintf(f, "\t\t\t\t%.*s\n", (int) l->lt[0].len, l->buf + l->lt[0].off);
+	} else {
+		fprintf(f, "\t\t\t\tswitch (leaf[state]) {\n");
+
+		for (i = 0; i < ir->n; i++) {
+			const struct leaftext *lt = &l->lt[i];
+
+			if (i > 0 && l->group[lt->state] == l->group[lt[-1].state]) {
+				continue;
+			}
+
+			fprintf(f, "\t\t\t\tcase %u: %.*s\n", l->group[lt->state],
+				(int) lt->len, l->buf + lt->off);
+		}
+
+		fprintf(f, "\t\t\t\t}\n");
+	}
+
+	fprintf(f, "\t\t\t} else {\n");
+	fprintf(f, "\t\t\t\tstate = to;\n");
+	fprintf(f, "\t\t\t}\n");
+}
+
+/*
+ * l is NULL when the table isn't partial, and so there's no leaf() output.
+ */
+static void
+print_ctable(FILE *f, const struct ir *ir, const struct fsm_options *opt,
+	const char *cp, int early, const struct ctable *t, const struct leaves *l)
+{
+	unsigned cls[FSM_SIGMA_COUNT];
+	unsigned nearly;
+	size_t i;
+
+	assert(f != NULL);
+	assert(ir != NULL);
+	assert(opt != NULL);
+	assert(cp != NULL);
+	assert(t != NULL);
+	assert((l != NULL) == t->partial);
+
+	for (i = 0; i < FSM_SIGMA_COUNT; i++) {
+		cls[i] = t->cls[i];
+	}
+
+	fprintf(f, "\t\t{\n");
+
+	if (opt->comments) {
+		fprintf(f, "\t\t\t/* %u byte classes; %u states of row-displaced transitions */\n",
+			t->nclasses, (unsigned) ir->n);
+	}
+
+	print_array(f, "\t\t\t", "cls",   cls,      FSM_SIGMA_COUNT);
+	print_array(f, "\t\t\t", "base",  t->base,  ir->n);
+	print_array(f, "\t\t\t", "dflt",  t->dflt,  ir->n);
+	print_array(f, "\t\t\t", "next",  t->next,  t->len);
+	print_array(f, "\t\t\t", "check", t->check, t->len);
+	if (l != NULL && l->ngroups > 1) {
+		print_array(f, "\t\t\t", "leaf", l->group, ir->n);
+	}
+
+	nearly = early ? ir_countearly(ir) : 0;
+	if (nearly > CTABLE_EARLY_CMP) {
+		unsigned *a;
+
+		/* an allocation failure here just goes without stopping early */
+		a = f_malloc(opt->alloc, ir->n * sizeof *a);
+		if (a == NULL) {
+			nearly = 0;
+		} else {
+			for (i = 0; i < ir->n; i++) {
+				a[i] = ir_isearly(&ir->states[i]);
+			}
+
+			print_array(f, "\t\t\t", "early", a, ir->n);
+
+			f_free(opt->alloc, a);
+		}
+	}
+	fprintf(f, "\t\t\tunsigned long k%s;\n", l != NULL ? ", to" : "");
+	fprintf(f, "\n");
+
+	fprintf(f, "\t\t\tk = base[state] + cls[(unsigned char) %s];\n", cp);
+
+	if (l == NULL) {
+		fprintf(f, "\t\t\tstate = check[k] == state ? next[k] : dflt[state];\n");
+	} else {
+		print_leaves(f, ir, l);
+	}
+
+	if (nearly > CTABLE_EARLY_CMP) {
+		fprintf(f, "\t\t\tif (early[state]) {\n");
+		fprintf(f, "\t\t\t\tgoto done;\n");
+		fprintf(f, "\t\t\t}\n");
+	} else if (nearly > 0) {
+		const char *sep;
+
+		fprintf(f, "\t\t\tif (");
+
+		sep = "";
+		for (i = 0; i < ir->n; i++) {
+			if (ir_isearly(&ir->states[i])) {
+				fprintf(f, "%sstate == S%u", sep, (unsigned) i);
+				sep = " || ";
+			}
+		}
+
+		fprintf(f, ") {\n");
+		fprintf(f, "\t\t\t\tgoto done;\n");
+		fprintf(f, "\t\t\t}\n");
+	}
+
+	fprintf(f, "\t\t}\n");
+}
+
+/*
+ * A case per state; if part is non-NULL, just the states in part k.
+ */
+static void
+print_switch(FILE *f, const struct ir *ir, const struct fsm_options *opt,
+	const char *cp, int early, const unsigned *part, unsigned k,
+	int (*leaf)(FILE *, const void *state_opaque, const void *leaf_opaque),
+	const void *leaf_opaque)
+{
+	unsigned i;
+
+	assert(f != NULL);
+	assert(ir != NULL);
+	assert(opt != NULL);
+	assert(cp != NULL);
+
+	fprintf(f, "\t\tswitch (state) {\n");
+	for (i = 0; i < ir->n; i++) {
+		if (part != NULL && part[i] != k) {
+			continue;
+		}
+
+		fprintf(f, "\t\tcase S%u:", i);
+
+		if (opt->comments) {
+			if (ir->states[i].example != NULL) {
+				fprintf(f, " /* e.g. \"");
+				escputs(f, opt, c_escputc_str, ir->states[i].example);
+				fprintf(f, "\" */");
+			} else if (i == ir->start) {
+				fprintf(f, " /* start */");
+			}
+		}
+		fprintf(f, "\n");
+
+		print_singlecase(f, ir, opt, cp, early, part, &ir->states[i], leaf, leaf_opaque);
+
+		fprintf(f, "\n");
+	}
+	fprintf(f, "\t\tdefault:\n");
+	fprintf(f, "\t\t\t; /* unreached */\n");
+	fprintf(f, "\t\t}\n");
+}
+
+/*
+ * If early is set, transitions to absorbing states goto a label "done"
+ * which the caller provides, when ir_countearly() is non-zero.
+ */
+static int
+print_cfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
+	const char *cp, int early,
+	int (*leaf)(FILE *, const void *state_opaque, const void *leaf_opaque),
+	const void *leaf_opaque)
+{
+	assert(f != NULL);
+	assert(ir != NULL);
+	assert(opt != NULL);
+	assert(cp != NULL);
+
+	{
+		struct ctable t;
+		struct leaves l;
+
+		switch (use_ctable(ir, opt, &t)) {
+		case -1:
+			return -1;
+
+		case 0:
+			break;
+
+		case 1:
+			if (!t.partial) {
+				print_ctable(f, ir, opt, cp, early, &t, NULL);
+				ctable_free(opt, &t);
+				return 0;
+			}
+
+			if (!leaves_build(ir, opt, leaf, leaf_opaque, &l)) {
+				ctable_free(opt, &t);
+				return -1;
+			}
+
+			print_ctable(f, ir, opt, cp, early, &t, &l);
+
+			leaves_free(opt, &l);
+			ctable_free(opt, &t);
+
+			return 0;
+		}
+	}
+
+	print_switch(f, ir, opt, cp, early, NULL, 0, leaf, leaf_opaque);
+
+	return 0;
+}
+
+int
+fsm_print_cfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
+	const char *cp,
+	int (*leaf)(FILE *, const void *state_opaque, const void *leaf_opaque),
+	const void *leaf_opaque)
+{
+	/* a fragment may be part of a longer match, so never stops early */
+	return print_cfrag(f, ir, opt, cp, 0, leaf, leaf_opaque);
+}
+
+static void
+fsm_print_c_complete(FILE *f, const struct ir *ir, const struct fsm_options *opt)
+{
+	const char *cp;
+
+	assert(f != NULL);
+	assert(ir != NULL);
+	assert(opt != NULL);
+
+	if (opt->cp != NULL) {
+		cp = opt->cp;
+	} else {
+		switch (opt->io) {
+		case FSM_IO_GETC: cp = "c";  break;
+		case FSM_IO_STR:  cp = "*p"; break;
+		case FSM_IO_PAIR: cp = "*p"; break;
+		}
+	}
+
+	/* enum of states */
+	print_stateenum(f, ir->n);
+	fprintf(f, "\n");
+
+	/* start state */
+	fprintf(f, "\tstate = S%u;\n", ir->start);
+	fprintf(f, "\n");
+
+	switch (opt->io) {
+	case FSM_IO_GETC:
+		fprintf(f, "\twhile (c = fsm_getc(opaque), c != EOF) {\n");
+		break;
+
+	case FSM_IO_STR:
+		fprintf(f, "\tfor (p = s; *p != '\\0'; p++) {\n");
+		break;
+
+	case FSM_IO_PAIR:
+		fprintf(f, "\tfor (p = b; p != e; p++) {\n");
+		break;
+	}
+
+	(void) print_cfrag(f, ir, opt, cp, 1,
+		opt->leaf != NULL ? opt->leaf : leaf, opt->leaf_opaque);
+
+	fprintf(f, "\t}\n");
+	fprintf(f, "\n");
+
+	if (ir_countearly(ir) > 0) {
+		fprintf(f, "done:\n");
+		fprintf(f, "\n");
+	}
+
+	/* end states */
+	endstates(f, opt, ir);
+}
+
+/*
+ * States are split across functions in breadth-first order from the
+ * start state, so that each part holds a neighbourhood of states which
+ * mostly transition among themselves. Unreachable states go last.
+ * Returns per-state part numbers, and the number of parts used.
+ */
+static unsigned *
+partition(const struct ir *ir, const struct fsm_options *opt,
+	unsigned *nparts)
+{
+	unsigned row[FSM_SIGMA_COUNT];
+	unsigned *part, *queue;
+	size_t i, h, t, size;
+	unsigned c;
+
+	assert(ir != NULL);
+	assert(opt != NULL);
+	assert(nparts != NULL);
+	assert(*nparts > 1);
+	assert(ir->n > 1);
+
+	part  = f_malloc(opt->alloc, ir->n * sizeof *part);
+	queue = f_malloc(opt->alloc, ir->n * sizeof *queue);
+	if (part == NULL || queue == NULL) {
+		f_free(opt->alloc, part);
+		f_free(opt->alloc, queue);
+		return NULL;
+	}
+
+	for (i = 0; i < ir->n; i++) {
+		part[i] = *nparts; /* unvisited */
+	}
+
+	h = t = 0;
+
+	queue[t++] = ir->start;
+	part[ir->start] = 0;
+
+	while (h < t) {
+		ir_row(ir, &ir->states[queue[h++]], row);
+
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			if (row[c] == ir->n || part[row[c]] != *nparts) {
+				continue;
+			}
+
+			queue[t++] = row[c];
+			part[row[c]] = 0;
+		}
+	}
+
+	for (i = 0; i < ir->n; i++) {
+		if (part[i] == *nparts) {
+			queue[t++] = i;
+		}
+	}
+
+	assert(t == ir->n);
+
+	size = (ir->n + *nparts - 1) / *nparts;
+
+	for (i = 0; i < ir->n; i++) {
+		part[queue[i]] = i / size;
+	}
+
+	*nparts = (ir->n + size - 1) / size;
+
+	f_free(opt->alloc, queue);
+
+	return part;
+}
+
+static int
+leaf_part(FILE *f, const void *state_opaque, const void *leaf_opaque)
+{
+	assert(f != NULL);
+
+	(void) state_opaque;
+	(void) leaf_opaque;
+
+	fprintf(f, "goto leaf;");
+
+	return 0;
+}
+
+#define PART_HANDOFF 1
+#define PART_LEAF    2
+#define PART_DONE    4
+
+/*
+ * Each part is a function of its own, guarded by FSM_PART so that the
+ * same file may be compiled once per part (by -DFSM_PART=n) in parallel,
+ * or just once as a whole. A part runs until input ends, or until there
+ * is no transition, or until a transition leaves the part. In each case
+ * it returns to the main function, which dispatches to the next part.
+ * Reaching an absorbing state returns as if input had ended.
+ */
+static int
+print_parts(FILE *f, const struct ir *ir, const struct fsm_options *opt,
+	const char *prefix, unsigned nparts)
+{
+	unsigned row[FSM_SIGMA_COUNT];
+	const char *cp, *args, *types;
+	unsigned *part;
+	unsigned char *uses;
+	struct leaves l;
+	unsigned any;
+	unsigned c;
+	size_t i;
+
+	assert(f != NULL);
+	assert(ir != NULL);
+	assert(opt != NULL);
+	assert(prefix != NULL);
+
+	switch (opt->io) {
+	case FSM_IO_GETC:
+		cp    = "c";
+		args  = "(int (*fsm_getc)(void *opaque), void *opaque, unsigned *sp, int *cp)";
+		types = "(int (*)(void *), void *, unsigned *, int *)";
+		break;
+
+	case FSM_IO_STR:
+		cp    = "*p";
+		args  = "(const char **pp, unsigned *sp)";
+		types = "(const char **, unsigned *)";
+		break;
+
+	case FSM_IO_PAIR:
+		cp    = "*p";
+		args  = "(const char **pp, const char *e, unsigned *sp)";
+		types = "(const char **, const char *, unsigned *)";
+		break;
+
+	default:
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (opt->cp != NULL) {
+		cp = opt->cp;
+	}
+
+	part = partition(ir, opt, &nparts);
+	if (part == NULL) {
+		return -1;
+	}
+
+	uses = f_calloc(opt->alloc, nparts, sizeof *uses);
+	if (uses == NULL) {
+		f_free(opt->alloc, part);
+		return -1;
+	}
+
+	for (i = 0; i < ir->n; i++) {
+		ir_row(ir, &ir->states[i], row);
+
+		for (c = 0; c < FSM_SIGMA_COUNT; c++) {
+			if (row[c] == ir->n) {
+				uses[part[i]] |= PART_LEAF;
+			} else if (ir_isearly(&ir->states[row[c]])) {
+				uses[part[i]] |= PART_DONE;
+			} else if (part[row[c]] != part[i]) {
+				uses[part[i]] |= PART_HANDOFF;
+			}
+		}
+	}
+
+	any = 0;
+	for (i = 0; i < nparts; i++) {
+		any |= uses[i];
+	}
+
+	if ((any & PART_LEAF) && !leaves_build(ir, opt,
+		opt->leaf != NULL ? opt->leaf : leaf, opt->leaf_opaque, &l))
+	{
+		f_free(opt->alloc, uses);
+		f_free(opt->alloc, part);
+		return -1;
+	}
+
+	fprintf(f, "\n");
+
+	if (opt->comments) {
+		fprintf(f, "/*\n");
+		fprintf(f, " * Compile once, or once per part with -DFSM_PART=0 to %u\n", nparts - 1);
+		fprintf(f, " */\n");
+		fprintf(f, "\n");
+	}
+
+	/* enum of states, at file scope for all parts */
+	fprintf(f, "enum {\n");
+	fprintf(f, "\t");
+	for (i = 0; i < ir->n; i++) {
+		fprintf(f, "S%u", (unsigned) i);
+		if (i + 1 < ir->n) {
+			fprintf(f, ", ");
+		}
+
+		if (i + 1 < ir->n && (i + 1) % 10 == 0) {
+			fprintf(f, "\n");
+			fprintf(f, "\t");
+		}
+	}
+	fprintf(f, "\n");
+	fprintf(f, "};\n");
+	fprintf(f, "\n");
+
+	for (i = 0; i < nparts; i++) {
+		fprintf(f, "int %spart%u%s;\n", prefix, (unsigned) i, args);
+	}
+
+	for (i = 0; i < nparts; i++) {
+		fprintf(f, "\n");
+		fprintf(f, "#if !defined(FSM_PART) || FSM_PART == %u\n", (unsigned) i);
+		fprintf(f, "int\n%spart%u%s\n", prefix, (unsigned) i, args);
+		fprintf(f, "{\n");
+
+		switch (opt->io) {
+		case FSM_IO_GETC:
+			fprintf(f, "\tint c;\n");
+			fprintf(f, "\tunsigned state;\n");
+			fprintf(f, "\n");
+			fprintf(f, "\tstate = *sp;\n");
+			fprintf(f, "\n");
+			fprintf(f, "\twhile (c = fsm_getc(opaque), c != EOF) {\n");
+			break;
+
+		case FSM_IO_STR:
+			fprintf(f, "\tconst char *p;\n");
+			fprintf(f, "\tunsigned state;\n");
+			fprintf(f, "\n");
+			fprintf(f, "\tstate = *sp;\n");
+			fprintf(f, "\n");
+			fprintf(f, "\tfor (p = *pp; *p != '\\0'; p++) {\n");
+			break;
+
+		case FSM_IO_PAIR:
+			fprintf(f, "\tconst char *p;\n");
+			fprintf(f, "\tunsigned state;\n");
+			fprintf(f, "\n");
+			fprintf(f, "\tstate = *sp;\n");
+			fprintf(f, "\n");
+			fprintf(f, "\tfor (p = *pp; p != e; p++) {\n");
+			break;
+		}
+
+		print_switch(f, ir, opt, cp, 1, part, i, leaf_part, NULL);
+
+		fprintf(f, "\t}\n");
+		fprintf(f, "\n");
+
+		if (uses[i] & PART_DONE) {
+			fprintf(f, "done:\n");
+			fprintf(f, "\n");
+		}
+
+		fprintf(f, "\t*sp = state;\n");
+		if (opt->io != FSM_IO_GETC) {
+			fprintf(f, "\t*pp = p;\n");
+		}
+		fprintf(f, "\treturn 1; /* end of input */\n");
+
+		if (uses[i] & PART_HANDOFF) {
+			fprintf(f, "\n");
+			fprintf(f, "handoff:\n");
+			fprintf(f, "\n");
+			fprintf(f, "\t*sp = state;\n");
+			if (opt->io != FSM_IO_GETC) {
+				fprintf(f, "\t*pp = p + 1;\n");
+			}
+			fprintf(f, "\treturn 0;\n");
+		}
+
+		if (uses[i] & PART_LEAF) {
+			fprintf(f, "\n");
+			fprintf(f, "leaf:\n");
+			fprintf(f, "\n");
+			fprintf(f, "\t*sp = state;\n");
+			if (opt->io != FSM_IO_GETC) {
+				fprintf(f, "\t*pp = p;\n");
+			} else {
+				fprintf(f, "\t*cp = c;\n");
+			}
+			fprintf(f, "\treturn 2; /* no transition */\n");
+		}
+
+		fprintf(f, "}\n");
+		fprintf(f, "#endif\n");
+	}
+
+	fprintf(f, "\n");
+	fprintf(f, "#if !defined(FSM_PART) || FSM_PART == 0\n");
+	fprintf(f, "int\n%smain", prefix);
+
+	switch (opt->io) {
+	case FSM_IO_GETC:
+		fprintf(f, "(int (*fsm_getc)(void *opaque), void *opaque)\n");
+		break;
+
+	case FSM_IO_STR:
+		fprintf(f, "(const char *s)\n");
+		break;
+
+	case FSM_IO_PAIR:
+		fprintf(f, "(const char *b, const char *e)\n");
+		break;
+	}
+
+	fprintf(f, "{\n");
+
+	fprintf(f, "\tstatic int (*const part[])%s = {\n", types);
+	for (i = 0; i < nparts; i++) {
+		fprintf(f, "\t\t%spart%u%s\n", prefix, (unsigned) i, i + 1 < nparts ? "," : "");
+	}
+	fprintf(f, "\t};\n");
+
+	print_array(f, "\t", "partof", part, ir->n);
+	if ((any & PART_LEAF) && l.ngroups > 1) {
+		print_array(f, "\t", "leaf", l.group, ir->n);
+	}
+
+	switch (opt->io) {
+	case FSM_IO_GETC:
+		fprintf(f, "\tint c;\n");
+		break;
+
+	case FSM_IO_STR:
+	case FSM_IO_PAIR:
+		fprintf(f, "\tconst char *p;\n");
+		break;
+	}
+
+	fprintf(f, "\tunsigned state;\n");
+	fprintf(f, "\tint r;\n");
+	fprintf(f, "\n");
+
+	switch (opt->io) {
+	case FSM_IO_GETC:
+		break;
+
+	case FSM_IO_STR:
+		fprintf(f, "\tp = s;\n");
+		break;
+
+	case FSM_IO_PAIR:
+		fprintf(f, "\tp = b;\n");
+		break;
+	}
+
+	fprintf(f, "\tstate = S%u;\n", ir->start);
+	fprintf(f, "\n");
+
+	fprintf(f, "\tdo {\n");
+	switch (opt->io) {
+	case FSM_IO_GETC:
+		fprintf(f, "\t\tr = part[partof[state]](fsm_getc, opaque, &state, &c);\n");
+		break;
+
+	case FSM_IO_STR:
+		fprintf(f, "\t\tr = part[partof[state]](&p, &state);\n");
+		break;
+
+	case FSM_IO_PAIR:
+		fprintf(f, "\t\tr = part[partof[state]](&p, e, &state);\n");
+		break;
+	}
+	fprintf(f, "\t} while (r == 0);\n");
+	fprintf(f, "\n");
+
+	if (any & PART_LEAF) {
+		fprintf(f, "\tif (r == 2) {\n");
+
+		if (l.ngroups == 1) {
+			fprintf(f, "\t\t%.*s\n", (int) l.lt[0].len, l.buf + l.lt[0].off);
+		} else {
+			fprintf(f, "\t\tswitch (leaf[state]) {\n");
+
+			for (i = 0; i < ir->n; i++) {
+				const struct leaftext *lt = &l.lt[i];
+
+				if (i > 0 && l.group[lt->state] == l.group[lt[-1].state]) {
+					continue;
+				}
+
+				fprintf(f, "\t\tcase %u: %.*s\n", l.group[lt->state],
+					(int) lt->len, l.buf + lt->off);
+			}
+
+			fprintf(f, "\t\t}\n");
+		}
+
+		fprintf(f, "\t}\n");
+		fprintf(f, "\n");
+
+		leaves_free(opt, &l);
+	}
+
+	endstates(f, opt, ir);
+
+	fprintf(f, "}\n");
+	fprintf(f, "#endif\n");
+	fprintf(f, "\n");
+
+	f_free(opt->alloc, uses);
+	f_free(opt->alloc, part);
+
+	return 0;
+}
+
+void
+fsm_print_c(FILE *f, const struct fsm *fsm)
+{
+	struct ir *ir;
+	const char *prefix;
+
+	assert(f != NULL);
+	assert(fsm != NULL);
+	assert(fsm->opt != NULL);
+
+	ir = make_ir(fsm);
+	if (ir == NULL) {
+		return;
+	}
+
+	/* henceforth, no function should be passed struct fsm *, only the ir and options */
+
+	if (fsm->opt->prefix != NULL) {
+		prefix = fsm->opt->prefix;
+	} else {
+		prefix = "fsm_";
+	}
+
+	if (fsm->opt->fragment) {
+		fsm_print_c_complete(f, ir, fsm->opt);
+		return;
+	}
+
+	if (fsm->opt->parts > 1 && ir->n > 1 && fsm->opt->ctable != FSM_CTABLE_ALWAYS) {
+		if (0 == print_parts(f, ir, fsm->opt, prefix, fsm->opt->parts)) {
+			free_ir(fsm, ir);
+			return;
+		}
 	}
 
 	fprintf(f, "\n");
@@ -36,18 +36,27 @@ findany(const struct fsm *fsm, fsm_state_t state, fsm_state_t *a)
 	assert(state < fsm->statecount);
 
 	/*
-	 * This approach is a little unsatisfying because it will only identify
-	 * situations with one single "any" edge between states. I'd much prefer
-	 * to be able to emit "any" edges for situations like:
+	 * A default edge for every symbol is an "any" edge, regardless of
+	 * whatever other edges the state has, as in:
 	 *
 	 *  1 -> 2 'x';
 	 *  1 -> 3;
 	 *
-	 * where a given state also has an unrelated edge transitioning elsewhere.
-	 * The current implementation conservatively bails out on that situation
+	 * Otherwise this approach is a little unsatisfying because it will only
+	 * identify situations with one single "any" edge between states.
+	 * The implementation conservatively bails out when edges go elsewhere
 	 * (because f != e.state), and will emit each edge separately.
 	 */
 
+	if (edge_set_default(fsm->states[state].edges, &bm, &f)) {
+		if (bm_count(&bm) == FSM_SIGMA_COUNT) {
+			assert(f < fsm->statecount);
+
+			*a = f;
+			return 1;
+		}
+	}
+
 	bm_clear(&bm);
 
 	edge_set_reset(fsm->states[state].edges, &it);
@@ -112,6 +121,8 @@ fsm_print_fsm(FILE *f, const struct fsm *fsm)
 	for (s = 0; s < fsm->statecount; s++) {
 		struct fsm_edge e;
 		struct edge_ordered_iter eoi;
+		fsm_state_t a;
+		int any;
 
 		{
 			struct state_iter jt;
@@ -122,13 +133,10 @@ fsm_print_fsm(FILE *f, const struct fsm *fsm)
 			}
 		}
 
-		{
-			fsm_state_t a;
-
-			if (findany(fsm, s, &a)) {
-				fprintf(f, "%-2u -> %2u ?;\n", s, a);
-				continue;
-			}
+		a = 0;
+		any = findany(fsm, s, &a);
+		if (any) {
+			fprintf(f, "%-2u -> %2u ?;\n", s, a);
 		}
 
 		assert(s < fsm->statecount);
@@ -137,6 +145,11 @@ fsm_print_fsm(FILE *f, const struct fsm *fsm)
 		     edge_set_ordered_iter_next(&eoi, &e); ) {
 			assert(e.state < fsm->statecount);
 
+			/* already covered by the "any" edge */
+			if (any && e.state == a) {
+				continue;
+			}
+
 			fprintf(f, "%-2u -> %2u", s, e.state);
 
 			fputs(" \"", f);
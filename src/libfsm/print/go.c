@@ -133,7 +133,7 @@ fsm_print_gofrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	struct dfavm_assembler_ir a;
 	struct dfavm_op_ir *op;
 
-	static const struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS, FSM_VM_COMPILE_VM_V1, NULL };
+	struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS & ~FSM_VM_COMPILE_MATCHS, FSM_VM_COMPILE_VM_V1, NULL, NULL };
 
 	assert(f != NULL);
 	assert(ir != NULL);
@@ -150,6 +150,8 @@ fsm_print_gofrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	/* TODO: we'll need to heed cp for e.g. lx's codegen */
 	(void) cp;
 
+	vm_opts.profile = opt->vm_profile;
+
 	if (!dfavm_compile_ir(&a, ir, vm_opts)) {
 		return -1;
 	}
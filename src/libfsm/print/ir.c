@@ -472,6 +472,7 @@ make_ir(const struct fsm *fsm)
 
 		ir->states[i].isend  = fsm_isend(fsm, i);
 		ir->states[i].opaque = fsm_isend(fsm, i) ? fsm_getopaque(fsm, i) : NULL;
+		ir->states[i].absorbing = fsm_isabsorbing(fsm, i);
 
 		if (make_state(fsm, i, ir, &ir->states[i]) == -1) {
 			goto error;
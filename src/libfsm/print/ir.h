@@ -52,6 +52,7 @@ struct ir_error {
 struct ir_state {
 	const char *example;
 	unsigned int isend:1;
+	unsigned int absorbing:1; /* see fsm_isabsorbing() */
 
 	void *opaque;
 
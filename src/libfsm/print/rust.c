@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <errno.h>
 #include <stdio.h>
+#include <ctype.h>
 
 #include <print/esc.h>
 
@@ -122,6 +123,55 @@ print_fetch(FILE *f)
 	fprintf(f, "bytes.next()");
 }
 
+static void
+print_bytestr(FILE *f, const struct dfavm_op_ir *op, const struct fsm_options *opt)
+{
+	unsigned i;
+
+	fprintf(f, "b\"");
+
+	for (i = 0; i < op->u.matchs.len; i++) {
+		unsigned char c = op->u.matchs.str[i];
+
+		if (opt->always_hex || !isprint(c) || c == '\\' || c == '\"') {
+			fprintf(f, "\\x%02x", c);
+		} else {
+			fprintf(f, "%c", c);
+		}
+	}
+
+	fprintf(f, "\"");
+}
+
+/*
+ * For FSM_IO_PAIR the string is compared in place, and otherwise
+ * each byte is taken from the iterator in turn.
+ */
+static void
+print_matchs(FILE *f, const struct dfavm_op_ir *op, const struct fsm_options *opt)
+{
+	switch (opt->io) {
+	case FSM_IO_PAIR:
+		fprintf(f, "if !bytes.as_slice().starts_with(");
+		print_bytestr(f, op, opt);
+		fprintf(f, ") { return None; }\n");
+		fprintf(f, "                ");
+		fprintf(f, "bytes = bytes.as_slice()[%u..].iter();", (unsigned) op->u.matchs.len);
+		break;
+
+	case FSM_IO_GETC:
+	case FSM_IO_STR:
+		fprintf(f, "for &b in ");
+		print_bytestr(f, op, opt);
+		fprintf(f, " { if bytes.next() != Some(b) { return None; } }");
+		break;
+
+	default:
+		assert(!"unreached");
+		break;
+	}
+}
+
 /* TODO: eventually to be non-static */
 static int
 fsm_print_rustfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
@@ -134,7 +184,7 @@ fsm_print_rustfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	struct dfavm_op_ir *op;
 	bool fallthrough;
 
-	static const struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS, FSM_VM_COMPILE_VM_V1, NULL };
+	struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS, FSM_VM_COMPILE_VM_V1, NULL, NULL };
 
 	assert(f != NULL);
 	assert(ir != NULL);
@@ -151,6 +201,8 @@ fsm_print_rustfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	/* TODO: we'll need to heed cp for e.g. lx's codegen */
 	(void) cp;
 
+	vm_opts.profile = opt->vm_profile;
+
 	if (!dfavm_compile_ir(&a, ir, vm_opts)) {
 		return -1;
 	}
@@ -305,6 +357,10 @@ fsm_print_rustfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 			}
 			break;
 
+		case VM_OP_MATCHS:
+			print_matchs(f, op, opt);
+			break;
+
 		default:
 			assert(!"unreached");
 			break;
@@ -155,7 +155,7 @@ fsm_print_shfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt)
 	struct dfavm_assembler_ir a;
 	struct dfavm_op_ir *op;
 
-	static const struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS, FSM_VM_COMPILE_VM_V1, NULL };
+	struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS & ~FSM_VM_COMPILE_MATCHS, FSM_VM_COMPILE_VM_V1, NULL, NULL };
 
 	assert(f != NULL);
 	assert(ir != NULL);
@@ -163,6 +163,8 @@ fsm_print_shfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt)
 
 	a = zero;
 
+	vm_opts.profile = opt->vm_profile;
+
 	if (!dfavm_compile_ir(&a, ir, vm_opts)) {
 		return -1;
 	}
@@ -376,7 +376,7 @@ print_vmasm_encoding(FILE *f, const struct fsm *fsm, enum asm_dialect dialect)
 	static const struct dfavm_assembler_ir zero;
 	struct dfavm_assembler_ir a;
 
-	static const struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS, FSM_VM_COMPILE_VM_V1, NULL };
+	struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS & ~FSM_VM_COMPILE_MATCHS, FSM_VM_COMPILE_VM_V1, NULL, NULL };
 
 	assert(f != NULL);
 	assert(fsm != NULL);
@@ -392,6 +392,8 @@ print_vmasm_encoding(FILE *f, const struct fsm *fsm, enum asm_dialect dialect)
 
 	a = zero;
 
+	vm_opts.profile = fsm->opt->vm_profile;
+
 	if (!dfavm_compile_ir(&a, ir, vm_opts)) {
 		free_ir(fsm, ir);
 		return;
@@ -133,6 +133,54 @@ print_fetch(FILE *f, const struct fsm_options *opt)
 	}
 }
 
+/*
+ * For FSM_IO_GETC, each byte must be read in turn. Otherwise the string
+ * is compared in place, by strncmp() for FSM_IO_STR (which stops at the
+ * '\0' terminator) and memcmp() for FSM_IO_PAIR.
+ */
+static void
+print_matchs(FILE *f, const struct dfavm_op_ir *op, const struct fsm_options *opt)
+{
+	unsigned i, n;
+
+	n = op->u.matchs.len;
+
+	switch (opt->io) {
+	case FSM_IO_GETC:
+		fprintf(f, "if (");
+		for (i = 0; i < n; i++) {
+			if (i > 0) {
+				fprintf(f, "\n\t    || ");
+			}
+			fprintf(f, "fsm_getc(opaque) != ");
+			c_escputcharlit(f, opt, op->u.matchs.str[i]);
+		}
+		fprintf(f, ") return -1;");
+		return;
+
+	case FSM_IO_STR:
+		if (memchr(op->u.matchs.str, '\0', n) != NULL) {
+			/* the terminator can't be matched */
+			fprintf(f, "return -1;");
+			return;
+		}
+
+		fprintf(f, "if (0 != strncmp(p, \"");
+		break;
+
+	case FSM_IO_PAIR:
+		fprintf(f, "if (e - p < %u || 0 != memcmp(p, \"", n);
+		break;
+	}
+
+	for (i = 0; i < n; i++) {
+		c_escputc_str(f, opt, op->u.matchs.str[i]);
+	}
+
+	fprintf(f, "\", %u)) return -1;\n", n);
+	fprintf(f, "\tp += %u;", n);
+}
+
 /* TODO: eventually to be non-static */
 static int
 fsm_print_cfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
@@ -144,7 +192,7 @@ fsm_print_cfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	struct dfavm_assembler_ir a;
 	struct dfavm_op_ir *op;
 
-	static const struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS, FSM_VM_COMPILE_VM_V1, NULL };
+	struct fsm_vm_compile_opts vm_opts = { FSM_VM_COMPILE_DEFAULT_FLAGS, FSM_VM_COMPILE_VM_V1, NULL, NULL };
 
 	assert(f != NULL);
 	assert(ir != NULL);
@@ -161,6 +209,8 @@ fsm_print_cfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 	/* TODO: we'll need to heed cp for e.g. lx's codegen */
 	(void) cp;
 
+	vm_opts.profile = opt->vm_profile;
+
 	if (!dfavm_compile_ir(&a, ir, vm_opts)) {
 		return -1;
 	}
@@ -212,6 +262,10 @@ fsm_print_cfrag(FILE *f, const struct ir *ir, const struct fsm_options *opt,
 			print_branch(f, op);
 			break;
 
+		case VM_OP_MATCHS:
+			print_matchs(f, op, opt);
+			break;
+
 		default:
 			assert(!"unreached");
 			break;
@@ -234,6 +288,12 @@ fsm_print_c_complete(FILE *f, const struct ir *ir, const struct fsm_options *opt
 	assert(ir != NULL);
 	assert(opt != NULL);
 
+	if (opt->cp != NULL) {
+		cp = opt->cp;
+	} else {
+		cp = "c"; /* XXX */
+	}
+
 	(void) fsm_print_cfrag(f, ir, opt, cp,
 		opt->leaf != NULL ? opt->leaf : leaf, opt->leaf_opaque);
 }
@@ -268,6 +328,12 @@ fsm_print_vmc(FILE *f, const struct fsm *fsm)
 
 	fprintf(f, "\n");
 
+	/* for MATCHS */
+	if (fsm->opt->io != FSM_IO_GETC) {
+		fprintf(f, "#include <string.h>\n");
+		fprintf(f, "\n");
+	}
+
 	fprintf(f, "int\n%smain", prefix);
 
 	switch (fsm->opt->io) {
@@ -106,7 +106,7 @@ otherwise realloc to += twice as much more
 	return 1;
 }
 
-void
+int
 fsm_removestate(struct fsm *fsm, fsm_state_t state)
 {
 	fsm_state_t start, i;
@@ -144,12 +144,16 @@ fsm_removestate(struct fsm *fsm, fsm_state_t state)
 		fsm->states[state] = fsm->states[fsm->statecount - 1];
 
 		for (i = 0; i < fsm->statecount - 1; i++) {
-			state_set_replace(&fsm->states[i].epsilons, fsm->statecount - 1, state);
+			if (!state_set_replace(&fsm->states[i].epsilons, fsm->statecount - 1, state)) {
+				return 0;
+			}
 			edge_set_replace_state(&fsm->states[i].edges, fsm->statecount - 1, state);
 		}
 	}
 
 	fsm->statecount--;
+
+	return 1;
 }
 
 static fsm_state_t
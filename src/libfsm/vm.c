@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 #include <string.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -59,10 +60,22 @@ fsm_dfavm_load(FILE *f, struct fsm_dfavm *vm)
 	}
 
 	if (header[6] == DFAVM_VARENC_MAJOR && header[7] == DFAVM_VARENC_MINOR) {
+		enum dfavm_io_result r;
+
 		vm->version_major = header[6];
 		vm->version_minor = header[7];
 
-		return dfavm_load_v1(f, &vm->u.v1);
+		r = dfavm_load_v1(f, &vm->u.v1);
+		if (r != DFAVM_IO_OK) {
+			return r;
+		}
+
+		vm->dec.ops = NULL;
+		if (!dfavm_decode(vm)) {
+			return DFAVM_IO_OUT_OF_MEMORY;
+		}
+
+		return DFAVM_IO_OK;
 	}
 
 	return DFAVM_IO_UNSUPPORTED_VERSION;
@@ -119,7 +132,9 @@ struct fsm_dfavm *
 fsm_vm_compile(const struct fsm *fsm)
 {
 	// static const struct fsm_vm_compile_opts defaults = { FSM_VM_COMPILE_DEFAULT_FLAGS | FSM_VM_COMPILE_PRINT_IR_PREOPT | FSM_VM_COMPILE_PRINT_IR, NULL };
-	static const struct fsm_vm_compile_opts defaults = { FSM_VM_COMPILE_DEFAULT_FLAGS, FSM_VM_COMPILE_VM_V1, NULL };
+	struct fsm_vm_compile_opts defaults = { FSM_VM_COMPILE_DEFAULT_FLAGS, FSM_VM_COMPILE_VM_V1, NULL, NULL };
+
+	defaults.profile = fsm->opt->vm_profile;
 
 	return fsm_vm_compile_with_options(fsm, defaults);
 }
@@ -127,16 +142,39 @@ fsm_vm_compile(const struct fsm *fsm)
 void
 fsm_vm_free(struct fsm_dfavm *vm)
 {
-	(void)vm;
+	if (vm == NULL) {
+		return;
+	}
+
+	if (vm->version_major == DFAVM_VARENC_MAJOR && vm->version_minor == DFAVM_VARENC_MINOR) {
+		free(vm->u.v1.ops);
+	} else if (vm->version_major == DFAVM_FIXEDENC_MAJOR && vm->version_minor == DFAVM_FIXEDENC_MINOR) {
+		free(vm->u.v2.ops);
+		free(vm->u.v2.abuf);
+	} else if (vm->version_major == DFAVM_AMD64_MAJOR && vm->version_minor == DFAVM_AMD64_MINOR) {
+		dfavm_amd64_free(&vm->u.amd64);
+	}
+
+	if (vm->dec.ops != NULL) {
+		dfavm_dec_free(&vm->dec);
+	}
+
+	free(vm);
 }
 
 static enum dfavm_state
 vm_match(const struct fsm_dfavm *vm, struct vm_state *st, const char *buf, size_t n)
 {
+	if (vm->dec.ops != NULL) {
+		return vm_match_dec(&vm->dec, st, buf, n);
+	}
+
 	if (vm->version_major == DFAVM_VARENC_MAJOR && vm->version_minor == DFAVM_VARENC_MINOR) {
 		return vm_match_v1(&vm->u.v1, st, buf, n);
 	} else if (vm->version_major == DFAVM_FIXEDENC_MAJOR && vm->version_minor == DFAVM_FIXEDENC_MINOR) {
 		return vm_match_v2(&vm->u.v2, st, buf, n);
+	} else if (vm->version_major == DFAVM_AMD64_MAJOR && vm->version_minor == DFAVM_AMD64_MINOR) {
+		return vm_match_amd64(&vm->u.amd64, st, buf, n);
 	}
 
 	return VM_FAIL;
@@ -0,0 +1,627 @@
+/*
+ * Copyright 2019 Shannon F. Stewman
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#define _POSIX_C_SOURCE 200112L
+#define _DEFAULT_SOURCE /* for MAP_ANONYMOUS */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include <fsm/fsm.h>
+#include <fsm/vm.h>
+
+#include "vm.h"
+
+// Native code for amd64, encoded directly from the VM instructions
+// into memory mapped executable. The layout of instructions is the same
+// as for the VM bytecode, and so is the profile-guided ordering.
+//
+// The generated function uses the System V calling convention:
+//
+//   uint32_t f(const unsigned char *p, const unsigned char *e, uint32_t pc)
+//
+//   %rdi - p, the next byte to fetch
+//   %rsi - e, the end of the buffer
+//   %edx - pc, the offset of the FETCH to resume from; 0 to start
+//   %cl  - the current byte
+//
+// The result is (pc << 2) | R when a FETCH reaches the end of the
+// buffer, where R is its end bit; matching resumes from that FETCH
+// with the next buffer. Otherwise the result is 2 | R for a STOP.
+//
+// Encodings:
+//
+//   entry    89 D2             mov   %edx,%edx
+//            48 8D 05 <5>      lea   5(%rip),%rax
+//            48 01 D0          add   %rdx,%rax
+//            FF E0             jmp   *%rax
+//
+//   FETCH    48 39 F7          cmp   %rsi,%rdi
+//            75 06             jne   1f
+//            B8 <pc|R>         mov   $((pc << 2) | R),%eax
+//            C3                ret
+//         1: 0F B6 0F          movzbl (%rdi),%ecx
+//            48 FF C7          inc   %rdi
+//
+//   STOP     80 F9 <arg>       cmp   $arg,%cl       (unless ALWAYS)
+//            7x 06             j!cc  1f             (unless ALWAYS)
+//            B8 <2|R>          mov   $(2 | R),%eax
+//            C3                ret
+//         1:
+//
+//   BRANCH   80 F9 <arg>       cmp   $arg,%cl       (unless ALWAYS)
+//            7x <rel8>         jcc   dest           (short)
+//            0F 8x <rel32>     jcc   dest           (near)
+//            EB <rel8>         jmp   dest           (ALWAYS, short)
+//            E9 <rel32>        jmp   dest           (ALWAYS, near)
+//
+//   MATCHS   48 89 F0          mov   %rsi,%rax
+//            48 29 F8          sub   %rdi,%rax
+//            48 83 F8 <n>      cmp   $n,%rax
+//            72 <rel8>         jb    slow
+//            ...               compare in place, per chunk of the string:
+//            48 B8 <imm64>     mov   $imm64,%rax
+//            48 39 47 <o>      cmp   %rax,o(%rdi)   (8 bytes)
+//            81 7F <o> <imm32> cmpl  $imm32,o(%rdi) (4 bytes)
+//            66 81 7F <o> <imm16>                   (2 bytes)
+//            80 7F <o> <imm8>  cmpb  $imm8,o(%rdi)  (1 byte)
+//            0F 85 <rel32>     jne   fail           (after each)
+//            48 83 C7 <n>      add   $n,%rdi
+//            0F B6 4F FF       movzbl -1(%rdi),%ecx
+//            E9 <rel32>        jmp   next
+//      fail: B8 <2>            mov   $2,%eax
+//            C3                ret
+//      slow: ...               per byte of the string:
+//            FETCH             with R = 0
+//            80 F9 <c>         cmp   $c,%cl
+//            0F 85 <rel32>     jne   fail
+//      next:
+//
+//   Where the buffer holds the whole string, MATCHS compares it in place,
+//   up to eight bytes at a time. Otherwise it falls back to a FETCH per
+//   byte, each of which may return for the next buffer and be resumed.
+//
+// Comparisons are unsigned, as the byte is.
+
+#if defined(__x86_64__) && !defined(_WIN32)
+
+#include <sys/types.h>
+#include <sys/mman.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#define ENTRY_BYTES 14
+#define FETCH_BYTES 17
+
+#define MATCHS_HEAD_BYTES 12
+#define MATCHS_TAIL_BYTES 13
+#define MATCHS_FAIL_BYTES  6
+#define MATCHS_SLOW_BYTES (FETCH_BYTES + 3 + 6)
+
+typedef uint32_t amd64_func(const unsigned char *p, const unsigned char *e, uint32_t pc);
+
+// x86 condition codes, for the low nibble of Jcc
+static unsigned char
+cc(enum dfavm_op_cmp cmp)
+{
+	switch (cmp) {
+	case VM_CMP_LT: return 0x2; // b
+	case VM_CMP_LE: return 0x6; // be
+	case VM_CMP_GE: return 0x3; // ae
+	case VM_CMP_GT: return 0x7; // a
+	case VM_CMP_EQ: return 0x4; // e
+	case VM_CMP_NE: return 0x5; // ne
+
+	case VM_CMP_ALWAYS:
+	default:
+		assert(!"unreached");
+		return 0;
+	}
+}
+
+// the widest comparison for the remaining n bytes of a string
+static unsigned
+chunk(unsigned n)
+{
+	return n >= 8 ? 8 : n >= 4 ? 4 : n >= 2 ? 2 : 1;
+}
+
+static size_t
+matchs_fast_size(unsigned n)
+{
+	size_t size;
+	unsigned o;
+
+	size = 0;
+
+	for (o = 0; o < n; o += chunk(n - o)) {
+		switch (chunk(n - o)) {
+		case 8: size += 10 + 4; break;
+		case 4: size += 7;      break;
+		case 2: size += 6;      break;
+		case 1: size += 4;      break;
+		}
+
+		size += 6;
+	}
+
+	return size;
+}
+
+static size_t
+op_size(const struct dfavm_vm_op *op, int near)
+{
+	size_t n;
+
+	n = (op->cmp != VM_CMP_ALWAYS) ? 3 : 0;
+
+	switch (op->instr) {
+	case VM_OP_FETCH:
+		return FETCH_BYTES;
+
+	case VM_OP_STOP:
+		return n + ((op->cmp != VM_CMP_ALWAYS) ? 2 : 0) + 6;
+
+	case VM_OP_BRANCH:
+		if (!near) {
+			return n + 2;
+		}
+
+		return n + ((op->cmp != VM_CMP_ALWAYS) ? 6 : 5);
+
+	case VM_OP_MATCHS:
+		return MATCHS_HEAD_BYTES + matchs_fast_size(op->u.matchs.len)
+			+ MATCHS_TAIL_BYTES + MATCHS_FAIL_BYTES
+			+ op->u.matchs.len * MATCHS_SLOW_BYTES;
+	}
+
+	assert(!"unreached");
+	return 0;
+}
+
+// Branches start short, and are lengthened until every displacement
+// fits. Lengthening only moves code apart, so this converges.
+static size_t
+layout(const struct dfavm_vm_op *instr, size_t ninstr,
+	uint32_t *off, unsigned char *near)
+{
+	size_t i, total;
+	int changed;
+
+	do {
+		total = 0;
+		for (i = 0; i < ninstr; i++) {
+			off[i] = total;
+			total += op_size(&instr[i], near[i]);
+		}
+
+		changed = 0;
+		for (i = 0; i < ninstr; i++) {
+			int64_t rel;
+
+			if (instr[i].instr != VM_OP_BRANCH || near[i]) {
+				continue;
+			}
+
+			assert(instr[i].u.br.dest_index < ninstr);
+
+			rel = (int64_t) off[instr[i].u.br.dest_index]
+				- (int64_t) (off[i] + op_size(&instr[i], 0));
+
+			if (rel < INT8_MIN || rel > INT8_MAX) {
+				near[i] = 1;
+				changed = 1;
+			}
+		}
+	} while (changed);
+
+	return total;
+}
+
+static unsigned char *
+put32(unsigned char *q, uint32_t v)
+{
+	q[0] = (v >>  0) & 0xff;
+	q[1] = (v >>  8) & 0xff;
+	q[2] = (v >> 16) & 0xff;
+	q[3] = (v >> 24) & 0xff;
+
+	return q + 4;
+}
+
+static const unsigned char fetch[] = {
+	0x48, 0x39, 0xF7,       // cmp   %rsi,%rdi
+	0x75, 0x06              // jne   1f
+};
+
+static const unsigned char fetched[] = {
+	0x0F, 0xB6, 0x0F,       // movzbl (%rdi),%ecx
+	0x48, 0xFF, 0xC7        // inc   %rdi
+};
+
+static unsigned char *
+encode_fetch(unsigned char *q, uint32_t off, enum dfavm_op_end end_bits)
+{
+	memcpy(q, fetch, sizeof fetch);
+	q += sizeof fetch;
+
+	*q++ = 0xB8;
+	q = put32(q, (off << 2) | (end_bits == VM_END_SUCC));
+	*q++ = 0xC3;
+
+	memcpy(q, fetched, sizeof fetched);
+	q += sizeof fetched;
+
+	return q;
+}
+
+// jne to an address within the same op, given as an offset from its start
+static unsigned char *
+encode_jne(unsigned char *q, const unsigned char *start, size_t to)
+{
+	int32_t rel;
+
+	rel = (int32_t) to - (int32_t) (q + 6 - start);
+
+	*q++ = 0x0F;
+	*q++ = 0x85;
+
+	return put32(q, (uint32_t) rel);
+}
+
+static unsigned char *
+encode_matchs(unsigned char *q, const struct dfavm_vm_op *op, uint32_t off)
+{
+	static const unsigned char head[] = {
+		0x48, 0x89, 0xF0,       // mov   %rsi,%rax
+		0x48, 0x29, 0xF8,       // sub   %rdi,%rax
+		0x48, 0x83, 0xF8        // cmp   $n,%rax
+	};
+
+	const unsigned char *start = q;
+	const unsigned char *s = op->u.matchs.str;
+	unsigned n = op->u.matchs.len;
+	size_t fail, slow, next;
+	unsigned o, i;
+
+	assert(n > 0 && n <= DFAVM_MATCHS_MAX);
+
+	fail = MATCHS_HEAD_BYTES + matchs_fast_size(n) + MATCHS_TAIL_BYTES;
+	slow = fail + MATCHS_FAIL_BYTES;
+	next = slow + n * MATCHS_SLOW_BYTES;
+
+	memcpy(q, head, sizeof head);
+	q += sizeof head;
+	*q++ = n;
+
+	*q++ = 0x72; // jb
+	*q++ = (unsigned char) (slow - MATCHS_HEAD_BYTES);
+
+	for (o = 0; o < n; o += chunk(n - o)) {
+		uint64_t v;
+		unsigned k;
+
+		v = 0;
+		for (k = 0; k < chunk(n - o); k++) {
+			v |= (uint64_t) s[o + k] << (8 * k);
+		}
+
+		switch (chunk(n - o)) {
+		case 8:
+			*q++ = 0x48; *q++ = 0xB8;
+			q = put32(q, (uint32_t) v);
+			q = put32(q, (uint32_t) (v >> 32));
+			*q++ = 0x48; *q++ = 0x39; *q++ = 0x47; *q++ = o;
+			break;
+
+		case 4:
+			*q++ = 0x81; *q++ = 0x7F; *q++ = o;
+			q = put32(q, (uint32_t) v);
+			break;
+
+		case 2:
+			*q++ = 0x66; *q++ = 0x81; *q++ = 0x7F; *q++ = o;
+			*q++ = v & 0xff;
+			*q++ = (v >> 8) & 0xff;
+			break;
+
+		case 1:
+			*q++ = 0x80; *q++ = 0x7F; *q++ = o;
+			*q++ = v & 0xff;
+			break;
+		}
+
+		q = encode_jne(q, start, fail);
+	}
+
+	*q++ = 0x48; *q++ = 0x83; *q++ = 0xC7; *q++ = n;    // add   $n,%rdi
+	*q++ = 0x0F; *q++ = 0xB6; *q++ = 0x4F; *q++ = 0xFF; // movzbl -1(%rdi),%ecx
+	*q++ = 0xE9;                                        // jmp   next
+	q = put32(q, (uint32_t) (next - (q + 4 - start)));
+
+	assert((size_t) (q - start) == fail);
+
+	*q++ = 0xB8;
+	q = put32(q, 2 | VM_END_FAIL);
+	*q++ = 0xC3;
+
+	for (i = 0; i < n; i++) {
+		q = encode_fetch(q, off + (q - start), VM_END_FAIL);
+
+		*q++ = 0x80;
+		*q++ = 0xF9;
+		*q++ = s[i];
+
+		q = encode_jne(q, start, fail);
+	}
+
+	assert((size_t) (q - start) == next);
+
+	return q;
+}
+
+static unsigned char *
+encode_op(unsigned char *q, const struct dfavm_vm_op *op,
+	uint32_t off, uint32_t dest, int near)
+{
+	const unsigned char *start = q;
+
+	if (op->instr != VM_OP_FETCH && op->instr != VM_OP_MATCHS && op->cmp != VM_CMP_ALWAYS) {
+		*q++ = 0x80;
+		*q++ = 0xF9;
+		*q++ = op->cmp_arg;
+	}
+
+	switch (op->instr) {
+	case VM_OP_FETCH:
+		q = encode_fetch(q, off, op->u.fetch.end_bits);
+		break;
+
+	case VM_OP_MATCHS:
+		q = encode_matchs(q, op, off);
+		break;
+
+	case VM_OP_STOP:
+		if (op->cmp != VM_CMP_ALWAYS) {
+			*q++ = 0x70 | (cc(op->cmp) ^ 1);
+			*q++ = 0x06;
+		}
+
+		*q++ = 0xB8;
+		q = put32(q, 2 | (op->u.stop.end_bits == VM_END_SUCC));
+		*q++ = 0xC3;
+		break;
+
+	case VM_OP_BRANCH: {
+		int64_t rel;
+
+		rel = (int64_t) dest - (int64_t) (off + op_size(op, near));
+
+		if (op->cmp == VM_CMP_ALWAYS) {
+			*q++ = near ? 0xE9 : 0xEB;
+		} else if (near) {
+			*q++ = 0x0F;
+			*q++ = 0x80 | cc(op->cmp);
+		} else {
+			*q++ = 0x70 | cc(op->cmp);
+		}
+
+		if (near) {
+			assert(rel >= INT32_MIN && rel <= INT32_MAX);
+			q = put32(q, (uint32_t) (int32_t) rel);
+		} else {
+			assert(rel >= INT8_MIN && rel <= INT8_MAX);
+			*q++ = (unsigned char) (int8_t) rel;
+		}
+		break;
+	}
+	}
+
+	assert((size_t) (q - start) == op_size(op, near));
+	(void) start;
+
+	return q;
+}
+
+static void *
+map_rw(size_t len)
+{
+	void *p;
+
+#ifdef MAP_ANONYMOUS
+	p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#else
+	{
+		int fd;
+
+		fd = open("/dev/zero", O_RDWR);
+		if (fd == -1) {
+			return NULL;
+		}
+
+		p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+
+		close(fd);
+	}
+#endif
+
+	if (p == MAP_FAILED) {
+		return NULL;
+	}
+
+	return p;
+}
+
+struct fsm_dfavm *
+encode_opasm_amd64(const struct dfavm_vm_op *instr, size_t ninstr)
+{
+	static const struct fsm_dfavm zero;
+	static const unsigned char entry[] = {
+		0x89, 0xD2,                          // mov   %edx,%edx
+		0x48, 0x8D, 0x05, 0x05, 0, 0, 0,     // lea   5(%rip),%rax
+		0x48, 0x01, 0xD0,                    // add   %rdx,%rax
+		0xFF, 0xE0                           // jmp   *%rax
+	};
+
+	struct fsm_dfavm *ret;
+	uint32_t *off;
+	unsigned char *near;
+	unsigned char *code, *q;
+	size_t i, len;
+
+	assert(sizeof entry == ENTRY_BYTES);
+
+	if (ninstr == 0) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	ret  = malloc(sizeof *ret);
+	off  = malloc(ninstr * sizeof *off);
+	near = calloc(ninstr, sizeof *near);
+	if (ret == NULL || off == NULL || near == NULL) {
+		goto error;
+	}
+
+	len = layout(instr, ninstr, off, near);
+
+	// FETCH offsets are returned shifted left by two
+	if (len > UINT32_MAX >> 2) {
+		errno = EFBIG;
+		goto error;
+	}
+
+	code = map_rw(ENTRY_BYTES + len);
+	if (code == NULL) {
+		goto error;
+	}
+
+	q = code;
+
+	memcpy(q, entry, sizeof entry);
+	q += sizeof entry;
+
+	for (i = 0; i < ninstr; i++) {
+		uint32_t dest;
+
+		assert((size_t) (q - code) == ENTRY_BYTES + off[i]);
+
+		dest = 0;
+		if (instr[i].instr == VM_OP_BRANCH) {
+			dest = off[instr[i].u.br.dest_index];
+		}
+
+		q = encode_op(q, &instr[i], off[i], dest, near[i]);
+	}
+
+	if (-1 == mprotect(code, ENTRY_BYTES + len, PROT_READ | PROT_EXEC)) {
+		munmap(code, ENTRY_BYTES + len);
+		goto error;
+	}
+
+	free(off);
+	free(near);
+
+	*ret = zero;
+
+	ret->version_major = DFAVM_AMD64_MAJOR;
+	ret->version_minor = DFAVM_AMD64_MINOR;
+
+	ret->u.amd64.code = code;
+	ret->u.amd64.len  = ENTRY_BYTES + len;
+
+	return ret;
+
+error:
+
+	free(ret);
+	free(off);
+	free(near);
+
+	return NULL;
+}
+
+void
+dfavm_amd64_free(struct dfavm_amd64 *vm)
+{
+	assert(vm != NULL);
+
+	munmap(vm->code, vm->len);
+}
+
+enum dfavm_state
+vm_match_amd64(const struct dfavm_amd64 *vm, struct vm_state *st, const char *buf, size_t n)
+{
+	const unsigned char *p;
+	amd64_func *f;
+	uint32_t r;
+
+	assert(vm != NULL);
+	assert(st != NULL);
+
+	if (st->state != VM_MATCHING) {
+		return st->state;
+	}
+
+	// object to function pointer, as for dlsym()
+	assert(sizeof f == sizeof vm->code);
+	memcpy(&f, &vm->code, sizeof f);
+
+	p = (const unsigned char *) buf;
+
+	r = f(p, p + n, st->pc);
+
+	if (r & 2) {
+		st->state = (r & 1) ? VM_SUCCESS : VM_FAIL;
+		return st->state;
+	}
+
+	st->pc = r >> 2;
+	st->fetch_state = r & 1;
+
+	return VM_MATCHING;
+}
+
+#else
+
+struct fsm_dfavm *
+encode_opasm_amd64(const struct dfavm_vm_op *instr, size_t ninstr)
+{
+	(void) instr;
+	(void) ninstr;
+
+	errno = ENOTSUP;
+	return NULL;
+}
+
+void
+dfavm_amd64_free(struct dfavm_amd64 *vm)
+{
+	(void) vm;
+}
+
+enum dfavm_state
+vm_match_amd64(const struct dfavm_amd64 *vm, struct vm_state *st, const char *buf, size_t n)
+{
+	(void) vm;
+	(void) buf;
+	(void) n;
+
+	st->state = VM_FAIL;
+	return st->state;
+}
+
+#endif
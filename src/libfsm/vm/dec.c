@@ -0,0 +1,383 @@
+/*
+ * Copyright 2019 Shannon F. Stewman
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <limits.h>
+#include <string.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include "vm.h"
+
+// Pre-decoded VM:
+//
+//   Both bytecode encodings are decoded once, after encoding or loading,
+//   into an array of fixed-width ops with absolute destinations. Each op
+//   carries a single code combining its instruction and comparison, so
+//   executing an op is one dispatch, rather than decoding bit fields and
+//   then switching on the instruction and again on the comparison.
+//
+//   With GCC and clang, dispatch is by computed goto, giving each op its
+//   own indirect branch to predict. Elsewhere it's a switch statement.
+//   Define DFAVM_NO_THREADED to use the switch regardless.
+//
+//   vm_state.pc counts ops here, not bytes of bytecode. A VM which has
+//   been decoded is always executed decoded, so the two never mix.
+//
+//   MATCHS compares its string eight bytes at a time where the buffer
+//   holds enough, and otherwise as much as the buffer has, stopping with
+//   vm_state.matched set to resume from the next buffer.
+
+#if defined(__GNUC__) && !defined(DFAVM_NO_THREADED)
+#define DFAVM_THREADED 1
+#else
+#define DFAVM_THREADED 0
+#endif
+
+#define DEC_CODE(instr, cmp) (((instr) << 3) | (cmp))
+
+enum dfavm_dec_code {
+	DEC_STOP     = DEC_CODE(VM_OP_STOP,   VM_CMP_ALWAYS),
+	DEC_STOP_LT  = DEC_CODE(VM_OP_STOP,   VM_CMP_LT),
+	DEC_STOP_LE  = DEC_CODE(VM_OP_STOP,   VM_CMP_LE),
+	DEC_STOP_GE  = DEC_CODE(VM_OP_STOP,   VM_CMP_GE),
+	DEC_STOP_GT  = DEC_CODE(VM_OP_STOP,   VM_CMP_GT),
+	DEC_STOP_EQ  = DEC_CODE(VM_OP_STOP,   VM_CMP_EQ),
+	DEC_STOP_NE  = DEC_CODE(VM_OP_STOP,   VM_CMP_NE),
+
+	DEC_FETCH    = DEC_CODE(VM_OP_FETCH,  VM_CMP_ALWAYS),
+
+	DEC_BR       = DEC_CODE(VM_OP_BRANCH, VM_CMP_ALWAYS),
+	DEC_BR_LT    = DEC_CODE(VM_OP_BRANCH, VM_CMP_LT),
+	DEC_BR_LE    = DEC_CODE(VM_OP_BRANCH, VM_CMP_LE),
+	DEC_BR_GE    = DEC_CODE(VM_OP_BRANCH, VM_CMP_GE),
+	DEC_BR_GT    = DEC_CODE(VM_OP_BRANCH, VM_CMP_GT),
+	DEC_BR_EQ    = DEC_CODE(VM_OP_BRANCH, VM_CMP_EQ),
+	DEC_BR_NE    = DEC_CODE(VM_OP_BRANCH, VM_CMP_NE),
+
+	DEC_MATCHS   = DEC_CODE(VM_OP_MATCHS, VM_CMP_ALWAYS),
+
+	// every code the instruction and comparison bits can hold
+	DEC_NCODES   = DEC_CODE(VM_OP_MATCHS + 1, 0)
+};
+
+int
+dfavm_dec_alloc(struct dfavm_dec *dec, size_t n, size_t slen)
+{
+	assert(dec != NULL);
+
+	dec->ops = calloc(n > 0 ? n : 1, sizeof *dec->ops);
+	dec->str = malloc(slen > 0 ? slen : 1);
+	if (dec->ops == NULL || dec->str == NULL) {
+		free(dec->ops);
+		free(dec->str);
+		dec->ops = NULL;
+		dec->str = NULL;
+		return 0;
+	}
+
+	dec->len  = n;
+	dec->slen = slen;
+
+	return 1;
+}
+
+int
+dfavm_dec_set(struct dfavm_dec *dec, size_t i,
+	enum dfavm_op_instr instr, enum dfavm_op_cmp cmp, int arg, int end, uint32_t dest)
+{
+	struct dfavm_dec_op *op;
+
+	assert(dec != NULL);
+	assert(i < dec->len);
+
+	if (instr == VM_OP_FETCH) {
+		cmp = VM_CMP_ALWAYS;
+	}
+
+	if (instr == VM_OP_MATCHS || cmp > VM_CMP_NE || (instr == VM_OP_BRANCH && dest >= dec->len)) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	op = &dec->ops[i];
+
+	op->code = DEC_CODE(instr, cmp);
+	op->arg  = arg;
+	op->end  = end;
+	op->dest = dest;
+
+	return 1;
+}
+
+int
+dfavm_dec_set_matchs(struct dfavm_dec *dec, size_t i, uint32_t off,
+	const unsigned char *s, size_t n)
+{
+	struct dfavm_dec_op *op;
+
+	assert(dec != NULL);
+	assert(i < dec->len);
+	assert(s != NULL);
+
+	if (n == 0 || n > UCHAR_MAX || off > dec->slen || n > dec->slen - off) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	memcpy(&dec->str[off], s, n);
+
+	op = &dec->ops[i];
+
+	op->code = DEC_MATCHS;
+	op->arg  = n;
+	op->end  = VM_END_FAIL;
+	op->dest = off;
+
+	return 1;
+}
+
+int
+dfavm_decode(struct fsm_dfavm *vm)
+{
+	assert(vm != NULL);
+
+	if (vm->version_major == DFAVM_VARENC_MAJOR && vm->version_minor == DFAVM_VARENC_MINOR) {
+		return dfavm_decode_v1(&vm->u.v1, &vm->dec);
+	} else if (vm->version_major == DFAVM_FIXEDENC_MAJOR && vm->version_minor == DFAVM_FIXEDENC_MINOR) {
+		return dfavm_decode_v2(&vm->u.v2, &vm->dec);
+	}
+
+	// nothing to decode
+	return 1;
+}
+
+void
+dfavm_dec_free(struct dfavm_dec *dec)
+{
+	assert(dec != NULL);
+
+	free(dec->ops);
+	free(dec->str);
+
+	dec->ops  = NULL;
+	dec->len  = 0;
+	dec->str  = NULL;
+	dec->slen = 0;
+}
+
+// compare n bytes, eight at a time where possible
+static int
+eqbytes(const unsigned char *a, const unsigned char *b, size_t n)
+{
+	uint64_t x, y;
+	uint32_t v, w;
+
+	for ( ; n >= sizeof x; n -= sizeof x, a += sizeof x, b += sizeof x) {
+		memcpy(&x, a, sizeof x);
+		memcpy(&y, b, sizeof y);
+		if (x != y) {
+			return 0;
+		}
+	}
+
+	if (n >= sizeof v) {
+		memcpy(&v, a, sizeof v);
+		memcpy(&w, b, sizeof w);
+		if (v != w) {
+			return 0;
+		}
+
+		n -= sizeof v;
+		a += sizeof v;
+		b += sizeof v;
+	}
+
+	for ( ; n > 0; n--) {
+		if (*a++ != *b++) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+// __extension__ keeps -pedantic quiet about labels as values
+#if DFAVM_THREADED
+#define OP(code)   L_ ## code
+#define ADDR(code) __extension__ &&L_ ## code
+#define NEXT       __extension__ ({ goto *dispatch[op->code]; })
+#else
+#define OP(code)   case code
+#define NEXT       goto next
+#endif
+
+#define COND(code, cond)                                   \
+	OP(DEC_STOP_ ## code):                             \
+		if (cond) goto stop;                       \
+		op++;                                      \
+		NEXT;                                      \
+	OP(DEC_BR_ ## code):                               \
+		op = (cond) ? &ops[op->dest] : op + 1;     \
+		NEXT
+
+enum dfavm_state
+vm_match_dec(const struct dfavm_dec *vm, struct vm_state *st, const char *buf, size_t n)
+{
+#if DFAVM_THREADED
+	static const void *const dispatch[DEC_NCODES] = {
+		[DEC_STOP]    = ADDR(DEC_STOP),
+		[DEC_STOP_LT] = ADDR(DEC_STOP_LT),
+		[DEC_STOP_LE] = ADDR(DEC_STOP_LE),
+		[DEC_STOP_GE] = ADDR(DEC_STOP_GE),
+		[DEC_STOP_GT] = ADDR(DEC_STOP_GT),
+		[DEC_STOP_EQ] = ADDR(DEC_STOP_EQ),
+		[DEC_STOP_NE] = ADDR(DEC_STOP_NE),
+		[7]           = ADDR(DEC_BAD),
+		[DEC_FETCH]   = ADDR(DEC_FETCH),
+		[9]           = ADDR(DEC_BAD),
+		[10]          = ADDR(DEC_BAD),
+		[11]          = ADDR(DEC_BAD),
+		[12]          = ADDR(DEC_BAD),
+		[13]          = ADDR(DEC_BAD),
+		[14]          = ADDR(DEC_BAD),
+		[15]          = ADDR(DEC_BAD),
+		[DEC_BR]      = ADDR(DEC_BR),
+		[DEC_BR_LT]   = ADDR(DEC_BR_LT),
+		[DEC_BR_LE]   = ADDR(DEC_BR_LE),
+		[DEC_BR_GE]   = ADDR(DEC_BR_GE),
+		[DEC_BR_GT]   = ADDR(DEC_BR_GT),
+		[DEC_BR_EQ]   = ADDR(DEC_BR_EQ),
+		[DEC_BR_NE]   = ADDR(DEC_BR_NE),
+		[23]          = ADDR(DEC_BAD),
+		[DEC_MATCHS]  = ADDR(DEC_MATCHS),
+		[25]          = ADDR(DEC_BAD),
+		[26]          = ADDR(DEC_BAD),
+		[27]          = ADDR(DEC_BAD),
+		[28]          = ADDR(DEC_BAD),
+		[29]          = ADDR(DEC_BAD),
+		[30]          = ADDR(DEC_BAD),
+		[31]          = ADDR(DEC_BAD)
+	};
+#endif
+
+	const struct dfavm_dec_op *ops, *op;
+	const unsigned char *sp, *last;
+	unsigned ch;
+
+	assert(vm != NULL);
+	assert(st != NULL);
+
+	if (st->state != VM_MATCHING) {
+		return st->state;
+	}
+
+	assert(st->pc < vm->len);
+
+	ops  = vm->ops;
+	op   = &ops[st->pc];
+	ch   = 0;
+	sp   = (const unsigned char *) buf;
+	last = sp + n;
+
+#if DFAVM_THREADED
+	NEXT;
+#else
+next:
+	switch (op->code) {
+	default:
+		goto bad;
+#endif
+
+	OP(DEC_FETCH):
+		if (sp >= last) {
+			st->pc = op - ops;
+			st->fetch_state = op->end;
+			return VM_MATCHING;
+		}
+
+		ch = *sp++;
+		op++;
+		NEXT;
+
+	OP(DEC_MATCHS): {
+		const unsigned char *s;
+		size_t k;
+
+		assert(st->matched < op->arg);
+
+		s = &vm->str[op->dest + st->matched];
+		k = op->arg - st->matched;
+
+		if ((size_t) (last - sp) < k) {
+			k = last - sp;
+			if (!eqbytes(sp, s, k)) {
+				goto fail;
+			}
+
+			st->pc = op - ops;
+			st->fetch_state = VM_END_FAIL;
+			st->matched += k;
+			return VM_MATCHING;
+		}
+
+		if (!eqbytes(sp, s, k)) {
+			goto fail;
+		}
+
+		sp += k;
+		ch = sp[-1];
+		st->matched = 0;
+		op++;
+		NEXT;
+	}
+
+	OP(DEC_STOP):
+		goto stop;
+
+	OP(DEC_BR):
+		op = &ops[op->dest];
+		NEXT;
+
+	COND(LT, ch <  op->arg);
+	COND(LE, ch <= op->arg);
+	COND(GE, ch >= op->arg);
+	COND(GT, ch >  op->arg);
+	COND(EQ, ch == op->arg);
+	COND(NE, ch != op->arg);
+
+#if DFAVM_THREADED
+	L_DEC_BAD:
+		goto bad;
+#else
+	}
+#endif
+
+stop:
+
+	st->state = (op->end == VM_END_FAIL) ? VM_FAIL : VM_SUCCESS;
+	return st->state;
+
+fail:
+
+	st->state = VM_FAIL;
+	return st->state;
+
+bad:
+
+	// dfavm_dec_set() doesn't produce these
+	assert(!"unreached");
+	st->state = VM_FAIL;
+	return st->state;
+}
+
+#undef COND
+#undef NEXT
+#undef ADDR
+#undef OP
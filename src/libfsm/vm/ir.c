@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdio.h>
+#include <string.h>
 #include <errno.h>
 #include <ctype.h>
 
@@ -55,6 +56,18 @@
 //     If cond(SB,arg) is true, sets the PC to the instruction at 'dest'.
 //     Otherwise advances the PC to the next instruction.
 //
+//   MATCHS str:BYTES
+//
+//     Fetches as many bytes as are in 'str', each of which must equal the
+//     corresponding byte of 'str'.  SB is left holding the last byte.
+//     The match fails on the first byte which differs, or if the string
+//     buffer cannot be filled, as for FETCH with 'succ' false.
+//
+//     This replaces a chain of states which each have a single transition
+//     and are not end states, where each state after the first is reached
+//     only from the one before.  'str' is limited to DFAVM_MATCHS_MAX bytes,
+//     and is always followed by a BRANCH to the state the chain leads to.
+//
 // Potential future opcodes:
 //
 //   FINDB arg:BYTE succ:BOOL
@@ -76,16 +89,6 @@
 //     Like FINDB, but searches the buffer for the string 'str' instead of a byte.
 //     String is length-encoded.
 //
-//   MATCHS str:ADDR
-//
-//     Matches the bytes given by 'str' with the current bytes in the buffer.
-//     SB is set to the number of bytes that match.
-//
-//     Note that 'str' is limited to 255 bytes.
-//
-//     This instruction must be followed by BRANCH instructions to decode where
-//     the match failed.
-//
 //  TBRANCH table:ADDR
 //
 //     This is a "table branch" instruction.  The table should have 256
@@ -105,6 +108,9 @@ struct dfa_table {
 
 	const struct ir_state *ir_state;
 
+	/* per-symbol counts from the profile, or NULL */
+	const unsigned long *hits;
+
 	int nerr;
 	int ndst;
 
@@ -198,6 +204,20 @@ print_op_ir(FILE *f, struct dfavm_op_ir *op)
 		}
 		break;
 
+	case VM_OP_MATCHS:
+		{
+			unsigned i;
+
+			n = snprintf(opstr, nop, "MATCHS \"");
+			for (i = 0; i < op->u.matchs.len && n + 5 < nop; i++) {
+				unsigned char c = op->u.matchs.str[i];
+
+				n += snprintf(opstr + n, nop - n, isprint(c) && c != '"' && c != '\\' ? "%c" : "\\x%02x", c);
+			}
+			n += snprintf(opstr + n, nop - n, "\"");
+		}
+		break;
+
 	default:
 		n = snprintf(opstr, nop, "UNK_%d_%s", (int)op->instr, cmp);
 	}
@@ -510,7 +530,8 @@ xlate_table_ranges(struct dfavm_assembler_ir *a, struct dfa_table *table, struct
 		}
 	}
 
-	if (lo < FSM_SIGMA_COUNT-1) {
+	/* the final run, which may be a single symbol */
+	{
 		int64_t dst = table->tbl[lo];
 		*opp = (dst < 0)
 			? opasm_new_stop(a, VM_CMP_ALWAYS, 0, VM_END_FAIL, table->ir_state)
@@ -525,24 +546,69 @@ xlate_table_ranges(struct dfavm_assembler_ir *a, struct dfa_table *table, struct
 	return count;
 }
 
+struct sym_hits {
+	unsigned long hits;
+	int sym;
+};
+
+static int
+cmp_sym_hits(const void *a, const void *b)
+{
+	const struct sym_hits *ha = a, *hb = b;
+
+	if (ha->hits != hb->hits) {
+		return (ha->hits > hb->hits) ? -1 : +1;
+	}
+
+	return (ha->sym > hb->sym) - (ha->sym < hb->sym);
+}
+
+/*
+ * Symbols in order of decreasing frequency per the profile,
+ * or in ascending order if there is no profile.
+ */
+static void
+order_symbols(const struct dfa_table *table, int order[FSM_SIGMA_COUNT])
+{
+	struct sym_hits sh[FSM_SIGMA_COUNT];
+	int i;
+
+	for (i=0; i < FSM_SIGMA_COUNT; i++) {
+		sh[i].sym  = i;
+		sh[i].hits = (table->hits != NULL) ? table->hits[i] : 0;
+	}
+
+	if (table->hits != NULL) {
+		qsort(sh, FSM_SIGMA_COUNT, sizeof sh[0], cmp_sym_hits);
+	}
+
+	for (i=0; i < FSM_SIGMA_COUNT; i++) {
+		order[i] = sh[i].sym;
+	}
+}
+
 static int
 xlate_table_cases(struct dfavm_assembler_ir *a, struct dfa_table *table, struct dfavm_op_ir **opp)
 {
 	int i, count = 0;
 	int64_t mdst = table->mode.to;
+	int order[FSM_SIGMA_COUNT];
+
+	/* equality tests are independent, so the hottest may go first */
+	order_symbols(table, order);
 
 	for (i=0; i < FSM_SIGMA_COUNT; i++) {
 		int64_t dst;
 
-		dst = table->tbl[i];
+		dst = table->tbl[order[i]];
 
 		if (dst == mdst) {
 			continue;
 		}
 
 		*opp = (dst < 0)
-			? opasm_new_stop(a, VM_CMP_EQ, i, VM_END_FAIL, table->ir_state)
-			: opasm_new_branch(a, VM_CMP_EQ, i, dst, table->ir_state);
+			? opasm_new_stop(a, VM_CMP_EQ, order[i], VM_END_FAIL, table->ir_state)
+			: opasm_new_branch(a, VM_CMP_EQ, order[i], dst, table->ir_state);
 		if (*opp == NULL) {
 			return -1;
 		}
@@ -562,6 +628,156 @@ xlate_table_cases(struct dfavm_assembler_ir *a, struct dfa_table *table, struct
 	return count;
 }
 
+/*
+ * Equality tests for the k hottest symbols, followed by the usual chain
+ * of ranges (which still covers those symbols, but they never reach it).
+ */
+static int
+xlate_table_hot(struct dfavm_assembler_ir *a, struct dfa_table *table,
+	const int order[FSM_SIGMA_COUNT], int k, struct dfavm_op_ir **opp)
+{
+	int i, count;
+
+	for (i=0; i < k; i++) {
+		const int64_t dst = table->tbl[order[i]];
+
+		*opp = (dst < 0)
+			? opasm_new_stop(a, VM_CMP_EQ, order[i], VM_END_FAIL, table->ir_state)
+			: opasm_new_branch(a, VM_CMP_EQ, order[i], dst, table->ir_state);
+		if (*opp == NULL) {
+			return -1;
+		}
+		opp = &(*opp)->next;
+	}
+
+	count = xlate_table_ranges(a, table, opp);
+	if (count < 0) {
+		return -1;
+	}
+
+	return k + count;
+}
+
+static int
+cmp_holds(enum dfavm_op_cmp cmp, int arg, int c)
+{
+	switch (cmp) {
+	case VM_CMP_ALWAYS: return 1;
+	case VM_CMP_LT:     return c <  arg;
+	case VM_CMP_LE:     return c <= arg;
+	case VM_CMP_GE:     return c >= arg;
+	case VM_CMP_GT:     return c >  arg;
+	case VM_CMP_EQ:     return c == arg;
+	case VM_CMP_NE:     return c != arg;
+
+	default:
+		assert(!"unreached");
+		return 0;
+	}
+}
+
+/*
+ * Attribute each symbol's hits to the first instruction in the chain
+ * whose condition holds for it, and return the number of comparisons
+ * made over all hits. Every symbol also carries a nominal weight, as if
+ * it were seen once in FSM_SIGMA_COUNT times the sample, so that symbols
+ * absent from the sample still count for something and the paths they
+ * take aren't made arbitrarily long.
+ */
+static uint64_t
+chain_hits(struct dfavm_op_ir *ops, const unsigned long *hits)
+{
+	struct dfavm_op_ir *op;
+	uint64_t cost;
+	int c;
+
+	assert(hits != NULL);
+
+	for (op = ops; op != NULL; op = op->next) {
+		op->hits = 0;
+	}
+
+	cost = 0;
+
+	for (c=0; c < FSM_SIGMA_COUNT; c++) {
+		unsigned n;
+
+		for (op = ops, n = 1; op != NULL; op = op->next, n++) {
+			if (cmp_holds(op->cmp, op->cmp_arg, c)) {
+				op->hits += hits[c];
+				cost += (uint64_t) n * ((uint64_t) hits[c] * FSM_SIGMA_COUNT + 1);
+				break;
+			}
+		}
+
+		/* every chain ends with an unconditional instruction */
+		assert(op != NULL);
+	}
+
+	return cost;
+}
+
+/* the number of hot symbols to consider testing ahead of a range chain */
+#define HOT_MAX 8
+
+/*
+ * With a profile, pick whichever chain makes the fewest comparisons
+ * over the sample input: ranges, cases ordered by frequency, or ranges
+ * preceded by tests for the hottest few symbols.
+ */
+static int
+translate_table_profiled(struct dfavm_assembler_ir *a, struct dfa_table *table, struct dfavm_op_ir **opp)
+{
+	struct dfavm_op_ir *op, *best_op;
+	int order[FSM_SIGMA_COUNT];
+	uint64_t cost, best_cost;
+	int k;
+
+	assert(table->hits != NULL);
+
+	best_op = NULL;
+	if (xlate_table_ranges(a, table, &best_op) < 0) {
+		return -1;
+	}
+	best_cost = chain_hits(best_op, table->hits);
+
+	op = NULL;
+	if (xlate_table_cases(a, table, &op) < 0) {
+		return -1;
+	}
+	cost = chain_hits(op, table->hits);
+
+	if (cost < best_cost) {
+		opasm_free_list(a, best_op);
+		best_op = op;
+		best_cost = cost;
+	} else {
+		opasm_free_list(a, op);
+	}
+
+	order_symbols(table, order);
+
+	for (k=1; k <= HOT_MAX && table->hits[order[k-1]] > 0; k++) {
+		op = NULL;
+		if (xlate_table_hot(a, table, order, k, &op) < 0) {
+			return -1;
+		}
+		cost = chain_hits(op, table->hits);
+
+		if (cost < best_cost) {
+			opasm_free_list(a, best_op);
+			best_op = op;
+			best_cost = cost;
+		} else {
+			opasm_free_list(a, op);
+		}
+	}
+
+	*opp = best_op;
+
+	return 0;
+}
+
 static int
 initial_translate_table(struct dfavm_assembler_ir *a, struct dfa_table *table, struct dfavm_op_ir **opp)
 {
@@ -606,6 +822,10 @@ initial_translate_table(struct dfavm_assembler_ir *a, struct dfa_table *table, s
 		return 0;
 	}
 
+	if (table->hits != NULL) {
+		return translate_table_profiled(a, table, opp);
+	}
+
 	best_op = NULL;
 	best_count = xlate_table_ranges(a, table, &best_op);
 
@@ -652,7 +872,8 @@ group_to_table(struct dfa_table *table, const struct ir_group *grp)
 }
 
 static void
-dfa_table_init(struct dfa_table *table, long default_dest, const struct ir_state *ir_state)
+dfa_table_init(struct dfa_table *table, long default_dest, const struct ir_state *ir_state,
+	const unsigned long *hits)
 {
 	static const struct dfa_table zero;
 	int i;
@@ -662,6 +883,7 @@ dfa_table_init(struct dfa_table *table, long default_dest, const struct ir_state
 	*table = zero;
 
 	table->ir_state = ir_state;
+	table->hits = hits;
 
 	for (i=0; i < FSM_SIGMA_COUNT; i++) {
 		table->tbl[i] = default_dest;
@@ -669,14 +891,15 @@ dfa_table_init(struct dfa_table *table, long default_dest, const struct ir_state
 }
 
 static int
-initial_translate_partial(struct dfavm_assembler_ir *a, struct ir_state *st, struct dfavm_op_ir **opp)
+initial_translate_partial(struct dfavm_assembler_ir *a, struct ir_state *st, const unsigned long *hits,
+	struct dfavm_op_ir **opp)
 {
 	struct dfa_table table;
 	size_t i, ngrps;
 
 	assert(st->strategy == IR_PARTIAL);
 
-	dfa_table_init(&table, -1, st);
+	dfa_table_init(&table, -1, st, hits);
 
 	ngrps = st->u.partial.n;
 	for (i=0; i < ngrps; i++) {
@@ -687,14 +910,15 @@ initial_translate_partial(struct dfavm_assembler_ir *a, struct ir_state *st, str
 }
 
 static int
-initial_translate_dominant(struct dfavm_assembler_ir *a, struct ir_state *st, struct dfavm_op_ir **opp)
+initial_translate_dominant(struct dfavm_assembler_ir *a, struct ir_state *st, const unsigned long *hits,
+	struct dfavm_op_ir **opp)
 {
 	struct dfa_table table;
 	size_t i, ngrps;
 
 	assert(st->strategy == IR_DOMINANT);
 
-	dfa_table_init(&table, st->u.dominant.mode, st);
+	dfa_table_init(&table, st->u.dominant.mode, st, hits);
 
 	ngrps = st->u.dominant.n;
 	for (i=0; i < ngrps; i++) {
@@ -705,14 +929,15 @@ initial_translate_dominant(struct dfavm_assembler_ir *a, struct ir_state *st, st
 }
 
 static int
-initial_translate_error(struct dfavm_assembler_ir *a, struct ir_state *st, struct dfavm_op_ir **opp)
+initial_translate_error(struct dfavm_assembler_ir *a, struct ir_state *st, const unsigned long *hits,
+	struct dfavm_op_ir **opp)
 {
 	struct dfa_table table;
 	size_t i, ngrps;
 
 	assert(st->strategy == IR_ERROR);
 
-	dfa_table_init(&table, st->u.error.mode, st);
+	dfa_table_init(&table, st->u.error.mode, st, hits);
 
 	error_to_table(&table, &st->u.error.error);
 
@@ -724,21 +949,240 @@ initial_translate_error(struct dfavm_assembler_ir *a, struct ir_state *st, struc
 	return initial_translate_table(a, &table, opp);
 }
 
+enum chain_mark {
+	CHAIN_NONE,
+	CHAIN_HEAD,
+	CHAIN_TAIL
+};
+
+/*
+ * The byte for a state with a single transition, and which is not an end
+ * state, or -1 otherwise.
+ */
+static int
+single_sym(const struct ir_state *st, unsigned *to)
+{
+	const struct ir_group *grp;
+
+	if (st->isend || st->strategy != IR_PARTIAL || st->u.partial.n != 1) {
+		return -1;
+	}
+
+	grp = &st->u.partial.groups[0];
+	if (grp->n != 1 || grp->ranges[0].start != grp->ranges[0].end) {
+		return -1;
+	}
+
+	*to = grp->to;
+
+	return grp->ranges[0].start;
+}
+
+static void
+count_incoming(const struct ir *ir, unsigned *incoming)
+{
+	size_t i, j;
+
+	for (i=0; i < ir->n; i++) {
+		const struct ir_state *st = &ir->states[i];
+		const struct ir_group *groups;
+		size_t ngroups;
+
+		groups  = NULL;
+		ngroups = 0;
+
+		switch (st->strategy) {
+		case IR_SAME:
+			incoming[st->u.same.to]++;
+			break;
+
+		case IR_COMPLETE:
+			groups  = st->u.complete.groups;
+			ngroups = st->u.complete.n;
+			break;
+
+		case IR_PARTIAL:
+			groups  = st->u.partial.groups;
+			ngroups = st->u.partial.n;
+			break;
+
+		case IR_DOMINANT:
+			incoming[st->u.dominant.mode]++;
+			groups  = st->u.dominant.groups;
+			ngroups = st->u.dominant.n;
+			break;
+
+		case IR_ERROR:
+			incoming[st->u.error.mode]++;
+			groups  = st->u.error.groups;
+			ngroups = st->u.error.n;
+			break;
+
+		default:
+			break;
+		}
+
+		for (j=0; j < ngroups; j++) {
+			incoming[groups[j].to]++;
+		}
+	}
+}
+
+/*
+ * Mark chains of states with a single transition each. The states after
+ * the head of a chain are reached only from the state before, and so
+ * their bytes can be matched together with the head's by one MATCHS.
+ * A chain longer than DFAVM_MATCHS_MAX continues from a new head.
+ */
+static unsigned char *
+find_chains(const struct ir *ir)
+{
+	unsigned char *mark;
+	unsigned *incoming;
+	unsigned to, next;
+	size_t i;
+
+	mark     = calloc(ir->n, sizeof *mark);
+	incoming = calloc(ir->n, sizeof *incoming);
+	if (mark == NULL || incoming == NULL) {
+		free(mark);
+		free(incoming);
+		return NULL;
+	}
+
+	count_incoming(ir, incoming);
+
+	for (i=0; i < ir->n; i++) {
+		if (single_sym(&ir->states[i], &to) == -1) {
+			continue;
+		}
+
+		if (to != ir->start && incoming[to] == 1 && single_sym(&ir->states[to], &next) != -1) {
+			mark[to] = CHAIN_TAIL;
+		}
+	}
+
+	for (i=0; i < ir->n; i++) {
+		unsigned len;
+
+		if (mark[i] == CHAIN_TAIL || single_sym(&ir->states[i], &to) == -1) {
+			continue;
+		}
+
+		mark[i] = CHAIN_HEAD;
+
+		/* each tail has only the one predecessor, so is seen once */
+		for (len = 1; mark[to] == CHAIN_TAIL; len++) {
+			if (len == DFAVM_MATCHS_MAX) {
+				mark[to] = CHAIN_HEAD;
+				len = 0;
+			}
+
+			(void) single_sym(&ir->states[to], &to);
+		}
+	}
+
+	free(incoming);
+
+	return mark;
+}
+
+/*
+ * MATCHS for the bytes of a chain from its head, followed by a branch to
+ * the state after. Returns 0 if the chain is too short to be worthwhile.
+ */
+static int
+initial_translate_chain(struct dfavm_assembler_ir *a, const struct ir *ir, const unsigned char *mark,
+	size_t ind, struct dfavm_op_ir **opp)
+{
+	unsigned char str[DFAVM_MATCHS_MAX];
+	unsigned to, len;
+	size_t t;
+
+	assert(mark[ind] == CHAIN_HEAD);
+
+	t = ind;
+	len = 0;
+
+	do {
+		assert(len < sizeof str);
+
+		str[len++] = single_sym(&ir->states[t], &to);
+		t = to;
+	} while (mark[t] == CHAIN_TAIL);
+
+	if (len < 2) {
+		return 0;
+	}
+
+	*opp = opasm_new(a, VM_OP_MATCHS, VM_CMP_ALWAYS, 0, &ir->states[ind]);
+	if (*opp == NULL) {
+		return -1;
+	}
+
+	memcpy((*opp)->u.matchs.str, str, len);
+	(*opp)->u.matchs.len = len;
+
+	if (a->profile != NULL) {
+		(*opp)->hits = a->profile->state_hits[ind];
+	}
+
+	opp = &(*opp)->next;
+
+	*opp = opasm_new_branch(a, VM_CMP_ALWAYS, 0, t, &ir->states[ind]);
+	if (*opp == NULL) {
+		return -1;
+	}
+
+	(*opp)->hits = a->ops[ind]->hits;
+
+	return 1;
+}
+
 static struct dfavm_op_ir *
-initial_translate_state(struct dfavm_assembler_ir *a, const struct ir *ir, size_t ind)
+initial_translate_state(struct dfavm_assembler_ir *a, const struct ir *ir, const unsigned char *mark,
+	size_t ind)
 {
 	struct ir_state *st;
 	struct dfavm_op_ir **opp;
+	const unsigned long *hits;
 
 	st = &ir->states[ind];
 	opp = &a->ops[ind];
 
-	if (st->isend && st->strategy == IR_SAME && st->u.same.to == ind) {
-		*opp = opasm_new_stop(a, VM_CMP_ALWAYS, 0, VM_END_SUCC, st);
+	hits = (a->profile != NULL) ? a->profile->sym_hits[ind] : NULL;
+
+	if (mark != NULL && mark[ind] == CHAIN_TAIL) {
+		/* matched by the MATCHS at the head of its chain */
+		return NULL;
+	}
+
+	if (mark != NULL && mark[ind] == CHAIN_HEAD) {
+		int r;
+
+		r = initial_translate_chain(a, ir, mark, ind, opp);
+		if (r < 0) {
+			return NULL;
+		}
+
+		if (r > 0) {
+			return a->ops[ind];
+		}
+	}
+
+	// the outcome is decided on entry, so stop without fetching
+	if (st->absorbing) {
+		*opp = opasm_new_stop(a, VM_CMP_ALWAYS, 0, st->isend ? VM_END_SUCC : VM_END_FAIL, st);
+		if (*opp != NULL && a->profile != NULL) {
+			(*opp)->hits = a->profile->state_hits[ind];
+		}
 		return a->ops[ind];
 	}
 
 	*opp = opasm_new_fetch(a, ind, (st->isend) ? VM_END_SUCC : VM_END_FAIL, st);
+	if (*opp != NULL && a->profile != NULL) {
+		(*opp)->hits = a->profile->state_hits[ind];
+	}
 	opp = &(*opp)->next;
 	assert(*opp == NULL);
 
@@ -761,19 +1205,19 @@ initial_translate_state(struct dfavm_assembler_ir *a, const struct ir *ir, size_
 	 * intelligently.
 	 */
 	case IR_PARTIAL:
-		if (initial_translate_partial(a, st, opp) < 0) {
+		if (initial_translate_partial(a, st, hits, opp) < 0) {
 			return NULL;
 		}
 		break;
 
 	case IR_DOMINANT:
-		if (initial_translate_dominant(a, st, opp) < 0) {
+		if (initial_translate_dominant(a, st, hits, opp) < 0) {
 			return NULL;
 		}
 		break;
 
 	case IR_ERROR:
-		if (initial_translate_error(a, st, opp) < 0) {
+		if (initial_translate_error(a, st, hits, opp) < 0) {
 			return NULL;
 		}
 		break;
@@ -788,18 +1232,25 @@ initial_translate_state(struct dfavm_assembler_ir *a, const struct ir *ir, size_
 		abort();
 	}
 
+	if (hits != NULL) {
+		(void) chain_hits(a->ops[ind]->next, hits);
+	}
+
 	return a->ops[ind];
 }
 
 static int
-initial_translate(const struct ir *ir, struct dfavm_assembler_ir *a)
+initial_translate(const struct ir *ir, struct dfavm_assembler_ir *a, const unsigned char *mark)
 {
 	size_t i,n;
 
 	n = a->nstates;
 
 	for (i=0; i < n; i++) {
-		a->ops[i] = initial_translate_state(a, ir, i);
+		a->ops[i] = initial_translate_state(a, ir, mark, i);
+		if (a->ops[i] == NULL && (mark == NULL || mark[i] != CHAIN_TAIL)) {
+			return -1;
+		}
 	}
 
 	return 0;
@@ -820,6 +1271,7 @@ fixup_dests(struct dfavm_assembler_ir *a)
 			}
 
 			op->u.br.dest_arg = a->ops[op->u.br.dest_state];
+			assert(op->u.br.dest_arg != NULL);
 			op->u.br.dest_arg->num_incoming++;
 		}
 	}
@@ -940,32 +1392,69 @@ eliminate_unnecessary_branches(struct dfavm_assembler_ir *a)
 	} while (count > 0);
 }
 
-static void
+struct state_hits {
+	unsigned long hits;
+	size_t ind;
+};
+
+static int
+cmp_state_hits(const void *a, const void *b)
+{
+	const struct state_hits *ha = a, *hb = b;
+
+	if (ha->hits != hb->hits) {
+		return (ha->hits > hb->hits) ? -1 : +1;
+	}
+
+	return (ha->ind > hb->ind) - (ha->ind < hb->ind);
+}
+
+/*
+ * Lay out states as traces: each state is followed by the destination of
+ * its hottest branch which isn't already placed, or without a profile,
+ * of its last such branch (often the unconditional one). When a trace
+ * ends, the next begins at the hottest state not yet placed, or without
+ * a profile, the lowest numbered.
+ */
+static int
 order_basic_blocks(struct dfavm_assembler_ir *a)
 {
-	size_t i,n;
+	size_t i,n,next,nseeds;
 	struct dfavm_op_ir **opp;
+	struct state_hits *seeds;
 	struct dfavm_op_ir *st;
 
-	/* replace this with something that actually
-	 * orders basic blocks ...
-	 */
-
 	n = a->nstates;
 
-	/* mark all states as !in_trace */
-	for (i=0; i < n; i++) {
+	seeds = malloc(n * sizeof *seeds);
+	if (seeds == NULL) {
+		return 0;
+	}
+
+	/* mark all states as !in_trace, except those with no code of their own */
+	for (i=0, nseeds=0; i < n; i++) {
+		if (a->ops[i] == NULL) {
+			continue;
+		}
+
 		a->ops[i]->in_trace = 0;
+		seeds[nseeds].hits = a->ops[i]->hits;
+		seeds[nseeds].ind  = i;
+		nseeds++;
+	}
+
+	if (a->profile != NULL) {
+		qsort(seeds, nseeds, sizeof *seeds, cmp_state_hits);
 	}
 
 	opp = &a->linked;
 	*opp = NULL;
 
+	next = 0;
+
 	st = a->ops[a->start];
 	while (st != NULL) {
-		struct dfavm_op_ir *branches[FSM_SIGMA_COUNT];  /* at most FSM_SIGMA_COUNT branches per state */
 		struct dfavm_op_ir *instr;
-		size_t j,count;
 
 		/* add state to trace */
 		*opp = st;
@@ -976,36 +1465,47 @@ order_basic_blocks(struct dfavm_assembler_ir *a)
 
 		st->in_trace = 1;
 
-		/* look for branches to states not in the trace.
-		 * Start at the last branch and work toward the first.
+		/* look for branches to states not in the trace. The last such
+		 * branch wins ties, hence >= here.
 		 */
-		count = 0;
-		for (instr=st; instr != NULL; instr=instr->next) {
-			if (instr->instr == VM_OP_BRANCH) {
-				branches[count++] = instr;
-			}
-			assert(count <= sizeof branches/sizeof branches[0]);
-		}
+		{
+			struct dfavm_op_ir *best;
 
-		st = NULL;
-		for (j=count; j > 0; j--) {
-			struct dfavm_op_ir *dest = branches[j-1]->u.br.dest_arg;
-			if (!dest->in_trace) {
-				st = dest;
-				break;
+			best = NULL;
+			for (instr=st; instr != NULL; instr=instr->next) {
+				struct dfavm_op_ir *dest;
+
+				if (instr->instr != VM_OP_BRANCH) {
+					continue;
+				}
+
+				dest = instr->u.br.dest_arg;
+				if (dest->in_trace) {
+					continue;
+				}
+
+				if (best == NULL || instr->hits >= best->hits) {
+					best = instr;
+				}
 			}
+
+			st = (best != NULL) ? best->u.br.dest_arg : NULL;
 		}
 
 		if (st == NULL) {
-			/* look for a new state ... */
-			for (j=0; j < n; j++) {
-				if (!a->ops[j]->in_trace) {
-					st = a->ops[j];
+			/* look for a new state; everything before next is placed */
+			for ( ; next < nseeds; next++) {
+				if (!a->ops[seeds[next].ind]->in_trace) {
+					st = a->ops[seeds[next].ind];
 					break;
 				}
 			}
 		}
 	}
+
+	free(seeds);
+
+	return 1;
 }
 
 static uint32_t
@@ -1054,8 +1554,16 @@ print_all_states(struct dfavm_assembler_ir *a)
 int
 dfavm_compile_ir(struct dfavm_assembler_ir *a, const struct ir *ir, struct fsm_vm_compile_opts opts)
 {
+	unsigned char *mark;
+
 	a->nstates = ir->n;
 	a->start = ir->start;
+	a->profile = opts.profile;
+
+	if (a->profile != NULL && a->profile->nstates != ir->n) {
+		errno = EINVAL;
+		return 0;
+	}
 
 	(void)dump_states; /* make clang happy */
 	(void)print_all_states;
@@ -1065,10 +1573,21 @@ dfavm_compile_ir(struct dfavm_assembler_ir *a, const struct ir *ir, struct fsm_v
 		return 0;
 	}
 
-	if (initial_translate(ir, a) < 0) {
+	mark = NULL;
+	if (opts.flags & FSM_VM_COMPILE_MATCHS) {
+		mark = find_chains(ir);
+		if (mark == NULL) {
+			return 0;
+		}
+	}
+
+	if (initial_translate(ir, a, mark) < 0) {
+		free(mark);
 		return 0;
 	}
 
+	free(mark);
+
 	fixup_dests(a);
 
 	if (opts.flags & FSM_VM_COMPILE_PRINT_IR_PREOPT) {
@@ -1079,7 +1598,9 @@ dfavm_compile_ir(struct dfavm_assembler_ir *a, const struct ir *ir, struct fsm_v
 		fprintf(f, "\n");
 	}
 
-	order_basic_blocks(a);
+	if (!order_basic_blocks(a)) {
+		return 0;
+	}
 
 	/* basic optimizations */
 	if (opts.flags & FSM_VM_COMPILE_OPTIM) {
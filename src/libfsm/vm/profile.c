@@ -0,0 +1,134 @@
+/*
+ * Copyright 2019 Shannon F. Stewman
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <errno.h>
+
+#include <fsm/fsm.h>
+#include <fsm/pred.h>
+#include <fsm/walk.h>
+#include <fsm/vm.h>
+
+#include <adt/alloc.h>
+#include <adt/edgeset.h>
+
+#include "libfsm/internal.h"
+
+#include "vm.h"
+
+// Profiling walks the DFA itself rather than running the VM, so that
+// counts are per state and per symbol, independent of how the code for
+// each state happens to be laid out.
+
+struct fsm_vm_profile *
+fsm_vm_profile_new(const struct fsm *fsm)
+{
+	struct fsm_vm_profile *p;
+
+	assert(fsm != NULL);
+	assert(fsm->opt != NULL);
+
+	if (!fsm_all(fsm, fsm_isdfa)) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	p = f_malloc(fsm->opt->alloc, sizeof *p);
+	if (p == NULL) {
+		return NULL;
+	}
+
+	p->alloc   = fsm->opt->alloc;
+	p->nstates = fsm->statecount;
+
+	p->state_hits = f_calloc(p->alloc, p->nstates + 1, sizeof *p->state_hits);
+	if (p->state_hits == NULL) {
+		goto error;
+	}
+
+	p->sym_hits = f_calloc(p->alloc, p->nstates + 1, sizeof *p->sym_hits);
+	if (p->sym_hits == NULL) {
+		goto error;
+	}
+
+	return p;
+
+error:
+
+	f_free(p->alloc, p->state_hits);
+	f_free(p->alloc, p);
+
+	return NULL;
+}
+
+void
+fsm_vm_profile_free(struct fsm_vm_profile *p)
+{
+	size_t i;
+
+	if (p == NULL) {
+		return;
+	}
+
+	for (i = 0; i < p->nstates; i++) {
+		f_free(p->alloc, p->sym_hits[i]);
+	}
+
+	f_free(p->alloc, p->sym_hits);
+	f_free(p->alloc, p->state_hits);
+	f_free(p->alloc, p);
+}
+
+int
+fsm_vm_profile_buffer(struct fsm_vm_profile *p, const struct fsm *fsm,
+	const char *buf, size_t n)
+{
+	fsm_state_t state;
+	size_t i;
+
+	assert(p != NULL);
+	assert(fsm != NULL);
+	assert(buf != NULL || n == 0);
+
+	if (fsm->statecount != p->nstates) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	if (!fsm_getstart(fsm, &state)) {
+		errno = EINVAL;
+		return -1;
+	}
+
+	for (i = 0; i < n; i++) {
+		const unsigned char c = (unsigned char) buf[i];
+
+		// one per FETCH
+		p->state_hits[state]++;
+
+		if (p->sym_hits[state] == NULL) {
+			p->sym_hits[state] = f_calloc(p->alloc, FSM_SIGMA_COUNT, sizeof *p->sym_hits[state]);
+			if (p->sym_hits[state] == NULL) {
+				return -1;
+			}
+		}
+
+		p->sym_hits[state][c]++;
+
+		if (!edge_set_transition(fsm->states[state].edges, c, &state)) {
+			return 0;
+		}
+	}
+
+	// the FETCH which finds the end of input
+	p->state_hits[state]++;
+
+	return fsm_isend(fsm, state);
+}
@@ -10,6 +10,7 @@
 #include <stdint.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <errno.h>
 
 #include "vm.h"
 
@@ -103,7 +104,7 @@ encode_opasm_v1(const struct dfavm_vm_op *instr, size_t ninstr, size_t total_byt
 	vm->len = total_bytes;
 
 	for (off = 0, i = 0; i < ninstr; i++) {
-		unsigned char bytes[6];
+		unsigned char bytes[2 + DFAVM_MATCHS_MAX];
 		unsigned char cmp_bits, instr_bits, rest_bits;
 		const struct dfavm_vm_op *op = &instr[i];
 		int nb = 1;
@@ -188,6 +189,18 @@ encode_opasm_v1(const struct dfavm_vm_op *instr, size_t ninstr, size_t total_byt
 
 			break;
 
+		case VM_OP_MATCHS:
+			instr_bits = 0x3;
+
+			if (op->cmp != VM_CMP_ALWAYS || op->u.matchs.len > DFAVM_MATCHS_MAX) {
+				goto error;
+			}
+
+			bytes[nb++] = op->u.matchs.len;
+			memcpy(&bytes[nb], op->u.matchs.str, op->u.matchs.len);
+			nb += op->u.matchs.len;
+			break;
+
 		default:
 			goto error;
 		}
@@ -299,6 +312,21 @@ running_print_op_v1(const unsigned char *ops, uint32_t pc, const char *sp, const
 		}
 		break;
 
+	case VM_OP_MATCHS:
+		{
+			int i, len = ops[pc+1];
+
+			fprintf(f, "MATCHS \"");
+			for (i = 0; i < len; i++) {
+				int c = ops[pc+2+i];
+				fprintf(f, isprint(c) ? "%c" : "\\x%02x", c);
+			}
+			fprintf(f, "\"\n");
+
+			pc += 1 + len;
+		}
+		break;
+
 	default:
 		fprintf(f, "UNK\n");
 	}
@@ -344,6 +372,27 @@ vm_match_v1(const struct dfavm_v1 *vm, struct vm_state *st, const char *buf, siz
 
 			ch = (unsigned char) *sp++;
 			st->pc++;
+		} else if (op == VM_OP_MATCHS) {
+			uint32_t i, len;
+
+			len = vm->ops[st->pc+1];
+
+			for (i = st->matched; i < len; i++) {
+				if (sp >= last) {
+					st->matched = i;
+					st->fetch_state = VM_END_FAIL;
+					return VM_MATCHING;
+				}
+
+				ch = (unsigned char) *sp++;
+				if (ch != vm->ops[st->pc+2+i]) {
+					st->state = VM_FAIL;
+					return st->state;
+				}
+			}
+
+			st->matched = 0;
+			st->pc += 2 + len;
 		} else {
 			int cmp, end, dest, dest_nbytes;
 			int result;
@@ -415,3 +464,149 @@ vm_match_v1(const struct dfavm_v1 *vm, struct vm_state *st, const char *buf, siz
 	return VM_FAIL;
 }
 
+
+static uint32_t
+op_len_v1(const struct dfavm_v1 *vm, uint32_t pc)
+{
+	uint32_t len;
+	unsigned char b;
+	int op;
+
+	b  = vm->ops[pc];
+	op = (b>>3)&0x03;
+	if (op == VM_OP_FETCH) {
+		return 1;
+	}
+
+	if (op == VM_OP_MATCHS) {
+		/* past the end, for a truncated length */
+		return (pc + 1 < vm->len) ? (uint32_t) (2 + vm->ops[pc+1]) : (uint32_t) (vm->len - pc + 1);
+	}
+
+	len = 1;
+	if ((b >> 5) != VM_CMP_ALWAYS) {
+		len++;
+	}
+
+	if (op == VM_OP_BRANCH) {
+		len += 1 << (b & 0x3);
+	}
+
+	return len;
+}
+
+int
+dfavm_decode_v1(const struct dfavm_v1 *vm, struct dfavm_dec *dec)
+{
+	uint32_t *index;
+	uint32_t pc, soff;
+	size_t n, slen;
+
+	/* op index by pc, for resolving relative destinations */
+	index = malloc((vm->len + 1) * sizeof *index);
+	if (index == NULL) {
+		return 0;
+	}
+
+	for (pc = 0; pc <= vm->len; pc++) {
+		index[pc] = UINT32_MAX;
+	}
+
+	n = 0;
+	slen = 0;
+	for (pc = 0; pc < vm->len; pc += op_len_v1(vm, pc)) {
+		if (((vm->ops[pc]>>3)&0x03) == VM_OP_MATCHS) {
+			slen += op_len_v1(vm, pc) - 2;
+		}
+
+		index[pc] = n++;
+	}
+
+	if (pc != vm->len) {
+		errno = EINVAL;
+		goto error;
+	}
+
+	if (!dfavm_dec_alloc(dec, n, slen)) {
+		goto error;
+	}
+
+	soff = 0;
+
+	for (pc = 0; pc < vm->len; pc += op_len_v1(vm, pc)) {
+		unsigned char b;
+		uint32_t off, dest;
+		int op, cmp, arg;
+
+		b   = vm->ops[pc];
+		op  = (b>>3)&0x03;
+		cmp = b >> 5;
+		off = pc + 1;
+
+		if (op == VM_OP_MATCHS) {
+			if (!dfavm_dec_set_matchs(dec, index[pc], soff, &vm->ops[pc+2], vm->ops[pc+1])) {
+				goto error_dec;
+			}
+
+			soff += vm->ops[pc+1];
+			continue;
+		}
+
+		arg = 0;
+		if (op != VM_OP_FETCH && cmp != VM_CMP_ALWAYS) {
+			arg = vm->ops[off++];
+		}
+
+		dest = 0;
+		if (op == VM_OP_BRANCH) {
+			int64_t rel;
+
+			switch (b & 0x3) {
+			case 0:
+				rel = (int8_t) vm->ops[off];
+				break;
+
+			case 1:
+				rel = (int16_t) (vm->ops[off] | (vm->ops[off+1] << 8));
+				break;
+
+			default:
+				rel = (int32_t) ((uint32_t) vm->ops[off] | ((uint32_t) vm->ops[off+1] << 8)
+					| ((uint32_t) vm->ops[off+2] << 16) | ((uint32_t) vm->ops[off+3] << 24));
+				break;
+			}
+
+			if ((int64_t) pc + rel < 0 || (int64_t) pc + rel >= vm->len
+				|| index[pc + rel] == UINT32_MAX)
+			{
+				errno = EINVAL;
+				goto error_dec;
+			}
+
+			dest = index[pc + rel];
+		}
+
+		if (op == VM_OP_FETCH || op == VM_OP_STOP || op == VM_OP_BRANCH) {
+			if (!dfavm_dec_set(dec, index[pc], op, cmp, arg, b & 0x01, dest)) {
+				goto error_dec;
+			}
+		} else {
+			errno = EINVAL;
+			goto error_dec;
+		}
+	}
+
+	free(index);
+
+	return 1;
+
+error_dec:
+
+	dfavm_dec_free(dec);
+
+error:
+
+	free(index);
+
+	return 0;
+}
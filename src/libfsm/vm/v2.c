@@ -9,6 +9,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <ctype.h>
+#include <errno.h>
 
 #include "vm.h"
 
@@ -23,8 +24,45 @@ enum dfavm_vm_op_v2 {
 	// Branch to another state
 	VM_V2_OP_BRANCH  = 2,
 	VM_V2_OP_IBRANCH = 3,
+
+	// Match a string, held in the address buffer
+	VM_V2_OP_MATCHS  = 4,
 };
 
+static int
+grow_abuf(struct dfavm_v2 *vm, uint32_t **abuf, uint32_t *acap, uint32_t need)
+{
+	size_t new_acap;
+	uint32_t *new_abuf;
+
+	if (need <= *acap) {
+		return 1;
+	}
+
+	new_acap = *acap;
+	while (new_acap < need) {
+		if (new_acap < 16) {
+			new_acap = 16;
+		} else if (new_acap < 1024) {
+			new_acap = new_acap * 2;
+		} else {
+			new_acap = new_acap + new_acap/2;
+		}
+	}
+
+	new_abuf = realloc(*abuf, new_acap * sizeof **abuf);
+	if (new_abuf == NULL) {
+		return 0;
+	}
+
+	*abuf = new_abuf;
+	*acap = new_acap;
+
+	vm->abuf = new_abuf;
+
+	return 1;
+}
+
 struct fsm_dfavm *
 encode_opasm_v2(const struct dfavm_vm_op *instr, size_t ninstr)
 {
@@ -90,27 +128,8 @@ encode_opasm_v2(const struct dfavm_vm_op *instr, size_t ninstr)
 					/* allocate address in address table */
 					instr_bits = VM_V2_OP_IBRANCH;
 
-					if (alen >= acap) {
-						size_t new_acap;
-						uint32_t *new_abuf;
-
-						if (acap < 16) {
-							new_acap = 16;
-						} else if (acap < 1024) {
-							new_acap = acap * 2;
-						} else {
-							new_acap = acap + acap/2;
-						}
-
-						new_abuf = realloc(abuf, new_acap * sizeof abuf[0]);
-						if (new_abuf == NULL) {
-							goto error;
-						}
-
-						abuf = new_abuf;
-						acap = new_acap;
-
-						vm->abuf = new_abuf;
+					if (!grow_abuf(vm, &abuf, &acap, alen + 1)) {
+						goto error;
 					}
 
 					assert(alen < acap);
@@ -126,6 +145,39 @@ encode_opasm_v2(const struct dfavm_vm_op *instr, size_t ninstr)
 				result_bit = 0;
 			}
 			break;
+
+		case VM_OP_MATCHS:
+			{
+				unsigned j, len;
+
+				len = op->u.matchs.len;
+
+				/* the string is packed four bytes to a word, LSB first */
+				if (alen > UINT16_MAX || !grow_abuf(vm, &abuf, &acap, alen + (len + 3) / 4)) {
+					goto error;
+				}
+
+				for (j = 0; j < len; j += 4) {
+					abuf[alen + j/4] = 0;
+				}
+
+				for (j = 0; j < len; j++) {
+					abuf[alen + j/4] |= (uint32_t) op->u.matchs.str[j] << (8 * (j % 4));
+				}
+
+				instr_bits = VM_V2_OP_MATCHS;
+				cmp_bits   = 0;
+				cmp_arg    = len;
+				result_bit = 0;
+				dest_arg   = alen;
+
+				alen += (len + 3) / 4;
+				vm->alen = alen;
+			}
+			break;
+
+		default:
+			goto error;
 		}
 
 		if (cmp_bits > 7) {
@@ -226,12 +278,22 @@ running_print_op_v2(const struct dfavm_v2 *vm, uint32_t pc, const char *sp, cons
 		}
 		break;
 
+	case VM_V2_OP_MATCHS:
+		fprintf(f, "MATCHS %d index=%d\n", arg, dest);
+		break;
+
 	default:
 		fprintf(f, "UNK[op=%d cmp=%d end=%d arg=%d dest=%d]\n", op,cmp,end,arg, dest);
 		break;
 	}
 }
 
+static unsigned char
+matchs_byte(const struct dfavm_v2 *vm, uint32_t index, uint32_t i)
+{
+	return (vm->abuf[index + i/4] >> (8 * (i % 4))) & 0xff;
+}
+
 enum dfavm_state
 vm_match_v2(const struct dfavm_v2 *vm, struct vm_state *st, const char *buf, size_t n)
 {
@@ -267,6 +329,25 @@ vm_match_v2(const struct dfavm_v2 *vm, struct vm_state *st, const char *buf, siz
 
 			ch = (unsigned char) *sp++;
 			st->pc++;
+		} else if (op == VM_V2_OP_MATCHS) {
+			uint32_t i;
+
+			for (i = st->matched; i < (uint32_t) arg; i++) {
+				if (sp >= last) {
+					st->matched = i;
+					st->fetch_state = VM_END_FAIL;
+					return VM_MATCHING;
+				}
+
+				ch = (unsigned char) *sp++;
+				if (ch != matchs_byte(vm, dest, i)) {
+					st->state = VM_FAIL;
+					return st->state;
+				}
+			}
+
+			st->matched = 0;
+			st->pc++;
 		} else {
 			int result;
 
@@ -319,3 +400,107 @@ vm_match_v2(const struct dfavm_v2 *vm, struct vm_state *st, const char *buf, siz
 	return VM_FAIL;
 }
 
+
+int
+dfavm_decode_v2(const struct dfavm_v2 *vm, struct dfavm_dec *dec)
+{
+	uint32_t pc, soff;
+	size_t slen;
+
+	slen = 0;
+	for (pc = 0; pc < vm->len; pc++) {
+		if ((vm->ops[pc] >> 28) == VM_V2_OP_MATCHS) {
+			slen += (vm->ops[pc] >> 16) & 0xff;
+		}
+	}
+
+	if (!dfavm_dec_alloc(dec, vm->len, slen)) {
+		return 0;
+	}
+
+	soff = 0;
+
+	for (pc = 0; pc < vm->len; pc++) {
+		int op, cmp, end, arg, dest;
+		int64_t to;
+
+		V2DEC(vm->ops[pc], op,cmp,end, arg, dest);
+
+		to = 0;
+
+		switch (op) {
+		case VM_V2_OP_MATCHS:
+			{
+				unsigned char str[256];
+				int i;
+
+				if ((uint64_t) dest + (arg + 3) / 4 > vm->alen) {
+					goto error;
+				}
+
+				for (i = 0; i < arg; i++) {
+					str[i] = matchs_byte(vm, dest, i);
+				}
+
+				if (!dfavm_dec_set_matchs(dec, pc, soff, str, arg)) {
+					dfavm_dec_free(dec);
+					return 0;
+				}
+
+				soff += arg;
+			}
+			continue;
+
+		case VM_V2_OP_STOP:
+			op = VM_OP_STOP;
+			break;
+
+		case VM_V2_OP_FETCH:
+			op = VM_OP_FETCH;
+			break;
+
+		case VM_V2_OP_BRANCH:
+			{
+				union {
+					uint16_t u;
+					int16_t  rel;
+				} packed;
+
+				packed.u = dest;
+				to = (int64_t) pc + packed.rel;
+				op = VM_OP_BRANCH;
+			}
+			break;
+
+		case VM_V2_OP_IBRANCH:
+			if ((uint32_t) dest >= vm->alen) {
+				goto error;
+			}
+
+			to = vm->abuf[dest];
+			op = VM_OP_BRANCH;
+			break;
+
+		default:
+			goto error;
+		}
+
+		if (to < 0 || to >= vm->len) {
+			goto error;
+		}
+
+		if (!dfavm_dec_set(dec, pc, op, cmp, arg, end, to)) {
+			dfavm_dec_free(dec);
+			return 0;
+		}
+	}
+
+	return 1;
+
+error:
+
+	dfavm_dec_free(dec);
+	errno = EINVAL;
+
+	return 0;
+}
@@ -22,12 +22,13 @@
 //
 // Fixed encoding VM state:
 //
-//   The VM address buffer holds addresses for indirect branches.
+//   The VM address buffer holds addresses for indirect branches,
+//   and strings for MATCHS.
 //
 // VM bytecodes:
 //
-//   There are four instructions:
-//     BRANCH, IBRANCH, FETCH, and STOP.
+//   There are five instructions:
+//     BRANCH, IBRANCH, FETCH, STOP, and MATCHS.
 //
 //   Each instruction is 32-bits, encoded as follows:
 //
@@ -38,6 +39,7 @@
 //     FETCH      0001 000 R   00000000  0000 0000 0000 0000
 //     BRANCH     0010 CCC 0   AAAAAAAA  DDDD DDDD DDDD DDDD
 //     IBRANCH    0011 CCC 0   AAAAAAAA  IIII IIII IIII IIII
+//     MATCHS     0100 000 0   LLLLLLLL  IIII IIII IIII IIII
 //
 //                IIII CCC R
 //
@@ -56,6 +58,9 @@
 //             which holds a 32-bit unsigned value stored in the address buffer.
 //             The argument is the address buffer entry.
 //
+//   MATCHS matches L bytes, packed four to a word from address buffer
+//   entry I, least significant byte first.
+//
 // Instructions are encoded into 4 bytes.  The first byte holds the instruction
 // type, the condition (if applicable) and the success argument (if applicable).
 // The remaining three bytes depend on the instruction:
@@ -129,6 +134,12 @@
 //
 //   DD=11 is reserved for future use
 //
+// MATCHS - match string instructions
+//
+//   In the variable length encoding, MATCHS is followed by a byte giving
+//   the length of its string, then the string itself. Comparison bits are
+//   00 (always).
+//
 
 struct dfavm_assembler_vm {
 	struct dfavm_vm_op *instr;
@@ -175,6 +186,10 @@ print_vm_op(FILE *f, struct dfavm_vm_op *op)
 		}
 		break;
 
+	case VM_OP_MATCHS:
+		fprintf(f, "MATCHS %u", (unsigned)op->u.matchs.len);
+		break;
+
 	default:
 		fprintf(f, "UNK_%d_%s", (int)op->instr, cmp);
 	}
@@ -243,6 +258,11 @@ op_encoding_size(struct dfavm_vm_op *op, int max_enc)
 		nbytes++;
 	}
 
+	if (op->instr == VM_OP_MATCHS) {
+		// length, then the string
+		nbytes += 1 + op->u.matchs.len;
+	}
+
 	if (op->instr == VM_OP_BRANCH) {
 		int32_t rel_dest = op->u.br.rel_dest;
 		if (!max_enc && rel_dest >= min_dest_1b && rel_dest <= max_dest_1b) {
@@ -294,6 +314,10 @@ build_vm_op(const struct dfavm_op_ir *ir, struct dfavm_vm_op *op)
 		op->u.br.rel_dest = 0;
 
 		break;
+
+	case VM_OP_MATCHS:
+		op->u.matchs = ir->u.matchs;
+		break;
 	}
 }
 
@@ -353,7 +377,7 @@ assign_rel_dests(struct dfavm_assembler_vm *a)
 
 		nenc = op_encoding_size(op, 1);
 
-		assert(nenc > 0 && nenc <= 6);
+		assert(nenc > 0 && nenc <= 2 + DFAVM_MATCHS_MAX);
 
 		op->offset = off;
 		op->num_encoded_bytes = nenc;
@@ -456,12 +480,21 @@ dfavm_compile_vm(const struct dfavm_assembler_ir *a, struct fsm_vm_compile_opts
 	case FSM_VM_COMPILE_VM_V2:
 		vm = encode_opasm_v2(b.instr, b.ninstr);
 		break;
+
+	case FSM_VM_COMPILE_AMD64:
+		vm = encode_opasm_amd64(b.instr, b.ninstr);
+		break;
 	}
 
 	if (vm == NULL) {
 		goto error;
 	}
 
+	if (!dfavm_decode(vm)) {
+		fsm_vm_free(vm);
+		goto error;
+	}
+
 	free(b.instr);
 
 	return vm;
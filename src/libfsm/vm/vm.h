@@ -17,6 +17,10 @@
 #define DFAVM_FIXEDENC_MAJOR 0x00
 #define DFAVM_FIXEDENC_MINOR 0x02
 
+// native code, which is never saved
+#define DFAVM_AMD64_MAJOR 0x01
+#define DFAVM_AMD64_MINOR 0x00
+
 #define DFAVM_MAGIC "DFAVM$"
 
 struct ir;
@@ -34,8 +38,15 @@ enum dfavm_op_instr {
 
 	// Branch to another state
 	VM_OP_BRANCH = 2,
+
+	// Match a string of bytes, each fetched in turn.  Fails on
+	// a mismatch or EOS.
+	VM_OP_MATCHS = 3,
 };
 
+// the longest string for a single MATCHS
+#define DFAVM_MATCHS_MAX 16
+
 enum dfavm_op_cmp {
 	VM_CMP_ALWAYS = 0,
 	VM_CMP_LT     = 1,
@@ -58,6 +69,11 @@ enum dfavm_op_dest {
 	VM_DEST_FAR   = 3,  // 32-bit dest
 };
 
+struct dfavm_matchs {
+	unsigned char str[DFAVM_MATCHS_MAX];
+	unsigned char len;
+};
+
 struct dfavm_op_ir {
 	struct dfavm_op_ir *next;
 
@@ -81,6 +97,10 @@ struct dfavm_op_ir {
 	int in_trace;
 	int cmp_arg;
 
+	// times this instruction was reached (for a FETCH), or its
+	// condition held (otherwise), per the profile; zero if no profile
+	unsigned long hits;
+
 	enum dfavm_op_cmp cmp;
 	enum dfavm_op_instr instr;
 
@@ -98,6 +118,8 @@ struct dfavm_op_ir {
 			struct dfavm_op_ir *dest_arg;
 			uint32_t dest_state;
 		} br;
+
+		struct dfavm_matchs matchs;
 	} u;
 };
 
@@ -124,6 +146,8 @@ struct dfavm_vm_op {
 			enum dfavm_op_dest dest;
 			int32_t  rel_dest;
 		} br;
+
+		struct dfavm_matchs matchs;
 	} u;
 
 	unsigned char cmp_arg;
@@ -140,6 +164,18 @@ struct dfavm_assembler_ir {
 	size_t nstates;
 	size_t start;
 	uint32_t count;
+
+	const struct fsm_vm_profile *profile;
+};
+
+// Per-state counts from matching sample input, indexed by state
+// number. sym_hits[s] is NULL for states never entered.
+struct fsm_vm_profile {
+	const struct fsm_alloc *alloc;
+	size_t nstates;
+
+	unsigned long *state_hits;
+	unsigned long **sym_hits;
 };
 
 enum dfavm_io_result {
@@ -165,6 +201,29 @@ struct dfavm_v2 {
 	uint32_t len;
 };
 
+struct dfavm_amd64 {
+	void *code;
+	size_t len;
+};
+
+// Pre-decoded form of either bytecode encoding, for execution.
+// code combines the instruction and comparison; dest is an op index,
+// or for MATCHS, the offset of its string in str, and arg its length.
+struct dfavm_dec_op {
+	uint32_t dest;
+	unsigned char code;
+	unsigned char arg;
+	unsigned char end;
+};
+
+struct dfavm_dec {
+	struct dfavm_dec_op *ops;
+	size_t len;
+
+	unsigned char *str;
+	size_t slen;
+};
+
 enum dfavm_state {
 	VM_FAIL     = -1,
 	VM_MATCHING =  0,
@@ -175,6 +234,9 @@ struct vm_state {
 	uint32_t pc;
 	enum dfavm_state state;
 	int fetch_state;
+
+	// bytes matched so far, when stopped part way through a MATCHS
+	uint32_t matched;
 };
 
 struct fsm_dfavm {
@@ -184,7 +246,11 @@ struct fsm_dfavm {
 	union {
 		struct dfavm_v1 v1;
 		struct dfavm_v2 v2;
+		struct dfavm_amd64 amd64;
 	} u;
+
+	// ops == NULL if not decoded
+	struct dfavm_dec dec;
 };
 
 const char * 
@@ -220,5 +286,33 @@ running_print_op_v2(const struct dfavm_v2 *vm, uint32_t pc, const char *sp, cons
 enum dfavm_state
 vm_match_v2(const struct dfavm_v2 *vm, struct vm_state *st, const char *buf, size_t n);
 
+/* pre-decoded */
+int
+dfavm_dec_alloc(struct dfavm_dec *dec, size_t n, size_t slen);
+int
+dfavm_dec_set(struct dfavm_dec *dec, size_t i,
+	enum dfavm_op_instr instr, enum dfavm_op_cmp cmp, int arg, int end, uint32_t dest);
+int
+dfavm_dec_set_matchs(struct dfavm_dec *dec, size_t i, uint32_t off,
+	const unsigned char *s, size_t n);
+int
+dfavm_decode(struct fsm_dfavm *vm);
+void
+dfavm_dec_free(struct dfavm_dec *dec);
+int
+dfavm_decode_v1(const struct dfavm_v1 *vm, struct dfavm_dec *dec);
+int
+dfavm_decode_v2(const struct dfavm_v2 *vm, struct dfavm_dec *dec);
+enum dfavm_state
+vm_match_dec(const struct dfavm_dec *vm, struct vm_state *st, const char *buf, size_t n);
+
+/* amd64 */
+struct fsm_dfavm *
+encode_opasm_amd64(const struct dfavm_vm_op *instr, size_t ninstr);
+void
+dfavm_amd64_free(struct dfavm_amd64 *vm);
+enum dfavm_state
+vm_match_amd64(const struct dfavm_amd64 *vm, struct vm_state *st, const char *buf, size_t n);
+
 #endif
 
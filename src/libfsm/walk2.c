@@ -10,6 +10,7 @@
 #include <string.h>
 #include <limits.h>
 #include <errno.h>
+#include <stdio.h>
 
 #include <fsm/fsm.h>
 #include <fsm/options.h>
@@ -17,8 +18,11 @@
 #include <fsm/pred.h>
 #include <fsm/walk.h>
 
+#include <print/esc.h>
+
 #include <adt/alloc.h>
 #include <adt/set.h>
+#include <adt/bitmap.h>
 #include <adt/stateset.h>
 #include <adt/edgeset.h>
 #include <adt/tupleset.h>
@@ -326,12 +330,103 @@ fsm_walk2_tuple_new(struct fsm_walk2_data *data,
 	return p;
 }
 
+static int
+fsm_walk2_edges(struct fsm_walk2_data *data,
+	const struct fsm *a, const struct fsm *b, struct fsm_walk2_tuple *start);
+
+static int
+fsm_walk2_bulk(struct fsm_walk2_data *data,
+	const struct fsm *a, const struct fsm *b, fsm_state_t qc,
+	const struct bm *symbols,
+	const struct fsm *fsm_a, fsm_state_t sa,
+	const struct fsm *fsm_b, fsm_state_t sb)
+{
+	struct fsm_walk2_tuple *dst;
+
+	if (bm_count(symbols) == 0) {
+		return 1;
+	}
+
+	dst = fsm_walk2_tuple_new(data, fsm_a, sa, fsm_b, sb);
+	if (dst == NULL) {
+		return 0;
+	}
+
+	assert(dst->comb < data->new->statecount);
+
+	if (!edge_set_add_bulk(&data->new->states[qc].edges, data->new->opt->alloc, symbols, dst->comb)) {
+		return 0;
+	}
+
+	if (!data->new->states[dst->comb].visited) {
+		if (!fsm_walk2_edges(data, a, b, dst)) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+/*
+ * Symbols with no explicit edge from either qa or qb go to the same
+ * combined state, depending only on which of qa and qb have a default
+ * edge for that symbol. So these are walked once for each of the three
+ * possible combinations, rather than once per symbol.
+ */
+static int
+fsm_walk2_defaults(struct fsm_walk2_data *data,
+	const struct fsm *a, const struct fsm *b,
+	int have_qa, fsm_state_t qa, int have_qb, fsm_state_t qb, fsm_state_t qc,
+	const struct bm *explicit)
+{
+	struct bm ma, mb, both, only_a, only_b;
+	fsm_state_t da = 0, db = 0;
+	size_t i;
+
+	if (!have_qa || !edge_set_default(a->states[qa].edges, &ma, &da)) {
+		bm_clear(&ma);
+	}
+
+	if (!have_qb || !edge_set_default(b->states[qb].edges, &mb, &db)) {
+		bm_clear(&mb);
+	}
+
+	for (i = 0; i < sizeof explicit->map; i++) {
+		const unsigned char rest = ~explicit->map[i];
+
+		both.map[i]   =  ma.map[i] &  mb.map[i] & rest;
+		only_a.map[i] =  ma.map[i] & ~mb.map[i] & rest;
+		only_b.map[i] = ~ma.map[i] &  mb.map[i] & rest;
+	}
+
+	if (data->edgemask & (FSM_WALK2_BOTH|FSM_WALK2_ONLYA)) {
+		if (!fsm_walk2_bulk(data, a, b, qc, &both, a, da, b, db)) {
+			return 0;
+		}
+	}
+
+	if (data->edgemask & FSM_WALK2_ONLYA) {
+		if (!fsm_walk2_bulk(data, a, b, qc, &only_a, a, da, NULL, 0)) {
+			return 0;
+		}
+	}
+
+	if (data->edgemask & FSM_WALK2_ONLYB) {
+		if (!fsm_walk2_bulk(data, a, b, qc, &only_b, NULL, 0, b, db)) {
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
 static int
 fsm_walk2_edges(struct fsm_walk2_data *data,
 	const struct fsm *a, const struct fsm *b, struct fsm_walk2_tuple *start)
 {
 	fsm_state_t qa, qb, qc;
 	int have_qa, have_qb;
+	struct bm explicit;
 	int i;
 
 	assert(a != NULL);
@@ -363,6 +458,33 @@ fsm_walk2_edges(struct fsm_walk2_data *data,
 	/* mark combined state as visited */
 	data->new->states[qc].visited = 1;
 
+	/*
+	 * Only the symbols with explicit edges are walked one by one;
+	 * the others are all taken care of by their default edges.
+	 */
+	{
+		struct edge_iter it;
+		struct fsm_edge e;
+
+		bm_clear(&explicit);
+
+		if (have_qa) {
+			for (edge_set_reset_explicit(a->states[qa].edges, &it); edge_set_next(&it, &e); ) {
+				bm_set(&explicit, e.symbol);
+			}
+		}
+
+		if (have_qb) {
+			for (edge_set_reset_explicit(b->states[qb].edges, &it); edge_set_next(&it, &e); ) {
+				bm_set(&explicit, e.symbol);
+			}
+		}
+
+		if (!fsm_walk2_defaults(data, a, b, have_qa, qa, have_qb, qb, qc, &explicit)) {
+			return 0;
+		}
+	}
+
 	/*
 	 * fsm_walk2_edges walks the edges of two graphs, generating combined
 	 * states.
@@ -408,7 +530,8 @@ fsm_walk2_edges(struct fsm_walk2_data *data,
 	}
 
 	/* take care of only A and both A&B edges */
-	for (i = 0; i <= FSM_SIGMA_MAX; i++) {
+	i = -1;
+	while (i = bm_next(&explicit, i, 1), i <= UCHAR_MAX) {
 		struct fsm_walk2_tuple *dst;
 		fsm_state_t eas, ebs;
 		int have_ebs;
@@ -463,7 +586,8 @@ only_b:
 	}
 
 	/* take care of only B edges */
-	for (i = 0; i <= FSM_SIGMA_MAX; i++) {
+	i = -1;
+	while (i = bm_next(&explicit, i, 1), i <= UCHAR_MAX) {
 		struct fsm_walk2_tuple *dst;
 		fsm_state_t ebs;
 
@@ -24,16 +24,197 @@
 static struct ast_expr the_tombstone;
 struct ast_expr *ast_expr_tombstone = &the_tombstone;
 
+/*
+ * Chunks are allocated at this size, or larger for a single large
+ * allocation. The first chunk holds a typical regexp's tree entirely.
+ */
+#define ARENA_CHUNK 4096
+
+union arena_align {
+	void *p;
+	long l;
+	double d;
+	size_t z;
+	uint32_t u;
+};
+
+struct arena_chunk {
+	struct arena_chunk *next;
+	size_t size; /* bytes in a[] */
+	union arena_align a[];
+};
+
+struct re_arena {
+	struct arena_chunk *used;  /* the current chunk first */
+	struct arena_chunk *spare; /* emptied by re_arena_clear() */
+	char *p; /* free space in the current chunk, from p up to e */
+	char *e;
+};
+
+struct re_arena *
+re_arena_new(void)
+{
+	struct re_arena *arena;
+
+	arena = malloc(sizeof *arena);
+	if (arena == NULL) {
+		return NULL;
+	}
+
+	arena->used  = NULL;
+	arena->spare = NULL;
+	arena->p     = NULL;
+	arena->e     = NULL;
+
+	return arena;
+}
+
+static void
+free_chunks(struct arena_chunk *c)
+{
+	struct arena_chunk *next;
+
+	for ( ; c != NULL; c = next) {
+		next = c->next;
+		free(c);
+	}
+}
+
+void
+re_arena_free(struct re_arena *arena)
+{
+	if (arena == NULL) {
+		return;
+	}
+
+	free_chunks(arena->used);
+	free_chunks(arena->spare);
+	free(arena);
+}
+
+void
+re_arena_clear(struct re_arena *arena)
+{
+	struct arena_chunk *c, *next;
+
+	assert(arena != NULL);
+
+	for (c = arena->used; c != NULL; c = next) {
+		next = c->next;
+		c->next = arena->spare;
+		arena->spare = c;
+	}
+
+	arena->used = NULL;
+	arena->p    = NULL;
+	arena->e    = NULL;
+}
+
+static size_t
+arena_round(size_t n)
+{
+	return (n + sizeof (union arena_align) - 1)
+		/ sizeof (union arena_align) * sizeof (union arena_align);
+}
+
+void *
+re_arena_alloc(struct re_arena *arena, size_t n)
+{
+	void *p;
+
+	assert(arena != NULL);
+
+	n = arena_round(n);
+
+	if ((size_t) (arena->e - arena->p) < n) {
+		struct arena_chunk *c;
+
+		/* only the first spare is tried; chunks are mostly ARENA_CHUNK */
+		if (arena->spare != NULL && arena->spare->size >= n) {
+			c = arena->spare;
+			arena->spare = c->next;
+		} else {
+			size_t size;
+
+			size = n > ARENA_CHUNK ? n : ARENA_CHUNK;
+
+			c = malloc(sizeof *c + size);
+			if (c == NULL) {
+				return NULL;
+			}
+
+			c->size = size;
+		}
+
+		c->next = arena->used;
+		arena->used = c;
+
+		arena->p = (char *) c->a;
+		arena->e = (char *) c->a + c->size;
+	}
+
+	p = arena->p;
+	arena->p += n;
+
+	return p;
+}
+
+void *
+re_arena_realloc(struct re_arena *arena, void *p, size_t old, size_t n)
+{
+	void *q;
+
+	assert(arena != NULL);
+	assert(p != NULL);
+	assert(n >= old);
+
+	/* the most recent allocation can grow in place */
+	if ((char *) p + arena_round(old) == arena->p
+	 && (size_t) (arena->e - (char *) p) >= arena_round(n)) {
+		arena->p = (char *) p + arena_round(n);
+		return p;
+	}
+
+	q = re_arena_alloc(arena, n);
+	if (q == NULL) {
+		return NULL;
+	}
+
+	memcpy(q, p, old);
+
+	return q;
+}
+
+static struct ast_expr *
+new_expr(struct re_arena *arena, enum ast_expr_type type)
+{
+	struct ast_expr *res;
+
+	res = re_arena_alloc(arena, sizeof *res);
+	if (res == NULL) {
+		return NULL;
+	}
+
+	memset(res, 0x00, sizeof *res);
+
+	res->type = type;
+
+	return res;
+}
+
 struct ast *
-ast_new(void)
+ast_new(struct re_arena *arena)
 {
 	struct ast *res;
 
-	res = calloc(1, sizeof *res);
+	res = re_arena_alloc(arena, sizeof *res);
 	if (res == NULL) {
 		return NULL;
 	}
 
+	res->expr  = NULL;
+	res->arena = arena;
+
 	/* XXX: not thread-safe */
 	the_tombstone.type = AST_EXPR_TOMBSTONE;
 
@@ -43,8 +224,7 @@ ast_new(void)
 void
 ast_free(struct ast *ast)
 {
-	ast_expr_free(ast->expr);
-	free(ast);
+	re_arena_free(ast->arena);
 }
 
 struct ast_count
@@ -72,67 +252,6 @@ ast_make_count(unsigned min, const struct ast_pos *start,
  * Expressions
  */
 
-void
-ast_expr_free(struct ast_expr *n)
-{
-	if (n == NULL) {
-		return;
-	}
-	
-	switch (n->type) {
-	case AST_EXPR_EMPTY:
-	case AST_EXPR_LITERAL:
-	case AST_EXPR_CODEPOINT:
-	case AST_EXPR_FLAGS:
-	case AST_EXPR_ANCHOR:
-	case AST_EXPR_RANGE:
-		/* these nodes have no subnodes or dynamic allocation */
-		break;
-
-	case AST_EXPR_SUBTRACT:
-		ast_expr_free(n->u.subtract.a);
-		ast_expr_free(n->u.subtract.b);
-		break;
-
-	case AST_EXPR_CONCAT: {
-		size_t i;
-
-		for (i = 0; i < n->u.concat.count; i++) {
-			ast_expr_free(n->u.concat.n[i]);
-		}
-
-		free(n->u.concat.n);
-		break;
-	}
-
-	case AST_EXPR_ALT: {
-		size_t i;
-
-		for (i = 0; i < n->u.alt.count; i++) {
-			ast_expr_free(n->u.alt.n[i]);
-		}
-		break;
-	}
-
-	case AST_EXPR_REPEAT:
-		ast_expr_free(n->u.repeat.e);
-		break;
-
-	case AST_EXPR_GROUP:
-		ast_expr_free(n->u.group.e);
-		break;
-
-	case AST_EXPR_TOMBSTONE:
-		/* do not free */
-		return;
-
-	default:
-		assert(!"unreached");
-	}
-
-	free(n);
-}
-
 static int
 ast_class_cmp(const struct class *a, const struct class *b)
 {
@@ -353,37 +472,26 @@ ast_contains_expr(const struct ast_expr *node, struct ast_expr * const *a, size_
 }
 
 struct ast_expr *
-ast_make_expr_empty(void)
+ast_make_expr_empty(struct re_arena *arena)
 {
-	struct ast_expr *res;
-
-	res = calloc(1, sizeof *res);
-	if (res == NULL) {
-		return NULL;
-	}
-
-	res->type = AST_EXPR_EMPTY;
-
-	return res;
+	return new_expr(arena, AST_EXPR_EMPTY);
 }
 
 struct ast_expr *
-ast_make_expr_concat(void)
+ast_make_expr_concat(struct re_arena *arena)
 {
 	struct ast_expr *res;
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_CONCAT);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_CONCAT;
 	res->u.concat.alloc = 8; /* arbitrary initial value */
 	res->u.concat.count = 0;
 
-	res->u.concat.n = malloc(res->u.concat.alloc * sizeof *res->u.concat.n);
+	res->u.concat.n = re_arena_alloc(arena, res->u.concat.alloc * sizeof *res->u.concat.n);
 	if (res->u.concat.n == NULL) {
-		free(res);
 		return NULL;
 	}
 
@@ -391,7 +499,7 @@ ast_make_expr_concat(void)
 }
 
 int
-ast_add_expr_concat(struct ast_expr *cat, struct ast_expr *node)
+ast_add_expr_concat(struct re_arena *arena, struct ast_expr *cat, struct ast_expr *node)
 {
 	assert(cat != NULL);
 	assert(cat->type == AST_EXPR_CONCAT);
@@ -399,7 +507,9 @@ ast_add_expr_concat(struct ast_expr *cat, struct ast_expr *node)
 	if (cat->u.concat.count == cat->u.concat.alloc) {
 		void *tmp;
 
-		tmp = realloc(cat->u.concat.n, cat->u.concat.alloc * 2 * sizeof *cat->u.concat.n);
+		tmp = re_arena_realloc(arena, cat->u.concat.n,
+			cat->u.concat.alloc * sizeof *cat->u.concat.n,
+			cat->u.concat.alloc * 2 * sizeof *cat->u.concat.n);
 		if (tmp == NULL) {
 			return 0;
 		}
@@ -415,22 +525,20 @@ ast_add_expr_concat(struct ast_expr *cat, struct ast_expr *node)
 }
 
 struct ast_expr *
-ast_make_expr_alt(void)
+ast_make_expr_alt(struct re_arena *arena)
 {
 	struct ast_expr *res;
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_ALT);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_ALT;
 	res->u.alt.alloc = 8; /* arbitrary initial value */
 	res->u.alt.count = 0;
 
-	res->u.alt.n = malloc(res->u.alt.alloc * sizeof *res->u.alt.n);
+	res->u.alt.n = re_arena_alloc(arena, res->u.alt.alloc * sizeof *res->u.alt.n);
 	if (res->u.alt.n == NULL) {
-		free(res);
 		return NULL;
 	}
 
@@ -438,7 +546,7 @@ ast_make_expr_alt(void)
 }
 
 int
-ast_add_expr_alt(struct ast_expr *cat, struct ast_expr *node)
+ast_add_expr_alt(struct re_arena *arena, struct ast_expr *cat, struct ast_expr *node)
 {
 	assert(cat != NULL);
 	assert(cat->type == AST_EXPR_ALT);
@@ -446,7 +554,9 @@ ast_add_expr_alt(struct ast_expr *cat, struct ast_expr *node)
 	if (cat->u.alt.count == cat->u.alt.alloc) {
 		void *tmp;
 
-		tmp = realloc(cat->u.alt.n, cat->u.alt.alloc * 2 * sizeof *cat->u.alt.n);
+		tmp = re_arena_realloc(arena, cat->u.alt.n,
+			cat->u.alt.alloc * sizeof *cat->u.alt.n,
+			cat->u.alt.alloc * 2 * sizeof *cat->u.alt.n);
 		if (tmp == NULL) {
 			return 0;
 		}
@@ -462,39 +572,37 @@ ast_add_expr_alt(struct ast_expr *cat, struct ast_expr *node)
 }
 
 struct ast_expr *
-ast_make_expr_literal(char c)
+ast_make_expr_literal(struct re_arena *arena, char c)
 {
 	struct ast_expr *res;
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_LITERAL);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_LITERAL;
 	res->u.literal.c = c;
 
 	return res;
 }
 
 struct ast_expr *
-ast_make_expr_codepoint(uint32_t u)
+ast_make_expr_codepoint(struct re_arena *arena, uint32_t u)
 {
 	struct ast_expr *res;
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_CODEPOINT);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_CODEPOINT;
 	res->u.codepoint.u = u;
 
 	return res;
 }
 
 struct ast_expr *
-ast_make_expr_repeat(struct ast_expr *e, struct ast_count count)
+ast_make_expr_repeat(struct re_arena *arena, struct ast_expr *e, struct ast_count count)
 {
 	struct ast_expr *res = NULL;
 
@@ -505,12 +613,11 @@ ast_make_expr_repeat(struct ast_expr *e, struct ast_count count)
 		return NULL;
 	}
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_REPEAT);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_REPEAT;
 	res->u.repeat.e = e;
 	res->u.repeat.min = count.min;
 	res->u.repeat.max = count.max;
@@ -519,16 +626,15 @@ ast_make_expr_repeat(struct ast_expr *e, struct ast_count count)
 }
 
 struct ast_expr *
-ast_make_expr_group(struct ast_expr *e)
+ast_make_expr_group(struct re_arena *arena, struct ast_expr *e)
 {
 	struct ast_expr *res;
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_GROUP);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_GROUP;
 	res->u.group.e = e;
 	res->u.group.id = NO_GROUP_ID; /* not yet assigned */
 
@@ -536,16 +642,15 @@ ast_make_expr_group(struct ast_expr *e)
 }
 
 struct ast_expr *
-ast_make_expr_re_flags(enum re_flags pos, enum re_flags neg)
+ast_make_expr_re_flags(struct re_arena *arena, enum re_flags pos, enum re_flags neg)
 {
 	struct ast_expr *res;
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_FLAGS);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_FLAGS;
 	res->u.flags.pos = pos;
 	res->u.flags.neg = neg;
 
@@ -553,32 +658,30 @@ ast_make_expr_re_flags(enum re_flags pos, enum re_flags neg)
 }
 
 struct ast_expr *
-ast_make_expr_anchor(enum ast_anchor_type type)
+ast_make_expr_anchor(struct re_arena *arena, enum ast_anchor_type type)
 {
 	struct ast_expr *res;
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_ANCHOR);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_ANCHOR;
 	res->u.anchor.type = type;
 
 	return res;
 }
 
 struct ast_expr *
-ast_make_expr_subtract(struct ast_expr *a, struct ast_expr *b)
+ast_make_expr_subtract(struct re_arena *arena, struct ast_expr *a, struct ast_expr *b)
 {
 	struct ast_expr *res;
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_SUBTRACT);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_SUBTRACT;
 	res->u.subtract.a = a;
 	res->u.subtract.b = b;
 
@@ -586,12 +689,13 @@ ast_make_expr_subtract(struct ast_expr *a, struct ast_expr *b)
 }
 
 struct ast_expr *
-ast_make_expr_range(const struct ast_endpoint *from, struct ast_pos start,
-    const struct ast_endpoint *to, struct ast_pos end)
+ast_make_expr_range(struct re_arena *arena,
+	const struct ast_endpoint *from, struct ast_pos start,
+	const struct ast_endpoint *to, struct ast_pos end)
 {
 	struct ast_expr *res;
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_RANGE);
 	if (res == NULL) {
 		return NULL;
 	}
@@ -599,7 +703,6 @@ ast_make_expr_range(const struct ast_endpoint *from, struct ast_pos start,
 	assert(from != NULL);
 	assert(to != NULL);
 
-	res->type = AST_EXPR_RANGE;
 	res->u.range.from = *from;
 	res->u.range.start = start;
 	res->u.range.to = *to;
@@ -609,37 +712,35 @@ ast_make_expr_range(const struct ast_endpoint *from, struct ast_pos start,
 }
 
 struct ast_expr *
-ast_make_expr_named(const struct class *class)
+ast_make_expr_named(struct re_arena *arena, const struct class *class)
 {
 	struct ast_expr *res;
 	size_t i;
 
 	assert(class != NULL);
 
-	res = calloc(1, sizeof *res);
+	res = new_expr(arena, AST_EXPR_ALT);
 	if (res == NULL) {
 		return NULL;
 	}
 
-	res->type = AST_EXPR_ALT;
 	res->u.alt.alloc = class->count;
 	res->u.alt.count = class->count;
 
-	res->u.alt.n = malloc(res->u.alt.alloc * sizeof *res->u.alt.n);
+	res->u.alt.n = re_arena_alloc(arena, res->u.alt.alloc * sizeof *res->u.alt.n);
 	if (res->u.alt.n == NULL) {
-		free(res);
 		return NULL;
 	}
 
 	for (i = 0; i < class->count; i++) {
 		if (class->ranges[i].a == class->ranges[i].b) {
 			if (class->ranges[i].a <= UCHAR_MAX) {
-				res->u.alt.n[i] = ast_make_expr_literal((unsigned char) class->ranges[i].a);
+				res->u.alt.n[i] = ast_make_expr_literal(arena, (unsigned char) class->ranges[i].a);
 			} else {
-				res->u.alt.n[i] = ast_make_expr_codepoint(class->ranges[i].a);
+				res->u.alt.n[i] = ast_make_expr_codepoint(arena, class->ranges[i].a);
 			}
 			if (res->u.alt.n[i] == NULL) {
-				goto error;
+				return NULL;
 			}
 		} else {
 			struct ast_endpoint from, to;
@@ -659,29 +760,12 @@ ast_make_expr_named(const struct class *class)
 				to.u.codepoint.u = class->ranges[i].b;
 			}
 
-			res->u.alt.n[i] = ast_make_expr_range(&from, pos, &to, pos);
+			res->u.alt.n[i] = ast_make_expr_range(arena, &from, pos, &to, pos);
 			if (res->u.alt.n[i] == NULL) {
-				goto error;
+				return NULL;
 			}
 		}
 	}
 
 	return res;
-
-error:
-
-	for (i = 0; i < class->count; i++) {
-		if (res->u.alt.n[i] == NULL) {
-			break;
-		}
-
-		ast_expr_free(res->u.alt.n[i]);
-	}
-
-	res->u.alt.count = 0;
-
-	ast_expr_free(res);
-
-	return NULL;
 }
-
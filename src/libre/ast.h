@@ -181,13 +181,32 @@ struct ast_expr {
 
 struct ast {
 	struct ast_expr *expr;
+	struct re_arena *arena;
 };
 
 extern struct ast_expr *ast_expr_tombstone;
 
+/*
+ * An AST's nodes and their arrays of children are allocated from an arena,
+ * and are never freed individually; a node which is rewritten away stays
+ * in the arena until it is cleared. re_arena_clear() frees all the nodes
+ * at once, keeping the arena's memory for the next AST.
+ */
+void *
+re_arena_alloc(struct re_arena *arena, size_t n);
+
+void *
+re_arena_realloc(struct re_arena *arena, void *p, size_t old, size_t n);
+
+void
+re_arena_clear(struct re_arena *arena);
+
 struct ast *
-ast_new(void);
+ast_new(struct re_arena *arena);
 
+/*
+ * Free an AST along with its arena, for an AST from re_parse().
+ */
 void
 ast_free(struct ast *ast);
 
@@ -199,9 +218,6 @@ ast_make_count(unsigned min, const struct ast_pos *start,
  * Expressions
  */
 
-void
-ast_expr_free(struct ast_expr *n);
-
 int
 ast_expr_cmp(const struct ast_expr *a, const struct ast_expr *b);
 
@@ -212,47 +228,48 @@ int
 ast_contains_expr(const struct ast_expr *node, struct ast_expr * const *a, size_t n);
 
 struct ast_expr *
-ast_make_expr_empty(void);
+ast_make_expr_empty(struct re_arena *arena);
 
 struct ast_expr *
-ast_make_expr_concat(void);
+ast_make_expr_concat(struct re_arena *arena);
 
 struct ast_expr *
-ast_make_expr_alt(void);
+ast_make_expr_alt(struct re_arena *arena);
 
 int
-ast_add_expr_alt(struct ast_expr *alt, struct ast_expr *node);
+ast_add_expr_alt(struct re_arena *arena, struct ast_expr *alt, struct ast_expr *node);
 
 struct ast_expr *
-ast_make_expr_literal(char c);
+ast_make_expr_literal(struct re_arena *arena, char c);
 
 struct ast_expr *
-ast_make_expr_codepoint(uint32_t u);
+ast_make_expr_codepoint(struct re_arena *arena, uint32_t u);
 
 struct ast_expr *
-ast_make_expr_repeat(struct ast_expr *e, struct ast_count count);
+ast_make_expr_repeat(struct re_arena *arena, struct ast_expr *e, struct ast_count count);
 
 struct ast_expr *
-ast_make_expr_group(struct ast_expr *e);
+ast_make_expr_group(struct re_arena *arena, struct ast_expr *e);
 
 struct ast_expr *
-ast_make_expr_re_flags(enum re_flags pos, enum re_flags neg);
+ast_make_expr_re_flags(struct re_arena *arena, enum re_flags pos, enum re_flags neg);
 
 struct ast_expr *
-ast_make_expr_anchor(enum ast_anchor_type type);
+ast_make_expr_anchor(struct re_arena *arena, enum ast_anchor_type type);
 
 struct ast_expr *
-ast_make_expr_subtract(struct ast_expr *a, struct ast_expr *b);
+ast_make_expr_subtract(struct re_arena *arena, struct ast_expr *a, struct ast_expr *b);
 
 int
-ast_add_expr_concat(struct ast_expr *cat, struct ast_expr *node);
+ast_add_expr_concat(struct re_arena *arena, struct ast_expr *cat, struct ast_expr *node);
 
 struct ast_expr *
-ast_make_expr_range(const struct ast_endpoint *from, struct ast_pos start,
+ast_make_expr_range(struct re_arena *arena,
+	const struct ast_endpoint *from, struct ast_pos start,
 	const struct ast_endpoint *to, struct ast_pos end);
 
 struct ast_expr *
-ast_make_expr_named(const struct class *class);
+ast_make_expr_named(struct re_arena *arena, const struct class *class);
 
 /* XXX: exposed for sake of re(1) printing an ast;
  * it's not part of the <re/re.h> API proper */
@@ -381,9 +381,7 @@ analysis_iter_anchoring(struct anchoring_env *env, struct ast_expr *n)
 			res = analysis_iter_anchoring(env, n->u.alt.n[i]);
 			if (res == AST_ANALYSIS_UNSATISFIABLE) {
 				/* prune unsatisfiable branch */
-				struct ast_expr *doomed = n->u.alt.n[i];
 				n->u.alt.n[i] = ast_expr_tombstone;
-				ast_expr_free(doomed);
 				continue;
 			} else if (res == AST_ANALYSIS_OK) {
 				any_sat = 1;
@@ -419,8 +417,6 @@ analysis_iter_anchoring(struct anchoring_env *env, struct ast_expr *n)
 		/* TODO: maybe do the analysis before rewriting? */
 
 		if (res == AST_ANALYSIS_UNSATISFIABLE && n->u.repeat.min == 0) {
-			ast_expr_free(n->u.repeat.e);
-
 			n->type = AST_EXPR_EMPTY;
 			set_flags(n, AST_FLAG_NULLABLE);
 			break;
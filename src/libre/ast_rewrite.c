@@ -24,7 +24,7 @@
 #endif
 
 static int
-rewrite(struct ast_expr *n, enum re_flags flags);
+rewrite(struct re_arena *arena, struct ast_expr *n, enum re_flags flags);
 
 static int
 cmp(const void *_a, const void *_b)
@@ -35,14 +35,6 @@ cmp(const void *_a, const void *_b)
 	return ast_expr_cmp(a, b);
 }
 
-static void
-dtor(void *p)
-{
-	struct ast_expr *n = * (struct ast_expr **) p;
-
-	ast_expr_free(n);
-}
-
 /*
  * Remove duplicates from a pre-sorted array, according to a user-supplied
  * comparator.  Usually the array should have been sorted with qsort() using
@@ -50,8 +42,7 @@ dtor(void *p)
  */
 static size_t
 qunique(void *array, size_t elements, size_t width,
-	int (*cmp)(const void *, const void *),
-	void (*dtor)(void *))
+	int (*cmp)(const void *, const void *))
 {
 	char *bytes = array;
 	size_t i, j;
@@ -67,8 +58,6 @@ qunique(void *array, size_t elements, size_t width,
 
 				memcpy(bytes + j * width, bytes + i * width, width);
 			}
-		} else {
-			dtor(bytes + i * width);
 		}
 	}
 
@@ -98,7 +87,8 @@ compile_subexpr(struct ast_expr *e, enum re_flags flags)
 	/* we're just setting these temporarily for sake of ast_analysis() */
 	e->flags = AST_FLAG_FIRST | AST_FLAG_LAST;
 
-	ast.expr = e;
+	ast.expr  = e;
+	ast.arena = NULL; /* not rewritten */
 
 	if (ast_analysis(&ast) != AST_ANALYSIS_OK) {
 		return 0;
@@ -115,7 +105,7 @@ compile_subexpr(struct ast_expr *e, enum re_flags flags)
 }
 
 static int
-rewrite_concat(struct ast_expr *n, enum re_flags flags)
+rewrite_concat(struct re_arena *arena, struct ast_expr *n, enum re_flags flags)
 {
 	size_t i;
 
@@ -124,7 +114,7 @@ rewrite_concat(struct ast_expr *n, enum re_flags flags)
 	assert(n->flags == 0x0);
 
 	for (i = 0; i < n->u.concat.count; i++) {
-		if (!rewrite(n->u.concat.n[i], flags)) {
+		if (!rewrite(arena, n->u.concat.n[i], flags)) {
 			return 0;
 		}
 	}
@@ -132,10 +122,6 @@ rewrite_concat(struct ast_expr *n, enum re_flags flags)
 	/* a tombstone here means the entire concatenation is a tombstone */
 	for (i = 0; i < n->u.concat.count; i++) {
 		if (n->u.concat.n[i]->type == AST_EXPR_TOMBSTONE) {
-			for (i = 0; i < n->u.concat.count; i++) {
-				ast_expr_free(n->u.concat.n[i]);
-			}
-
 			goto tombstone;
 		}
 	}
@@ -143,8 +129,6 @@ rewrite_concat(struct ast_expr *n, enum re_flags flags)
 	/* remove empty children; these have no semantic effect */
 	for (i = 0; i < n->u.concat.count; ) {
 		if (n->u.concat.n[i]->type == AST_EXPR_EMPTY) {
-			ast_expr_free(n->u.concat.n[i]);
-
 			if (i + 1 < n->u.concat.count) {
 				memmove(&n->u.concat.n[i], &n->u.concat.n[i + 1],
 					(n->u.concat.count - i - 1) * sizeof *n->u.concat.n);
@@ -171,7 +155,9 @@ rewrite_concat(struct ast_expr *n, enum re_flags flags)
 			if (n->u.concat.alloc < req_count) {
 				void *tmp;
 
-				tmp = realloc(n->u.concat.n, req_count * sizeof *n->u.concat.n);
+				tmp = re_arena_realloc(arena, n->u.concat.n,
+					n->u.concat.alloc * sizeof *n->u.concat.n,
+					req_count * sizeof *n->u.concat.n);
 				if (tmp == NULL) {
 					return 0;
 				}
@@ -193,9 +179,6 @@ rewrite_concat(struct ast_expr *n, enum re_flags flags)
 			n->u.concat.count--;
 			n->u.concat.count += dead->u.concat.count;
 
-			dead->u.concat.count = 0;
-			ast_expr_free(dead);
-
 			continue;
 		}
 
@@ -203,16 +186,11 @@ rewrite_concat(struct ast_expr *n, enum re_flags flags)
 	}
 
 	if (n->u.concat.count == 0) {
-		free(n->u.concat.n);
-
 		goto empty;
 	}
 
 	if (n->u.concat.count == 1) {
-		void *p = n->u.concat.n, *q = n->u.concat.n[0];
 		*n = *n->u.concat.n[0];
-		free(p);
-		free(q);
 		return 1;
 	}
 
@@ -232,7 +210,7 @@ tombstone:
 }
 
 static int
-rewrite_alt(struct ast_expr *n, enum re_flags flags)
+rewrite_alt(struct re_arena *arena, struct ast_expr *n, enum re_flags flags)
 {
 	size_t i;
 
@@ -241,7 +219,7 @@ rewrite_alt(struct ast_expr *n, enum re_flags flags)
 	assert(n->flags == 0x0);
 
 	for (i = 0; i < n->u.alt.count; i++) {
-		if (!rewrite(n->u.alt.n[i], flags)) {
+		if (!rewrite(arena, n->u.alt.n[i], flags)) {
 			return 0;
 		}
 	}
@@ -264,7 +242,8 @@ rewrite_alt(struct ast_expr *n, enum re_flags flags)
 			if (n->u.alt.alloc < n->u.alt.count + dead->u.alt.count - 1) {
 				void *tmp;
 
-				tmp = realloc(n->u.alt.n,
+				tmp = re_arena_realloc(arena, n->u.alt.n,
+					n->u.alt.alloc * sizeof *n->u.alt.n,
 					(n->u.alt.count + dead->u.alt.count - 1) * sizeof *n->u.alt.n);
 				if (tmp == NULL) {
 					return 0;
@@ -272,7 +251,7 @@ rewrite_alt(struct ast_expr *n, enum re_flags flags)
 
 				n->u.alt.n = tmp;
 
-				n->u.alt.alloc = (n->u.alt.count + dead->u.alt.count - 1) * sizeof *n->u.alt.n;
+				n->u.alt.alloc = n->u.alt.count + dead->u.alt.count - 1;
 			}
 
 			/* move along our existing tail to make space */
@@ -287,9 +266,6 @@ rewrite_alt(struct ast_expr *n, enum re_flags flags)
 			n->u.alt.count--;
 			n->u.alt.count += dead->u.alt.count;
 
-			dead->u.alt.count = 0;
-			ast_expr_free(dead);
-
 			continue;
 		}
 
@@ -300,20 +276,15 @@ rewrite_alt(struct ast_expr *n, enum re_flags flags)
 	/* de-duplicate children */
 	if (n->u.alt.count > 1) {
 		qsort(n->u.alt.n, n->u.alt.count, sizeof *n->u.alt.n, cmp);
-		n->u.alt.count = qunique(n->u.alt.n, n->u.alt.count, sizeof *n->u.alt.n, cmp, dtor);
+		n->u.alt.count = qunique(n->u.alt.n, n->u.alt.count, sizeof *n->u.alt.n, cmp);
 	}
 
 	if (n->u.alt.count == 0) {
-		free(n->u.alt.n);
-
 		goto empty;
 	}
 
 	if (n->u.alt.count == 1) {
-		void *p = n->u.alt.n, *q = n->u.alt.n[0];
 		*n = *n->u.alt.n[0];
-		free(p);
-		free(q);
 		return 1;
 	}
 
@@ -327,19 +298,17 @@ empty:
 }
 
 static int
-rewrite_repeat(struct ast_expr *n, enum re_flags flags)
+rewrite_repeat(struct re_arena *arena, struct ast_expr *n, enum re_flags flags)
 {
 	assert(n != NULL);
 	assert(n->type == AST_EXPR_REPEAT);
 	assert(n->flags == 0x0);
 
-	if (!rewrite(n->u.repeat.e, flags)) {
+	if (!rewrite(arena, n->u.repeat.e, flags)) {
 		return 0;
 	}
 
 	if (n->u.repeat.e->type == AST_EXPR_EMPTY) {
-		ast_expr_free(n->u.repeat.e);
-
 		goto empty;
 	}
 
@@ -347,8 +316,6 @@ rewrite_repeat(struct ast_expr *n, enum re_flags flags)
 	 * Should never be constructed, but just in case.
 	 */
 	if (n->u.repeat.min == 0 && n->u.repeat.max == 0) {
-		ast_expr_free(n->u.repeat.e);
-
 		goto empty;
 	}
 
@@ -356,13 +323,8 @@ rewrite_repeat(struct ast_expr *n, enum re_flags flags)
 	 * Should never be constructed, but just in case.
 	 */
 	if (n->u.repeat.min == 1 && n->u.repeat.max == 1) {
-		struct ast_expr *dead = n->u.repeat.e;
-
 		*n = *n->u.repeat.e;
 
-		dead->type = AST_EXPR_EMPTY;
-		ast_expr_free(dead);
-
 		return 1;
 	}
 
@@ -372,7 +334,6 @@ rewrite_repeat(struct ast_expr *n, enum re_flags flags)
 	 */
 	if (n->u.repeat.e->type == AST_EXPR_REPEAT) {
 		const struct ast_expr *inner, *outer;
-		struct ast_expr *dead;
 		unsigned h, i, j, k;
 		unsigned v, w;
 
@@ -398,15 +359,10 @@ rewrite_repeat(struct ast_expr *n, enum re_flags flags)
 		}
 
 		if (h == 0 || h == 1) {
-			dead = n->u.repeat.e;
-
 			n->u.repeat.min = v;
 			n->u.repeat.max = w;
 			n->u.repeat.e    = n->u.repeat.e->u.repeat.e;
 
-			dead->type = AST_EXPR_EMPTY;
-			ast_expr_free(dead);
-
 			return 1;
 		}
 
@@ -426,28 +382,18 @@ rewrite_repeat(struct ast_expr *n, enum re_flags flags)
 		 * a{h,}{j,k}
 		 */
 		if ((i == AST_COUNT_UNBOUNDED || k == AST_COUNT_UNBOUNDED) && h <= 1 && j <= 1) {
-			dead = n->u.repeat.e;
-
 			n->u.repeat.min = v;
 			n->u.repeat.max = w;
 			n->u.repeat.e   = n->u.repeat.e->u.repeat.e;
 
-			dead->type = AST_EXPR_EMPTY;
-			ast_expr_free(dead);
-
 			return 1;
 		}
 
 		if (h > 1 && i == AST_COUNT_UNBOUNDED && j > 0) {
-			dead = n->u.repeat.e;
-
 			n->u.repeat.min = v;
 			n->u.repeat.max = w;
 			n->u.repeat.e   = n->u.repeat.e->u.repeat.e;
 
-			dead->type = AST_EXPR_EMPTY;
-			ast_expr_free(dead);
-
 			return 1;
 		}
 
@@ -468,14 +414,10 @@ rewrite_repeat(struct ast_expr *n, enum re_flags flags)
 	 */
 
 	if (n->u.repeat.min == 0 && n->u.repeat.e->type == AST_EXPR_TOMBSTONE) {
-		ast_expr_free(n->u.repeat.e);
-
 		goto empty;
 	}
 
 	if (n->u.repeat.min > 0 && n->u.repeat.e->type == AST_EXPR_TOMBSTONE) {
-		ast_expr_free(n->u.repeat.e);
-
 		goto tombstone;
 	}
 
@@ -495,7 +437,7 @@ tombstone:
 }
 
 static int
-rewrite_subtract(struct ast_expr *n, enum re_flags flags)
+rewrite_subtract(struct re_arena *arena, struct ast_expr *n, enum re_flags flags)
 {
 	int empty;
 
@@ -503,19 +445,16 @@ rewrite_subtract(struct ast_expr *n, enum re_flags flags)
 	assert(n->type == AST_EXPR_SUBTRACT);
 	assert(n->flags == 0x0);
 
-	if (!rewrite(n->u.subtract.a, flags)) {
+	if (!rewrite(arena, n->u.subtract.a, flags)) {
 		return 0;
 	}
 
 	/* If the lhs operand is empty, the result is always empty */
 	if (n->u.subtract.a->type == AST_EXPR_EMPTY) {
-		ast_expr_free(n->u.subtract.a);
-		ast_expr_free(n->u.subtract.b);
-
 		goto empty;
 	}
 
-	if (!rewrite(n->u.subtract.b, flags)) {
+	if (!rewrite(arena, n->u.subtract.b, flags)) {
 		return 0;
 	}
 
@@ -567,8 +506,6 @@ rewrite_subtract(struct ast_expr *n, enum re_flags flags)
 	}
 
 	if (empty) {
-		ast_expr_free(n->u.subtract.a);
-		ast_expr_free(n->u.subtract.b);
 		goto tombstone;
 	}
 
@@ -588,7 +525,7 @@ tombstone:
 }
 
 static int
-rewrite(struct ast_expr *n, enum re_flags flags)
+rewrite(struct re_arena *arena, struct ast_expr *n, enum re_flags flags)
 {
 	if (n == NULL) {
 		return 1;
@@ -602,26 +539,24 @@ rewrite(struct ast_expr *n, enum re_flags flags)
 		return 1;
 
 	case AST_EXPR_CONCAT:
-		return rewrite_concat(n, flags);
+		return rewrite_concat(arena, n, flags);
 
 	case AST_EXPR_ALT:
-		return rewrite_alt(n, flags);
+		return rewrite_alt(arena, n, flags);
 
 	case AST_EXPR_LITERAL:
 	case AST_EXPR_CODEPOINT:
 		return 1;
 
 	case AST_EXPR_REPEAT:
-		return rewrite_repeat(n, flags);
+		return rewrite_repeat(arena, n, flags);
 
 	case AST_EXPR_GROUP:
-		if (!rewrite(n->u.group.e, flags)) {
+		if (!rewrite(arena, n->u.group.e, flags)) {
 			return 0;
 		}
 
 		if (n->u.group.e->type == AST_EXPR_TOMBSTONE) {
-			ast_expr_free(n->u.group.e);
-
 			goto tombstone;
 		}
 
@@ -632,7 +567,7 @@ rewrite(struct ast_expr *n, enum re_flags flags)
 		return 1;
 
 	case AST_EXPR_SUBTRACT:
-		return rewrite_subtract(n, flags);
+		return rewrite_subtract(arena, n, flags);
 
 	case AST_EXPR_RANGE:
 	case AST_EXPR_TOMBSTONE:
@@ -652,6 +587,6 @@ tombstone:
 int
 ast_rewrite(struct ast *ast, enum re_flags flags)
 {
-	return rewrite(ast->expr, flags);
+	return rewrite(ast->arena, ast->expr, flags);
 }
 
@@ -14,7 +14,7 @@
 /* TODO: make overlap a flag */
 
 typedef struct ast *
-re_dialect_parse_fun(re_getchar_fun *getchar, void *opaque,
+re_dialect_parse_fun(struct re_arena *arena, const char *s, size_t n,
 	const struct fsm_options *opt,
 	enum re_flags flags, int overlap,
 	struct re_err *err);
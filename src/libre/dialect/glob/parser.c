@@ -9,7 +9,7 @@
 
 /* BEGINNING OF HEADER */
 
-#line 142 "src/libre/parser.act"
+#line 140 "src/libre/parser.act"
 
 
 	#include <assert.h>
@@ -100,6 +100,7 @@
 		enum LX_TOKEN lex_tok;
 		enum LX_TOKEN lex_tok_save;
 		int overlap; /* permit overlap in groups */
+		struct re_arena *arena;
 
 		/*
 		 * Lexical position stored for syntax errors.
@@ -121,9 +122,6 @@
 		struct LX_STATE lx;
 		struct lx_dynbuf buf; /* XXX: unneccessary since we're lexing from a string */
 
-		re_getchar_fun *f;
-		void *opaque;
-
 		/* TODO: use lx's generated conveniences for the pattern buffer */
 		char a[512];
 		char *p;
@@ -209,7 +207,7 @@
 		return s;
 	}
 
-#line 213 "src/libre/dialect/glob/parser.c"
+#line 211 "src/libre/dialect/glob/parser.c"
 
 
 #ifndef ERROR_TERMINAL
@@ -244,13 +242,13 @@ ZL2_list_Hof_Hatoms:;
 		}
 		/* BEGINNING OF ACTION: ast-add-concat */
 		{
-#line 821 "src/libre/parser.act"
+#line 819 "src/libre/parser.act"
 
-		if (!ast_add_expr_concat((ZIcat), (ZIa))) {
+		if (!ast_add_expr_concat(act_state->arena, (ZIcat), (ZIa))) {
 			goto ZL1;
 		}
 	
-#line 254 "src/libre/dialect/glob/parser.c"
+#line 252 "src/libre/dialect/glob/parser.c"
 		}
 		/* END OF ACTION: ast-add-concat */
 		/* BEGINNING OF INLINE: 98 */
@@ -288,24 +286,24 @@ p_list_Hof_Hatoms_C_Catom(flags flags, lex_state lex_state, act_state act_state,
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: class-any */
 			{
-#line 574 "src/libre/parser.act"
+#line 572 "src/libre/parser.act"
 
 		/* TODO: or the unicode equivalent */
 		(ZIa) = &class_any;
 	
-#line 297 "src/libre/dialect/glob/parser.c"
+#line 295 "src/libre/dialect/glob/parser.c"
 			}
 			/* END OF ACTION: class-any */
 			/* BEGINNING OF ACTION: ast-make-named */
 			{
-#line 814 "src/libre/parser.act"
+#line 812 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_named((ZIa));
+		(ZIe) = ast_make_expr_named(act_state->arena, (ZIa));
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 309 "src/libre/dialect/glob/parser.c"
+#line 307 "src/libre/dialect/glob/parser.c"
 			}
 			/* END OF ACTION: ast-make-named */
 		}
@@ -318,7 +316,7 @@ p_list_Hof_Hatoms_C_Catom(flags flags, lex_state lex_state, act_state act_state,
 
 			/* BEGINNING OF EXTRACT: CHAR */
 			{
-#line 414 "src/libre/parser.act"
+#line 412 "src/libre/parser.act"
 
 		/* the first byte may be '\x00' */
 		assert(lex_state->buf.a[1] == '\0');
@@ -328,20 +326,20 @@ p_list_Hof_Hatoms_C_Catom(flags flags, lex_state lex_state, act_state act_state,
 
 		ZIc = lex_state->buf.a[0];
 	
-#line 332 "src/libre/dialect/glob/parser.c"
+#line 330 "src/libre/dialect/glob/parser.c"
 			}
 			/* END OF EXTRACT: CHAR */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: ast-make-literal */
 			{
-#line 683 "src/libre/parser.act"
+#line 681 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_literal((ZIc));
+		(ZIe) = ast_make_expr_literal(act_state->arena, (ZIc));
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 345 "src/libre/dialect/glob/parser.c"
+#line 343 "src/libre/dialect/glob/parser.c"
 			}
 			/* END OF ACTION: ast-make-literal */
 		}
@@ -355,52 +353,52 @@ p_list_Hof_Hatoms_C_Catom(flags flags, lex_state lex_state, act_state act_state,
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: class-any */
 			{
-#line 574 "src/libre/parser.act"
+#line 572 "src/libre/parser.act"
 
 		/* TODO: or the unicode equivalent */
 		(ZIa) = &class_any;
 	
-#line 364 "src/libre/dialect/glob/parser.c"
+#line 362 "src/libre/dialect/glob/parser.c"
 			}
 			/* END OF ACTION: class-any */
 			/* BEGINNING OF ACTION: ast-make-named */
 			{
-#line 814 "src/libre/parser.act"
+#line 812 "src/libre/parser.act"
 
-		(ZIg) = ast_make_expr_named((ZIa));
+		(ZIg) = ast_make_expr_named(act_state->arena, (ZIa));
 		if ((ZIg) == NULL) {
 			goto ZL1;
 		}
 	
-#line 376 "src/libre/dialect/glob/parser.c"
+#line 374 "src/libre/dialect/glob/parser.c"
 			}
 			/* END OF ACTION: ast-make-named */
 			/* BEGINNING OF ACTION: count-zero-or-more */
 			{
-#line 595 "src/libre/parser.act"
+#line 593 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(0, NULL, AST_COUNT_UNBOUNDED, NULL);
 	
-#line 385 "src/libre/dialect/glob/parser.c"
+#line 383 "src/libre/dialect/glob/parser.c"
 			}
 			/* END OF ACTION: count-zero-or-more */
 			/* BEGINNING OF ACTION: ast-make-piece */
 			{
-#line 694 "src/libre/parser.act"
+#line 692 "src/libre/parser.act"
 
 		if ((ZIc).min == 0 && (ZIc).max == 0) {
-			(ZIe) = ast_make_expr_empty();
+			(ZIe) = ast_make_expr_empty(act_state->arena);
 		} else if ((ZIc).min == 1 && (ZIc).max == 1) {
 			(ZIe) = (ZIg);
 		} else {
-			(ZIe) = ast_make_expr_repeat((ZIg), (ZIc));
+			(ZIe) = ast_make_expr_repeat(act_state->arena, (ZIg), (ZIc));
 		}
 		if ((ZIe) == NULL) {
 			err->e = RE_EXEOF;
 			goto ZL1;
 		}
 	
-#line 404 "src/libre/dialect/glob/parser.c"
+#line 402 "src/libre/dialect/glob/parser.c"
 			}
 			/* END OF ACTION: ast-make-piece */
 		}
@@ -415,26 +413,26 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-atom */
 		{
-#line 483 "src/libre/parser.act"
+#line 481 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXATOM;
 		}
 		goto ZL2;
 	
-#line 426 "src/libre/dialect/glob/parser.c"
+#line 424 "src/libre/dialect/glob/parser.c"
 		}
 		/* END OF ACTION: err-expected-atom */
 		/* BEGINNING OF ACTION: ast-make-empty */
 		{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_empty();
+		(ZIe) = ast_make_expr_empty(act_state->arena);
 		if ((ZIe) == NULL) {
 			goto ZL2;
 		}
 	
-#line 438 "src/libre/dialect/glob/parser.c"
+#line 436 "src/libre/dialect/glob/parser.c"
 		}
 		/* END OF ACTION: ast-make-empty */
 	}
@@ -462,14 +460,14 @@ p_re__glob(flags flags, lex_state lex_state, act_state act_state, err err, t_ast
 				{
 					/* BEGINNING OF ACTION: ast-make-concat */
 					{
-#line 669 "src/libre/parser.act"
+#line 667 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_concat();
+		(ZInode) = ast_make_expr_concat(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 473 "src/libre/dialect/glob/parser.c"
+#line 471 "src/libre/dialect/glob/parser.c"
 					}
 					/* END OF ACTION: ast-make-concat */
 					p_list_Hof_Hatoms (flags, lex_state, act_state, err, ZInode);
@@ -483,14 +481,14 @@ p_re__glob(flags flags, lex_state lex_state, act_state act_state, err err, t_ast
 				{
 					/* BEGINNING OF ACTION: ast-make-empty */
 					{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_empty();
+		(ZInode) = ast_make_expr_empty(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 494 "src/libre/dialect/glob/parser.c"
+#line 492 "src/libre/dialect/glob/parser.c"
 					}
 					/* END OF ACTION: ast-make-empty */
 				}
@@ -514,14 +512,14 @@ p_re__glob(flags flags, lex_state lex_state, act_state act_state, err err, t_ast
 			{
 				/* BEGINNING OF ACTION: err-expected-eof */
 				{
-#line 532 "src/libre/parser.act"
+#line 530 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXEOF;
 		}
 		goto ZL1;
 	
-#line 525 "src/libre/dialect/glob/parser.c"
+#line 523 "src/libre/dialect/glob/parser.c"
 				}
 				/* END OF ACTION: err-expected-eof */
 			}
@@ -539,26 +537,11 @@ ZL0:;
 
 /* BEGINNING OF TRAILER */
 
-#line 974 "src/libre/parser.act"
-
-
-	static int
-	lgetc(struct LX_STATE *lx)
-	{
-		struct lex_state *lex_state;
-
-		assert(lx != NULL);
-		assert(lx->getc_opaque != NULL);
+#line 959 "src/libre/parser.act"
 
-		lex_state = lx->getc_opaque;
-
-		assert(lex_state->f != NULL);
-
-		return lex_state->f(lex_state->opaque);
-	}
 
 	struct ast *
-	DIALECT_PARSE(re_getchar_fun *f, void *opaque,
+	DIALECT_PARSE(struct re_arena *arena, const char *s, size_t n,
 		const struct fsm_options *opt,
 		enum re_flags flags, int overlap,
 		struct re_err *err)
@@ -576,14 +559,19 @@ ZL0:;
 
 		top.flags = flags;
 
-		assert(f != NULL);
-
-		ast = ast_new();
+		assert(arena != NULL);
+		assert(s != NULL);
 
 		if (err == NULL) {
 			err = &dummy;
 		}
 
+		ast = ast_new(arena);
+		if (ast == NULL) {
+			err->e = RE_EERRNO;
+			return NULL;
+		}
+
 		lex_state    = &lex_state_s;
 		lex_state->p = lex_state->a;
 
@@ -591,11 +579,9 @@ ZL0:;
 
 		LX_INIT(lx);
 
-		lx->lgetc       = lgetc;
-		lx->getc_opaque = lex_state;
-
-		lex_state->f       = f;
-		lex_state->opaque  = opaque;
+		/* the lexer reads from the buffer directly, by lx->p */
+		lx->p = s;
+		lx->e = s + n;
 
 		lex_state->buf.a   = NULL;
 		lex_state->buf.len = 0;
@@ -611,6 +597,7 @@ ZL0:;
 		act_state = &act_state_s;
 
 		act_state->overlap = overlap;
+		act_state->arena   = arena;
 
 		err->e = RE_ESUCCESS;
 
@@ -620,7 +607,7 @@ ZL0:;
 		lx->free(lx->buf_opaque);
 
 		if (err->e != RE_ESUCCESS) {
-			/* TODO: free internals allocated during parsing (are there any?) */
+			/* nodes allocated during parsing are freed with the arena */
 			goto error;
 		}
 
@@ -677,11 +664,9 @@ ZL0:;
 			break;
 		}
 
-		ast_free(ast);
-
 		return NULL;
 	}
 
-#line 686 "src/libre/dialect/glob/parser.c"
+#line 671 "src/libre/dialect/glob/parser.c"
 
 /* END OF FILE */
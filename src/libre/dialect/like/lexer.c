@@ -19,22 +19,20 @@ lx_getc(struct lx_like_lx *lx)
 	int c;
 
 	assert(lx != NULL);
-	assert(lx->lgetc != NULL);
+	assert(lx->p != NULL);
 
-	if (lx->c != EOF) {
-		c = lx->c, lx->c = EOF;
-	} else {
-		c = lx->lgetc(lx);
-		if (c == EOF) {
+	if (lx->p == lx->e) {
 			return EOF;
-		}
 	}
 
+	c = (unsigned char) *lx->p++;
+
 	lx->end.byte++;
 	lx->end.col++;
 
 	if (c == '\n') {
 		lx->end.line++;
+		lx->end.saved_col = lx->end.col - 1;
 		lx->end.col = 1;
 	}
 
@@ -48,9 +46,10 @@ static void
 lx_like_ungetc(struct lx_like_lx *lx, int c)
 {
 	assert(lx != NULL);
-	assert(lx->c == EOF);
+	assert(lx->p != NULL);
+	assert((unsigned char) *(lx->p - 1) == c);
 
-	lx->c = c;
+	lx->p--;
 
 
 	lx->end.byte--;
@@ -58,7 +57,7 @@ lx_like_ungetc(struct lx_like_lx *lx, int c)
 
 	if (c == '\n') {
 		lx->end.line--;
-		lx->end.col = 0; /* XXX: lost information */
+		lx->end.col = lx->end.saved_col;
 	}
 }
 
@@ -161,21 +160,21 @@ z0(struct lx_like_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "a" */
+			lx_like_ungetc(lx, c); return TOK_CHAR;
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
 			case '%': state = S2; break;
 			case '_': state = S3; break;
-			default: state = S1; break;
+			default: state = S0; break;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_like_ungetc(lx, c); return TOK_CHAR;
-
 		case S2: /* e.g. "%" */
 			lx_like_ungetc(lx, c); return TOK_MANY;
 
@@ -193,11 +192,11 @@ z0(struct lx_like_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
+	case S0: return TOK_CHAR;
 	case S2: return TOK_MANY;
 	case S3: return TOK_ANY;
 	default: errno = EINVAL; return TOK_ERROR;
@@ -225,9 +224,9 @@ lx_like_example(enum lx_like_token (*z)(struct lx_like_lx *), enum lx_like_token
 
 	if (z == z0) {
 		switch (t) {
-		case TOK_CHAR: return "a";
-		case TOK_MANY: return "%";
-		case TOK_ANY: return "_";
+		case TOK_CHAR: return "";
+		case TOK_MANY: return "";
+		case TOK_ANY: return "";
 		default: goto error;
 		}
 	}
@@ -247,7 +246,6 @@ lx_like_init(struct lx_like_lx *lx)
 
 	*lx = lx_default;
 
-	lx->c = EOF;
 	lx->z = z0;
 
 	lx->end.byte = 0;
@@ -263,7 +261,7 @@ lx_like_next(struct lx_like_lx *lx)
 	assert(lx != NULL);
 	assert(lx->z != NULL);
 
-	if (lx->lgetc == NULL) {
+	if (lx->p == NULL) {
 		return TOK_EOF;
 	}
 
@@ -19,22 +19,20 @@ lx_getc(struct lx_literal_lx *lx)
 	int c;
 
 	assert(lx != NULL);
-	assert(lx->lgetc != NULL);
+	assert(lx->p != NULL);
 
-	if (lx->c != EOF) {
-		c = lx->c, lx->c = EOF;
-	} else {
-		c = lx->lgetc(lx);
-		if (c == EOF) {
+	if (lx->p == lx->e) {
 			return EOF;
-		}
 	}
 
+	c = (unsigned char) *lx->p++;
+
 	lx->end.byte++;
 	lx->end.col++;
 
 	if (c == '\n') {
 		lx->end.line++;
+		lx->end.saved_col = lx->end.col - 1;
 		lx->end.col = 1;
 	}
 
@@ -48,9 +46,10 @@ static void
 lx_literal_ungetc(struct lx_literal_lx *lx, int c)
 {
 	assert(lx != NULL);
-	assert(lx->c == EOF);
+	assert(lx->p != NULL);
+	assert((unsigned char) *(lx->p - 1) == c);
 
-	lx->c = c;
+	lx->p--;
 
 
 	lx->end.byte--;
@@ -58,7 +57,7 @@ lx_literal_ungetc(struct lx_literal_lx *lx, int c)
 
 	if (c == '\n') {
 		lx->end.line--;
-		lx->end.col = 0; /* XXX: lost information */
+		lx->end.col = lx->end.saved_col;
 	}
 }
 
@@ -182,7 +181,7 @@ z0(struct lx_literal_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
@@ -210,7 +209,7 @@ lx_literal_example(enum lx_literal_token (*z)(struct lx_literal_lx *), enum lx_l
 
 	if (z == z0) {
 		switch (t) {
-		case TOK_CHAR: return "a";
+		case TOK_CHAR: return "";
 		default: goto error;
 		}
 	}
@@ -230,7 +229,6 @@ lx_literal_init(struct lx_literal_lx *lx)
 
 	*lx = lx_default;
 
-	lx->c = EOF;
 	lx->z = z0;
 
 	lx->end.byte = 0;
@@ -246,7 +244,7 @@ lx_literal_next(struct lx_literal_lx *lx)
 	assert(lx != NULL);
 	assert(lx->z != NULL);
 
-	if (lx->lgetc == NULL) {
+	if (lx->p == NULL) {
 		return TOK_EOF;
 	}
 
@@ -12,19 +12,18 @@ enum lx_literal_token {
 
 /*
  * .byte is 0-based.
- * .line and .col are 1-based; 0 means unknown.
+ * .line, .col, and .saved_col are 1-based; 0 means unknown.
  */
 struct lx_pos {
 	unsigned byte;
 	unsigned line;
 	unsigned col;
+	unsigned saved_col;
 };
 
 struct lx_literal_lx {
-	int (*lgetc)(struct lx_literal_lx *lx);
-	void *getc_opaque;
-
-	int c; /* lx_literal_ungetc buffer */
+	const char *p; /* input string */
+	const char *e; /* one past end of input */
 
 	struct lx_pos start;
 	struct lx_pos end;
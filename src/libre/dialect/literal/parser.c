@@ -9,7 +9,7 @@
 
 /* BEGINNING OF HEADER */
 
-#line 142 "src/libre/parser.act"
+#line 140 "src/libre/parser.act"
 
 
 	#include <assert.h>
@@ -100,6 +100,7 @@
 		enum LX_TOKEN lex_tok;
 		enum LX_TOKEN lex_tok_save;
 		int overlap; /* permit overlap in groups */
+		struct re_arena *arena;
 
 		/*
 		 * Lexical position stored for syntax errors.
@@ -121,9 +122,6 @@
 		struct LX_STATE lx;
 		struct lx_dynbuf buf; /* XXX: unneccessary since we're lexing from a string */
 
-		re_getchar_fun *f;
-		void *opaque;
-
 		/* TODO: use lx's generated conveniences for the pattern buffer */
 		char a[512];
 		char *p;
@@ -209,7 +207,7 @@
 		return s;
 	}
 
-#line 213 "src/libre/dialect/literal/parser.c"
+#line 211 "src/libre/dialect/literal/parser.c"
 
 
 #ifndef ERROR_TERMINAL
@@ -244,13 +242,13 @@ ZL2_list_Hof_Hatoms:;
 		}
 		/* BEGINNING OF ACTION: ast-add-concat */
 		{
-#line 821 "src/libre/parser.act"
+#line 819 "src/libre/parser.act"
 
-		if (!ast_add_expr_concat((ZIcat), (ZIa))) {
+		if (!ast_add_expr_concat(act_state->arena, (ZIcat), (ZIa))) {
 			goto ZL1;
 		}
 	
-#line 254 "src/libre/dialect/literal/parser.c"
+#line 252 "src/libre/dialect/literal/parser.c"
 		}
 		/* END OF ACTION: ast-add-concat */
 		/* BEGINNING OF INLINE: 97 */
@@ -291,14 +289,14 @@ p_re__literal(flags flags, lex_state lex_state, act_state act_state, err err, t_
 				{
 					/* BEGINNING OF ACTION: ast-make-concat */
 					{
-#line 669 "src/libre/parser.act"
+#line 667 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_concat();
+		(ZInode) = ast_make_expr_concat(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 302 "src/libre/dialect/literal/parser.c"
+#line 300 "src/libre/dialect/literal/parser.c"
 					}
 					/* END OF ACTION: ast-make-concat */
 					p_list_Hof_Hatoms (flags, lex_state, act_state, err, ZInode);
@@ -312,14 +310,14 @@ p_re__literal(flags flags, lex_state lex_state, act_state act_state, err err, t_
 				{
 					/* BEGINNING OF ACTION: ast-make-empty */
 					{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_empty();
+		(ZInode) = ast_make_expr_empty(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 323 "src/libre/dialect/literal/parser.c"
+#line 321 "src/libre/dialect/literal/parser.c"
 					}
 					/* END OF ACTION: ast-make-empty */
 				}
@@ -343,14 +341,14 @@ p_re__literal(flags flags, lex_state lex_state, act_state act_state, err err, t_
 			{
 				/* BEGINNING OF ACTION: err-expected-eof */
 				{
-#line 532 "src/libre/parser.act"
+#line 530 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXEOF;
 		}
 		goto ZL1;
 	
-#line 354 "src/libre/dialect/literal/parser.c"
+#line 352 "src/libre/dialect/literal/parser.c"
 				}
 				/* END OF ACTION: err-expected-eof */
 			}
@@ -383,7 +381,7 @@ p_list_Hof_Hatoms_C_Catom(flags flags, lex_state lex_state, act_state act_state,
 		case (TOK_CHAR):
 			/* BEGINNING OF EXTRACT: CHAR */
 			{
-#line 414 "src/libre/parser.act"
+#line 412 "src/libre/parser.act"
 
 		/* the first byte may be '\x00' */
 		assert(lex_state->buf.a[1] == '\0');
@@ -393,7 +391,7 @@ p_list_Hof_Hatoms_C_Catom(flags flags, lex_state lex_state, act_state act_state,
 
 		ZIc = lex_state->buf.a[0];
 	
-#line 397 "src/libre/dialect/literal/parser.c"
+#line 395 "src/libre/dialect/literal/parser.c"
 			}
 			/* END OF EXTRACT: CHAR */
 			break;
@@ -403,14 +401,14 @@ p_list_Hof_Hatoms_C_Catom(flags flags, lex_state lex_state, act_state act_state,
 		ADVANCE_LEXER;
 		/* BEGINNING OF ACTION: ast-make-literal */
 		{
-#line 683 "src/libre/parser.act"
+#line 681 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_literal((ZIc));
+		(ZInode) = ast_make_expr_literal(act_state->arena, (ZIc));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 414 "src/libre/dialect/literal/parser.c"
+#line 412 "src/libre/dialect/literal/parser.c"
 		}
 		/* END OF ACTION: ast-make-literal */
 	}
@@ -419,26 +417,26 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-atom */
 		{
-#line 483 "src/libre/parser.act"
+#line 481 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXATOM;
 		}
 		goto ZL2;
 	
-#line 430 "src/libre/dialect/literal/parser.c"
+#line 428 "src/libre/dialect/literal/parser.c"
 		}
 		/* END OF ACTION: err-expected-atom */
 		/* BEGINNING OF ACTION: ast-make-empty */
 		{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_empty();
+		(ZInode) = ast_make_expr_empty(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL2;
 		}
 	
-#line 442 "src/libre/dialect/literal/parser.c"
+#line 440 "src/libre/dialect/literal/parser.c"
 		}
 		/* END OF ACTION: ast-make-empty */
 	}
@@ -452,26 +450,11 @@ ZL0:;
 
 /* BEGINNING OF TRAILER */
 
-#line 974 "src/libre/parser.act"
-
-
-	static int
-	lgetc(struct LX_STATE *lx)
-	{
-		struct lex_state *lex_state;
-
-		assert(lx != NULL);
-		assert(lx->getc_opaque != NULL);
+#line 959 "src/libre/parser.act"
 
-		lex_state = lx->getc_opaque;
-
-		assert(lex_state->f != NULL);
-
-		return lex_state->f(lex_state->opaque);
-	}
 
 	struct ast *
-	DIALECT_PARSE(re_getchar_fun *f, void *opaque,
+	DIALECT_PARSE(struct re_arena *arena, const char *s, size_t n,
 		const struct fsm_options *opt,
 		enum re_flags flags, int overlap,
 		struct re_err *err)
@@ -489,14 +472,19 @@ ZL0:;
 
 		top.flags = flags;
 
-		assert(f != NULL);
-
-		ast = ast_new();
+		assert(arena != NULL);
+		assert(s != NULL);
 
 		if (err == NULL) {
 			err = &dummy;
 		}
 
+		ast = ast_new(arena);
+		if (ast == NULL) {
+			err->e = RE_EERRNO;
+			return NULL;
+		}
+
 		lex_state    = &lex_state_s;
 		lex_state->p = lex_state->a;
 
@@ -504,11 +492,9 @@ ZL0:;
 
 		LX_INIT(lx);
 
-		lx->lgetc       = lgetc;
-		lx->getc_opaque = lex_state;
-
-		lex_state->f       = f;
-		lex_state->opaque  = opaque;
+		/* the lexer reads from the buffer directly, by lx->p */
+		lx->p = s;
+		lx->e = s + n;
 
 		lex_state->buf.a   = NULL;
 		lex_state->buf.len = 0;
@@ -524,6 +510,7 @@ ZL0:;
 		act_state = &act_state_s;
 
 		act_state->overlap = overlap;
+		act_state->arena   = arena;
 
 		err->e = RE_ESUCCESS;
 
@@ -533,7 +520,7 @@ ZL0:;
 		lx->free(lx->buf_opaque);
 
 		if (err->e != RE_ESUCCESS) {
-			/* TODO: free internals allocated during parsing (are there any?) */
+			/* nodes allocated during parsing are freed with the arena */
 			goto error;
 		}
 
@@ -590,11 +577,9 @@ ZL0:;
 			break;
 		}
 
-		ast_free(ast);
-
 		return NULL;
 	}
 
-#line 599 "src/libre/dialect/literal/parser.c"
+#line 584 "src/libre/dialect/literal/parser.c"
 
 /* END OF FILE */
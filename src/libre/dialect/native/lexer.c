@@ -21,17 +21,14 @@ lx_getc(struct lx_native_lx *lx)
 	int c;
 
 	assert(lx != NULL);
-	assert(lx->lgetc != NULL);
+	assert(lx->p != NULL);
 
-	if (lx->c != EOF) {
-		c = lx->c, lx->c = EOF;
-	} else {
-		c = lx->lgetc(lx);
-		if (c == EOF) {
+	if (lx->p == lx->e) {
 			return EOF;
-		}
 	}
 
+	c = (unsigned char) *lx->p++;
+
 	lx->end.byte++;
 	lx->end.col++;
 
@@ -51,9 +48,10 @@ static void
 lx_native_ungetc(struct lx_native_lx *lx, int c)
 {
 	assert(lx != NULL);
-	assert(lx->c == EOF);
+	assert(lx->p != NULL);
+	assert((unsigned char) *(lx->p - 1) == c);
 
-	lx->c = c;
+	lx->p--;
 
 
 	lx->end.byte--;
@@ -164,13 +162,16 @@ z0(struct lx_native_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "," */
+			lx_native_ungetc(lx, c); return TOK_SEP;
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
-			case '}': state = S3; break;
+			case ',': state = S0; break;
 			case '0':
 			case '1':
 			case '2':
@@ -181,14 +182,11 @@ z0(struct lx_native_lx *lx)
 			case '7':
 			case '8':
 			case '9': state = S2; break;
-			case ',': state = S1; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '}': state = S3; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "," */
-			lx_native_ungetc(lx, c); return TOK_SEP;
-
 		case S2: /* e.g. "0" */
 			switch ((unsigned char) c) {
 			case '0':
@@ -219,11 +217,11 @@ z0(struct lx_native_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_SEP;
+	case S0: return TOK_SEP;
 	case S2: return TOK_COUNT;
 	case S3: return TOK_CLOSECOUNT;
 	default: errno = EINVAL; return TOK_ERROR;
@@ -256,408 +254,344 @@ z1(struct lx_native_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S50;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "[:wo" */
 			switch ((unsigned char) c) {
-			case '-': state = S2; break;
-			case '[': state = S3; break;
-			case '\\': state = S4; break;
-			case ']': state = S5; break;
-			case '^': state = S6; break;
-			default: state = S1; break;
+			case 'r': state = S40; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_native_ungetc(lx, c); return TOK_CHAR;
-
-		case S2: /* e.g. "-" */
-			lx_native_ungetc(lx, c); return TOK_RANGE;
-
-		case S3: /* e.g. "[" */
+		case S1: /* e.g. "[:asc" */
 			switch ((unsigned char) c) {
-			case ':': state = S7; break;
-			default:  lx_native_ungetc(lx, c); return TOK_CHAR;
+			case 'i': state = S43; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S4: /* e.g. "\\" */
+		case S2: /* e.g. "[:sp" */
 			switch ((unsigned char) c) {
-			case '-':
-			case '[':
-			case '\\':
-			case ']':
-			case '^':
-			case 'f':
-			case 'n':
-			case 'r':
-			case 't':
-			case 'v': state = S52; break;
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S53; break;
-			case 'x': state = S54; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S7; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S5: /* e.g. "]" */
-			lx_native_ungetc(lx, c); return lx->z = z2, TOK_CLOSEGROUP;
-
-		case S6: /* e.g. "^" */
-			lx_native_ungetc(lx, c); return TOK_INVERT;
-
-		case S7: /* e.g. "[:" */
+		case S3: /* e.g. "[" */
 			switch ((unsigned char) c) {
-			case 'x': state = S18; break;
-			case 'c': state = S9; break;
-			case 'u': state = S16; break;
-			case 'l': state = S13; break;
-			case 'd': state = S10; break;
-			case 'a': state = S8; break;
-			case 'h':
-			case 'v': state = S12; break;
-			case 'p': state = S14; break;
-			case 's': state = S15; break;
-			case 'w': state = S17; break;
-			case 'g': state = S11; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ':': state = S31; break;
+			default:  lx_native_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S8: /* e.g. "[:a" */
+		case S4: /* e.g. "[:word:" */
 			switch ((unsigned char) c) {
-			case 's': state = S21; break;
-			case 'l': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ']': state = S14; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S9: /* e.g. "[:c" */
+		case S5: /* e.g. "[:x" */
 			switch ((unsigned char) c) {
-			case 'n': state = S44; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'd': state = S32; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S10: /* e.g. "[:d" */
+		case S6: /* e.g. "[:word" */
 			switch ((unsigned char) c) {
-			case 'i': state = S24; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ':': state = S4; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S11: /* e.g. "[:g" */
+		case S7: /* e.g. "[:spa" */
 			switch ((unsigned char) c) {
-			case 'r': state = S30; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S41; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S12: /* e.g. "[:h" */
+		case S8: /* e.g. "[:lowe" */
 			switch ((unsigned char) c) {
-			case 's': state = S15; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S13: /* e.g. "[:l" */
+		case S9: /* e.g. "[:alnu" */
 			switch ((unsigned char) c) {
-			case 'o': state = S25; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'm': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S14: /* e.g. "[:p" */
+		case S10: /* e.g. "[:u" */
 			switch ((unsigned char) c) {
-			case 'r': state = S42; break;
-			case 'u': state = S43; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S21; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S15: /* e.g. "[:s" */
-			switch ((unsigned char) c) {
-			case 'p': state = S19; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		case S11: /* e.g. "\\f" */
+			lx_native_ungetc(lx, c); return TOK_ESC;
 
-		case S16: /* e.g. "[:u" */
+		case S12: /* e.g. "\\0" */
 			switch ((unsigned char) c) {
-			case 'p': state = S34; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': break;
+			default:  lx_native_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S17: /* e.g. "[:w" */
-			switch ((unsigned char) c) {
-			case 'o': state = S28; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		case S13: /* e.g. "\\xaa" */
+			lx_native_ungetc(lx, c); return TOK_HEX;
 
-		case S18: /* e.g. "[:x" */
-			switch ((unsigned char) c) {
-			case 'd': state = S10; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		case S14: /* e.g. "[:word:]" */
+			lx_native_ungetc(lx, c); return TOK_NAMED__CLASS;
 
-		case S19: /* e.g. "[:sp" */
-			switch ((unsigned char) c) {
-			case 'a': state = S27; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		case S15: /* e.g. "-" */
+			lx_native_ungetc(lx, c); return TOK_RANGE;
 
-		case S20: /* e.g. "[:al" */
-			switch ((unsigned char) c) {
-			case 'n': state = S22; break;
-			case 'p': state = S23; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		case S16: /* e.g. "]" */
+			lx_native_ungetc(lx, c); return lx->z = z2, TOK_CLOSEGROUP;
 
-		case S21: /* e.g. "[:as" */
+		case S17: /* e.g. "[:di" */
 			switch ((unsigned char) c) {
-			case 'c': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'g': state = S55; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S22: /* e.g. "[:aln" */
+		case S18: /* e.g. "[:pr" */
 			switch ((unsigned char) c) {
-			case 'u': state = S33; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S28; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S23: /* e.g. "[:alp" */
+		case S19: /* e.g. "[:as" */
 			switch ((unsigned char) c) {
-			case 'h': state = S26; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S1; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S24: /* e.g. "[:di" */
-			switch ((unsigned char) c) {
-			case 'g': state = S41; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		case S20: /* e.g. "^" */
+			lx_native_ungetc(lx, c); return TOK_INVERT;
 
-		case S25: /* e.g. "[:lo" */
+		case S21: /* e.g. "[:up" */
 			switch ((unsigned char) c) {
-			case 'w': state = S35; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S25; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S26: /* e.g. "[:alph" */
+		case S22: /* e.g. "[:lo" */
 			switch ((unsigned char) c) {
-			case 'a': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'w': state = S25; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S27: /* e.g. "[:spa" */
+		case S23: /* e.g. "[:pu" */
 			switch ((unsigned char) c) {
-			case 'c': state = S39; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S28: /* e.g. "[:wo" */
+		case S24: /* e.g. "[:al" */
 			switch ((unsigned char) c) {
-			case 'r': state = S29; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S27; break;
+			case 'n': state = S30; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S29: /* e.g. "[:wor" */
+		case S25: /* e.g. "[:low" */
 			switch ((unsigned char) c) {
-			case 'd': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S8; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S30: /* e.g. "[:gr" */
+		case S26: /* e.g. "[:cn" */
 			switch ((unsigned char) c) {
-			case 'a': state = S31; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S56; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S31: /* e.g. "[:gra" */
+		case S27: /* e.g. "[:alp" */
 			switch ((unsigned char) c) {
-			case 'p': state = S32; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S32: /* e.g. "[:grap" */
+		case S28: /* e.g. "[:pri" */
 			switch ((unsigned char) c) {
-			case 'h': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S46; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S33: /* e.g. "[:alnu" */
+		case S29: /* e.g. "[:gra" */
 			switch ((unsigned char) c) {
-			case 'm': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S42; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S34: /* e.g. "[:up" */
+		case S30: /* e.g. "[:aln" */
 			switch ((unsigned char) c) {
-			case 'p': state = S35; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'u': state = S9; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S35: /* e.g. "[:low" */
+		case S31: /* e.g. "[:" */
 			switch ((unsigned char) c) {
-			case 'e': state = S36; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'x': state = S5; break;
+			case 'u': state = S10; break;
+			case 'd': state = S32; break;
+			case 'a': state = S33; break;
+			case 'c': state = S34; break;
+			case 'l': state = S35; break;
+			case 'w': state = S36; break;
+			case 's': state = S37; break;
+			case 'p': state = S38; break;
+			case 'g': state = S45; break;
+			case 'h':
+			case 'v': state = S49; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S36: /* e.g. "[:lowe" */
+		case S32: /* e.g. "[:d" */
 			switch ((unsigned char) c) {
-			case 'r': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S17; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S37: /* e.g. "[:word" */
+		case S33: /* e.g. "[:a" */
 			switch ((unsigned char) c) {
-			case ':': state = S40; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 's': state = S19; break;
+			case 'l': state = S24; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S38: /* e.g. "[:asc" */
+		case S34: /* e.g. "[:c" */
 			switch ((unsigned char) c) {
-			case 'i': state = S51; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S26; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S39: /* e.g. "[:spac" */
+		case S35: /* e.g. "[:l" */
 			switch ((unsigned char) c) {
-			case 'e': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S22; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S40: /* e.g. "[:word:" */
+		case S36: /* e.g. "[:w" */
 			switch ((unsigned char) c) {
-			case ']': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S0; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S41: /* e.g. "[:dig" */
+		case S37: /* e.g. "[:s" */
 			switch ((unsigned char) c) {
-			case 'i': state = S46; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S2; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S42: /* e.g. "[:pr" */
+		case S38: /* e.g. "[:p" */
 			switch ((unsigned char) c) {
-			case 'i': state = S45; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S18; break;
+			case 'u': state = S23; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S43: /* e.g. "[:pu" */
+		case S39: /* e.g. "[:alph" */
 			switch ((unsigned char) c) {
-			case 'n': state = S50; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S44: /* e.g. "[:cn" */
+		case S40: /* e.g. "[:wor" */
 			switch ((unsigned char) c) {
-			case 't': state = S47; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'd': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S45: /* e.g. "[:pri" */
+		case S41: /* e.g. "[:spac" */
 			switch ((unsigned char) c) {
-			case 'n': state = S46; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S46: /* e.g. "[:prin" */
+		case S42: /* e.g. "[:grap" */
 			switch ((unsigned char) c) {
-			case 't': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S47: /* e.g. "[:cnt" */
+		case S43: /* e.g. "[:asci" */
 			switch ((unsigned char) c) {
-			case 'r': state = S48; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S48: /* e.g. "[:cntr" */
+		case S44: /* e.g. "[:cntr" */
 			switch ((unsigned char) c) {
-			case 'l': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'l': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S49: /* e.g. "[:word:]" */
-			lx_native_ungetc(lx, c); return TOK_NAMED__CLASS;
-
-		case S50: /* e.g. "[:pun" */
+		case S45: /* e.g. "[:g" */
 			switch ((unsigned char) c) {
-			case 'c': state = S46; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S54; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S51: /* e.g. "[:asci" */
+		case S46: /* e.g. "[:digi" */
 			switch ((unsigned char) c) {
-			case 'i': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S52: /* e.g. "\\f" */
-			lx_native_ungetc(lx, c); return TOK_ESC;
-
-		case S53: /* e.g. "\\0" */
+		case S47: /* e.g. "[:pun" */
 			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': break;
-			default:  lx_native_ungetc(lx, c); return TOK_OCT;
+			case 'c': state = S46; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S54: /* e.g. "\\x" */
+		case S48: /* e.g. "\\x" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -680,12 +614,55 @@ z1(struct lx_native_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S55; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'f': state = S52; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S55: /* e.g. "\\xa" */
+		case S49: /* e.g. "[:h" */
+			switch ((unsigned char) c) {
+			case 's': state = S37; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S50: /* start */
+			switch ((unsigned char) c) {
+			case '[': state = S3; break;
+			case '-': state = S15; break;
+			case ']': state = S16; break;
+			case '^': state = S20; break;
+			case '\\': state = S51; break;
+			default: state = S53; break;
+			}
+			break;
+
+		case S51: /* e.g. "\\" */
+			switch ((unsigned char) c) {
+			case '-':
+			case '[':
+			case '\\':
+			case ']':
+			case '^':
+			case 'f':
+			case 'n':
+			case 'r':
+			case 't':
+			case 'v': state = S11; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': state = S12; break;
+			case 'x': state = S48; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S52: /* e.g. "\\xa" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -708,13 +685,34 @@ z1(struct lx_native_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S56; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'f': state = S13; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S56: /* e.g. "\\xaa" */
-			lx_native_ungetc(lx, c); return TOK_HEX;
+		case S53: /* e.g. "a" */
+			lx_native_ungetc(lx, c); return TOK_CHAR;
+
+		case S54: /* e.g. "[:gr" */
+			switch ((unsigned char) c) {
+			case 'a': state = S29; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S55: /* e.g. "[:dig" */
+			switch ((unsigned char) c) {
+			case 'i': state = S46; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S56: /* e.g. "[:cnt" */
+			switch ((unsigned char) c) {
+			case 'r': state = S44; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
 		default:
 			; /* unreached */
@@ -727,19 +725,19 @@ z1(struct lx_native_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_RANGE;
 	case S3: return TOK_CHAR;
-	case S5: return TOK_CLOSEGROUP;
-	case S6: return TOK_INVERT;
-	case S49: return TOK_NAMED__CLASS;
-	case S52: return TOK_ESC;
-	case S53: return TOK_OCT;
-	case S56: return TOK_HEX;
+	case S11: return TOK_ESC;
+	case S12: return TOK_OCT;
+	case S13: return TOK_HEX;
+	case S14: return TOK_NAMED__CLASS;
+	case S15: return TOK_RANGE;
+	case S16: return TOK_CLOSEGROUP;
+	case S20: return TOK_INVERT;
+	case S53: return TOK_CHAR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -767,87 +765,79 @@ z2(struct lx_native_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S20;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "\\xa" */
 			switch ((unsigned char) c) {
-			case '$': state = S2; break;
-			case '(': state = S3; break;
-			case ')': state = S4; break;
-			case '*': state = S5; break;
-			case '+': state = S6; break;
-			case '.': state = S7; break;
-			case '?': state = S8; break;
-			case '[': state = S9; break;
-			case '\\': state = S10; break;
-			case '^': state = S11; break;
-			case '{': state = S12; break;
-			case '|': state = S13; break;
-			default: state = S1; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': state = S16; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_native_ungetc(lx, c); return TOK_CHAR;
+		case S1: /* e.g. "\\0" */
+			switch ((unsigned char) c) {
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': state = S19; break;
+			default:  lx_native_ungetc(lx, c); return TOK_OCT;
+			}
+			break;
+
+		case S2: /* e.g. "\\000" */
+			lx_native_ungetc(lx, c); return TOK_OCT;
 
-		case S2: /* e.g. "$" */
+		case S3: /* e.g. "$" */
 			lx_native_ungetc(lx, c); return TOK_END;
 
-		case S3: /* e.g. "(" */
+		case S4: /* e.g. "(" */
 			lx_native_ungetc(lx, c); return TOK_OPENSUB;
 
-		case S4: /* e.g. ")" */
+		case S5: /* e.g. ")" */
 			lx_native_ungetc(lx, c); return TOK_CLOSESUB;
 
-		case S5: /* e.g. "*" */
+		case S6: /* e.g. "*" */
 			lx_native_ungetc(lx, c); return TOK_STAR;
 
-		case S6: /* e.g. "+" */
+		case S7: /* e.g. "+" */
 			lx_native_ungetc(lx, c); return TOK_PLUS;
 
-		case S7: /* e.g. "." */
+		case S8: /* e.g. "." */
 			lx_native_ungetc(lx, c); return TOK_ANY;
 
-		case S8: /* e.g. "?" */
+		case S9: /* e.g. "?" */
 			lx_native_ungetc(lx, c); return TOK_OPT;
 
-		case S9: /* e.g. "[" */
+		case S10: /* e.g. "[" */
 			lx_native_ungetc(lx, c); return lx->z = z1, TOK_OPENGROUP;
 
-		case S10: /* e.g. "\\" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S15; break;
-			case '$':
-			case '(':
-			case ')':
-			case '*':
-			case '+':
-			case '.':
-			case '?':
-			case '[':
-			case '\\':
-			case '^':
-			case 'f':
-			case 'n':
-			case 'r':
-			case 't':
-			case 'v':
-			case '{':
-			case '|': state = S14; break;
-			case 'x': state = S16; break;
-			default:  lx_native_ungetc(lx, c); return TOK_CHAR;
-			}
-			break;
-
 		case S11: /* e.g. "^" */
 			lx_native_ungetc(lx, c); return TOK_START;
 
@@ -860,21 +850,7 @@ z2(struct lx_native_lx *lx)
 		case S14: /* e.g. "\\f" */
 			lx_native_ungetc(lx, c); return TOK_ESC;
 
-		case S15: /* e.g. "\\0" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S17; break;
-			default:  lx_native_ungetc(lx, c); return TOK_OCT;
-			}
-			break;
-
-		case S16: /* e.g. "\\x" */
+		case S15: /* e.g. "\\x" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -897,12 +873,18 @@ z2(struct lx_native_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S18; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'f': state = S0; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S17: /* e.g. "\\00" */
+		case S16: /* e.g. "\\xaa" */
+			lx_native_ungetc(lx, c); return TOK_HEX;
+
+		case S17: /* e.g. "a" */
+			lx_native_ungetc(lx, c); return TOK_CHAR;
+
+		case S18: /* e.g. "\\" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -911,12 +893,30 @@ z2(struct lx_native_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7': state = S20; break;
-			default:  lx_native_ungetc(lx, c); return TOK_OCT;
+			case '7': state = S1; break;
+			case '$':
+			case '(':
+			case ')':
+			case '*':
+			case '+':
+			case '.':
+			case '?':
+			case '[':
+			case '\\':
+			case '^':
+			case 'f':
+			case 'n':
+			case 'r':
+			case 't':
+			case 'v':
+			case '{':
+			case '|': state = S14; break;
+			case 'x': state = S15; break;
+			default:  lx_native_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S18: /* e.g. "\\xa" */
+		case S19: /* e.g. "\\00" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -925,30 +925,28 @@ z2(struct lx_native_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S19; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '7': state = S2; break;
+			default:  lx_native_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S19: /* e.g. "\\xaa" */
-			lx_native_ungetc(lx, c); return TOK_HEX;
-
-		case S20: /* e.g. "\\000" */
-			lx_native_ungetc(lx, c); return TOK_OCT;
+		case S20: /* start */
+			switch ((unsigned char) c) {
+			case '$': state = S3; break;
+			case '(': state = S4; break;
+			case ')': state = S5; break;
+			case '*': state = S6; break;
+			case '+': state = S7; break;
+			case '.': state = S8; break;
+			case '?': state = S9; break;
+			case '[': state = S10; break;
+			case '^': state = S11; break;
+			case '{': state = S12; break;
+			case '|': state = S13; break;
+			case '\\': state = S18; break;
+			default: state = S17; break;
+			}
+			break;
 
 		default:
 			; /* unreached */
@@ -961,28 +959,28 @@ z2(struct lx_native_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_END;
-	case S3: return TOK_OPENSUB;
-	case S4: return TOK_CLOSESUB;
-	case S5: return TOK_STAR;
-	case S6: return TOK_PLUS;
-	case S7: return TOK_ANY;
-	case S8: return TOK_OPT;
-	case S9: return TOK_OPENGROUP;
-	case S10: return TOK_CHAR;
+	case S1: return TOK_OCT;
+	case S2: return TOK_OCT;
+	case S3: return TOK_END;
+	case S4: return TOK_OPENSUB;
+	case S5: return TOK_CLOSESUB;
+	case S6: return TOK_STAR;
+	case S7: return TOK_PLUS;
+	case S8: return TOK_ANY;
+	case S9: return TOK_OPT;
+	case S10: return TOK_OPENGROUP;
 	case S11: return TOK_START;
 	case S12: return TOK_OPENCOUNT;
 	case S13: return TOK_ALT;
 	case S14: return TOK_ESC;
-	case S15: return TOK_OCT;
-	case S17: return TOK_OCT;
-	case S19: return TOK_HEX;
-	case S20: return TOK_OCT;
+	case S16: return TOK_HEX;
+	case S17: return TOK_CHAR;
+	case S18: return TOK_CHAR;
+	case S19: return TOK_OCT;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -1027,42 +1025,82 @@ lx_native_example(enum lx_native_token (*z)(struct lx_native_lx *), enum lx_nati
 
 	if (z == z0) {
 		switch (t) {
-		case TOK_COUNT: return "0";
-		case TOK_SEP: return ",";
-		case TOK_CLOSECOUNT: return "}";
+		case TOK_COUNT: return "";
+		case TOK_SEP: return "";
+		case TOK_CLOSECOUNT: return "";
+		case TOK_OPENCOUNT: return "";
+		case TOK_CHAR: return "";
+		case TOK_NAMED__CLASS: return "";
+		case TOK_RANGE: return "";
+		case TOK_INVERT: return "";
+		case TOK_CLOSEGROUP: return "";
+		case TOK_OPENGROUP: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_ALT: return "";
+		case TOK_ANY: return "";
+		case TOK_PLUS: return "";
+		case TOK_STAR: return "";
+		case TOK_OPT: return "";
+		case TOK_END: return "";
+		case TOK_START: return "";
+		case TOK_CLOSESUB: return "";
+		case TOK_OPENSUB: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z1) {
 		switch (t) {
-		case TOK_CHAR: return "a";
-		case TOK_NAMED__CLASS: return "[:word:]";
-		case TOK_RANGE: return "-";
-		case TOK_INVERT: return "^";
-		case TOK_CLOSEGROUP: return "]";
-		case TOK_HEX: return "\\xaa";
-		case TOK_OCT: return "\\0";
-		case TOK_ESC: return "\\f";
+		case TOK_COUNT: return "";
+		case TOK_SEP: return "";
+		case TOK_CLOSECOUNT: return "";
+		case TOK_OPENCOUNT: return "";
+		case TOK_CHAR: return "";
+		case TOK_NAMED__CLASS: return "";
+		case TOK_RANGE: return "";
+		case TOK_INVERT: return "";
+		case TOK_CLOSEGROUP: return "";
+		case TOK_OPENGROUP: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_ALT: return "";
+		case TOK_ANY: return "";
+		case TOK_PLUS: return "";
+		case TOK_STAR: return "";
+		case TOK_OPT: return "";
+		case TOK_END: return "";
+		case TOK_START: return "";
+		case TOK_CLOSESUB: return "";
+		case TOK_OPENSUB: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z2) {
 		switch (t) {
-		case TOK_OPENCOUNT: return "{";
-		case TOK_CHAR: return "a";
-		case TOK_OPENGROUP: return "[";
-		case TOK_HEX: return "\\xaa";
-		case TOK_OCT: return "\\0";
-		case TOK_ESC: return "\\f";
-		case TOK_ALT: return "|";
-		case TOK_ANY: return ".";
-		case TOK_PLUS: return "+";
-		case TOK_STAR: return "*";
-		case TOK_OPT: return "?";
-		case TOK_END: return "$";
-		case TOK_START: return "^";
-		case TOK_CLOSESUB: return ")";
-		case TOK_OPENSUB: return "(";
+		case TOK_COUNT: return "";
+		case TOK_SEP: return "";
+		case TOK_CLOSECOUNT: return "";
+		case TOK_OPENCOUNT: return "";
+		case TOK_CHAR: return "";
+		case TOK_NAMED__CLASS: return "";
+		case TOK_RANGE: return "";
+		case TOK_INVERT: return "";
+		case TOK_CLOSEGROUP: return "";
+		case TOK_OPENGROUP: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_ALT: return "";
+		case TOK_ANY: return "";
+		case TOK_PLUS: return "";
+		case TOK_STAR: return "";
+		case TOK_OPT: return "";
+		case TOK_END: return "";
+		case TOK_START: return "";
+		case TOK_CLOSESUB: return "";
+		case TOK_OPENSUB: return "";
 		default: goto error;
 		}
 	}
@@ -1082,7 +1120,6 @@ lx_native_init(struct lx_native_lx *lx)
 
 	*lx = lx_default;
 
-	lx->c = EOF;
 	lx->z = z2;
 
 	lx->end.byte = 0;
@@ -1098,7 +1135,7 @@ lx_native_next(struct lx_native_lx *lx)
 	assert(lx != NULL);
 	assert(lx->z != NULL);
 
-	if (lx->lgetc == NULL) {
+	if (lx->p == NULL) {
 		return TOK_EOF;
 	}
 
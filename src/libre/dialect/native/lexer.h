@@ -43,10 +43,8 @@ struct lx_pos {
 };
 
 struct lx_native_lx {
-	int (*lgetc)(struct lx_native_lx *lx);
-	void *getc_opaque;
-
-	int c; /* lx_native_ungetc buffer */
+	const char *p; /* input string */
+	const char *e; /* one past end of input */
 
 	struct lx_pos start;
 	struct lx_pos end;
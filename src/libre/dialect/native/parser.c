@@ -9,7 +9,7 @@
 
 /* BEGINNING OF HEADER */
 
-#line 142 "src/libre/parser.act"
+#line 140 "src/libre/parser.act"
 
 
 	#include <assert.h>
@@ -100,6 +100,7 @@
 		enum LX_TOKEN lex_tok;
 		enum LX_TOKEN lex_tok_save;
 		int overlap; /* permit overlap in groups */
+		struct re_arena *arena;
 
 		/*
 		 * Lexical position stored for syntax errors.
@@ -121,9 +122,6 @@
 		struct LX_STATE lx;
 		struct lx_dynbuf buf; /* XXX: unneccessary since we're lexing from a string */
 
-		re_getchar_fun *f;
-		void *opaque;
-
 		/* TODO: use lx's generated conveniences for the pattern buffer */
 		char a[512];
 		char *p;
@@ -209,7 +207,7 @@
 		return s;
 	}
 
-#line 213 "src/libre/dialect/native/parser.c"
+#line 211 "src/libre/dialect/native/parser.c"
 
 
 #ifndef ERROR_TERMINAL
@@ -250,17 +248,17 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hhead(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: INVERT */
 			{
-#line 237 "src/libre/parser.act"
+#line 235 "src/libre/parser.act"
 
 		ZI107 = '^';
 	
-#line 258 "src/libre/dialect/native/parser.c"
+#line 256 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF EXTRACT: INVERT */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: ast-make-invert */
 			{
-#line 771 "src/libre/parser.act"
+#line 769 "src/libre/parser.act"
 
 		struct ast_expr *any;
 
@@ -288,17 +286,17 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hhead(flags flags, lex_state lex_state, act_
 		 * a better idea.
 		 */
 
-		any = ast_make_expr_named(&class_any);
+		any = ast_make_expr_named(act_state->arena, &class_any);
 		if (any == NULL) {
 			goto ZL1;
 		}
 
-		(*ZIclass) = ast_make_expr_subtract(any, (*ZIclass));
+		(*ZIclass) = ast_make_expr_subtract(act_state->arena, any, (*ZIclass));
 		if ((*ZIclass) == NULL) {
 			goto ZL1;
 		}
 	
-#line 302 "src/libre/dialect/native/parser.c"
+#line 300 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-make-invert */
 		}
@@ -334,13 +332,13 @@ ZL2_expr_C_Ccharacter_Hclass_C_Clist_Hof_Hclass_Hterms:;
 				}
 				/* BEGINNING OF ACTION: ast-add-alt */
 				{
-#line 827 "src/libre/parser.act"
+#line 825 "src/libre/parser.act"
 
-		if (!ast_add_expr_alt((ZIclass), (ZInode))) {
+		if (!ast_add_expr_alt(act_state->arena, (ZIclass), (ZInode))) {
 			goto ZL4;
 		}
 	
-#line 344 "src/libre/dialect/native/parser.c"
+#line 342 "src/libre/dialect/native/parser.c"
 				}
 				/* END OF ACTION: ast-add-alt */
 			}
@@ -349,14 +347,14 @@ ZL2_expr_C_Ccharacter_Hclass_C_Clist_Hof_Hclass_Hterms:;
 			{
 				/* BEGINNING OF ACTION: err-expected-term */
 				{
-#line 469 "src/libre/parser.act"
+#line 467 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXTERM;
 		}
 		goto ZL1;
 	
-#line 360 "src/libre/dialect/native/parser.c"
+#line 358 "src/libre/dialect/native/parser.c"
 				}
 				/* END OF ACTION: err-expected-term */
 			}
@@ -403,13 +401,13 @@ ZL2_expr_C_Clist_Hof_Hpieces:;
 		}
 		/* BEGINNING OF ACTION: ast-add-concat */
 		{
-#line 821 "src/libre/parser.act"
+#line 819 "src/libre/parser.act"
 
-		if (!ast_add_expr_concat((ZIcat), (ZIa))) {
+		if (!ast_add_expr_concat(act_state->arena, (ZIcat), (ZIa))) {
 			goto ZL1;
 		}
 	
-#line 413 "src/libre/dialect/native/parser.c"
+#line 411 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: ast-add-concat */
 		/* BEGINNING OF INLINE: 177 */
@@ -457,7 +455,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 					/* BEGINNING OF EXTRACT: CHAR */
 					{
-#line 414 "src/libre/parser.act"
+#line 412 "src/libre/parser.act"
 
 		/* the first byte may be '\x00' */
 		assert(lex_state->buf.a[1] == '\0');
@@ -467,7 +465,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 		ZIc = lex_state->buf.a[0];
 	
-#line 471 "src/libre/dialect/native/parser.c"
+#line 469 "src/libre/dialect/native/parser.c"
 					}
 					/* END OF EXTRACT: CHAR */
 					ADVANCE_LEXER;
@@ -480,7 +478,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 					/* BEGINNING OF EXTRACT: ESC */
 					{
-#line 287 "src/libre/parser.act"
+#line 285 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] != '\0');
@@ -501,7 +499,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 		ZI94 = lex_state->lx.start;
 		ZI95   = lex_state->lx.end;
 	
-#line 505 "src/libre/dialect/native/parser.c"
+#line 503 "src/libre/dialect/native/parser.c"
 					}
 					/* END OF EXTRACT: ESC */
 					ADVANCE_LEXER;
@@ -514,7 +512,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 					/* BEGINNING OF EXTRACT: HEX */
 					{
-#line 378 "src/libre/parser.act"
+#line 376 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -554,7 +552,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 		ZIc = (char) (unsigned char) u;
 	
-#line 558 "src/libre/dialect/native/parser.c"
+#line 556 "src/libre/dialect/native/parser.c"
 					}
 					/* END OF EXTRACT: HEX */
 					ADVANCE_LEXER;
@@ -567,7 +565,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 					/* BEGINNING OF EXTRACT: OCT */
 					{
-#line 338 "src/libre/parser.act"
+#line 336 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -607,7 +605,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 		ZIc = (char) (unsigned char) u;
 	
-#line 611 "src/libre/dialect/native/parser.c"
+#line 609 "src/libre/dialect/native/parser.c"
 					}
 					/* END OF EXTRACT: OCT */
 					ADVANCE_LEXER;
@@ -620,14 +618,14 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 		/* END OF INLINE: 92 */
 		/* BEGINNING OF ACTION: ast-make-literal */
 		{
-#line 683 "src/libre/parser.act"
+#line 681 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_literal((ZIc));
+		(ZInode) = ast_make_expr_literal(act_state->arena, (ZIc));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 631 "src/libre/dialect/native/parser.c"
+#line 629 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: ast-make-literal */
 	}
@@ -653,7 +651,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: CHAR */
 			{
-#line 414 "src/libre/parser.act"
+#line 412 "src/libre/parser.act"
 
 		/* the first byte may be '\x00' */
 		assert(lex_state->buf.a[1] == '\0');
@@ -663,7 +661,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 		ZI209 = lex_state->buf.a[0];
 	
-#line 667 "src/libre/dialect/native/parser.c"
+#line 665 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF EXTRACT: CHAR */
 			ADVANCE_LEXER;
@@ -682,7 +680,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: ESC */
 			{
-#line 287 "src/libre/parser.act"
+#line 285 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] != '\0');
@@ -703,7 +701,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 		ZI198 = lex_state->lx.start;
 		ZI199   = lex_state->lx.end;
 	
-#line 707 "src/libre/dialect/native/parser.c"
+#line 705 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF EXTRACT: ESC */
 			ADVANCE_LEXER;
@@ -722,7 +720,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: HEX */
 			{
-#line 378 "src/libre/parser.act"
+#line 376 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -762,7 +760,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 		ZI205 = (char) (unsigned char) u;
 	
-#line 766 "src/libre/dialect/native/parser.c"
+#line 764 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF EXTRACT: HEX */
 			ADVANCE_LEXER;
@@ -781,7 +779,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: OCT */
 			{
-#line 338 "src/libre/parser.act"
+#line 336 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -821,7 +819,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 		ZI201 = (char) (unsigned char) u;
 	
-#line 825 "src/libre/dialect/native/parser.c"
+#line 823 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF EXTRACT: OCT */
 			ADVANCE_LEXER;
@@ -872,12 +870,12 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 		case (TOK_OPENGROUP):
 			/* BEGINNING OF EXTRACT: OPENGROUP */
 			{
-#line 247 "src/libre/parser.act"
+#line 245 "src/libre/parser.act"
 
 		ZIstart = lex_state->lx.start;
 		ZI153   = lex_state->lx.end;
 	
-#line 881 "src/libre/dialect/native/parser.c"
+#line 879 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF EXTRACT: OPENGROUP */
 			break;
@@ -887,14 +885,14 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 		ADVANCE_LEXER;
 		/* BEGINNING OF ACTION: ast-make-alt */
 		{
-#line 676 "src/libre/parser.act"
+#line 674 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_alt();
+		(ZInode) = ast_make_expr_alt(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 898 "src/libre/dialect/native/parser.c"
+#line 896 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: ast-make-alt */
 		ZItmp = ZInode;
@@ -914,13 +912,13 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 				case (TOK_CLOSEGROUP):
 					/* BEGINNING OF EXTRACT: CLOSEGROUP */
 					{
-#line 267 "src/libre/parser.act"
+#line 265 "src/libre/parser.act"
 
 		ZI157 = ']';
 		ZI158 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 924 "src/libre/dialect/native/parser.c"
+#line 922 "src/libre/dialect/native/parser.c"
 					}
 					/* END OF EXTRACT: CLOSEGROUP */
 					break;
@@ -930,12 +928,12 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 				ADVANCE_LEXER;
 				/* BEGINNING OF ACTION: mark-group */
 				{
-#line 543 "src/libre/parser.act"
+#line 541 "src/libre/parser.act"
 
 		mark(&act_state->groupstart, &(ZIstart));
 		mark(&act_state->groupend,   &(ZIend));
 	
-#line 939 "src/libre/dialect/native/parser.c"
+#line 937 "src/libre/dialect/native/parser.c"
 				}
 				/* END OF ACTION: mark-group */
 			}
@@ -944,14 +942,14 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 			{
 				/* BEGINNING OF ACTION: err-expected-closegroup */
 				{
-#line 504 "src/libre/parser.act"
+#line 502 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXCLOSEGROUP;
 		}
 		goto ZL1;
 	
-#line 955 "src/libre/dialect/native/parser.c"
+#line 953 "src/libre/dialect/native/parser.c"
 				}
 				/* END OF ACTION: err-expected-closegroup */
 				ZIend = ZIstart;
@@ -961,7 +959,7 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 		/* END OF INLINE: 156 */
 		/* BEGINNING OF ACTION: mark-expr */
 		{
-#line 560 "src/libre/parser.act"
+#line 558 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 
@@ -976,7 +974,7 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 		(ZItmp)->u.class.end   = ast_end;
 */
 	
-#line 980 "src/libre/dialect/native/parser.c"
+#line 978 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: mark-expr */
 	}
@@ -1008,21 +1006,21 @@ p_expr_C_Cpiece(flags flags, lex_state lex_state, act_state act_state, err err,
 		}
 		/* BEGINNING OF ACTION: ast-make-piece */
 		{
-#line 694 "src/libre/parser.act"
+#line 692 "src/libre/parser.act"
 
 		if ((ZIc).min == 0 && (ZIc).max == 0) {
-			(ZInode) = ast_make_expr_empty();
+			(ZInode) = ast_make_expr_empty(act_state->arena);
 		} else if ((ZIc).min == 1 && (ZIc).max == 1) {
 			(ZInode) = (ZIe);
 		} else {
-			(ZInode) = ast_make_expr_repeat((ZIe), (ZIc));
+			(ZInode) = ast_make_expr_repeat(act_state->arena, (ZIe), (ZIc));
 		}
 		if ((ZInode) == NULL) {
 			err->e = RE_EXEOF;
 			goto ZL1;
 		}
 	
-#line 1026 "src/libre/dialect/native/parser.c"
+#line 1024 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: ast-make-piece */
 	}
@@ -1046,14 +1044,14 @@ p_expr(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__ex
 		{
 			/* BEGINNING OF ACTION: ast-make-alt */
 			{
-#line 676 "src/libre/parser.act"
+#line 674 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_alt();
+		(ZInode) = ast_make_expr_alt(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1057 "src/libre/dialect/native/parser.c"
+#line 1055 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-make-alt */
 			p_expr_C_Clist_Hof_Halts (flags, lex_state, act_state, err, ZInode);
@@ -1067,14 +1065,14 @@ p_expr(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__ex
 		{
 			/* BEGINNING OF ACTION: ast-make-empty */
 			{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_empty();
+		(ZInode) = ast_make_expr_empty(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1078 "src/libre/dialect/native/parser.c"
+#line 1076 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-make-empty */
 		}
@@ -1087,26 +1085,26 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-alts */
 		{
-#line 490 "src/libre/parser.act"
+#line 488 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXALTS;
 		}
 		goto ZL2;
 	
-#line 1098 "src/libre/dialect/native/parser.c"
+#line 1096 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: err-expected-alts */
 		/* BEGINNING OF ACTION: ast-make-empty */
 		{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_empty();
+		(ZInode) = ast_make_expr_empty(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL2;
 		}
 	
-#line 1110 "src/libre/dialect/native/parser.c"
+#line 1108 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: ast-make-empty */
 	}
@@ -1154,14 +1152,14 @@ p_re__native(flags flags, lex_state lex_state, act_state act_state, err err, t_a
 			{
 				/* BEGINNING OF ACTION: err-expected-eof */
 				{
-#line 532 "src/libre/parser.act"
+#line 530 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXEOF;
 		}
 		goto ZL1;
 	
-#line 1165 "src/libre/dialect/native/parser.c"
+#line 1163 "src/libre/dialect/native/parser.c"
 				}
 				/* END OF ACTION: err-expected-eof */
 			}
@@ -1187,14 +1185,14 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 		{
 			/* BEGINNING OF ACTION: ast-make-literal */
 			{
-#line 683 "src/libre/parser.act"
+#line 681 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_literal((*ZI209));
+		(ZInode) = ast_make_expr_literal(act_state->arena, (*ZI209));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1198 "src/libre/dialect/native/parser.c"
+#line 1196 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-make-literal */
 		}
@@ -1208,12 +1206,12 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 			/* BEGINNING OF ACTION: ast-range-endpoint-literal */
 			{
-#line 631 "src/libre/parser.act"
+#line 629 "src/libre/parser.act"
 
 		(ZIa).type = AST_ENDPOINT_LITERAL;
 		(ZIa).u.literal.c = (*ZI209);
 	
-#line 1217 "src/libre/dialect/native/parser.c"
+#line 1215 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-range-endpoint-literal */
 			/* BEGINNING OF INLINE: 129 */
@@ -1227,13 +1225,13 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 					case (TOK_RANGE):
 						/* BEGINNING OF EXTRACT: RANGE */
 						{
-#line 241 "src/libre/parser.act"
+#line 239 "src/libre/parser.act"
 
 		ZI130 = '-';
 		ZI131 = lex_state->lx.start;
 		ZI132   = lex_state->lx.end;
 	
-#line 1237 "src/libre/dialect/native/parser.c"
+#line 1235 "src/libre/dialect/native/parser.c"
 						}
 						/* END OF EXTRACT: RANGE */
 						break;
@@ -1247,14 +1245,14 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 				{
 					/* BEGINNING OF ACTION: err-expected-range */
 					{
-#line 497 "src/libre/parser.act"
+#line 495 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXRANGE;
 		}
 		goto ZL1;
 	
-#line 1258 "src/libre/dialect/native/parser.c"
+#line 1256 "src/libre/dialect/native/parser.c"
 					}
 					/* END OF ACTION: err-expected-range */
 				}
@@ -1270,7 +1268,7 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 						/* BEGINNING OF EXTRACT: CHAR */
 						{
-#line 414 "src/libre/parser.act"
+#line 412 "src/libre/parser.act"
 
 		/* the first byte may be '\x00' */
 		assert(lex_state->buf.a[1] == '\0');
@@ -1280,7 +1278,7 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 		ZIcz = lex_state->buf.a[0];
 	
-#line 1284 "src/libre/dialect/native/parser.c"
+#line 1282 "src/libre/dialect/native/parser.c"
 						}
 						/* END OF EXTRACT: CHAR */
 						ADVANCE_LEXER;
@@ -1292,7 +1290,7 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 						/* BEGINNING OF EXTRACT: ESC */
 						{
-#line 287 "src/libre/parser.act"
+#line 285 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] != '\0');
@@ -1313,7 +1311,7 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 		ZI135 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 1317 "src/libre/dialect/native/parser.c"
+#line 1315 "src/libre/dialect/native/parser.c"
 						}
 						/* END OF EXTRACT: ESC */
 						ADVANCE_LEXER;
@@ -1325,7 +1323,7 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 						/* BEGINNING OF EXTRACT: HEX */
 						{
-#line 378 "src/libre/parser.act"
+#line 376 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -1365,7 +1363,7 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 		ZIcz = (char) (unsigned char) u;
 	
-#line 1369 "src/libre/dialect/native/parser.c"
+#line 1367 "src/libre/dialect/native/parser.c"
 						}
 						/* END OF EXTRACT: HEX */
 						ADVANCE_LEXER;
@@ -1377,7 +1375,7 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 						/* BEGINNING OF EXTRACT: OCT */
 						{
-#line 338 "src/libre/parser.act"
+#line 336 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -1417,7 +1415,7 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 		ZIcz = (char) (unsigned char) u;
 	
-#line 1421 "src/libre/dialect/native/parser.c"
+#line 1419 "src/libre/dialect/native/parser.c"
 						}
 						/* END OF EXTRACT: OCT */
 						ADVANCE_LEXER;
@@ -1429,13 +1427,13 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 						/* BEGINNING OF EXTRACT: RANGE */
 						{
-#line 241 "src/libre/parser.act"
+#line 239 "src/libre/parser.act"
 
 		ZIcz = '-';
 		ZI140 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 1439 "src/libre/dialect/native/parser.c"
+#line 1437 "src/libre/dialect/native/parser.c"
 						}
 						/* END OF EXTRACT: RANGE */
 						ADVANCE_LEXER;
@@ -1448,27 +1446,27 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 			/* END OF INLINE: 133 */
 			/* BEGINNING OF ACTION: ast-range-endpoint-literal */
 			{
-#line 631 "src/libre/parser.act"
+#line 629 "src/libre/parser.act"
 
 		(ZIz).type = AST_ENDPOINT_LITERAL;
 		(ZIz).u.literal.c = (ZIcz);
 	
-#line 1457 "src/libre/dialect/native/parser.c"
+#line 1455 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-range-endpoint-literal */
 			/* BEGINNING OF ACTION: mark-range */
 			{
-#line 548 "src/libre/parser.act"
+#line 546 "src/libre/parser.act"
 
 		mark(&act_state->rangestart, &(*ZI210));
 		mark(&act_state->rangeend,   &(ZIend));
 	
-#line 1467 "src/libre/dialect/native/parser.c"
+#line 1465 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: mark-range */
 			/* BEGINNING OF ACTION: ast-range-distinct */
 			{
-#line 643 "src/libre/parser.act"
+#line 641 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 
@@ -1485,12 +1483,12 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 			goto ZL1;
 		}
 	
-#line 1489 "src/libre/dialect/native/parser.c"
+#line 1487 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-range-distinct */
 			/* BEGINNING OF ACTION: ast-make-range */
 			{
-#line 784 "src/libre/parser.act"
+#line 782 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 		unsigned char lower, upper;
@@ -1518,12 +1516,12 @@ p_212(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 			goto ZL1;
 		}
 
-		(ZInode) = ast_make_expr_range(&(ZIa), ast_start, &(ZIz), ast_end);
+		(ZInode) = ast_make_expr_range(act_state->arena, &(ZIa), ast_start, &(ZIz), ast_end);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1527 "src/libre/dialect/native/parser.c"
+#line 1525 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-make-range */
 		}
@@ -1552,28 +1550,28 @@ p_215(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 			/* BEGINNING OF EXTRACT: CLOSECOUNT */
 			{
-#line 278 "src/libre/parser.act"
+#line 276 "src/libre/parser.act"
 
 		ZI170 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 1561 "src/libre/dialect/native/parser.c"
+#line 1559 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF EXTRACT: CLOSECOUNT */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: mark-count */
 			{
-#line 553 "src/libre/parser.act"
+#line 551 "src/libre/parser.act"
 
 		mark(&act_state->countstart, &(*ZI213));
 		mark(&act_state->countend,   &(ZIend));
 	
-#line 1572 "src/libre/dialect/native/parser.c"
+#line 1570 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: mark-count */
 			/* BEGINNING OF ACTION: count-range */
 			{
-#line 613 "src/libre/parser.act"
+#line 611 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 
@@ -1593,7 +1591,7 @@ p_215(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 		(ZIc) = ast_make_count((*ZIm), &ast_start, (*ZIm), &ast_end);
 	
-#line 1597 "src/libre/dialect/native/parser.c"
+#line 1595 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: count-range */
 		}
@@ -1609,7 +1607,7 @@ p_215(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 			case (TOK_COUNT):
 				/* BEGINNING OF EXTRACT: COUNT */
 				{
-#line 429 "src/libre/parser.act"
+#line 427 "src/libre/parser.act"
 
 		unsigned long u;
 		char *e;
@@ -1629,7 +1627,7 @@ p_215(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 		ZIn = (unsigned int) u;
 	
-#line 1633 "src/libre/dialect/native/parser.c"
+#line 1631 "src/libre/dialect/native/parser.c"
 				}
 				/* END OF EXTRACT: COUNT */
 				break;
@@ -1641,12 +1639,12 @@ p_215(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 			case (TOK_CLOSECOUNT):
 				/* BEGINNING OF EXTRACT: CLOSECOUNT */
 				{
-#line 278 "src/libre/parser.act"
+#line 276 "src/libre/parser.act"
 
 		ZI173 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 1650 "src/libre/dialect/native/parser.c"
+#line 1648 "src/libre/dialect/native/parser.c"
 				}
 				/* END OF EXTRACT: CLOSECOUNT */
 				break;
@@ -1656,17 +1654,17 @@ p_215(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: mark-count */
 			{
-#line 553 "src/libre/parser.act"
+#line 551 "src/libre/parser.act"
 
 		mark(&act_state->countstart, &(*ZI213));
 		mark(&act_state->countend,   &(ZIend));
 	
-#line 1665 "src/libre/dialect/native/parser.c"
+#line 1663 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: mark-count */
 			/* BEGINNING OF ACTION: count-range */
 			{
-#line 613 "src/libre/parser.act"
+#line 611 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 
@@ -1686,7 +1684,7 @@ p_215(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 		(ZIc) = ast_make_count((*ZIm), &ast_start, (ZIn), &ast_end);
 	
-#line 1690 "src/libre/dialect/native/parser.c"
+#line 1688 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: count-range */
 		}
@@ -1721,13 +1719,13 @@ ZL2_expr_C_Clist_Hof_Halts:;
 		}
 		/* BEGINNING OF ACTION: ast-add-alt */
 		{
-#line 827 "src/libre/parser.act"
+#line 825 "src/libre/parser.act"
 
-		if (!ast_add_expr_alt((ZIalts), (ZIa))) {
+		if (!ast_add_expr_alt(act_state->arena, (ZIalts), (ZIa))) {
 			goto ZL1;
 		}
 	
-#line 1731 "src/libre/dialect/native/parser.c"
+#line 1729 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: ast-add-alt */
 		/* BEGINNING OF INLINE: 183 */
@@ -1752,14 +1750,14 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-alts */
 		{
-#line 490 "src/libre/parser.act"
+#line 488 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXALTS;
 		}
 		goto ZL4;
 	
-#line 1763 "src/libre/dialect/native/parser.c"
+#line 1761 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: err-expected-alts */
 	}
@@ -1784,12 +1782,12 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 
 			/* BEGINNING OF EXTRACT: OPENCOUNT */
 			{
-#line 273 "src/libre/parser.act"
+#line 271 "src/libre/parser.act"
 
 		ZI213 = lex_state->lx.start;
 		ZI214   = lex_state->lx.end;
 	
-#line 1793 "src/libre/dialect/native/parser.c"
+#line 1791 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF EXTRACT: OPENCOUNT */
 			ADVANCE_LEXER;
@@ -1797,7 +1795,7 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 			case (TOK_COUNT):
 				/* BEGINNING OF EXTRACT: COUNT */
 				{
-#line 429 "src/libre/parser.act"
+#line 427 "src/libre/parser.act"
 
 		unsigned long u;
 		char *e;
@@ -1817,7 +1815,7 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 
 		ZIm = (unsigned int) u;
 	
-#line 1821 "src/libre/dialect/native/parser.c"
+#line 1819 "src/libre/dialect/native/parser.c"
 				}
 				/* END OF EXTRACT: COUNT */
 				break;
@@ -1837,11 +1835,11 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: count-zero-or-one */
 			{
-#line 603 "src/libre/parser.act"
+#line 601 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(0, NULL, 1, NULL);
 	
-#line 1845 "src/libre/dialect/native/parser.c"
+#line 1843 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: count-zero-or-one */
 		}
@@ -1851,11 +1849,11 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: count-one-or-more */
 			{
-#line 599 "src/libre/parser.act"
+#line 597 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(1, NULL, AST_COUNT_UNBOUNDED, NULL);
 	
-#line 1859 "src/libre/dialect/native/parser.c"
+#line 1857 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: count-one-or-more */
 		}
@@ -1865,11 +1863,11 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: count-zero-or-more */
 			{
-#line 595 "src/libre/parser.act"
+#line 593 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(0, NULL, AST_COUNT_UNBOUNDED, NULL);
 	
-#line 1873 "src/libre/dialect/native/parser.c"
+#line 1871 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: count-zero-or-more */
 		}
@@ -1878,11 +1876,11 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 		{
 			/* BEGINNING OF ACTION: count-one */
 			{
-#line 607 "src/libre/parser.act"
+#line 605 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(1, NULL, 1, NULL);
 	
-#line 1886 "src/libre/dialect/native/parser.c"
+#line 1884 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: count-one */
 		}
@@ -1895,23 +1893,23 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-count */
 		{
-#line 476 "src/libre/parser.act"
+#line 474 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXCOUNT;
 		}
 		goto ZL2;
 	
-#line 1906 "src/libre/dialect/native/parser.c"
+#line 1904 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: err-expected-count */
 		/* BEGINNING OF ACTION: count-one */
 		{
-#line 607 "src/libre/parser.act"
+#line 605 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(1, NULL, 1, NULL);
 	
-#line 1915 "src/libre/dialect/native/parser.c"
+#line 1913 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: count-one */
 	}
@@ -1936,24 +1934,24 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: class-any */
 			{
-#line 574 "src/libre/parser.act"
+#line 572 "src/libre/parser.act"
 
 		/* TODO: or the unicode equivalent */
 		(ZIa) = &class_any;
 	
-#line 1945 "src/libre/dialect/native/parser.c"
+#line 1943 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: class-any */
 			/* BEGINNING OF ACTION: ast-make-named */
 			{
-#line 814 "src/libre/parser.act"
+#line 812 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_named((ZIa));
+		(ZIe) = ast_make_expr_named(act_state->arena, (ZIa));
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1957 "src/libre/dialect/native/parser.c"
+#line 1955 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-make-named */
 		}
@@ -1963,14 +1961,14 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: ast-make-anchor-end */
 			{
-#line 729 "src/libre/parser.act"
+#line 727 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_anchor(AST_ANCHOR_END);
+		(ZIe) = ast_make_expr_anchor(act_state->arena, AST_ANCHOR_END);
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1974 "src/libre/dialect/native/parser.c"
+#line 1972 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-make-anchor-end */
 		}
@@ -1987,14 +1985,14 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 			}
 			/* BEGINNING OF ACTION: ast-make-group */
 			{
-#line 708 "src/libre/parser.act"
+#line 706 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_group((ZIg));
+		(ZIe) = ast_make_expr_group(act_state->arena, (ZIg));
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1998 "src/libre/dialect/native/parser.c"
+#line 1996 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-make-group */
 			switch (CURRENT_TERMINAL) {
@@ -2011,14 +2009,14 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: ast-make-anchor-start */
 			{
-#line 722 "src/libre/parser.act"
+#line 720 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_anchor(AST_ANCHOR_START);
+		(ZIe) = ast_make_expr_anchor(act_state->arena, AST_ANCHOR_START);
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2022 "src/libre/dialect/native/parser.c"
+#line 2020 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF ACTION: ast-make-anchor-start */
 		}
@@ -2051,26 +2049,26 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-atom */
 		{
-#line 483 "src/libre/parser.act"
+#line 481 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXATOM;
 		}
 		goto ZL2;
 	
-#line 2062 "src/libre/dialect/native/parser.c"
+#line 2060 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: err-expected-atom */
 		/* BEGINNING OF ACTION: ast-make-empty */
 		{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_empty();
+		(ZIe) = ast_make_expr_empty(act_state->arena);
 		if ((ZIe) == NULL) {
 			goto ZL2;
 		}
 	
-#line 2074 "src/libre/dialect/native/parser.c"
+#line 2072 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: ast-make-empty */
 	}
@@ -2099,7 +2097,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hnamed(flags flags, lex_state lex_state, act
 		case (TOK_NAMED__CLASS):
 			/* BEGINNING OF EXTRACT: NAMED_CLASS */
 			{
-#line 441 "src/libre/parser.act"
+#line 439 "src/libre/parser.act"
 
 		ZIid = DIALECT_CLASS(lex_state->buf.a);
 		if (ZIid == NULL) {
@@ -2110,7 +2108,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hnamed(flags flags, lex_state lex_state, act
 		ZI145 = lex_state->lx.start;
 		ZI146   = lex_state->lx.end;
 	
-#line 2114 "src/libre/dialect/native/parser.c"
+#line 2112 "src/libre/dialect/native/parser.c"
 			}
 			/* END OF EXTRACT: NAMED_CLASS */
 			break;
@@ -2120,14 +2118,14 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hnamed(flags flags, lex_state lex_state, act
 		ADVANCE_LEXER;
 		/* BEGINNING OF ACTION: ast-make-named */
 		{
-#line 814 "src/libre/parser.act"
+#line 812 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_named((ZIid));
+		(ZInode) = ast_make_expr_named(act_state->arena, (ZIid));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2131 "src/libre/dialect/native/parser.c"
+#line 2129 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: ast-make-named */
 	}
@@ -2150,14 +2148,14 @@ p_expr_C_Calt(flags flags, lex_state lex_state, act_state act_state, err err, t_
 	{
 		/* BEGINNING OF ACTION: ast-make-concat */
 		{
-#line 669 "src/libre/parser.act"
+#line 667 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_concat();
+		(ZInode) = ast_make_expr_concat(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2161 "src/libre/dialect/native/parser.c"
+#line 2159 "src/libre/dialect/native/parser.c"
 		}
 		/* END OF ACTION: ast-make-concat */
 		p_expr_C_Clist_Hof_Hpieces (flags, lex_state, act_state, err, ZInode);
@@ -2176,26 +2174,11 @@ ZL0:;
 
 /* BEGINNING OF TRAILER */
 
-#line 974 "src/libre/parser.act"
-
-
-	static int
-	lgetc(struct LX_STATE *lx)
-	{
-		struct lex_state *lex_state;
-
-		assert(lx != NULL);
-		assert(lx->getc_opaque != NULL);
+#line 959 "src/libre/parser.act"
 
-		lex_state = lx->getc_opaque;
-
-		assert(lex_state->f != NULL);
-
-		return lex_state->f(lex_state->opaque);
-	}
 
 	struct ast *
-	DIALECT_PARSE(re_getchar_fun *f, void *opaque,
+	DIALECT_PARSE(struct re_arena *arena, const char *s, size_t n,
 		const struct fsm_options *opt,
 		enum re_flags flags, int overlap,
 		struct re_err *err)
@@ -2213,14 +2196,19 @@ ZL0:;
 
 		top.flags = flags;
 
-		assert(f != NULL);
-
-		ast = ast_new();
+		assert(arena != NULL);
+		assert(s != NULL);
 
 		if (err == NULL) {
 			err = &dummy;
 		}
 
+		ast = ast_new(arena);
+		if (ast == NULL) {
+			err->e = RE_EERRNO;
+			return NULL;
+		}
+
 		lex_state    = &lex_state_s;
 		lex_state->p = lex_state->a;
 
@@ -2228,11 +2216,9 @@ ZL0:;
 
 		LX_INIT(lx);
 
-		lx->lgetc       = lgetc;
-		lx->getc_opaque = lex_state;
-
-		lex_state->f       = f;
-		lex_state->opaque  = opaque;
+		/* the lexer reads from the buffer directly, by lx->p */
+		lx->p = s;
+		lx->e = s + n;
 
 		lex_state->buf.a   = NULL;
 		lex_state->buf.len = 0;
@@ -2248,6 +2234,7 @@ ZL0:;
 		act_state = &act_state_s;
 
 		act_state->overlap = overlap;
+		act_state->arena   = arena;
 
 		err->e = RE_ESUCCESS;
 
@@ -2257,7 +2244,7 @@ ZL0:;
 		lx->free(lx->buf_opaque);
 
 		if (err->e != RE_ESUCCESS) {
-			/* TODO: free internals allocated during parsing (are there any?) */
+			/* nodes allocated during parsing are freed with the arena */
 			goto error;
 		}
 
@@ -2314,11 +2301,9 @@ ZL0:;
 			break;
 		}
 
-		ast_free(ast);
-
 		return NULL;
 	}
 
-#line 2323 "src/libre/dialect/native/parser.c"
+#line 2308 "src/libre/dialect/native/parser.c"
 
 /* END OF FILE */
@@ -30,17 +30,14 @@ lx_getc(struct lx_pcre_lx *lx)
 	int c;
 
 	assert(lx != NULL);
-	assert(lx->lgetc != NULL);
+	assert(lx->p != NULL);
 
-	if (lx->c != EOF) {
-		c = lx->c, lx->c = EOF;
-	} else {
-		c = lx->lgetc(lx);
-		if (c == EOF) {
+	if (lx->p == lx->e) {
 			return EOF;
-		}
 	}
 
+	c = (unsigned char) *lx->p++;
+
 	lx->end.byte++;
 	lx->end.col++;
 
@@ -60,9 +57,10 @@ static void
 lx_pcre_ungetc(struct lx_pcre_lx *lx, int c)
 {
 	assert(lx != NULL);
-	assert(lx->c == EOF);
+	assert(lx->p != NULL);
+	assert((unsigned char) *(lx->p - 1) == c);
 
-	lx->c = c;
+	lx->p--;
 
 
 	lx->end.byte--;
@@ -173,37 +171,37 @@ z0(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "\\" */
 			switch ((unsigned char) c) {
-			case '\\': state = S2; break;
-			case '\x00': lx->lgetc = NULL; return TOK_UNKNOWN;
-			default: state = S1; break;
+			case 'E': state = S2; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
-
-		case S2: /* e.g. "\\" */
+		case S1: /* start */
 			switch ((unsigned char) c) {
-			case 'E': state = S3; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			case '\\': state = S0; break;
+			case '\x00': lx->p = NULL; return TOK_UNKNOWN;
+			default: state = S3; break;
 			}
 			break;
 
-		case S3: /* e.g. "\\E" */
+		case S2: /* e.g. "\\E" */
 			lx_pcre_ungetc(lx, c); return lx->z = z11, lx->z(lx);
 
+		case S3: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
 		default:
 			; /* unreached */
 		}
 
 		switch (state) {
-		case S3:
+		case S2:
 			break;
 
 		default:
@@ -217,13 +215,13 @@ z0(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_CHAR;
-	case S3: return TOK_EOF;
+	case S0: return TOK_CHAR;
+	case S2: return TOK_EOF;
+	case S3: return TOK_CHAR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -249,13 +247,16 @@ z1(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "," */
+			lx_pcre_ungetc(lx, c); return TOK_SEP;
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
-			case ',': state = S1; break;
+			case ',': state = S0; break;
 			case '0':
 			case '1':
 			case '2':
@@ -267,13 +268,10 @@ z1(struct lx_pcre_lx *lx)
 			case '8':
 			case '9': state = S2; break;
 			case '}': state = S3; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "," */
-			lx_pcre_ungetc(lx, c); return TOK_SEP;
-
 		case S2: /* e.g. "0" */
 			switch ((unsigned char) c) {
 			case '0':
@@ -304,11 +302,11 @@ z1(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_SEP;
+	case S0: return TOK_SEP;
 	case S2: return TOK_COUNT;
 	case S3: return TOK_CLOSECOUNT;
 	default: errno = EINVAL; return TOK_ERROR;
@@ -336,36 +334,36 @@ z2(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "\\" */
 			switch ((unsigned char) c) {
-			case '\\': state = S2; break;
-			default: state = S1; break;
+			case 'E': state = S2; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
-
-		case S2: /* e.g. "\\" */
+		case S1: /* start */
 			switch ((unsigned char) c) {
-			case 'E': state = S3; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			case '\\': state = S0; break;
+			default: state = S3; break;
 			}
 			break;
 
-		case S3: /* e.g. "\\E" */
+		case S2: /* e.g. "\\E" */
 			lx_pcre_ungetc(lx, c); return lx->z = z3, lx->z(lx);
 
+		case S3: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
 		default:
 			; /* unreached */
 		}
 
 		switch (state) {
-		case S3:
+		case S2:
 			break;
 
 		default:
@@ -379,13 +377,13 @@ z2(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_CHAR;
-	case S3: return TOK_EOF;
+	case S0: return TOK_CHAR;
+	case S2: return TOK_EOF;
+	case S3: return TOK_CHAR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -418,36 +416,112 @@ z3(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S28;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "[:bl" */
 			switch ((unsigned char) c) {
-			case '-': state = S2; break;
-			case '[': state = S3; break;
-			case '\\': state = S4; break;
-			case ']': state = S5; break;
-			case '^': state = S6; break;
-			default: state = S1; break;
+			case 'a': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+		case S1: /* e.g. "[:sp" */
+			switch ((unsigned char) c) {
+			case 'a': state = S4; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
-		case S2: /* e.g. "-" */
-			lx_pcre_ungetc(lx, c); return TOK_RANGE;
+		case S2: /* e.g. "[:a" */
+			switch ((unsigned char) c) {
+			case 's': state = S50; break;
+			case 'l': state = S55; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
-		case S3: /* e.g. "[" */
+		case S3: /* e.g. "[:g" */
 			switch ((unsigned char) c) {
-			case ':': state = S24; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			case 'r': state = S70; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S4: /* e.g. "[:spa" */
+			switch ((unsigned char) c) {
+			case 'c': state = S33; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S5: /* e.g. "[:asc" */
+			switch ((unsigned char) c) {
+			case 'i': state = S35; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S6: /* e.g. "[:bla" */
+			switch ((unsigned char) c) {
+			case 'n': state = S36; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S7: /* e.g. "[:aln" */
+			switch ((unsigned char) c) {
+			case 'u': state = S45; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S8: /* e.g. "[:wo" */
+			switch ((unsigned char) c) {
+			case 'r': state = S32; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S9: /* e.g. "\\x" */
+			switch ((unsigned char) c) {
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': state = S25; break;
+			case '{': state = S29; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S4: /* e.g. "\\" */
+		case S10: /* e.g. "]" */
+			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEGROUP;
+
+		case S11: /* e.g. "^" */
+			lx_pcre_ungetc(lx, c); return TOK_INVERT;
+
+		case S12: /* e.g. "\\" */
 			switch ((unsigned char) c) {
+			case 'x': state = S9; break;
 			case '$':
 			case '(':
 			case '*':
@@ -464,15 +538,7 @@ z3(struct lx_pcre_lx *lx)
 			case 'r':
 			case 't':
 			case '{':
-			case '|': state = S8; break;
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S9; break;
+			case '|': state = S13; break;
 			case 'D':
 			case 'H':
 			case 'N':
@@ -483,29 +549,10 @@ z3(struct lx_pcre_lx *lx)
 			case 'h':
 			case 's':
 			case 'v':
-			case 'w': state = S10; break;
-			case 'Q': state = S11; break;
-			case 'c': state = S12; break;
-			case 'o': state = S13; break;
-			case 'x': state = S14; break;
-			default: state = S7; break;
-			}
-			break;
-
-		case S5: /* e.g. "]" */
-			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEGROUP;
-
-		case S6: /* e.g. "^" */
-			lx_pcre_ungetc(lx, c); return TOK_INVERT;
-
-		case S7: /* e.g. "\\b" */
-			lx_pcre_ungetc(lx, c); return TOK_NOESC;
-
-		case S8: /* e.g. "\\a" */
-			lx_pcre_ungetc(lx, c); return TOK_ESC;
-
-		case S9: /* e.g. "\\0" */
-			switch ((unsigned char) c) {
+			case 'w': state = S15; break;
+			case 'Q': state = S16; break;
+			case 'c': state = S20; break;
+			case 'o': state = S22; break;
 			case '0':
 			case '1':
 			case '2':
@@ -513,28 +560,57 @@ z3(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7': state = S23; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
+			case '7': state = S24; break;
+			default: state = S61; break;
 			}
 			break;
 
-		case S10: /* e.g. "\\d" */
+		case S13: /* e.g. "\\a" */
+			lx_pcre_ungetc(lx, c); return TOK_ESC;
+
+		case S14: /* e.g. "-" */
+			lx_pcre_ungetc(lx, c); return TOK_RANGE;
+
+		case S15: /* e.g. "\\d" */
 			lx_pcre_ungetc(lx, c); return TOK_NAMED__CLASS;
 
-		case S11: /* e.g. "\\Q" */
+		case S16: /* e.g. "\\Q" */
 			lx_pcre_ungetc(lx, c); return lx->z = z2, lx->z(lx);
 
-		case S12: /* e.g. "\\c" */
-			state = S22; break;
+		case S17: /* e.g. "[:x" */
+			switch ((unsigned char) c) {
+			case 'd': state = S41; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S18: /* e.g. "\\ca" */
+			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
+
+		case S19: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
+		case S20: /* e.g. "\\c" */
+			state = S18; break;
+
+		case S21: /* e.g. "[" */
+			switch ((unsigned char) c) {
+			case ':': state = S40; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			}
+			break;
 
-		case S13: /* e.g. "\\o" */
+		case S22: /* e.g. "\\o" */
 			switch ((unsigned char) c) {
-			case '{': state = S19; break;
+			case '{': state = S27; break;
 			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S14: /* e.g. "\\x" */
+		case S23: /* e.g. "\\000" */
+			lx_pcre_ungetc(lx, c); return TOK_OCT;
+
+		case S24: /* e.g. "\\0" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -543,27 +619,12 @@ z3(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S15; break;
-			case '{': state = S16; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
+			case '7': state = S51; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S15: /* e.g. "\\xa" */
+		case S25: /* e.g. "\\xa" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -586,12 +647,15 @@ z3(struct lx_pcre_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S18; break;
+			case 'f': state = S26; break;
 			default:  lx_pcre_ungetc(lx, c); return TOK_HEX;
 			}
 			break;
 
-		case S16: /* e.g. "\\x{" */
+		case S26: /* e.g. "\\xaa" */
+			lx_pcre_ungetc(lx, c); return TOK_HEX;
+
+		case S27: /* e.g. "\\o{" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -600,26 +664,23 @@ z3(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S17; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '7': state = S30; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S28: /* start */
+			switch ((unsigned char) c) {
+			case ']': state = S10; break;
+			case '^': state = S11; break;
+			case '\\': state = S12; break;
+			case '-': state = S14; break;
+			case '[': state = S21; break;
+			default: state = S19; break;
 			}
 			break;
 
-		case S17: /* e.g. "\\x{a" */
+		case S29: /* e.g. "\\x{" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -642,31 +703,14 @@ z3(struct lx_pcre_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': break;
-			case '}': state = S18; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S18: /* e.g. "\\xaa" */
-			lx_pcre_ungetc(lx, c); return TOK_HEX;
-
-		case S19: /* e.g. "\\o{" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'f': state = S38; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S20: /* e.g. "\\o{0" */
+		case S30: /* e.g. "\\o{0" */
 			switch ((unsigned char) c) {
+			case '}': state = S23; break;
 			case '0':
 			case '1':
 			case '2':
@@ -675,415 +719,369 @@ z3(struct lx_pcre_lx *lx)
 			case '5':
 			case '6':
 			case '7': break;
-			case '}': state = S21; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S21: /* e.g. "\\000" */
-			lx_pcre_ungetc(lx, c); return TOK_OCT;
-
-		case S22: /* e.g. "\\ca" */
-			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
-
-		case S23: /* e.g. "\\00" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S21; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S24: /* e.g. "[:" */
+		case S31: /* e.g. "[:alph" */
 			switch ((unsigned char) c) {
-			case 'a': state = S25; break;
-			case 'b': state = S26; break;
-			case 'c': state = S27; break;
-			case 'd': state = S28; break;
-			case 'g': state = S29; break;
-			case 'l': state = S30; break;
-			case 'p': state = S31; break;
-			case 's': state = S32; break;
-			case 'u': state = S33; break;
-			case 'w': state = S34; break;
-			case 'x': state = S35; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S25: /* e.g. "[:a" */
+		case S32: /* e.g. "[:wor" */
 			switch ((unsigned char) c) {
-			case 'l': state = S63; break;
-			case 's': state = S64; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'd': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S26: /* e.g. "[:b" */
+		case S33: /* e.g. "[:spac" */
 			switch ((unsigned char) c) {
-			case 'l': state = S60; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S27: /* e.g. "[:c" */
+		case S34: /* e.g. "[:grap" */
 			switch ((unsigned char) c) {
-			case 'n': state = S57; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S28: /* e.g. "[:d" */
+		case S35: /* e.g. "[:asci" */
 			switch ((unsigned char) c) {
-			case 'i': state = S55; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S29: /* e.g. "[:g" */
+		case S36: /* e.g. "[:blan" */
 			switch ((unsigned char) c) {
-			case 'r': state = S52; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'k': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S30: /* e.g. "[:l" */
+		case S37: /* e.g. "[:cntr" */
 			switch ((unsigned char) c) {
-			case 'o': state = S51; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'l': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S31: /* e.g. "[:p" */
+		case S38: /* e.g. "\\x{a" */
 			switch ((unsigned char) c) {
-			case 'r': state = S46; break;
-			case 'u': state = S47; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '}': state = S26; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S32: /* e.g. "[:s" */
+		case S39: /* e.g. "[:digi" */
 			switch ((unsigned char) c) {
-			case 'p': state = S43; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S33: /* e.g. "[:u" */
+		case S40: /* e.g. "[:" */
 			switch ((unsigned char) c) {
-			case 'p': state = S40; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S2; break;
+			case 'g': state = S3; break;
+			case 'x': state = S17; break;
+			case 'd': state = S41; break;
+			case 'c': state = S43; break;
+			case 'l': state = S44; break;
+			case 'w': state = S59; break;
+			case 'p': state = S66; break;
+			case 'b': state = S67; break;
+			case 's': state = S68; break;
+			case 'u': state = S69; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S34: /* e.g. "[:w" */
+		case S41: /* e.g. "[:d" */
 			switch ((unsigned char) c) {
-			case 'o': state = S36; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S48; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S35: /* e.g. "[:x" */
+		case S42: /* e.g. "[:lowe" */
 			switch ((unsigned char) c) {
-			case 'd': state = S28; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S36: /* e.g. "[:wo" */
+		case S43: /* e.g. "[:c" */
 			switch ((unsigned char) c) {
-			case 'r': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S57; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S37: /* e.g. "[:wor" */
+		case S44: /* e.g. "[:l" */
 			switch ((unsigned char) c) {
-			case 'd': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S53; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S38: /* e.g. "[:word" */
+		case S45: /* e.g. "[:alnu" */
 			switch ((unsigned char) c) {
-			case ':': state = S39; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'm': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S39: /* e.g. "[:word:" */
+		case S46: /* e.g. "[:word:" */
 			switch ((unsigned char) c) {
-			case ']': state = S10; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ']': state = S15; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S40: /* e.g. "[:up" */
+		case S47: /* e.g. "[:word" */
 			switch ((unsigned char) c) {
-			case 'p': state = S41; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ':': state = S46; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S41: /* e.g. "[:low" */
+		case S48: /* e.g. "[:di" */
 			switch ((unsigned char) c) {
-			case 'e': state = S42; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'g': state = S64; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S42: /* e.g. "[:lowe" */
+		case S49: /* e.g. "[:pr" */
 			switch ((unsigned char) c) {
-			case 'r': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S63; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S43: /* e.g. "[:sp" */
+		case S50: /* e.g. "[:as" */
 			switch ((unsigned char) c) {
-			case 'a': state = S44; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S5; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S44: /* e.g. "[:spa" */
+		case S51: /* e.g. "\\00" */
 			switch ((unsigned char) c) {
-			case 'c': state = S45; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': state = S23; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S45: /* e.g. "[:spac" */
+		case S52: /* e.g. "[:up" */
 			switch ((unsigned char) c) {
-			case 'e': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S56; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S46: /* e.g. "[:pr" */
+		case S53: /* e.g. "[:lo" */
 			switch ((unsigned char) c) {
-			case 'i': state = S50; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'w': state = S56; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S47: /* e.g. "[:pu" */
+		case S54: /* e.g. "[:pu" */
 			switch ((unsigned char) c) {
-			case 'n': state = S48; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S65; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S48: /* e.g. "[:pun" */
+		case S55: /* e.g. "[:al" */
 			switch ((unsigned char) c) {
-			case 'c': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S7; break;
+			case 'p': state = S58; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S49: /* e.g. "[:prin" */
+		case S56: /* e.g. "[:low" */
 			switch ((unsigned char) c) {
-			case 't': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S42; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S50: /* e.g. "[:pri" */
+		case S57: /* e.g. "[:cn" */
 			switch ((unsigned char) c) {
-			case 'n': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S62; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S51: /* e.g. "[:lo" */
+		case S58: /* e.g. "[:alp" */
 			switch ((unsigned char) c) {
-			case 'w': state = S41; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S31; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S52: /* e.g. "[:gr" */
+		case S59: /* e.g. "[:w" */
 			switch ((unsigned char) c) {
-			case 'a': state = S53; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S8; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S53: /* e.g. "[:gra" */
+		case S60: /* e.g. "[:gra" */
 			switch ((unsigned char) c) {
-			case 'p': state = S54; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S34; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S54: /* e.g. "[:grap" */
-			switch ((unsigned char) c) {
-			case 'h': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		case S61: /* e.g. "\\b" */
+			lx_pcre_ungetc(lx, c); return TOK_NOESC;
 
-		case S55: /* e.g. "[:di" */
+		case S62: /* e.g. "[:cnt" */
 			switch ((unsigned char) c) {
-			case 'g': state = S56; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S37; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S56: /* e.g. "[:dig" */
+		case S63: /* e.g. "[:pri" */
 			switch ((unsigned char) c) {
-			case 'i': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S57: /* e.g. "[:cn" */
+		case S64: /* e.g. "[:dig" */
 			switch ((unsigned char) c) {
-			case 't': state = S58; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S58: /* e.g. "[:cnt" */
+		case S65: /* e.g. "[:pun" */
 			switch ((unsigned char) c) {
-			case 'r': state = S59; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S59: /* e.g. "[:cntr" */
+		case S66: /* e.g. "[:p" */
 			switch ((unsigned char) c) {
-			case 'l': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S49; break;
+			case 'u': state = S54; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S60: /* e.g. "[:bl" */
+		case S67: /* e.g. "[:b" */
 			switch ((unsigned char) c) {
-			case 'a': state = S61; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'l': state = S0; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S61: /* e.g. "[:bla" */
+		case S68: /* e.g. "[:s" */
 			switch ((unsigned char) c) {
-			case 'n': state = S62; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S1; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S62: /* e.g. "[:blan" */
+		case S69: /* e.g. "[:u" */
 			switch ((unsigned char) c) {
-			case 'k': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S52; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S63: /* e.g. "[:al" */
+		case S70: /* e.g. "[:gr" */
 			switch ((unsigned char) c) {
-			case 'n': state = S67; break;
-			case 'p': state = S68; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S60; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S64: /* e.g. "[:as" */
-			switch ((unsigned char) c) {
-			case 'c': state = S65; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		default:
+			; /* unreached */
+		}
 
-		case S65: /* e.g. "[:asc" */
-			switch ((unsigned char) c) {
-			case 'i': state = S66; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
+		switch (state) {
+		case S16:
 			break;
 
-		case S66: /* e.g. "[:asci" */
-			switch ((unsigned char) c) {
-			case 'i': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S67: /* e.g. "[:aln" */
-			switch ((unsigned char) c) {
-			case 'u': state = S70; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S68: /* e.g. "[:alp" */
-			switch ((unsigned char) c) {
-			case 'h': state = S69; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S69: /* e.g. "[:alph" */
-			switch ((unsigned char) c) {
-			case 'a': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S70: /* e.g. "[:alnu" */
-			switch ((unsigned char) c) {
-			case 'm': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		default:
-			; /* unreached */
-		}
-
-		switch (state) {
-		case S11:
-			break;
-
-		default:
-			if (lx->push != NULL) {
-				if (-1 == lx->push(lx->buf_opaque, c)) {
-					return TOK_ERROR;
-				}
+		default:
+			if (lx->push != NULL) {
+				if (-1 == lx->push(lx->buf_opaque, c)) {
+					return TOK_ERROR;
+				}
 			}
 			break;
 
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_RANGE;
-	case S3: return TOK_CHAR;
-	case S4: return TOK_INVALID;
-	case S5: return TOK_CLOSEGROUP;
-	case S6: return TOK_INVERT;
-	case S7: return TOK_NOESC;
-	case S8: return TOK_ESC;
-	case S9: return TOK_OCT;
-	case S10: return TOK_NAMED__CLASS;
-	case S11: return TOK_EOF;
-	case S12: return TOK_NOESC;
-	case S13: return TOK_NOESC;
-	case S14: return TOK_NOESC;
-	case S15: return TOK_HEX;
-	case S18: return TOK_HEX;
-	case S21: return TOK_OCT;
-	case S22: return TOK_CONTROL;
+	case S9: return TOK_NOESC;
+	case S10: return TOK_CLOSEGROUP;
+	case S11: return TOK_INVERT;
+	case S12: return TOK_INVALID;
+	case S13: return TOK_ESC;
+	case S14: return TOK_RANGE;
+	case S15: return TOK_NAMED__CLASS;
+	case S16: return TOK_EOF;
+	case S18: return TOK_CONTROL;
+	case S19: return TOK_CHAR;
+	case S20: return TOK_NOESC;
+	case S21: return TOK_CHAR;
+	case S22: return TOK_NOESC;
 	case S23: return TOK_OCT;
+	case S24: return TOK_OCT;
+	case S25: return TOK_HEX;
+	case S26: return TOK_HEX;
+	case S51: return TOK_OCT;
+	case S61: return TOK_NOESC;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -1109,36 +1107,36 @@ z4(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "\\" */
 			switch ((unsigned char) c) {
-			case '\\': state = S2; break;
-			default: state = S1; break;
+			case 'E': state = S2; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
-
-		case S2: /* e.g. "\\" */
+		case S1: /* start */
 			switch ((unsigned char) c) {
-			case 'E': state = S3; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			case '\\': state = S0; break;
+			default: state = S3; break;
 			}
 			break;
 
-		case S3: /* e.g. "\\E" */
+		case S2: /* e.g. "\\E" */
 			lx_pcre_ungetc(lx, c); return lx->z = z5, lx->z(lx);
 
+		case S3: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
 		default:
 			; /* unreached */
 		}
 
 		switch (state) {
-		case S3:
+		case S2:
 			break;
 
 		default:
@@ -1152,13 +1150,13 @@ z4(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_CHAR;
-	case S3: return TOK_EOF;
+	case S0: return TOK_CHAR;
+	case S2: return TOK_EOF;
+	case S3: return TOK_CHAR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -1191,36 +1189,112 @@ z5(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S28;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "[:bl" */
 			switch ((unsigned char) c) {
-			case '-': state = S2; break;
-			case '[': state = S3; break;
-			case '\\': state = S4; break;
-			case ']': state = S5; break;
-			case '^': state = S6; break;
-			default: state = S1; break;
+			case 'a': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+		case S1: /* e.g. "[:sp" */
+			switch ((unsigned char) c) {
+			case 'a': state = S4; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
-		case S2: /* e.g. "-" */
-			lx_pcre_ungetc(lx, c); return TOK_RANGE;
+		case S2: /* e.g. "[:a" */
+			switch ((unsigned char) c) {
+			case 's': state = S50; break;
+			case 'l': state = S55; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
-		case S3: /* e.g. "[" */
+		case S3: /* e.g. "[:g" */
 			switch ((unsigned char) c) {
-			case ':': state = S24; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			case 'r': state = S70; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S4: /* e.g. "[:spa" */
+			switch ((unsigned char) c) {
+			case 'c': state = S33; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S5: /* e.g. "[:asc" */
+			switch ((unsigned char) c) {
+			case 'i': state = S35; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S6: /* e.g. "[:bla" */
+			switch ((unsigned char) c) {
+			case 'n': state = S36; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S7: /* e.g. "[:aln" */
+			switch ((unsigned char) c) {
+			case 'u': state = S45; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S8: /* e.g. "[:wo" */
+			switch ((unsigned char) c) {
+			case 'r': state = S32; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S9: /* e.g. "\\x" */
+			switch ((unsigned char) c) {
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': state = S25; break;
+			case '{': state = S29; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S4: /* e.g. "\\" */
+		case S10: /* e.g. "]" */
+			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEGROUP;
+
+		case S11: /* e.g. "^" */
+			lx_pcre_ungetc(lx, c); return TOK_INVERT;
+
+		case S12: /* e.g. "\\" */
 			switch ((unsigned char) c) {
+			case 'x': state = S9; break;
 			case '$':
 			case '(':
 			case '*':
@@ -1237,15 +1311,7 @@ z5(struct lx_pcre_lx *lx)
 			case 'r':
 			case 't':
 			case '{':
-			case '|': state = S8; break;
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S9; break;
+			case '|': state = S13; break;
 			case 'D':
 			case 'H':
 			case 'N':
@@ -1256,29 +1322,10 @@ z5(struct lx_pcre_lx *lx)
 			case 'h':
 			case 's':
 			case 'v':
-			case 'w': state = S10; break;
-			case 'Q': state = S11; break;
-			case 'c': state = S12; break;
-			case 'o': state = S13; break;
-			case 'x': state = S14; break;
-			default: state = S7; break;
-			}
-			break;
-
-		case S5: /* e.g. "]" */
-			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEGROUP;
-
-		case S6: /* e.g. "^" */
-			lx_pcre_ungetc(lx, c); return TOK_INVERT;
-
-		case S7: /* e.g. "\\b" */
-			lx_pcre_ungetc(lx, c); return TOK_NOESC;
-
-		case S8: /* e.g. "\\a" */
-			lx_pcre_ungetc(lx, c); return TOK_ESC;
-
-		case S9: /* e.g. "\\0" */
-			switch ((unsigned char) c) {
+			case 'w': state = S15; break;
+			case 'Q': state = S16; break;
+			case 'c': state = S20; break;
+			case 'o': state = S22; break;
 			case '0':
 			case '1':
 			case '2':
@@ -1286,28 +1333,57 @@ z5(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7': state = S23; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
+			case '7': state = S24; break;
+			default: state = S61; break;
 			}
 			break;
 
-		case S10: /* e.g. "\\d" */
+		case S13: /* e.g. "\\a" */
+			lx_pcre_ungetc(lx, c); return TOK_ESC;
+
+		case S14: /* e.g. "-" */
+			lx_pcre_ungetc(lx, c); return TOK_RANGE;
+
+		case S15: /* e.g. "\\d" */
 			lx_pcre_ungetc(lx, c); return TOK_NAMED__CLASS;
 
-		case S11: /* e.g. "\\Q" */
+		case S16: /* e.g. "\\Q" */
 			lx_pcre_ungetc(lx, c); return lx->z = z4, lx->z(lx);
 
-		case S12: /* e.g. "\\c" */
-			state = S22; break;
+		case S17: /* e.g. "[:x" */
+			switch ((unsigned char) c) {
+			case 'd': state = S41; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S18: /* e.g. "\\ca" */
+			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
+
+		case S19: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
+		case S20: /* e.g. "\\c" */
+			state = S18; break;
+
+		case S21: /* e.g. "[" */
+			switch ((unsigned char) c) {
+			case ':': state = S40; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			}
+			break;
 
-		case S13: /* e.g. "\\o" */
+		case S22: /* e.g. "\\o" */
 			switch ((unsigned char) c) {
-			case '{': state = S19; break;
+			case '{': state = S27; break;
 			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S14: /* e.g. "\\x" */
+		case S23: /* e.g. "\\000" */
+			lx_pcre_ungetc(lx, c); return TOK_OCT;
+
+		case S24: /* e.g. "\\0" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -1316,27 +1392,12 @@ z5(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S15; break;
-			case '{': state = S16; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
+			case '7': state = S51; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S15: /* e.g. "\\xa" */
+		case S25: /* e.g. "\\xa" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -1359,12 +1420,15 @@ z5(struct lx_pcre_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S18; break;
+			case 'f': state = S26; break;
 			default:  lx_pcre_ungetc(lx, c); return TOK_HEX;
 			}
 			break;
 
-		case S16: /* e.g. "\\x{" */
+		case S26: /* e.g. "\\xaa" */
+			lx_pcre_ungetc(lx, c); return TOK_HEX;
+
+		case S27: /* e.g. "\\o{" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -1373,26 +1437,23 @@ z5(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S17; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '7': state = S30; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S28: /* start */
+			switch ((unsigned char) c) {
+			case ']': state = S10; break;
+			case '^': state = S11; break;
+			case '\\': state = S12; break;
+			case '-': state = S14; break;
+			case '[': state = S21; break;
+			default: state = S19; break;
 			}
 			break;
 
-		case S17: /* e.g. "\\x{a" */
+		case S29: /* e.g. "\\x{" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -1415,31 +1476,14 @@ z5(struct lx_pcre_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': break;
-			case '}': state = S18; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S18: /* e.g. "\\xaa" */
-			lx_pcre_ungetc(lx, c); return TOK_HEX;
-
-		case S19: /* e.g. "\\o{" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'f': state = S38; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S20: /* e.g. "\\o{0" */
+		case S30: /* e.g. "\\o{0" */
 			switch ((unsigned char) c) {
+			case '}': state = S23; break;
 			case '0':
 			case '1':
 			case '2':
@@ -1448,370 +1492,324 @@ z5(struct lx_pcre_lx *lx)
 			case '5':
 			case '6':
 			case '7': break;
-			case '}': state = S21; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S21: /* e.g. "\\000" */
-			lx_pcre_ungetc(lx, c); return TOK_OCT;
-
-		case S22: /* e.g. "\\ca" */
-			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
-
-		case S23: /* e.g. "\\00" */
+		case S31: /* e.g. "[:alph" */
 			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S21; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
+			case 'a': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S24: /* e.g. "[:" */
+		case S32: /* e.g. "[:wor" */
 			switch ((unsigned char) c) {
-			case 'a': state = S25; break;
-			case 'b': state = S26; break;
-			case 'c': state = S27; break;
-			case 'd': state = S28; break;
-			case 'g': state = S29; break;
-			case 'l': state = S30; break;
-			case 'p': state = S31; break;
-			case 's': state = S32; break;
-			case 'u': state = S33; break;
-			case 'w': state = S34; break;
-			case 'x': state = S35; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'd': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S25: /* e.g. "[:a" */
+		case S33: /* e.g. "[:spac" */
 			switch ((unsigned char) c) {
-			case 'l': state = S63; break;
-			case 's': state = S64; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S26: /* e.g. "[:b" */
+		case S34: /* e.g. "[:grap" */
 			switch ((unsigned char) c) {
-			case 'l': state = S60; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S27: /* e.g. "[:c" */
+		case S35: /* e.g. "[:asci" */
 			switch ((unsigned char) c) {
-			case 'n': state = S57; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S28: /* e.g. "[:d" */
+		case S36: /* e.g. "[:blan" */
 			switch ((unsigned char) c) {
-			case 'i': state = S55; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'k': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S29: /* e.g. "[:g" */
+		case S37: /* e.g. "[:cntr" */
 			switch ((unsigned char) c) {
-			case 'r': state = S52; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'l': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S30: /* e.g. "[:l" */
+		case S38: /* e.g. "\\x{a" */
 			switch ((unsigned char) c) {
-			case 'o': state = S51; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '}': state = S26; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S31: /* e.g. "[:p" */
+		case S39: /* e.g. "[:digi" */
 			switch ((unsigned char) c) {
-			case 'r': state = S46; break;
-			case 'u': state = S47; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S32: /* e.g. "[:s" */
+		case S40: /* e.g. "[:" */
 			switch ((unsigned char) c) {
-			case 'p': state = S43; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S2; break;
+			case 'g': state = S3; break;
+			case 'x': state = S17; break;
+			case 'd': state = S41; break;
+			case 'c': state = S43; break;
+			case 'l': state = S44; break;
+			case 'w': state = S59; break;
+			case 'p': state = S66; break;
+			case 'b': state = S67; break;
+			case 's': state = S68; break;
+			case 'u': state = S69; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S33: /* e.g. "[:u" */
+		case S41: /* e.g. "[:d" */
 			switch ((unsigned char) c) {
-			case 'p': state = S40; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S48; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S34: /* e.g. "[:w" */
+		case S42: /* e.g. "[:lowe" */
 			switch ((unsigned char) c) {
-			case 'o': state = S36; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S35: /* e.g. "[:x" */
+		case S43: /* e.g. "[:c" */
 			switch ((unsigned char) c) {
-			case 'd': state = S28; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S57; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S36: /* e.g. "[:wo" */
+		case S44: /* e.g. "[:l" */
 			switch ((unsigned char) c) {
-			case 'r': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S53; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S37: /* e.g. "[:wor" */
+		case S45: /* e.g. "[:alnu" */
 			switch ((unsigned char) c) {
-			case 'd': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'm': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S38: /* e.g. "[:word" */
+		case S46: /* e.g. "[:word:" */
 			switch ((unsigned char) c) {
-			case ':': state = S39; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ']': state = S15; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S39: /* e.g. "[:word:" */
+		case S47: /* e.g. "[:word" */
 			switch ((unsigned char) c) {
-			case ']': state = S10; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ':': state = S46; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S40: /* e.g. "[:up" */
+		case S48: /* e.g. "[:di" */
 			switch ((unsigned char) c) {
-			case 'p': state = S41; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'g': state = S64; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S41: /* e.g. "[:low" */
+		case S49: /* e.g. "[:pr" */
 			switch ((unsigned char) c) {
-			case 'e': state = S42; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S63; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S42: /* e.g. "[:lowe" */
+		case S50: /* e.g. "[:as" */
 			switch ((unsigned char) c) {
-			case 'r': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S5; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S43: /* e.g. "[:sp" */
+		case S51: /* e.g. "\\00" */
 			switch ((unsigned char) c) {
-			case 'a': state = S44; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': state = S23; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S44: /* e.g. "[:spa" */
+		case S52: /* e.g. "[:up" */
 			switch ((unsigned char) c) {
-			case 'c': state = S45; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S56; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S45: /* e.g. "[:spac" */
+		case S53: /* e.g. "[:lo" */
 			switch ((unsigned char) c) {
-			case 'e': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'w': state = S56; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S46: /* e.g. "[:pr" */
+		case S54: /* e.g. "[:pu" */
 			switch ((unsigned char) c) {
-			case 'i': state = S50; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S65; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S47: /* e.g. "[:pu" */
+		case S55: /* e.g. "[:al" */
 			switch ((unsigned char) c) {
-			case 'n': state = S48; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S7; break;
+			case 'p': state = S58; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S48: /* e.g. "[:pun" */
+		case S56: /* e.g. "[:low" */
 			switch ((unsigned char) c) {
-			case 'c': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S42; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S49: /* e.g. "[:prin" */
+		case S57: /* e.g. "[:cn" */
 			switch ((unsigned char) c) {
-			case 't': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S62; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S50: /* e.g. "[:pri" */
+		case S58: /* e.g. "[:alp" */
 			switch ((unsigned char) c) {
-			case 'n': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S31; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S51: /* e.g. "[:lo" */
+		case S59: /* e.g. "[:w" */
 			switch ((unsigned char) c) {
-			case 'w': state = S41; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S8; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S52: /* e.g. "[:gr" */
+		case S60: /* e.g. "[:gra" */
 			switch ((unsigned char) c) {
-			case 'a': state = S53; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S34; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S53: /* e.g. "[:gra" */
+		case S61: /* e.g. "\\b" */
+			lx_pcre_ungetc(lx, c); return TOK_NOESC;
+
+		case S62: /* e.g. "[:cnt" */
 			switch ((unsigned char) c) {
-			case 'p': state = S54; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S37; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S54: /* e.g. "[:grap" */
+		case S63: /* e.g. "[:pri" */
 			switch ((unsigned char) c) {
-			case 'h': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S55: /* e.g. "[:di" */
+		case S64: /* e.g. "[:dig" */
 			switch ((unsigned char) c) {
-			case 'g': state = S56; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S56: /* e.g. "[:dig" */
+		case S65: /* e.g. "[:pun" */
 			switch ((unsigned char) c) {
-			case 'i': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S57: /* e.g. "[:cn" */
+		case S66: /* e.g. "[:p" */
 			switch ((unsigned char) c) {
-			case 't': state = S58; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S49; break;
+			case 'u': state = S54; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S58: /* e.g. "[:cnt" */
+		case S67: /* e.g. "[:b" */
 			switch ((unsigned char) c) {
-			case 'r': state = S59; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'l': state = S0; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S59: /* e.g. "[:cntr" */
+		case S68: /* e.g. "[:s" */
 			switch ((unsigned char) c) {
-			case 'l': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S1; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S60: /* e.g. "[:bl" */
+		case S69: /* e.g. "[:u" */
 			switch ((unsigned char) c) {
-			case 'a': state = S61; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S52; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S61: /* e.g. "[:bla" */
+		case S70: /* e.g. "[:gr" */
 			switch ((unsigned char) c) {
-			case 'n': state = S62; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S62: /* e.g. "[:blan" */
-			switch ((unsigned char) c) {
-			case 'k': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S63: /* e.g. "[:al" */
-			switch ((unsigned char) c) {
-			case 'n': state = S67; break;
-			case 'p': state = S68; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S64: /* e.g. "[:as" */
-			switch ((unsigned char) c) {
-			case 'c': state = S65; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S65: /* e.g. "[:asc" */
-			switch ((unsigned char) c) {
-			case 'i': state = S66; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S66: /* e.g. "[:asci" */
-			switch ((unsigned char) c) {
-			case 'i': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S67: /* e.g. "[:aln" */
-			switch ((unsigned char) c) {
-			case 'u': state = S70; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S68: /* e.g. "[:alp" */
-			switch ((unsigned char) c) {
-			case 'h': state = S69; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S69: /* e.g. "[:alph" */
-			switch ((unsigned char) c) {
-			case 'a': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S70: /* e.g. "[:alnu" */
-			switch ((unsigned char) c) {
-			case 'm': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S60; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
@@ -1820,7 +1818,7 @@ z5(struct lx_pcre_lx *lx)
 		}
 
 		switch (state) {
-		case S11:
+		case S16:
 			break;
 
 		default:
@@ -1834,29 +1832,29 @@ z5(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_RANGE;
-	case S3: return TOK_CHAR;
-	case S4: return TOK_INVALID;
-	case S5: return TOK_CLOSEGROUP;
-	case S6: return TOK_INVERT;
-	case S7: return TOK_NOESC;
-	case S8: return TOK_ESC;
-	case S9: return TOK_OCT;
-	case S10: return TOK_NAMED__CLASS;
-	case S11: return TOK_EOF;
-	case S12: return TOK_NOESC;
-	case S13: return TOK_NOESC;
-	case S14: return TOK_NOESC;
-	case S15: return TOK_HEX;
-	case S18: return TOK_HEX;
-	case S21: return TOK_OCT;
-	case S22: return TOK_CONTROL;
+	case S9: return TOK_NOESC;
+	case S10: return TOK_CLOSEGROUP;
+	case S11: return TOK_INVERT;
+	case S12: return TOK_INVALID;
+	case S13: return TOK_ESC;
+	case S14: return TOK_RANGE;
+	case S15: return TOK_NAMED__CLASS;
+	case S16: return TOK_EOF;
+	case S18: return TOK_CONTROL;
+	case S19: return TOK_CHAR;
+	case S20: return TOK_NOESC;
+	case S21: return TOK_CHAR;
+	case S22: return TOK_NOESC;
 	case S23: return TOK_OCT;
+	case S24: return TOK_OCT;
+	case S25: return TOK_HEX;
+	case S26: return TOK_HEX;
+	case S51: return TOK_OCT;
+	case S61: return TOK_NOESC;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -1882,36 +1880,36 @@ z6(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "\\" */
 			switch ((unsigned char) c) {
-			case '\\': state = S2; break;
-			default: state = S1; break;
+			case 'E': state = S2; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
-
-		case S2: /* e.g. "\\" */
+		case S1: /* start */
 			switch ((unsigned char) c) {
-			case 'E': state = S3; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			case '\\': state = S0; break;
+			default: state = S3; break;
 			}
 			break;
 
-		case S3: /* e.g. "\\E" */
+		case S2: /* e.g. "\\E" */
 			lx_pcre_ungetc(lx, c); return lx->z = z7, lx->z(lx);
 
+		case S3: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
 		default:
 			; /* unreached */
 		}
 
 		switch (state) {
-		case S3:
+		case S2:
 			break;
 
 		default:
@@ -1925,13 +1923,13 @@ z6(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_CHAR;
-	case S3: return TOK_EOF;
+	case S0: return TOK_CHAR;
+	case S2: return TOK_EOF;
+	case S3: return TOK_CHAR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -1964,36 +1962,112 @@ z7(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S28;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "[:bl" */
 			switch ((unsigned char) c) {
-			case '-': state = S2; break;
-			case '[': state = S3; break;
-			case '\\': state = S4; break;
-			case ']': state = S5; break;
-			case '^': state = S6; break;
-			default: state = S1; break;
+			case 'a': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+		case S1: /* e.g. "[:sp" */
+			switch ((unsigned char) c) {
+			case 'a': state = S4; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
-		case S2: /* e.g. "-" */
-			lx_pcre_ungetc(lx, c); return TOK_RANGE;
+		case S2: /* e.g. "[:a" */
+			switch ((unsigned char) c) {
+			case 's': state = S50; break;
+			case 'l': state = S55; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
-		case S3: /* e.g. "[" */
+		case S3: /* e.g. "[:g" */
 			switch ((unsigned char) c) {
-			case ':': state = S24; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			case 'r': state = S70; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S4: /* e.g. "[:spa" */
+			switch ((unsigned char) c) {
+			case 'c': state = S33; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S5: /* e.g. "[:asc" */
+			switch ((unsigned char) c) {
+			case 'i': state = S35; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S6: /* e.g. "[:bla" */
+			switch ((unsigned char) c) {
+			case 'n': state = S36; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S7: /* e.g. "[:aln" */
+			switch ((unsigned char) c) {
+			case 'u': state = S45; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S8: /* e.g. "[:wo" */
+			switch ((unsigned char) c) {
+			case 'r': state = S32; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S9: /* e.g. "\\x" */
+			switch ((unsigned char) c) {
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': state = S25; break;
+			case '{': state = S29; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S4: /* e.g. "\\" */
+		case S10: /* e.g. "]" */
+			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEGROUP;
+
+		case S11: /* e.g. "^" */
+			lx_pcre_ungetc(lx, c); return TOK_INVERT;
+
+		case S12: /* e.g. "\\" */
 			switch ((unsigned char) c) {
+			case 'x': state = S9; break;
 			case '$':
 			case '(':
 			case '*':
@@ -2010,15 +2084,7 @@ z7(struct lx_pcre_lx *lx)
 			case 'r':
 			case 't':
 			case '{':
-			case '|': state = S8; break;
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S9; break;
+			case '|': state = S13; break;
 			case 'D':
 			case 'H':
 			case 'N':
@@ -2029,29 +2095,10 @@ z7(struct lx_pcre_lx *lx)
 			case 'h':
 			case 's':
 			case 'v':
-			case 'w': state = S10; break;
-			case 'Q': state = S11; break;
-			case 'c': state = S12; break;
-			case 'o': state = S13; break;
-			case 'x': state = S14; break;
-			default: state = S7; break;
-			}
-			break;
-
-		case S5: /* e.g. "]" */
-			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEGROUP;
-
-		case S6: /* e.g. "^" */
-			lx_pcre_ungetc(lx, c); return TOK_INVERT;
-
-		case S7: /* e.g. "\\b" */
-			lx_pcre_ungetc(lx, c); return TOK_NOESC;
-
-		case S8: /* e.g. "\\a" */
-			lx_pcre_ungetc(lx, c); return TOK_ESC;
-
-		case S9: /* e.g. "\\0" */
-			switch ((unsigned char) c) {
+			case 'w': state = S15; break;
+			case 'Q': state = S16; break;
+			case 'c': state = S20; break;
+			case 'o': state = S22; break;
 			case '0':
 			case '1':
 			case '2':
@@ -2059,28 +2106,57 @@ z7(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7': state = S23; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
+			case '7': state = S24; break;
+			default: state = S61; break;
 			}
 			break;
 
-		case S10: /* e.g. "\\d" */
+		case S13: /* e.g. "\\a" */
+			lx_pcre_ungetc(lx, c); return TOK_ESC;
+
+		case S14: /* e.g. "-" */
+			lx_pcre_ungetc(lx, c); return TOK_RANGE;
+
+		case S15: /* e.g. "\\d" */
 			lx_pcre_ungetc(lx, c); return TOK_NAMED__CLASS;
 
-		case S11: /* e.g. "\\Q" */
+		case S16: /* e.g. "\\Q" */
 			lx_pcre_ungetc(lx, c); return lx->z = z6, lx->z(lx);
 
-		case S12: /* e.g. "\\c" */
-			state = S22; break;
+		case S17: /* e.g. "[:x" */
+			switch ((unsigned char) c) {
+			case 'd': state = S41; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S18: /* e.g. "\\ca" */
+			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
+
+		case S19: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
+		case S20: /* e.g. "\\c" */
+			state = S18; break;
+
+		case S21: /* e.g. "[" */
+			switch ((unsigned char) c) {
+			case ':': state = S40; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			}
+			break;
 
-		case S13: /* e.g. "\\o" */
+		case S22: /* e.g. "\\o" */
 			switch ((unsigned char) c) {
-			case '{': state = S19; break;
+			case '{': state = S27; break;
 			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S14: /* e.g. "\\x" */
+		case S23: /* e.g. "\\000" */
+			lx_pcre_ungetc(lx, c); return TOK_OCT;
+
+		case S24: /* e.g. "\\0" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -2089,27 +2165,12 @@ z7(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S15; break;
-			case '{': state = S16; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
+			case '7': state = S51; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S15: /* e.g. "\\xa" */
+		case S25: /* e.g. "\\xa" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -2132,12 +2193,15 @@ z7(struct lx_pcre_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S18; break;
+			case 'f': state = S26; break;
 			default:  lx_pcre_ungetc(lx, c); return TOK_HEX;
 			}
 			break;
 
-		case S16: /* e.g. "\\x{" */
+		case S26: /* e.g. "\\xaa" */
+			lx_pcre_ungetc(lx, c); return TOK_HEX;
+
+		case S27: /* e.g. "\\o{" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -2146,26 +2210,23 @@ z7(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S17; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '7': state = S30; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S28: /* start */
+			switch ((unsigned char) c) {
+			case ']': state = S10; break;
+			case '^': state = S11; break;
+			case '\\': state = S12; break;
+			case '-': state = S14; break;
+			case '[': state = S21; break;
+			default: state = S19; break;
 			}
 			break;
 
-		case S17: /* e.g. "\\x{a" */
+		case S29: /* e.g. "\\x{" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -2188,31 +2249,14 @@ z7(struct lx_pcre_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': break;
-			case '}': state = S18; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S18: /* e.g. "\\xaa" */
-			lx_pcre_ungetc(lx, c); return TOK_HEX;
-
-		case S19: /* e.g. "\\o{" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'f': state = S38; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S20: /* e.g. "\\o{0" */
+		case S30: /* e.g. "\\o{0" */
 			switch ((unsigned char) c) {
+			case '}': state = S23; break;
 			case '0':
 			case '1':
 			case '2':
@@ -2221,370 +2265,324 @@ z7(struct lx_pcre_lx *lx)
 			case '5':
 			case '6':
 			case '7': break;
-			case '}': state = S21; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S21: /* e.g. "\\000" */
-			lx_pcre_ungetc(lx, c); return TOK_OCT;
-
-		case S22: /* e.g. "\\ca" */
-			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
-
-		case S23: /* e.g. "\\00" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S21; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
-			}
-			break;
-
-		case S24: /* e.g. "[:" */
-			switch ((unsigned char) c) {
-			case 'a': state = S25; break;
-			case 'b': state = S26; break;
-			case 'c': state = S27; break;
-			case 'd': state = S28; break;
-			case 'g': state = S29; break;
-			case 'l': state = S30; break;
-			case 'p': state = S31; break;
-			case 's': state = S32; break;
-			case 'u': state = S33; break;
-			case 'w': state = S34; break;
-			case 'x': state = S35; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S25: /* e.g. "[:a" */
-			switch ((unsigned char) c) {
-			case 'l': state = S63; break;
-			case 's': state = S64; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S26: /* e.g. "[:b" */
-			switch ((unsigned char) c) {
-			case 'l': state = S60; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S27: /* e.g. "[:c" */
-			switch ((unsigned char) c) {
-			case 'n': state = S57; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S28: /* e.g. "[:d" */
-			switch ((unsigned char) c) {
-			case 'i': state = S55; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S29: /* e.g. "[:g" */
+		case S31: /* e.g. "[:alph" */
 			switch ((unsigned char) c) {
-			case 'r': state = S52; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S30: /* e.g. "[:l" */
+		case S32: /* e.g. "[:wor" */
 			switch ((unsigned char) c) {
-			case 'o': state = S51; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'd': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S31: /* e.g. "[:p" */
+		case S33: /* e.g. "[:spac" */
 			switch ((unsigned char) c) {
-			case 'r': state = S46; break;
-			case 'u': state = S47; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S32: /* e.g. "[:s" */
+		case S34: /* e.g. "[:grap" */
 			switch ((unsigned char) c) {
-			case 'p': state = S43; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S33: /* e.g. "[:u" */
+		case S35: /* e.g. "[:asci" */
 			switch ((unsigned char) c) {
-			case 'p': state = S40; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S34: /* e.g. "[:w" */
+		case S36: /* e.g. "[:blan" */
 			switch ((unsigned char) c) {
-			case 'o': state = S36; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'k': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S35: /* e.g. "[:x" */
+		case S37: /* e.g. "[:cntr" */
 			switch ((unsigned char) c) {
-			case 'd': state = S28; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'l': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S36: /* e.g. "[:wo" */
+		case S38: /* e.g. "\\x{a" */
 			switch ((unsigned char) c) {
-			case 'r': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S37: /* e.g. "[:wor" */
-			switch ((unsigned char) c) {
-			case 'd': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S38: /* e.g. "[:word" */
-			switch ((unsigned char) c) {
-			case ':': state = S39; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '}': state = S26; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S39: /* e.g. "[:word:" */
+		case S39: /* e.g. "[:digi" */
 			switch ((unsigned char) c) {
-			case ']': state = S10; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S40: /* e.g. "[:up" */
+		case S40: /* e.g. "[:" */
 			switch ((unsigned char) c) {
-			case 'p': state = S41; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S2; break;
+			case 'g': state = S3; break;
+			case 'x': state = S17; break;
+			case 'd': state = S41; break;
+			case 'c': state = S43; break;
+			case 'l': state = S44; break;
+			case 'w': state = S59; break;
+			case 'p': state = S66; break;
+			case 'b': state = S67; break;
+			case 's': state = S68; break;
+			case 'u': state = S69; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S41: /* e.g. "[:low" */
+		case S41: /* e.g. "[:d" */
 			switch ((unsigned char) c) {
-			case 'e': state = S42; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S48; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
 		case S42: /* e.g. "[:lowe" */
 			switch ((unsigned char) c) {
-			case 'r': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S43: /* e.g. "[:sp" */
+		case S43: /* e.g. "[:c" */
 			switch ((unsigned char) c) {
-			case 'a': state = S44; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S57; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S44: /* e.g. "[:spa" */
+		case S44: /* e.g. "[:l" */
 			switch ((unsigned char) c) {
-			case 'c': state = S45; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S53; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S45: /* e.g. "[:spac" */
+		case S45: /* e.g. "[:alnu" */
 			switch ((unsigned char) c) {
-			case 'e': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'm': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S46: /* e.g. "[:pr" */
+		case S46: /* e.g. "[:word:" */
 			switch ((unsigned char) c) {
-			case 'i': state = S50; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ']': state = S15; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S47: /* e.g. "[:pu" */
+		case S47: /* e.g. "[:word" */
 			switch ((unsigned char) c) {
-			case 'n': state = S48; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ':': state = S46; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S48: /* e.g. "[:pun" */
+		case S48: /* e.g. "[:di" */
 			switch ((unsigned char) c) {
-			case 'c': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'g': state = S64; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S49: /* e.g. "[:prin" */
+		case S49: /* e.g. "[:pr" */
 			switch ((unsigned char) c) {
-			case 't': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S63; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S50: /* e.g. "[:pri" */
+		case S50: /* e.g. "[:as" */
 			switch ((unsigned char) c) {
-			case 'n': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S5; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S51: /* e.g. "[:lo" */
+		case S51: /* e.g. "\\00" */
 			switch ((unsigned char) c) {
-			case 'w': state = S41; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': state = S23; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S52: /* e.g. "[:gr" */
+		case S52: /* e.g. "[:up" */
 			switch ((unsigned char) c) {
-			case 'a': state = S53; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S56; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S53: /* e.g. "[:gra" */
+		case S53: /* e.g. "[:lo" */
 			switch ((unsigned char) c) {
-			case 'p': state = S54; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'w': state = S56; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S54: /* e.g. "[:grap" */
+		case S54: /* e.g. "[:pu" */
 			switch ((unsigned char) c) {
-			case 'h': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S65; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S55: /* e.g. "[:di" */
+		case S55: /* e.g. "[:al" */
 			switch ((unsigned char) c) {
-			case 'g': state = S56; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S7; break;
+			case 'p': state = S58; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S56: /* e.g. "[:dig" */
+		case S56: /* e.g. "[:low" */
 			switch ((unsigned char) c) {
-			case 'i': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S42; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
 		case S57: /* e.g. "[:cn" */
 			switch ((unsigned char) c) {
-			case 't': state = S58; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S62; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S58: /* e.g. "[:cnt" */
+		case S58: /* e.g. "[:alp" */
 			switch ((unsigned char) c) {
-			case 'r': state = S59; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S31; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S59: /* e.g. "[:cntr" */
+		case S59: /* e.g. "[:w" */
 			switch ((unsigned char) c) {
-			case 'l': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S8; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S60: /* e.g. "[:bl" */
+		case S60: /* e.g. "[:gra" */
 			switch ((unsigned char) c) {
-			case 'a': state = S61; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S34; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S61: /* e.g. "[:bla" */
-			switch ((unsigned char) c) {
-			case 'n': state = S62; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		case S61: /* e.g. "\\b" */
+			lx_pcre_ungetc(lx, c); return TOK_NOESC;
 
-		case S62: /* e.g. "[:blan" */
+		case S62: /* e.g. "[:cnt" */
 			switch ((unsigned char) c) {
-			case 'k': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S37; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S63: /* e.g. "[:al" */
+		case S63: /* e.g. "[:pri" */
 			switch ((unsigned char) c) {
-			case 'n': state = S67; break;
-			case 'p': state = S68; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S64: /* e.g. "[:as" */
+		case S64: /* e.g. "[:dig" */
 			switch ((unsigned char) c) {
-			case 'c': state = S65; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S65: /* e.g. "[:asc" */
+		case S65: /* e.g. "[:pun" */
 			switch ((unsigned char) c) {
-			case 'i': state = S66; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S66: /* e.g. "[:asci" */
+		case S66: /* e.g. "[:p" */
 			switch ((unsigned char) c) {
-			case 'i': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S49; break;
+			case 'u': state = S54; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S67: /* e.g. "[:aln" */
+		case S67: /* e.g. "[:b" */
 			switch ((unsigned char) c) {
-			case 'u': state = S70; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'l': state = S0; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S68: /* e.g. "[:alp" */
+		case S68: /* e.g. "[:s" */
 			switch ((unsigned char) c) {
-			case 'h': state = S69; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S1; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S69: /* e.g. "[:alph" */
+		case S69: /* e.g. "[:u" */
 			switch ((unsigned char) c) {
-			case 'a': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S52; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S70: /* e.g. "[:alnu" */
+		case S70: /* e.g. "[:gr" */
 			switch ((unsigned char) c) {
-			case 'm': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S60; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
@@ -2593,7 +2591,7 @@ z7(struct lx_pcre_lx *lx)
 		}
 
 		switch (state) {
-		case S11:
+		case S16:
 			break;
 
 		default:
@@ -2607,29 +2605,29 @@ z7(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_RANGE;
-	case S3: return TOK_CHAR;
-	case S4: return TOK_INVALID;
-	case S5: return TOK_CLOSEGROUP;
-	case S6: return TOK_INVERT;
-	case S7: return TOK_NOESC;
-	case S8: return TOK_ESC;
-	case S9: return TOK_OCT;
-	case S10: return TOK_NAMED__CLASS;
-	case S11: return TOK_EOF;
-	case S12: return TOK_NOESC;
-	case S13: return TOK_NOESC;
-	case S14: return TOK_NOESC;
-	case S15: return TOK_HEX;
-	case S18: return TOK_HEX;
-	case S21: return TOK_OCT;
-	case S22: return TOK_CONTROL;
+	case S9: return TOK_NOESC;
+	case S10: return TOK_CLOSEGROUP;
+	case S11: return TOK_INVERT;
+	case S12: return TOK_INVALID;
+	case S13: return TOK_ESC;
+	case S14: return TOK_RANGE;
+	case S15: return TOK_NAMED__CLASS;
+	case S16: return TOK_EOF;
+	case S18: return TOK_CONTROL;
+	case S19: return TOK_CHAR;
+	case S20: return TOK_NOESC;
+	case S21: return TOK_CHAR;
+	case S22: return TOK_NOESC;
 	case S23: return TOK_OCT;
+	case S24: return TOK_OCT;
+	case S25: return TOK_HEX;
+	case S26: return TOK_HEX;
+	case S51: return TOK_OCT;
+	case S61: return TOK_NOESC;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -2655,37 +2653,37 @@ z8(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "\\" */
 			switch ((unsigned char) c) {
-			case '\\': state = S2; break;
-			case '\x00': lx->lgetc = NULL; return TOK_UNKNOWN;
-			default: state = S1; break;
+			case 'E': state = S2; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
-
-		case S2: /* e.g. "\\" */
+		case S1: /* start */
 			switch ((unsigned char) c) {
-			case 'E': state = S3; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			case '\\': state = S0; break;
+			case '\x00': lx->p = NULL; return TOK_UNKNOWN;
+			default: state = S3; break;
 			}
 			break;
 
-		case S3: /* e.g. "\\E" */
+		case S2: /* e.g. "\\E" */
 			lx_pcre_ungetc(lx, c); return lx->z = z9, lx->z(lx);
 
+		case S3: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
 		default:
 			; /* unreached */
 		}
 
 		switch (state) {
-		case S3:
+		case S2:
 			break;
 
 		default:
@@ -2699,13 +2697,13 @@ z8(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_CHAR;
-	case S3: return TOK_EOF;
+	case S0: return TOK_CHAR;
+	case S2: return TOK_EOF;
+	case S3: return TOK_CHAR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -2738,37 +2736,112 @@ z9(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S28;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "[:bl" */
 			switch ((unsigned char) c) {
-			case '-': state = S2; break;
-			case '[': state = S3; break;
-			case '\\': state = S4; break;
-			case ']': state = S5; break;
-			case '^': state = S6; break;
-			case '\x00': lx->lgetc = NULL; return TOK_UNKNOWN;
-			default: state = S1; break;
+			case 'a': state = S6; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+		case S1: /* e.g. "[:sp" */
+			switch ((unsigned char) c) {
+			case 'a': state = S4; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
-		case S2: /* e.g. "-" */
-			lx_pcre_ungetc(lx, c); return TOK_RANGE;
+		case S2: /* e.g. "[:a" */
+			switch ((unsigned char) c) {
+			case 's': state = S50; break;
+			case 'l': state = S55; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
-		case S3: /* e.g. "[" */
+		case S3: /* e.g. "[:g" */
 			switch ((unsigned char) c) {
-			case ':': state = S24; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			case 'r': state = S70; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S4: /* e.g. "[:spa" */
+			switch ((unsigned char) c) {
+			case 'c': state = S33; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S5: /* e.g. "[:asc" */
+			switch ((unsigned char) c) {
+			case 'i': state = S35; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S6: /* e.g. "[:bla" */
+			switch ((unsigned char) c) {
+			case 'n': state = S36; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S7: /* e.g. "[:aln" */
+			switch ((unsigned char) c) {
+			case 'u': state = S45; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S8: /* e.g. "[:wo" */
+			switch ((unsigned char) c) {
+			case 'r': state = S32; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S9: /* e.g. "\\x" */
+			switch ((unsigned char) c) {
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': state = S25; break;
+			case '{': state = S29; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S4: /* e.g. "\\" */
+		case S10: /* e.g. "]" */
+			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEGROUP;
+
+		case S11: /* e.g. "^" */
+			lx_pcre_ungetc(lx, c); return TOK_INVERT;
+
+		case S12: /* e.g. "\\" */
 			switch ((unsigned char) c) {
+			case 'x': state = S9; break;
 			case '$':
 			case '(':
 			case '*':
@@ -2785,15 +2858,7 @@ z9(struct lx_pcre_lx *lx)
 			case 'r':
 			case 't':
 			case '{':
-			case '|': state = S8; break;
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S9; break;
+			case '|': state = S13; break;
 			case 'D':
 			case 'H':
 			case 'N':
@@ -2804,29 +2869,10 @@ z9(struct lx_pcre_lx *lx)
 			case 'h':
 			case 's':
 			case 'v':
-			case 'w': state = S10; break;
-			case 'Q': state = S11; break;
-			case 'c': state = S12; break;
-			case 'o': state = S13; break;
-			case 'x': state = S14; break;
-			default: state = S7; break;
-			}
-			break;
-
-		case S5: /* e.g. "]" */
-			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEGROUP;
-
-		case S6: /* e.g. "^" */
-			lx_pcre_ungetc(lx, c); return TOK_INVERT;
-
-		case S7: /* e.g. "\\b" */
-			lx_pcre_ungetc(lx, c); return TOK_NOESC;
-
-		case S8: /* e.g. "\\a" */
-			lx_pcre_ungetc(lx, c); return TOK_ESC;
-
-		case S9: /* e.g. "\\0" */
-			switch ((unsigned char) c) {
+			case 'w': state = S15; break;
+			case 'Q': state = S16; break;
+			case 'c': state = S20; break;
+			case 'o': state = S22; break;
 			case '0':
 			case '1':
 			case '2':
@@ -2834,28 +2880,57 @@ z9(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7': state = S23; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
+			case '7': state = S24; break;
+			default: state = S61; break;
 			}
 			break;
 
-		case S10: /* e.g. "\\d" */
+		case S13: /* e.g. "\\a" */
+			lx_pcre_ungetc(lx, c); return TOK_ESC;
+
+		case S14: /* e.g. "-" */
+			lx_pcre_ungetc(lx, c); return TOK_RANGE;
+
+		case S15: /* e.g. "\\d" */
 			lx_pcre_ungetc(lx, c); return TOK_NAMED__CLASS;
 
-		case S11: /* e.g. "\\Q" */
+		case S16: /* e.g. "\\Q" */
 			lx_pcre_ungetc(lx, c); return lx->z = z8, lx->z(lx);
 
-		case S12: /* e.g. "\\c" */
-			state = S22; break;
+		case S17: /* e.g. "[:x" */
+			switch ((unsigned char) c) {
+			case 'd': state = S41; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S18: /* e.g. "\\ca" */
+			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
+
+		case S19: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
+		case S20: /* e.g. "\\c" */
+			state = S18; break;
+
+		case S21: /* e.g. "[" */
+			switch ((unsigned char) c) {
+			case ':': state = S40; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_CHAR;
+			}
+			break;
 
-		case S13: /* e.g. "\\o" */
+		case S22: /* e.g. "\\o" */
 			switch ((unsigned char) c) {
-			case '{': state = S19; break;
+			case '{': state = S27; break;
 			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S14: /* e.g. "\\x" */
+		case S23: /* e.g. "\\000" */
+			lx_pcre_ungetc(lx, c); return TOK_OCT;
+
+		case S24: /* e.g. "\\0" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -2864,27 +2939,12 @@ z9(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S15; break;
-			case '{': state = S16; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
+			case '7': state = S51; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S15: /* e.g. "\\xa" */
+		case S25: /* e.g. "\\xa" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -2907,12 +2967,15 @@ z9(struct lx_pcre_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S18; break;
+			case 'f': state = S26; break;
 			default:  lx_pcre_ungetc(lx, c); return TOK_HEX;
 			}
 			break;
 
-		case S16: /* e.g. "\\x{" */
+		case S26: /* e.g. "\\xaa" */
+			lx_pcre_ungetc(lx, c); return TOK_HEX;
+
+		case S27: /* e.g. "\\o{" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -2921,26 +2984,24 @@ z9(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S17; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '7': state = S30; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S28: /* start */
+			switch ((unsigned char) c) {
+			case ']': state = S10; break;
+			case '^': state = S11; break;
+			case '\\': state = S12; break;
+			case '-': state = S14; break;
+			case '[': state = S21; break;
+			case '\x00': lx->p = NULL; return TOK_UNKNOWN;
+			default: state = S19; break;
 			}
 			break;
 
-		case S17: /* e.g. "\\x{a" */
+		case S29: /* e.g. "\\x{" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -2961,405 +3022,342 @@ z9(struct lx_pcre_lx *lx)
 			case 'a':
 			case 'b':
 			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': break;
-			case '}': state = S18; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S18: /* e.g. "\\xaa" */
-			lx_pcre_ungetc(lx, c); return TOK_HEX;
-
-		case S19: /* e.g. "\\o{" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S20: /* e.g. "\\o{0" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': break;
-			case '}': state = S21; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S21: /* e.g. "\\000" */
-			lx_pcre_ungetc(lx, c); return TOK_OCT;
-
-		case S22: /* e.g. "\\ca" */
-			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
-
-		case S23: /* e.g. "\\00" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S21; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
-			}
-			break;
-
-		case S24: /* e.g. "[:" */
-			switch ((unsigned char) c) {
-			case 'a': state = S25; break;
-			case 'b': state = S26; break;
-			case 'c': state = S27; break;
-			case 'd': state = S28; break;
-			case 'g': state = S29; break;
-			case 'l': state = S30; break;
-			case 'p': state = S31; break;
-			case 's': state = S32; break;
-			case 'u': state = S33; break;
-			case 'w': state = S34; break;
-			case 'x': state = S35; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S25: /* e.g. "[:a" */
-			switch ((unsigned char) c) {
-			case 'l': state = S63; break;
-			case 's': state = S64; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S26: /* e.g. "[:b" */
-			switch ((unsigned char) c) {
-			case 'l': state = S60; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S27: /* e.g. "[:c" */
-			switch ((unsigned char) c) {
-			case 'n': state = S57; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S28: /* e.g. "[:d" */
-			switch ((unsigned char) c) {
-			case 'i': state = S55; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S29: /* e.g. "[:g" */
-			switch ((unsigned char) c) {
-			case 'r': state = S52; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'd':
+			case 'e':
+			case 'f': state = S38; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S30: /* e.g. "[:l" */
+		case S30: /* e.g. "\\o{0" */
 			switch ((unsigned char) c) {
-			case 'o': state = S51; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '}': state = S23; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S31: /* e.g. "[:p" */
+		case S31: /* e.g. "[:alph" */
 			switch ((unsigned char) c) {
-			case 'r': state = S46; break;
-			case 'u': state = S47; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S32: /* e.g. "[:s" */
+		case S32: /* e.g. "[:wor" */
 			switch ((unsigned char) c) {
-			case 'p': state = S43; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'd': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S33: /* e.g. "[:u" */
+		case S33: /* e.g. "[:spac" */
 			switch ((unsigned char) c) {
-			case 'p': state = S40; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S34: /* e.g. "[:w" */
+		case S34: /* e.g. "[:grap" */
 			switch ((unsigned char) c) {
-			case 'o': state = S36; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S35: /* e.g. "[:x" */
+		case S35: /* e.g. "[:asci" */
 			switch ((unsigned char) c) {
-			case 'd': state = S28; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S36: /* e.g. "[:wo" */
+		case S36: /* e.g. "[:blan" */
 			switch ((unsigned char) c) {
-			case 'r': state = S37; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'k': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S37: /* e.g. "[:wor" */
+		case S37: /* e.g. "[:cntr" */
 			switch ((unsigned char) c) {
-			case 'd': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'l': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S38: /* e.g. "[:word" */
+		case S38: /* e.g. "\\x{a" */
 			switch ((unsigned char) c) {
-			case ':': state = S39; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '}': state = S26; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S39: /* e.g. "[:word:" */
+		case S39: /* e.g. "[:digi" */
 			switch ((unsigned char) c) {
-			case ']': state = S10; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S40: /* e.g. "[:up" */
+		case S40: /* e.g. "[:" */
 			switch ((unsigned char) c) {
-			case 'p': state = S41; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S2; break;
+			case 'g': state = S3; break;
+			case 'x': state = S17; break;
+			case 'd': state = S41; break;
+			case 'c': state = S43; break;
+			case 'l': state = S44; break;
+			case 'w': state = S59; break;
+			case 'p': state = S66; break;
+			case 'b': state = S67; break;
+			case 's': state = S68; break;
+			case 'u': state = S69; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S41: /* e.g. "[:low" */
+		case S41: /* e.g. "[:d" */
 			switch ((unsigned char) c) {
-			case 'e': state = S42; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S48; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
 		case S42: /* e.g. "[:lowe" */
 			switch ((unsigned char) c) {
-			case 'r': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S43: /* e.g. "[:sp" */
+		case S43: /* e.g. "[:c" */
 			switch ((unsigned char) c) {
-			case 'a': state = S44; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S57; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S44: /* e.g. "[:spa" */
+		case S44: /* e.g. "[:l" */
 			switch ((unsigned char) c) {
-			case 'c': state = S45; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S53; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S45: /* e.g. "[:spac" */
+		case S45: /* e.g. "[:alnu" */
 			switch ((unsigned char) c) {
-			case 'e': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'm': state = S47; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S46: /* e.g. "[:pr" */
+		case S46: /* e.g. "[:word:" */
 			switch ((unsigned char) c) {
-			case 'i': state = S50; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ']': state = S15; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S47: /* e.g. "[:pu" */
+		case S47: /* e.g. "[:word" */
 			switch ((unsigned char) c) {
-			case 'n': state = S48; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ':': state = S46; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S48: /* e.g. "[:pun" */
+		case S48: /* e.g. "[:di" */
 			switch ((unsigned char) c) {
-			case 'c': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'g': state = S64; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S49: /* e.g. "[:prin" */
+		case S49: /* e.g. "[:pr" */
 			switch ((unsigned char) c) {
-			case 't': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S63; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S50: /* e.g. "[:pri" */
+		case S50: /* e.g. "[:as" */
 			switch ((unsigned char) c) {
-			case 'n': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S5; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S51: /* e.g. "[:lo" */
+		case S51: /* e.g. "\\00" */
 			switch ((unsigned char) c) {
-			case 'w': state = S41; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': state = S23; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S52: /* e.g. "[:gr" */
+		case S52: /* e.g. "[:up" */
 			switch ((unsigned char) c) {
-			case 'a': state = S53; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S56; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S53: /* e.g. "[:gra" */
+		case S53: /* e.g. "[:lo" */
 			switch ((unsigned char) c) {
-			case 'p': state = S54; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'w': state = S56; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S54: /* e.g. "[:grap" */
+		case S54: /* e.g. "[:pu" */
 			switch ((unsigned char) c) {
-			case 'h': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S65; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S55: /* e.g. "[:di" */
+		case S55: /* e.g. "[:al" */
 			switch ((unsigned char) c) {
-			case 'g': state = S56; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S7; break;
+			case 'p': state = S58; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S56: /* e.g. "[:dig" */
+		case S56: /* e.g. "[:low" */
 			switch ((unsigned char) c) {
-			case 'i': state = S49; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'e': state = S42; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
 		case S57: /* e.g. "[:cn" */
 			switch ((unsigned char) c) {
-			case 't': state = S58; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 't': state = S62; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S58: /* e.g. "[:cnt" */
+		case S58: /* e.g. "[:alp" */
 			switch ((unsigned char) c) {
-			case 'r': state = S59; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'h': state = S31; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S59: /* e.g. "[:cntr" */
+		case S59: /* e.g. "[:w" */
 			switch ((unsigned char) c) {
-			case 'l': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'o': state = S8; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S60: /* e.g. "[:bl" */
+		case S60: /* e.g. "[:gra" */
 			switch ((unsigned char) c) {
-			case 'a': state = S61; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S34; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S61: /* e.g. "[:bla" */
-			switch ((unsigned char) c) {
-			case 'n': state = S62; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
+		case S61: /* e.g. "\\b" */
+			lx_pcre_ungetc(lx, c); return TOK_NOESC;
 
-		case S62: /* e.g. "[:blan" */
+		case S62: /* e.g. "[:cnt" */
 			switch ((unsigned char) c) {
-			case 'k': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S37; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S63: /* e.g. "[:al" */
+		case S63: /* e.g. "[:pri" */
 			switch ((unsigned char) c) {
-			case 'n': state = S67; break;
-			case 'p': state = S68; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'n': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S64: /* e.g. "[:as" */
+		case S64: /* e.g. "[:dig" */
 			switch ((unsigned char) c) {
-			case 'c': state = S65; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'i': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S65: /* e.g. "[:asc" */
+		case S65: /* e.g. "[:pun" */
 			switch ((unsigned char) c) {
-			case 'i': state = S66; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'c': state = S39; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S66: /* e.g. "[:asci" */
+		case S66: /* e.g. "[:p" */
 			switch ((unsigned char) c) {
-			case 'i': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'r': state = S49; break;
+			case 'u': state = S54; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S67: /* e.g. "[:aln" */
+		case S67: /* e.g. "[:b" */
 			switch ((unsigned char) c) {
-			case 'u': state = S70; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'l': state = S0; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S68: /* e.g. "[:alp" */
+		case S68: /* e.g. "[:s" */
 			switch ((unsigned char) c) {
-			case 'h': state = S69; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S1; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S69: /* e.g. "[:alph" */
+		case S69: /* e.g. "[:u" */
 			switch ((unsigned char) c) {
-			case 'a': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'p': state = S52; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S70: /* e.g. "[:alnu" */
+		case S70: /* e.g. "[:gr" */
 			switch ((unsigned char) c) {
-			case 'm': state = S38; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'a': state = S60; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
@@ -3368,7 +3366,7 @@ z9(struct lx_pcre_lx *lx)
 		}
 
 		switch (state) {
-		case S11:
+		case S16:
 			break;
 
 		default:
@@ -3382,29 +3380,29 @@ z9(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_RANGE;
-	case S3: return TOK_CHAR;
-	case S4: return TOK_INVALID;
-	case S5: return TOK_CLOSEGROUP;
-	case S6: return TOK_INVERT;
-	case S7: return TOK_NOESC;
-	case S8: return TOK_ESC;
-	case S9: return TOK_OCT;
-	case S10: return TOK_NAMED__CLASS;
-	case S11: return TOK_EOF;
-	case S12: return TOK_NOESC;
-	case S13: return TOK_NOESC;
-	case S14: return TOK_NOESC;
-	case S15: return TOK_HEX;
-	case S18: return TOK_HEX;
-	case S21: return TOK_OCT;
-	case S22: return TOK_CONTROL;
+	case S9: return TOK_NOESC;
+	case S10: return TOK_CLOSEGROUP;
+	case S11: return TOK_INVERT;
+	case S12: return TOK_INVALID;
+	case S13: return TOK_ESC;
+	case S14: return TOK_RANGE;
+	case S15: return TOK_NAMED__CLASS;
+	case S16: return TOK_EOF;
+	case S18: return TOK_CONTROL;
+	case S19: return TOK_CHAR;
+	case S20: return TOK_NOESC;
+	case S21: return TOK_CHAR;
+	case S22: return TOK_NOESC;
 	case S23: return TOK_OCT;
+	case S24: return TOK_OCT;
+	case S25: return TOK_HEX;
+	case S26: return TOK_HEX;
+	case S51: return TOK_OCT;
+	case S61: return TOK_NOESC;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -3430,13 +3428,16 @@ z10(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. ")" */
+			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEFLAGS;
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
-			case ')': state = S1; break;
+			case ')': state = S0; break;
 			case '-': state = S2; break;
 			case 'a':
 			case 'b':
@@ -3464,13 +3465,10 @@ z10(struct lx_pcre_lx *lx)
 			case 'y':
 			case 'z': state = S3; break;
 			case 'i': state = S4; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. ")" */
-			lx_pcre_ungetc(lx, c); return lx->z = z11, TOK_CLOSEFLAGS;
-
 		case S2: /* e.g. "-" */
 			lx_pcre_ungetc(lx, c); return TOK_NEGATE;
 
@@ -3491,11 +3489,11 @@ z10(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CLOSEFLAGS;
+	case S0: return TOK_CLOSEFLAGS;
 	case S2: return TOK_NEGATE;
 	case S3: return TOK_FLAG__UNKNOWN;
 	case S4: return TOK_FLAG__INSENSITIVE;
@@ -3527,67 +3525,111 @@ z11(struct lx_pcre_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S34;
 		}
 
 		switch (state) {
-		case S0: /* start */
-			switch ((unsigned char) c) {
-			case '$': state = S2; break;
-			case '(': state = S3; break;
-			case ')': state = S4; break;
-			case '*': state = S5; break;
-			case '+': state = S6; break;
-			case '.': state = S7; break;
-			case '?': state = S8; break;
-			case '[': state = S9; break;
-			case '\\': state = S10; break;
-			case '^': state = S11; break;
-			case '{': state = S12; break;
-			case '|': state = S13; break;
-			case '\x00': lx->lgetc = NULL; return TOK_UNKNOWN;
-			default: state = S1; break;
+		case S0: /* e.g. "\\o{0" */
+			switch ((unsigned char) c) {
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': break;
+			case '}': state = S31; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+		case S1: /* e.g. "\\o{" */
+			switch ((unsigned char) c) {
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': state = S0; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
 
-		case S2: /* e.g. "$" */
-			lx_pcre_ungetc(lx, c); return TOK_END;
+		case S2: /* e.g. "\\00" */
+			switch ((unsigned char) c) {
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': state = S31; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
+			}
+			break;
 
-		case S3: /* e.g. "(" */
+		case S3: /* e.g. "\\b" */
+			lx_pcre_ungetc(lx, c); return TOK_NOESC;
+
+		case S4: /* e.g. "\\x" */
 			switch ((unsigned char) c) {
-			case '?': state = S34; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OPENCAPTURE;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': state = S27; break;
+			case '{': state = S33; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S4: /* e.g. ")" */
+		case S5: /* e.g. ")" */
 			lx_pcre_ungetc(lx, c); return TOK_CLOSE;
 
-		case S5: /* e.g. "*" */
+		case S6: /* e.g. "*" */
 			lx_pcre_ungetc(lx, c); return TOK_STAR;
 
-		case S6: /* e.g. "+" */
+		case S7: /* e.g. "+" */
 			lx_pcre_ungetc(lx, c); return TOK_PLUS;
 
-		case S7: /* e.g. "." */
+		case S8: /* e.g. "." */
 			lx_pcre_ungetc(lx, c); return TOK_ANY;
 
-		case S8: /* e.g. "?" */
+		case S9: /* e.g. "?" */
 			lx_pcre_ungetc(lx, c); return TOK_OPT;
 
-		case S9: /* e.g. "[" */
+		case S10: /* e.g. "[" */
 			switch ((unsigned char) c) {
-			case ']': state = S31; break;
-			case '^': state = S32; break;
+			case ']': state = S22; break;
+			case '^': state = S23; break;
 			default:  lx_pcre_ungetc(lx, c); return lx->z = z9, TOK_OPENGROUP;
 			}
 			break;
 
-		case S10: /* e.g. "\\" */
+		case S11: /* e.g. "\\" */
 			switch ((unsigned char) c) {
+			case 'x': state = S4; break;
 			case '$':
 			case '(':
 			case ')':
@@ -3604,15 +3646,7 @@ z11(struct lx_pcre_lx *lx)
 			case 'r':
 			case 't':
 			case '{':
-			case '|': state = S15; break;
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S16; break;
+			case '|': state = S16; break;
 			case 'D':
 			case 'H':
 			case 'N':
@@ -3623,61 +3657,80 @@ z11(struct lx_pcre_lx *lx)
 			case 'h':
 			case 's':
 			case 'v':
-			case 'w': state = S17; break;
-			case 'Q': state = S18; break;
-			case 'c': state = S19; break;
-			case 'o': state = S20; break;
-			case 'x': state = S21; break;
-			default: state = S14; break;
+			case 'w': state = S18; break;
+			case 'Q': state = S19; break;
+			case 'c': state = S28; break;
+			case 'o': state = S30; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7': state = S32; break;
+			default: state = S3; break;
 			}
 			break;
 
-		case S11: /* e.g. "^" */
+		case S12: /* e.g. "^" */
 			lx_pcre_ungetc(lx, c); return TOK_START;
 
-		case S12: /* e.g. "{" */
+		case S13: /* e.g. "{" */
 			lx_pcre_ungetc(lx, c); return lx->z = z1, TOK_OPENCOUNT;
 
-		case S13: /* e.g. "|" */
+		case S14: /* e.g. "|" */
 			lx_pcre_ungetc(lx, c); return TOK_ALT;
 
-		case S14: /* e.g. "\\b" */
-			lx_pcre_ungetc(lx, c); return TOK_NOESC;
-
-		case S15: /* e.g. "\\a" */
-			lx_pcre_ungetc(lx, c); return TOK_ESC;
-
-		case S16: /* e.g. "\\0" */
+		case S15: /* e.g. "(" */
 			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S30; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
+			case '?': state = S25; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OPENCAPTURE;
 			}
 			break;
 
-		case S17: /* e.g. "\\d" */
+		case S16: /* e.g. "\\a" */
+			lx_pcre_ungetc(lx, c); return TOK_ESC;
+
+		case S17: /* e.g. "$" */
+			lx_pcre_ungetc(lx, c); return TOK_END;
+
+		case S18: /* e.g. "\\d" */
 			lx_pcre_ungetc(lx, c); return TOK_NAMED__CLASS;
 
-		case S18: /* e.g. "\\Q" */
+		case S19: /* e.g. "\\Q" */
 			lx_pcre_ungetc(lx, c); return lx->z = z0, lx->z(lx);
 
-		case S19: /* e.g. "\\c" */
-			state = S29; break;
+		case S20: /* e.g. "a" */
+			lx_pcre_ungetc(lx, c); return TOK_CHAR;
+
+		case S21: /* e.g. "\\ca" */
+			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
+
+		case S22: /* e.g. "[]" */
+			lx_pcre_ungetc(lx, c); return lx->z = z5, TOK_OPENGROUPCB;
 
-		case S20: /* e.g. "\\o" */
+		case S23: /* e.g. "[^" */
 			switch ((unsigned char) c) {
-			case '{': state = S26; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
+			case ']': state = S24; break;
+			default:  lx_pcre_ungetc(lx, c); return lx->z = z7, TOK_OPENGROUPINV;
+			}
+			break;
+
+		case S24: /* e.g. "[^]" */
+			lx_pcre_ungetc(lx, c); return lx->z = z3, TOK_OPENGROUPINVCB;
+
+		case S25: /* e.g. "(?" */
+			switch ((unsigned char) c) {
+			case ':': state = S26; break;
+			default:  lx_pcre_ungetc(lx, c); return lx->z = z10, TOK_OPENFLAGS;
 			}
 			break;
 
-		case S21: /* e.g. "\\x" */
+		case S26: /* e.g. "(?:" */
+			lx_pcre_ungetc(lx, c); return TOK_OPENSUB;
+
+		case S27: /* e.g. "\\xa" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -3700,13 +3753,28 @@ z11(struct lx_pcre_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S22; break;
-			case '{': state = S23; break;
+			case 'f': state = S29; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_HEX;
+			}
+			break;
+
+		case S28: /* e.g. "\\c" */
+			state = S21; break;
+
+		case S29: /* e.g. "\\xaa" */
+			lx_pcre_ungetc(lx, c); return TOK_HEX;
+
+		case S30: /* e.g. "\\o" */
+			switch ((unsigned char) c) {
+			case '{': state = S1; break;
 			default:  lx_pcre_ungetc(lx, c); return TOK_NOESC;
 			}
 			break;
 
-		case S22: /* e.g. "\\xa" */
+		case S31: /* e.g. "\\000" */
+			lx_pcre_ungetc(lx, c); return TOK_OCT;
+
+		case S32: /* e.g. "\\0" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -3715,26 +3783,12 @@ z11(struct lx_pcre_lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': state = S25; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_HEX;
+			case '7': state = S2; break;
+			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
 			}
 			break;
 
-		case S23: /* e.g. "\\x{" */
+		case S33: /* e.g. "\\x{" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -3757,13 +3811,33 @@ z11(struct lx_pcre_lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S24; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'f': state = S35; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
+			}
+			break;
+
+		case S34: /* start */
+			switch ((unsigned char) c) {
+			case ')': state = S5; break;
+			case '*': state = S6; break;
+			case '+': state = S7; break;
+			case '.': state = S8; break;
+			case '?': state = S9; break;
+			case '[': state = S10; break;
+			case '\\': state = S11; break;
+			case '^': state = S12; break;
+			case '{': state = S13; break;
+			case '|': state = S14; break;
+			case '(': state = S15; break;
+			case '$': state = S17; break;
+			case '\x00': lx->p = NULL; return TOK_UNKNOWN;
+			default: state = S20; break;
 			}
 			break;
 
-		case S24: /* e.g. "\\x{a" */
+		case S35: /* e.g. "\\x{a" */
 			switch ((unsigned char) c) {
+			case '}': state = S29; break;
 			case '0':
 			case '1':
 			case '2':
@@ -3786,92 +3860,16 @@ z11(struct lx_pcre_lx *lx)
 			case 'd':
 			case 'e':
 			case 'f': break;
-			case '}': state = S25; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S25: /* e.g. "\\xaa" */
-			lx_pcre_ungetc(lx, c); return TOK_HEX;
-
-		case S26: /* e.g. "\\o{" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S27; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S27: /* e.g. "\\o{0" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': break;
-			case '}': state = S28; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
-			}
-			break;
-
-		case S28: /* e.g. "\\000" */
-			lx_pcre_ungetc(lx, c); return TOK_OCT;
-
-		case S29: /* e.g. "\\ca" */
-			lx_pcre_ungetc(lx, c); return TOK_CONTROL;
-
-		case S30: /* e.g. "\\00" */
-			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7': state = S28; break;
-			default:  lx_pcre_ungetc(lx, c); return TOK_OCT;
-			}
-			break;
-
-		case S31: /* e.g. "[]" */
-			lx_pcre_ungetc(lx, c); return lx->z = z5, TOK_OPENGROUPCB;
-
-		case S32: /* e.g. "[^" */
-			switch ((unsigned char) c) {
-			case ']': state = S33; break;
-			default:  lx_pcre_ungetc(lx, c); return lx->z = z7, TOK_OPENGROUPINV;
-			}
-			break;
-
-		case S33: /* e.g. "[^]" */
-			lx_pcre_ungetc(lx, c); return lx->z = z3, TOK_OPENGROUPINVCB;
-
-		case S34: /* e.g. "(?" */
-			switch ((unsigned char) c) {
-			case ':': state = S35; break;
-			default:  lx_pcre_ungetc(lx, c); return lx->z = z10, TOK_OPENFLAGS;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S35: /* e.g. "(?:" */
-			lx_pcre_ungetc(lx, c); return TOK_OPENSUB;
-
 		default:
 			; /* unreached */
 		}
 
 		switch (state) {
-		case S18:
+		case S19:
 			break;
 
 		default:
@@ -3885,41 +3883,41 @@ z11(struct lx_pcre_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_END;
-	case S3: return TOK_OPENCAPTURE;
-	case S4: return TOK_CLOSE;
-	case S5: return TOK_STAR;
-	case S6: return TOK_PLUS;
-	case S7: return TOK_ANY;
-	case S8: return TOK_OPT;
-	case S9: return TOK_OPENGROUP;
-	case S10: return TOK_INVALID;
-	case S11: return TOK_START;
-	case S12: return TOK_OPENCOUNT;
-	case S13: return TOK_ALT;
-	case S14: return TOK_NOESC;
-	case S15: return TOK_ESC;
-	case S16: return TOK_OCT;
-	case S17: return TOK_NAMED__CLASS;
-	case S18: return TOK_EOF;
-	case S19: return TOK_NOESC;
-	case S20: return TOK_NOESC;
-	case S21: return TOK_NOESC;
-	case S22: return TOK_HEX;
-	case S25: return TOK_HEX;
-	case S28: return TOK_OCT;
-	case S29: return TOK_CONTROL;
-	case S30: return TOK_OCT;
-	case S31: return TOK_OPENGROUPCB;
-	case S32: return TOK_OPENGROUPINV;
-	case S33: return TOK_OPENGROUPINVCB;
-	case S34: return TOK_OPENFLAGS;
-	case S35: return TOK_OPENSUB;
+	case S2: return TOK_OCT;
+	case S3: return TOK_NOESC;
+	case S4: return TOK_NOESC;
+	case S5: return TOK_CLOSE;
+	case S6: return TOK_STAR;
+	case S7: return TOK_PLUS;
+	case S8: return TOK_ANY;
+	case S9: return TOK_OPT;
+	case S10: return TOK_OPENGROUP;
+	case S11: return TOK_INVALID;
+	case S12: return TOK_START;
+	case S13: return TOK_OPENCOUNT;
+	case S14: return TOK_ALT;
+	case S15: return TOK_OPENCAPTURE;
+	case S16: return TOK_ESC;
+	case S17: return TOK_END;
+	case S18: return TOK_NAMED__CLASS;
+	case S19: return TOK_EOF;
+	case S20: return TOK_CHAR;
+	case S21: return TOK_CONTROL;
+	case S22: return TOK_OPENGROUPCB;
+	case S23: return TOK_OPENGROUPINV;
+	case S24: return TOK_OPENGROUPINVCB;
+	case S25: return TOK_OPENFLAGS;
+	case S26: return TOK_OPENSUB;
+	case S27: return TOK_HEX;
+	case S28: return TOK_NOESC;
+	case S29: return TOK_HEX;
+	case S30: return TOK_NOESC;
+	case S31: return TOK_OCT;
+	case S32: return TOK_OCT;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -4458,7 +4456,6 @@ lx_pcre_init(struct lx_pcre_lx *lx)
 
 	*lx = lx_default;
 
-	lx->c = EOF;
 	lx->z = z11;
 
 	lx->end.byte = 0;
@@ -4474,7 +4471,7 @@ lx_pcre_next(struct lx_pcre_lx *lx)
 	assert(lx != NULL);
 	assert(lx->z != NULL);
 
-	if (lx->lgetc == NULL) {
+	if (lx->p == NULL) {
 		return TOK_EOF;
 	}
 
@@ -55,10 +55,8 @@ struct lx_pos {
 };
 
 struct lx_pcre_lx {
-	int (*lgetc)(struct lx_pcre_lx *lx);
-	void *getc_opaque;
-
-	int c; /* lx_pcre_ungetc buffer */
+	const char *p; /* input string */
+	const char *e; /* one past end of input */
 
 	struct lx_pos start;
 	struct lx_pos end;
@@ -9,7 +9,7 @@
 
 /* BEGINNING OF HEADER */
 
-#line 142 "src/libre/parser.act"
+#line 140 "src/libre/parser.act"
 
 
 	#include <assert.h>
@@ -100,6 +100,7 @@
 		enum LX_TOKEN lex_tok;
 		enum LX_TOKEN lex_tok_save;
 		int overlap; /* permit overlap in groups */
+		struct re_arena *arena;
 
 		/*
 		 * Lexical position stored for syntax errors.
@@ -121,9 +122,6 @@
 		struct LX_STATE lx;
 		struct lx_dynbuf buf; /* XXX: unneccessary since we're lexing from a string */
 
-		re_getchar_fun *f;
-		void *opaque;
-
 		/* TODO: use lx's generated conveniences for the pattern buffer */
 		char a[512];
 		char *p;
@@ -209,7 +207,7 @@
 		return s;
 	}
 
-#line 213 "src/libre/dialect/pcre/parser.c"
+#line 211 "src/libre/dialect/pcre/parser.c"
 
 
 #ifndef ERROR_TERMINAL
@@ -264,17 +262,17 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hhead(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: INVERT */
 			{
-#line 237 "src/libre/parser.act"
+#line 235 "src/libre/parser.act"
 
 		ZI111 = '^';
 	
-#line 272 "src/libre/dialect/pcre/parser.c"
+#line 270 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: INVERT */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: ast-make-invert */
 			{
-#line 771 "src/libre/parser.act"
+#line 769 "src/libre/parser.act"
 
 		struct ast_expr *any;
 
@@ -302,17 +300,17 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hhead(flags flags, lex_state lex_state, act_
 		 * a better idea.
 		 */
 
-		any = ast_make_expr_named(&class_any);
+		any = ast_make_expr_named(act_state->arena, &class_any);
 		if (any == NULL) {
 			goto ZL1;
 		}
 
-		(*ZIclass) = ast_make_expr_subtract(any, (*ZIclass));
+		(*ZIclass) = ast_make_expr_subtract(act_state->arena, any, (*ZIclass));
 		if ((*ZIclass) == NULL) {
 			goto ZL1;
 		}
 	
-#line 316 "src/libre/dialect/pcre/parser.c"
+#line 314 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-invert */
 		}
@@ -340,21 +338,21 @@ p_expr_C_Cflags_C_Cflag__set(flags flags, lex_state lex_state, act_state act_sta
 
 			/* BEGINNING OF EXTRACT: FLAG_INSENSITIVE */
 			{
-#line 452 "src/libre/parser.act"
+#line 450 "src/libre/parser.act"
 
 		ZIc = RE_ICASE;
 	
-#line 348 "src/libre/dialect/pcre/parser.c"
+#line 346 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: FLAG_INSENSITIVE */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: re-flag-union */
 			{
-#line 587 "src/libre/parser.act"
+#line 585 "src/libre/parser.act"
 
 		(ZIo) = (ZIi) | (ZIc);
 	
-#line 358 "src/libre/dialect/pcre/parser.c"
+#line 356 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: re-flag-union */
 		}
@@ -365,14 +363,14 @@ p_expr_C_Cflags_C_Cflag__set(flags flags, lex_state lex_state, act_state act_sta
 			ZIo = ZIi;
 			/* BEGINNING OF ACTION: err-unknown-flag */
 			{
-#line 518 "src/libre/parser.act"
+#line 516 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EFLAG;
 		}
 		goto ZL1;
 	
-#line 376 "src/libre/dialect/pcre/parser.c"
+#line 374 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: err-unknown-flag */
 		}
@@ -410,7 +408,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 				{
 					/* BEGINNING OF EXTRACT: CHAR */
 					{
-#line 414 "src/libre/parser.act"
+#line 412 "src/libre/parser.act"
 
 		/* the first byte may be '\x00' */
 		assert(lex_state->buf.a[1] == '\0');
@@ -420,7 +418,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 
 		ZIc = lex_state->buf.a[0];
 	
-#line 424 "src/libre/dialect/pcre/parser.c"
+#line 422 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: CHAR */
 					ADVANCE_LEXER;
@@ -430,7 +428,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 				{
 					/* BEGINNING OF EXTRACT: CONTROL */
 					{
-#line 320 "src/libre/parser.act"
+#line 318 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] == 'c');
@@ -446,20 +444,20 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 		ZIstart = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 450 "src/libre/dialect/pcre/parser.c"
+#line 448 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: CONTROL */
 					ADVANCE_LEXER;
 					/* BEGINNING OF ACTION: err-unsupported */
 					{
-#line 539 "src/libre/parser.act"
+#line 537 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXUNSUPPORTD;
 		}
 		goto ZL1;
 	
-#line 463 "src/libre/dialect/pcre/parser.c"
+#line 461 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: err-unsupported */
 				}
@@ -468,7 +466,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 				{
 					/* BEGINNING OF EXTRACT: ESC */
 					{
-#line 287 "src/libre/parser.act"
+#line 285 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] != '\0');
@@ -489,7 +487,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 		ZIstart = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 493 "src/libre/dialect/pcre/parser.c"
+#line 491 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: ESC */
 					ADVANCE_LEXER;
@@ -499,7 +497,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 				{
 					/* BEGINNING OF EXTRACT: HEX */
 					{
-#line 378 "src/libre/parser.act"
+#line 376 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -539,7 +537,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 
 		ZIc = (char) (unsigned char) u;
 	
-#line 543 "src/libre/dialect/pcre/parser.c"
+#line 541 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: HEX */
 					ADVANCE_LEXER;
@@ -549,7 +547,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 				{
 					/* BEGINNING OF EXTRACT: OCT */
 					{
-#line 338 "src/libre/parser.act"
+#line 336 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -589,7 +587,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 
 		ZIc = (char) (unsigned char) u;
 	
-#line 593 "src/libre/dialect/pcre/parser.c"
+#line 591 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: OCT */
 					ADVANCE_LEXER;
@@ -602,12 +600,12 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hliteral(flags
 		/* END OF INLINE: 136 */
 		/* BEGINNING OF ACTION: ast-range-endpoint-literal */
 		{
-#line 631 "src/libre/parser.act"
+#line 629 "src/libre/parser.act"
 
 		(ZIr).type = AST_ENDPOINT_LITERAL;
 		(ZIr).u.literal.c = (ZIc);
 	
-#line 611 "src/libre/dialect/pcre/parser.c"
+#line 609 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-range-endpoint-literal */
 	}
@@ -631,14 +629,14 @@ p_269(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__cla
 		{
 			/* BEGINNING OF ACTION: ast-make-named */
 			{
-#line 814 "src/libre/parser.act"
+#line 812 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_named((*ZI266));
+		(ZInode) = ast_make_expr_named(act_state->arena, (*ZI266));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 642 "src/libre/dialect/pcre/parser.c"
+#line 640 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-named */
 		}
@@ -651,12 +649,12 @@ p_269(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__cla
 
 			/* BEGINNING OF ACTION: ast-range-endpoint-class */
 			{
-#line 636 "src/libre/parser.act"
+#line 634 "src/libre/parser.act"
 
 		(ZIlower).type = AST_ENDPOINT_NAMED;
 		(ZIlower).u.named.class = (*ZI266);
 	
-#line 660 "src/libre/dialect/pcre/parser.c"
+#line 658 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-range-endpoint-class */
 			p_149 (flags, lex_state, act_state, err);
@@ -667,17 +665,17 @@ p_269(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__cla
 			}
 			/* BEGINNING OF ACTION: mark-range */
 			{
-#line 548 "src/libre/parser.act"
+#line 546 "src/libre/parser.act"
 
 		mark(&act_state->rangestart, &(*ZI267));
 		mark(&act_state->rangeend,   &(ZIend));
 	
-#line 676 "src/libre/dialect/pcre/parser.c"
+#line 674 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: mark-range */
 			/* BEGINNING OF ACTION: ast-make-range */
 			{
-#line 784 "src/libre/parser.act"
+#line 782 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 		unsigned char lower, upper;
@@ -705,12 +703,12 @@ p_269(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__cla
 			goto ZL1;
 		}
 
-		(ZInode) = ast_make_expr_range(&(ZIlower), ast_start, &(ZIupper), ast_end);
+		(ZInode) = ast_make_expr_range(act_state->arena, &(ZIlower), ast_start, &(ZIupper), ast_end);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 714 "src/libre/dialect/pcre/parser.c"
+#line 712 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-range */
 		}
@@ -746,13 +744,13 @@ ZL2_expr_C_Ccharacter_Hclass_C_Clist_Hof_Hclass_Hterms:;
 				}
 				/* BEGINNING OF ACTION: ast-add-alt */
 				{
-#line 827 "src/libre/parser.act"
+#line 825 "src/libre/parser.act"
 
-		if (!ast_add_expr_alt((ZIclass), (ZInode))) {
+		if (!ast_add_expr_alt(act_state->arena, (ZIclass), (ZInode))) {
 			goto ZL4;
 		}
 	
-#line 756 "src/libre/dialect/pcre/parser.c"
+#line 754 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF ACTION: ast-add-alt */
 			}
@@ -761,14 +759,14 @@ ZL2_expr_C_Ccharacter_Hclass_C_Clist_Hof_Hclass_Hterms:;
 			{
 				/* BEGINNING OF ACTION: err-expected-term */
 				{
-#line 469 "src/libre/parser.act"
+#line 467 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXTERM;
 		}
 		goto ZL1;
 	
-#line 772 "src/libre/dialect/pcre/parser.c"
+#line 770 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF ACTION: err-expected-term */
 			}
@@ -802,13 +800,13 @@ p_149(flags flags, lex_state lex_state, act_state act_state, err err)
 		case (TOK_RANGE):
 			/* BEGINNING OF EXTRACT: RANGE */
 			{
-#line 241 "src/libre/parser.act"
+#line 239 "src/libre/parser.act"
 
 		ZI150 = '-';
 		ZI151 = lex_state->lx.start;
 		ZI152   = lex_state->lx.end;
 	
-#line 812 "src/libre/dialect/pcre/parser.c"
+#line 810 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: RANGE */
 			break;
@@ -822,14 +820,14 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-range */
 		{
-#line 497 "src/libre/parser.act"
+#line 495 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXRANGE;
 		}
 		goto ZL2;
 	
-#line 833 "src/libre/dialect/pcre/parser.c"
+#line 831 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: err-expected-range */
 	}
@@ -850,14 +848,14 @@ p_289(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 		{
 			/* BEGINNING OF ACTION: ast-make-literal */
 			{
-#line 683 "src/libre/parser.act"
+#line 681 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_literal((*ZI286));
+		(ZInode) = ast_make_expr_literal(act_state->arena, (*ZI286));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 861 "src/libre/dialect/pcre/parser.c"
+#line 859 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-literal */
 		}
@@ -870,12 +868,12 @@ p_289(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 
 			/* BEGINNING OF ACTION: ast-range-endpoint-literal */
 			{
-#line 631 "src/libre/parser.act"
+#line 629 "src/libre/parser.act"
 
 		(ZIlower).type = AST_ENDPOINT_LITERAL;
 		(ZIlower).u.literal.c = (*ZI286);
 	
-#line 879 "src/libre/dialect/pcre/parser.c"
+#line 877 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-range-endpoint-literal */
 			p_149 (flags, lex_state, act_state, err);
@@ -886,17 +884,17 @@ p_289(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 			}
 			/* BEGINNING OF ACTION: mark-range */
 			{
-#line 548 "src/libre/parser.act"
+#line 546 "src/libre/parser.act"
 
 		mark(&act_state->rangestart, &(*ZI287));
 		mark(&act_state->rangeend,   &(ZIend));
 	
-#line 895 "src/libre/dialect/pcre/parser.c"
+#line 893 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: mark-range */
 			/* BEGINNING OF ACTION: ast-make-range */
 			{
-#line 784 "src/libre/parser.act"
+#line 782 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 		unsigned char lower, upper;
@@ -924,12 +922,12 @@ p_289(flags flags, lex_state lex_state, act_state act_state, err err, t_char *ZI
 			goto ZL1;
 		}
 
-		(ZInode) = ast_make_expr_range(&(ZIlower), ast_start, &(ZIupper), ast_end);
+		(ZInode) = ast_make_expr_range(act_state->arena, &(ZIlower), ast_start, &(ZIupper), ast_end);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 933 "src/libre/dialect/pcre/parser.c"
+#line 931 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-range */
 		}
@@ -958,28 +956,28 @@ p_292(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 			/* BEGINNING OF EXTRACT: CLOSECOUNT */
 			{
-#line 278 "src/libre/parser.act"
+#line 276 "src/libre/parser.act"
 
 		ZI234 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 967 "src/libre/dialect/pcre/parser.c"
+#line 965 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: CLOSECOUNT */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: mark-count */
 			{
-#line 553 "src/libre/parser.act"
+#line 551 "src/libre/parser.act"
 
 		mark(&act_state->countstart, &(*ZI290));
 		mark(&act_state->countend,   &(ZIend));
 	
-#line 978 "src/libre/dialect/pcre/parser.c"
+#line 976 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: mark-count */
 			/* BEGINNING OF ACTION: count-range */
 			{
-#line 613 "src/libre/parser.act"
+#line 611 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 
@@ -999,7 +997,7 @@ p_292(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 		(ZIc) = ast_make_count((*ZIm), &ast_start, (*ZIm), &ast_end);
 	
-#line 1003 "src/libre/dialect/pcre/parser.c"
+#line 1001 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: count-range */
 		}
@@ -1044,13 +1042,13 @@ ZL2_expr_C_Clist_Hof_Hpieces:;
 		}
 		/* BEGINNING OF ACTION: ast-add-concat */
 		{
-#line 821 "src/libre/parser.act"
+#line 819 "src/libre/parser.act"
 
-		if (!ast_add_expr_concat((ZIcat), (ZIa))) {
+		if (!ast_add_expr_concat(act_state->arena, (ZIcat), (ZIa))) {
 			goto ZL1;
 		}
 	
-#line 1054 "src/libre/dialect/pcre/parser.c"
+#line 1052 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-add-concat */
 		/* BEGINNING OF INLINE: 247 */
@@ -1093,37 +1091,37 @@ p_293(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 			/* BEGINNING OF EXTRACT: CLOSECOUNT */
 			{
-#line 278 "src/libre/parser.act"
+#line 276 "src/libre/parser.act"
 
 		ZI239 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 1102 "src/libre/dialect/pcre/parser.c"
+#line 1100 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: CLOSECOUNT */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: mark-count */
 			{
-#line 553 "src/libre/parser.act"
+#line 551 "src/libre/parser.act"
 
 		mark(&act_state->countstart, &(*ZI290));
 		mark(&act_state->countend,   &(ZIend));
 	
-#line 1113 "src/libre/dialect/pcre/parser.c"
+#line 1111 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: mark-count */
 			/* BEGINNING OF ACTION: count-unbounded */
 			{
-#line 591 "src/libre/parser.act"
+#line 589 "src/libre/parser.act"
 
 		(ZIn) = AST_COUNT_UNBOUNDED;
 	
-#line 1122 "src/libre/dialect/pcre/parser.c"
+#line 1120 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: count-unbounded */
 			/* BEGINNING OF ACTION: count-range */
 			{
-#line 613 "src/libre/parser.act"
+#line 611 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 
@@ -1143,7 +1141,7 @@ p_293(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 		(ZIc) = ast_make_count((*ZIm), &ast_start, (ZIn), &ast_end);
 	
-#line 1147 "src/libre/dialect/pcre/parser.c"
+#line 1145 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: count-range */
 		}
@@ -1156,7 +1154,7 @@ p_293(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 			/* BEGINNING OF EXTRACT: COUNT */
 			{
-#line 429 "src/libre/parser.act"
+#line 427 "src/libre/parser.act"
 
 		unsigned long u;
 		char *e;
@@ -1176,7 +1174,7 @@ p_293(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 		ZIn = (unsigned int) u;
 	
-#line 1180 "src/libre/dialect/pcre/parser.c"
+#line 1178 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: COUNT */
 			ADVANCE_LEXER;
@@ -1184,12 +1182,12 @@ p_293(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 			case (TOK_CLOSECOUNT):
 				/* BEGINNING OF EXTRACT: CLOSECOUNT */
 				{
-#line 278 "src/libre/parser.act"
+#line 276 "src/libre/parser.act"
 
 		ZI237 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 1193 "src/libre/dialect/pcre/parser.c"
+#line 1191 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF EXTRACT: CLOSECOUNT */
 				break;
@@ -1199,17 +1197,17 @@ p_293(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: mark-count */
 			{
-#line 553 "src/libre/parser.act"
+#line 551 "src/libre/parser.act"
 
 		mark(&act_state->countstart, &(*ZI290));
 		mark(&act_state->countend,   &(ZIend));
 	
-#line 1208 "src/libre/dialect/pcre/parser.c"
+#line 1206 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: mark-count */
 			/* BEGINNING OF ACTION: count-range */
 			{
-#line 613 "src/libre/parser.act"
+#line 611 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 
@@ -1229,7 +1227,7 @@ p_293(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZI2
 
 		(ZIc) = ast_make_count((*ZIm), &ast_start, (ZIn), &ast_end);
 	
-#line 1233 "src/libre/dialect/pcre/parser.c"
+#line 1231 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: count-range */
 		}
@@ -1268,7 +1266,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 					/* BEGINNING OF EXTRACT: CHAR */
 					{
-#line 414 "src/libre/parser.act"
+#line 412 "src/libre/parser.act"
 
 		/* the first byte may be '\x00' */
 		assert(lex_state->buf.a[1] == '\0');
@@ -1278,7 +1276,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 		ZIc = lex_state->buf.a[0];
 	
-#line 1282 "src/libre/dialect/pcre/parser.c"
+#line 1280 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: CHAR */
 					ADVANCE_LEXER;
@@ -1291,7 +1289,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 					/* BEGINNING OF EXTRACT: ESC */
 					{
-#line 287 "src/libre/parser.act"
+#line 285 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] != '\0');
@@ -1312,7 +1310,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 		ZI96 = lex_state->lx.start;
 		ZI97   = lex_state->lx.end;
 	
-#line 1316 "src/libre/dialect/pcre/parser.c"
+#line 1314 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: ESC */
 					ADVANCE_LEXER;
@@ -1325,7 +1323,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 					/* BEGINNING OF EXTRACT: HEX */
 					{
-#line 378 "src/libre/parser.act"
+#line 376 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -1365,7 +1363,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 		ZIc = (char) (unsigned char) u;
 	
-#line 1369 "src/libre/dialect/pcre/parser.c"
+#line 1367 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: HEX */
 					ADVANCE_LEXER;
@@ -1378,7 +1376,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 					/* BEGINNING OF EXTRACT: NOESC */
 					{
-#line 308 "src/libre/parser.act"
+#line 306 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] != '\0');
@@ -1389,7 +1387,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 		ZI98 = lex_state->lx.start;
 		ZI99   = lex_state->lx.end;
 	
-#line 1393 "src/libre/dialect/pcre/parser.c"
+#line 1391 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: NOESC */
 					ADVANCE_LEXER;
@@ -1402,7 +1400,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 					/* BEGINNING OF EXTRACT: OCT */
 					{
-#line 338 "src/libre/parser.act"
+#line 336 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -1442,7 +1440,7 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 
 		ZIc = (char) (unsigned char) u;
 	
-#line 1446 "src/libre/dialect/pcre/parser.c"
+#line 1444 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: OCT */
 					ADVANCE_LEXER;
@@ -1455,14 +1453,14 @@ p_expr_C_Cliteral(flags flags, lex_state lex_state, act_state act_state, err err
 		/* END OF INLINE: 94 */
 		/* BEGINNING OF ACTION: ast-make-literal */
 		{
-#line 683 "src/libre/parser.act"
+#line 681 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_literal((ZIc));
+		(ZInode) = ast_make_expr_literal(act_state->arena, (ZIc));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1466 "src/libre/dialect/pcre/parser.c"
+#line 1464 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-make-literal */
 	}
@@ -1488,7 +1486,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: CHAR */
 			{
-#line 414 "src/libre/parser.act"
+#line 412 "src/libre/parser.act"
 
 		/* the first byte may be '\x00' */
 		assert(lex_state->buf.a[1] == '\0');
@@ -1498,7 +1496,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 		ZI282 = lex_state->buf.a[0];
 	
-#line 1502 "src/libre/dialect/pcre/parser.c"
+#line 1500 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: CHAR */
 			ADVANCE_LEXER;
@@ -1517,7 +1515,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: CONTROL */
 			{
-#line 320 "src/libre/parser.act"
+#line 318 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] == 'c');
@@ -1533,20 +1531,20 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 		ZI287 = lex_state->lx.start;
 		ZI288   = lex_state->lx.end;
 	
-#line 1537 "src/libre/dialect/pcre/parser.c"
+#line 1535 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: CONTROL */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: err-unsupported */
 			{
-#line 539 "src/libre/parser.act"
+#line 537 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXUNSUPPORTD;
 		}
 		goto ZL1;
 	
-#line 1550 "src/libre/dialect/pcre/parser.c"
+#line 1548 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: err-unsupported */
 			p_289 (flags, lex_state, act_state, err, &ZI286, &ZI287, &ZInode);
@@ -1564,7 +1562,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: ESC */
 			{
-#line 287 "src/libre/parser.act"
+#line 285 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] != '\0');
@@ -1585,7 +1583,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 		ZI271 = lex_state->lx.start;
 		ZI272   = lex_state->lx.end;
 	
-#line 1589 "src/libre/dialect/pcre/parser.c"
+#line 1587 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: ESC */
 			ADVANCE_LEXER;
@@ -1604,7 +1602,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: HEX */
 			{
-#line 378 "src/libre/parser.act"
+#line 376 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -1644,7 +1642,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 		ZI278 = (char) (unsigned char) u;
 	
-#line 1648 "src/libre/dialect/pcre/parser.c"
+#line 1646 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: HEX */
 			ADVANCE_LEXER;
@@ -1663,7 +1661,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: NAMED_CLASS */
 			{
-#line 441 "src/libre/parser.act"
+#line 439 "src/libre/parser.act"
 
 		ZI266 = DIALECT_CLASS(lex_state->buf.a);
 		if (ZI266 == NULL) {
@@ -1674,7 +1672,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 		ZI267 = lex_state->lx.start;
 		ZI268   = lex_state->lx.end;
 	
-#line 1678 "src/libre/dialect/pcre/parser.c"
+#line 1676 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: NAMED_CLASS */
 			ADVANCE_LEXER;
@@ -1693,7 +1691,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: NOESC */
 			{
-#line 308 "src/libre/parser.act"
+#line 306 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] != '\0');
@@ -1704,20 +1702,20 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 		ZI117 = lex_state->lx.start;
 		ZI118   = lex_state->lx.end;
 	
-#line 1708 "src/libre/dialect/pcre/parser.c"
+#line 1706 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: NOESC */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: ast-make-literal */
 			{
-#line 683 "src/libre/parser.act"
+#line 681 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_literal((ZIc));
+		(ZInode) = ast_make_expr_literal(act_state->arena, (ZIc));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1721 "src/libre/dialect/pcre/parser.c"
+#line 1719 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-literal */
 		}
@@ -1730,7 +1728,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 			/* BEGINNING OF EXTRACT: OCT */
 			{
-#line 338 "src/libre/parser.act"
+#line 336 "src/libre/parser.act"
 
 		unsigned long u;
 		char *s, *e;
@@ -1770,7 +1768,7 @@ p_expr_C_Ccharacter_Hclass_C_Cclass_Hterm(flags flags, lex_state lex_state, act_
 
 		ZI274 = (char) (unsigned char) u;
 	
-#line 1774 "src/libre/dialect/pcre/parser.c"
+#line 1772 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: OCT */
 			ADVANCE_LEXER;
@@ -1811,7 +1809,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hclass(flags fl
 		case (TOK_NAMED__CLASS):
 			/* BEGINNING OF EXTRACT: NAMED_CLASS */
 			{
-#line 441 "src/libre/parser.act"
+#line 439 "src/libre/parser.act"
 
 		ZIid = DIALECT_CLASS(lex_state->buf.a);
 		if (ZIid == NULL) {
@@ -1822,7 +1820,7 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hclass(flags fl
 		ZIstart = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 1826 "src/libre/dialect/pcre/parser.c"
+#line 1824 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: NAMED_CLASS */
 			break;
@@ -1832,12 +1830,12 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_C_Crange_Hendpoint_Hclass(flags fl
 		ADVANCE_LEXER;
 		/* BEGINNING OF ACTION: ast-range-endpoint-class */
 		{
-#line 636 "src/libre/parser.act"
+#line 634 "src/libre/parser.act"
 
 		(ZIr).type = AST_ENDPOINT_NAMED;
 		(ZIr).u.named.class = (ZIid);
 	
-#line 1841 "src/libre/dialect/pcre/parser.c"
+#line 1839 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-range-endpoint-class */
 	}
@@ -1864,13 +1862,13 @@ p_177(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__exp
 
 			/* BEGINNING OF EXTRACT: RANGE */
 			{
-#line 241 "src/libre/parser.act"
+#line 239 "src/libre/parser.act"
 
 		ZIc = '-';
 		ZIrstart = lex_state->lx.start;
 		ZI178   = lex_state->lx.end;
 	
-#line 1874 "src/libre/dialect/pcre/parser.c"
+#line 1872 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: RANGE */
 			ADVANCE_LEXER;
@@ -1881,14 +1879,14 @@ p_177(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__exp
 					{
 						/* BEGINNING OF ACTION: ast-make-literal */
 						{
-#line 683 "src/libre/parser.act"
+#line 681 "src/libre/parser.act"
 
-		(ZInode1) = ast_make_expr_literal((ZIc));
+		(ZInode1) = ast_make_expr_literal(act_state->arena, (ZIc));
 		if ((ZInode1) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1892 "src/libre/dialect/pcre/parser.c"
+#line 1890 "src/libre/dialect/pcre/parser.c"
 						}
 						/* END OF ACTION: ast-make-literal */
 					}
@@ -1904,23 +1902,23 @@ p_177(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__exp
 
 						/* BEGINNING OF ACTION: ast-range-endpoint-literal */
 						{
-#line 631 "src/libre/parser.act"
+#line 629 "src/libre/parser.act"
 
 		(ZIlower).type = AST_ENDPOINT_LITERAL;
 		(ZIlower).u.literal.c = (ZIc);
 	
-#line 1913 "src/libre/dialect/pcre/parser.c"
+#line 1911 "src/libre/dialect/pcre/parser.c"
 						}
 						/* END OF ACTION: ast-range-endpoint-literal */
 						/* BEGINNING OF EXTRACT: RANGE */
 						{
-#line 241 "src/libre/parser.act"
+#line 239 "src/libre/parser.act"
 
 		ZI180 = '-';
 		ZI181 = lex_state->lx.start;
 		ZI182   = lex_state->lx.end;
 	
-#line 1924 "src/libre/dialect/pcre/parser.c"
+#line 1922 "src/libre/dialect/pcre/parser.c"
 						}
 						/* END OF EXTRACT: RANGE */
 						ADVANCE_LEXER;
@@ -1931,7 +1929,7 @@ p_177(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__exp
 						}
 						/* BEGINNING OF ACTION: ast-make-range */
 						{
-#line 784 "src/libre/parser.act"
+#line 782 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 		unsigned char lower, upper;
@@ -1959,12 +1957,12 @@ p_177(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__exp
 			goto ZL1;
 		}
 
-		(ZInode1) = ast_make_expr_range(&(ZIlower), ast_start, &(ZIupper), ast_end);
+		(ZInode1) = ast_make_expr_range(act_state->arena, &(ZIlower), ast_start, &(ZIupper), ast_end);
 		if ((ZInode1) == NULL) {
 			goto ZL1;
 		}
 	
-#line 1968 "src/libre/dialect/pcre/parser.c"
+#line 1966 "src/libre/dialect/pcre/parser.c"
 						}
 						/* END OF ACTION: ast-make-range */
 					}
@@ -1974,13 +1972,13 @@ p_177(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__exp
 			/* END OF INLINE: 179 */
 			/* BEGINNING OF ACTION: ast-add-alt */
 			{
-#line 827 "src/libre/parser.act"
+#line 825 "src/libre/parser.act"
 
-		if (!ast_add_expr_alt((*ZItmp), (ZInode1))) {
+		if (!ast_add_expr_alt(act_state->arena, (*ZItmp), (ZInode1))) {
 			goto ZL1;
 		}
 	
-#line 1984 "src/libre/dialect/pcre/parser.c"
+#line 1982 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-add-alt */
 			p_198 (flags, lex_state, act_state, err, ZItmp);
@@ -2033,25 +2031,25 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 
 					/* BEGINNING OF EXTRACT: OPENGROUP */
 					{
-#line 247 "src/libre/parser.act"
+#line 245 "src/libre/parser.act"
 
 		ZIstart = lex_state->lx.start;
 		ZI163   = lex_state->lx.end;
 	
-#line 2042 "src/libre/dialect/pcre/parser.c"
+#line 2040 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: OPENGROUP */
 					ADVANCE_LEXER;
 					/* BEGINNING OF ACTION: ast-make-alt */
 					{
-#line 676 "src/libre/parser.act"
+#line 674 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_alt();
+		(ZInode) = ast_make_expr_alt(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2055 "src/libre/dialect/pcre/parser.c"
+#line 2053 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-make-alt */
 					ZItmp = ZInode;
@@ -2071,35 +2069,35 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 
 					/* BEGINNING OF EXTRACT: OPENGROUPCB */
 					{
-#line 257 "src/libre/parser.act"
+#line 255 "src/libre/parser.act"
 
 		ZIstart = lex_state->lx.start;
 		ZI184   = lex_state->lx.end;
 	
-#line 2080 "src/libre/dialect/pcre/parser.c"
+#line 2078 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: OPENGROUPCB */
 					ADVANCE_LEXER;
 					/* BEGINNING OF ACTION: ast-make-alt */
 					{
-#line 676 "src/libre/parser.act"
+#line 674 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_alt();
+		(ZInode) = ast_make_expr_alt(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2093 "src/libre/dialect/pcre/parser.c"
+#line 2091 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-make-alt */
 					ZItmp = ZInode;
 					/* BEGINNING OF ACTION: make-literal-cbrak */
 					{
-#line 690 "src/libre/parser.act"
+#line 688 "src/libre/parser.act"
 
 		(ZIcbrak) = ']';
 	
-#line 2103 "src/libre/dialect/pcre/parser.c"
+#line 2101 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: make-literal-cbrak */
 					p_194 (flags, lex_state, act_state, err, &ZIstart, &ZIcbrak, &ZInode1);
@@ -2109,13 +2107,13 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 					}
 					/* BEGINNING OF ACTION: ast-add-alt */
 					{
-#line 827 "src/libre/parser.act"
+#line 825 "src/libre/parser.act"
 
-		if (!ast_add_expr_alt((ZItmp), (ZInode1))) {
+		if (!ast_add_expr_alt(act_state->arena, (ZItmp), (ZInode1))) {
 			goto ZL1;
 		}
 	
-#line 2119 "src/libre/dialect/pcre/parser.c"
+#line 2117 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-add-alt */
 					p_198 (flags, lex_state, act_state, err, &ZItmp);
@@ -2131,31 +2129,31 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 
 					/* BEGINNING OF EXTRACT: OPENGROUPINV */
 					{
-#line 252 "src/libre/parser.act"
+#line 250 "src/libre/parser.act"
 
 		ZIstart = lex_state->lx.start;
 		ZI175   = lex_state->lx.end;
 	
-#line 2140 "src/libre/dialect/pcre/parser.c"
+#line 2138 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: OPENGROUPINV */
 					ADVANCE_LEXER;
 					/* BEGINNING OF ACTION: ast-make-alt */
 					{
-#line 676 "src/libre/parser.act"
+#line 674 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_alt();
+		(ZInode) = ast_make_expr_alt(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2153 "src/libre/dialect/pcre/parser.c"
+#line 2151 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-make-alt */
 					ZItmp = ZInode;
 					/* BEGINNING OF ACTION: ast-make-invert */
 					{
-#line 771 "src/libre/parser.act"
+#line 769 "src/libre/parser.act"
 
 		struct ast_expr *any;
 
@@ -2183,17 +2181,17 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 		 * a better idea.
 		 */
 
-		any = ast_make_expr_named(&class_any);
+		any = ast_make_expr_named(act_state->arena, &class_any);
 		if (any == NULL) {
 			goto ZL1;
 		}
 
-		(ZInode) = ast_make_expr_subtract(any, (ZInode));
+		(ZInode) = ast_make_expr_subtract(act_state->arena, any, (ZInode));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2197 "src/libre/dialect/pcre/parser.c"
+#line 2195 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-make-invert */
 					p_177 (flags, lex_state, act_state, err, &ZItmp);
@@ -2211,31 +2209,31 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 
 					/* BEGINNING OF EXTRACT: OPENGROUPINVCB */
 					{
-#line 262 "src/libre/parser.act"
+#line 260 "src/libre/parser.act"
 
 		ZIstart = lex_state->lx.start;
 		ZI192   = lex_state->lx.end;
 	
-#line 2220 "src/libre/dialect/pcre/parser.c"
+#line 2218 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: OPENGROUPINVCB */
 					ADVANCE_LEXER;
 					/* BEGINNING OF ACTION: ast-make-alt */
 					{
-#line 676 "src/libre/parser.act"
+#line 674 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_alt();
+		(ZInode) = ast_make_expr_alt(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2233 "src/libre/dialect/pcre/parser.c"
+#line 2231 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-make-alt */
 					ZItmp = ZInode;
 					/* BEGINNING OF ACTION: ast-make-invert */
 					{
-#line 771 "src/libre/parser.act"
+#line 769 "src/libre/parser.act"
 
 		struct ast_expr *any;
 
@@ -2263,26 +2261,26 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 		 * a better idea.
 		 */
 
-		any = ast_make_expr_named(&class_any);
+		any = ast_make_expr_named(act_state->arena, &class_any);
 		if (any == NULL) {
 			goto ZL1;
 		}
 
-		(ZInode) = ast_make_expr_subtract(any, (ZInode));
+		(ZInode) = ast_make_expr_subtract(act_state->arena, any, (ZInode));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2277 "src/libre/dialect/pcre/parser.c"
+#line 2275 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-make-invert */
 					/* BEGINNING OF ACTION: make-literal-cbrak */
 					{
-#line 690 "src/libre/parser.act"
+#line 688 "src/libre/parser.act"
 
 		(ZIcbrak) = ']';
 	
-#line 2286 "src/libre/dialect/pcre/parser.c"
+#line 2284 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: make-literal-cbrak */
 					p_194 (flags, lex_state, act_state, err, &ZIstart, &ZIcbrak, &ZInode1);
@@ -2292,13 +2290,13 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 					}
 					/* BEGINNING OF ACTION: ast-add-alt */
 					{
-#line 827 "src/libre/parser.act"
+#line 825 "src/libre/parser.act"
 
-		if (!ast_add_expr_alt((ZItmp), (ZInode1))) {
+		if (!ast_add_expr_alt(act_state->arena, (ZItmp), (ZInode1))) {
 			goto ZL1;
 		}
 	
-#line 2302 "src/libre/dialect/pcre/parser.c"
+#line 2300 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-add-alt */
 					p_198 (flags, lex_state, act_state, err, &ZItmp);
@@ -2323,13 +2321,13 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 				case (TOK_CLOSEGROUP):
 					/* BEGINNING OF EXTRACT: CLOSEGROUP */
 					{
-#line 267 "src/libre/parser.act"
+#line 265 "src/libre/parser.act"
 
 		ZI200 = ']';
 		ZI201 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 2333 "src/libre/dialect/pcre/parser.c"
+#line 2331 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: CLOSEGROUP */
 					break;
@@ -2339,12 +2337,12 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 				ADVANCE_LEXER;
 				/* BEGINNING OF ACTION: mark-group */
 				{
-#line 543 "src/libre/parser.act"
+#line 541 "src/libre/parser.act"
 
 		mark(&act_state->groupstart, &(ZIstart));
 		mark(&act_state->groupend,   &(ZIend));
 	
-#line 2348 "src/libre/dialect/pcre/parser.c"
+#line 2346 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF ACTION: mark-group */
 			}
@@ -2353,14 +2351,14 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 			{
 				/* BEGINNING OF ACTION: err-expected-closegroup */
 				{
-#line 504 "src/libre/parser.act"
+#line 502 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXCLOSEGROUP;
 		}
 		goto ZL1;
 	
-#line 2364 "src/libre/dialect/pcre/parser.c"
+#line 2362 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF ACTION: err-expected-closegroup */
 				ZIend = ZIstart;
@@ -2370,7 +2368,7 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 		/* END OF INLINE: 199 */
 		/* BEGINNING OF ACTION: mark-expr */
 		{
-#line 560 "src/libre/parser.act"
+#line 558 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 
@@ -2385,7 +2383,7 @@ p_expr_C_Ccharacter_Hclass(flags flags, lex_state lex_state, act_state act_state
 		(ZItmp)->u.class.end   = ast_end;
 */
 	
-#line 2389 "src/libre/dialect/pcre/parser.c"
+#line 2387 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: mark-expr */
 	}
@@ -2417,24 +2415,24 @@ p_expr_C_Ccharacter_Hclass_C_Crange_Hendpoint_Hend(flags flags, lex_state lex_st
 
 					/* BEGINNING OF EXTRACT: RANGE */
 					{
-#line 241 "src/libre/parser.act"
+#line 239 "src/libre/parser.act"
 
 		ZIc = '-';
 		ZI144 = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 2427 "src/libre/dialect/pcre/parser.c"
+#line 2425 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF EXTRACT: RANGE */
 					ADVANCE_LEXER;
 					/* BEGINNING OF ACTION: ast-range-endpoint-literal */
 					{
-#line 631 "src/libre/parser.act"
+#line 629 "src/libre/parser.act"
 
 		(ZIr).type = AST_ENDPOINT_LITERAL;
 		(ZIr).u.literal.c = (ZIc);
 	
-#line 2438 "src/libre/dialect/pcre/parser.c"
+#line 2436 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-range-endpoint-literal */
 				}
@@ -2496,30 +2494,30 @@ p_expr_C_Cpiece(flags flags, lex_state lex_state, act_state act_state, err err,
 
 					/* BEGINNING OF ACTION: count-one */
 					{
-#line 607 "src/libre/parser.act"
+#line 605 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(1, NULL, 1, NULL);
 	
-#line 2504 "src/libre/dialect/pcre/parser.c"
+#line 2502 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: count-one */
 					/* BEGINNING OF ACTION: ast-make-piece */
 					{
-#line 694 "src/libre/parser.act"
+#line 692 "src/libre/parser.act"
 
 		if ((ZIc).min == 0 && (ZIc).max == 0) {
-			(ZInode) = ast_make_expr_empty();
+			(ZInode) = ast_make_expr_empty(act_state->arena);
 		} else if ((ZIc).min == 1 && (ZIc).max == 1) {
 			(ZInode) = (ZIe);
 		} else {
-			(ZInode) = ast_make_expr_repeat((ZIe), (ZIc));
+			(ZInode) = ast_make_expr_repeat(act_state->arena, (ZIe), (ZIc));
 		}
 		if ((ZInode) == NULL) {
 			err->e = RE_EXEOF;
 			goto ZL1;
 		}
 	
-#line 2523 "src/libre/dialect/pcre/parser.c"
+#line 2521 "src/libre/dialect/pcre/parser.c"
 					}
 					/* END OF ACTION: ast-make-piece */
 				}
@@ -2550,14 +2548,14 @@ p_expr(flags flags, lex_state lex_state, act_state act_state, err err, t_ast__ex
 	{
 		/* BEGINNING OF ACTION: ast-make-alt */
 		{
-#line 676 "src/libre/parser.act"
+#line 674 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_alt();
+		(ZInode) = ast_make_expr_alt(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2561 "src/libre/dialect/pcre/parser.c"
+#line 2559 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-make-alt */
 		p_expr_C_Clist_Hof_Halts (flags, lex_state, act_state, err, ZInode);
@@ -2571,26 +2569,26 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-alts */
 		{
-#line 490 "src/libre/parser.act"
+#line 488 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXALTS;
 		}
 		goto ZL2;
 	
-#line 2582 "src/libre/dialect/pcre/parser.c"
+#line 2580 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: err-expected-alts */
 		/* BEGINNING OF ACTION: ast-make-empty */
 		{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_empty();
+		(ZInode) = ast_make_expr_empty(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL2;
 		}
 	
-#line 2594 "src/libre/dialect/pcre/parser.c"
+#line 2592 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-make-empty */
 	}
@@ -2612,14 +2610,14 @@ p_194(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZIs
 		{
 			/* BEGINNING OF ACTION: ast-make-literal */
 			{
-#line 683 "src/libre/parser.act"
+#line 681 "src/libre/parser.act"
 
-		(ZInode1) = ast_make_expr_literal((*ZIcbrak));
+		(ZInode1) = ast_make_expr_literal(act_state->arena, (*ZIcbrak));
 		if ((ZInode1) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2623 "src/libre/dialect/pcre/parser.c"
+#line 2621 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-literal */
 		}
@@ -2636,23 +2634,23 @@ p_194(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZIs
 
 			/* BEGINNING OF ACTION: ast-range-endpoint-literal */
 			{
-#line 631 "src/libre/parser.act"
+#line 629 "src/libre/parser.act"
 
 		(ZIr).type = AST_ENDPOINT_LITERAL;
 		(ZIr).u.literal.c = (*ZIcbrak);
 	
-#line 2645 "src/libre/dialect/pcre/parser.c"
+#line 2643 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-range-endpoint-literal */
 			/* BEGINNING OF EXTRACT: RANGE */
 			{
-#line 241 "src/libre/parser.act"
+#line 239 "src/libre/parser.act"
 
 		ZI195 = '-';
 		ZI196 = lex_state->lx.start;
 		ZI197   = lex_state->lx.end;
 	
-#line 2656 "src/libre/dialect/pcre/parser.c"
+#line 2654 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: RANGE */
 			ADVANCE_LEXER;
@@ -2663,17 +2661,17 @@ p_194(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZIs
 			}
 			/* BEGINNING OF ACTION: ast-range-endpoint-literal */
 			{
-#line 631 "src/libre/parser.act"
+#line 629 "src/libre/parser.act"
 
 		(ZIlower).type = AST_ENDPOINT_LITERAL;
 		(ZIlower).u.literal.c = (*ZIcbrak);
 	
-#line 2672 "src/libre/dialect/pcre/parser.c"
+#line 2670 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-range-endpoint-literal */
 			/* BEGINNING OF ACTION: ast-make-range */
 			{
-#line 784 "src/libre/parser.act"
+#line 782 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 		unsigned char lower, upper;
@@ -2701,12 +2699,12 @@ p_194(flags flags, lex_state lex_state, act_state act_state, err err, t_pos *ZIs
 			goto ZL1;
 		}
 
-		(ZInode1) = ast_make_expr_range(&(ZIlower), ast_start, &(ZIupper), ast_end);
+		(ZInode1) = ast_make_expr_range(act_state->arena, &(ZIlower), ast_start, &(ZIupper), ast_end);
 		if ((ZInode1) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2710 "src/libre/dialect/pcre/parser.c"
+#line 2708 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-range */
 		}
@@ -2745,13 +2743,13 @@ ZL2_198:;
 							}
 							/* BEGINNING OF ACTION: ast-add-alt */
 							{
-#line 827 "src/libre/parser.act"
+#line 825 "src/libre/parser.act"
 
-		if (!ast_add_expr_alt((*ZItmp), (ZInode))) {
+		if (!ast_add_expr_alt(act_state->arena, (*ZItmp), (ZInode))) {
 			goto ZL5;
 		}
 	
-#line 2755 "src/libre/dialect/pcre/parser.c"
+#line 2753 "src/libre/dialect/pcre/parser.c"
 							}
 							/* END OF ACTION: ast-add-alt */
 						}
@@ -2760,14 +2758,14 @@ ZL2_198:;
 						{
 							/* BEGINNING OF ACTION: err-expected-term */
 							{
-#line 469 "src/libre/parser.act"
+#line 467 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXTERM;
 		}
 		goto ZL1;
 	
-#line 2771 "src/libre/dialect/pcre/parser.c"
+#line 2769 "src/libre/dialect/pcre/parser.c"
 							}
 							/* END OF ACTION: err-expected-term */
 						}
@@ -2817,20 +2815,20 @@ p_expr_C_Cflags(flags flags, lex_state lex_state, act_state act_state, err err,
 		ADVANCE_LEXER;
 		/* BEGINNING OF ACTION: re-flag-none */
 		{
-#line 583 "src/libre/parser.act"
+#line 581 "src/libre/parser.act"
 
 		(ZIempty__pos) = RE_FLAGS_NONE;
 	
-#line 2825 "src/libre/dialect/pcre/parser.c"
+#line 2823 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: re-flag-none */
 		/* BEGINNING OF ACTION: re-flag-none */
 		{
-#line 583 "src/libre/parser.act"
+#line 581 "src/libre/parser.act"
 
 		(ZIempty__neg) = RE_FLAGS_NONE;
 	
-#line 2834 "src/libre/dialect/pcre/parser.c"
+#line 2832 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: re-flag-none */
 		/* BEGINNING OF INLINE: 214 */
@@ -2886,14 +2884,14 @@ p_expr_C_Cflags(flags flags, lex_state lex_state, act_state act_state, err err,
 				ADVANCE_LEXER;
 				/* BEGINNING OF ACTION: ast-make-re-flags */
 				{
-#line 715 "src/libre/parser.act"
+#line 713 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_re_flags((ZIpos), (ZIneg));
+		(ZInode) = ast_make_expr_re_flags(act_state->arena, (ZIpos), (ZIneg));
 		if ((ZInode) == NULL) {
 			goto ZL5;
 		}
 	
-#line 2897 "src/libre/dialect/pcre/parser.c"
+#line 2895 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF ACTION: ast-make-re-flags */
 			}
@@ -2902,26 +2900,26 @@ p_expr_C_Cflags(flags flags, lex_state lex_state, act_state act_state, err err,
 			{
 				/* BEGINNING OF ACTION: err-expected-closeflags */
 				{
-#line 525 "src/libre/parser.act"
+#line 523 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXCLOSEFLAGS;
 		}
 		goto ZL1;
 	
-#line 2913 "src/libre/dialect/pcre/parser.c"
+#line 2911 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF ACTION: err-expected-closeflags */
 				/* BEGINNING OF ACTION: ast-make-empty */
 				{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_empty();
+		(ZInode) = ast_make_expr_empty(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 2925 "src/libre/dialect/pcre/parser.c"
+#line 2923 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF ACTION: ast-make-empty */
 			}
@@ -2955,21 +2953,21 @@ p_expr_C_Cpiece_C_Clist_Hof_Hcounts(flags flags, lex_state lex_state, act_state
 		}
 		/* BEGINNING OF ACTION: ast-make-piece */
 		{
-#line 694 "src/libre/parser.act"
+#line 692 "src/libre/parser.act"
 
 		if ((ZIc).min == 0 && (ZIc).max == 0) {
-			(ZInode) = ast_make_expr_empty();
+			(ZInode) = ast_make_expr_empty(act_state->arena);
 		} else if ((ZIc).min == 1 && (ZIc).max == 1) {
 			(ZInode) = (ZIe);
 		} else {
-			(ZInode) = ast_make_expr_repeat((ZIe), (ZIc));
+			(ZInode) = ast_make_expr_repeat(act_state->arena, (ZIe), (ZIc));
 		}
 		if ((ZInode) == NULL) {
 			err->e = RE_EXEOF;
 			goto ZL1;
 		}
 	
-#line 2973 "src/libre/dialect/pcre/parser.c"
+#line 2971 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-make-piece */
 		/* BEGINNING OF INLINE: 242 */
@@ -3064,7 +3062,7 @@ p_class_Hnamed(flags flags, lex_state lex_state, act_state act_state, err err, t
 		case (TOK_NAMED__CLASS):
 			/* BEGINNING OF EXTRACT: NAMED_CLASS */
 			{
-#line 441 "src/libre/parser.act"
+#line 439 "src/libre/parser.act"
 
 		ZIid = DIALECT_CLASS(lex_state->buf.a);
 		if (ZIid == NULL) {
@@ -3075,7 +3073,7 @@ p_class_Hnamed(flags flags, lex_state lex_state, act_state act_state, err err, t
 		ZIstart = lex_state->lx.start;
 		ZIend   = lex_state->lx.end;
 	
-#line 3079 "src/libre/dialect/pcre/parser.c"
+#line 3077 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: NAMED_CLASS */
 			break;
@@ -3085,14 +3083,14 @@ p_class_Hnamed(flags flags, lex_state lex_state, act_state act_state, err err, t
 		ADVANCE_LEXER;
 		/* BEGINNING OF ACTION: ast-make-named */
 		{
-#line 814 "src/libre/parser.act"
+#line 812 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_named((ZIid));
+		(ZInode) = ast_make_expr_named(act_state->arena, (ZIid));
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 3096 "src/libre/dialect/pcre/parser.c"
+#line 3094 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-make-named */
 	}
@@ -3123,13 +3121,13 @@ ZL2_expr_C_Clist_Hof_Halts:;
 		}
 		/* BEGINNING OF ACTION: ast-add-alt */
 		{
-#line 827 "src/libre/parser.act"
+#line 825 "src/libre/parser.act"
 
-		if (!ast_add_expr_alt((ZIalts), (ZIa))) {
+		if (!ast_add_expr_alt(act_state->arena, (ZIalts), (ZIa))) {
 			goto ZL1;
 		}
 	
-#line 3133 "src/libre/dialect/pcre/parser.c"
+#line 3131 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-add-alt */
 		/* BEGINNING OF INLINE: 253 */
@@ -3154,14 +3152,14 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-alts */
 		{
-#line 490 "src/libre/parser.act"
+#line 488 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXALTS;
 		}
 		goto ZL4;
 	
-#line 3165 "src/libre/dialect/pcre/parser.c"
+#line 3163 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: err-expected-alts */
 	}
@@ -3186,12 +3184,12 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 
 			/* BEGINNING OF EXTRACT: OPENCOUNT */
 			{
-#line 273 "src/libre/parser.act"
+#line 271 "src/libre/parser.act"
 
 		ZI290 = lex_state->lx.start;
 		ZI291   = lex_state->lx.end;
 	
-#line 3195 "src/libre/dialect/pcre/parser.c"
+#line 3193 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: OPENCOUNT */
 			ADVANCE_LEXER;
@@ -3199,7 +3197,7 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 			case (TOK_COUNT):
 				/* BEGINNING OF EXTRACT: COUNT */
 				{
-#line 429 "src/libre/parser.act"
+#line 427 "src/libre/parser.act"
 
 		unsigned long u;
 		char *e;
@@ -3219,7 +3217,7 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 
 		ZIm = (unsigned int) u;
 	
-#line 3223 "src/libre/dialect/pcre/parser.c"
+#line 3221 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF EXTRACT: COUNT */
 				break;
@@ -3239,11 +3237,11 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: count-zero-or-one */
 			{
-#line 603 "src/libre/parser.act"
+#line 601 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(0, NULL, 1, NULL);
 	
-#line 3247 "src/libre/dialect/pcre/parser.c"
+#line 3245 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: count-zero-or-one */
 		}
@@ -3253,11 +3251,11 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: count-one-or-more */
 			{
-#line 599 "src/libre/parser.act"
+#line 597 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(1, NULL, AST_COUNT_UNBOUNDED, NULL);
 	
-#line 3261 "src/libre/dialect/pcre/parser.c"
+#line 3259 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: count-one-or-more */
 		}
@@ -3267,11 +3265,11 @@ p_expr_C_Cpiece_C_Ccount(flags flags, lex_state lex_state, act_state act_state,
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: count-zero-or-more */
 			{
-#line 595 "src/libre/parser.act"
+#line 593 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(0, NULL, AST_COUNT_UNBOUNDED, NULL);
 	
-#line 3275 "src/libre/dialect/pcre/parser.c"
+#line 3273 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: count-zero-or-more */
 		}
@@ -3286,23 +3284,23 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-count */
 		{
-#line 476 "src/libre/parser.act"
+#line 474 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXCOUNT;
 		}
 		goto ZL2;
 	
-#line 3297 "src/libre/dialect/pcre/parser.c"
+#line 3295 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: err-expected-count */
 		/* BEGINNING OF ACTION: count-one */
 		{
-#line 607 "src/libre/parser.act"
+#line 605 "src/libre/parser.act"
 
 		(ZIc) = ast_make_count(1, NULL, 1, NULL);
 	
-#line 3306 "src/libre/dialect/pcre/parser.c"
+#line 3304 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: count-one */
 	}
@@ -3350,14 +3348,14 @@ p_re__pcre(flags flags, lex_state lex_state, act_state act_state, err err, t_ast
 			{
 				/* BEGINNING OF ACTION: err-expected-eof */
 				{
-#line 532 "src/libre/parser.act"
+#line 530 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXEOF;
 		}
 		goto ZL1;
 	
-#line 3361 "src/libre/dialect/pcre/parser.c"
+#line 3359 "src/libre/dialect/pcre/parser.c"
 				}
 				/* END OF ACTION: err-expected-eof */
 			}
@@ -3386,24 +3384,24 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: class-any */
 			{
-#line 574 "src/libre/parser.act"
+#line 572 "src/libre/parser.act"
 
 		/* TODO: or the unicode equivalent */
 		(ZIa) = &class_any;
 	
-#line 3395 "src/libre/dialect/pcre/parser.c"
+#line 3393 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: class-any */
 			/* BEGINNING OF ACTION: ast-make-named */
 			{
-#line 814 "src/libre/parser.act"
+#line 812 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_named((ZIa));
+		(ZIe) = ast_make_expr_named(act_state->arena, (ZIa));
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 3407 "src/libre/dialect/pcre/parser.c"
+#line 3405 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-named */
 		}
@@ -3416,7 +3414,7 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 
 			/* BEGINNING OF EXTRACT: CONTROL */
 			{
-#line 320 "src/libre/parser.act"
+#line 318 "src/libre/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] == 'c');
@@ -3432,32 +3430,32 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 		ZI227 = lex_state->lx.start;
 		ZI228   = lex_state->lx.end;
 	
-#line 3436 "src/libre/dialect/pcre/parser.c"
+#line 3434 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF EXTRACT: CONTROL */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: err-unsupported */
 			{
-#line 539 "src/libre/parser.act"
+#line 537 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXUNSUPPORTD;
 		}
 		goto ZL1;
 	
-#line 3449 "src/libre/dialect/pcre/parser.c"
+#line 3447 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: err-unsupported */
 			/* BEGINNING OF ACTION: ast-make-empty */
 			{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_empty();
+		(ZIe) = ast_make_expr_empty(act_state->arena);
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 3461 "src/libre/dialect/pcre/parser.c"
+#line 3459 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-empty */
 		}
@@ -3467,14 +3465,14 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: ast-make-anchor-end */
 			{
-#line 729 "src/libre/parser.act"
+#line 727 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_anchor(AST_ANCHOR_END);
+		(ZIe) = ast_make_expr_anchor(act_state->arena, AST_ANCHOR_END);
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 3478 "src/libre/dialect/pcre/parser.c"
+#line 3476 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-anchor-end */
 		}
@@ -3491,14 +3489,14 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 			}
 			/* BEGINNING OF ACTION: ast-make-group */
 			{
-#line 708 "src/libre/parser.act"
+#line 706 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_group((ZIg));
+		(ZIe) = ast_make_expr_group(act_state->arena, (ZIg));
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 3502 "src/libre/dialect/pcre/parser.c"
+#line 3500 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-group */
 			switch (CURRENT_TERMINAL) {
@@ -3531,14 +3529,14 @@ p_expr_C_Cpiece_C_Catom(flags flags, lex_state lex_state, act_state act_state, e
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: ast-make-anchor-start */
 			{
-#line 722 "src/libre/parser.act"
+#line 720 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_anchor(AST_ANCHOR_START);
+		(ZIe) = ast_make_expr_anchor(act_state->arena, AST_ANCHOR_START);
 		if ((ZIe) == NULL) {
 			goto ZL1;
 		}
 	
-#line 3542 "src/libre/dialect/pcre/parser.c"
+#line 3540 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-anchor-start */
 		}
@@ -3590,26 +3588,26 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-atom */
 		{
-#line 483 "src/libre/parser.act"
+#line 481 "src/libre/parser.act"
 
 		if (err->e == RE_ESUCCESS) {
 			err->e = RE_EXATOM;
 		}
 		goto ZL2;
 	
-#line 3601 "src/libre/dialect/pcre/parser.c"
+#line 3599 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: err-expected-atom */
 		/* BEGINNING OF ACTION: ast-make-empty */
 		{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZIe) = ast_make_expr_empty();
+		(ZIe) = ast_make_expr_empty(act_state->arena);
 		if ((ZIe) == NULL) {
 			goto ZL2;
 		}
 	
-#line 3613 "src/libre/dialect/pcre/parser.c"
+#line 3611 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-make-empty */
 	}
@@ -3635,14 +3633,14 @@ p_expr_C_Calt(flags flags, lex_state lex_state, act_state act_state, err err, t_
 		{
 			/* BEGINNING OF ACTION: ast-make-concat */
 			{
-#line 669 "src/libre/parser.act"
+#line 667 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_concat();
+		(ZInode) = ast_make_expr_concat(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 3646 "src/libre/dialect/pcre/parser.c"
+#line 3644 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-concat */
 			p_expr_C_Clist_Hof_Hpieces (flags, lex_state, act_state, err, ZInode);
@@ -3656,14 +3654,14 @@ p_expr_C_Calt(flags flags, lex_state lex_state, act_state act_state, err err, t_
 		{
 			/* BEGINNING OF ACTION: ast-make-empty */
 			{
-#line 662 "src/libre/parser.act"
+#line 660 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_empty();
+		(ZInode) = ast_make_expr_empty(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 3667 "src/libre/dialect/pcre/parser.c"
+#line 3665 "src/libre/dialect/pcre/parser.c"
 			}
 			/* END OF ACTION: ast-make-empty */
 		}
@@ -3699,30 +3697,30 @@ p_expr_C_Ctype(flags flags, lex_state lex_state, act_state act_state, err err, t
 		}
 		/* BEGINNING OF ACTION: ast-make-alt */
 		{
-#line 676 "src/libre/parser.act"
+#line 674 "src/libre/parser.act"
 
-		(ZInode) = ast_make_expr_alt();
+		(ZInode) = ast_make_expr_alt(act_state->arena);
 		if ((ZInode) == NULL) {
 			goto ZL1;
 		}
 	
-#line 3710 "src/libre/dialect/pcre/parser.c"
+#line 3708 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-make-alt */
 		/* BEGINNING OF ACTION: ast-add-alt */
 		{
-#line 827 "src/libre/parser.act"
+#line 825 "src/libre/parser.act"
 
-		if (!ast_add_expr_alt((ZInode), (ZIclass))) {
+		if (!ast_add_expr_alt(act_state->arena, (ZInode), (ZIclass))) {
 			goto ZL1;
 		}
 	
-#line 3721 "src/libre/dialect/pcre/parser.c"
+#line 3719 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: ast-add-alt */
 		/* BEGINNING OF ACTION: mark-expr */
 		{
-#line 560 "src/libre/parser.act"
+#line 558 "src/libre/parser.act"
 
 		struct ast_pos ast_start, ast_end;
 
@@ -3737,7 +3735,7 @@ p_expr_C_Ctype(flags flags, lex_state lex_state, act_state act_state, err err, t
 		(ZInode)->u.class.end   = ast_end;
 */
 	
-#line 3741 "src/libre/dialect/pcre/parser.c"
+#line 3739 "src/libre/dialect/pcre/parser.c"
 		}
 		/* END OF ACTION: mark-expr */
 	}
@@ -3751,26 +3749,11 @@ ZL0:;
 
 /* BEGINNING OF TRAILER */
 
-#line 974 "src/libre/parser.act"
-
-
-	static int
-	lgetc(struct LX_STATE *lx)
-	{
-		struct lex_state *lex_state;
-
-		assert(lx != NULL);
-		assert(lx->getc_opaque != NULL);
+#line 959 "src/libre/parser.act"
 
-		lex_state = lx->getc_opaque;
-
-		assert(lex_state->f != NULL);
-
-		return lex_state->f(lex_state->opaque);
-	}
 
 	struct ast *
-	DIALECT_PARSE(re_getchar_fun *f, void *opaque,
+	DIALECT_PARSE(struct re_arena *arena, const char *s, size_t n,
 		const struct fsm_options *opt,
 		enum re_flags flags, int overlap,
 		struct re_err *err)
@@ -3788,14 +3771,19 @@ ZL0:;
 
 		top.flags = flags;
 
-		assert(f != NULL);
-
-		ast = ast_new();
+		assert(arena != NULL);
+		assert(s != NULL);
 
 		if (err == NULL) {
 			err = &dummy;
 		}
 
+		ast = ast_new(arena);
+		if (ast == NULL) {
+			err->e = RE_EERRNO;
+			return NULL;
+		}
+
 		lex_state    = &lex_state_s;
 		lex_state->p = lex_state->a;
 
@@ -3803,11 +3791,9 @@ ZL0:;
 
 		LX_INIT(lx);
 
-		lx->lgetc       = lgetc;
-		lx->getc_opaque = lex_state;
-
-		lex_state->f       = f;
-		lex_state->opaque  = opaque;
+		/* the lexer reads from the buffer directly, by lx->p */
+		lx->p = s;
+		lx->e = s + n;
 
 		lex_state->buf.a   = NULL;
 		lex_state->buf.len = 0;
@@ -3823,6 +3809,7 @@ ZL0:;
 		act_state = &act_state_s;
 
 		act_state->overlap = overlap;
+		act_state->arena   = arena;
 
 		err->e = RE_ESUCCESS;
 
@@ -3832,7 +3819,7 @@ ZL0:;
 		lx->free(lx->buf_opaque);
 
 		if (err->e != RE_ESUCCESS) {
-			/* TODO: free internals allocated during parsing (are there any?) */
+			/* nodes allocated during parsing are freed with the arena */
 			goto error;
 		}
 
@@ -3889,11 +3876,9 @@ ZL0:;
 			break;
 		}
 
-		ast_free(ast);
-
 		return NULL;
 	}
 
-#line 3898 "src/libre/dialect/pcre/parser.c"
+#line 3883 "src/libre/dialect/pcre/parser.c"
 
 /* END OF FILE */
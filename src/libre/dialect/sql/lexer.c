@@ -21,22 +21,20 @@ lx_getc(struct lx_sql_lx *lx)
 	int c;
 
 	assert(lx != NULL);
-	assert(lx->lgetc != NULL);
+	assert(lx->p != NULL);
 
-	if (lx->c != EOF) {
-		c = lx->c, lx->c = EOF;
-	} else {
-		c = lx->lgetc(lx);
-		if (c == EOF) {
+	if (lx->p == lx->e) {
 			return EOF;
-		}
 	}
 
+	c = (unsigned char) *lx->p++;
+
 	lx->end.byte++;
 	lx->end.col++;
 
 	if (c == '\n') {
 		lx->end.line++;
+		lx->end.saved_col = lx->end.col - 1;
 		lx->end.col = 1;
 	}
 
@@ -50,9 +48,10 @@ static void
 lx_sql_ungetc(struct lx_sql_lx *lx, int c)
 {
 	assert(lx != NULL);
-	assert(lx->c == EOF);
+	assert(lx->p != NULL);
+	assert((unsigned char) *(lx->p - 1) == c);
 
-	lx->c = c;
+	lx->p--;
 
 
 	lx->end.byte--;
@@ -60,7 +59,7 @@ lx_sql_ungetc(struct lx_sql_lx *lx, int c)
 
 	if (c == '\n') {
 		lx->end.line--;
-		lx->end.col = 0; /* XXX: lost information */
+		lx->end.col = lx->end.saved_col;
 	}
 }
 
@@ -163,13 +162,16 @@ z0(struct lx_sql_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "," */
+			lx_sql_ungetc(lx, c); return TOK_SEP;
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
-			case '}': state = S3; break;
+			case ',': state = S0; break;
 			case '0':
 			case '1':
 			case '2':
@@ -180,14 +182,11 @@ z0(struct lx_sql_lx *lx)
 			case '7':
 			case '8':
 			case '9': state = S2; break;
-			case ',': state = S1; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '}': state = S3; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "," */
-			lx_sql_ungetc(lx, c); return TOK_SEP;
-
 		case S2: /* e.g. "0" */
 			switch ((unsigned char) c) {
 			case '0':
@@ -218,11 +217,11 @@ z0(struct lx_sql_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_SEP;
+	case S0: return TOK_SEP;
 	case S2: return TOK_COUNT;
 	case S3: return TOK_CLOSECOUNT;
 	default: errno = EINVAL; return TOK_ERROR;
@@ -253,241 +252,241 @@ z1(struct lx_sql_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S17;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "[:U" */
 			switch ((unsigned char) c) {
-			case '-': state = S2; break;
-			case '[': state = S3; break;
-			case ']': state = S4; break;
-			case '^': state = S5; break;
-			default: state = S1; break;
+			case 'P': state = S1; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_sql_ungetc(lx, c); return TOK_CHAR;
-
-		case S2: /* e.g. "-" */
-			lx_sql_ungetc(lx, c); return TOK_RANGE;
-
-		case S3: /* e.g. "[" */
+		case S1: /* e.g. "[:UP" */
 			switch ((unsigned char) c) {
-			case ':': state = S6; break;
-			default:  lx_sql_ungetc(lx, c); return TOK_CHAR;
+			case 'P': state = S24; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S4: /* e.g. "]" */
-			lx_sql_ungetc(lx, c); return lx->z = z2, TOK_CLOSEGROUP;
-
-		case S5: /* e.g. "^" */
-			lx_sql_ungetc(lx, c); return TOK_INVERT;
-
-		case S6: /* e.g. "[:" */
+		case S2: /* e.g. "[:AL" */
 			switch ((unsigned char) c) {
-			case 'A': state = S7; break;
-			case 'D': state = S8; break;
-			case 'L': state = S9; break;
-			case 'S': state = S10; break;
-			case 'U': state = S11; break;
-			case 'W': state = S12; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'P': state = S3; break;
+			case 'N': state = S26; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S7: /* e.g. "[:A" */
+		case S3: /* e.g. "[:ALP" */
 			switch ((unsigned char) c) {
-			case 'L': state = S16; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'H': state = S19; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S8: /* e.g. "[:D" */
+		case S4: /* e.g. "[:ALNU" */
 			switch ((unsigned char) c) {
-			case 'I': state = S21; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'M': state = S11; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S9: /* e.g. "[:L" */
+		case S5: /* e.g. "[:ALPHA:" */
 			switch ((unsigned char) c) {
-			case 'O': state = S15; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ']': state = S15; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S10: /* e.g. "[:S" */
+		case S6: /* e.g. "[" */
 			switch ((unsigned char) c) {
-			case 'P': state = S31; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ':': state = S18; break;
+			default:  lx_sql_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S11: /* e.g. "[:U" */
+		case S7: /* e.g. "[:W" */
 			switch ((unsigned char) c) {
-			case 'P': state = S13; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'H': state = S8; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S12: /* e.g. "[:W" */
+		case S8: /* e.g. "[:WH" */
 			switch ((unsigned char) c) {
-			case 'H': state = S27; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'I': state = S9; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S13: /* e.g. "[:UP" */
+		case S9: /* e.g. "[:WHI" */
 			switch ((unsigned char) c) {
-			case 'P': state = S14; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'T': state = S10; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S14: /* e.g. "[:LOW" */
+		case S10: /* e.g. "[:WHIT" */
 			switch ((unsigned char) c) {
-			case 'E': state = S34; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'E': state = S21; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S15: /* e.g. "[:LO" */
+		case S11: /* e.g. "[:ALPHA" */
 			switch ((unsigned char) c) {
-			case 'W': state = S14; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case ':': state = S5; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S16: /* e.g. "[:AL" */
+		case S12: /* e.g. "-" */
+			lx_sql_ungetc(lx, c); return TOK_RANGE;
+
+		case S13: /* e.g. "]" */
+			lx_sql_ungetc(lx, c); return lx->z = z2, TOK_CLOSEGROUP;
+
+		case S14: /* e.g. "^" */
+			lx_sql_ungetc(lx, c); return TOK_INVERT;
+
+		case S15: /* e.g. "[:ALPHA:]" */
+			lx_sql_ungetc(lx, c); return TOK_NAMED__CLASS;
+
+		case S16: /* e.g. "a" */
+			lx_sql_ungetc(lx, c); return TOK_CHAR;
+
+		case S17: /* start */
 			switch ((unsigned char) c) {
-			case 'N': state = S17; break;
-			case 'P': state = S18; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case '[': state = S6; break;
+			case '-': state = S12; break;
+			case ']': state = S13; break;
+			case '^': state = S14; break;
+			default: state = S16; break;
 			}
 			break;
 
-		case S17: /* e.g. "[:ALN" */
+		case S18: /* e.g. "[:" */
 			switch ((unsigned char) c) {
-			case 'U': state = S19; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'U': state = S0; break;
+			case 'W': state = S7; break;
+			case 'D': state = S31; break;
+			case 'A': state = S32; break;
+			case 'L': state = S33; break;
+			case 'S': state = S34; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S18: /* e.g. "[:ALP" */
+		case S19: /* e.g. "[:ALPH" */
 			switch ((unsigned char) c) {
-			case 'H': state = S23; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'A': state = S11; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S19: /* e.g. "[:ALNU" */
+		case S20: /* e.g. "[:SPAC" */
 			switch ((unsigned char) c) {
-			case 'M': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'E': state = S11; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S20: /* e.g. "[:ALNUM" */
+		case S21: /* e.g. "[:WHITE" */
 			switch ((unsigned char) c) {
-			case ':': state = S25; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'S': state = S34; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S21: /* e.g. "[:DI" */
+		case S22: /* e.g. "[:DIGI" */
 			switch ((unsigned char) c) {
-			case 'G': state = S22; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'T': state = S11; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S22: /* e.g. "[:DIG" */
+		case S23: /* e.g. "[:SPA" */
 			switch ((unsigned char) c) {
-			case 'I': state = S24; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'C': state = S20; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S23: /* e.g. "[:ALPH" */
+		case S24: /* e.g. "[:LOW" */
 			switch ((unsigned char) c) {
-			case 'A': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'E': state = S25; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S24: /* e.g. "[:DIGI" */
+		case S25: /* e.g. "[:LOWE" */
 			switch ((unsigned char) c) {
-			case 'T': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'R': state = S11; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S25: /* e.g. "[:ALNUM:" */
+		case S26: /* e.g. "[:ALN" */
 			switch ((unsigned char) c) {
-			case ']': state = S26; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'U': state = S4; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S26: /* e.g. "[:ALNUM:]" */
-			lx_sql_ungetc(lx, c); return TOK_NAMED__CLASS;
-
-		case S27: /* e.g. "[:WH" */
+		case S27: /* e.g. "[:SP" */
 			switch ((unsigned char) c) {
-			case 'I': state = S28; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'A': state = S23; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S28: /* e.g. "[:WHI" */
+		case S28: /* e.g. "[:DI" */
 			switch ((unsigned char) c) {
-			case 'T': state = S29; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'G': state = S29; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S29: /* e.g. "[:WHIT" */
+		case S29: /* e.g. "[:DIG" */
 			switch ((unsigned char) c) {
-			case 'E': state = S30; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'I': state = S22; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S30: /* e.g. "[:WHITE" */
+		case S30: /* e.g. "[:LO" */
 			switch ((unsigned char) c) {
-			case 'S': state = S10; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'W': state = S24; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S31: /* e.g. "[:SP" */
+		case S31: /* e.g. "[:D" */
 			switch ((unsigned char) c) {
-			case 'A': state = S32; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'I': state = S28; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S32: /* e.g. "[:SPA" */
+		case S32: /* e.g. "[:A" */
 			switch ((unsigned char) c) {
-			case 'C': state = S33; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'L': state = S2; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S33: /* e.g. "[:SPAC" */
+		case S33: /* e.g. "[:L" */
 			switch ((unsigned char) c) {
-			case 'E': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'O': state = S30; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S34: /* e.g. "[:LOWE" */
+		case S34: /* e.g. "[:S" */
 			switch ((unsigned char) c) {
-			case 'R': state = S20; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'P': state = S27; break;
+			default:  lx->p = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
@@ -502,16 +501,16 @@ z1(struct lx_sql_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
-	case S2: return TOK_RANGE;
-	case S3: return TOK_CHAR;
-	case S4: return TOK_CLOSEGROUP;
-	case S5: return TOK_INVERT;
-	case S26: return TOK_NAMED__CLASS;
+	case S6: return TOK_CHAR;
+	case S12: return TOK_RANGE;
+	case S13: return TOK_CLOSEGROUP;
+	case S14: return TOK_INVERT;
+	case S15: return TOK_NAMED__CLASS;
+	case S16: return TOK_CHAR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -538,11 +537,14 @@ z2(struct lx_sql_lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "a" */
+			lx_sql_ungetc(lx, c); return TOK_CHAR;
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
 			case '%': state = S2; break;
 			case '(': state = S3; break;
@@ -554,13 +556,10 @@ z2(struct lx_sql_lx *lx)
 			case '_': state = S9; break;
 			case '{': state = S10; break;
 			case '|': state = S11; break;
-			default: state = S1; break;
+			default: state = S0; break;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_sql_ungetc(lx, c); return TOK_CHAR;
-
 		case S2: /* e.g. "%" */
 			lx_sql_ungetc(lx, c); return TOK_MANY;
 
@@ -602,11 +601,11 @@ z2(struct lx_sql_lx *lx)
 		}
 	}
 
-	lx->lgetc = NULL;
+	lx->p = NULL;
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
+	case S0: return TOK_CHAR;
 	case S2: return TOK_MANY;
 	case S3: return TOK_OPENSUB;
 	case S4: return TOK_CLOSESUB;
@@ -657,35 +656,70 @@ lx_sql_example(enum lx_sql_token (*z)(struct lx_sql_lx *), enum lx_sql_token t)
 
 	if (z == z0) {
 		switch (t) {
-		case TOK_SEP: return ",";
-		case TOK_COUNT: return "0";
-		case TOK_CLOSECOUNT: return "}";
+		case TOK_SEP: return "";
+		case TOK_COUNT: return "";
+		case TOK_CLOSECOUNT: return "";
+		case TOK_OPENCOUNT: return "";
+		case TOK_CHAR: return "";
+		case TOK_NAMED__CLASS: return "";
+		case TOK_RANGE: return "";
+		case TOK_INVERT: return "";
+		case TOK_CLOSEGROUP: return "";
+		case TOK_OPENGROUP: return "";
+		case TOK_ALT: return "";
+		case TOK_PLUS: return "";
+		case TOK_STAR: return "";
+		case TOK_OPT: return "";
+		case TOK_CLOSESUB: return "";
+		case TOK_OPENSUB: return "";
+		case TOK_MANY: return "";
+		case TOK_ANY: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z1) {
 		switch (t) {
-		case TOK_CHAR: return "a";
-		case TOK_NAMED__CLASS: return "[:ALNUM:]";
-		case TOK_RANGE: return "-";
-		case TOK_INVERT: return "^";
-		case TOK_CLOSEGROUP: return "]";
+		case TOK_SEP: return "";
+		case TOK_COUNT: return "";
+		case TOK_CLOSECOUNT: return "";
+		case TOK_OPENCOUNT: return "";
+		case TOK_CHAR: return "";
+		case TOK_NAMED__CLASS: return "";
+		case TOK_RANGE: return "";
+		case TOK_INVERT: return "";
+		case TOK_CLOSEGROUP: return "";
+		case TOK_OPENGROUP: return "";
+		case TOK_ALT: return "";
+		case TOK_PLUS: return "";
+		case TOK_STAR: return "";
+		case TOK_OPT: return "";
+		case TOK_CLOSESUB: return "";
+		case TOK_OPENSUB: return "";
+		case TOK_MANY: return "";
+		case TOK_ANY: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z2) {
 		switch (t) {
-		case TOK_OPENCOUNT: return "{";
-		case TOK_CHAR: return "a";
-		case TOK_OPENGROUP: return "[";
-		case TOK_ALT: return "|";
-		case TOK_PLUS: return "+";
-		case TOK_STAR: return "*";
-		case TOK_OPT: return "?";
-		case TOK_CLOSESUB: return ")";
-		case TOK_OPENSUB: return "(";
-		case TOK_MANY: return "%";
-		case TOK_ANY: return "_";
+		case TOK_SEP: return "";
+		case TOK_COUNT: return "";
+		case TOK_CLOSECOUNT: return "";
+		case TOK_OPENCOUNT: return "";
+		case TOK_CHAR: return "";
+		case TOK_NAMED__CLASS: return "";
+		case TOK_RANGE: return "";
+		case TOK_INVERT: return "";
+		case TOK_CLOSEGROUP: return "";
+		case TOK_OPENGROUP: return "";
+		case TOK_ALT: return "";
+		case TOK_PLUS: return "";
+		case TOK_STAR: return "";
+		case TOK_OPT: return "";
+		case TOK_CLOSESUB: return "";
+		case TOK_OPENSUB: return "";
+		case TOK_MANY: return "";
+		case TOK_ANY: return "";
 		default: goto error;
 		}
 	}
@@ -705,7 +739,6 @@ lx_sql_init(struct lx_sql_lx *lx)
 
 	*lx = lx_default;
 
-	lx->c = EOF;
 	lx->z = z2;
 
 	lx->end.byte = 0;
@@ -721,7 +754,7 @@ lx_sql_next(struct lx_sql_lx *lx)
 	assert(lx != NULL);
 	assert(lx->z != NULL);
 
-	if (lx->lgetc == NULL) {
+	if (lx->p == NULL) {
 		return TOK_EOF;
 	}
 
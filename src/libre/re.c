@@ -89,16 +89,64 @@ re_flags(const char *s, enum re_flags *f)
 	return 0;
 }
 
-struct ast *
-re_parse(enum re_dialect dialect, int (*getc)(void *opaque), void *opaque,
+/*
+ * The dialects' lexers read from a buffer, so a regexp given by callback
+ * is read whole first.
+ */
+static char *
+readall(int (*getc)(void *opaque), void *opaque, size_t *n)
+{
+	char *s, *tmp;
+	size_t len, sz;
+	int c;
+
+	assert(getc != NULL);
+	assert(n != NULL);
+
+	s   = NULL;
+	len = 0;
+	sz  = 0;
+
+	while (c = getc(opaque), c != EOF) {
+		if (len == sz) {
+			sz = sz == 0 ? 64 : sz * 2;
+
+			tmp = realloc(s, sz);
+			if (tmp == NULL) {
+				free(s);
+				return NULL;
+			}
+
+			s = tmp;
+		}
+
+		s[len++] = (char) c;
+	}
+
+	/* non-NULL for an empty regexp */
+	if (s == NULL) {
+		s = malloc(1);
+		if (s == NULL) {
+			return NULL;
+		}
+	}
+
+	*n = len;
+
+	return s;
+}
+
+static struct ast *
+re_parse_buf(struct re_arena *arena,
+	enum re_dialect dialect, const char *s, size_t n,
 	const struct fsm_options *opt,
 	enum re_flags flags, struct re_err *err, int *unsatisfiable)
 {
 	const struct dialect *m;
 	struct ast *ast = NULL;
 	enum ast_analysis_res res;
-	
-	assert(getc != NULL);
+
+	assert(s != NULL);
 
 	m = re_dialect(dialect);
 	if (m == NULL) {
@@ -108,7 +156,7 @@ re_parse(enum re_dialect dialect, int (*getc)(void *opaque), void *opaque,
 
 	flags |= m->flags;
 
-	ast = m->parse(getc, opaque, opt, flags, m->overlap, err);
+	ast = m->parse(arena, s, n, opt, flags, m->overlap, err);
 	if (ast == NULL) {
 		return NULL;
 	}
@@ -121,7 +169,6 @@ re_parse(enum re_dialect dialect, int (*getc)(void *opaque), void *opaque,
 	res = ast_analysis(ast);
 
 	if (res < 0) {
-		ast_free(ast);
 		if (err != NULL) { err->e = RE_EERRNO; }
 		return NULL;
 	}
@@ -133,8 +180,45 @@ re_parse(enum re_dialect dialect, int (*getc)(void *opaque), void *opaque,
 	return ast;
 }
 
+struct ast *
+re_parse(enum re_dialect dialect, int (*getc)(void *opaque), void *opaque,
+	const struct fsm_options *opt,
+	enum re_flags flags, struct re_err *err, int *unsatisfiable)
+{
+	struct re_arena *arena;
+	struct ast *ast;
+	char *s;
+	size_t n;
+
+	assert(getc != NULL);
+
+	s = readall(getc, opaque, &n);
+	if (s == NULL) {
+		if (err != NULL) { err->e = RE_EERRNO; }
+		return NULL;
+	}
+
+	/* the AST owns its arena, for ast_free() */
+	arena = re_arena_new();
+	if (arena == NULL) {
+		free(s);
+		if (err != NULL) { err->e = RE_EERRNO; }
+		return NULL;
+	}
+
+	ast = re_parse_buf(arena, dialect, s, n, opt, flags, err, unsatisfiable);
+	if (ast == NULL) {
+		re_arena_free(arena);
+	}
+
+	free(s);
+
+	return ast;
+}
+
 struct fsm *
-re_comp(enum re_dialect dialect, int (*getc)(void *opaque), void *opaque,
+re_comp_arena(struct re_arena *arena,
+	enum re_dialect dialect, const char *s, size_t n,
 	const struct fsm_options *opt,
 	enum re_flags flags, struct re_err *err)
 {
@@ -143,6 +227,9 @@ re_comp(enum re_dialect dialect, int (*getc)(void *opaque), void *opaque,
 	const struct dialect *m;
 	int unsatisfiable;
 
+	assert(arena != NULL);
+	assert(s != NULL);
+
 	m = re_dialect(dialect);
 	if (m == NULL) {
 		if (err != NULL) { err->e = RE_EBADDIALECT; }
@@ -151,23 +238,26 @@ re_comp(enum re_dialect dialect, int (*getc)(void *opaque), void *opaque,
 
 	flags |= m->flags;
 
-	ast = re_parse(dialect, getc, opaque, opt, flags, err, &unsatisfiable);
-	if (ast == NULL) { return NULL; }
+	ast = re_parse_buf(arena, dialect, s, n, opt, flags, err, &unsatisfiable);
+	if (ast == NULL) {
+		re_arena_clear(arena);
+		return NULL;
+	}
 
 	/*
-	 * If the RE is inherently unsatisfiable, then free the
+	 * If the RE is inherently unsatisfiable, then discard the
 	 * AST and replace it with an empty tombstone node.
 	 * This will compile to an FSM that matches nothing, so
 	 * that unioning it with other regexes will still work.
 	 */
 	if (unsatisfiable) {
-		ast_expr_free(ast->expr);
 		ast->expr = ast_expr_tombstone;
 	}
 
 	new = ast_compile(ast, flags, opt, err);
 
-	ast_free(ast);
+	/* the nodes are all freed at once, keeping the arena for reuse */
+	re_arena_clear(arena);
 
 	if (new == NULL) {
 		/* XXX: this can happen e.g. on malloc failure */
@@ -185,3 +275,48 @@ error:
 
 	return NULL;
 }
+
+struct fsm *
+re_comp_buf(enum re_dialect dialect, const char *s, size_t n,
+	const struct fsm_options *opt,
+	enum re_flags flags, struct re_err *err)
+{
+	struct re_arena *arena;
+	struct fsm *new;
+
+	arena = re_arena_new();
+	if (arena == NULL) {
+		if (err != NULL) { err->e = RE_EERRNO; }
+		return NULL;
+	}
+
+	new = re_comp_arena(arena, dialect, s, n, opt, flags, err);
+
+	re_arena_free(arena);
+
+	return new;
+}
+
+struct fsm *
+re_comp(enum re_dialect dialect, int (*getc)(void *opaque), void *opaque,
+	const struct fsm_options *opt,
+	enum re_flags flags, struct re_err *err)
+{
+	struct fsm *new;
+	char *s;
+	size_t n;
+
+	assert(getc != NULL);
+
+	s = readall(getc, opaque, &n);
+	if (s == NULL) {
+		if (err != NULL) { err->e = RE_EERRNO; }
+		return NULL;
+	}
+
+	new = re_comp_buf(dialect, s, n, opt, flags, err);
+
+	free(s);
+
+	return new;
+}
@@ -4,6 +4,7 @@
  * See LICENCE for the full copyright terms.
  */
 
+#include <pthread.h>
 #include <assert.h>
 #include <string.h>
 #include <stdlib.h>
@@ -22,6 +23,15 @@
 
 #include "ast.h"
 
+static unsigned mapping_id; /* for ast_addmapping */
+
+static struct {
+	pthread_mutex_t mtx;
+	struct mapping_set **bucket;
+	size_t nbuckets;
+	size_t n;
+} conflicts = { PTHREAD_MUTEX_INITIALIZER, NULL, 0, 0 };
+
 struct ast *
 ast_new(void)
 {
@@ -123,6 +133,7 @@ ast_addmapping(struct ast_zone *z, struct fsm *fsm,
 		m->token    = token;
 		m->to       = to;
 		m->conflict = NULL;
+		m->id       = mapping_id++;
 
 		m->next = z->ml;
 		z->ml   = m;
@@ -138,36 +149,135 @@ ast_addmapping(struct ast_zone *z, struct fsm *fsm,
 	return m;
 }
 
-/* TODO: merge with adt/set.c */
+static int
+cmp_mapping(const void *a, const void *b)
+{
+	const struct ast_mapping *ma = * (const struct ast_mapping * const *) a;
+	const struct ast_mapping *mb = * (const struct ast_mapping * const *) b;
+
+	return (ma->id > mb->id) - (ma->id < mb->id);
+}
+
+static unsigned long
+hash_mappings(struct ast_mapping **a, size_t n)
+{
+	unsigned long h;
+	size_t i;
+
+	h = 2166136261UL;
+
+	for (i = 0; i < n; i++) {
+		h ^= a[i]->id;
+		h *= 16777619UL;
+	}
+
+	return h;
+}
+
+static int
+rehash_conflicts(void)
+{
+	struct mapping_set **bucket;
+	struct mapping_set *s, *next;
+	size_t nbuckets;
+	size_t i;
+
+	nbuckets = conflicts.nbuckets == 0 ? 64 : conflicts.nbuckets * 2;
+
+	bucket = calloc(nbuckets, sizeof *bucket);
+	if (bucket == NULL) {
+		return 0;
+	}
+
+	for (i = 0; i < conflicts.nbuckets; i++) {
+		for (s = conflicts.bucket[i]; s != NULL; s = next) {
+			next = s->next;
+
+			s->next = bucket[s->hash & (nbuckets - 1)];
+			bucket[s->hash & (nbuckets - 1)] = s;
+		}
+	}
+
+	free(conflicts.bucket);
+
+	conflicts.bucket   = bucket;
+	conflicts.nbuckets = nbuckets;
+
+	return 1;
+}
+
+/*
+ * Each DFA state's set of conflicting mappings is found here, and many
+ * states share the same set. Interning means each distinct set is held
+ * (and later reported) once, at the cost of a hash per state.
+ */
 struct mapping_set *
-ast_addconflict(struct mapping_set **head, struct ast_mapping *m)
+ast_internconflict(struct ast_mapping **a, size_t n)
 {
-	struct mapping_set *new;
+	struct mapping_set *s;
+	unsigned long h;
+	size_t i, j;
 
-	assert(head != NULL);
-	assert(m != NULL);
+	assert(a != NULL);
+	assert(n > 0);
 
-	/* TODO: explain we find duplicate; return success */
-	{
-		struct mapping_set *s;
+	qsort(a, n, sizeof *a, cmp_mapping);
+
+	for (i = 1, j = 1; i < n; i++) {
+		if (a[i] != a[j - 1]) {
+			a[j++] = a[i];
+		}
+	}
+
+	n = j;
 
-		for (s = *head; s != NULL; s = s->next) {
-			if (s->m == m) {
-				return s;
+	h = hash_mappings(a, n);
+
+	pthread_mutex_lock(&conflicts.mtx);
+
+	if (conflicts.nbuckets > 0) {
+		for (s = conflicts.bucket[h & (conflicts.nbuckets - 1)]; s != NULL; s = s->next) {
+			if (s->hash == h && s->n == n && 0 == memcmp(s->a, a, n * sizeof *a)) {
+				goto done;
 			}
 		}
 	}
 
-	new = malloc(sizeof *new);
-	if (new == NULL) {
-		return NULL;
+	if (conflicts.n >= conflicts.nbuckets) {
+		if (!rehash_conflicts()) {
+			s = NULL;
+			goto done;
+		}
 	}
 
-	new->m    = m;
+	s = malloc(sizeof *s + n * sizeof *a);
+	if (s == NULL) {
+		goto done;
+	}
 
-	new->next = *head;
-	*head     = new;
+	s->a    = (void *) (s + 1);
+	s->n    = n;
+	s->hash = h;
 
-	return new;
+	memcpy(s->a, a, n * sizeof *a);
+
+	s->m.fsm      = NULL;
+	s->m.token    = a[0]->token;
+	s->m.to       = a[0]->to;
+	s->m.conflict = s;
+	s->m.id       = a[0]->id;
+	s->m.next     = NULL;
+
+	s->reported = 0;
+
+	s->next = conflicts.bucket[h & (conflicts.nbuckets - 1)];
+	conflicts.bucket[h & (conflicts.nbuckets - 1)] = s;
+	conflicts.n++;
+
+done:
+
+	pthread_mutex_unlock(&conflicts.mtx);
+
+	return s;
 }
 
@@ -16,6 +16,8 @@ struct ast_mapping {
 	struct ast_zone  *to;
 	struct mapping_set *conflict;
 
+	unsigned id; /* in order of creation */
+
 	struct ast_mapping *next;
 };
 
@@ -34,9 +36,20 @@ struct ast_token {
 	struct ast_token *next;
 };
 
+/*
+ * A set of mappings which accept together in some DFA state, and so
+ * conflict. Sets are interned, so that each distinct set is held once,
+ * and every DFA state with that set shares .m, which stands for the set.
+ */
 struct mapping_set {
-	struct ast_mapping *m;
-	struct mapping_set *next;
+	struct ast_mapping **a; /* ascending by id */
+	size_t n;
+	unsigned long hash;
+
+	struct ast_mapping m;
+	int reported;
+
+	struct mapping_set *next; /* hash chain */
 };
 
 struct ast {
@@ -59,8 +72,13 @@ struct ast_mapping *
 ast_addmapping(struct ast_zone *z, struct fsm *fsm,
 	struct ast_token *token, struct ast_zone *to);
 
+/*
+ * Find the set of the given mappings, creating it if it is new.
+ * The array is sorted in place, and may contain duplicates.
+ * Safe to call from multiple threads.
+ */
 struct mapping_set *
-ast_addconflict(struct mapping_set **head, struct ast_mapping *n);
+ast_internconflict(struct ast_mapping **a, size_t n);
 
 #endif
 
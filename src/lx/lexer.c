@@ -175,20 +175,20 @@ z0(struct lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "a" */
+			lx_ungetc(lx, c); return TOK_CHAR;
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
 			case '/': state = S2; break;
-			default: state = S1; break;
+			default: state = S0; break;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_ungetc(lx, c); return TOK_CHAR;
-
 		case S2: /* e.g. "\057" */
 			switch ((unsigned char) c) {
 			case 'A':
@@ -262,7 +262,7 @@ z0(struct lx *lx)
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
+	case S0: return TOK_CHAR;
 	case S2: return TOK_RE;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
@@ -289,33 +289,48 @@ z1(struct lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S7;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "\\x" */
 			switch ((unsigned char) c) {
-			case '\\': state = S3; break;
-			case '"': state = S2; break;
-			default: state = S1; break;
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
+			case 'A':
+			case 'B':
+			case 'C':
+			case 'D':
+			case 'E':
+			case 'F':
+			case 'a':
+			case 'b':
+			case 'c':
+			case 'd':
+			case 'e':
+			case 'f': state = S5; break;
+			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_ungetc(lx, c); return TOK_CHAR;
-
-		case S2: /* e.g. "\"" */
-			lx_ungetc(lx, c); return lx->z = z4, TOK_STR;
-
-		case S3: /* e.g. "\\" */
+		case S1: /* e.g. "\\" */
 			switch ((unsigned char) c) {
+			case 'x': state = S0; break;
 			case '"':
 			case '\\':
 			case 'f':
 			case 'n':
 			case 'r':
 			case 't':
-			case 'v': state = S4; break;
+			case 'v': state = S3; break;
 			case '0':
 			case '1':
 			case '2':
@@ -323,16 +338,18 @@ z1(struct lx *lx)
 			case '4':
 			case '5':
 			case '6':
-			case '7': state = S5; break;
-			case 'x': state = S6; break;
+			case '7': state = S4; break;
 			default:  lx_ungetc(lx, c); return TOK_CHAR;
 			}
 			break;
 
-		case S4: /* e.g. "\\f" */
+		case S2: /* e.g. "\"" */
+			lx_ungetc(lx, c); return lx->z = z4, TOK_STR;
+
+		case S3: /* e.g. "\\f" */
 			lx_ungetc(lx, c); return TOK_ESC;
 
-		case S5: /* e.g. "\\0" */
+		case S4: /* e.g. "\\0" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -346,7 +363,7 @@ z1(struct lx *lx)
 			}
 			break;
 
-		case S6: /* e.g. "\\x" */
+		case S5: /* e.g. "\\xa" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -369,36 +386,19 @@ z1(struct lx *lx)
 			case 'c':
 			case 'd':
 			case 'e':
-			case 'f': state = S7; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'f': break;
+			default:  lx_ungetc(lx, c); return TOK_HEX;
 			}
 			break;
 
-		case S7: /* e.g. "\\xa" */
+		case S6: /* e.g. "a" */
+			lx_ungetc(lx, c); return TOK_CHAR;
+
+		case S7: /* start */
 			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
-			case 'A':
-			case 'B':
-			case 'C':
-			case 'D':
-			case 'E':
-			case 'F':
-			case 'a':
-			case 'b':
-			case 'c':
-			case 'd':
-			case 'e':
-			case 'f': break;
-			default:  lx_ungetc(lx, c); return TOK_HEX;
+			case '\\': state = S1; break;
+			case '"': state = S2; break;
+			default: state = S6; break;
 			}
 			break;
 
@@ -419,10 +419,10 @@ z1(struct lx *lx)
 	case NONE: return TOK_EOF;
 	case S1: return TOK_CHAR;
 	case S2: return TOK_STR;
-	case S3: return TOK_CHAR;
-	case S4: return TOK_ESC;
-	case S5: return TOK_OCT;
-	case S7: return TOK_HEX;
+	case S3: return TOK_ESC;
+	case S4: return TOK_OCT;
+	case S5: return TOK_HEX;
+	case S6: return TOK_CHAR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -448,20 +448,20 @@ z2(struct lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "a" */
+			lx_ungetc(lx, c); return TOK_CHAR;
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
 			case '\'': state = S2; break;
-			default: state = S1; break;
+			default: state = S0; break;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_ungetc(lx, c); return TOK_CHAR;
-
 		case S2: /* e.g. "'" */
 			lx_ungetc(lx, c); return lx->z = z4, TOK_STR;
 
@@ -480,7 +480,7 @@ z2(struct lx *lx)
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_CHAR;
+	case S0: return TOK_CHAR;
 	case S2: return TOK_STR;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
@@ -507,20 +507,20 @@ z3(struct lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S1;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "a" */
+			lx_ungetc(lx, c); return lx->z(lx);
+
+		case S1: /* start */
 			switch ((unsigned char) c) {
 			case '\n': state = S2; break;
-			default: state = S1; break;
+			default: state = S0; break;
 			}
 			break;
 
-		case S1: /* e.g. "a" */
-			lx_ungetc(lx, c); return lx->z(lx);
-
 		case S2: /* e.g. "\n" */
 			lx_ungetc(lx, c); return lx->z = z4, lx->z(lx);
 
@@ -549,7 +549,7 @@ z3(struct lx *lx)
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_EOF;
+	case S0: return TOK_EOF;
 	case S2: return TOK_EOF;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
@@ -578,37 +578,12 @@ z4(struct lx *lx)
 
 	while (c = lx_getc(lx), c != EOF) {
 		if (state == NONE) {
-			state = S0;
+			state = S27;
 		}
 
 		switch (state) {
-		case S0: /* start */
+		case S0: /* e.g. "$" */
 			switch ((unsigned char) c) {
-			case '#': state = S4; break;
-			case '&': state = S6; break;
-			case '\'': state = S7; break;
-			case '(': state = S8; break;
-			case ')': state = S9; break;
-			case '*': state = S10; break;
-			case '+': state = S11; break;
-			case '-': state = S12; break;
-			case '.': state = S13; break;
-			case '/': state = S14; break;
-			case ';': state = S15; break;
-			case '\t':
-			case '\n':
-			case '\r':
-			case ' ': state = S1; break;
-			case '=': state = S16; break;
-			case '$': state = S5; break;
-			case '"': state = S3; break;
-			case '\\': state = S19; break;
-			case '^': state = S20; break;
-			case '|': state = S22; break;
-			case '}': state = S23; break;
-			case '~': state = S24; break;
-			case '!': state = S2; break;
-			case '?': state = S17; break;
 			case 'A':
 			case 'B':
 			case 'C':
@@ -661,13 +636,42 @@ z4(struct lx *lx)
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S18; break;
-			case '{': state = S21; break;
+			case 'z': state = S25; break;
 			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S1: /* e.g. "\t" */
+		case S1: /* e.g. "\\" */
+			lx_ungetc(lx, c); return TOK_DASH;
+
+		case S2: /* e.g. "!" */
+			lx_ungetc(lx, c); return TOK_BANG;
+
+		case S3: /* e.g. "\"" */
+			lx_ungetc(lx, c); return lx->z = z1, lx->z(lx);
+
+		case S4: /* e.g. "#" */
+			lx_ungetc(lx, c); return lx->z = z3, lx->z(lx);
+
+		case S5: /* e.g. "&" */
+			lx_ungetc(lx, c); return TOK_AND;
+
+		case S6: /* e.g. "'" */
+			lx_ungetc(lx, c); return lx->z = z2, lx->z(lx);
+
+		case S7: /* e.g. "(" */
+			lx_ungetc(lx, c); return TOK_LPAREN;
+
+		case S8: /* e.g. ")" */
+			lx_ungetc(lx, c); return TOK_RPAREN;
+
+		case S9: /* e.g. "*" */
+			lx_ungetc(lx, c); return TOK_STAR;
+
+		case S10: /* e.g. "+" */
+			lx_ungetc(lx, c); return TOK_CROSS;
+
+		case S11: /* e.g. "\t" */
 			switch ((unsigned char) c) {
 			case '\t':
 			case '\n':
@@ -677,17 +681,37 @@ z4(struct lx *lx)
 			}
 			break;
 
-		case S2: /* e.g. "!" */
-			lx_ungetc(lx, c); return TOK_BANG;
+		case S12: /* e.g. "." */
+			switch ((unsigned char) c) {
+			case '.': state = S23; break;
+			default:  lx_ungetc(lx, c); return TOK_DOT;
+			}
+			break;
 
-		case S3: /* e.g. "\"" */
-			lx_ungetc(lx, c); return lx->z = z1, lx->z(lx);
+		case S13: /* e.g. "\057" */
+			lx_ungetc(lx, c); return lx->z = z0, lx->z(lx);
 
-		case S4: /* e.g. "#" */
-			lx_ungetc(lx, c); return lx->z = z3, lx->z(lx);
+		case S14: /* e.g. ";" */
+			lx_ungetc(lx, c); return TOK_SEMI;
+
+		case S15: /* e.g. "=" */
+			lx_ungetc(lx, c); return TOK_BIND;
+
+		case S16: /* e.g. "?" */
+			lx_ungetc(lx, c); return TOK_QMARK;
 
-		case S5: /* e.g. "$" */
+		case S17: /* e.g. "a" */
 			switch ((unsigned char) c) {
+			case '0':
+			case '1':
+			case '2':
+			case '3':
+			case '4':
+			case '5':
+			case '6':
+			case '7':
+			case '8':
+			case '9':
 			case 'A':
 			case 'B':
 			case 'C':
@@ -740,56 +764,33 @@ z4(struct lx *lx)
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': state = S25; break;
-			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
+			case 'z': break;
+			default:  lx_ungetc(lx, c); return TOK_IDENT;
 			}
 			break;
 
-		case S6: /* e.g. "&" */
-			lx_ungetc(lx, c); return TOK_AND;
-
-		case S7: /* e.g. "'" */
-			lx_ungetc(lx, c); return lx->z = z2, lx->z(lx);
-
-		case S8: /* e.g. "(" */
-			lx_ungetc(lx, c); return TOK_LPAREN;
-
-		case S9: /* e.g. ")" */
-			lx_ungetc(lx, c); return TOK_RPAREN;
-
-		case S10: /* e.g. "*" */
-			lx_ungetc(lx, c); return TOK_STAR;
-
-		case S11: /* e.g. "+" */
-			lx_ungetc(lx, c); return TOK_CROSS;
+		case S18: /* e.g. "^" */
+			lx_ungetc(lx, c); return TOK_HAT;
 
-		case S12: /* e.g. "-" */
-			switch ((unsigned char) c) {
-			case '>': state = S27; break;
-			default:  lx_ungetc(lx, c); return TOK_DASH;
-			}
-			break;
+		case S19: /* e.g. "{" */
+			lx_ungetc(lx, c); return TOK_OPEN;
 
-		case S13: /* e.g. "." */
-			switch ((unsigned char) c) {
-			case '.': state = S26; break;
-			default:  lx_ungetc(lx, c); return TOK_DOT;
-			}
-			break;
+		case S20: /* e.g. "|" */
+			lx_ungetc(lx, c); return TOK_PIPE;
 
-		case S14: /* e.g. "\057" */
-			lx_ungetc(lx, c); return lx->z = z0, lx->z(lx);
+		case S21: /* e.g. "}" */
+			lx_ungetc(lx, c); return TOK_CLOSE;
 
-		case S15: /* e.g. ";" */
-			lx_ungetc(lx, c); return TOK_SEMI;
+		case S22: /* e.g. "~" */
+			lx_ungetc(lx, c); return TOK_TILDE;
 
-		case S16: /* e.g. "=" */
-			lx_ungetc(lx, c); return TOK_BIND;
+		case S23: /* e.g. ".." */
+			lx_ungetc(lx, c); return TOK_TO;
 
-		case S17: /* e.g. "?" */
-			lx_ungetc(lx, c); return TOK_QMARK;
+		case S24: /* e.g. "->" */
+			lx_ungetc(lx, c); return TOK_MAP;
 
-		case S18: /* e.g. "a" */
+		case S25: /* e.g. "$a" */
 			switch ((unsigned char) c) {
 			case '0':
 			case '1':
@@ -854,40 +855,39 @@ z4(struct lx *lx)
 			case 'x':
 			case 'y':
 			case 'z': break;
-			default:  lx_ungetc(lx, c); return TOK_IDENT;
+			default:  lx_ungetc(lx, c); return TOK_TOKEN;
 			}
 			break;
 
-		case S19: /* e.g. "\\" */
-			lx_ungetc(lx, c); return TOK_DASH;
-
-		case S20: /* e.g. "^" */
-			lx_ungetc(lx, c); return TOK_HAT;
-
-		case S21: /* e.g. "{" */
-			lx_ungetc(lx, c); return TOK_OPEN;
-
-		case S22: /* e.g. "|" */
-			lx_ungetc(lx, c); return TOK_PIPE;
-
-		case S23: /* e.g. "}" */
-			lx_ungetc(lx, c); return TOK_CLOSE;
-
-		case S24: /* e.g. "~" */
-			lx_ungetc(lx, c); return TOK_TILDE;
+		case S26: /* e.g. "-" */
+			switch ((unsigned char) c) {
+			case '>': state = S24; break;
+			default:  lx_ungetc(lx, c); return TOK_DASH;
+			}
+			break;
 
-		case S25: /* e.g. "$a" */
+		case S27: /* start */
 			switch ((unsigned char) c) {
-			case '0':
-			case '1':
-			case '2':
-			case '3':
-			case '4':
-			case '5':
-			case '6':
-			case '7':
-			case '8':
-			case '9':
+			case '$': state = S0; break;
+			case '\\': state = S1; break;
+			case '!': state = S2; break;
+			case '"': state = S3; break;
+			case '#': state = S4; break;
+			case '&': state = S5; break;
+			case '\'': state = S6; break;
+			case '(': state = S7; break;
+			case ')': state = S8; break;
+			case '*': state = S9; break;
+			case '+': state = S10; break;
+			case '\t':
+			case '\n':
+			case '\r':
+			case ' ': state = S11; break;
+			case '.': state = S12; break;
+			case '/': state = S13; break;
+			case ';': state = S14; break;
+			case '=': state = S15; break;
+			case '?': state = S16; break;
 			case 'A':
 			case 'B':
 			case 'C':
@@ -940,27 +940,27 @@ z4(struct lx *lx)
 			case 'w':
 			case 'x':
 			case 'y':
-			case 'z': break;
-			default:  lx_ungetc(lx, c); return TOK_TOKEN;
+			case 'z': state = S17; break;
+			case '^': state = S18; break;
+			case '{': state = S19; break;
+			case '|': state = S20; break;
+			case '}': state = S21; break;
+			case '~': state = S22; break;
+			case '-': state = S26; break;
+			default:  lx->lgetc = NULL; return TOK_UNKNOWN;
 			}
 			break;
 
-		case S26: /* e.g. ".." */
-			lx_ungetc(lx, c); return TOK_TO;
-
-		case S27: /* e.g. "->" */
-			lx_ungetc(lx, c); return TOK_MAP;
-
 		default:
 			; /* unreached */
 		}
 
 		switch (state) {
-		case S1:
 		case S3:
 		case S4:
-		case S7:
-		case S14:
+		case S6:
+		case S11:
+		case S13:
 			break;
 
 		default:
@@ -978,32 +978,32 @@ z4(struct lx *lx)
 
 	switch (state) {
 	case NONE: return TOK_EOF;
-	case S1: return TOK_EOF;
+	case S1: return TOK_DASH;
 	case S2: return TOK_BANG;
 	case S3: return TOK_EOF;
 	case S4: return TOK_EOF;
-	case S6: return TOK_AND;
-	case S7: return TOK_EOF;
-	case S8: return TOK_LPAREN;
-	case S9: return TOK_RPAREN;
-	case S10: return TOK_STAR;
-	case S11: return TOK_CROSS;
-	case S12: return TOK_DASH;
-	case S13: return TOK_DOT;
-	case S14: return TOK_EOF;
-	case S15: return TOK_SEMI;
-	case S16: return TOK_BIND;
-	case S17: return TOK_QMARK;
-	case S18: return TOK_IDENT;
-	case S19: return TOK_DASH;
-	case S20: return TOK_HAT;
-	case S21: return TOK_OPEN;
-	case S22: return TOK_PIPE;
-	case S23: return TOK_CLOSE;
-	case S24: return TOK_TILDE;
+	case S5: return TOK_AND;
+	case S6: return TOK_EOF;
+	case S7: return TOK_LPAREN;
+	case S8: return TOK_RPAREN;
+	case S9: return TOK_STAR;
+	case S10: return TOK_CROSS;
+	case S11: return TOK_EOF;
+	case S12: return TOK_DOT;
+	case S13: return TOK_EOF;
+	case S14: return TOK_SEMI;
+	case S15: return TOK_BIND;
+	case S16: return TOK_QMARK;
+	case S17: return TOK_IDENT;
+	case S18: return TOK_HAT;
+	case S19: return TOK_OPEN;
+	case S20: return TOK_PIPE;
+	case S21: return TOK_CLOSE;
+	case S22: return TOK_TILDE;
+	case S23: return TOK_TO;
+	case S24: return TOK_MAP;
 	case S25: return TOK_TOKEN;
-	case S26: return TOK_TO;
-	case S27: return TOK_MAP;
+	case S26: return TOK_DASH;
 	default: errno = EINVAL; return TOK_ERROR;
 	}
 }
@@ -1052,55 +1052,156 @@ lx_example(enum lx_token (*z)(struct lx *), enum lx_token t)
 
 	if (z == z0) {
 		switch (t) {
-		case TOK_RE: return "\057";
-		case TOK_CHAR: return "a";
+		case TOK_TOKEN: return "";
+		case TOK_IDENT: return "";
+		case TOK_AND: return "";
+		case TOK_PIPE: return "";
+		case TOK_DOT: return "";
+		case TOK_DASH: return "";
+		case TOK_HAT: return "";
+		case TOK_BANG: return "";
+		case TOK_TILDE: return "";
+		case TOK_QMARK: return "";
+		case TOK_CROSS: return "";
+		case TOK_STAR: return "";
+		case TOK_RPAREN: return "";
+		case TOK_LPAREN: return "";
+		case TOK_CLOSE: return "";
+		case TOK_OPEN: return "";
+		case TOK_MAP: return "";
+		case TOK_TO: return "";
+		case TOK_SEMI: return "";
+		case TOK_BIND: return "";
+		case TOK_RE: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_CHAR: return "";
+		case TOK_STR: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z1) {
 		switch (t) {
-		case TOK_HEX: return "\\xa";
-		case TOK_OCT: return "\\0";
-		case TOK_ESC: return "\\f";
-		case TOK_CHAR: return "a";
-		case TOK_STR: return "\"";
+		case TOK_TOKEN: return "";
+		case TOK_IDENT: return "";
+		case TOK_AND: return "";
+		case TOK_PIPE: return "";
+		case TOK_DOT: return "";
+		case TOK_DASH: return "";
+		case TOK_HAT: return "";
+		case TOK_BANG: return "";
+		case TOK_TILDE: return "";
+		case TOK_QMARK: return "";
+		case TOK_CROSS: return "";
+		case TOK_STAR: return "";
+		case TOK_RPAREN: return "";
+		case TOK_LPAREN: return "";
+		case TOK_CLOSE: return "";
+		case TOK_OPEN: return "";
+		case TOK_MAP: return "";
+		case TOK_TO: return "";
+		case TOK_SEMI: return "";
+		case TOK_BIND: return "";
+		case TOK_RE: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_CHAR: return "";
+		case TOK_STR: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z2) {
 		switch (t) {
-		case TOK_CHAR: return "a";
-		case TOK_STR: return "'";
+		case TOK_TOKEN: return "";
+		case TOK_IDENT: return "";
+		case TOK_AND: return "";
+		case TOK_PIPE: return "";
+		case TOK_DOT: return "";
+		case TOK_DASH: return "";
+		case TOK_HAT: return "";
+		case TOK_BANG: return "";
+		case TOK_TILDE: return "";
+		case TOK_QMARK: return "";
+		case TOK_CROSS: return "";
+		case TOK_STAR: return "";
+		case TOK_RPAREN: return "";
+		case TOK_LPAREN: return "";
+		case TOK_CLOSE: return "";
+		case TOK_OPEN: return "";
+		case TOK_MAP: return "";
+		case TOK_TO: return "";
+		case TOK_SEMI: return "";
+		case TOK_BIND: return "";
+		case TOK_RE: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_CHAR: return "";
+		case TOK_STR: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z3) {
 		switch (t) {
+		case TOK_TOKEN: return "";
+		case TOK_IDENT: return "";
+		case TOK_AND: return "";
+		case TOK_PIPE: return "";
+		case TOK_DOT: return "";
+		case TOK_DASH: return "";
+		case TOK_HAT: return "";
+		case TOK_BANG: return "";
+		case TOK_TILDE: return "";
+		case TOK_QMARK: return "";
+		case TOK_CROSS: return "";
+		case TOK_STAR: return "";
+		case TOK_RPAREN: return "";
+		case TOK_LPAREN: return "";
+		case TOK_CLOSE: return "";
+		case TOK_OPEN: return "";
+		case TOK_MAP: return "";
+		case TOK_TO: return "";
+		case TOK_SEMI: return "";
+		case TOK_BIND: return "";
+		case TOK_RE: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_CHAR: return "";
+		case TOK_STR: return "";
 		default: goto error;
 		}
 	} else
 	if (z == z4) {
 		switch (t) {
-		case TOK_TOKEN: return "$a";
-		case TOK_IDENT: return "a";
-		case TOK_AND: return "&";
-		case TOK_PIPE: return "|";
-		case TOK_DOT: return ".";
-		case TOK_DASH: return "-";
-		case TOK_HAT: return "^";
-		case TOK_BANG: return "!";
-		case TOK_TILDE: return "~";
-		case TOK_QMARK: return "?";
-		case TOK_CROSS: return "+";
-		case TOK_STAR: return "*";
-		case TOK_RPAREN: return ")";
-		case TOK_LPAREN: return "(";
-		case TOK_CLOSE: return "}";
-		case TOK_OPEN: return "{";
-		case TOK_MAP: return "->";
-		case TOK_TO: return "..";
-		case TOK_SEMI: return ";";
-		case TOK_BIND: return "=";
+		case TOK_TOKEN: return "";
+		case TOK_IDENT: return "";
+		case TOK_AND: return "";
+		case TOK_PIPE: return "";
+		case TOK_DOT: return "";
+		case TOK_DASH: return "";
+		case TOK_HAT: return "";
+		case TOK_BANG: return "";
+		case TOK_TILDE: return "";
+		case TOK_QMARK: return "";
+		case TOK_CROSS: return "";
+		case TOK_STAR: return "";
+		case TOK_RPAREN: return "";
+		case TOK_LPAREN: return "";
+		case TOK_CLOSE: return "";
+		case TOK_OPEN: return "";
+		case TOK_MAP: return "";
+		case TOK_TO: return "";
+		case TOK_SEMI: return "";
+		case TOK_BIND: return "";
+		case TOK_RE: return "";
+		case TOK_HEX: return "";
+		case TOK_OCT: return "";
+		case TOK_ESC: return "";
+		case TOK_CHAR: return "";
+		case TOK_STR: return "";
 		default: goto error;
 		}
 	}
@@ -26,9 +26,12 @@
 
 #include "parser.h"
 
+#include <adt/edgeset.h>
+
 #include "libfsm/internal.h" /* XXX */
 
 #include "print.h"
+#include "pool.h"
 #include "ast.h"
 #include "tokens.h"
 
@@ -45,17 +48,16 @@ struct prefix prefix = {
 struct fsm_options opt;
 
 int print_progress;
+int combine_zones;
 int keep_nfa;
 
-struct ast_zone *cur_zone = NULL;
 unsigned zn = 0;
-int zerror = 0;
-pthread_mutex_t zmtx = PTHREAD_MUTEX_INITIALIZER;
+pthread_mutex_t zmtx = PTHREAD_MUTEX_INITIALIZER; /* for zn */
 
 static
 void usage(void)
 {
-	printf("usage: lx [-nQX] [-C <concurrency>] [-b <tokbuf>] [-g <getc>] [-l <language>] [-et <prefix>] [-k <io>] [-x <exclude>]\n");
+	printf("usage: lx [-nQTXz] [-C <concurrency>] [-b <tokbuf>] [-g <getc>] [-l <language>] [-et <prefix>] [-k <io>] [-x <exclude>]\n");
 	printf("       lx -h\n");
 }
 
@@ -80,6 +82,44 @@ important(unsigned int n)
 	}
 }
 
+unsigned int
+zindexof(const struct ast *ast, const struct ast_zone *zone)
+{
+	struct ast_zone *z;
+	unsigned int i;
+
+	assert(ast != NULL);
+	assert(zone != NULL);
+
+	for (z = ast->zl, i = 0; z != NULL; z = z->next, i++) {
+		if (z == zone) {
+			return i;
+		}
+	}
+
+	assert(!"unreached");
+	return 0;
+}
+
+unsigned int
+tokindexof(const struct ast *ast, const struct ast_token *token)
+{
+	struct ast_token *t;
+	unsigned int i;
+
+	assert(ast != NULL);
+	assert(token != NULL);
+
+	for (t = ast->tl, i = 0; t != NULL; t = t->next, i++) {
+		if (t == token) {
+			return i;
+		}
+	}
+
+	assert(!"unreached");
+	return 0;
+}
+
 static enum fsm_io
 io(const char *name)
 {
@@ -127,7 +167,8 @@ print_name(const char *name)
 		{ "dump", lx_print_dump },
 		{ "zdot", lx_print_zdot },
 		{ "c",    lx_print_c    },
-		{ "h",    lx_print_h    }
+		{ "h",    lx_print_h    },
+		{ "vm",   lx_print_vm   }
 	};
 
 	assert(name != NULL);
@@ -159,7 +200,8 @@ lang_tokbuf(const char *name)
 		enum api_tokbuf tokbuf;
 	} a[] = {
 		{ "dyn",   API_DYNBUF   },
-		{ "fixed", API_FIXEDBUF }
+		{ "fixed", API_FIXEDBUF },
+		{ "span",  API_SPANBUF  }
 	};
 
 	assert(name != NULL);
@@ -254,9 +296,9 @@ static void
 carryopaque(struct fsm *src_fsm, const fsm_state_t *src_set, size_t n,
 	struct fsm *dst_fsm, fsm_state_t dst_state)
 {
-	struct mapping_set *conflict;
 	struct ast_mapping *m;
-	size_t i;
+	size_t i, k;
+	int conflict;
 
 	assert(src_fsm != NULL);
 	assert(src_set != NULL);
@@ -287,7 +329,8 @@ carryopaque(struct fsm *src_fsm, const fsm_state_t *src_set, size_t n,
 
 	assert(m != NULL);
 
-	conflict = NULL;
+	k = 0;
+	conflict = 0;
 
 	for (i = 0; i < n; i++) {
 		struct ast_mapping *p;
@@ -304,65 +347,66 @@ carryopaque(struct fsm *src_fsm, const fsm_state_t *src_set, size_t n,
 
 		p = fsm_getopaque(src_fsm, src_set[i]);
 
-		if (m->to == p->to && m->token == p->token) {
-			continue;
-		}
+		k++;
 
-		if (!ast_addconflict(&conflict, p)) {
-			perror("ast_addconflict");
-			goto error;
-		}
-	}
-
-	/* if anything conflicts with m, then m is part of the conflicting set */
-	if (conflict != NULL) {
-		if (!ast_addconflict(&conflict, m)) {
-			perror("ast_addconflict");
-			goto error;
+		if (m->to != p->to || m->token != p->token) {
+			conflict = 1;
 		}
 	}
 
 	/*
-	 * An ast_mapping is allocated in order to potentially hold
-	 * conflicting mappings, if any are found.
+	 * If there isn't a conflict, the DFA state points to an existing
+	 * mapping. It doesn't matter which one.
 	 *
-	 * We can't point to an existing ast_mapping in this case,
-	 * because a conflict set may not be the same in all DFA states
-	 * where the same .to/.token are used.
+	 * Otherwise the DFA state points to the mapping which stands for
+	 * its set of conflicting mappings. We can't point to an existing
+	 * ast_mapping in this case, because a conflict set may not be the same
+	 * in all DFA states where the same .to/.token are used.
 	 * This is the case for /aa(aa)+/ -> $x; /aaa(aaa)+/ -> $y;
 	 * where $y appears in both a conflicting and non-conflicting DFA state.
-	 *
-	 * If there isn't a conflict, the DFA state point to an existing
-	 * mapping. It doesn't matter which one.
+	 * Sets are interned, so DFA states with the same set share its mapping.
 	 */
-	if (conflict == NULL) {
+	if (!conflict) {
 		assert(m->conflict == NULL);
 
 		fsm_setopaque(dst_fsm, dst_state, m);
 	} else {
-		struct ast_mapping *new;
+		struct ast_mapping *a[16], **v;
+		struct mapping_set *set;
+
+		if (k <= sizeof a / sizeof *a) {
+			v = a;
+		} else {
+			v = malloc(k * sizeof *v);
+			if (v == NULL) {
+				goto error;
+			}
+		}
 
-		new = malloc(sizeof *new);
-		if (new == NULL) {
-			goto error;
+		for (i = 0, k = 0; i < n; i++) {
+			if (fsm_isend(src_fsm, src_set[i])) {
+				v[k++] = fsm_getopaque(src_fsm, src_set[i]);
+			}
 		}
 
-		new->token    = m->token;
-		new->to       = m->to;
+		set = ast_internconflict(v, k);
+
+		if (v != a) {
+			free(v);
+		}
 
-		new->fsm      = NULL;
-		new->next     = NULL;
-		new->conflict = conflict; /* private to this DFA state */
+		if (set == NULL) {
+			perror("ast_internconflict");
+			goto error;
+		}
 
-		fsm_setopaque(dst_fsm, dst_state, new);
+		fsm_setopaque(dst_fsm, dst_state, &set->m);
 	}
 
 	return;
 
 error:
 
-	/* XXX: free conflict set */
-
 	fsm_setopaque(dst_fsm, dst_state, NULL);
 
 	return;
@@ -443,183 +487,564 @@ zone_equal(const struct ast_zone *a, const struct ast_zone *b)
 	return 1;
 }
 
-void *
-zone_minimise(void *arg)
+/*
+ * Each zone's mappings are minimised as a task apiece, and then merged
+ * pairwise up a balanced tree over the list of mappings, each merge running
+ * as soon as both of its halves are done. A merge appends the right half's
+ * states to the left's, so the zone's FSM holds each mapping's states
+ * in order, and their start states are found from their sizes.
+ */
+struct zone_job {
+	struct ast_zone *z;
+	unsigned n;
+
+	/* per mapping */
+	struct ast_mapping **m;
+	fsm_state_t *start;
+	fsm_state_t *count;
+
+	struct zone_node *nodes;
+	pthread_mutex_t mtx;
+};
+
+struct zone_node {
+	struct zone_job *zj;
+	struct zone_node *parent;
+	struct zone_node *l, *r;
+	unsigned lo, hi; /* range of mappings */
+	unsigned pending; /* halves yet to finish */
+	struct fsm *fsm;
+};
+
+static struct zone_node *
+zone_tree(struct zone_job *zj, struct zone_node *parent,
+	unsigned lo, unsigned hi, unsigned *i)
 {
-	(void) arg;
+	struct zone_node *node;
 
-	for (;;) {
-		struct ast_zone    *z;
-		struct ast_mapping *m;
-		fsm_state_t start;
+	assert(lo < hi);
 
-		pthread_mutex_lock(&zmtx);
-		{
-			z = cur_zone;
-			if (z == NULL || zerror != 0) {
-				pthread_mutex_unlock(&zmtx);
-				return NULL;
-			}
-			cur_zone = cur_zone->next;
+	node = &zj->nodes[(*i)++];
 
-			assert(z->fsm == NULL);
-			if (print_progress) {
-				if (important(zn)) {
-					fprintf(stderr, " z%u", zn);
-				}
-				zn++;
-			}
+	node->zj      = zj;
+	node->parent  = parent;
+	node->lo      = lo;
+	node->hi      = hi;
+	node->fsm     = NULL;
+
+	if (hi - lo == 1) {
+		node->l = NULL;
+		node->r = NULL;
+		node->pending = 0;
+	} else {
+		node->l = zone_tree(zj, node, lo, lo + (hi - lo) / 2, i);
+		node->r = zone_tree(zj, node, lo + (hi - lo) / 2, hi, i);
+		node->pending = 2;
+	}
+
+	return node;
+}
+
+static const char *
+zone_finish(struct zone_job *zj, struct fsm *fsm)
+{
+	fsm_state_t start, base;
+	unsigned i;
+
+	assert(zj != NULL);
+	assert(fsm != NULL);
+
+	if (!fsm_addstate(fsm, &start)) {
+		fsm_free(fsm);
+		return "fsm_addstate";
+	}
+
+	base = 0;
+
+	for (i = 0; i < zj->n; i++) {
+		if (!fsm_addedge_epsilon(fsm, start, base + zj->start[i])) {
+			fsm_free(fsm);
+			return "fsm_addedge_epsilon";
+		}
+
+		base += zj->count[i];
+	}
+
+	fsm_setstart(fsm, start);
+
+	zj->z->fsm = fsm;
+
+	if (print_progress) {
+		pthread_mutex_lock(&zmtx);
+		if (important(zn)) {
+			fprintf(stderr, " z%u", zn);
 		}
+		zn++;
 		pthread_mutex_unlock(&zmtx);
+	}
+
+	return NULL;
+}
 
-		z->fsm = fsm_new(&opt);
-		if (z->fsm == NULL) {
-			pthread_mutex_lock(&zmtx);
-			zerror = errno;
-			pthread_mutex_unlock(&zmtx);
-			return "fsm_new";
+/* the last of a node's halves to finish carries on to merge them */
+static const char *
+zone_done(struct zone_node *node)
+{
+	struct zone_job *zj;
+
+	assert(node != NULL);
+
+	zj = node->zj;
+
+	while (node->parent != NULL) {
+		struct zone_node *parent;
+		fsm_state_t base;
+		int ready;
+
+		parent = node->parent;
+
+		pthread_mutex_lock(&zj->mtx);
+		ready = --parent->pending == 0;
+		pthread_mutex_unlock(&zj->mtx);
+
+		if (!ready) {
+			return NULL;
 		}
 
-		if (!fsm_addstate(z->fsm, &start)) {
-			pthread_mutex_lock(&zmtx);
-			zerror = errno;
-			pthread_mutex_unlock(&zmtx);
-			return "fsm_addstate";
+		parent->fsm = fsm_mergeab(parent->l->fsm, parent->r->fsm, &base);
+		if (parent->fsm == NULL) {
+			return "fsm_mergeab";
 		}
 
-		for (m = z->ml; m != NULL; m = m->next) {
-			fsm_state_t ms;
-			fsm_state_t base_z, base_m;
+		parent->l->fsm = NULL;
+		parent->r->fsm = NULL;
 
-			assert(m->fsm != NULL);
+		node = parent;
+	}
 
-			if (!keep_nfa) {
-				if (!fsm_determinise(m->fsm)) {
-					pthread_mutex_lock(&zmtx);
-					zerror = errno;
-					pthread_mutex_unlock(&zmtx);
-					return "fsm_minimise";
-				}
-				if (!fsm_minimise(m->fsm)) {
-					pthread_mutex_lock(&zmtx);
-					zerror = errno;
-					pthread_mutex_unlock(&zmtx);
-					return "fsm_minimise";
-				}
-			}
+	return zone_finish(zj, node->fsm);
+}
 
-			/* Attach this mapping to each end state for this FSM */
-			fsm_setendopaque(m->fsm, m);
+static const char *
+mapping_minimise(struct pool_worker *w, void *opaque)
+{
+	struct zone_node *node = opaque;
+	struct zone_job *zj;
+	struct ast_mapping *m;
 
-			(void) fsm_getstart(m->fsm, &ms);
+	(void) w;
 
-			z->fsm = fsm_merge(z->fsm, m->fsm, &base_z, &base_m);
-			if (z->fsm == NULL) {
-				pthread_mutex_lock(&zmtx);
-				zerror = errno;
-				pthread_mutex_unlock(&zmtx);
-				return "fsm_union";
-			}
+	assert(node != NULL);
+	assert(node->hi - node->lo == 1);
+
+	zj = node->zj;
+	m  = zj->m[node->lo];
+
+	assert(m->fsm != NULL);
+
+	if (!keep_nfa) {
+		if (!fsm_determinise(m->fsm)) {
+			return "fsm_determinise";
+		}
+		if (!fsm_minimise(m->fsm)) {
+			return "fsm_minimise";
+		}
+	}
+
+	/* Attach this mapping to each end state for this FSM */
+	fsm_setendopaque(m->fsm, m);
+
+	(void) fsm_getstart(m->fsm, &zj->start[node->lo]);
+	zj->count[node->lo] = fsm_countstates(m->fsm);
+
+	node->fsm = m->fsm;
 
 #ifndef NDEBUG
-			m->fsm = NULL;
+	m->fsm = NULL;
 #endif
 
-			ms    += base_m;
-			start += base_z;
+	return zone_done(node);
+}
 
-			if (!fsm_addedge_epsilon(z->fsm, start, ms)) {
-				pthread_mutex_lock(&zmtx);
-				zerror = errno;
-				pthread_mutex_unlock(&zmtx);
-				return "fsm_addedge_epsilon";
-			}
+static const char *
+zone_determinise(struct pool_worker *w, void *opaque)
+{
+	struct ast_zone *z = opaque;
+
+	(void) w;
+
+	assert(z != NULL);
+
+	if (!fsm_determinise(z->fsm)) {
+		return "fsm_determinise";
+	}
+
+	/*
+	 * Each mapping was minimised alone, but states from different
+	 * mappings may be equivalent in their union. End states are kept
+	 * apart by their mappings, which carryopaque() gave as opaques,
+	 * and which are interned for conflicting sets.
+	 */
+	if (!fsm_minimise_opaque(z->fsm)) {
+		return "fsm_minimise_opaque";
+	}
+
+	if (print_progress) {
+		pthread_mutex_lock(&zmtx);
+		if (important(zn)) {
+			fprintf(stderr, " z%u", zn);
 		}
+		zn++;
+		pthread_mutex_unlock(&zmtx);
+	}
+
+	return NULL;
+}
 
-		fsm_setstart(z->fsm, start);
+static int
+run_pool(struct pool *pool)
+{
+	const char *name;
+
+	assert(pool != NULL);
+
+	if (!pool_run(pool, &name)) {
+		perror(name);
+		return EXIT_FAILURE;
 	}
+
+	return 0;
 }
 
-void *
-zone_determinise(void *arg)
+/*
+ * Minimise each mapping, and union them to an NFA per zone.
+ */
+static int
+zones_minimise(struct ast *ast, unsigned concurrency)
 {
-	(void) arg;
+	struct zone_job *jobs;
+	struct ast_zone *z;
+	struct pool *pool;
+	unsigned nzones, i, j;
+	int r;
 
-	for (;;) {
-		struct ast_zone *z;
+	assert(ast != NULL);
 
-		pthread_mutex_lock(&zmtx);
-		{
-			z = cur_zone;
-			if (z == NULL || zerror != 0) {
-				pthread_mutex_unlock(&zmtx);
-				return NULL;
+	nzones = 0;
+	for (z = ast->zl; z != NULL; z = z->next) {
+		nzones++;
+	}
+
+	jobs = calloc(nzones, sizeof *jobs);
+	if (jobs == NULL) {
+		perror("calloc");
+		return EXIT_FAILURE;
+	}
+
+	pool = pool_new(concurrency);
+	if (pool == NULL) {
+		perror("pool_new");
+		free(jobs);
+		return EXIT_FAILURE;
+	}
+
+	r = EXIT_FAILURE;
+
+	for (z = ast->zl, i = 0; z != NULL; z = z->next, i++) {
+		struct zone_job *zj = &jobs[i];
+		struct ast_mapping *m;
+
+		assert(z->fsm == NULL);
+
+		zj->z = z;
+		zj->n = 0;
+		for (m = z->ml; m != NULL; m = m->next) {
+			zj->n++;
+		}
+
+		pthread_mutex_init(&zj->mtx, NULL);
+
+		if (zj->n == 0) {
+			struct fsm *fsm;
+			const char *err;
+
+			fsm = fsm_new(&opt);
+			if (fsm == NULL) {
+				perror("fsm_new");
+				goto done;
 			}
-			cur_zone = cur_zone->next;
 
-			if (print_progress) {
-				if (important(zn)) {
-					fprintf(stderr, " z%u", zn);
-				}
-				zn++;
+			err = zone_finish(zj, fsm);
+			if (err != NULL) {
+				perror(err);
+				goto done;
 			}
+
+			continue;
 		}
-		pthread_mutex_unlock(&zmtx);
 
-		if (!fsm_determinise(z->fsm)) {
-			pthread_mutex_lock(&zmtx);
-			zerror = errno;
-			pthread_mutex_unlock(&zmtx);
-			return "fsm_determinise";
+		zj->m     = malloc(zj->n * sizeof *zj->m);
+		zj->start = malloc(zj->n * sizeof *zj->start);
+		zj->count = malloc(zj->n * sizeof *zj->count);
+		zj->nodes = malloc((2 * zj->n - 1) * sizeof *zj->nodes);
+		if (zj->m == NULL || zj->start == NULL || zj->count == NULL || zj->nodes == NULL) {
+			perror("malloc");
+			goto done;
+		}
+
+		for (m = z->ml, j = 0; m != NULL; m = m->next, j++) {
+			zj->m[j] = m;
+		}
+
+		j = 0;
+		(void) zone_tree(zj, NULL, 0, zj->n, &j);
+		assert(j == 2 * zj->n - 1);
+
+		for (j = 0; j < 2 * zj->n - 1; j++) {
+			if (zj->nodes[j].l != NULL) {
+				continue;
+			}
+
+			if (!pool_add(pool, mapping_minimise, &zj->nodes[j])) {
+				perror("pool_add");
+				goto done;
+			}
+		}
+	}
+
+	r = run_pool(pool);
+
+done:
+
+	for (i = 0; i < nzones; i++) {
+		if (jobs[i].z == NULL) {
+			continue;
 		}
+
+		free(jobs[i].m);
+		free(jobs[i].start);
+		free(jobs[i].count);
+		free(jobs[i].nodes);
+		pthread_mutex_destroy(&jobs[i].mtx);
 	}
+
+	pool_free(pool);
+	free(jobs);
+
+	return r;
 }
 
-int
-run_threads(int concurrency, void *(*fn)(void *))
+static int
+zones_determinise(struct ast *ast, unsigned concurrency)
 {
-	pthread_t *tds;
-	int i;
+	struct ast_zone *z;
+	struct pool *pool;
+	int r;
 
-	assert(fn != NULL);
+	assert(ast != NULL);
 
-	tds = malloc(concurrency * sizeof *tds);
-	if (tds == NULL) {
-		perror("malloc");
+	pool = pool_new(concurrency);
+	if (pool == NULL) {
+		perror("pool_new");
 		return EXIT_FAILURE;
 	}
 
-	for (i = 0; i < concurrency; i++) {
-		int r;
-
-		r = pthread_create(&tds[i], NULL, fn, NULL);
-		if (r != 0) {
-			perror("pthread_create");
+	for (z = ast->zl; z != NULL; z = z->next) {
+		if (!pool_add(pool, zone_determinise, z)) {
+			perror("pool_add");
+			pool_free(pool);
 			return EXIT_FAILURE;
 		}
 	}
 
-	for (i = 0; i < concurrency; i++) {
-		void *rv;
-		int r;
+	r = run_pool(pool);
 
-		r = pthread_join(tds[i], &rv);
-		if (r != 0) {
-			perror("pthread_join");
-			return EXIT_FAILURE;
+	pool_free(pool);
+
+	return r;
+}
+
+/*
+ * Least-cost paths from the start state to every state, for an example
+ * of input to each state with conflicting mappings. This is Dijkstra's
+ * algorithm per fsm_shortest(), costed per fsm_example(), but finding all
+ * states in one pass over a binary heap; calling fsm_example() per state
+ * is quadratic for lexers of many tokens, which may conflict in as many
+ * states.
+ */
+struct examples {
+	fsm_state_t start;
+	fsm_state_t *prev; /* statecount for unreachable */
+	char *c;           /* symbol from prev[] */
+};
+
+struct example_node {
+	unsigned long cost;
+	fsm_state_t state;
+};
+
+static void
+example_push(struct example_node *heap, size_t *n, unsigned long cost, fsm_state_t state)
+{
+	struct example_node tmp;
+	size_t i;
+
+	i = (*n)++;
+	heap[i].cost  = cost;
+	heap[i].state = state;
+
+	while (i > 0 && heap[(i - 1) / 2].cost > heap[i].cost) {
+		tmp = heap[i];
+		heap[i] = heap[(i - 1) / 2];
+		heap[(i - 1) / 2] = tmp;
+		i = (i - 1) / 2;
+	}
+}
+
+static struct example_node
+example_pop(struct example_node *heap, size_t *n)
+{
+	struct example_node top, tmp;
+	size_t i, l;
+
+	top = heap[0];
+	heap[0] = heap[--*n];
+
+	for (i = 0; l = 2 * i + 1, l < *n; i = l) {
+		if (l + 1 < *n && heap[l + 1].cost < heap[l].cost) {
+			l++;
 		}
 
-		if (rv != NULL) {
-			char *f = rv;
-			errno = zerror;
-			perror(f);
-			return EXIT_FAILURE;
+		if (heap[i].cost <= heap[l].cost) {
+			break;
+		}
+
+		tmp = heap[i];
+		heap[i] = heap[l];
+		heap[l] = tmp;
+	}
+
+	return top;
+}
+
+static int
+examples_find(const struct fsm *fsm, struct examples *ex)
+{
+	struct example_node *heap;
+	unsigned long *cost;
+	size_t n, i;
+
+	assert(fsm != NULL);
+	assert(ex != NULL);
+
+	if (!fsm_getstart(fsm, &ex->start)) {
+		errno = EINVAL;
+		return 0;
+	}
+
+	/* each state is pushed at most once per incoming edge, and once more */
+	ex->prev = malloc(fsm->statecount * sizeof *ex->prev);
+	ex->c    = malloc(fsm->statecount * sizeof *ex->c);
+	cost     = malloc(fsm->statecount * sizeof *cost);
+	heap     = malloc((fsm_countedges(fsm) + 1) * sizeof *heap);
+
+	if (ex->prev == NULL || ex->c == NULL || cost == NULL || heap == NULL) {
+		goto error;
+	}
+
+	for (i = 0; i < fsm->statecount; i++) {
+		ex->prev[i] = fsm->statecount;
+		cost[i]     = (unsigned long) -1;
+	}
+
+	ex->prev[ex->start] = ex->start;
+	ex->c[ex->start]    = '\0';
+	cost[ex->start]     = 0;
+
+	n = 0;
+	example_push(heap, &n, 0, ex->start);
+
+	while (n > 0) {
+		struct example_node u;
+		struct edge_iter it;
+		struct fsm_edge e;
+
+		u = example_pop(heap, &n);
+
+		/* superseded by a cheaper push */
+		if (u.cost > cost[u.state]) {
+			continue;
+		}
+
+		for (edge_set_reset(fsm->states[u.state].edges, &it); edge_set_next(&it, &e); ) {
+			unsigned long c;
+
+			c = u.cost + fsm_cost_legible(u.state, e.state, e.symbol);
+
+			/* relax */
+			if (c < cost[e.state]) {
+				cost[e.state]     = c;
+				ex->prev[e.state] = u.state;
+				ex->c[e.state]    = e.symbol;
+
+				example_push(heap, &n, c, e.state);
+			}
 		}
 	}
 
+	free(cost);
+	free(heap);
+
+	return 1;
+
+error:
+
+	free(ex->prev);
+	free(ex->c);
+	free(cost);
+	free(heap);
+
 	return 0;
 }
 
+/* as for fsm_example() */
+static int
+example(const struct fsm *fsm, const struct examples *ex, fsm_state_t goal,
+	char *buf, size_t bufsz)
+{
+	fsm_state_t s;
+	size_t n, k;
+
+	assert(fsm != NULL);
+	assert(ex != NULL);
+	assert(buf != NULL && bufsz > 0);
+	assert(goal < fsm->statecount);
+
+	n = 0;
+
+	/* no known path to goal */
+	if (ex->prev[goal] == fsm->statecount) {
+		buf[0] = '\0';
+		return 0;
+	}
+
+	for (s = goal; s != ex->start; s = ex->prev[s]) {
+		n++;
+	}
+
+	for (s = goal, k = n; s != ex->start; s = ex->prev[s]) {
+		k--;
+
+		if (k < bufsz - 1) {
+			buf[k] = ex->c[s];
+		}
+	}
+
+	buf[n < bufsz - 1 ? n : bufsz - 1] = '\0';
+
+	return n;
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -630,6 +1055,7 @@ main(int argc, char *argv[])
 	print = lx_print_c;
 	keep_nfa = 0;
 	print_progress = 0;
+	combine_zones = 0;
 	concurrency = 4;
 
 	/* TODO: populate options */
@@ -642,12 +1068,16 @@ main(int argc, char *argv[])
 	{
 		int c;
 
-		while (c = getopt(argc, argv, "h" "C:Xe:t:k:" "vb:g:l:nQx:"), c != -1) {
+		while (c = getopt(argc, argv, "h" "C:TXe:t:k:" "vb:g:l:nQx:z"), c != -1) {
 			switch (c) {
 			case 'C':
 				concurrency = atoi(optarg);
 				break;
 
+			case 'T':
+				opt.ctable = FSM_CTABLE_ALWAYS;
+				break;
+
 			case 'X':
 				opt.always_hex = 1;
 				break;
@@ -680,6 +1110,10 @@ main(int argc, char *argv[])
 				print_progress = 1;
 				break;
 
+			case 'z':
+				combine_zones = 1;
+				break;
+
 			case 'h':
 				usage();
 				exit(EXIT_SUCCESS);
@@ -715,11 +1149,31 @@ main(int argc, char *argv[])
 		return EXIT_FAILURE;
 	}
 
+	if (combine_zones && (print != lx_print_c && print != lx_print_h && print != lx_print_dump)) {
+		fprintf(stderr, "-z is for .c/.h output only\n");
+		return EXIT_FAILURE;
+	}
+
 	if (api_getc && opt.io != FSM_IO_GETC) {
 		fprintf(stderr, "-g is for -k getc output only\n");
 		return EXIT_FAILURE;
 	}
 
+	if ((api_tokbuf & API_SPANBUF) && opt.io == FSM_IO_GETC) {
+		fprintf(stderr, "-b span is for -k str or -k pair output only\n");
+		return EXIT_FAILURE;
+	}
+
+	if ((api_tokbuf & API_SPANBUF) && api_tokbuf != API_SPANBUF) {
+		fprintf(stderr, "-b span cannot be combined with other token buffers\n");
+		return EXIT_FAILURE;
+	}
+
+	/* spans refer into the input, so there is nothing to push */
+	if (api_tokbuf & API_SPANBUF) {
+		api_exclude |= API_BUF;
+	}
+
 	if (0 != strcmp(prefix.api, "lx_")) {
 		prefix.lx = prefix.api;
 	}
@@ -764,8 +1218,7 @@ main(int argc, char *argv[])
 			zn = 0;
 		}
 
-		cur_zone = ast->zl;
-		if (run_threads(concurrency, zone_minimise)) {
+		if (zones_minimise(ast, concurrency)) {
 			return EXIT_FAILURE;
 		}
 
@@ -780,8 +1233,7 @@ main(int argc, char *argv[])
 			}
 
 			opt.carryopaque = carryopaque;
-			cur_zone = ast->zl;
-			if (run_threads(concurrency, zone_determinise)) {
+			if (zones_determinise(ast, concurrency)) {
 				return EXIT_FAILURE;
 			}
 			opt.carryopaque = NULL;
@@ -890,6 +1342,7 @@ main(int argc, char *argv[])
 	 */
 	if (print != lx_print_h) {
 		struct ast_zone  *z;
+		struct examples ex;
 		unsigned int zn;
 		fsm_state_t i;
 		int e;
@@ -929,7 +1382,12 @@ main(int argc, char *argv[])
 				e = 1;
 			}
 
-			/* pick up conflicts flagged by carryopaque() */
+			ex.prev = NULL;
+
+			/*
+			 * Pick up conflicts flagged by carryopaque(). Many states may share
+			 * the same set of conflicting mappings, which is reported once.
+			 */
 			for (i = 0; i < z->fsm->statecount; i++) {
 				struct ast_mapping *m;
 
@@ -940,17 +1398,20 @@ main(int argc, char *argv[])
 				m = fsm_getopaque(z->fsm, i);
 				assert(m != NULL);
 
-				if (m->conflict != NULL) {
-					struct mapping_set *p;
+				if (m->conflict != NULL && !m->conflict->reported) {
 					char buf[50]; /* 50 looks reasonable for an on-screen limit */
+					size_t j;
 					int n;
 
-					n = fsm_example(z->fsm, i, buf, sizeof buf);
-					if (-1 == n) {
-						perror("fsm_example");
+					if (ex.prev == NULL && !examples_find(z->fsm, &ex)) {
+						perror("examples_find");
 						return EXIT_FAILURE;
 					}
 
+					n = example(z->fsm, &ex, i, buf, sizeof buf);
+
+					m->conflict->reported = 1;
+
 					/*
 					 * When n == 0, we have two patterns which match the empty string.
 					 * Here we defer to the error about the start state accepting,
@@ -960,22 +1421,24 @@ main(int argc, char *argv[])
 					if (n > 0) {
 						fprintf(stderr, "ambiguous mappings to ");
 
-						for (p = m->conflict; p != NULL; p = p->next) {
-							if (p->m->token != NULL) {
-								fprintf(stderr, "$%s", p->m->token->s);
-							} else if (p->m->to == NULL) {
+						for (j = 0; j < m->conflict->n; j++) {
+							const struct ast_mapping *p = m->conflict->a[j];
+
+							if (p->token != NULL) {
+								fprintf(stderr, "$%s", p->token->s);
+							} else if (p->to == NULL) {
 								fprintf(stderr, "skip");
 							}
-							if (p->m->token != NULL && p->m->to != NULL) {
+							if (p->token != NULL && p->to != NULL) {
 								fprintf(stderr, "/");
 							}
-							if (p->m->to == ast->global) {
+							if (p->to == ast->global) {
 								fprintf(stderr, "global zone");
-							} else if (p->m->to != NULL) {
-								fprintf(stderr, "z%p", (void *) p->m->to); /* TODO: zindexof(n->to) */
+							} else if (p->to != NULL) {
+								fprintf(stderr, "z%p", (void *) p->to); /* TODO: zindexof(n->to) */
 							}
 
-							if (p->next != NULL) {
+							if (j + 1 < m->conflict->n) {
 								fprintf(stderr, ", ");
 							}
 						}
@@ -988,6 +1451,11 @@ main(int argc, char *argv[])
 					}
 				}
 			}
+
+			if (ex.prev != NULL) {
+				free(ex.prev);
+				free(ex.c);
+			}
 		}
 
 		if (print_progress) {
@@ -1001,7 +1469,6 @@ main(int argc, char *argv[])
 
 	/* XXX: can do this before semantic checks */
 	/* TODO: free ast */
-	/* TODO: free DFA ast_mappings, created in carryopaque, iff making a DFA. i.e. those which have non-NULL conflict sets */
 	if (print == lx_print_h) {
 		/* TODO: special case to avoid overhead; free non-minimized NFA */
 	}
@@ -1020,8 +1487,7 @@ main(int argc, char *argv[])
 				if (m != NULL) {
 					assert(m->fsm == NULL);
 
-					/* TODO: free m->conflict, allocated in carryopaque */
-					(void) m->conflict;
+					/* m->conflict is interned, shared between DFA states */
 				}
 			}
 		}
@@ -9,7 +9,7 @@
 
 /* BEGINNING OF HEADER */
 
-#line 128 "src/lx/parser.act"
+#line 112 "src/lx/parser.act"
 
 
 	#include <assert.h>
@@ -55,6 +55,7 @@
 		enum lx_token lex_tok_save;
 		unsigned int zn;
 		const struct fsm_options *opt;
+		struct re_arena *arena; /* reused for each regexp */
 	};
 
 	struct lex_state {
@@ -94,24 +95,7 @@
 		exit(EXIT_FAILURE);
 	}
 
-	static int
-	act_agetc(void *opaque)
-	{
-		struct arr *a;
-
-		a = opaque;
-
-		assert(a != NULL);
-		assert(a->p != NULL);
-
-		if (a->len == 0) {
-			return EOF;
-		}
-
-		return a->len--, (unsigned char) *a->p++;
-	}
-
-#line 115 "src/lx/parser.c"
+#line 99 "src/lx/parser.c"
 
 
 #ifndef ERROR_TERMINAL
@@ -179,11 +163,11 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-list */
 		{
-#line 831 "src/lx/parser.act"
+#line 815 "src/lx/parser.act"
 
 		err_expected(lex_state, "list of mappings, bindings or zones");
 	
-#line 187 "src/lx/parser.c"
+#line 171 "src/lx/parser.c"
 		}
 		/* END OF ACTION: err-expected-list */
 	}
@@ -201,7 +185,7 @@ p_pattern(lex_state lex_state, act_state act_state, zone ZIz, fsm *ZOr)
 
 			/* BEGINNING OF EXTRACT: IDENT */
 			{
-#line 233 "src/lx/parser.act"
+#line 217 "src/lx/parser.act"
 
 		ZIn = xstrdup(lex_state->buf.a);
 		if (ZIn == NULL) {
@@ -209,13 +193,13 @@ p_pattern(lex_state lex_state, act_state act_state, zone ZIz, fsm *ZOr)
 			exit(EXIT_FAILURE);
 		}
 	
-#line 213 "src/lx/parser.c"
+#line 197 "src/lx/parser.c"
 			}
 			/* END OF EXTRACT: IDENT */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: deref-var */
 			{
-#line 288 "src/lx/parser.act"
+#line 272 "src/lx/parser.act"
 
 		struct ast_zone *z;
 
@@ -242,7 +226,7 @@ p_pattern(lex_state lex_state, act_state act_state, zone ZIz, fsm *ZOr)
 			goto ZL1;
 		}
 	
-#line 246 "src/lx/parser.c"
+#line 230 "src/lx/parser.c"
 			}
 			/* END OF ACTION: deref-var */
 		}
@@ -253,7 +237,7 @@ p_pattern(lex_state lex_state, act_state act_state, zone ZIz, fsm *ZOr)
 
 			/* BEGINNING OF EXTRACT: TOKEN */
 			{
-#line 225 "src/lx/parser.act"
+#line 209 "src/lx/parser.act"
 
 		/* TODO: submatch addressing */
 		ZIt = xstrdup(lex_state->buf.a + 1); /* +1 for '$' prefix */
@@ -262,13 +246,13 @@ p_pattern(lex_state lex_state, act_state act_state, zone ZIz, fsm *ZOr)
 			exit(EXIT_FAILURE);
 		}
 	
-#line 266 "src/lx/parser.c"
+#line 250 "src/lx/parser.c"
 			}
 			/* END OF EXTRACT: TOKEN */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: deref-token */
 			{
-#line 316 "src/lx/parser.act"
+#line 300 "src/lx/parser.act"
 
 		const struct ast_mapping *m;
 		fsm_state_t start;
@@ -332,7 +316,7 @@ p_pattern(lex_state lex_state, act_state act_state, zone ZIz, fsm *ZOr)
 
 		fsm_setstart((ZIr), start);
 	
-#line 336 "src/lx/parser.c"
+#line 320 "src/lx/parser.c"
 			}
 			/* END OF ACTION: deref-token */
 		}
@@ -381,11 +365,11 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-open */
 		{
-#line 815 "src/lx/parser.act"
+#line 799 "src/lx/parser.act"
 
 		err_expected(lex_state, "'{'");
 	
-#line 389 "src/lx/parser.c"
+#line 373 "src/lx/parser.c"
 		}
 		/* END OF ACTION: err-expected-open */
 	}
@@ -411,11 +395,11 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-close */
 		{
-#line 819 "src/lx/parser.act"
+#line 803 "src/lx/parser.act"
 
 		err_expected(lex_state, "'}'");
 	
-#line 419 "src/lx/parser.c"
+#line 403 "src/lx/parser.c"
 		}
 		/* END OF ACTION: err-expected-close */
 	}
@@ -446,7 +430,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 			/* BEGINNING OF ACTION: op-reverse */
 			{
-#line 692 "src/lx/parser.act"
+#line 676 "src/lx/parser.act"
 
 		assert((ZI194) != NULL);
 
@@ -455,7 +439,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			goto ZL1;
 		}
 	
-#line 459 "src/lx/parser.c"
+#line 443 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-reverse */
 			p_196 (lex_state, act_state, &ZIz, &ZI194, &ZI191);
@@ -470,7 +454,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 			/* BEGINNING OF ACTION: subtract-exit */
 			{
-#line 751 "src/lx/parser.act"
+#line 735 "src/lx/parser.act"
 
 		assert((ZI210) != NULL);
 
@@ -490,7 +474,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 		}
 	
-#line 494 "src/lx/parser.c"
+#line 478 "src/lx/parser.c"
 			}
 			/* END OF ACTION: subtract-exit */
 			p_250 (lex_state, act_state, &ZIa, &ZIz, &ZI211, &ZI212);
@@ -521,7 +505,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 			/* BEGINNING OF ACTION: op-complete */
 			{
-#line 683 "src/lx/parser.act"
+#line 667 "src/lx/parser.act"
 
 		assert((ZI194) != NULL);
 
@@ -530,7 +514,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			goto ZL1;
 		}
 	
-#line 534 "src/lx/parser.c"
+#line 518 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-complete */
 			p_196 (lex_state, act_state, &ZIz, &ZI194, &ZI191);
@@ -545,7 +529,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 			/* BEGINNING OF ACTION: subtract-exit */
 			{
-#line 751 "src/lx/parser.act"
+#line 735 "src/lx/parser.act"
 
 		assert((ZI216) != NULL);
 
@@ -565,7 +549,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 		}
 	
-#line 569 "src/lx/parser.c"
+#line 553 "src/lx/parser.c"
 			}
 			/* END OF ACTION: subtract-exit */
 			p_250 (lex_state, act_state, &ZIa, &ZIz, &ZI217, &ZI218);
@@ -581,7 +565,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 
 			/* BEGINNING OF EXTRACT: IDENT */
 			{
-#line 233 "src/lx/parser.act"
+#line 217 "src/lx/parser.act"
 
 		ZIn = xstrdup(lex_state->buf.a);
 		if (ZIn == NULL) {
@@ -589,7 +573,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			exit(EXIT_FAILURE);
 		}
 	
-#line 593 "src/lx/parser.c"
+#line 577 "src/lx/parser.c"
 			}
 			/* END OF EXTRACT: IDENT */
 			ADVANCE_LEXER;
@@ -639,7 +623,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 			/* BEGINNING OF ACTION: subtract-exit */
 			{
-#line 751 "src/lx/parser.act"
+#line 735 "src/lx/parser.act"
 
 		assert((ZI223) != NULL);
 
@@ -659,7 +643,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 		}
 	
-#line 663 "src/lx/parser.c"
+#line 647 "src/lx/parser.c"
 			}
 			/* END OF ACTION: subtract-exit */
 			p_250 (lex_state, act_state, &ZIa, &ZIz, &ZI224, &ZI225);
@@ -690,7 +674,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 			/* BEGINNING OF ACTION: op-complement */
 			{
-#line 674 "src/lx/parser.act"
+#line 658 "src/lx/parser.act"
 
 		assert((ZI194) != NULL);
 
@@ -699,7 +683,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			goto ZL1;
 		}
 	
-#line 703 "src/lx/parser.c"
+#line 687 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-complement */
 			p_196 (lex_state, act_state, &ZIz, &ZI194, &ZI191);
@@ -714,7 +698,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 			/* BEGINNING OF ACTION: subtract-exit */
 			{
-#line 751 "src/lx/parser.act"
+#line 735 "src/lx/parser.act"
 
 		assert((ZI204) != NULL);
 
@@ -734,7 +718,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 		}
 	
-#line 738 "src/lx/parser.c"
+#line 722 "src/lx/parser.c"
 			}
 			/* END OF ACTION: subtract-exit */
 			p_250 (lex_state, act_state, &ZIa, &ZIz, &ZI205, &ZI206);
@@ -761,7 +745,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 
 			/* BEGINNING OF EXTRACT: TOKEN */
 			{
-#line 225 "src/lx/parser.act"
+#line 209 "src/lx/parser.act"
 
 		/* TODO: submatch addressing */
 		ZI228 = xstrdup(lex_state->buf.a + 1); /* +1 for '$' prefix */
@@ -770,13 +754,13 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			exit(EXIT_FAILURE);
 		}
 	
-#line 774 "src/lx/parser.c"
+#line 758 "src/lx/parser.c"
 			}
 			/* END OF EXTRACT: TOKEN */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: deref-token */
 			{
-#line 316 "src/lx/parser.act"
+#line 300 "src/lx/parser.act"
 
 		const struct ast_mapping *m;
 		fsm_state_t start;
@@ -840,7 +824,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 
 		fsm_setstart((ZI229), start);
 	
-#line 844 "src/lx/parser.c"
+#line 828 "src/lx/parser.c"
 			}
 			/* END OF ACTION: deref-token */
 			p_182 (lex_state, act_state, ZI229, &ZI194);
@@ -856,7 +840,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 			/* BEGINNING OF ACTION: subtract-exit */
 			{
-#line 751 "src/lx/parser.act"
+#line 735 "src/lx/parser.act"
 
 		assert((ZI232) != NULL);
 
@@ -876,7 +860,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 		}
 	
-#line 880 "src/lx/parser.c"
+#line 864 "src/lx/parser.c"
 			}
 			/* END OF ACTION: subtract-exit */
 			p_250 (lex_state, act_state, &ZIa, &ZIz, &ZI233, &ZI234);
@@ -916,7 +900,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 			/* BEGINNING OF ACTION: subtract-exit */
 			{
-#line 751 "src/lx/parser.act"
+#line 735 "src/lx/parser.act"
 
 		assert((ZI239) != NULL);
 
@@ -936,7 +920,7 @@ p_list_Hof_Hthings_C_Cthing(lex_state lex_state, act_state act_state, ast ZIa, z
 			}
 		}
 	
-#line 940 "src/lx/parser.c"
+#line 924 "src/lx/parser.c"
 			}
 			/* END OF ACTION: subtract-exit */
 			p_250 (lex_state, act_state, &ZIa, &ZIz, &ZI240, &ZI241);
@@ -956,11 +940,11 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-thing */
 		{
-#line 827 "src/lx/parser.act"
+#line 811 "src/lx/parser.act"
 
 		err_expected(lex_state, "mapping, binding or zone");
 	
-#line 964 "src/lx/parser.c"
+#line 948 "src/lx/parser.c"
 		}
 		/* END OF ACTION: err-expected-thing */
 	}
@@ -1031,7 +1015,7 @@ ZL2_165:;
 			}
 			/* BEGINNING OF ACTION: op-alt */
 			{
-#line 740 "src/lx/parser.act"
+#line 724 "src/lx/parser.act"
 
 		assert((ZI162) != NULL);
 		assert((ZIb) != NULL);
@@ -1042,7 +1026,7 @@ ZL2_165:;
 			goto ZL1;
 		}
 	
-#line 1046 "src/lx/parser.c"
+#line 1030 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-alt */
 			/* BEGINNING OF INLINE: 165 */
@@ -1085,14 +1069,14 @@ ZL2_pattern_C_Cbody:;
 					{
 						/* BEGINNING OF EXTRACT: CHAR */
 						{
-#line 220 "src/lx/parser.act"
+#line 204 "src/lx/parser.act"
 
 		assert(lex_state->buf.a[0] != '\0');
 		assert(lex_state->buf.a[1] == '\0');
 
 		ZIc = lex_state->buf.a[0];
 	
-#line 1096 "src/lx/parser.c"
+#line 1080 "src/lx/parser.c"
 						}
 						/* END OF EXTRACT: CHAR */
 						ADVANCE_LEXER;
@@ -1102,7 +1086,7 @@ ZL2_pattern_C_Cbody:;
 					{
 						/* BEGINNING OF EXTRACT: ESC */
 						{
-#line 150 "src/lx/parser.act"
+#line 134 "src/lx/parser.act"
 
 		assert(lex_state->buf.a[0] == '\\');
 		assert(lex_state->buf.a[1] != '\0');
@@ -1120,7 +1104,7 @@ ZL2_pattern_C_Cbody:;
 		default:   ZIc = '\0'; break; /* TODO: handle error */
 		}
 	
-#line 1124 "src/lx/parser.c"
+#line 1108 "src/lx/parser.c"
 						}
 						/* END OF EXTRACT: ESC */
 						ADVANCE_LEXER;
@@ -1130,7 +1114,7 @@ ZL2_pattern_C_Cbody:;
 					{
 						/* BEGINNING OF EXTRACT: HEX */
 						{
-#line 213 "src/lx/parser.act"
+#line 197 "src/lx/parser.act"
 
 		unsigned long u;
 		char *e;
@@ -1157,7 +1141,7 @@ ZL2_pattern_C_Cbody:;
 
 		ZIc = (char) (unsigned char) u;
 	
-#line 1161 "src/lx/parser.c"
+#line 1145 "src/lx/parser.c"
 						}
 						/* END OF EXTRACT: HEX */
 						ADVANCE_LEXER;
@@ -1167,7 +1151,7 @@ ZL2_pattern_C_Cbody:;
 					{
 						/* BEGINNING OF EXTRACT: OCT */
 						{
-#line 186 "src/lx/parser.act"
+#line 170 "src/lx/parser.act"
 
 		unsigned long u;
 		char *e;
@@ -1194,7 +1178,7 @@ ZL2_pattern_C_Cbody:;
 
 		ZIc = (char) (unsigned char) u;
 	
-#line 1198 "src/lx/parser.c"
+#line 1182 "src/lx/parser.c"
 						}
 						/* END OF EXTRACT: OCT */
 						ADVANCE_LEXER;
@@ -1207,12 +1191,12 @@ ZL2_pattern_C_Cbody:;
 			/* END OF INLINE: 83 */
 			/* BEGINNING OF ACTION: pattern-char */
 			{
-#line 257 "src/lx/parser.act"
+#line 241 "src/lx/parser.act"
 
 		/* TODO */
 		*lex_state->p++ = (ZIc);
 	
-#line 1216 "src/lx/parser.c"
+#line 1200 "src/lx/parser.c"
 			}
 			/* END OF ACTION: pattern-char */
 			/* BEGINNING OF INLINE: pattern::body */
@@ -1252,7 +1236,7 @@ ZL2_171:;
 			}
 			/* BEGINNING OF ACTION: op-intersect */
 			{
-#line 729 "src/lx/parser.act"
+#line 713 "src/lx/parser.act"
 
 		assert((ZI168) != NULL);
 		assert((ZIb) != NULL);
@@ -1263,7 +1247,7 @@ ZL2_171:;
 			goto ZL1;
 		}
 	
-#line 1267 "src/lx/parser.c"
+#line 1251 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-intersect */
 			/* BEGINNING OF INLINE: 171 */
@@ -1355,7 +1339,7 @@ ZL2_182:;
 						ADVANCE_LEXER;
 						/* BEGINNING OF ACTION: op-cross */
 						{
-#line 590 "src/lx/parser.act"
+#line 574 "src/lx/parser.act"
 
 		fsm_state_t start, end;
 		fsm_state_t old;
@@ -1400,7 +1384,7 @@ ZL2_182:;
 
 		fsm_setstart((ZIq), start);
 	
-#line 1404 "src/lx/parser.c"
+#line 1388 "src/lx/parser.c"
 						}
 						/* END OF ACTION: op-cross */
 						/* BEGINNING OF INLINE: 182 */
@@ -1414,7 +1398,7 @@ ZL2_182:;
 						ADVANCE_LEXER;
 						/* BEGINNING OF ACTION: op-qmark */
 						{
-#line 635 "src/lx/parser.act"
+#line 619 "src/lx/parser.act"
 
 		fsm_state_t start, end;
 		fsm_state_t old;
@@ -1459,7 +1443,7 @@ ZL2_182:;
 
 		fsm_setstart((ZIq), start);
 	
-#line 1463 "src/lx/parser.c"
+#line 1447 "src/lx/parser.c"
 						}
 						/* END OF ACTION: op-qmark */
 						/* BEGINNING OF INLINE: 182 */
@@ -1473,7 +1457,7 @@ ZL2_182:;
 						ADVANCE_LEXER;
 						/* BEGINNING OF ACTION: op-star */
 						{
-#line 540 "src/lx/parser.act"
+#line 524 "src/lx/parser.act"
 
 		fsm_state_t start, end;
 		fsm_state_t old;
@@ -1523,7 +1507,7 @@ ZL2_182:;
 
 		fsm_setstart((ZIq), start);
 	
-#line 1527 "src/lx/parser.c"
+#line 1511 "src/lx/parser.c"
 						}
 						/* END OF ACTION: op-star */
 						/* BEGINNING OF INLINE: 182 */
@@ -1597,7 +1581,7 @@ p_expr_C_Cprefix_Hexpr(lex_state lex_state, act_state act_state, zone ZIz, fsm *
 			}
 			/* BEGINNING OF ACTION: op-reverse */
 			{
-#line 692 "src/lx/parser.act"
+#line 676 "src/lx/parser.act"
 
 		assert((ZIq) != NULL);
 
@@ -1606,7 +1590,7 @@ p_expr_C_Cprefix_Hexpr(lex_state lex_state, act_state act_state, zone ZIz, fsm *
 			goto ZL1;
 		}
 	
-#line 1610 "src/lx/parser.c"
+#line 1594 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-reverse */
 		}
@@ -1621,7 +1605,7 @@ p_expr_C_Cprefix_Hexpr(lex_state lex_state, act_state act_state, zone ZIz, fsm *
 			}
 			/* BEGINNING OF ACTION: op-complete */
 			{
-#line 683 "src/lx/parser.act"
+#line 667 "src/lx/parser.act"
 
 		assert((ZIq) != NULL);
 
@@ -1630,7 +1614,7 @@ p_expr_C_Cprefix_Hexpr(lex_state lex_state, act_state act_state, zone ZIz, fsm *
 			goto ZL1;
 		}
 	
-#line 1634 "src/lx/parser.c"
+#line 1618 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-complete */
 		}
@@ -1645,7 +1629,7 @@ p_expr_C_Cprefix_Hexpr(lex_state lex_state, act_state act_state, zone ZIz, fsm *
 			}
 			/* BEGINNING OF ACTION: op-complement */
 			{
-#line 674 "src/lx/parser.act"
+#line 658 "src/lx/parser.act"
 
 		assert((ZIq) != NULL);
 
@@ -1654,7 +1638,7 @@ p_expr_C_Cprefix_Hexpr(lex_state lex_state, act_state act_state, zone ZIz, fsm *
 			goto ZL1;
 		}
 	
-#line 1658 "src/lx/parser.c"
+#line 1642 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-complement */
 		}
@@ -1701,7 +1685,7 @@ p_190(lex_state lex_state, act_state act_state, zone *ZIz, fsm *ZI188, fsm *ZOq)
 			}
 			/* BEGINNING OF ACTION: op-subtract */
 			{
-#line 718 "src/lx/parser.act"
+#line 702 "src/lx/parser.act"
 
 		assert((*ZI188) != NULL);
 		assert((ZIb) != NULL);
@@ -1712,7 +1696,7 @@ p_190(lex_state lex_state, act_state act_state, zone *ZIz, fsm *ZI188, fsm *ZOq)
 			goto ZL1;
 		}
 	
-#line 1716 "src/lx/parser.c"
+#line 1700 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-subtract */
 		}
@@ -1752,7 +1736,7 @@ p_193(lex_state lex_state, act_state act_state, zone *ZIz, fsm *ZI191, fsm *ZOq)
 			}
 			/* BEGINNING OF ACTION: op-concat */
 			{
-#line 701 "src/lx/parser.act"
+#line 685 "src/lx/parser.act"
 
 		assert((*ZI191) != NULL);
 		assert((ZIb) != NULL);
@@ -1763,7 +1747,7 @@ p_193(lex_state lex_state, act_state act_state, zone *ZIz, fsm *ZI191, fsm *ZOq)
 			goto ZL1;
 		}
 	
-#line 1767 "src/lx/parser.c"
+#line 1751 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-concat */
 		}
@@ -1851,13 +1835,13 @@ p_196(lex_state lex_state, act_state act_state, zone *ZIz, fsm *ZI194, fsm *ZOq)
 			}
 			/* BEGINNING OF ACTION: op-product */
 			{
-#line 713 "src/lx/parser.act"
+#line 697 "src/lx/parser.act"
 
 		fprintf(stderr, "unimplemented\n");
 		(ZIq) = NULL;
 		goto ZL1;
 	
-#line 1861 "src/lx/parser.c"
+#line 1845 "src/lx/parser.c"
 			}
 			/* END OF ACTION: op-product */
 		}
@@ -1891,7 +1875,7 @@ p_200(lex_state lex_state, act_state act_state, fsm *ZOr)
 
 			/* BEGINNING OF EXTRACT: RE */
 			{
-#line 245 "src/lx/parser.act"
+#line 229 "src/lx/parser.act"
 
 		assert(lex_state->buf.a[0] == '/');
 
@@ -1904,13 +1888,13 @@ p_200(lex_state lex_state, act_state act_state, fsm *ZOr)
 
 		ZIf |= RE_ANCHORED; /* regexps in lx are implicitly anchored */
 	
-#line 1908 "src/lx/parser.c"
+#line 1892 "src/lx/parser.c"
 			}
 			/* END OF EXTRACT: RE */
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: pattern-buffer */
 			{
-#line 271 "src/lx/parser.act"
+#line 255 "src/lx/parser.act"
 
 		size_t len;
 
@@ -1935,19 +1919,19 @@ p_200(lex_state lex_state, act_state act_state, fsm *ZOr)
 
 		lex_state->p = lex_state->a;
 	
-#line 1939 "src/lx/parser.c"
+#line 1923 "src/lx/parser.c"
 			}
 			/* END OF ACTION: pattern-buffer */
 			/* BEGINNING OF ACTION: compile-regex */
 			{
-#line 394 "src/lx/parser.act"
+#line 378 "src/lx/parser.act"
 
 		struct re_err err;
 
 		assert((ZIa) != NULL);
 		assert((ZIa)->p != NULL);
 
-		(ZIr) = re_comp(RE_NATIVE, act_agetc, (ZIa), act_state->opt, (ZIf), &err);
+		(ZIr) = re_comp_arena(act_state->arena, RE_NATIVE, (ZIa)->p, (ZIa)->len, act_state->opt, (ZIf), &err);
 		if ((ZIr) == NULL) {
 			assert(err.e != RE_EBADDIALECT);
 			/* TODO: pass filename for .lx source */
@@ -1955,16 +1939,16 @@ p_200(lex_state lex_state, act_state act_state, fsm *ZOr)
 			exit(EXIT_FAILURE);
 		}
 	
-#line 1959 "src/lx/parser.c"
+#line 1943 "src/lx/parser.c"
 			}
 			/* END OF ACTION: compile-regex */
 			/* BEGINNING OF ACTION: free-arr */
 			{
-#line 781 "src/lx/parser.act"
+#line 765 "src/lx/parser.act"
 
 		free((ZIa));
 	
-#line 1968 "src/lx/parser.c"
+#line 1952 "src/lx/parser.c"
 			}
 			/* END OF ACTION: free-arr */
 		}
@@ -1976,7 +1960,7 @@ p_200(lex_state lex_state, act_state act_state, fsm *ZOr)
 			ADVANCE_LEXER;
 			/* BEGINNING OF ACTION: pattern-buffer */
 			{
-#line 271 "src/lx/parser.act"
+#line 255 "src/lx/parser.act"
 
 		size_t len;
 
@@ -2001,19 +1985,19 @@ p_200(lex_state lex_state, act_state act_state, fsm *ZOr)
 
 		lex_state->p = lex_state->a;
 	
-#line 2005 "src/lx/parser.c"
+#line 1989 "src/lx/parser.c"
 			}
 			/* END OF ACTION: pattern-buffer */
 			/* BEGINNING OF ACTION: compile-literal */
 			{
-#line 379 "src/lx/parser.act"
+#line 363 "src/lx/parser.act"
 
 		struct re_err err;
 
 		assert((ZIa) != NULL);
 		assert((ZIa)->p != NULL);
 
-		(ZIr) = re_comp(RE_LITERAL, act_agetc, (ZIa), act_state->opt, 0, &err);
+		(ZIr) = re_comp_arena(act_state->arena, RE_LITERAL, (ZIa)->p, (ZIa)->len, act_state->opt, 0, &err);
 		if ((ZIr) == NULL) {
 			assert(err.e != RE_EBADDIALECT);
 			/* TODO: pass filename for .lx source */
@@ -2021,16 +2005,16 @@ p_200(lex_state lex_state, act_state act_state, fsm *ZOr)
 			exit(EXIT_FAILURE);
 		}
 	
-#line 2025 "src/lx/parser.c"
+#line 2009 "src/lx/parser.c"
 			}
 			/* END OF ACTION: compile-literal */
 			/* BEGINNING OF ACTION: free-arr */
 			{
-#line 781 "src/lx/parser.act"
+#line 765 "src/lx/parser.act"
 
 		free((ZIa));
 	
-#line 2034 "src/lx/parser.c"
+#line 2018 "src/lx/parser.c"
 			}
 			/* END OF ACTION: free-arr */
 		}
@@ -2123,11 +2107,11 @@ p_227(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, fsm *ZIexit
 				{
 					/* BEGINNING OF ACTION: err-expected-bind */
 					{
-#line 803 "src/lx/parser.act"
+#line 787 "src/lx/parser.act"
 
 		err_expected(lex_state, "'='");
 	
-#line 2131 "src/lx/parser.c"
+#line 2115 "src/lx/parser.c"
 					}
 					/* END OF ACTION: err-expected-bind */
 				}
@@ -2141,7 +2125,7 @@ p_227(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, fsm *ZIexit
 			}
 			/* BEGINNING OF ACTION: subtract-exit */
 			{
-#line 751 "src/lx/parser.act"
+#line 735 "src/lx/parser.act"
 
 		assert((ZIr) != NULL);
 
@@ -2161,7 +2145,7 @@ p_227(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, fsm *ZIexit
 			}
 		}
 	
-#line 2165 "src/lx/parser.c"
+#line 2149 "src/lx/parser.c"
 			}
 			/* END OF ACTION: subtract-exit */
 			p_121 (lex_state, act_state);
@@ -2171,7 +2155,7 @@ p_227(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, fsm *ZIexit
 			}
 			/* BEGINNING OF ACTION: add-binding */
 			{
-#line 500 "src/lx/parser.act"
+#line 484 "src/lx/parser.act"
 
 		struct var *v;
 
@@ -2188,7 +2172,7 @@ p_227(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, fsm *ZIexit
 			goto ZL1;
 		}
 	
-#line 2192 "src/lx/parser.c"
+#line 2176 "src/lx/parser.c"
 			}
 			/* END OF ACTION: add-binding */
 		}
@@ -2214,7 +2198,7 @@ p_227(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, fsm *ZIexit
 
 			/* BEGINNING OF ACTION: deref-var */
 			{
-#line 288 "src/lx/parser.act"
+#line 272 "src/lx/parser.act"
 
 		struct ast_zone *z;
 
@@ -2241,7 +2225,7 @@ p_227(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, fsm *ZIexit
 			goto ZL1;
 		}
 	
-#line 2245 "src/lx/parser.c"
+#line 2229 "src/lx/parser.c"
 			}
 			/* END OF ACTION: deref-var */
 			p_182 (lex_state, act_state, ZI244, &ZI194);
@@ -2257,7 +2241,7 @@ p_227(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, fsm *ZIexit
 			}
 			/* BEGINNING OF ACTION: subtract-exit */
 			{
-#line 751 "src/lx/parser.act"
+#line 735 "src/lx/parser.act"
 
 		assert((ZI247) != NULL);
 
@@ -2277,7 +2261,7 @@ p_227(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, fsm *ZIexit
 			}
 		}
 	
-#line 2281 "src/lx/parser.c"
+#line 2265 "src/lx/parser.c"
 			}
 			/* END OF ACTION: subtract-exit */
 			p_250 (lex_state, act_state, ZIa, ZIz, &ZI248, &ZI249);
@@ -2313,16 +2297,16 @@ p_lx(lex_state lex_state, act_state act_state, ast *ZOa)
 
 		/* BEGINNING OF ACTION: no-zone */
 		{
-#line 530 "src/lx/parser.act"
+#line 514 "src/lx/parser.act"
 
 		(ZIparent) = NULL;
 	
-#line 2321 "src/lx/parser.c"
+#line 2305 "src/lx/parser.c"
 		}
 		/* END OF ACTION: no-zone */
 		/* BEGINNING OF ACTION: make-ast */
 		{
-#line 439 "src/lx/parser.act"
+#line 423 "src/lx/parser.act"
 
 		(ZIa) = ast_new();
 		if ((ZIa) == NULL) {
@@ -2330,12 +2314,12 @@ p_lx(lex_state lex_state, act_state act_state, ast *ZOa)
 			goto ZL1;
 		}
 	
-#line 2334 "src/lx/parser.c"
+#line 2318 "src/lx/parser.c"
 		}
 		/* END OF ACTION: make-ast */
 		/* BEGINNING OF ACTION: make-zone */
 		{
-#line 447 "src/lx/parser.act"
+#line 431 "src/lx/parser.act"
 
 		assert((ZIa) != NULL);
 
@@ -2353,28 +2337,28 @@ p_lx(lex_state lex_state, act_state act_state, ast *ZOa)
 			goto ZL1;
 		}
 	
-#line 2357 "src/lx/parser.c"
+#line 2341 "src/lx/parser.c"
 		}
 		/* END OF ACTION: make-zone */
 		/* BEGINNING OF ACTION: no-exit */
 		{
-#line 526 "src/lx/parser.act"
+#line 510 "src/lx/parser.act"
 
 		(ZIexit) = NULL;
 	
-#line 2366 "src/lx/parser.c"
+#line 2350 "src/lx/parser.c"
 		}
 		/* END OF ACTION: no-exit */
 		/* BEGINNING OF ACTION: set-globalzone */
 		{
-#line 515 "src/lx/parser.act"
+#line 499 "src/lx/parser.act"
 
 		assert((ZIa) != NULL);
 		assert((ZIz) != NULL);
 
 		(ZIa)->global = (ZIz);
 	
-#line 2378 "src/lx/parser.c"
+#line 2362 "src/lx/parser.c"
 		}
 		/* END OF ACTION: set-globalzone */
 		p_list_Hof_Hthings (lex_state, act_state, ZIa, ZIz, ZIexit);
@@ -2398,11 +2382,11 @@ p_lx(lex_state lex_state, act_state act_state, ast *ZOa)
 			{
 				/* BEGINNING OF ACTION: err-expected-eof */
 				{
-#line 823 "src/lx/parser.act"
+#line 807 "src/lx/parser.act"
 
 		err_expected(lex_state, "EOF");
 	
-#line 2406 "src/lx/parser.c"
+#line 2390 "src/lx/parser.c"
 				}
 				/* END OF ACTION: err-expected-eof */
 			}
@@ -2415,7 +2399,7 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: make-ast */
 		{
-#line 439 "src/lx/parser.act"
+#line 423 "src/lx/parser.act"
 
 		(ZIa) = ast_new();
 		if ((ZIa) == NULL) {
@@ -2423,17 +2407,17 @@ ZL1:;
 			goto ZL4;
 		}
 	
-#line 2427 "src/lx/parser.c"
+#line 2411 "src/lx/parser.c"
 		}
 		/* END OF ACTION: make-ast */
 		/* BEGINNING OF ACTION: err-syntax */
 		{
-#line 791 "src/lx/parser.act"
+#line 775 "src/lx/parser.act"
 
 		err(lex_state, "Syntax error");
 		exit(EXIT_FAILURE);
 	
-#line 2437 "src/lx/parser.c"
+#line 2421 "src/lx/parser.c"
 		}
 		/* END OF ACTION: err-syntax */
 	}
@@ -2495,11 +2479,11 @@ p_111(lex_state lex_state, act_state act_state, string *ZOt)
 				{
 					/* BEGINNING OF ACTION: err-expected-map */
 					{
-#line 799 "src/lx/parser.act"
+#line 783 "src/lx/parser.act"
 
 		err_expected(lex_state, "'->'");
 	
-#line 2503 "src/lx/parser.c"
+#line 2487 "src/lx/parser.c"
 					}
 					/* END OF ACTION: err-expected-map */
 				}
@@ -2510,7 +2494,7 @@ p_111(lex_state lex_state, act_state act_state, string *ZOt)
 			case (TOK_TOKEN):
 				/* BEGINNING OF EXTRACT: TOKEN */
 				{
-#line 225 "src/lx/parser.act"
+#line 209 "src/lx/parser.act"
 
 		/* TODO: submatch addressing */
 		ZIt = xstrdup(lex_state->buf.a + 1); /* +1 for '$' prefix */
@@ -2519,7 +2503,7 @@ p_111(lex_state lex_state, act_state act_state, string *ZOt)
 			exit(EXIT_FAILURE);
 		}
 	
-#line 2523 "src/lx/parser.c"
+#line 2507 "src/lx/parser.c"
 				}
 				/* END OF EXTRACT: TOKEN */
 				break;
@@ -2533,11 +2517,11 @@ p_111(lex_state lex_state, act_state act_state, string *ZOt)
 		{
 			/* BEGINNING OF ACTION: no-token */
 			{
-#line 522 "src/lx/parser.act"
+#line 506 "src/lx/parser.act"
 
 		(ZIt) = NULL;
 	
-#line 2541 "src/lx/parser.c"
+#line 2525 "src/lx/parser.c"
 			}
 			/* END OF ACTION: no-token */
 		}
@@ -2626,11 +2610,11 @@ ZL1:;
 	{
 		/* BEGINNING OF ACTION: err-expected-semi */
 		{
-#line 807 "src/lx/parser.act"
+#line 791 "src/lx/parser.act"
 
 		err_expected(lex_state, "';'");
 	
-#line 2634 "src/lx/parser.c"
+#line 2618 "src/lx/parser.c"
 		}
 		/* END OF ACTION: err-expected-semi */
 	}
@@ -2677,16 +2661,16 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			}
 			/* BEGINNING OF ACTION: no-zone */
 			{
-#line 530 "src/lx/parser.act"
+#line 514 "src/lx/parser.act"
 
 		(ZIto) = NULL;
 	
-#line 2685 "src/lx/parser.c"
+#line 2669 "src/lx/parser.c"
 			}
 			/* END OF ACTION: no-zone */
 			/* BEGINNING OF ACTION: add-mapping */
 			{
-#line 468 "src/lx/parser.act"
+#line 452 "src/lx/parser.act"
 
 		struct ast_token *t;
 		struct ast_mapping *m;
@@ -2719,7 +2703,7 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			nmappings++;
 		}
 	
-#line 2723 "src/lx/parser.c"
+#line 2707 "src/lx/parser.c"
 			}
 			/* END OF ACTION: add-mapping */
 		}
@@ -2746,11 +2730,11 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 				{
 					/* BEGINNING OF ACTION: err-expected-to */
 					{
-#line 811 "src/lx/parser.act"
+#line 795 "src/lx/parser.act"
 
 		err_expected(lex_state, "'..'");
 	
-#line 2754 "src/lx/parser.c"
+#line 2738 "src/lx/parser.c"
 					}
 					/* END OF ACTION: err-expected-to */
 				}
@@ -2764,7 +2748,7 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			}
 			/* BEGINNING OF ACTION: make-zone */
 			{
-#line 447 "src/lx/parser.act"
+#line 431 "src/lx/parser.act"
 
 		assert((*ZIa) != NULL);
 
@@ -2782,12 +2766,12 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			goto ZL1;
 		}
 	
-#line 2786 "src/lx/parser.c"
+#line 2770 "src/lx/parser.c"
 			}
 			/* END OF ACTION: make-zone */
 			/* BEGINNING OF ACTION: add-mapping */
 			{
-#line 468 "src/lx/parser.act"
+#line 452 "src/lx/parser.act"
 
 		struct ast_token *t;
 		struct ast_mapping *m;
@@ -2820,12 +2804,12 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			nmappings++;
 		}
 	
-#line 2824 "src/lx/parser.c"
+#line 2808 "src/lx/parser.c"
 			}
 			/* END OF ACTION: add-mapping */
 			/* BEGINNING OF ACTION: add-mapping */
 			{
-#line 468 "src/lx/parser.act"
+#line 452 "src/lx/parser.act"
 
 		struct ast_token *t;
 		struct ast_mapping *m;
@@ -2858,7 +2842,7 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			nmappings++;
 		}
 	
-#line 2862 "src/lx/parser.c"
+#line 2846 "src/lx/parser.c"
 			}
 			/* END OF ACTION: add-mapping */
 			/* BEGINNING OF INLINE: 137 */
@@ -2879,25 +2863,25 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 						}
 						/* BEGINNING OF ACTION: no-zone */
 						{
-#line 530 "src/lx/parser.act"
+#line 514 "src/lx/parser.act"
 
 		(ZIx) = NULL;
 	
-#line 2887 "src/lx/parser.c"
+#line 2871 "src/lx/parser.c"
 						}
 						/* END OF ACTION: no-zone */
 						/* BEGINNING OF ACTION: no-token */
 						{
-#line 522 "src/lx/parser.act"
+#line 506 "src/lx/parser.act"
 
 		(ZIy) = NULL;
 	
-#line 2896 "src/lx/parser.c"
+#line 2880 "src/lx/parser.c"
 						}
 						/* END OF ACTION: no-token */
 						/* BEGINNING OF ACTION: clone */
 						{
-#line 771 "src/lx/parser.act"
+#line 755 "src/lx/parser.act"
 
 		assert((ZIr2) != NULL);
 
@@ -2907,12 +2891,12 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			goto ZL5;
 		}
 	
-#line 2911 "src/lx/parser.c"
+#line 2895 "src/lx/parser.c"
 						}
 						/* END OF ACTION: clone */
 						/* BEGINNING OF ACTION: regex-any */
 						{
-#line 410 "src/lx/parser.act"
+#line 394 "src/lx/parser.act"
 
 		fsm_state_t start, end;
 
@@ -2943,12 +2927,12 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 		fsm_setstart((ZIw), start);
 		fsm_setend((ZIw), end, 1);
 	
-#line 2947 "src/lx/parser.c"
+#line 2931 "src/lx/parser.c"
 						}
 						/* END OF ACTION: regex-any */
 						/* BEGINNING OF ACTION: subtract-exit */
 						{
-#line 751 "src/lx/parser.act"
+#line 735 "src/lx/parser.act"
 
 		assert((ZIw) != NULL);
 
@@ -2968,12 +2952,12 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			}
 		}
 	
-#line 2972 "src/lx/parser.c"
+#line 2956 "src/lx/parser.c"
 						}
 						/* END OF ACTION: subtract-exit */
 						/* BEGINNING OF ACTION: add-mapping */
 						{
-#line 468 "src/lx/parser.act"
+#line 452 "src/lx/parser.act"
 
 		struct ast_token *t;
 		struct ast_mapping *m;
@@ -3006,7 +2990,7 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			nmappings++;
 		}
 	
-#line 3010 "src/lx/parser.c"
+#line 2994 "src/lx/parser.c"
 						}
 						/* END OF ACTION: add-mapping */
 					}
@@ -3030,11 +3014,11 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 				{
 					/* BEGINNING OF ACTION: err-expected-list */
 					{
-#line 831 "src/lx/parser.act"
+#line 815 "src/lx/parser.act"
 
 		err_expected(lex_state, "list of mappings, bindings or zones");
 	
-#line 3038 "src/lx/parser.c"
+#line 3022 "src/lx/parser.c"
 					}
 					/* END OF ACTION: err-expected-list */
 				}
@@ -3050,16 +3034,16 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 
 			/* BEGINNING OF ACTION: no-exit */
 			{
-#line 526 "src/lx/parser.act"
+#line 510 "src/lx/parser.act"
 
 		(ZIr2) = NULL;
 	
-#line 3058 "src/lx/parser.c"
+#line 3042 "src/lx/parser.c"
 			}
 			/* END OF ACTION: no-exit */
 			/* BEGINNING OF ACTION: make-zone */
 			{
-#line 447 "src/lx/parser.act"
+#line 431 "src/lx/parser.act"
 
 		assert((*ZIa) != NULL);
 
@@ -3077,12 +3061,12 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			goto ZL1;
 		}
 	
-#line 3081 "src/lx/parser.c"
+#line 3065 "src/lx/parser.c"
 			}
 			/* END OF ACTION: make-zone */
 			/* BEGINNING OF ACTION: add-mapping */
 			{
-#line 468 "src/lx/parser.act"
+#line 452 "src/lx/parser.act"
 
 		struct ast_token *t;
 		struct ast_mapping *m;
@@ -3115,7 +3099,7 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 			nmappings++;
 		}
 	
-#line 3119 "src/lx/parser.c"
+#line 3103 "src/lx/parser.c"
 			}
 			/* END OF ACTION: add-mapping */
 			/* BEGINNING OF INLINE: 130 */
@@ -3134,11 +3118,11 @@ p_250(lex_state lex_state, act_state act_state, ast *ZIa, zone *ZIz, string *ZI2
 				{
 					/* BEGINNING OF ACTION: err-expected-list */
 					{
-#line 831 "src/lx/parser.act"
+#line 815 "src/lx/parser.act"
 
 		err_expected(lex_state, "list of mappings, bindings or zones");
 	
-#line 3142 "src/lx/parser.c"
+#line 3126 "src/lx/parser.c"
 					}
 					/* END OF ACTION: err-expected-list */
 				}
@@ -3160,7 +3144,7 @@ ZL1:;
 
 /* BEGINNING OF TRAILER */
 
-#line 883 "src/lx/parser.act"
+#line 875 "src/lx/parser.act"
 
 
 	struct ast *lx_parse(FILE *f, const struct fsm_options *opt) {
@@ -3197,6 +3181,12 @@ ZL1:;
 
 		act_state->opt = opt;
 
+		act_state->arena = re_arena_new();
+		if (act_state->arena == NULL) {
+			perror("re_arena_new");
+			exit(EXIT_FAILURE);
+		}
+
 		if (print_progress) {
 			act_state->zn = 0;
 		}
@@ -3206,11 +3196,13 @@ ZL1:;
 
 		lx->free(lx->buf_opaque);
 
+		re_arena_free(act_state->arena);
+
 		assert(ast != NULL);
 
 		return ast;
 	}
 
-#line 3215 "src/lx/parser.c"
+#line 3207 "src/lx/parser.c"
 
 /* END OF FILE */
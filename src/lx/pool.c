@@ -0,0 +1,319 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "pool.h"
+
+struct entry {
+	pool_task *fn;
+	void *opaque;
+};
+
+/* a deque of entries a[head] to a[tail - 1]; the owner takes from the tail */
+struct pool_worker {
+	struct pool *pool;
+	pthread_t td;
+
+	pthread_mutex_t mtx;
+	struct entry *a;
+	size_t head;
+	size_t tail;
+	size_t alloc;
+};
+
+struct pool {
+	unsigned n;
+	struct pool_worker *w;
+	unsigned next; /* for pool_add() */
+
+	/* guards everything below; taken after a worker's mtx, never before */
+	pthread_mutex_t mtx;
+	pthread_cond_t cond;
+
+	size_t queued;  /* in any deque */
+	size_t running;
+
+	const char *err;
+	int errnum;
+};
+
+struct pool *
+pool_new(unsigned nthreads)
+{
+	struct pool *pool;
+	unsigned i;
+
+	if (nthreads == 0) {
+		nthreads = 1;
+	}
+
+	pool = malloc(sizeof *pool);
+	if (pool == NULL) {
+		return NULL;
+	}
+
+	pool->w = malloc(nthreads * sizeof *pool->w);
+	if (pool->w == NULL) {
+		free(pool);
+		return NULL;
+	}
+
+	for (i = 0; i < nthreads; i++) {
+		pool->w[i].pool  = pool;
+		pool->w[i].a     = NULL;
+		pool->w[i].head  = 0;
+		pool->w[i].tail  = 0;
+		pool->w[i].alloc = 0;
+		pthread_mutex_init(&pool->w[i].mtx, NULL);
+	}
+
+	pool->n       = nthreads;
+	pool->next    = 0;
+	pool->queued  = 0;
+	pool->running = 0;
+	pool->err     = NULL;
+	pool->errnum  = 0;
+
+	pthread_mutex_init(&pool->mtx, NULL);
+	pthread_cond_init(&pool->cond, NULL);
+
+	return pool;
+}
+
+void
+pool_free(struct pool *pool)
+{
+	unsigned i;
+
+	if (pool == NULL) {
+		return;
+	}
+
+	for (i = 0; i < pool->n; i++) {
+		pthread_mutex_destroy(&pool->w[i].mtx);
+		free(pool->w[i].a);
+	}
+
+	pthread_mutex_destroy(&pool->mtx);
+	pthread_cond_destroy(&pool->cond);
+
+	free(pool->w);
+	free(pool);
+}
+
+static int
+push(struct pool_worker *w, pool_task *fn, void *opaque)
+{
+	struct pool *pool;
+
+	assert(w != NULL);
+	assert(fn != NULL);
+
+	pool = w->pool;
+
+	pthread_mutex_lock(&w->mtx);
+
+	if (w->tail == w->alloc) {
+		if (w->head > 0) {
+			memmove(w->a, w->a + w->head, (w->tail - w->head) * sizeof *w->a);
+			w->tail -= w->head;
+			w->head  = 0;
+		} else {
+			struct entry *tmp;
+			size_t alloc;
+
+			alloc = w->alloc == 0 ? 16 : w->alloc * 2;
+
+			tmp = realloc(w->a, alloc * sizeof *w->a);
+			if (tmp == NULL) {
+				pthread_mutex_unlock(&w->mtx);
+				return 0;
+			}
+
+			w->a     = tmp;
+			w->alloc = alloc;
+		}
+	}
+
+	w->a[w->tail].fn     = fn;
+	w->a[w->tail].opaque = opaque;
+	w->tail++;
+
+	/*
+	 * Counted before w->mtx is released, so that a thief can never
+	 * take this task and decrement .queued before it was incremented.
+	 */
+	pthread_mutex_lock(&pool->mtx);
+	pool->queued++;
+	pthread_cond_signal(&pool->cond);
+	pthread_mutex_unlock(&pool->mtx);
+
+	pthread_mutex_unlock(&w->mtx);
+
+	return 1;
+}
+
+int
+pool_add(struct pool *pool, pool_task *fn, void *opaque)
+{
+	struct pool_worker *w;
+
+	assert(pool != NULL);
+
+	w = &pool->w[pool->next];
+	pool->next = (pool->next + 1) % pool->n;
+
+	return push(w, fn, opaque);
+}
+
+int
+pool_push(struct pool_worker *w, pool_task *fn, void *opaque)
+{
+	return push(w, fn, opaque);
+}
+
+/* newest first from our own deque, otherwise the oldest from another */
+static int
+take(struct pool_worker *w, struct entry *e)
+{
+	struct pool *pool;
+	unsigned i;
+
+	pool = w->pool;
+
+	for (i = 0; i < pool->n; i++) {
+		struct pool_worker *v;
+
+		v = &pool->w[(w - pool->w + i) % pool->n];
+
+		pthread_mutex_lock(&v->mtx);
+
+		if (v->head == v->tail) {
+			pthread_mutex_unlock(&v->mtx);
+			continue;
+		}
+
+		if (v == w) {
+			*e = v->a[--v->tail];
+		} else {
+			*e = v->a[v->head++];
+		}
+
+		if (v->head == v->tail) {
+			v->head = 0;
+			v->tail = 0;
+		}
+
+		pthread_mutex_unlock(&v->mtx);
+
+		return 1;
+	}
+
+	return 0;
+}
+
+static void *
+worker(void *arg)
+{
+	struct pool_worker *w = arg;
+	struct pool *pool;
+
+	pool = w->pool;
+
+	for (;;) {
+		struct entry e;
+		const char *err;
+		int stop;
+
+		if (!take(w, &e)) {
+			pthread_mutex_lock(&pool->mtx);
+
+			while (pool->queued == 0 && pool->running > 0 && pool->err == NULL) {
+				pthread_cond_wait(&pool->cond, &pool->mtx);
+			}
+
+			stop = pool->err != NULL || (pool->queued == 0 && pool->running == 0);
+
+			pthread_mutex_unlock(&pool->mtx);
+
+			if (stop) {
+				return NULL;
+			}
+
+			continue;
+		}
+
+		pthread_mutex_lock(&pool->mtx);
+		assert(pool->queued > 0);
+		pool->queued--;
+		stop = pool->err != NULL;
+		if (!stop) {
+			pool->running++;
+		}
+		pthread_mutex_unlock(&pool->mtx);
+
+		if (stop) {
+			return NULL;
+		}
+
+		err = e.fn(w, e.opaque);
+
+		pthread_mutex_lock(&pool->mtx);
+		pool->running--;
+		if (err != NULL && pool->err == NULL) {
+			pool->err    = err;
+			pool->errnum = errno;
+		}
+		if (pool->err != NULL || (pool->queued == 0 && pool->running == 0)) {
+			pthread_cond_broadcast(&pool->cond);
+		}
+		pthread_mutex_unlock(&pool->mtx);
+	}
+}
+
+int
+pool_run(struct pool *pool, const char **name)
+{
+	unsigned i, n;
+	int r;
+
+	assert(pool != NULL);
+	assert(name != NULL);
+
+	/*
+	 * If a thread cannot be created, we make do with those which were.
+	 * Tasks dealt to the others are stolen from their deques as usual,
+	 * and with no threads at all, the caller runs them itself.
+	 */
+	for (n = 0; n < pool->n; n++) {
+		r = pthread_create(&pool->w[n].td, NULL, worker, &pool->w[n]);
+		if (r != 0) {
+			break;
+		}
+	}
+
+	if (n == 0) {
+		(void) worker(&pool->w[0]);
+	}
+
+	for (i = 0; i < n; i++) {
+		(void) pthread_join(pool->w[i].td, NULL);
+	}
+
+	if (pool->err != NULL) {
+		*name = pool->err;
+		errno = pool->errnum;
+		return 0;
+	}
+
+	return 1;
+}
+
@@ -0,0 +1,57 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#ifndef LX_POOL_H
+#define LX_POOL_H
+
+/*
+ * A pool of threads running tasks, which may add further tasks as they run.
+ *
+ * Each thread keeps a deque of its own tasks, and runs the most recently
+ * added first. A thread with none left steals the oldest task from another
+ * thread, which for tasks added by recursive division tends to be the
+ * largest piece of work remaining.
+ */
+
+struct pool;
+struct pool_worker;
+
+/*
+ * A task returns NULL on success, or on error the name of the function
+ * which failed, with errno set. The first error stops the pool.
+ */
+typedef const char *(pool_task)(struct pool_worker *w, void *opaque);
+
+struct pool *
+pool_new(unsigned nthreads);
+
+void
+pool_free(struct pool *pool);
+
+/*
+ * Add a task before pool_run(). Tasks are dealt across the threads in turn.
+ * Returns 0 on error; see errno.
+ */
+int
+pool_add(struct pool *pool, pool_task *fn, void *opaque);
+
+/*
+ * Add a task from within a running task, to that thread's own deque.
+ * Returns 0 on error; see errno.
+ */
+int
+pool_push(struct pool_worker *w, pool_task *fn, void *opaque);
+
+/*
+ * Run until all tasks are done, including those they add.
+ * Returns 1 on success, or 0 on error, with *name set as returned
+ * by the task which failed, and errno set.
+ */
+int
+pool_run(struct pool *pool, const char **name);
+
+#endif
+
@@ -10,6 +10,8 @@
 #include <stdio.h>
 
 struct ast;
+struct ast_zone;
+struct ast_token;
 
 /* TODO: combine all variables here into an lx_outoptions struct */
 struct prefix {
@@ -20,11 +22,17 @@ struct prefix {
 
 extern struct prefix prefix;
 extern int print_progress;
+extern int combine_zones;
 extern int important(unsigned int n);
 
+/* indexes in the order of the AST's lists, as numbered in the output */
+extern unsigned int zindexof(const struct ast *ast, const struct ast_zone *zone);
+extern unsigned int tokindexof(const struct ast *ast, const struct ast_token *token);
+
 enum api_tokbuf {
 	API_DYNBUF   = 1 << 0,
-	API_FIXEDBUF = 1 << 1
+	API_FIXEDBUF = 1 << 1,
+	API_SPANBUF  = 1 << 2
 };
 
 enum api_getc {
@@ -55,6 +63,7 @@ lx_print lx_print_h;
 lx_print lx_print_dot;
 lx_print lx_print_dump;
 lx_print lx_print_zdot;
+lx_print lx_print_vm;
 
 #endif
 
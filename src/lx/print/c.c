@@ -5,6 +5,7 @@
  */
 
 #include <assert.h>
+#include <stdlib.h>
 #include <stdio.h>
 #include <errno.h>
 
@@ -53,25 +54,6 @@ skip(const struct fsm *fsm, fsm_state_t state)
 	return 0;
 }
 
-static unsigned int
-zindexof(const struct ast *ast, const struct ast_zone *zone)
-{
-	struct ast_zone *z;
-	unsigned int i;
-
-	assert(ast != NULL);
-	assert(zone != NULL);
-
-	for (z = ast->zl, i = 0; z != NULL; z = z->next, i++) {
-		if (z == zone) {
-			return i;
-		}
-	}
-
-	assert(!"unreached");
-	return 0;
-}
-
 /*
  * Given a token, find one of its accepting states which gives
  * the shortest fsm_example(). This is pretty expensive.
@@ -141,6 +123,10 @@ leaf(FILE *f, const void *state_opaque, const void *leaf_opaque)
 	m = state_opaque;
 
 	if (m == NULL) {
+		if (api_tokbuf & API_SPANBUF) {
+			fprintf(f, "lx->tok.e = lx->p; ");
+		}
+
 		/* XXX: don't need this if complete */
 		switch (opt.io) {
 		case FSM_IO_GETC:
@@ -162,6 +148,9 @@ leaf(FILE *f, const void *state_opaque, const void *leaf_opaque)
 
 	/* XXX: don't need this if complete */
 	fprintf(f, "%sungetc(lx, c); ", prefix.api);
+	if (api_tokbuf & API_SPANBUF) {
+		fprintf(f, "lx->tok.e = lx->p; ");
+	}
 	fprintf(f, "return ");
 	if (m->to != NULL) {
 		fprintf(f, "lx->z = z%u, ", zindexof(ast, m->to));
@@ -177,6 +166,21 @@ leaf(FILE *f, const void *state_opaque, const void *leaf_opaque)
 	return 0;
 }
 
+/*
+ * For combined zones, what to do is found by table from the state,
+ * so every state's leaf is the same.
+ */
+static int
+leaf_combined(FILE *f, const void *state_opaque, const void *leaf_opaque)
+{
+	(void) state_opaque;
+	(void) leaf_opaque;
+
+	fprintf(f, "goto leaf;");
+
+	return 0;
+}
+
 static void
 print_proto(FILE *f, const struct ast *ast, const struct ast_zone *z)
 {
@@ -365,7 +369,8 @@ print_io(FILE *f)
 		fprintf(f, "\t\t\treturn EOF;\n");
 		fprintf(f, "\t}\n");
 		fprintf(f, "\n");
-		fprintf(f, "\tc = *lx->p++;\n");
+		/* as for fgetc(), so that '\xff' is not taken for EOF */
+		fprintf(f, "\tc = (unsigned char) *lx->p++;\n");
 		fprintf(f, "\n");
 		break;
 	}
@@ -419,7 +424,7 @@ print_io(FILE *f)
 
 	case FSM_IO_PAIR:
 		fprintf(f, "\tassert(lx->p != NULL);\n");
-		fprintf(f, "\tassert(*(lx->p - 1) == c);\n");
+		fprintf(f, "\tassert((unsigned char) *(lx->p - 1) == c);\n");
 		fprintf(f, "\n");
 		fprintf(f, "\tlx->p--;\n");
 		fprintf(f, "\n");
@@ -595,28 +600,13 @@ print_stateenum(FILE *f, const struct fsm *fsm)
 	fprintf(f, "\t} state;\n");
 }
 
-static int
-print_zone(FILE *f, const struct ast *ast, const struct ast_zone *z)
+/*
+ * Reset for a new token, and start the loop over input.
+ */
+static void
+print_begin(FILE *f)
 {
 	assert(f != NULL);
-	assert(z != NULL);
-	assert(z->fsm != NULL);
-	assert(fsm_all(z->fsm, fsm_isdfa));
-	assert(ast != NULL);
-
-	/* TODO: prerequisite that the FSM is a DFA */
-
-	fprintf(f, "static enum %stoken\n", prefix.api);
-	fprintf(f, "z%u(struct %slx *lx)\n", zindexof(ast, z), prefix.lx);
-	fprintf(f, "{\n");
-	fprintf(f, "\tint c;\n");
-	fprintf(f, "\n");
-
-	print_stateenum(f, z->fsm);
-	fprintf(f, "\n");
-
-	fprintf(f, "\tassert(lx != NULL);\n");
-	fprintf(f, "\n");
 
 	if (~api_exclude & API_BUF) {
 		fprintf(f, "\tif (lx->clear != NULL) {\n");
@@ -633,6 +623,11 @@ print_zone(FILE *f, const struct ast *ast, const struct ast_zone *z)
 		fprintf(f, "\n");
 	}
 
+	if (api_tokbuf & API_SPANBUF) {
+		fprintf(f, "\tlx->tok.p = lx->p;\n");
+		fprintf(f, "\n");
+	}
+
 	switch (opt.io) {
 	case FSM_IO_GETC:
 		fprintf(f, "\twhile (c = lx_getc(lx), c != EOF) {\n");
@@ -646,142 +641,226 @@ print_zone(FILE *f, const struct ast *ast, const struct ast_zone *z)
 		fprintf(f, "\twhile (c = lx_getc(lx), c != EOF) {\n");
 		break;
 	}
+}
 
-	{
-		fsm_state_t start;
+/*
+ * After the loop over input; there is no more input to read.
+ */
+static void
+print_end(FILE *f)
+{
+	assert(f != NULL);
 
-		if (!fsm_getstart(z->fsm, &start)) {
-			errno = EINVAL;
-			return -1;
+	if (api_tokbuf & API_SPANBUF) {
+		switch (opt.io) {
+		case FSM_IO_GETC:
+			assert(!"unreached");
+			break;
+
+		case FSM_IO_STR:
+			/* lx_getc() has consumed the terminating '\0' */
+			fprintf(f, "\tlx->tok.e = lx->p - 1;\n");
+			break;
+
+		case FSM_IO_PAIR:
+			fprintf(f, "\tlx->tok.e = lx->p;\n");
+			break;
 		}
+	}
 
-		fprintf(f, "\t\tif (state == NONE) {\n");
-		fprintf(f, "\t\t\tstate = S%u;\n", start);
-		fprintf(f, "\t\t}\n");
+	switch (opt.io) {
+	case FSM_IO_GETC:
+		fprintf(f, "\tlx->lgetc = NULL;\n");
+		fprintf(f, "\n");
+		break;
+
+	case FSM_IO_STR:
+		fprintf(f, "\tlx->p = NULL;\n");
 		fprintf(f, "\n");
+		break;
+
+	case FSM_IO_PAIR:
+		fprintf(f, "\tlx->p = NULL;\n");
+		fprintf(f, "\n");
+		break;
 	}
+}
 
-	{
-		const struct fsm_options *tmp;
-		static const struct fsm_options defaults;
-		struct fsm_options o = defaults;
-		struct ir *ir;
+static int
+print_frag(FILE *f, struct fsm *fsm,
+	int (*leaf)(FILE *, const void *state_opaque, const void *leaf_opaque),
+	const void *leaf_opaque)
+{
+	const struct fsm_options *tmp;
+	static const struct fsm_options defaults;
+	struct fsm_options o = defaults;
+	struct ir *ir;
+	int r;
+
+	assert(f != NULL);
+	assert(fsm != NULL);
+	assert(leaf != NULL);
+	assert(opt.cp != NULL);
 
-		tmp = z->fsm->opt;
+	tmp = fsm->opt;
 
-		o.comments    = z->fsm->opt->comments;
-		o.case_ranges = z->fsm->opt->case_ranges;
-		o.leaf        = leaf;
-		o.leaf_opaque = (void *) ast;
+	o.comments    = fsm->opt->comments;
+	o.case_ranges = fsm->opt->case_ranges;
+	o.ctable      = fsm->opt->ctable;
+	o.leaf        = leaf;
+	o.leaf_opaque = (void *) leaf_opaque;
 
-		z->fsm->opt = &o;
+	fsm->opt = &o;
 
-		assert(opt.cp != NULL);
+	ir = make_ir(fsm);
+	if (ir == NULL) {
+		fsm->opt = tmp;
+		return -1;
+	}
 
-		ir = make_ir(z->fsm);
-		if (ir == NULL) {
-			/* TODO */
-		}
+	/* XXX: abstraction */
+	r = fsm_print_cfrag(f, ir, &o, opt.cp, leaf, leaf_opaque);
+
+	free_ir(fsm, ir);
+
+	fsm->opt = tmp;
+
+	return r;
+}
 
-		/* XXX: abstraction */
-		(void) fsm_print_cfrag(f, ir, &o, opt.cp,
-			z->fsm->opt->leaf != NULL ? z->fsm->opt->leaf : leaf, z->fsm->opt->leaf_opaque);
+static int
+print_push(FILE *f, const struct fsm *fsm)
+{
+	int has_skips;
+	fsm_state_t i;
 
-		free_ir(z->fsm, ir);
+	assert(f != NULL);
+	assert(fsm != NULL);
 
-		z->fsm->opt = tmp;
+	if (api_exclude & API_BUF) {
+		return 0;
 	}
 
-	if (~api_exclude & API_BUF) {
-		int has_skips;
-		fsm_state_t i;
+	has_skips = 0;
 
-		has_skips = 0;
+	for (i = 0; i < fsm->statecount; i++) {
+		int r;
 
-		for (i = 0; i < z->fsm->statecount; i++) {
+		r = fsm_reachableall(fsm, i, skip);
+		if (r == -1) {
+			return -1;
+		}
+
+		if (r) {
+			has_skips = 1;
+			break;
+		}
+	}
+
+	/*
+	 * An optimisation to avoid pushing to the token buffer, where all
+	 * states reachable henceforth skip, rather than emitting a token.
+	 */
+	if (has_skips) {
+		fprintf(f, "\n");
+		fprintf(f, "\t\tswitch (state) {\n");
+
+		for (i = 0; i < fsm->statecount; i++) {
 			int r;
 
-			r = fsm_reachableall(z->fsm, i, skip);
+			r = fsm_reachableall(fsm, i, skip);
 			if (r == -1) {
 				return -1;
 			}
 
-			if (r) {
-				has_skips = 1;
-				break;
+			if (!r) {
+				continue;
 			}
+
+			fprintf(f, "\t\tcase S%u:\n", (unsigned) i);
 		}
 
-		/*
-		 * An optimisation to avoid pushing to the token buffer, where all
-		 * states reachable henceforth skip, rather than emitting a token.
-		 */
-		if (has_skips) {
-			fprintf(f, "\n");
-			fprintf(f, "\t\tswitch (state) {\n");
+		fprintf(f, "\t\t\tbreak;\n");
+		fprintf(f, "\n");
 
-			for (i = 0; i < z->fsm->statecount; i++) {
-				int r;
+		fprintf(f, "\t\tdefault:\n");
+		fprintf(f, "\t\t\tif (lx->push != NULL) {\n");
+		fprintf(f, "\t\t\t\tif (-1 == lx->push(lx->buf_opaque, %s)) {\n", opt.cp);
+		fprintf(f, "\t\t\t\t\treturn %sERROR;\n", prefix.tok);
+		fprintf(f, "\t\t\t\t}\n");
+		fprintf(f, "\t\t\t}\n");
+		fprintf(f, "\t\t\tbreak;\n");
+		fprintf(f, "\n");
 
-				r = fsm_reachableall(z->fsm, i, skip);
-				if (r == -1) {
-					return -1;
-				}
+		fprintf(f, "\t\t}\n");
+	} else {
+		fprintf(f, "\n");
+		fprintf(f, "\t\tif (lx->push != NULL) {\n");
+		fprintf(f, "\t\t\tif (-1 == lx->push(lx->buf_opaque, %s)) {\n", opt.cp);
+		fprintf(f, "\t\t\t\treturn %sERROR;\n", prefix.tok);
+		fprintf(f, "\t\t\t}\n");
+		fprintf(f, "\t\t}\n");
+	}
 
-				if (!r) {
-					continue;
-				}
+	return 0;
+}
 
-				fprintf(f, "\t\tcase S%u:\n", (unsigned) i);
-			}
+static int
+print_zone(FILE *f, const struct ast *ast, const struct ast_zone *z)
+{
+	assert(f != NULL);
+	assert(z != NULL);
+	assert(z->fsm != NULL);
+	assert(fsm_all(z->fsm, fsm_isdfa));
+	assert(ast != NULL);
 
-			fprintf(f, "\t\t\tbreak;\n");
-			fprintf(f, "\n");
+	/* TODO: prerequisite that the FSM is a DFA */
 
-			fprintf(f, "\t\tdefault:\n");
-			fprintf(f, "\t\t\tif (lx->push != NULL) {\n");
-			fprintf(f, "\t\t\t\tif (-1 == lx->push(lx->buf_opaque, %s)) {\n", opt.cp);
-			fprintf(f, "\t\t\t\t\treturn %sERROR;\n", prefix.tok);
-			fprintf(f, "\t\t\t\t}\n");
-			fprintf(f, "\t\t\t}\n");
-			fprintf(f, "\t\t\tbreak;\n");
-			fprintf(f, "\n");
+	fprintf(f, "static enum %stoken\n", prefix.api);
+	fprintf(f, "z%u(struct %slx *lx)\n", zindexof(ast, z), prefix.lx);
+	fprintf(f, "{\n");
+	fprintf(f, "\tint c;\n");
+	fprintf(f, "\n");
 
-			fprintf(f, "\t\t}\n");
-		} else {
-			fprintf(f, "\n");
-			fprintf(f, "\t\tif (lx->push != NULL) {\n");
-			fprintf(f, "\t\t\tif (-1 == lx->push(lx->buf_opaque, %s)) {\n", opt.cp);
-			fprintf(f, "\t\t\t\treturn %sERROR;\n", prefix.tok);
-			fprintf(f, "\t\t\t}\n");
-			fprintf(f, "\t\t}\n");
+	print_stateenum(f, z->fsm);
+	fprintf(f, "\n");
+
+	fprintf(f, "\tassert(lx != NULL);\n");
+	fprintf(f, "\n");
+
+	print_begin(f);
+
+	{
+		fsm_state_t start;
+
+		if (!fsm_getstart(z->fsm, &start)) {
+			errno = EINVAL;
+			return -1;
 		}
+
+		fprintf(f, "\t\tif (state == NONE) {\n");
+		fprintf(f, "\t\t\tstate = S%u;\n", start);
+		fprintf(f, "\t\t}\n");
+		fprintf(f, "\n");
+	}
+
+	if (-1 == print_frag(f, z->fsm, leaf, ast)) {
+		return -1;
+	}
+
+	if (-1 == print_push(f, z->fsm)) {
+		return -1;
 	}
 
 	fprintf(f, "\t}\n");
 
 	fprintf(f, "\n");
 
+	print_end(f);
+
 	{
 		fsm_state_t i;
 
-		switch (opt.io) {
-		case FSM_IO_GETC:
-			fprintf(f, "\tlx->lgetc = NULL;\n");
-			fprintf(f, "\n");
-			break;
-
-		case FSM_IO_STR:
-			fprintf(f, "\tlx->p = NULL;\n");
-			fprintf(f, "\n");
-			break;
-
-		case FSM_IO_PAIR:
-			fprintf(f, "\tlx->p = NULL;\n");
-			fprintf(f, "\n");
-			break;
-		}
-
 		fprintf(f, "\tswitch (state) {\n");
 
 		fprintf(f, "\tcase NONE: return %sEOF;\n", prefix.tok);
@@ -820,6 +899,296 @@ print_zone(FILE *f, const struct ast *ast, const struct ast_zone *z)
 	return 0;
 }
 
+static const char *
+ctype(unsigned long max)
+{
+	if (max <= 255UL) {
+		return "unsigned char";
+	}
+
+	if (max <= 65535UL) {
+		return "unsigned short";
+	}
+
+	return "unsigned long";
+}
+
+static void
+print_array(FILE *f, const char *name, const unsigned *a, size_t n)
+{
+	unsigned long max;
+	size_t i;
+
+	max = 0;
+	for (i = 0; i < n; i++) {
+		if (a[i] > max) {
+			max = a[i];
+		}
+	}
+
+	fprintf(f, "\tstatic const %s %s[] = {", ctype(max), name);
+
+	for (i = 0; i < n; i++) {
+		if (i % 16 == 0) {
+			fprintf(f, "\n\t\t");
+		} else {
+			fprintf(f, " ");
+		}
+
+		fprintf(f, "%u%s", a[i], i + 1 < n ? "," : "");
+	}
+
+	fprintf(f, "\n\t};\n");
+}
+
+/*
+ * All zones as one DFA: each zone's DFA is a disjoint part, entered at its
+ * own start state, and a zone is switched by which start state is taken
+ * for the next token. Per state, tok[] gives the token to return (EOF for
+ * a skip, UNKNOWN for a state which does not accept), and zto[] gives the
+ * zone to switch to. So skips and zone switches stay within the one loop.
+ */
+static int
+print_combined(FILE *f, const struct ast *ast)
+{
+	const struct ast_zone *z;
+	struct fsm *fsm;
+	unsigned *zstart, *tok, *zto;
+	unsigned nzones, ntokens;
+	int has_skips, has_to;
+	fsm_state_t i;
+	int r;
+
+	assert(f != NULL);
+	assert(ast != NULL);
+
+	{
+		const struct ast_token *t;
+
+		ntokens = 0;
+		for (t = ast->tl; t != NULL; t = t->next) {
+			ntokens++;
+		}
+
+		nzones = 0;
+		for (z = ast->zl; z != NULL; z = z->next) {
+			nzones++;
+		}
+	}
+
+	fsm = NULL;
+	tok = NULL;
+	zto = NULL;
+	r   = -1;
+
+	zstart = malloc(nzones * sizeof *zstart);
+	if (zstart == NULL) {
+		goto done;
+	}
+
+	for (z = ast->zl; z != NULL; z = z->next) {
+		fsm_state_t base, start;
+		struct fsm *q;
+
+		assert(z->fsm != NULL);
+		assert(fsm_all(z->fsm, fsm_isdfa));
+
+		if (!fsm_getstart(z->fsm, &start)) {
+			errno = EINVAL;
+			goto done;
+		}
+
+		q = fsm_clone(z->fsm);
+		if (q == NULL) {
+			goto done;
+		}
+
+		if (fsm == NULL) {
+			fsm  = q;
+			base = 0;
+		} else {
+			struct fsm *tmp;
+
+			tmp = fsm_mergeab(fsm, q, &base);
+			if (tmp == NULL) {
+				fsm_free(q);
+				goto done;
+			}
+
+			fsm = tmp;
+		}
+
+		zstart[zindexof(ast, z)] = base + start;
+	}
+
+	assert(fsm != NULL);
+
+	/* for make_ir(); which zone's start is arbitrary */
+	fsm_setstart(fsm, zstart[zindexof(ast, ast->global)]);
+
+	tok = malloc(fsm->statecount * sizeof *tok);
+	zto = malloc(fsm->statecount * sizeof *zto);
+	if (tok == NULL || zto == NULL) {
+		goto done;
+	}
+
+	has_skips = 0;
+	has_to    = 0;
+
+	for (i = 0; i < fsm->statecount; i++) {
+		const struct ast_mapping *m;
+
+		if (!fsm_isend(fsm, i)) {
+			tok[i] = ntokens + 2; /* UNKNOWN */
+			zto[i] = nzones;
+			continue;
+		}
+
+		m = fsm_getopaque(fsm, i);
+		assert(m != NULL);
+
+		if (m->token == NULL) {
+			tok[i] = ntokens; /* EOF */
+			has_skips = 1;
+		} else {
+			tok[i] = tokindexof(ast, m->token);
+		}
+
+		if (m->to == NULL) {
+			zto[i] = nzones;
+		} else {
+			zto[i] = zindexof(ast, m->to);
+			has_to = 1;
+		}
+	}
+
+	fprintf(f, "static enum %stoken\n", prefix.api);
+	fprintf(f, "zones(struct %slx *lx)\n", prefix.lx);
+	fprintf(f, "{\n");
+
+	if (opt.comments) {
+		fprintf(f, "\t/* start state per zone */\n");
+	}
+	print_array(f, "zstart", zstart, nzones);
+	if (opt.comments) {
+		fprintf(f, "\t/* per state: token, or %sEOF to skip, or %sUNKNOWN if not accepting */\n",
+			prefix.tok, prefix.tok);
+	}
+	print_array(f, "tok", tok, fsm->statecount);
+	if (has_to) {
+		if (opt.comments) {
+			fprintf(f, "\t/* per state: zone to switch to, or %u for none */\n", nzones);
+		}
+		print_array(f, "zto", zto, fsm->statecount);
+	}
+	fprintf(f, "\tint c;\n");
+	fprintf(f, "\n");
+
+	print_stateenum(f, fsm);
+	fprintf(f, "\n");
+
+	fprintf(f, "\tassert(lx != NULL);\n");
+	fprintf(f, "\tassert(lx->z < %u);\n", nzones);
+	fprintf(f, "\n");
+
+	if (has_skips) {
+		fprintf(f, "restart:\n");
+		fprintf(f, "\n");
+	}
+
+	print_begin(f);
+
+	fprintf(f, "\t\tif (state == NONE) {\n");
+	fprintf(f, "\t\t\tstate = zstart[lx->z];\n");
+	fprintf(f, "\t\t}\n");
+	fprintf(f, "\n");
+
+	if (-1 == print_frag(f, fsm, leaf_combined, NULL)) {
+		goto done;
+	}
+
+	if (-1 == print_push(f, fsm)) {
+		goto done;
+	}
+
+	fprintf(f, "\t}\n");
+	fprintf(f, "\n");
+
+	print_end(f);
+
+	fprintf(f, "\tif (state == NONE) {\n");
+	fprintf(f, "\t\treturn %sEOF;\n", prefix.tok);
+	fprintf(f, "\t}\n");
+	fprintf(f, "\n");
+	fprintf(f, "\tif (tok[state] == %sUNKNOWN) {\n", prefix.tok);
+	fprintf(f, "\t\terrno = EINVAL;\n");
+	fprintf(f, "\t\treturn %sERROR;\n", prefix.tok);
+	fprintf(f, "\t}\n");
+	fprintf(f, "\n");
+	fprintf(f, "\treturn (enum %stoken) tok[state];\n", prefix.api);
+	fprintf(f, "\n");
+
+	fprintf(f, "leaf:\n");
+	fprintf(f, "\n");
+	fprintf(f, "\tif (tok[state] == %sUNKNOWN) {\n", prefix.tok);
+	if (api_tokbuf & API_SPANBUF) {
+		fprintf(f, "\t\tlx->tok.e = lx->p;\n");
+	}
+	switch (opt.io) {
+	case FSM_IO_GETC:
+		fprintf(f, "\t\tlx->lgetc = NULL;\n");
+		break;
+
+	case FSM_IO_STR:
+		fprintf(f, "\t\tlx->p = NULL;\n");
+		break;
+
+	case FSM_IO_PAIR:
+		fprintf(f, "\t\tlx->p = NULL;\n");
+		break;
+	}
+	fprintf(f, "\t\treturn %sUNKNOWN;\n", prefix.tok);
+	fprintf(f, "\t}\n");
+	fprintf(f, "\n");
+
+	fprintf(f, "\t%sungetc(lx, c);\n", prefix.api);
+	if (api_tokbuf & API_SPANBUF) {
+		fprintf(f, "\tlx->tok.e = lx->p;\n");
+	}
+	fprintf(f, "\n");
+
+	if (has_to) {
+		fprintf(f, "\tif (zto[state] != %u) {\n", nzones);
+		fprintf(f, "\t\tlx->z = zto[state];\n");
+		fprintf(f, "\t}\n");
+		fprintf(f, "\n");
+	}
+
+	if (has_skips) {
+		fprintf(f, "\tif (tok[state] == %sEOF) {\n", prefix.tok);
+		fprintf(f, "\t\tgoto restart;\n");
+		fprintf(f, "\t}\n");
+		fprintf(f, "\n");
+	}
+
+	fprintf(f, "\treturn (enum %stoken) tok[state];\n", prefix.api);
+	fprintf(f, "}\n\n");
+
+	r = 0;
+
+done:
+
+	if (fsm != NULL) {
+		fsm_free(fsm);
+	}
+
+	free(zstart);
+	free(tok);
+	free(zto);
+
+	return r;
+}
+
 static void
 print_name(FILE *f, const struct ast *ast)
 {
@@ -872,16 +1241,22 @@ print_example(FILE *f, const struct ast *ast)
 	}
 
 	fprintf(f, "const char *\n");
-	fprintf(f, "%sexample(enum %stoken (*z)(struct %slx *), enum %stoken t)\n",
-		prefix.api, prefix.api, prefix.lx, prefix.api);
+	if (combine_zones) {
+		fprintf(f, "%sexample(unsigned z, enum %stoken t)\n",
+			prefix.api, prefix.api);
+	} else {
+		fprintf(f, "%sexample(enum %stoken (*z)(struct %slx *), enum %stoken t)\n",
+			prefix.api, prefix.api, prefix.lx, prefix.api);
+	}
 	fprintf(f, "{\n");
 
-	fprintf(f, "\tassert(z != NULL);\n");
-
-	fprintf(f, "\n");
+	if (!combine_zones) {
+		fprintf(f, "\tassert(z != NULL);\n");
+		fprintf(f, "\n");
+	}
 
 	for (z = ast->zl; z != NULL; z = z->next) {
-		fprintf(f, "\tif (z == z%u) {\n", zindexof(ast, z));
+		fprintf(f, "\tif (z == %s%u) {\n", combine_zones ? "" : "z", zindexof(ast, z));
 		fprintf(f, "\t\tswitch (t) {\n");
 
 		for (t = ast->tl; t != NULL; t = t->next) {
@@ -973,11 +1348,13 @@ lx_print_c(FILE *f, const struct ast *ast)
 	fprintf(f, "#include LX_HEADER\n");
 	fprintf(f, "\n");
 
-	for (z = ast->zl; z != NULL; z = z->next) {
-		print_proto(f, ast, z);
-	}
+	if (!combine_zones) {
+		for (z = ast->zl; z != NULL; z = z->next) {
+			print_proto(f, ast, z);
+		}
 
-	fprintf(f, "\n");
+		fprintf(f, "\n");
+	}
 
 	print_io(f);
 	print_lgetc(f);
@@ -988,17 +1365,27 @@ lx_print_c(FILE *f, const struct ast *ast)
 		zn = 0;
 	}
 
-	for (z = ast->zl; z != NULL; z = z->next) {
+	if (combine_zones) {
 		if (print_progress) {
-			if (important(zn)) {
-				fprintf(stderr, " z%u", zn);
-			}
-			zn++;
+			fprintf(stderr, " zones");
 		}
 
-		if (-1 == print_zone(f, ast, z)) {
+		if (-1 == print_combined(f, ast)) {
 			return; /* XXX: handle error */
 		}
+	} else {
+		for (z = ast->zl; z != NULL; z = z->next) {
+			if (print_progress) {
+				if (important(zn)) {
+					fprintf(stderr, " z%u", zn);
+				}
+				zn++;
+			}
+
+			if (-1 == print_zone(f, ast, z)) {
+				return; /* XXX: handle error */
+			}
+		}
 	}
 
 	if (~api_exclude & API_NAME) {
@@ -1034,7 +1421,7 @@ lx_print_c(FILE *f, const struct ast *ast)
 			break;
 		}
 
-		fprintf(f, "\tlx->z = z%u;\n", zindexof(ast, ast->global));
+		fprintf(f, "\tlx->z = %s%u;\n", combine_zones ? "" : "z", zindexof(ast, ast->global));
 		if (~api_exclude & API_POS) {
 			fprintf(f, "\n");
 			fprintf(f, "\tlx->end.byte = 0;\n");
@@ -1053,7 +1440,9 @@ lx_print_c(FILE *f, const struct ast *ast)
 		fprintf(f, "\tenum %stoken t;\n", prefix.api);
 		fprintf(f, "\n");
 		fprintf(f, "\tassert(lx != NULL);\n");
-		fprintf(f, "\tassert(lx->z != NULL);\n");
+		if (!combine_zones) {
+			fprintf(f, "\tassert(lx->z != NULL);\n");
+		}
 		fprintf(f, "\n");
 
 		switch (opt.io) {
@@ -1075,7 +1464,7 @@ lx_print_c(FILE *f, const struct ast *ast)
 		fprintf(f, "\t}\n");
 		fprintf(f, "\n");
 
-		fprintf(f, "\tt = lx->z(lx);\n");
+		fprintf(f, "\tt = %s(lx);\n", combine_zones ? "zones" : "lx->z");
 		fprintf(f, "\n");
 
 		if (~api_exclude & API_BUF) {
@@ -1100,7 +1489,9 @@ lx_print_c(FILE *f, const struct ast *ast)
 		fprintf(f, "{\n");
 		fprintf(f, "\tassert(lx != NULL);\n");
 		fprintf(f, "\tassert(p != NULL);\n");
-		fprintf(f, "\tlx->end.col = 1;\n");
+		if (~api_exclude & API_POS) {
+			fprintf(f, "\tlx->end.col = 1;\n");
+		}
 		fprintf(f, "\tlx->p = p;\n");
 		fprintf(f, "}\n");
         }
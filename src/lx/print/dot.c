@@ -21,26 +21,6 @@
 
 static unsigned int anonymous_states = 1;
 
-/* TODO: centralise */
-static unsigned int
-zindexof(const struct ast *ast, const struct ast_zone *zone)
-{
-	struct ast_zone *z;
-	unsigned int i;
-
-	assert(ast != NULL);
-	assert(zone != NULL);
-
-	for (z = ast->zl, i = 0; z != NULL; z = z->next, i++) {
-		if (z == zone) {
-			return i;
-		}
-	}
-
-	assert(!"unreached");
-	return 0;
-}
-
 static void
 mapping(FILE *f, const struct ast_mapping *m, const struct ast *ast)
 {
@@ -86,14 +66,14 @@ endleaf_dot(FILE *f, const void *state_opaque, const void *endleaf_opaque)
 #endif
 
 	if (m->conflict != NULL) {
-		const struct mapping_set *p;
+		size_t i;
 
 		fprintf(f, "<font color=\"red\">");
 
-		for (p = m->conflict; p != NULL; p = p->next) {
-			mapping(f, p->m, ast);
+		for (i = 0; i < m->conflict->n; i++) {
+			mapping(f, m->conflict->a[i], ast);
 
-			if (p->next != NULL) {
+			if (i + 1 < m->conflict->n) {
 				fprintf(f, "<br/>");
 			}
 		}
@@ -127,17 +107,19 @@ singlestate(FILE *f, const struct fsm *fsm, const struct ast *ast,
 	assert(m != NULL);
 
 	if (m->conflict != NULL) {
-		const struct mapping_set *p;
+		size_t i;
+
+		for (i = 0; i < m->conflict->n; i++) {
+			const struct ast_mapping *p = m->conflict->a[i];
 
-		for (p = m->conflict; p != NULL; p = p->next) {
-			if (p->m->to != NULL) {
+			if (p->to != NULL) {
 				fsm_state_t start;
 
-				(void) fsm_getstart(p->m->to->fsm, &start);
+				(void) fsm_getstart(p->to->fsm, &start);
 
 				fprintf(f, "\tz%uS%u -> z%uS%u [ color = red, style = dashed ];\n",
 					zindexof(ast, z), s,
-					zindexof(ast, p->m->to), start);
+					zindexof(ast, p->to), start);
 			}
 		}
 	} else {
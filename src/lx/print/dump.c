@@ -216,6 +216,10 @@ print_dump(FILE *f)
 		fprintf(f, "\tlx.free       = NULL;\n");
 		fprintf(f, "\n");
 		break;
+
+	case API_SPANBUF:
+		/* the span is in lx.tok, with no buffer to set up */
+		break;
 	}
 
 	fprintf(f, "\tdo {\n");
@@ -239,6 +243,12 @@ print_dump(FILE *f)
 		fprintf(f, "\n");
 		break;
 
+	case API_SPANBUF:
+		fprintf(f, "\t\tl = lx.tok.e - lx.tok.p;\n");
+		fprintf(f, "\t\tq = lx.tok.p;\n");
+		fprintf(f, "\n");
+		break;
+
 	default:
 		fprintf(f, "\t\tl = 0;\n");
 		fprintf(f, "\t\tq = NULL;\n");
@@ -71,6 +71,18 @@ lx_print_h(FILE *f, const struct ast *ast)
 		fprintf(f, "\n");
 	}
 
+	if (api_tokbuf & API_SPANBUF) {
+		fprintf(f, "/*\n");
+		fprintf(f, " * The current token's text, in place in the input.\n");
+		fprintf(f, " * .e is one past the end.\n");
+		fprintf(f, " */\n");
+		fprintf(f, "struct lx_span {\n");
+		fprintf(f, "\tconst char *p;\n");
+		fprintf(f, "\tconst char *e;\n");
+		fprintf(f, "};\n");
+		fprintf(f, "\n");
+	}
+
 	fprintf(f, "struct %slx {\n", prefix.lx);
 
 	switch (opt.io) {
@@ -99,6 +111,10 @@ lx_print_h(FILE *f, const struct ast *ast)
 		fprintf(f, "\tstruct lx_pos end;\n");
 		fprintf(f, "\n");
 	}
+	if (api_tokbuf & API_SPANBUF) {
+		fprintf(f, "\tstruct lx_span tok;\n");
+		fprintf(f, "\n");
+	}
 	if (~api_exclude & API_BUF) {
 		fprintf(f, "\tvoid *buf_opaque;\n");
 		fprintf(f, "\tint  (*push) (void *buf_opaque, char c);\n");
@@ -107,7 +123,11 @@ lx_print_h(FILE *f, const struct ast *ast)
 		fprintf(f, "\n");
 	}
 
-	fprintf(f, "\tenum %stoken (*z)(struct %slx *lx);\n", prefix.api, prefix.lx);
+	if (combine_zones) {
+		fprintf(f, "\tunsigned z; /* current zone */\n");
+	} else {
+		fprintf(f, "\tenum %stoken (*z)(struct %slx *lx);\n", prefix.api, prefix.lx);
+	}
 
 	fprintf(f, "};\n");
 	fprintf(f, "\n");
@@ -194,7 +214,10 @@ lx_print_h(FILE *f, const struct ast *ast)
 	if (~api_exclude & API_NAME) {
 		fprintf(f, "const char *%sname(enum %stoken t);\n", prefix.api, prefix.api);
 	}
-	if (~api_exclude & API_EXAMPLE) {
+	if ((~api_exclude & API_EXAMPLE) && combine_zones) {
+		fprintf(f, "const char *%sexample(unsigned z, enum %stoken t);\n",
+			prefix.api, prefix.api);
+	} else if (~api_exclude & API_EXAMPLE) {
 		fprintf(f, "const char *%sexample(enum %stoken (*z)(struct %slx *), enum %stoken t);\n",
 			prefix.api, prefix.api, prefix.lx, prefix.api);
 	}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <ctype.h>
+
+#include <fsm/fsm.h>
+#include <fsm/lexer.h>
+
+#include "lx/ast.h"
+#include "lx/print.h"
+
+static void
+end(const struct fsm *fsm, fsm_state_t state,
+	unsigned *token, unsigned *zone, void *opaque)
+{
+	const struct ast_mapping *m;
+	const struct ast *ast;
+
+	assert(fsm != NULL);
+	assert(token != NULL);
+	assert(zone != NULL);
+	assert(opaque != NULL);
+
+	ast = opaque;
+
+	m = fsm_getopaque(fsm, state);
+	assert(m != NULL);
+
+	if (m->token != NULL) {
+		*token = tokindexof(ast, m->token);
+	}
+
+	if (m->to != NULL) {
+		*zone = zindexof(ast, m->to);
+	}
+}
+
+/* as for esctok(), so names are as given by lx_name() */
+static char *
+tokname(const char *s)
+{
+	char *p, *q;
+
+	p = malloc(strlen(s) + 1);
+	if (p == NULL) {
+		return NULL;
+	}
+
+	for (q = p; *s != '\0'; s++) {
+		*q++ = isalnum((unsigned char) *s) ? toupper((unsigned char) *s) : '_';
+	}
+
+	*q = '\0';
+
+	return p;
+}
+
+void
+lx_print_vm(FILE *f, const struct ast *ast)
+{
+	const struct ast_zone *z;
+	const struct ast_token *t;
+	const struct fsm **zone;
+	char **name;
+	unsigned nzones, ntokens;
+	unsigned i;
+
+	assert(f != NULL);
+	assert(ast != NULL);
+
+	nzones = 0;
+	for (z = ast->zl; z != NULL; z = z->next) {
+		nzones++;
+	}
+
+	ntokens = 0;
+	for (t = ast->tl; t != NULL; t = t->next) {
+		ntokens++;
+	}
+
+	zone = malloc(nzones * sizeof *zone);
+	name = calloc(ntokens + 1, sizeof *name);
+	if (zone == NULL || name == NULL) {
+		perror("malloc");
+		goto done;
+	}
+
+	for (z = ast->zl, i = 0; z != NULL; z = z->next, i++) {
+		assert(z->fsm != NULL);
+		zone[i] = z->fsm;
+	}
+
+	for (t = ast->tl, i = 0; t != NULL; t = t->next, i++) {
+		name[i] = tokname(t->s);
+		if (name[i] == NULL) {
+			perror("malloc");
+			goto done;
+		}
+	}
+
+	if (!fsm_lexer_write(f, zone, nzones, zindexof(ast, ast->global),
+		(const char *const *) name, ntokens, end, (void *) ast)) {
+		perror("fsm_lexer_write");
+		goto done;
+	}
+
+done:
+
+	if (name != NULL) {
+		for (i = 0; i < ntokens; i++) {
+			free(name[i]);
+		}
+	}
+
+	free(name);
+	free(zone);
+}
+
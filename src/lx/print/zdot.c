@@ -20,26 +20,6 @@
 #include "lx/ast.h"
 #include "lx/print.h"
 
-/* TODO: centralise */
-static unsigned int
-zindexof(const struct ast *ast, const struct ast_zone *zone)
-{
-	struct ast_zone *z;
-	unsigned int i;
-
-	assert(ast != NULL);
-	assert(zone != NULL);
-
-	for (z = ast->zl, i = 0; z != NULL; z = z->next, i++) {
-		if (z == zone) {
-			return i;
-		}
-	}
-
-	assert(!"unreached");
-	return 0;
-}
-
 static void
 print_zone(FILE *f, const struct ast *ast, const struct ast_zone *z)
 {
@@ -0,0 +1,364 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <pthread.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/parallel.h>
+
+#include "grep.h"
+
+struct job {
+	const char *path;
+	char *out;
+	size_t outlen;
+	int r;
+	int done;
+};
+
+struct pool {
+	const struct grep *g;
+	struct job *jobs;
+	size_t n;
+	size_t next;
+
+	pthread_mutex_t mu;
+	pthread_cond_t cv;
+};
+
+/* for files which can't be mapped, e.g. pipes */
+static char *
+slurp(int fd, size_t *len)
+{
+	char *buf, *tmp;
+	size_t size;
+	ssize_t r;
+
+	buf  = NULL;
+	size = 0;
+	*len = 0;
+
+	for (;;) {
+		if (*len == size) {
+			size = size == 0 ? 65536 : size * 2;
+
+			tmp = realloc(buf, size);
+			if (tmp == NULL) {
+				free(buf);
+				return NULL;
+			}
+
+			buf = tmp;
+		}
+
+		r = read(fd, buf + *len, size - *len);
+		if (r == -1 && errno == EINTR) {
+			continue;
+		}
+
+		if (r == -1) {
+			free(buf);
+			return NULL;
+		}
+
+		if (r == 0) {
+			return buf;
+		}
+
+		*len += r;
+	}
+}
+
+struct lines {
+	const struct grep *g;
+	FILE *f;
+	const char *path;
+	size_t count;
+};
+
+static int
+line(const char *s, size_t len, size_t lineno, fsm_state_t end, void *opaque)
+{
+	struct lines *l = opaque;
+
+	assert(l != NULL);
+
+	(void) lineno;
+
+	l->count++;
+
+	if (l->g->count) {
+		return 1;
+	}
+
+	if (l->g->names) {
+		fprintf(l->f, "%s:", l->path);
+	}
+
+	if (l->g->patterns != NULL) {
+		l->g->patterns(l->f, l->g->fsm, end);
+	}
+
+	fwrite(s, 1, len, l->f);
+	putc('\n', l->f);
+
+	return 1;
+}
+
+static int
+grep_buf(const struct grep *g, FILE *f, const char *path,
+	const char *buf, size_t len)
+{
+	struct lines l;
+
+	l.g     = g;
+	l.f     = f;
+	l.path  = path;
+	l.count = 0;
+
+	(void) fsm_parallel_match_lines(g->p, buf, len, &l, line);
+
+	if (g->count) {
+		if (g->names) {
+			fprintf(f, "%s:", path);
+		}
+
+		fprintf(f, "%lu\n", (unsigned long) l.count);
+	}
+
+	return l.count > 0;
+}
+
+static int
+grep_file(const struct grep *g, FILE *f, const char *path)
+{
+	struct stat st;
+	char *buf;
+	void *map;
+	size_t len;
+	int fd, r;
+
+	/* a duplicate, so that stdin is closed no differently to a file */
+	if (0 == strcmp(path, "-")) {
+		path = "(standard input)";
+		fd = dup(STDIN_FILENO);
+	} else {
+		fd = open(path, O_RDONLY);
+	}
+
+	if (fd == -1) {
+		perror(path);
+		return -1;
+	}
+
+	if (fstat(fd, &st) == -1) {
+		perror(path);
+		close(fd);
+		return -1;
+	}
+
+	map = MAP_FAILED;
+
+	if (S_ISREG(st.st_mode) && st.st_size > 0) {
+		map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	}
+
+	if (map != MAP_FAILED) {
+		close(fd);
+
+		r = grep_buf(g, f, path, map, st.st_size);
+
+		munmap(map, st.st_size);
+
+		return r;
+	}
+
+	buf = slurp(fd, &len);
+	if (buf == NULL) {
+		perror(path);
+		close(fd);
+		return -1;
+	}
+
+	close(fd);
+
+	r = grep_buf(g, f, path, buf, len);
+
+	free(buf);
+
+	return r;
+}
+
+static void *
+worker(void *opaque)
+{
+	struct pool *pool = opaque;
+	struct job *job;
+	FILE *f;
+
+	for (;;) {
+		pthread_mutex_lock(&pool->mu);
+		job = pool->next < pool->n ? &pool->jobs[pool->next++] : NULL;
+		pthread_mutex_unlock(&pool->mu);
+
+		if (job == NULL) {
+			return NULL;
+		}
+
+		/* output is held until the files before it are printed */
+		f = open_memstream(&job->out, &job->outlen);
+		if (f == NULL) {
+			perror("open_memstream");
+			job->r = -1;
+		} else {
+			job->r = grep_file(pool->g, f, job->path);
+
+			if (fclose(f) != 0) {
+				perror("fclose");
+				job->r = -1;
+			}
+		}
+
+		pthread_mutex_lock(&pool->mu);
+		job->done = 1;
+		pthread_cond_broadcast(&pool->cv);
+		pthread_mutex_unlock(&pool->mu);
+	}
+}
+
+static unsigned
+online(void)
+{
+#ifdef _SC_NPROCESSORS_ONLN
+	long n;
+
+	n = sysconf(_SC_NPROCESSORS_ONLN);
+	if (n > 0) {
+		return n;
+	}
+#endif
+
+	return 1;
+}
+
+int
+grep_files(const struct grep *g, char *const files[], size_t n,
+	unsigned nthreads)
+{
+	struct pool pool;
+	pthread_t *tid;
+	size_t i, t;
+	int r;
+
+	assert(g != NULL);
+	assert(g->p != NULL);
+	assert(files != NULL || n == 0);
+
+	r = 0;
+
+	if (nthreads == 0) {
+		nthreads = online();
+	}
+
+	if (nthreads > n) {
+		nthreads = n;
+	}
+
+	tid = NULL;
+	t = 0;
+
+	if (nthreads > 1) {
+		pool.g    = g;
+		pool.n    = n;
+		pool.next = 0;
+
+		pool.jobs = calloc(n, sizeof *pool.jobs);
+		tid = malloc(nthreads * sizeof *tid);
+		if (pool.jobs == NULL || tid == NULL) {
+			free(pool.jobs);
+			free(tid);
+			return -1;
+		}
+
+		for (i = 0; i < n; i++) {
+			pool.jobs[i].path = files[i];
+		}
+
+		pthread_mutex_init(&pool.mu, NULL);
+		pthread_cond_init(&pool.cv, NULL);
+
+		for (t = 0; t < nthreads; t++) {
+			if (0 != pthread_create(&tid[t], NULL, worker, &pool)) {
+				break;
+			}
+		}
+
+		if (t == 0) {
+			pthread_mutex_destroy(&pool.mu);
+			pthread_cond_destroy(&pool.cv);
+			free(pool.jobs);
+			free(tid);
+		}
+	}
+
+	/* no threads; match each file in turn */
+	if (t == 0) {
+		for (i = 0; i < n; i++) {
+			switch (grep_file(g, stdout, files[i])) {
+			case -1: r = -1; break;
+			case  1: if (r == 0) { r = 1; } break;
+			}
+		}
+
+		return r;
+	}
+
+	for (i = 0; i < n; i++) {
+		struct job *job = &pool.jobs[i];
+
+		pthread_mutex_lock(&pool.mu);
+		while (!job->done) {
+			pthread_cond_wait(&pool.cv, &pool.mu);
+		}
+		pthread_mutex_unlock(&pool.mu);
+
+		if (job->out != NULL) {
+			fwrite(job->out, 1, job->outlen, stdout);
+			free(job->out);
+		}
+
+		switch (job->r) {
+		case -1: r = -1; break;
+		case  1: if (r == 0) { r = 1; } break;
+		}
+	}
+
+	while (t-- > 0) {
+		pthread_join(tid[t], NULL);
+	}
+
+	pthread_mutex_destroy(&pool.mu);
+	pthread_cond_destroy(&pool.cv);
+	free(pool.jobs);
+	free(tid);
+
+	return r;
+}
+
@@ -0,0 +1,38 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#ifndef RE_GREP_H
+#define RE_GREP_H
+
+#include <stdio.h>
+
+struct fsm;
+struct fsm_parallel;
+
+struct grep {
+	const struct fsm *fsm;
+	const struct fsm_parallel *p; /* by fsm_parallel_compile_lines() */
+
+	int count; /* print a count of matching lines per file, rather than the lines */
+	int names; /* prefix output by filename */
+
+	/* print the patterns for an end state, or NULL */
+	void (*patterns)(FILE *f, const struct fsm *fsm, fsm_state_t s);
+};
+
+/*
+ * Match each line of each file, where "-" is stdin. Files are shared
+ * across nthreads threads, or if nthreads is 0, as many as there are
+ * processors online. Output is in order of the files given regardless.
+ *
+ * Returns 1 if any line matched, 0 if none did, or -1 on error.
+ */
+int
+grep_files(const struct grep *g, char *const files[], size_t n,
+	unsigned nthreads);
+
+#endif
+
@@ -13,6 +13,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h> /* XXX: for ast.h */
+#include <limits.h>
 #include <stdio.h>
 #include <ctype.h>
 
@@ -22,6 +23,7 @@
 #include <fsm/print.h>
 #include <fsm/options.h>
 #include <fsm/vm.h>
+#include <fsm/parallel.h>
 
 #include <re/re.h>
 
@@ -30,6 +32,8 @@
 #include "libre/class.h" /* XXX */
 #include "libre/ast.h" /* XXX */
 
+#include "grep.h"
+
 
 #define DEBUG_ESCAPES     0
 #define DEBUG_VM_FSM      0
@@ -55,7 +59,8 @@ usage(void)
 {
 	fprintf(stderr, "usage: re    [-r <dialect>] [-nbiusyz] [-x] <re> ... [ <text> | -- <text> ... ]\n");
 	fprintf(stderr, "       re    [-r <dialect>] [-nbiusyz] {-q <query>} <re> ...\n");
-	fprintf(stderr, "       re -p [-r <dialect>] [-nbiusyz] [-l <language>] [-acwX] [-k <io>] [-e <prefix>] <re> ...\n");
+	fprintf(stderr, "       re {-g|-G} [-j <threads>] [-r <dialect>] [-biusyz] <re> ... [ <file> | -- <file> ... ]\n");
+	fprintf(stderr, "       re -p [-r <dialect>] [-nbiusyz] [-l <language>] [-acwX] [-k <io>] [-T <ctable>] [-S <parts>] [-e <prefix>] [-P <file>] <re> ...\n");
 	fprintf(stderr, "       re -m [-r <dialect>] [-nbiusyz] <re> ...\n");
 	fprintf(stderr, "       re -h\n");
 }
@@ -93,6 +98,57 @@ io(const char *name)
 	exit(EXIT_FAILURE);
 }
 
+static enum fsm_ctable
+ctable(const char *name)
+{
+	size_t i;
+
+	struct {
+		const char *name;
+		enum fsm_ctable ctable;
+	} a[] = {
+		{ "auto",   FSM_CTABLE_AUTO   },
+		{ "never",  FSM_CTABLE_NEVER  },
+		{ "always", FSM_CTABLE_ALWAYS }
+	};
+
+	assert(name != NULL);
+
+	for (i = 0; i < sizeof a / sizeof *a; i++) {
+		if (0 == strcmp(a[i].name, name)) {
+			return a[i].ctable;
+		}
+	}
+
+	fprintf(stderr, "unrecognised table mode; valid modes are: ");
+
+	for (i = 0; i < sizeof a / sizeof *a; i++) {
+		fprintf(stderr, "%s%s",
+			a[i].name,
+			i + 1 < sizeof a / sizeof *a ? ", " : "\n");
+	}
+
+	exit(EXIT_FAILURE);
+}
+
+static unsigned
+parts(const char *s)
+{
+	unsigned long n;
+	char *e;
+
+	assert(s != NULL);
+
+	errno = 0;
+	n = strtoul(s, &e, 10);
+	if (*s == '\0' || *e != '\0' || errno != 0 || n > UINT_MAX) {
+		fprintf(stderr, "-S: invalid number of parts\n");
+		exit(EXIT_FAILURE);
+	}
+
+	return n;
+}
+
 static void
 print_name(const char *name,
 	fsm_print **print_fsm, ast_print **print_ast)
@@ -249,6 +305,78 @@ xopen(const char *s)
 	return f;
 }
 
+/*
+ * Profile the DFA against sample texts, one per line.
+ */
+static struct fsm_vm_profile *
+profile(const struct fsm *fsm, const char *file)
+{
+	struct fsm_vm_profile *p;
+	char *buf;
+	size_t n, len;
+	FILE *f;
+	int c;
+
+	p = fsm_vm_profile_new(fsm);
+	if (p == NULL) {
+		perror("fsm_vm_profile_new");
+		exit(EXIT_FAILURE);
+	}
+
+	f = xopen(file);
+
+	buf = NULL;
+	len = 0;
+	n   = 0;
+
+	do {
+		c = getc(f);
+
+		if (c != EOF && c != '\n') {
+			if (n == len) {
+				char *tmp;
+
+				len = (len == 0) ? 128 : len * 2;
+
+				tmp = realloc(buf, len);
+				if (tmp == NULL) {
+					perror("realloc");
+					exit(EXIT_FAILURE);
+				}
+
+				buf = tmp;
+			}
+
+			buf[n++] = c;
+			continue;
+		}
+
+		if (c == EOF && n == 0) {
+			break;
+		}
+
+		if (-1 == fsm_vm_profile_buffer(p, fsm, buf, n)) {
+			perror("fsm_vm_profile_buffer");
+			exit(EXIT_FAILURE);
+		}
+
+		n = 0;
+	} while (c != EOF);
+
+	if (ferror(f)) {
+		perror(file);
+		exit(EXIT_FAILURE);
+	}
+
+	if (f != stdin) {
+		fclose(f);
+	}
+
+	free(buf);
+
+	return p;
+}
+
 static struct match *
 addmatch(struct match **head, int i, const char *s)
 {
@@ -476,6 +604,24 @@ endleaf_json(FILE *f, const void *state_opaque, const void *endleaf_opaque)
 	return 0;
 }
 
+static void
+grep_patterns(FILE *f, const struct fsm *fsm, fsm_state_t state)
+{
+	const struct match *m;
+
+	assert(fsm_getopaque(fsm, state) != NULL);
+
+	for (m = fsm_getopaque(fsm, state); m != NULL; m = m->next) {
+		/* TODO: print nicely */
+		fprintf(f, "/%s/", m->s);
+		if (m->next != NULL) {
+			fprintf(f, ", ");
+		}
+	}
+
+	fprintf(f, ": ");
+}
+
 int
 main(int argc, char *argv[])
 {
@@ -492,8 +638,12 @@ main(int argc, char *argv[])
 	int patterns;
 	int ambig;
 	int makevm;
+	int grep, count;
+	const char *threads;
+	const char *pfile;
 
 	struct fsm_dfavm *vm;
+	struct fsm_vm_profile *prof;
 
 	/* note these defaults are the opposite than for fsm(1) */
 	opt.anonymous_states  = 1;
@@ -510,17 +660,22 @@ main(int argc, char *argv[])
 	patterns  = 0;
 	ambig     = 0;
 	makevm    = 0;
+	grep      = 0;
+	count     = 0;
+	threads   = NULL;
 	print_fsm = NULL;
 	print_ast = NULL;
 	query     = NULL;
 	join      = fsm_union;
 	dialect   = RE_NATIVE;
 	vm        = NULL;
+	pfile     = NULL;
+	prof      = NULL;
 
 	{
 		int c;
 
-		while (c = getopt(argc, argv, "h" "acwXe:k:" "bi" "sq:r:l:" "upMmnxyz"), c != -1) {
+		while (c = getopt(argc, argv, "h" "acwXe:k:T:S:P:" "bi" "sq:r:l:" "upMmnxyz" "gGj:"), c != -1) {
 			switch (c) {
 			case 'a': opt.anonymous_states  = 0;          break;
 			case 'c': opt.consolidate_edges = 0;          break;
@@ -528,6 +683,9 @@ main(int argc, char *argv[])
 			case 'X': opt.always_hex        = 1;          break;
 			case 'e': opt.prefix            = optarg;     break;
 			case 'k': opt.io                = io(optarg); break;
+			case 'T': opt.ctable            = ctable(optarg); break;
+			case 'S': opt.parts             = parts(optarg);  break;
+			case 'P': pfile                 = optarg;     break;
 
 			case 'b': flags |= RE_ANCHORED; break;
 			case 'i': flags |= RE_ICASE;    break;
@@ -552,6 +710,10 @@ main(int argc, char *argv[])
 			case 'z': patterns = 1; break;
 			case 'M': makevm   = 1; break;
 
+			case 'g': grep = 1;            break;
+			case 'G': grep = 1; count = 1; break;
+			case 'j': threads = optarg;    break;
+
 			case 'h':
 				usage();
 				return EXIT_SUCCESS;
@@ -582,6 +744,21 @@ main(int argc, char *argv[])
 		return EXIT_FAILURE;
 	}
 
+	if (!!print_fsm + !!print_ast + example + !!query && grep) {
+		fprintf(stderr, "-g applies only when executing\n");
+		return EXIT_FAILURE;
+	}
+
+	if (threads != NULL && !grep) {
+		fprintf(stderr, "-j applies only for -g\n");
+		return EXIT_FAILURE;
+	}
+
+	if (makevm && grep) {
+		fprintf(stderr, "-M cannot be used with -g\n");
+		return EXIT_FAILURE;
+	}
+
 	if (makevm && (keep_nfa || example || query)) {
 		fprintf(stderr, "-M cannot be used with -m, -q, or -n\n");
 		return EXIT_FAILURE;
@@ -601,6 +778,11 @@ main(int argc, char *argv[])
 		keep_nfa = 0;
 	}
 
+	if (pfile != NULL && (keep_nfa || example || query || print_ast != NULL)) {
+		fprintf(stderr, "-P applies only when compiling to a DFA\n");
+		return EXIT_FAILURE;
+	}
+
 	if (keep_nfa) {
 		ambig = 1;
 	}
@@ -681,11 +863,7 @@ main(int argc, char *argv[])
 
 				fclose(f);
 			} else {
-				const char *s;
-
-				s = argv[i];
-
-				new = re_comp(dialect, fsm_sgetc, &s, &opt, flags, &err);
+				new = re_comp_buf(dialect, argv[i], strlen(argv[i]), &opt, flags, &err);
 			}
 
 			if (new == NULL) {
@@ -864,6 +1042,11 @@ main(int argc, char *argv[])
 
 		opt.carryopaque = NULL;
 
+		if (pfile != NULL) {
+			prof = profile(fsm, pfile);
+			opt.vm_profile = prof;
+		}
+
 		if (makevm) {
 			vm = fsm_vm_compile(fsm);
 		}
@@ -923,9 +1106,63 @@ main(int argc, char *argv[])
 			fsm_vm_free(vm);
 		}
 
+		fsm_vm_profile_free(prof);
+
 		return 0;
 	}
 
+	if (grep) {
+		static char stdin_name[] = "-";
+		static char *stdin_files[] = { stdin_name };
+		struct fsm_parallel *p;
+		struct grep g;
+		unsigned long n;
+		char *e;
+		int r;
+
+		n = 1;
+
+		/* like grep(1), no files means stdin */
+		if (argc == 0) {
+			argv = stdin_files;
+			argc = 1;
+		}
+
+		if (threads != NULL) {
+			errno = 0;
+			n = strtoul(threads, &e, 10);
+			if (*threads == '\0' || *e != '\0' || errno != 0 || n > UINT_MAX) {
+				fprintf(stderr, "-j: invalid number of threads\n");
+				return EXIT_FAILURE;
+			}
+		}
+
+		p = fsm_parallel_compile_lines(fsm);
+		if (p == NULL) {
+			perror("fsm_parallel_compile_lines");
+			return EXIT_FAILURE;
+		}
+
+		g.fsm      = fsm;
+		g.p        = p;
+		g.count    = count;
+		g.names    = argc > 1;
+		g.patterns = patterns ? grep_patterns : NULL;
+
+		/* like grep(1), success if any line matched */
+		r = grep_files(&g, argv, argc, n);
+
+		fsm_parallel_free(p);
+
+		/* XXX: free opaques */
+
+		fsm_free(fsm);
+
+		fsm_vm_profile_free(prof);
+
+		return r == 1 ? EXIT_SUCCESS : EXIT_FAILURE;
+	}
+
 	/* execute */
 	{
 		int r;
@@ -935,7 +1172,7 @@ main(int argc, char *argv[])
 		if (argc > 0) {
 			int i;
 
-			/* TODO: option to print input texts which match. like grep(1) does.
+			/* Printing input texts which match, like grep(1) does, is by -g.
 			 * This is not the same as printing patterns which match (by associating
 			 * a pattern to the end state), like lx(1) does */
 
@@ -993,6 +1230,8 @@ main(int argc, char *argv[])
 			fsm_vm_free(vm);
 		}
 
+		fsm_vm_profile_free(prof);
+
 		return r;
 	}
 }
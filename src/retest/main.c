@@ -50,7 +50,7 @@ struct match {
 };
 
 static struct fsm_options opt;
-static struct fsm_vm_compile_opts vm_opts = { 0, FSM_VM_COMPILE_VM_V1, NULL };
+static struct fsm_vm_compile_opts vm_opts = { 0, FSM_VM_COMPILE_VM_V1, NULL, NULL };
 
 static void
 usage(void)
@@ -75,12 +75,14 @@ usage(void)
 	fprintf(stderr, "                 asm       generate assembly and assemble\n");
 	fprintf(stderr, "                 c         compile as per fsm_print_c()\n");
 	fprintf(stderr, "                 vmc       compile as per fsm_print_vmc()\n");
+	fprintf(stderr, "                 rust      compile as per fsm_print_rust()\n");
 
 	fprintf(stderr, "\n");
 	fprintf(stderr, "        -x <encoding>\n");
 	fprintf(stderr, "             sets encoding type:\n");
 	fprintf(stderr, "                 v1        version 0.1 variable length encoding\n");
 	fprintf(stderr, "                 v2        version 0.2 fixed length encoding\n");
+	fprintf(stderr, "                 amd64     native code, compiled in memory\n");
 }
 
 static enum re_dialect
@@ -415,6 +417,9 @@ single_error_record_print(FILE *f, const struct single_error_record *err)
 	case ERROR_DETERMINISING:
 		fprintf(f, "error determinising regexp /%s/\n", err->regexp);
 		break;
+	case ERROR_MINIMISING:
+		fprintf(f, "error minimising regexp /%s/\n", err->regexp);
+		break;
 	case ERROR_COMPILING_BYTECODE:
 		fprintf(f, "error compiling regexp /%s/\n", err->regexp);
 		break;
@@ -577,7 +582,6 @@ process_test_file(const char *fname, enum re_dialect dialect, enum implementatio
 				continue;
 			}
 
-			/* XXX - minimize or determinize? */
 			if (!fsm_determinise(fsm)) {
 				fprintf(stderr, "line %d: error determinising /%s/: %s\n", linenum, regexp, strerror(errno));
 
@@ -592,6 +596,22 @@ process_test_file(const char *fname, enum re_dialect dialect, enum implementatio
 				continue;
 			}
 
+			/*
+			 * Minimised as for re -p, which also trims the dead state.
+			 * Otherwise every state has a transition to it, and the
+			 * generated code never compares strings by MATCHS.
+			 */
+			if (!fsm_minimise(fsm)) {
+				fprintf(stderr, "line %d: error minimising /%s/: %s\n", linenum, regexp, strerror(errno));
+
+				/* ignore errors */
+				error_record_add(erec,
+					ERROR_MINIMISING, fname, regexp, NULL, linenum);
+
+				num_re_errors++;
+				continue;
+			}
+
 #if DEBUG_VM_FSM
 			fprintf(stderr, "FSM:\n");
 			fsm_print_fsm(stderr, fsm);
@@ -698,15 +718,13 @@ process_test_file(const char *fname, enum re_dialect dialect, enum implementatio
 		impl_ready = false;
 	}
 
-	fclose(f);
-
 	if (ferror(f)) {
 		fprintf(stderr, "line %d: error reading %s: %s\n", linenum, fname, strerror(errno));
-		if (regexp != NULL) {
-			num_errors++;
-		}
+		num_errors++;
 	}
 
+	fclose(f);
+
 finish:
 	printf("%s: %d regexps, %d test cases\n", fname, num_regexps, num_test_cases);
 	printf("%s: %d re errors, %d errors\n", fname, num_re_errors, num_errors);
@@ -769,6 +787,8 @@ main(int argc, char *argv[])
 					impl = IMPL_VMASM;
 				} else if (strcmp(optarg, "vmc") == 0) {
 					impl = IMPL_VMC;
+				} else if (strcmp(optarg, "rust") == 0) {
+					impl = IMPL_RUST;
 				} else {
 					fprintf(stderr, "unknown argument to -l: %s\n", optarg);
 					usage();
@@ -781,6 +801,8 @@ main(int argc, char *argv[])
 					vm_opts.output = FSM_VM_COMPILE_VM_V1;
 				} else if (strcmp(optarg, "v2") == 0) {
 					vm_opts.output = FSM_VM_COMPILE_VM_V2;
+				} else if (strcmp(optarg, "amd64") == 0) {
+					vm_opts.output = FSM_VM_COMPILE_AMD64;
 				} else {
 					fprintf(stderr, "unknown argument to -x: %s\n", optarg);
 					usage();
@@ -839,11 +861,11 @@ main(int argc, char *argv[])
 		}
 
 		for (i = 0; i < argc; i++) {
-			int succ;
+			int failed;
 
-			succ = process_test_file(argv[i], dialect, impl, max_test_errors, &erec);
+			failed = process_test_file(argv[i], dialect, impl, max_test_errors, &erec);
 
-			if (!succ) {
+			if (failed) {
 				r |= 1;
 				continue;
 			}
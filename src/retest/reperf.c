@@ -82,7 +82,7 @@
  */
 
 static struct fsm_options opt;
-static struct fsm_vm_compile_opts vm_opts = { 0, FSM_VM_COMPILE_VM_V1, NULL };
+static struct fsm_vm_compile_opts vm_opts = { 0, FSM_VM_COMPILE_VM_V1, NULL, NULL };
 
 enum match_type {
 	MATCH_NONE,
@@ -975,6 +975,7 @@ usage(void)
 	fprintf(stderr, "             sets encoding type:\n");
 	fprintf(stderr, "                 v1        version 0.1 variable length encoding\n");
 	fprintf(stderr, "                 v2        version 0.2 fixed length encoding\n");
+	fprintf(stderr, "                 amd64     native code, compiled in memory\n");
 }
 
 static FILE *
@@ -1096,6 +1097,8 @@ main(int argc, char *argv[])
 					vm_opts.output = FSM_VM_COMPILE_VM_V1;
 				} else if (strcmp(optarg, "v2") == 0) {
 					vm_opts.output = FSM_VM_COMPILE_VM_V2;
+				} else if (strcmp(optarg, "amd64") == 0) {
+					vm_opts.output = FSM_VM_COMPILE_AMD64;
 				} else {
 					fprintf(stderr, "unknown argument to -x: %s\n", optarg);
 					usage();
@@ -61,7 +61,7 @@ runner_init_compiled(struct fsm *fsm, struct fsm_runner *r, enum implementation
 		fprintf(f, "#[no_mangle]\n");
 		fprintf(f, "pub extern \"C\" fn reperf_trampoline(ptr: *const c_uchar, len: usize) -> usize {\n");
 		fprintf(f, "    let a: &[u8] = unsafe { slice::from_raw_parts(ptr, len as usize) };\n");
-		fprintf(f, "    fsm_main(a).unwrap_or(0)\n");
+		fprintf(f, "    fsm_main(a).is_some() as usize\n");
 		fprintf(f, "}\n");
 	}
 
@@ -276,7 +276,7 @@ fsm_runner_run(const struct fsm_runner *r, const char *s, size_t n)
 
 	case IMPL_RUST:
 		assert(r->u.impl_rust.func != NULL);
-		return r->u.impl_rust.func((const unsigned char *)s, n) >= 0;
+		return r->u.impl_rust.func((const unsigned char *)s, n) != 0;
 
 	case IMPL_VMASM:
 		assert(r->u.impl_asm.func != NULL);
@@ -0,0 +1,98 @@
+/*
+ * Copyright 2026 agent
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/options.h>
+#include <fsm/print.h>
+
+/*
+ * /^x{600}$/, completed by a dead state: large enough for FSM_CTABLE_AUTO
+ * to pick tables, and with a transition for every state and every symbol,
+ * so there is no leaf. The output goes to stdout, to be compiled without
+ * TOK_UNKNOWN defined.
+ */
+
+#define N 600
+
+static struct fsm *
+build(const struct fsm_options *opt)
+{
+	struct fsm *fsm;
+	fsm_state_t s, dead;
+	unsigned c;
+	size_t i;
+	int r;
+
+	fsm = fsm_new(opt);
+	assert(fsm != NULL);
+
+	for (i = 0; i <= N + 1; i++) {
+		r = fsm_addstate(fsm, &s);
+		assert(r);
+		assert(s == i);
+	}
+
+	dead = N + 1;
+
+	for (i = 0; i <= N + 1; i++) {
+		for (c = 0; c <= UCHAR_MAX; c++) {
+			s = c == 'x' && i < N ? i + 1 : dead;
+
+			r = fsm_addedge_literal(fsm, i, s, c);
+			assert(r);
+		}
+	}
+
+	fsm_setstart(fsm, 0);
+	fsm_setend(fsm, N, 1);
+
+	return fsm;
+}
+
+int main(void) {
+	struct fsm_options opt;
+	struct fsm *fsm;
+	char line[256];
+	int tables;
+	FILE *f;
+
+	memset(&opt, 0, sizeof opt);
+	opt.io     = FSM_IO_STR;
+	opt.ctable = FSM_CTABLE_AUTO;
+
+	fsm = build(&opt);
+
+	f = tmpfile();
+	assert(f != NULL);
+
+	fsm_print_c(f, fsm);
+	rewind(f);
+
+	tables = 0;
+
+	while (fgets(line, sizeof line, f) != NULL) {
+		assert(strstr(line, "TOK_UNKNOWN") == NULL);
+
+		if (strstr(line, "check[") != NULL) {
+			tables = 1;
+		}
+
+		fputs(line, stdout);
+	}
+
+	assert(tables);
+
+	fclose(f);
+	fsm_free(fsm);
+
+	return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/dawg.h>
+
+#include <re/strings.h>
+
+/* in ascending order, so ordinals are array indices */
+static const char *words[] = {
+	"a", "ab", "abc", "abd", "b", "ba", "bad", "bc", "cab", "zzz"
+};
+
+static void
+load(struct fsm_dawg **dawg, void **buf)
+{
+	struct fsm *fsm;
+	FILE *f;
+	size_t r;
+	long n;
+	int e;
+
+	fsm = re_strings(NULL, words, sizeof words / sizeof *words,
+		RE_STRINGS_ANCHOR_LEFT | RE_STRINGS_ANCHOR_RIGHT);
+	assert(fsm != NULL);
+
+	e = fsm_minimise(fsm);
+	assert(e);
+
+	f = tmpfile();
+	assert(f != NULL);
+
+	e = fsm_dawg_write(f, fsm);
+	assert(e);
+	fsm_free(fsm);
+
+	n = ftell(f);
+	assert(n > 0);
+	rewind(f);
+
+	*buf = malloc(n);
+	assert(*buf != NULL);
+	r = fread(*buf, 1, n, f);
+	assert(r == (size_t) n);
+	fclose(f);
+
+	*dawg = fsm_dawg_open(*buf, n);
+	assert(*dawg != NULL);
+}
+
+int main(void) {
+	struct fsm_dawg *dawg;
+	char s[16];
+	size_t i, id, len;
+	void *buf;
+	long w;
+	int r;
+
+	load(&dawg, &buf);
+
+	assert(fsm_dawg_count(dawg) == sizeof words / sizeof *words);
+
+	for (i = 0; i < sizeof words / sizeof *words; i++) {
+		assert(fsm_dawg_contains(dawg, words[i], strlen(words[i])));
+
+		r = fsm_dawg_index(dawg, words[i], strlen(words[i]), &id);
+		assert(r);
+		assert(id == i);
+
+		w = fsm_dawg_word(dawg, i, s, sizeof s);
+		assert(w == (long) strlen(words[i]));
+		assert(0 == strcmp(s, words[i]));
+	}
+
+	assert(fsm_dawg_word(dawg, i, s, sizeof s) == -1);
+
+	assert(!fsm_dawg_contains(dawg, "c", 1));
+	assert(!fsm_dawg_contains(dawg, "abcd", 4));
+	assert(!fsm_dawg_index(dawg, "zz", 2, &id));
+
+	assert( fsm_dawg_hasprefix(dawg, "ca", 2));
+	assert( fsm_dawg_hasprefix(dawg, "zzz", 3));
+	assert(!fsm_dawg_hasprefix(dawg, "zzzz", 4));
+	assert(!fsm_dawg_hasprefix(dawg, "d", 1));
+
+	r = fsm_dawg_longest_prefix(dawg, "abcx", 4, &len);
+	assert(r && len == 3);
+	r = fsm_dawg_longest_prefix(dawg, "bax", 3, &len);
+	assert(r && len == 2);
+	assert(!fsm_dawg_longest_prefix(dawg, "x", 1, &len));
+	assert( fsm_dawg_hasprefix(dawg, "", 0));
+	assert(!fsm_dawg_contains(dawg, "", 0));
+
+	fsm_dawg_close(dawg);
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright 2026 agent
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+
+#include <fsm/fsm.h>
+#include <fsm/dawg.h>
+
+#include <re/strings.h>
+
+/*
+ * Large sets: a start node of more than 127 edges, and enough nodes
+ * that targets are wider than 8 bits. Then the same set by fsm_dawg_map(),
+ * and lookups over truncated and corrupted images, which must fail
+ * rather than read out of bounds or loop.
+ */
+
+#define NWORDS 1200
+
+static char words[NWORDS][12];
+static const char *a[NWORDS];
+static size_t nwords;
+
+static int
+cmp(const void *pa, const void *pb)
+{
+	return strcmp(* (const char * const *) pa, * (const char * const *) pb);
+}
+
+static void
+gen(void)
+{
+	unsigned long x;
+	size_t i, j;
+
+	x = 1;
+
+	/* one octet each, for a wide start node */
+	for (i = 0; i < 200; i++) {
+		words[i][0] = (char) (i + 1);
+		words[i][1] = '\0';
+	}
+
+	for ( ; i < NWORDS; i++) {
+		for (j = 0; j < 8; j++) {
+			x = x * 1103515245UL + 12345UL;
+			words[i][j] = 'a' + (x >> 16) % 26;
+		}
+		words[i][j] = '\0';
+	}
+
+	for (i = 0; i < NWORDS; i++) {
+		a[i] = words[i];
+	}
+
+	qsort(a, NWORDS, sizeof *a, cmp);
+
+	/* de-duplicate, since ordinals are indices into a[] */
+	nwords = 1;
+	for (i = 1; i < NWORDS; i++) {
+		if (0 != strcmp(a[i], a[nwords - 1])) {
+			a[nwords++] = a[i];
+		}
+	}
+}
+
+static FILE *
+write_dawg(void)
+{
+	struct fsm *fsm;
+	FILE *f;
+	int r;
+
+	fsm = re_strings(NULL, a, nwords,
+		RE_STRINGS_ANCHOR_LEFT | RE_STRINGS_ANCHOR_RIGHT);
+	assert(fsm != NULL);
+
+	r = fsm_minimise(fsm);
+	assert(r);
+
+	f = tmpfile();
+	assert(f != NULL);
+
+	r = fsm_dawg_write(f, fsm);
+	assert(r);
+
+	fsm_free(fsm);
+
+	return f;
+}
+
+static void
+check(const struct fsm_dawg *dawg)
+{
+	char s[16];
+	size_t i, id;
+	long w;
+	int r;
+
+	assert(fsm_dawg_count(dawg) == nwords);
+
+	for (i = 0; i < nwords; i++) {
+		assert(fsm_dawg_contains(dawg, a[i], strlen(a[i])));
+
+		r = fsm_dawg_index(dawg, a[i], strlen(a[i]), &id);
+		assert(r);
+		assert(id == i);
+
+		w = fsm_dawg_word(dawg, i, s, sizeof s);
+		assert(w == (long) strlen(a[i]));
+		assert(0 == strcmp(s, a[i]));
+	}
+
+	assert(!fsm_dawg_contains(dawg, "\xff", 1));
+	assert(!fsm_dawg_contains(dawg, "aaaaaaaaa", 9));
+}
+
+/* any result will do, so long as it returns */
+static void
+probe(const struct fsm_dawg *dawg)
+{
+	char s[16];
+	size_t i, id, len;
+
+	for (i = 0; i < nwords; i += 7) {
+		(void) fsm_dawg_contains(dawg, a[i], strlen(a[i]));
+		(void) fsm_dawg_hasprefix(dawg, a[i], strlen(a[i]));
+		(void) fsm_dawg_longest_prefix(dawg, a[i], strlen(a[i]), &len);
+		(void) fsm_dawg_index(dawg, a[i], strlen(a[i]), &id);
+		(void) fsm_dawg_word(dawg, i, s, sizeof s);
+	}
+}
+
+static void
+corrupt(const unsigned char *buf, size_t n)
+{
+	static const unsigned char v[] = { 0x00, 0x7f, 0x80, 0xff };
+	struct fsm_dawg *dawg;
+	unsigned char *p;
+	size_t i, k;
+
+	/* truncated images are rejected by their length */
+	for (i = 0; i < n; i += n / 16 + 1) {
+		assert(fsm_dawg_open(buf, i) == NULL);
+	}
+
+	p = malloc(n);
+	assert(p != NULL);
+
+	/* a few hundred octets of the node area, to keep this quick */
+	for (i = 32; i < n; i += n / 256 + 1) {
+		for (k = 0; k < sizeof v / sizeof *v; k++) {
+			memcpy(p, buf, n);
+			p[i] = v[k];
+
+			dawg = fsm_dawg_open(p, n);
+			if (dawg == NULL) {
+				continue;
+			}
+
+			probe(dawg);
+			fsm_dawg_close(dawg);
+		}
+	}
+
+	free(p);
+}
+
+/* a node whose only edge leads back to itself */
+static void
+cycle(void)
+{
+	static const unsigned char img[] = {
+		'F', 'S', 'M', 'D', 'A', 'W', 'G', 0x01,
+		2, 0, 0, 0, 0, 0, 0, 0, /* words */
+		4, 0, 0, 0,             /* node area */
+		0, 0, 0, 0,             /* start */
+		1,                      /* width */
+		0, 0, 0, 0, 0, 0, 0,
+		0x01, 0x02, 'a', 0x00
+	};
+	struct fsm_dawg *dawg;
+	char s[16];
+
+	dawg = fsm_dawg_open(img, sizeof img);
+	assert(dawg != NULL);
+
+	assert(fsm_dawg_word(dawg, 0, s, sizeof s) == -1);
+	assert(!fsm_dawg_contains(dawg, "aaaa", 4));
+
+	fsm_dawg_close(dawg);
+}
+
+int main(void) {
+	struct fsm_dawg *dawg;
+	char path[] = "/tmp/dawgXXXXXX";
+	unsigned char *buf;
+	FILE *f, *g;
+	size_t r;
+	long n;
+	int fd;
+
+	gen();
+
+	f = write_dawg();
+
+	n = ftell(f);
+	assert(n > 0);
+	rewind(f);
+
+	buf = malloc(n);
+	assert(buf != NULL);
+	r = fread(buf, 1, n, f);
+	assert(r == (size_t) n);
+	fclose(f);
+
+	/* width of targets, per the header */
+	assert(buf[24] > 8);
+
+	dawg = fsm_dawg_open(buf, n);
+	assert(dawg != NULL);
+	check(dawg);
+	fsm_dawg_close(dawg);
+
+	fd = mkstemp(path);
+	assert(fd != -1);
+	g = fdopen(fd, "wb");
+	assert(g != NULL);
+	r = fwrite(buf, 1, n, g);
+	assert(r == (size_t) n);
+	fclose(g);
+
+	dawg = fsm_dawg_map(path);
+	assert(dawg != NULL);
+	check(dawg);
+	fsm_dawg_close(dawg);
+
+	unlink(path);
+
+	assert(fsm_dawg_map(path) == NULL);
+
+	corrupt(buf, n);
+	cycle();
+
+	free(buf);
+
+	return 0;
+}
@@ -0,0 +1,115 @@
+/*
+ * Copyright 2019 Shannon F. Stewman
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+
+#include "libfsm/internal.h"
+
+#include <adt/edgeset.h>
+
+/*
+ * Grow a deterministic set past the size where it's held densely,
+ * and check lookup and both iterators against what was added.
+ */
+
+static fsm_state_t
+dest(unsigned symbol)
+{
+	return (symbol * 7) % 13;
+}
+
+static void
+check(const struct edge_set *set, const int *present)
+{
+	struct edge_ordered_iter eoi;
+	struct edge_iter it;
+	struct fsm_edge e;
+	size_t n, total;
+	unsigned i;
+	int prev;
+
+	total = 0;
+	for (i = 0; i <= UCHAR_MAX; i++) {
+		fsm_state_t to;
+
+		if (!present[i]) {
+			assert(!edge_set_contains(set, i));
+			continue;
+		}
+
+		assert(edge_set_transition(set, i, &to));
+		assert(to == dest(i));
+		total++;
+	}
+
+	assert(edge_set_count(set) == total);
+
+	n = 0;
+	for (edge_set_reset(set, &it); edge_set_next(&it, &e); ) {
+		assert(present[e.symbol]);
+		assert(e.state == dest(e.symbol));
+		n++;
+	}
+	assert(n == total);
+
+	n = 0;
+	prev = -1;
+	for (edge_set_ordered_iter_reset(set, &eoi); edge_set_ordered_iter_next(&eoi, &e); ) {
+		assert((int) e.symbol > prev);
+		assert(present[e.symbol]);
+		prev = e.symbol;
+		n++;
+	}
+	assert(n == total);
+}
+
+int main(void) {
+	struct edge_set *set = edge_set_new();
+	struct edge_set *copy = edge_set_new();
+	int present[UCHAR_MAX + 1] = { 0 };
+	unsigned i;
+
+	/* scattered order, to exercise insertion in the middle */
+	for (i = 0; i <= UCHAR_MAX; i++) {
+		const unsigned c = (i * 37) % (UCHAR_MAX + 1);
+
+		if (c % 3 == 0) {
+			continue;
+		}
+
+		assert(edge_set_add(&set, NULL, c, dest(c)));
+		present[c] = 1;
+
+		/* adding again is a no-op */
+		assert(edge_set_add(&set, NULL, c, dest(c)));
+
+		if (i % 16 == 0) {
+			check(set, present);
+		}
+	}
+
+	check(set, present);
+
+	assert(edge_set_copy(&copy, NULL, set));
+	check(copy, present);
+
+	for (i = 0; i <= UCHAR_MAX; i += 5) {
+		edge_set_remove(&set, i);
+		present[i] = 0;
+	}
+
+	check(set, present);
+
+	edge_set_free(NULL, set);
+	edge_set_free(NULL, copy);
+
+	return 0;
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright 2019 Shannon F. Stewman
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+
+#include "libfsm/internal.h"
+
+#include <adt/edgeset.h>
+
+/*
+ * A dense set which gains a second edge for a symbol must still hold
+ * every edge; likewise for states replaced and removed afterwards.
+ */
+
+static size_t
+count_edges(const struct edge_set *set, unsigned char symbol, fsm_state_t state)
+{
+	struct edge_ordered_iter eoi;
+	struct fsm_edge e;
+	size_t n;
+
+	n = 0;
+	for (edge_set_ordered_iter_reset_to(set, &eoi, symbol); edge_set_ordered_iter_next(&eoi, &e); ) {
+		if (e.symbol != symbol) {
+			break;
+		}
+
+		if (e.state == state) {
+			n++;
+		}
+	}
+
+	return n;
+}
+
+int main(void) {
+	struct edge_set *set = edge_set_new();
+	unsigned i;
+
+	for (i = 0; i < 64; i++) {
+		assert(edge_set_add(&set, NULL, i, 1));
+	}
+
+	assert(edge_set_count(set) == 64);
+
+	/* nondeterministic */
+	assert(edge_set_add(&set, NULL, 10, 2));
+	assert(edge_set_add(&set, NULL, 10, 3));
+	assert(edge_set_count(set) == 66);
+
+	assert(count_edges(set, 10, 1) == 1);
+	assert(count_edges(set, 10, 2) == 1);
+	assert(count_edges(set, 10, 3) == 1);
+	assert(count_edges(set, 11, 1) == 1);
+
+	/* merging states 2 and 3 leaves one edge <10, 3> */
+	edge_set_replace_state(&set, 2, 3);
+	assert(edge_set_count(set) == 65);
+	assert(count_edges(set, 10, 3) == 1);
+
+	edge_set_remove_state(&set, 1);
+	assert(edge_set_count(set) == 1);
+	assert(count_edges(set, 10, 3) == 1);
+	assert(!edge_set_contains(set, 11));
+
+	edge_set_remove(&set, 10);
+	assert(edge_set_empty(set));
+
+	edge_set_free(NULL, set);
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2026 agent
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+
+#include "libfsm/internal.h"
+
+#include <print/esc.h>
+
+#include <adt/bitmap.h>
+#include <adt/edgeset.h>
+
+/*
+ * Edges added in bulk are held as the default edge, until a larger
+ * group for another state takes its place. The explicit iterator
+ * yields only the edges which are not part of the default.
+ */
+
+static void
+range(struct bm *bm, unsigned lo, unsigned hi)
+{
+	unsigned i;
+
+	bm_clear(bm);
+
+	for (i = lo; i <= hi; i++) {
+		bm_set(bm, i);
+	}
+}
+
+static size_t
+count_explicit(const struct edge_set *set, fsm_state_t state)
+{
+	struct edge_iter it;
+	struct fsm_edge e;
+	size_t n;
+
+	n = 0;
+	for (edge_set_reset_explicit(set, &it); edge_set_next(&it, &e); ) {
+		if (e.state == state) {
+			n++;
+		}
+	}
+
+	return n;
+}
+
+static size_t
+count_all(const struct edge_set *set)
+{
+	struct edge_iter it;
+	struct fsm_edge e;
+	size_t n;
+
+	n = 0;
+	for (edge_set_reset(set, &it); edge_set_next(&it, &e); ) {
+		n++;
+	}
+
+	return n;
+}
+
+int main(void) {
+	struct edge_set *set = NULL;
+	struct fsm_edge e;
+	fsm_state_t state;
+	struct bm bm;
+	int r;
+
+	/* nothing to add */
+	bm_clear(&bm);
+	r = edge_set_add_bulk(&set, NULL, &bm, 1);
+	assert(r);
+	assert(edge_set_empty(set));
+	assert(!edge_set_default(set, NULL, NULL));
+
+	/* a singleton is kept as an explicit edge */
+	r = edge_set_add(&set, NULL, '0', 2);
+	assert(r);
+	assert(!edge_set_default(set, NULL, NULL));
+
+	range(&bm, 'a', 'z');
+	r = edge_set_add_bulk(&set, NULL, &bm, 1);
+	assert(r);
+	assert(edge_set_count(set) == 27);
+
+	r = edge_set_default(set, &bm, &state);
+	assert(r);
+	assert(bm_count(&bm) == 26);
+	assert(bm_get(&bm, 'a') && bm_get(&bm, 'z'));
+	assert(state == 1);
+
+	assert(count_explicit(set, 1) == 0);
+	assert(count_explicit(set, 2) == 1);
+	assert(count_all(set) == 27);
+
+	r = edge_set_find(set, 'm', &e);
+	assert(r);
+	assert(e.symbol == 'm' && e.state == 1);
+
+	/* already part of the default */
+	r = edge_set_add(&set, NULL, 'q', 1);
+	assert(r);
+	assert(edge_set_count(set) == 27);
+
+	/* a smaller group for another state is stored explicitly */
+	range(&bm, 'A', 'C');
+	r = edge_set_add_bulk(&set, NULL, &bm, 3);
+	assert(r);
+	assert(edge_set_count(set) == 30);
+
+	r = edge_set_default(set, NULL, &state);
+	assert(r);
+	assert(state == 1);
+	assert(count_explicit(set, 3) == 3);
+
+	/* a larger group for another state takes over the default */
+	range(&bm, 0x80, 0xff);
+	r = edge_set_add_bulk(&set, NULL, &bm, 4);
+	assert(r);
+	assert(edge_set_count(set) == 158);
+
+	r = edge_set_default(set, &bm, &state);
+	assert(r);
+	assert(bm_count(&bm) == 128);
+	assert(state == 4);
+
+	assert(count_explicit(set, 1) == 26);
+	assert(count_explicit(set, 2) == 1);
+	assert(count_explicit(set, 3) == 3);
+	assert(count_explicit(set, 4) == 0);
+	assert(count_all(set) == 158);
+
+	r = edge_set_find(set, 'm', &e);
+	assert(r);
+	assert(e.state == 1);
+
+	r = edge_set_find(set, 0x90, &e);
+	assert(r);
+	assert(e.state == 4);
+
+	/* the default edge goes with its state */
+	edge_set_remove_state(&set, 4);
+	assert(!edge_set_default(set, NULL, NULL));
+	assert(edge_set_count(set) == 30);
+
+	edge_set_free(NULL, set);
+
+	return 0;
+}
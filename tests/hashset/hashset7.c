@@ -0,0 +1,106 @@
+/*
+ * Copyright 2019 Shannon Stewman
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <adt/hashset.h>
+
+typedef int item_t;
+
+#include "hashset.inc"
+
+static int
+cmp_int(const void *a, const void *b)
+{
+	const int *pa = * (const int * const *) a;
+	const int *pb = * (const int * const *) b;
+
+	if (*pa > *pb)      return +1;
+	else if (*pa < *pb) return -1;
+	else                return  0;
+}
+
+static unsigned long
+hash_int(const void *a)
+{
+	return hashrec(a, sizeof * (const int *) a);
+}
+
+/* every item collides, to exercise probing across groups */
+static unsigned long
+hash_bad(const void *a)
+{
+	(void) a;
+	return 12345;
+}
+
+int
+hashset_contains(const struct hashset *set, const void *item)
+{
+	unsigned long h = set->hash(item);
+	size_t b = 0;
+
+	assert(set != NULL);
+
+	return finditem(set, h, item, &b);
+}
+
+/* removes and re-adds items, leaving tombstones behind */
+static void
+churn(unsigned long (*hash)(const void *), int *a, size_t n)
+{
+	struct hashset *s = hashset_create(NULL, hash, cmp_int);
+	struct hashset_iter iter;
+	size_t i, count;
+	int round;
+	int *p;
+
+	for (i = 0; i < n; i++) {
+		assert(hashset_add(s, &a[i]));
+	}
+
+	for (round = 0; round < 3; round++) {
+		for (i = 0; i < n; i += 2) {
+			assert(hashset_remove(s, &a[i]));
+		}
+
+		assert(hashset_count(s) == n / 2);
+
+		for (i = 0; i < n; i++) {
+			assert(!hashset_contains(s, &a[i]) == (i % 2 == 0));
+		}
+
+		for (i = 0; i < n; i += 2) {
+			assert(hashset_add(s, &a[i]) == &a[i]);
+		}
+
+		assert(hashset_count(s) == n);
+	}
+
+	count = 0;
+	for (p = hashset_first(s, &iter); p != NULL; p = hashset_next(&iter)) {
+		count++;
+	}
+
+	assert(count == n);
+
+	hashset_free(s);
+}
+
+int main(void) {
+	int a[5000];
+	size_t i;
+
+	for (i = 0; i < sizeof a / sizeof *a; i++) {
+		a[i] = i;
+	}
+
+	churn(hash_int, a, sizeof a / sizeof *a);
+	churn(hash_bad, a, 100);
+
+	return 0;
+}
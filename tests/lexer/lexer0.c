@@ -0,0 +1,227 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/lexer.h>
+
+enum { WORD, QUOTE, STR, LE };
+
+static const char *names[] = { "WORD", "QUOTE", "STR", "LE" };
+
+/*
+ * Zone 0: [a-z]+ -> WORD; [ \n]+ skipped; '"' -> QUOTE, to zone 1; '<=' -> LE
+ * Zone 1: [a-z ]+ -> STR; '"' -> QUOTE, to zone 0
+ */
+struct end {
+	unsigned token;
+	unsigned zone;
+};
+
+static const struct end ends[2][5] = {
+	{
+		{ 0, 0 },
+		{ WORD,           FSM_LEXER_STAY },
+		{ FSM_LEXER_SKIP, FSM_LEXER_STAY },
+		{ QUOTE,          1              },
+		{ LE,             FSM_LEXER_STAY }
+	},
+	{
+		{ 0, 0 },
+		{ STR,            FSM_LEXER_STAY },
+		{ QUOTE,          0              }
+	}
+};
+
+static struct fsm *zone[2];
+
+static void
+end(const struct fsm *fsm, fsm_state_t state,
+	unsigned *token, unsigned *to, void *opaque)
+{
+	unsigned z;
+
+	(void) opaque;
+
+	z = fsm == zone[0] ? 0 : 1;
+
+	*token = ends[z][state].token;
+	*to    = ends[z][state].zone;
+}
+
+static void
+edge(struct fsm *fsm, fsm_state_t from, fsm_state_t to, char c)
+{
+	int r;
+
+	r = fsm_addedge_literal(fsm, from, to, c);
+	assert(r);
+}
+
+static void
+range(struct fsm *fsm, fsm_state_t from, fsm_state_t to, char a, char b)
+{
+	char c;
+
+	for (c = a; c <= b; c++) {
+		edge(fsm, from, to, c);
+	}
+}
+
+static struct fsm_lexer *
+load(void)
+{
+	struct fsm_lexer *lexer;
+	fsm_state_t s[6];
+	FILE *f;
+	int i, r;
+
+	zone[0] = fsm_new(NULL);
+	zone[1] = fsm_new(NULL);
+	assert(zone[0] != NULL && zone[1] != NULL);
+
+	/* state 5 is '<' alone, which does not accept */
+	for (i = 0; i < 6; i++) {
+		r = fsm_addstate(zone[0], &s[i]);
+		assert(r);
+		assert(s[i] == (fsm_state_t) i);
+	}
+
+	range(zone[0], 0, 1, 'a', 'z');
+	range(zone[0], 1, 1, 'a', 'z');
+	edge(zone[0], 0, 2, ' ');
+	edge(zone[0], 0, 2, '\n');
+	edge(zone[0], 2, 2, ' ');
+	edge(zone[0], 2, 2, '\n');
+	edge(zone[0], 0, 3, '"');
+	edge(zone[0], 0, 5, '<');
+	edge(zone[0], 5, 4, '=');
+
+	fsm_setstart(zone[0], 0);
+	for (i = 1; i <= 4; i++) {
+		fsm_setend(zone[0], i, 1);
+	}
+
+	for (i = 0; i < 3; i++) {
+		r = fsm_addstate(zone[1], &s[i]);
+		assert(r);
+	}
+
+	range(zone[1], 0, 1, 'a', 'z');
+	range(zone[1], 1, 1, 'a', 'z');
+	edge(zone[1], 0, 1, ' ');
+	edge(zone[1], 1, 1, ' ');
+	edge(zone[1], 0, 2, '"');
+
+	fsm_setstart(zone[1], 0);
+	fsm_setend(zone[1], 1, 1);
+	fsm_setend(zone[1], 2, 1);
+
+	f = tmpfile();
+	assert(f != NULL);
+
+	r = fsm_lexer_write(f, (const struct fsm *const *) zone, 2, 0,
+		names, sizeof names / sizeof *names, end, NULL);
+	assert(r);
+
+	fsm_free(zone[0]);
+	fsm_free(zone[1]);
+
+	rewind(f);
+
+	lexer = fsm_lexer_read(f);
+	assert(lexer != NULL);
+
+	fclose(f);
+
+	return lexer;
+}
+
+static void
+expect(const struct fsm_lexer *lexer, struct fsm_lexer_input *in,
+	int token, const char *text, unsigned line, unsigned col)
+{
+	int r;
+
+	r = fsm_lexer_next(lexer, in);
+	assert(r == token);
+	assert((size_t) (in->p - in->tok) == strlen(text));
+	assert(0 == memcmp(in->tok, text, strlen(text)));
+	assert(in->start.line == line);
+	assert(in->start.col == col);
+}
+
+int main(void) {
+	struct fsm_lexer_input in;
+	struct fsm_lexer *lexer;
+	const char *s;
+
+	lexer = load();
+
+	assert(fsm_lexer_ntokens(lexer) == 4);
+	assert(0 == strcmp(fsm_lexer_name(lexer, STR), "STR"));
+	assert(fsm_lexer_name(lexer, 4) == NULL);
+	assert(fsm_lexer_name(lexer, FSM_LEXER_EOF) == NULL);
+
+	s = "ab \n \"x y\"cd!<=";
+	fsm_lexer_init(lexer, &in, s, strlen(s));
+	in.pos = 1;
+
+	expect(lexer, &in, WORD,              "ab",    1, 1);
+	expect(lexer, &in, QUOTE,             "\"",    2, 2);
+	assert(in.zone == 1);
+	expect(lexer, &in, STR,               "x y",   2, 3);
+	expect(lexer, &in, QUOTE,             "\"",    2, 6);
+	assert(in.zone == 0);
+	expect(lexer, &in, WORD,              "cd",    2, 7);
+	expect(lexer, &in, FSM_LEXER_UNKNOWN, "!",     2, 9);
+	expect(lexer, &in, LE,                "<=",    2, 10);
+	assert(in.end.byte == strlen(s));
+	expect(lexer, &in, FSM_LEXER_EOF,     "",      2, 10);
+
+	/* cut short by the end of input */
+	s = "\"ab";
+	fsm_lexer_init(lexer, &in, s, strlen(s));
+
+	expect(lexer, &in, QUOTE,             "\"",    1, 1);
+	expect(lexer, &in, STR,               "ab",    1, 1);
+	expect(lexer, &in, FSM_LEXER_EOF,     "",      1, 1);
+
+	s = "a <";
+	fsm_lexer_init(lexer, &in, s, strlen(s));
+
+	expect(lexer, &in, WORD,              "a",     1, 1);
+	errno = 0;
+	expect(lexer, &in, FSM_LEXER_ERROR,   "<",     1, 1);
+	assert(errno == EINVAL);
+	expect(lexer, &in, FSM_LEXER_EOF,     "",      1, 1);
+
+	s = "<";
+	fsm_lexer_init(lexer, &in, s, strlen(s));
+
+	expect(lexer, &in, FSM_LEXER_ERROR,   "<",     1, 1);
+	expect(lexer, &in, FSM_LEXER_EOF,     "",      1, 1);
+
+	/* skipping to the end of input */
+	s = "a  ";
+	fsm_lexer_init(lexer, &in, s, strlen(s));
+
+	expect(lexer, &in, WORD,              "a",     1, 1);
+	expect(lexer, &in, FSM_LEXER_EOF,     "  ",    1, 1);
+
+	fsm_lexer_init(lexer, &in, "", 0);
+	expect(lexer, &in, FSM_LEXER_EOF,     "",      1, 1);
+
+	fsm_lexer_free(lexer);
+
+	return 0;
+}
+
@@ -0,0 +1,87 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/lexer.h>
+
+/* as for lx -l dump, for tables from lx -l vm */
+int
+main(int argc, char *argv[])
+{
+	struct fsm_lexer *lexer;
+	struct fsm_lexer_input in;
+	FILE *f;
+	int t;
+
+	if (argc != 3) {
+		fprintf(stderr, "usage: vmdump <file> <str>\n");
+		return 1;
+	}
+
+	f = fopen(argv[1], "rb");
+	if (f == NULL) {
+		perror(argv[1]);
+		return 1;
+	}
+
+	lexer = fsm_lexer_read(f);
+	if (lexer == NULL) {
+		perror("fsm_lexer_read");
+		return 1;
+	}
+
+	fclose(f);
+
+	fsm_lexer_init(lexer, &in, argv[2], strlen(argv[2]));
+	in.pos = 1;
+
+	do {
+		t = fsm_lexer_next(lexer, &in);
+
+		printf("%u", in.start.byte);
+		if (in.end.byte != in.start.byte) {
+			printf("-%u", in.end.byte);
+		}
+		printf(":%u", in.start.line);
+		if (in.end.line != in.start.line) {
+			printf("-%u", in.end.line);
+		}
+		printf(",%u", in.start.col);
+		if (in.end.col != in.start.col) {
+			printf("-%u", in.end.col);
+		}
+		printf(": ");
+
+		switch (t) {
+		case FSM_LEXER_EOF:
+			printf("<EOF>\n");
+			break;
+
+		case FSM_LEXER_ERROR:
+			perror("fsm_lexer_next");
+			break;
+
+		case FSM_LEXER_UNKNOWN:
+			printf("lexically uncategorised: '%.*s'\n",
+				(int) (in.p - in.tok), in.tok);
+			break;
+
+		default:
+			printf("<%s '%.*s'>\n", fsm_lexer_name(lexer, t),
+				(int) (in.p - in.tok), in.tok);
+			break;
+		}
+	} while (t != FSM_LEXER_ERROR && t != FSM_LEXER_EOF && t != FSM_LEXER_UNKNOWN);
+
+	fsm_lexer_free(lexer);
+
+	return t == FSM_LEXER_ERROR;
+}
+
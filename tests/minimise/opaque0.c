@@ -0,0 +1,97 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+
+static int x, y;
+
+/*
+ * /ax/ and /bx/, each ending in a state with the given opaque.
+ * The paths through 'a' and 'b' are equivalent only if the opaques are
+ * the same.
+ */
+static struct fsm *
+build(void *p, void *q)
+{
+	struct fsm *fsm;
+	fsm_state_t s[5];
+	int i, r;
+
+	fsm = fsm_new(NULL);
+	assert(fsm != NULL);
+
+	for (i = 0; i < 5; i++) {
+		r = fsm_addstate(fsm, &s[i]);
+		assert(r);
+	}
+
+	r = fsm_addedge_literal(fsm, s[0], s[1], 'a');
+	assert(r);
+	r = fsm_addedge_literal(fsm, s[0], s[2], 'b');
+	assert(r);
+	r = fsm_addedge_literal(fsm, s[1], s[3], 'x');
+	assert(r);
+	r = fsm_addedge_literal(fsm, s[2], s[4], 'x');
+	assert(r);
+
+	fsm_setstart(fsm, s[0]);
+
+	fsm_setend(fsm, s[3], 1);
+	fsm_setend(fsm, s[4], 1);
+
+	fsm_setopaque(fsm, s[3], p);
+	fsm_setopaque(fsm, s[4], q);
+
+	return fsm;
+}
+
+static void *
+run(const struct fsm *fsm, const char *s)
+{
+	fsm_state_t end;
+	int r;
+
+	r = fsm_exec(fsm, fsm_sgetc, &s, &end);
+	assert(r == 1);
+
+	return fsm_getopaque(fsm, end);
+}
+
+int main(void) {
+	struct fsm *fsm;
+	int r;
+
+	/* the same opaque; merged as for fsm_minimise() */
+	fsm = build(&x, &x);
+	r = fsm_minimise_opaque(fsm);
+	assert(r);
+	assert(fsm_countstates(fsm) == 3);
+	assert(run(fsm, "ax") == &x);
+	assert(run(fsm, "bx") == &x);
+	fsm_free(fsm);
+
+	/* different opaques; kept apart, along with the states before them */
+	fsm = build(&x, &y);
+	r = fsm_minimise_opaque(fsm);
+	assert(r);
+	assert(fsm_countstates(fsm) == 5);
+	assert(run(fsm, "ax") == &x);
+	assert(run(fsm, "bx") == &y);
+	fsm_free(fsm);
+
+	/* fsm_minimise() does not look at opaques */
+	fsm = build(&x, &y);
+	r = fsm_minimise(fsm);
+	assert(r);
+	assert(fsm_countstates(fsm) == 3);
+	fsm_free(fsm);
+
+	return 0;
+}
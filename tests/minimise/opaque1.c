@@ -0,0 +1,128 @@
+/*
+ * Copyright 2026 agent
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+
+static int x, y, z;
+
+/*
+ * Several opaques, over states at several distances from an end state.
+ * The start state is alone at its distance, and so its EC is done from
+ * the outset. The end states for y are split from those for x after it,
+ * and must be moved ahead of it to be split again, because "cx" goes on
+ * to "cxy" where "dx" does not.
+ */
+static struct fsm *
+build(void)
+{
+	static const struct {
+		unsigned from;
+		unsigned to;
+		char c;
+	} edge[] = {
+		{ 0, 1, 'a' }, { 0, 2, 'b' }, { 0, 3, 'c' }, { 0, 4, 'd' },
+		{ 0, 5, 'e' },
+		{ 1, 6, 'x' }, { 2, 7, 'x' }, { 3, 8, 'x' }, { 4, 9, 'x' },
+		{ 5, 10, 'x' },
+		{ 8, 11, 'y' }
+	};
+	static const struct {
+		unsigned state;
+		void *opaque;
+	} end[] = {
+		{ 6, &x }, { 7, &x },
+		{ 8, &y }, { 9, &y }, { 11, &y },
+		{ 10, &z }
+	};
+	struct fsm *fsm;
+	fsm_state_t s;
+	size_t i;
+	int r;
+
+	fsm = fsm_new(NULL);
+	assert(fsm != NULL);
+
+	for (i = 0; i < 12; i++) {
+		r = fsm_addstate(fsm, &s);
+		assert(r);
+		assert(s == i);
+	}
+
+	for (i = 0; i < sizeof edge / sizeof *edge; i++) {
+		r = fsm_addedge_literal(fsm, edge[i].from, edge[i].to, edge[i].c);
+		assert(r);
+	}
+
+	fsm_setstart(fsm, 0);
+
+	for (i = 0; i < sizeof end / sizeof *end; i++) {
+		fsm_setend(fsm, end[i].state, 1);
+		fsm_setopaque(fsm, end[i].state, end[i].opaque);
+	}
+
+	return fsm;
+}
+
+static void *
+run(const struct fsm *fsm, const char *s)
+{
+	fsm_state_t end;
+	int r;
+
+	r = fsm_exec(fsm, fsm_sgetc, &s, &end);
+	assert(r != -1);
+
+	if (r == 0) {
+		return NULL;
+	}
+
+	return fsm_getopaque(fsm, end);
+}
+
+int main(void) {
+	static const struct {
+		const char *s;
+		void *opaque;
+	} in[] = {
+		{ "ax",  &x }, { "bx",  &x },
+		{ "cx",  &y }, { "dx",  &y }, { "cxy", &y },
+		{ "ex",  &z },
+		{ "",    NULL }, { "a",   NULL }, { "axy", NULL },
+		{ "dxy", NULL }, { "exy", NULL }, { "f",   NULL }
+	};
+	struct fsm *fsm;
+	size_t i;
+	int r;
+
+	/*
+	 * start; a and b; c; d; e; the ends for x;
+	 * "cx"; the other ends for y; the end for z
+	 */
+	fsm = build();
+	r = fsm_minimise_opaque(fsm);
+	assert(r);
+	assert(fsm_countstates(fsm) == 9);
+
+	for (i = 0; i < sizeof in / sizeof *in; i++) {
+		assert(run(fsm, in[i].s) == in[i].opaque);
+	}
+
+	fsm_free(fsm);
+
+	/* by fsm_minimise(): start; a, b, d and e; c; "cx"; the ends */
+	fsm = build();
+	r = fsm_minimise(fsm);
+	assert(r);
+	assert(fsm_countstates(fsm) == 5);
+	fsm_free(fsm);
+
+	return 0;
+}
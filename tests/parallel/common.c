@@ -0,0 +1,45 @@
+/*
+ * Copyright 2026 agent
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/options.h>
+
+#include <re/re.h>
+
+#include "common.h"
+
+static struct fsm_options opt;
+
+static unsigned long seed = 1;
+
+unsigned
+rnd(void)
+{
+	seed = seed * 6364136223846793005UL + 1442695040888963407UL;
+	return seed >> 33;
+}
+
+struct fsm *
+comp(const char *s, enum re_flags flags)
+{
+	struct fsm *fsm;
+	int r;
+
+	fsm = re_comp(RE_PCRE, fsm_sgetc, &s, &opt, flags, NULL);
+	assert(fsm != NULL);
+
+	r = fsm_determinise(fsm);
+	assert(r);
+
+	r = fsm_minimise(fsm);
+	assert(r);
+
+	return fsm;
+}
@@ -0,0 +1,18 @@
+/*
+ * Copyright 2026 agent
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#ifndef TEST_PARALLEL_COMMON_H
+#define TEST_PARALLEL_COMMON_H
+
+/* a fixed sequence of pseudo-random numbers, the same for every run */
+unsigned
+rnd(void);
+
+/* a minimal DFA for the given PCRE */
+struct fsm *
+comp(const char *s, enum re_flags flags);
+
+#endif
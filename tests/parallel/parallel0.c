@@ -0,0 +1,101 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/parallel.h>
+
+#include <re/re.h>
+
+#include "common.h"
+
+static const struct {
+	const char *re;
+	const char *alphabet;
+} a[] = {
+	{ "^[ab]*abb$",        "ab"    },
+	{ "^(a|b)*abba(a|b)*$", "ab"   },
+	{ "^([^x]*x[^x]*x)*[^x]*$", "xyz" },
+	{ "^[a-c]*(ca|ac)[a-c]{0,3}$", "abc" },
+	{ "^(ab)*$",           "ab"    },
+	{ "^[^z]*z",           "abz"   }
+};
+
+static void
+check(const struct fsm *fsm, const struct fsm_parallel *p, const char *buf, size_t n)
+{
+	static const unsigned threads[] = { 0, 1, 2, 3, 8 };
+	fsm_state_t want, got;
+	const char *s;
+	char *tmp;
+	size_t i;
+	int r, e;
+
+	/* fsm_sgetc needs a string */
+	tmp = malloc(n + 1);
+	assert(tmp != NULL);
+	memcpy(tmp, buf, n);
+	tmp[n] = '\0';
+
+	s = tmp;
+	r = fsm_exec(fsm, fsm_sgetc, &s, &want);
+	assert(r != -1);
+
+	for (i = 0; i < sizeof threads / sizeof *threads; i++) {
+		e = fsm_parallel_match(p, buf, n, threads[i], &got);
+		assert(e == r);
+		assert(r == 0 || got == want);
+	}
+
+	free(tmp);
+}
+
+int main(void) {
+	size_t i, j, n;
+	char *buf;
+
+	n = 4 * 1024 * 1024;
+
+	buf = malloc(n);
+	assert(buf != NULL);
+
+	for (i = 0; i < sizeof a / sizeof *a; i++) {
+		struct fsm_parallel *p;
+		struct fsm *fsm;
+		size_t k;
+
+		fsm = comp(a[i].re, 0);
+
+		p = fsm_parallel_compile(fsm);
+		assert(p != NULL);
+
+		k = strlen(a[i].alphabet);
+
+		for (j = 0; j < n; j++) {
+			buf[j] = a[i].alphabet[rnd() % k];
+		}
+
+		/* the result is decided by the last few bytes */
+		check(fsm, p, buf, n);
+		memcpy(buf + n - 4, "abba", 4);
+		check(fsm, p, buf, n);
+
+		check(fsm, p, buf, 0);
+		check(fsm, p, buf, 1000);
+
+		fsm_parallel_free(p);
+		fsm_free(fsm);
+	}
+
+	free(buf);
+
+	return 0;
+}
+
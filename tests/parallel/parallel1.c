@@ -0,0 +1,106 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/parallel.h>
+
+#include <re/re.h>
+
+#include "common.h"
+
+static const char *a[] = {
+	"^[-a-z0-9]+(\\.[-a-z0-9]+)*\\.(com|org|net)$",
+	"^(www|mail)\\.",
+	"example",
+	"^$",
+	""
+};
+
+int main(void) {
+	static const char *word[] = {
+		"www", "mail", "example", "com", "org", "net", "x-y", "0", ""
+	};
+	static const char sep[] = "..-_";
+
+	struct fsm_parallel_buf in[1000];
+	static char text[1000][64];
+	unsigned char matched[1000];
+	fsm_state_t end[1000];
+	size_t i, j, n, seen;
+
+	seen = 0;
+	n = sizeof in / sizeof *in;
+
+	for (i = 0; i < n; i++) {
+		size_t k, w, len;
+
+		/* lengths from empty to dozens of bytes, so lanes finish at different times */
+		len = 0;
+		w = rnd() % 6;
+		for (k = 0; k < w; k++) {
+			const char *x = word[rnd() % (sizeof word / sizeof *word)];
+
+			if (k > 0) {
+				text[i][len++] = sep[rnd() % (sizeof sep - 1)];
+			}
+
+			memcpy(text[i] + len, x, strlen(x));
+			len += strlen(x);
+		}
+		text[i][len] = '\0';
+
+		in[i].buf = text[i];
+		in[i].n   = strlen(text[i]);
+	}
+
+	for (i = 0; i < sizeof a / sizeof *a; i++) {
+		struct fsm_parallel *p;
+		struct fsm *fsm;
+		size_t count;
+
+		fsm = comp(a[i], 0);
+
+		p = fsm_parallel_compile(fsm);
+		assert(p != NULL);
+
+		/* a batch smaller than the lanes, and larger */
+		assert(fsm_parallel_match_batch(p, in, 0, NULL, NULL) == 0);
+		(void) fsm_parallel_match_batch(p, in, 3, matched, NULL);
+		count = fsm_parallel_match_batch(p, in, n, matched, end);
+
+		for (j = 0; j < n; j++) {
+			const char *s;
+			fsm_state_t want;
+			int r;
+
+			s = text[j];
+			r = fsm_exec(fsm, fsm_sgetc, &s, &want);
+			assert(r != -1);
+
+			assert(matched[j] == r);
+			assert(r == 0 || end[j] == want);
+
+			count -= r;
+		}
+
+		assert(count == 0);
+		seen += fsm_parallel_match_batch(p, in, n, matched, NULL);
+
+		fsm_parallel_free(p);
+		fsm_free(fsm);
+	}
+
+	/* some of each */
+	assert(seen > 0 && seen < n * (sizeof a / sizeof *a));
+
+	return 0;
+}
+
@@ -0,0 +1,107 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/parallel.h>
+
+#include <re/re.h>
+
+#include "common.h"
+
+static const char *a[] = {
+	"^[ab]*abb$",
+	"abba",
+	"^(ab)*$",
+	"^[^c]*$",
+	"c.c",
+	"^a",
+	"b$",
+	"^$",
+	"(aa|bb)(cc|aa)",
+	"^[abc]{3,5}$",
+	"a{4}",
+	"^(a|b)*c(a|b)*$",
+	"cab",
+	"^.*abc.*$",
+	"bbb",
+	"^[^a][^b]"
+};
+
+int main(void) {
+	const size_t max = sizeof a / sizeof *a;
+	const struct fsm_parallel *cp[sizeof a / sizeof *a];
+	struct fsm_parallel *p[sizeof a / sizeof *a];
+	struct fsm *fsm[sizeof a / sizeof *a];
+	unsigned char matched[sizeof a / sizeof *a];
+	fsm_state_t end[sizeof a / sizeof *a];
+	size_t i, j, k;
+	char buf[300];
+
+	assert(max == FSM_PARALLEL_MULTI_MAX);
+
+	for (i = 0; i < max; i++) {
+		fsm[i] = comp(a[i], 0);
+		p[i] = fsm_parallel_compile(fsm[i]);
+		assert(p[i] != NULL);
+		cp[i] = p[i];
+	}
+
+	assert(fsm_parallel_multi_compile(cp, 0) == NULL);
+	assert(fsm_parallel_multi_compile(cp, max + 1) == NULL);
+
+	/* one vector's worth of lanes, part of one, and more than one */
+	for (k = 1; k <= max; k++) {
+		struct fsm_parallel_multi *m;
+
+		m = fsm_parallel_multi_compile(cp, k);
+		assert(m != NULL);
+
+		for (j = 0; j < 300; j++) {
+			size_t n, count;
+
+			/* lengths either side of a block */
+			n = rnd() % (sizeof buf - 1);
+			for (i = 0; i < n; i++) {
+				buf[i] = "abc"[rnd() % 3];
+			}
+			buf[n] = '\0';
+
+			count = fsm_parallel_multi_match(m, buf, n, matched, end);
+
+			for (i = 0; i < k; i++) {
+				const char *s;
+				fsm_state_t want;
+				int r;
+
+				s = buf;
+				r = fsm_exec(fsm[i], fsm_sgetc, &s, &want);
+				assert(r != -1);
+
+				assert(matched[i] == r);
+				assert(r == 0 || end[i] == want);
+
+				count -= r;
+			}
+
+			assert(count == 0);
+		}
+
+		fsm_parallel_multi_free(m);
+	}
+
+	for (i = 0; i < max; i++) {
+		fsm_parallel_free(p[i]);
+		fsm_free(fsm[i]);
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,157 @@
+/*
+ * Copyright 2008-2017 Katherine Flavel
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/parallel.h>
+
+#include <re/re.h>
+
+#include "common.h"
+
+static const char *a[] = {
+	"abc",
+	"^ab",
+	"c$",
+	"^$",
+	"^[^b]*$",
+	"",
+	"^(ab|ba)+$",
+	"b.*c|^c",
+	".*",
+	"^.*$"
+};
+
+struct expect {
+	const struct fsm *fsm;
+	const char *p; /* the start of the next line to check */
+	size_t lineno;
+	size_t count;
+	size_t stop;
+};
+
+/* check each line before this one is not accepted, and this one is */
+static int
+line(const char *s, size_t len, size_t lineno, fsm_state_t end, void *opaque)
+{
+	struct expect *x = opaque;
+	fsm_state_t want;
+	const char *q;
+	char tmp[256];
+	size_t n;
+	int r;
+
+	for (;;) {
+		q = strchr(x->p, '\n');
+		n = q != NULL ? (size_t) (q - x->p) : strlen(x->p);
+
+		assert(n < sizeof tmp);
+		memcpy(tmp, x->p, n);
+		tmp[n] = '\0';
+
+		q = tmp;
+		r = fsm_exec(x->fsm, fsm_sgetc, &q, &want);
+		assert(r != -1);
+
+		if (x->p == s) {
+			break;
+		}
+
+		assert(r == 0);
+
+		x->p += n + 1;
+		x->lineno++;
+	}
+
+	assert(r == 1);
+	assert(len == n);
+	assert(lineno == x->lineno);
+	assert(end == want);
+
+	x->p += n + 1;
+	x->lineno++;
+	x->count++;
+
+	return x->count != x->stop;
+}
+
+int main(void) {
+	static char buf[20000];
+	size_t i, j, k, n;
+	int r;
+
+	for (i = 0; i < sizeof a / sizeof *a; i++) {
+		struct fsm_parallel *p;
+		struct fsm *fsm;
+
+		fsm = comp(a[i], RE_MULTI);
+
+		p = fsm_parallel_compile_lines(fsm);
+		assert(p != NULL);
+
+		for (j = 0; j < 50; j++) {
+			struct expect x;
+
+			/* short lines and long, empty lines, and maybe a final newline */
+			n = rnd() % (sizeof buf - 1);
+			for (k = 0; k < n; k++) {
+				buf[k] = "abc\n\n"[rnd() % (rnd() % 8 == 0 ? 5 : 3)];
+			}
+			buf[n] = '\0';
+
+			x.fsm    = fsm;
+			x.p      = buf;
+			x.lineno = 0;
+			x.count  = 0;
+			x.stop   = 0;
+
+			r = fsm_parallel_match_lines(p, buf, n, &x, line);
+			assert(r == 1);
+
+			/* no more lines are accepted after the last reported */
+			while (x.p < buf + n) {
+				const char *nl, *q;
+				fsm_state_t st;
+				char tmp[256];
+				size_t len;
+
+				nl  = strchr(x.p, '\n');
+				len = nl != NULL ? (size_t) (nl - x.p) : strlen(x.p);
+
+				memcpy(tmp, x.p, len);
+				tmp[len] = '\0';
+
+				q = tmp;
+				r = fsm_exec(fsm, fsm_sgetc, &q, &st);
+				assert(r == 0);
+
+				x.p += len + 1;
+			}
+
+			/* stopping early */
+			if (x.count > 1) {
+				x.p      = buf;
+				x.lineno = 0;
+				x.stop   = x.count / 2;
+				x.count  = 0;
+
+				r = fsm_parallel_match_lines(p, buf, n, &x, line);
+				assert(r == 0);
+				assert(x.count == x.stop);
+			}
+		}
+
+		fsm_parallel_free(p);
+		fsm_free(fsm);
+	}
+
+	return 0;
+}
+
@@ -0,0 +1,52 @@
+/*
+ * Copyright 2026 agent
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stdio.h>
+
+/*
+ * The same regexp printed as parts (each compiled as a translation unit
+ * of its own) and as a single function, compared over every string of
+ * up to MAXLEN symbols from an alphabet covering the regexps here.
+ */
+
+#define MAXLEN 6
+
+int parts_main(const char *b, const char *e);
+int whole_main(const char *b, const char *e);
+
+static const char alpha[] = "abcdexyz";
+
+static unsigned
+walk(char *s, size_t n)
+{
+	unsigned errors;
+	size_t i;
+
+	errors = 0;
+
+	if (parts_main(s, s + n) != whole_main(s, s + n)) {
+		fprintf(stderr, "mismatch for \"%.*s\"\n", (int) n, s);
+		errors++;
+	}
+
+	if (n == MAXLEN) {
+		return errors;
+	}
+
+	for (i = 0; i < sizeof alpha - 1; i++) {
+		s[n] = alpha[i];
+		errors += walk(s, n + 1);
+	}
+
+	return errors;
+}
+
+int main(void) {
+	char s[MAXLEN];
+
+	return walk(s, 0) != 0;
+}
@@ -0,0 +1,173 @@
+/*
+ * Copyright 2026 agent
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include <fsm/fsm.h>
+#include <fsm/options.h>
+#include <fsm/print.h>
+#include <fsm/vm.h>
+
+/*
+ * /^(ab|cd|ef)$/, with states numbered by hand:
+ * 1, 2 and 3 follow 'a', 'c' and 'e' from the start state 0,
+ * and 4 is the end state.
+ */
+static struct fsm *
+build(const struct fsm_options *opt)
+{
+	static const char *edge[] = { "01a", "02c", "03e", "14b", "24d", "34f" };
+	struct fsm *fsm;
+	fsm_state_t s;
+	size_t i;
+	int r;
+
+	fsm = fsm_new(opt);
+	assert(fsm != NULL);
+
+	for (i = 0; i < 5; i++) {
+		r = fsm_addstate(fsm, &s);
+		assert(r);
+		assert(s == i);
+	}
+
+	for (i = 0; i < sizeof edge / sizeof *edge; i++) {
+		r = fsm_addedge_literal(fsm, edge[i][0] - '0', edge[i][1] - '0', edge[i][2]);
+		assert(r);
+	}
+
+	fsm_setstart(fsm, 0);
+	fsm_setend(fsm, 4, 1);
+
+	return fsm;
+}
+
+/*
+ * The states in the order their code is laid out, and the first symbol
+ * compared by the start state, per the assembly output.
+ */
+static size_t
+layout(const struct fsm *fsm, unsigned order[], unsigned *first)
+{
+	char line[128];
+	unsigned n, c;
+	size_t i;
+	FILE *f;
+
+	f = tmpfile();
+	assert(f != NULL);
+
+	fsm_print_vmasm_amd64_att(f, fsm);
+	rewind(f);
+
+	i = 0;
+	*first = 0;
+
+	while (fgets(line, sizeof line, f) != NULL) {
+		if (1 == sscanf(line, "# state %u", &n) || 1 == sscanf(line, ".state_%u:", &n)) {
+			assert(i < 5);
+			order[i++] = n;
+			continue;
+		}
+
+		if (i == 1 && *first == 0 && 1 == sscanf(line, " cmpl $0x%x", &c)) {
+			*first = c;
+		}
+	}
+
+	fclose(f);
+
+	return i;
+}
+
+static int
+match(const struct fsm_dfavm *vm, const char *s)
+{
+	return fsm_vm_match_buffer(vm, s, strlen(s));
+}
+
+int main(void) {
+	static const char *in[] = {
+		"ab", "cd", "ef", "", "a", "c", "ad", "cb", "abx", "cdcd", "e", "ff"
+	};
+	struct fsm_vm_compile_opts vmopts;
+	struct fsm_options opt;
+	struct fsm_vm_profile *profile;
+	struct fsm_dfavm *vm, *pvm;
+	unsigned order[5], first;
+	struct fsm *fsm;
+	fsm_state_t end;
+	const char *s;
+	size_t i, n;
+	int r;
+
+	memset(&opt, 0, sizeof opt);
+
+	fsm = build(&opt);
+
+	/* without a profile, the trace follows the last branch */
+	n = layout(fsm, order, &first);
+	assert(n == 5);
+	assert(order[0] == 0);
+	assert(order[1] == 3);
+	assert(first == 'a');
+
+	profile = fsm_vm_profile_new(fsm);
+	assert(profile != NULL);
+
+	for (i = 0; i < 10; i++) {
+		r = fsm_vm_profile_buffer(profile, fsm, "cd", 2);
+		assert(r == 1);
+	}
+
+	r = fsm_vm_profile_buffer(profile, fsm, "ab", 2);
+	assert(r == 1);
+
+	r = fsm_vm_profile_buffer(profile, fsm, "cx", 2);
+	assert(r == 0);
+
+	/* with one, 'c' is compared first, and the hot path is laid out in order */
+	opt.vm_profile = profile;
+
+	n = layout(fsm, order, &first);
+	assert(n == 5);
+	assert(order[0] == 0);
+	assert(order[1] == 2);
+	assert(order[2] == 4);
+	assert(first == 'c');
+
+	/* the layout differs, but what matches does not */
+	memset(&vmopts, 0, sizeof vmopts);
+	vmopts.flags = FSM_VM_COMPILE_DEFAULT_FLAGS;
+
+	vm = fsm_vm_compile_with_options(fsm, vmopts);
+	assert(vm != NULL);
+
+	vmopts.profile = profile;
+
+	pvm = fsm_vm_compile_with_options(fsm, vmopts);
+	assert(pvm != NULL);
+
+	for (i = 0; i < sizeof in / sizeof *in; i++) {
+		s = in[i];
+		r = fsm_exec(fsm, fsm_sgetc, &s, &end);
+		assert(r != -1);
+
+		assert(match(vm, in[i]) == r);
+		assert(match(pvm, in[i]) == r);
+	}
+
+	fsm_vm_free(vm);
+	fsm_vm_free(pvm);
+
+	fsm_vm_profile_free(profile);
+	fsm_free(fsm);
+
+	return 0;
+}
@@ -0,0 +1,41 @@
+# literals, classes and anchors
+
+^abc$
++abc
+-ab
+-abcd
+-xabc
+-
+
+abc
++abc
++xxabcxx
++aabcc
+-ab
+-acb
+
+^a[b-d]*e$
++ae
++abcde
++adddddddddddddddddddddddddddddddddddddddddddde
+-a
+-abce!
+-aee
+
+^$
++
+-a
+
+^(foo|bar)+baz$
++foobaz
++barfoobarbaz
+-baz
+-foobarba
+-foobazbaz
+
+x+y?z
++xz
++xxxxyz
++aaxyzaa
+-xy
+-yz
@@ -0,0 +1,25 @@
+# enough states that branches must be lengthened past rel8,
+# and octets either side of 0x80
+
+^(alpha|bravo|charlie|delta|echo|foxtrot|golf|hotel|india|juliet|kilo|lima|mike|november|oscar|papa|quebec|romeo|sierra|tango|uniform|victor|whiskey|xray|yankee|zulu)[0-9]{2,4}$
++alpha00
++zulu1234
++november99
++juliet123
+-alpha0
+-zulu12345
+-Alpha00
+-alph00
+-xray
+
+^[\x00-\x7f]+$
++a
++\x01\x7f
+-\x80
+-a\xff
+
+^\xff[\x80-\xfe]*\xff$
++\xff\xff
++\xff\x80\xfe\x81\xff
+-\xff\x7f\xff
+-\xff\xff\xff
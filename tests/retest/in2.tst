@@ -0,0 +1,41 @@
+# long literals, compared by MATCHS a run of up to 16 octets at a time,
+# so these mismatch at the first, a middle and the last octet of a run,
+# and end partway through one
+
+^Content-Type: text/html$
++Content-Type: text/html
+-Content-Type: text/htm
+-Content-Type: text/htmlx
+-content-Type: text/html
+-Content-Type: text/hXml
+-Content-Type: tex
+-Content-Type: te
+-Content-Type: t
+-Content-Typ
+-C
+-
+
+^x(abcdefghijklmnop|0123456789abcdefghijklmnopqrstuvwxyz)y$
++xabcdefghijklmnopy
++x0123456789abcdefghijklmnopqrstuvwxyzy
+-xabcdefghijklmnop
+-xabcdefghijklmnoy
+-xabcdefghijklmnopqy
+-x0123456789abcdefghijklmnopqrstuvwxy
+-x0123456789abcdefghijklmnopqrstuvwxyzz
+-x0123456789abcdefXhijklmnopqrstuvwxyzy
+
+^[0-9]+(GET|POST) /index\.html HTTP/1\.[01]$
++1GET /index.html HTTP/1.0
++12345POST /index.html HTTP/1.1
+-1GET /index.html HTTP/1.2
+-1GET /index.htm HTTP/1.0
+-1PUT /index.html HTTP/1.0
+-GET /index.html HTTP/1.0
+
+keyword-that-is-quite-long
++keyword-that-is-quite-long
++xx keyword-that-is-quite-long xx
++kkeyword-that-is-quite-long
+-keyword-that-is-quite-lon
+-keyword-that-is-quite-lonG
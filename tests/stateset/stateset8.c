@@ -0,0 +1,92 @@
+/*
+ * Copyright 2019 Shannon Stewman
+ *
+ * See LICENCE for the full copyright terms.
+ */
+
+#include <assert.h>
+#include <stdlib.h>
+
+#include <fsm/fsm.h>
+
+#include <adt/stateset.h>
+
+/* tests dense sets, which are held as bitmaps */
+int main(void) {
+	struct state_set *a, *b, *c;
+	struct state_iter it;
+	const fsm_state_t *p;
+	fsm_state_t s, prev;
+	size_t i, n;
+
+	a = NULL;
+	b = NULL;
+	c = NULL;
+
+	/* evens in a, odds in b, over a few chunks' worth of states */
+	for (i = 0; i < 3000; i += 2) {
+		assert(state_set_add(&a, NULL, i));
+		assert(state_set_add(&b, NULL, 2999 - i));
+	}
+
+	assert(state_set_count(a) == 1500);
+	assert(state_set_count(b) == 1500);
+	assert(state_set_contains(a, 1000));
+	assert(!state_set_contains(a, 1001));
+
+	/* far away, to make a sparse chunk */
+	assert(state_set_add(&a, NULL, -2));
+
+	assert(state_set_copy(&c, NULL, a));
+	assert(state_set_cmp(a, c) == 0);
+	assert(state_set_hash(a) == state_set_hash(c));
+
+	assert(state_set_copy(&c, NULL, b));
+	assert(state_set_count(c) == 3001);
+
+	for (i = 0; i < 3000; i++) {
+		assert(state_set_contains(c, i));
+	}
+
+	n = 0;
+	prev = 0;
+	for (state_set_reset(c, &it); state_set_next(&it, &s); n++) {
+		assert(n == 0 || s > prev);
+		prev = s;
+	}
+	assert(n == 3001);
+	assert(prev == (fsm_state_t) -2);
+
+	state_set_remove(&c, -2);
+	for (i = 1; i < 3000; i += 2) {
+		state_set_remove(&c, i);
+	}
+	state_set_remove(&a, -2);
+
+	assert(state_set_cmp(a, c) == 0);
+	assert(state_set_hash(a) == state_set_hash(c));
+
+	/* equal sets built differently compare equal */
+	state_set_free(b);
+	b = NULL;
+	for (i = 0; i < 3000; i += 2) {
+		assert(state_set_add(&b, NULL, i));
+	}
+	assert(state_set_cmp(a, b) == 0);
+	assert(state_set_hash(a) == state_set_hash(b));
+
+	p = state_set_array(a);
+	assert(p != NULL);
+	for (i = 0; i < state_set_count(a); i++) {
+		assert(p[i] == i * 2);
+	}
+
+	assert(state_set_cmp(a, b) == 0);
+	assert(state_set_hash(a) == state_set_hash(b));
+
+	state_set_free(a);
+	state_set_free(b);
+	state_set_free(c);
+
+	return 0;
+}